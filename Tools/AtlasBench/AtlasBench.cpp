@@ -0,0 +1,261 @@
+// 图集和精灵批处理的无头基准和正确性检查：
+// 1. 随机大小的矩形用 SkylinePacker 装进若干页，报告 矩形/ms 和占用率，并检查没有重叠、没有出界；
+// 2. 用同样的尺寸生成小图建图集，逐像素检查每个图块和它四周的 padding；
+// 3. 往 SpriteQueue 里加精灵（轴对齐和旋转两种），报告 四边形/ms，也就是 SpriteBatch 每帧在 CPU 上的开销。
+// usage: AtlasBench [--rects N] [--min N] [--max N] [--page N] [--padding N] [--quads N] [--iterations N]
+#include "SpriteQueue.h"
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::uint32_t PixelOf(std::size_t image, std::uint32_t x, std::uint32_t y)
+    {
+        return std::uint32_t(image * 2654435761u) ^ (x << 12) ^ y;
+    }
+
+    std::uint32_t Read(const Image& image, std::uint32_t x, std::uint32_t y)
+    {
+        std::uint32_t p;
+        std::memcpy(&p, image.GetMipData(0u) + std::size_t(y) * image.GetMip(0u).rowPitch + std::size_t(x) * 4u, 4u);
+        return p;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int rectCount = 2000u;
+    std::uint32_t minSize = 8u;
+    std::uint32_t maxSize = 128u;
+    std::uint32_t pageSize = 1024u;
+    std::uint32_t padding = 2u;
+    unsigned int quadCount = 100000u;
+    unsigned int iterations = 20u;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "usage: AtlasBench [--rects N] [--min N] [--max N] [--page N] [--padding N] [--quads N] [--iterations N]" << std::endl;
+            return 1;
+        }
+        const auto value = unsigned(std::stoul(argv[++i]));
+        if (arg == "--rects") rectCount = value;
+        else if (arg == "--min") minSize = value;
+        else if (arg == "--max") maxSize = value;
+        else if (arg == "--page") pageSize = value;
+        else if (arg == "--padding") padding = value;
+        else if (arg == "--quads") quadCount = value;
+        else if (arg == "--iterations") iterations = value;
+        else
+        {
+            std::cerr << "unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (rectCount == 0u || minSize == 0u || maxSize < minSize || maxSize + 2u * padding > pageSize || iterations == 0u)
+    {
+        std::cerr << "bad options" << std::endl;
+        return 1;
+    }
+
+    std::mt19937 rng(12345u);
+    std::uniform_int_distribution<std::uint32_t> sizeDist(minSize, maxSize);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> sizes(rectCount);
+    for (auto& s : sizes)
+    {
+        s = { sizeDist(rng), sizeDist(rng) };
+    }
+
+    try
+    {
+        // 1. 装箱：放不进当前页就开新页，和 TextureAtlas::Build 一样先按高度排序
+        auto sorted = sizes;
+        std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.second != b.second ? a.second > b.second : a.first > b.first;
+        });
+        std::vector<SkylinePacker> packers;
+        std::vector<std::vector<AtlasRect>> placed;
+        double packMs = 0.0;
+        for (unsigned int it = 0u; it < iterations; it++)
+        {
+            packers.clear();
+            placed.clear();
+            const auto start = Clock::now();
+            for (const auto& s : sorted)
+            {
+                AtlasRect rect;
+                std::size_t page = 0u;
+                while (page < packers.size() && !packers[page].Insert(s.first, s.second, rect))
+                {
+                    page++;
+                }
+                if (page == packers.size())
+                {
+                    packers.emplace_back(pageSize, pageSize);
+                    placed.emplace_back();
+                    packers.back().Insert(s.first, s.second, rect);
+                }
+                placed[page].push_back(rect);
+            }
+            packMs += MillisecondsSince(start);
+        }
+        for (std::size_t page = 0u; page < placed.size(); page++)
+        {
+            std::vector<std::uint8_t> covered(std::size_t(pageSize) * pageSize, 0u);
+            for (const auto& r : placed[page])
+            {
+                if (r.x + r.width > pageSize || r.y + r.height > pageSize)
+                {
+                    std::cerr << "FAIL: rectangle outside page " << page << std::endl;
+                    return 1;
+                }
+                for (auto y = r.y; y < r.y + r.height; y++)
+                {
+                    for (auto x = r.x; x < r.x + r.width; x++)
+                    {
+                        if (covered[std::size_t(y) * pageSize + x]++ != 0u)
+                        {
+                            std::cerr << "FAIL: rectangles overlap on page " << page << std::endl;
+                            return 1;
+                        }
+                    }
+                }
+            }
+        }
+        std::cout << rectCount << " rects " << minSize << ".." << maxSize << " px into " << pageSize << " px pages: "
+                  << std::fixed << std::setprecision(1) << rectCount * iterations / packMs << " rects/ms, "
+                  << packers.size() << " pages, occupancy";
+        for (const auto& p : packers)
+        {
+            std::cout << " " << std::setprecision(1) << 100.0 * p.GetOccupancy() << "%";
+        }
+        std::cout << std::endl;
+
+        // 2. 图集：每个像素的值由图号和坐标决定，padding 应该等于最近的边缘像素
+        std::vector<Image> images;
+        std::vector<const Image*> pointers;
+        images.reserve(sizes.size());
+        for (std::size_t i = 0u; i < sizes.size(); i++)
+        {
+            images.emplace_back(sizes[i].first, sizes[i].second, ImageFormat::RGBA8, 1u);
+            for (std::uint32_t y = 0u; y < sizes[i].second; y++)
+            {
+                for (std::uint32_t x = 0u; x < sizes[i].first; x++)
+                {
+                    const auto p = PixelOf(i, x, y);
+                    std::memcpy(images.back().GetMipData(0u) + std::size_t(y) * images.back().GetMip(0u).rowPitch + x * 4u, &p, 4u);
+                }
+            }
+            pointers.push_back(&images.back());
+        }
+        const AtlasOptions options = { pageSize, padding, false };
+        auto start = Clock::now();
+        const auto atlas = TextureAtlas::Build(pointers, options);
+        const auto buildMs = MillisecondsSince(start);
+        for (std::uint32_t i = 0u; i < atlas.GetRegionCount(); i++)
+        {
+            const auto& region = atlas.GetRegion(i);
+            const auto& page = atlas.GetPage(region.page);
+            const auto& r = region.rect;
+            if (r.width != sizes[i].first || r.height != sizes[i].second ||
+                region.u0 != float(r.x) / pageSize || region.v1 != float(r.y + r.height) / pageSize)
+            {
+                std::cerr << "FAIL: region " << i << " has the wrong size or UVs" << std::endl;
+                return 1;
+            }
+            for (std::uint32_t y = 0u; y < r.height + 2u * padding; y++)
+            {
+                for (std::uint32_t x = 0u; x < r.width + 2u * padding; x++)
+                {
+                    const auto sx = std::min(r.width - 1u, x >= padding ? x - padding : 0u);
+                    const auto sy = std::min(r.height - 1u, y >= padding ? y - padding : 0u);
+                    if (Read(page, r.x - padding + x, r.y - padding + y) != PixelOf(i, sx, sy))
+                    {
+                        std::cerr << "FAIL: region " << i << " pixel " << x << "," << y << " (with padding) is wrong" << std::endl;
+                        return 1;
+                    }
+                }
+            }
+        }
+        std::cout << "atlas of " << atlas.GetRegionCount() << " images: " << std::setprecision(1) << buildMs << " ms, "
+                  << atlas.GetPageCount() << " pages, occupancy without padding";
+        for (std::uint32_t page = 0u; page < atlas.GetPageCount(); page++)
+        {
+            std::cout << " " << 100.0 * atlas.GetOccupancy(page) << "%";
+        }
+        std::cout << std::endl;
+
+        // 3. 精灵：先跑一遍让桶长到需要的容量，之后每遍都是稳定状态（不分配内存）
+        std::vector<std::uint32_t> regionIndices(quadCount);
+        std::uniform_int_distribution<std::uint32_t> regionDist(0u, atlas.GetRegionCount() - 1u);
+        for (auto& r : regionIndices)
+        {
+            r = regionDist(rng);
+        }
+        SpriteQueue queue;
+        queue.SetViewport(800.0f, 600.0f);
+        const auto fill = [&](bool rotated) {
+            queue.Clear();
+            for (unsigned int q = 0u; q < quadCount; q++)
+            {
+                const auto& region = atlas.GetRegion(regionIndices[q]);
+                const auto x = float(q % 800u);
+                const auto y = float(q % 600u);
+                if (rotated)
+                {
+                    queue.AddRotated(region, x, y, 32.0f, 32.0f, 0.001f * q);
+                }
+                else
+                {
+                    queue.Add(region, x, y, 32.0f, 32.0f);
+                }
+            }
+        };
+        for (const bool rotated : { false, true })
+        {
+            fill(rotated);
+            start = Clock::now();
+            for (unsigned int it = 0u; it < iterations; it++)
+            {
+                fill(rotated);
+            }
+            const auto ms = MillisecondsSince(start);
+            std::size_t vertices = 0u;
+            for (std::uint32_t page = 0u; page < queue.GetPageCount(); page++)
+            {
+                vertices += queue.GetVertices(page).size();
+            }
+            if (queue.GetQuadCount() != quadCount || vertices != std::size_t(quadCount) * 4u)
+            {
+                std::cerr << "FAIL: sprite queue lost quads" << std::endl;
+                return 1;
+            }
+            std::cout << quadCount << (rotated ? " rotated" : " axis-aligned") << " sprites on " << queue.GetPageCount()
+                      << " pages: " << std::setprecision(0) << double(quadCount) * iterations / ms << " quads/ms, "
+                      << std::setprecision(1) << double(vertices * sizeof(SpriteVertex)) / 1024.0 << " KB of vertices per frame"
+                      << std::endl;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "FAIL: " << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,998 @@
+// Drawable 绑定路径的无头基准：
+// 1. 按 Box 的绑定集合建 --objects 个物体：8 个 static bind（VB、VS、PS、IB、像素常量缓冲、输入布局、拓扑、光栅化状态）
+//    加一个每物体的 TransformCbuf（每次绘制算矩阵、Map 写 64 字节、绑定），设备上下文是虚接口的替身（FakeContext.h），计时用的只记状态；
+// 2. 三条路径：pooling 之前——每个 Bindable 单独 make_unique，Drawable 存 unique_ptr 的 vector，逐个虚调用 Bind；
+//    现在的——Bindable 放在按类型的 BindPool 里，Drawable 存 32 位句柄，经过按类型的函数表非虚地调用 T::Bind，
+//    TransformCbuf 是 Box 的成员；以及可选的 BindStream（引擎里要 --bind-stream）——绑定集合编译成带类型标签的命令数组，一个 switch 执行
+//    （句柄、函数表和 pool 用引擎的 BindPoolCore.h；BindStream.h / Drawable.h 要 d3d11.h，这里照着写了一份）；
+// 3. 三条路径一帧一帧轮流画 --frames 帧，一次连续画（数据都在缓存里），一次每帧之前先扫 64MB 把缓存挤掉，
+//    报告最快一帧里每次绘制的纳秒数，以及拿得到时的硬件缓存未命中和分支预测失败次数；
+// 4. 再建 --spawn 个物体并画两帧：两种布局（现在的布局两条绘制路径各一次）的建造时间、每个物体的堆分配（MemoryTracker）、绘制时的分配，
+//    按实际地址数每个物体一次绘制读到的、它自己的缓存行，以及拿得到时第一帧的硬件缓存未命中；
+// 5. 检查：三条路径对设备上下文做的调用（包括写进常量缓冲的矩阵）完全一样，
+//    之前的布局每个物体 3 次分配（Box、binds 的 vector、TransformCbuf），现在 1 次，画的时候都不分配，
+//    现在的布局每次绘制读到的自己的缓存行不比之前多（static 的命令流每个类型一份，不在物体里）。
+// usage: BindBench [--objects N] [--frames N] [--spawn N]
+#include "BindPoolCore.h"
+#include "FakeContext.h"
+#include "HardwareCounter.h"
+#include "MemoryTracker.h"
+#include "SmallVector.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Matrix
+    {
+        float m[4][4];
+    };
+
+    Matrix Multiply(const Matrix& a, const Matrix& b) noexcept
+    {
+        Matrix r;
+        for (int row = 0; row < 4; row++)
+        {
+            for (int col = 0; col < 4; col++)
+            {
+                r.m[row][col] = a.m[row][0] * b.m[0][col] + a.m[row][1] * b.m[1][col] + a.m[row][2] * b.m[2][col] + a.m[row][3] * b.m[3][col];
+            }
+        }
+        return r;
+    }
+
+    Matrix Transpose(const Matrix& a) noexcept
+    {
+        Matrix r;
+        for (int row = 0; row < 4; row++)
+        {
+            for (int col = 0; col < 4; col++)
+            {
+                r.m[row][col] = a.m[col][row];
+            }
+        }
+        return r;
+    }
+
+    // App 的 XMMatrixPerspectiveLH(1.0f, 3.0f / 4.0f, 0.5f, 40.0f)
+    constexpr Matrix projection = { {
+        { 1.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 4.0f / 3.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 40.0f / 39.5f, 1.0f },
+        { 0.0f, 0.0f, -0.5f * 40.0f / 39.5f, 0.0f },
+    } };
+
+    // DXGI_FORMAT_R16_UINT 和 D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST
+    constexpr UINT indexFormat = 57u;
+    constexpr UINT triangleList = 4u;
+    constexpr UINT boxIndexCount = 36u;
+
+    // 代替 ID3D11Buffer 等设备对象，只用到地址
+    struct FakeResource
+    {
+        unsigned char unused[16];
+    };
+
+    // [p, p + bytes) 覆盖的 64 字节缓存行
+    void AddLines(std::vector<std::uintptr_t>& lines, const void* p, std::size_t bytes)
+    {
+        const auto first = reinterpret_cast<std::uintptr_t>(p) / 64u;
+        const auto last = (reinterpret_cast<std::uintptr_t>(p) + bytes + 63u) / 64u;
+        for (auto line = first; line < last; line++)
+        {
+            lines.push_back(line);
+        }
+    }
+
+    struct BoxResources
+    {
+        FakeResource vertexBuffer;
+        FakeResource indexBuffer;
+        FakeResource vertexShader;
+        FakeResource pixelShader;
+        FakeResource faceColors;
+        FakeResource inputLayout;
+        FakeResource rasterizer;
+    };
+
+    namespace Pooled
+    {
+        class BindStream;
+        class Drawable;
+    }
+
+    // 两种布局共用的 Bindable：和引擎一样 Bind 是虚函数，pool 的函数表用限定名调用绕过虚表；
+    // Record 把自己写进命令流，只有现在的布局用
+    class Bindable
+    {
+    public:
+        virtual ~Bindable() = default;
+        virtual void Bind(FakeContext& context) noexcept = 0;
+        virtual void Record(Pooled::BindStream& stream) const = 0;
+    };
+
+    class VertexBuffer : public Bindable
+    {
+    public:
+        VertexBuffer(void* pBuffer, UINT stride) noexcept
+            :
+            pBuffer(pBuffer),
+            stride(stride)
+        {}
+        void Bind(FakeContext& context) noexcept override
+        {
+            context.IASetVertexBuffer(pBuffer, stride);
+        }
+        void Record(Pooled::BindStream& stream) const override;
+    private:
+        void* pBuffer;
+        UINT stride;
+    };
+
+    class IndexBuffer : public Bindable
+    {
+    public:
+        IndexBuffer(void* pBuffer, UINT count) noexcept
+            :
+            pBuffer(pBuffer),
+            count(count)
+        {}
+        void Bind(FakeContext& context) noexcept override
+        {
+            context.IASetIndexBuffer(pBuffer, indexFormat);
+        }
+        void Record(Pooled::BindStream& stream) const override;
+        UINT GetCount() const noexcept
+        {
+            return count;
+        }
+    private:
+        void* pBuffer;
+        UINT count;
+    };
+
+    class VertexShader : public Bindable
+    {
+    public:
+        explicit VertexShader(void* pShader) noexcept
+            :
+            pShader(pShader)
+        {}
+        void Bind(FakeContext& context) noexcept override
+        {
+            context.VSSetShader(pShader);
+        }
+        void Record(Pooled::BindStream& stream) const override;
+    private:
+        void* pShader;
+    };
+
+    class PixelShader : public Bindable
+    {
+    public:
+        explicit PixelShader(void* pShader) noexcept
+            :
+            pShader(pShader)
+        {}
+        void Bind(FakeContext& context) noexcept override
+        {
+            context.PSSetShader(pShader);
+        }
+        void Record(Pooled::BindStream& stream) const override;
+    private:
+        void* pShader;
+    };
+
+    class PixelConstantBuffer : public Bindable
+    {
+    public:
+        explicit PixelConstantBuffer(void* pBuffer) noexcept
+            :
+            pBuffer(pBuffer)
+        {}
+        void Bind(FakeContext& context) noexcept override
+        {
+            context.PSSetConstantBuffer(0u, pBuffer);
+        }
+        void Record(Pooled::BindStream& stream) const override;
+    private:
+        void* pBuffer;
+    };
+
+    class InputLayout : public Bindable
+    {
+    public:
+        explicit InputLayout(void* pLayout) noexcept
+            :
+            pLayout(pLayout)
+        {}
+        void Bind(FakeContext& context) noexcept override
+        {
+            context.IASetInputLayout(pLayout);
+        }
+        void Record(Pooled::BindStream& stream) const override;
+    private:
+        void* pLayout;
+    };
+
+    class Topology : public Bindable
+    {
+    public:
+        explicit Topology(UINT topology) noexcept
+            :
+            topology(topology)
+        {}
+        void Bind(FakeContext& context) noexcept override
+        {
+            context.IASetPrimitiveTopology(topology);
+        }
+        void Record(Pooled::BindStream& stream) const override;
+    private:
+        UINT topology;
+    };
+
+    class Rasterizer : public Bindable
+    {
+    public:
+        explicit Rasterizer(void* pState) noexcept
+            :
+            pState(pState)
+        {}
+        void Bind(FakeContext& context) noexcept override
+        {
+            context.RSSetState(pState);
+        }
+        void Record(Pooled::BindStream& stream) const override;
+    private:
+        void* pState;
+    };
+
+    // 和 TransformCbuf::Bind 一样：从 Drawable 取世界矩阵（虚调用），乘投影、转置，Map 写进去再绑定
+    template<class Parent>
+    class TransformCbuf : public Bindable
+    {
+    public:
+        TransformCbuf(void* pBuffer, const Parent& parent) noexcept
+            :
+            pBuffer(pBuffer),
+            parent(parent)
+        {}
+        void Bind(FakeContext& context) noexcept override
+        {
+            const auto m = Transpose(Multiply(parent.GetTransformXM(), projection));
+            std::memcpy(context.Map(pBuffer), &m, sizeof(m));
+            context.Unmap(pBuffer);
+            context.VSSetConstantBuffer(0u, pBuffer);
+        }
+        void Record(Pooled::BindStream& stream) const override;
+    private:
+        void* pBuffer;
+        const Parent& parent;
+    };
+
+    // pooling 之前的 Drawable / DrawableBase
+    namespace Legacy
+    {
+        class Drawable
+        {
+        public:
+            Drawable() = default;
+            Drawable(const Drawable&) = delete;
+            virtual ~Drawable() = default;
+            virtual Matrix GetTransformXM() const noexcept = 0;
+            void Draw(FakeContext& context) const noexcept
+            {
+                for (auto& b : binds)
+                {
+                    b->Bind(context);
+                }
+                for (auto& b : GetStaticBinds())
+                {
+                    b->Bind(context);
+                }
+                context.DrawIndexed(pIndexBuffer->GetCount(), 0u, 0);
+            }
+            // 一次绘制读到的这个物体自己的内存：对象本身、binds 的堆数组和各个实例 Bindable（Box 只有一个 TransformCbuf）
+            void CollectLines(std::vector<std::uintptr_t>& lines, std::size_t objectSize) const
+            {
+                AddLines(lines, this, objectSize);
+                AddLines(lines, binds.data(), binds.size() * sizeof(binds[0]));
+                for (auto& b : binds)
+                {
+                    AddLines(lines, b.get(), sizeof(TransformCbuf<Drawable>));
+                }
+            }
+        protected:
+            void AddBind(std::unique_ptr<Bindable> bind)
+            {
+                binds.push_back(std::move(bind));
+            }
+            void SetIndexBuffer(const IndexBuffer* pIndexBuffer_in) noexcept
+            {
+                pIndexBuffer = pIndexBuffer_in;
+            }
+        private:
+            virtual const std::vector<std::unique_ptr<Bindable>>& GetStaticBinds() const noexcept = 0;
+        private:
+            const IndexBuffer* pIndexBuffer = nullptr;
+            std::vector<std::unique_ptr<Bindable>> binds;
+        };
+
+        class Box : public Drawable
+        {
+        public:
+            Box(BoxResources& resources, FakeResource& transformBuffer, const Matrix& transform)
+                :
+                transform(transform)
+            {
+                if (staticBinds.empty())
+                {
+                    staticBinds.push_back(std::make_unique<VertexBuffer>(&resources.vertexBuffer, 12u));
+                    staticBinds.push_back(std::make_unique<VertexShader>(&resources.vertexShader));
+                    staticBinds.push_back(std::make_unique<PixelShader>(&resources.pixelShader));
+                    auto pIndexBuffer = std::make_unique<IndexBuffer>(&resources.indexBuffer, boxIndexCount);
+                    pStaticIndexBuffer = pIndexBuffer.get();
+                    staticBinds.push_back(std::move(pIndexBuffer));
+                    staticBinds.push_back(std::make_unique<PixelConstantBuffer>(&resources.faceColors));
+                    staticBinds.push_back(std::make_unique<InputLayout>(&resources.inputLayout));
+                    staticBinds.push_back(std::make_unique<Topology>(triangleList));
+                    staticBinds.push_back(std::make_unique<Rasterizer>(&resources.rasterizer));
+                }
+                SetIndexBuffer(pStaticIndexBuffer);
+                AddBind(std::make_unique<TransformCbuf<Drawable>>(&transformBuffer, *this));
+            }
+            Matrix GetTransformXM() const noexcept override
+            {
+                return transform;
+            }
+        private:
+            const std::vector<std::unique_ptr<Bindable>>& GetStaticBinds() const noexcept override
+            {
+                return staticBinds;
+            }
+        private:
+            Matrix transform;
+            static std::vector<std::unique_ptr<Bindable>> staticBinds;
+            static const IndexBuffer* pStaticIndexBuffer;
+        };
+
+        std::vector<std::unique_ptr<Bindable>> Box::staticBinds;
+        const IndexBuffer* Box::pStaticIndexBuffer = nullptr;
+    }
+
+    // 现在的 BindPool.h / BindStream.h / Drawable.h
+    namespace Pooled
+    {
+        // 句柄、函数表和 pool 直接用引擎的 BindPoolCore.h，只换了设备上下文
+        using BindRegistry = BasicBindRegistry<FakeContext, BindStream>;
+        template<class T>
+        using BindPool = BasicBindPool<T, BindRegistry>;
+
+        // BindStream.h：一组绑定编译成的扁平命令数组，Execute 用一个 switch 顺序执行；
+        // static binds 每个类型一份，每个物体自己的只有一条 Transform
+        class BindStream
+        {
+        public:
+            enum class Op : unsigned char
+            {
+                VertexBuffer,
+                IndexBuffer,
+                InputLayout,
+                Topology,
+                VertexShader,
+                PixelShader,
+                VertexConstantBuffer,
+                PixelConstantBuffer,
+                Rasterizer,
+                Transform,
+            };
+        public:
+            void Push(Op op, UINT arg, void* pObject)
+            {
+                commands.push_back({ op, arg, pObject });
+            }
+            void Execute(FakeContext& context) const noexcept;
+            void Clear() noexcept
+            {
+                commands.clear();
+            }
+            bool IsEmpty() const noexcept
+            {
+                return commands.empty();
+            }
+            std::size_t GetSize() const noexcept
+            {
+                return commands.size();
+            }
+        private:
+            // Transform 的 pObject 是 TransformCbuf
+            struct Command
+            {
+                Op op;
+                UINT arg;
+                void* pObject;
+            };
+        private:
+            SmallVector<Command, 1> commands;
+        };
+
+        class Drawable
+        {
+        public:
+            Drawable() = default;
+            Drawable(const Drawable&) = delete;
+            virtual ~Drawable()
+            {
+                for (const auto h : binds)
+                {
+                    BindRegistry::Release(h);
+                }
+            }
+            virtual Matrix GetTransformXM() const noexcept = 0;
+            void Draw(FakeContext& context) const noexcept
+            {
+                if (bindStreamEnabled)
+                {
+                    CompileBindStream();
+                    stream.Execute(context);
+                    GetStaticStream().Execute(context);
+                }
+                else
+                {
+                    for (const auto p : inlineBinds)
+                    {
+                        p->Bind(context);
+                    }
+                    for (const auto h : binds)
+                    {
+                        BindRegistry::Bind(h, context);
+                    }
+                    for (const auto h : GetStaticBinds())
+                    {
+                        BindRegistry::Bind(h, context);
+                    }
+                }
+                context.DrawIndexed(indexCount, startIndex, 0);
+            }
+            static void SetBindStreamEnabled(bool enable) noexcept
+            {
+                bindStreamEnabled = enable;
+            }
+            // 内联的 Bindable 和实例的命令流都在对象里面；Box 没有放在 pool 里的实例 Bindable，
+            // static 的命令流所有 Box 共用一份，不算它自己的
+            void CollectLines(std::vector<std::uintptr_t>& lines, std::size_t objectSize) const
+            {
+                assert(binds.empty());
+                AddLines(lines, this, objectSize);
+            }
+        protected:
+            void AddInlineBind(Bindable& bind) noexcept
+            {
+                inlineBinds.push_back(&bind);
+                stream.Clear();
+            }
+            void SetIndexFromStatic() noexcept
+            {
+                for (const auto h : GetStaticBinds())
+                {
+                    if (BindPool<IndexBuffer>::Owns(h))
+                    {
+                        indexCount = BindPool<IndexBuffer>::Get(h).GetCount();
+                        return;
+                    }
+                }
+            }
+        private:
+            virtual const std::vector<BindHandle>& GetStaticBinds() const noexcept = 0;
+            virtual BindStream& GetStaticStream() const noexcept = 0;
+            void CompileBindStream() const
+            {
+                if (stream.IsEmpty())
+                {
+                    for (const auto p : inlineBinds)
+                    {
+                        p->Record(stream);
+                    }
+                    for (const auto h : binds)
+                    {
+                        BindRegistry::Record(h, stream);
+                    }
+                }
+                auto& staticStream = GetStaticStream();
+                if (staticStream.IsEmpty())
+                {
+                    for (const auto h : GetStaticBinds())
+                    {
+                        BindRegistry::Record(h, staticStream);
+                    }
+                }
+            }
+        private:
+            UINT indexCount = 0u;
+            UINT startIndex = 0u;
+            SmallVector<Bindable*, 1> inlineBinds;
+            SmallVector<BindHandle, 2> binds;
+            mutable BindStream stream;
+            static bool bindStreamEnabled;
+        };
+
+        // 和引擎一样默认逐个 Bind
+        bool Drawable::bindStreamEnabled = false;
+
+        void BindStream::Execute(FakeContext& context) const noexcept
+        {
+            for (const auto& c : commands)
+            {
+                switch (c.op)
+                {
+                case Op::VertexBuffer:
+                    context.IASetVertexBuffer(c.pObject, c.arg);
+                    break;
+                case Op::IndexBuffer:
+                    context.IASetIndexBuffer(c.pObject, c.arg);
+                    break;
+                case Op::InputLayout:
+                    context.IASetInputLayout(c.pObject);
+                    break;
+                case Op::Topology:
+                    context.IASetPrimitiveTopology(c.arg);
+                    break;
+                case Op::VertexShader:
+                    context.VSSetShader(c.pObject);
+                    break;
+                case Op::PixelShader:
+                    context.PSSetShader(c.pObject);
+                    break;
+                case Op::VertexConstantBuffer:
+                    context.VSSetConstantBuffer(c.arg, c.pObject);
+                    break;
+                case Op::PixelConstantBuffer:
+                    context.PSSetConstantBuffer(c.arg, c.pObject);
+                    break;
+                case Op::Rasterizer:
+                    context.RSSetState(c.pObject);
+                    break;
+                case Op::Transform:
+                    static_cast<TransformCbuf<Drawable>*>(c.pObject)->TransformCbuf<Drawable>::Bind(context);
+                    break;
+                }
+            }
+        }
+
+        class Box : public Drawable
+        {
+        public:
+            Box(BoxResources& resources, FakeResource& transformBuffer, const Matrix& transform)
+                :
+                transform(transform),
+                transformCbuf(&transformBuffer, *this)
+            {
+                if (staticBinds.empty())
+                {
+                    staticBinds.push_back(BindPool<VertexBuffer>::Emplace(&resources.vertexBuffer, 12u));
+                    staticBinds.push_back(BindPool<VertexShader>::Emplace(&resources.vertexShader));
+                    staticBinds.push_back(BindPool<PixelShader>::Emplace(&resources.pixelShader));
+                    staticBinds.push_back(BindPool<IndexBuffer>::Emplace(&resources.indexBuffer, boxIndexCount));
+                    staticBinds.push_back(BindPool<PixelConstantBuffer>::Emplace(&resources.faceColors));
+                    staticBinds.push_back(BindPool<InputLayout>::Emplace(&resources.inputLayout));
+                    staticBinds.push_back(BindPool<Topology>::Emplace(triangleList));
+                    staticBinds.push_back(BindPool<Rasterizer>::Emplace(&resources.rasterizer));
+                }
+                SetIndexFromStatic();
+                AddInlineBind(transformCbuf);
+            }
+            Matrix GetTransformXM() const noexcept override
+            {
+                return transform;
+            }
+        private:
+            const std::vector<BindHandle>& GetStaticBinds() const noexcept override
+            {
+                return staticBinds;
+            }
+            BindStream& GetStaticStream() const noexcept override
+            {
+                return staticStream;
+            }
+        private:
+            Matrix transform;
+            TransformCbuf<Drawable> transformCbuf;
+            static std::vector<BindHandle> staticBinds;
+            static BindStream staticStream;
+        };
+
+        std::vector<BindHandle> Box::staticBinds;
+        BindStream Box::staticStream;
+    }
+
+    void VertexBuffer::Record(Pooled::BindStream& stream) const
+    {
+        stream.Push(Pooled::BindStream::Op::VertexBuffer, stride, pBuffer);
+    }
+
+    void IndexBuffer::Record(Pooled::BindStream& stream) const
+    {
+        stream.Push(Pooled::BindStream::Op::IndexBuffer, indexFormat, pBuffer);
+    }
+
+    void VertexShader::Record(Pooled::BindStream& stream) const
+    {
+        stream.Push(Pooled::BindStream::Op::VertexShader, 0u, pShader);
+    }
+
+    void PixelShader::Record(Pooled::BindStream& stream) const
+    {
+        stream.Push(Pooled::BindStream::Op::PixelShader, 0u, pShader);
+    }
+
+    void PixelConstantBuffer::Record(Pooled::BindStream& stream) const
+    {
+        stream.Push(Pooled::BindStream::Op::PixelConstantBuffer, 0u, pBuffer);
+    }
+
+    void InputLayout::Record(Pooled::BindStream& stream) const
+    {
+        stream.Push(Pooled::BindStream::Op::InputLayout, 0u, pLayout);
+    }
+
+    void Topology::Record(Pooled::BindStream& stream) const
+    {
+        stream.Push(Pooled::BindStream::Op::Topology, topology, nullptr);
+    }
+
+    void Rasterizer::Record(Pooled::BindStream& stream) const
+    {
+        stream.Push(Pooled::BindStream::Op::Rasterizer, 0u, pState);
+    }
+
+    // 矩阵在执行时才从 Drawable 取；pooling 之前的布局不编译命令流
+    template<class Parent>
+    void TransformCbuf<Parent>::Record(Pooled::BindStream& stream) const
+    {
+        if constexpr (std::is_same_v<Parent, Pooled::Drawable>)
+        {
+            stream.Push(Pooled::BindStream::Op::Transform, 0u, const_cast<TransformCbuf*>(this));
+        }
+        else
+        {
+            (void)stream;
+            assert("The legacy layout has no bind streams" && false);
+        }
+    }
+
+    struct Result
+    {
+        double nsPerDraw;
+        std::uint64_t cacheMisses;
+        std::uint64_t branchMisses;
+        bool hasCounters;
+    };
+
+    template<class Boxes>
+    void DrawFrame(const Boxes& boxes, FakeContext& context) noexcept
+    {
+        for (const auto& pBox : boxes)
+        {
+            pBox->Draw(context);
+        }
+    }
+
+    // 比最后一级缓存大，每帧画之前扫一遍，模拟一帧里其他工作把物体的数据挤出缓存
+    constexpr std::size_t evictBytes = 64u << 20u;
+
+    void Evict(std::vector<unsigned char>& buffer) noexcept
+    {
+        for (std::size_t i = 0u; i < buffer.size(); i += 64u)
+        {
+            buffer[i]++;
+        }
+    }
+
+    // 一条绘制路径的计时状态
+    class Path
+    {
+    public:
+        Path() noexcept
+            :
+            cacheMisses(HardwareEvent::CacheMisses),
+            branchMisses(HardwareEvent::BranchMisses)
+        {}
+        template<class Boxes>
+        void Warmup(const Boxes& boxes)
+        {
+            DrawFrame(boxes, context);
+        }
+        template<class Boxes>
+        void Frame(const Boxes& boxes, std::vector<unsigned char>* pEvict)
+        {
+            if (pEvict)
+            {
+                Evict(*pEvict);
+            }
+            cacheMisses.Start();
+            branchMisses.Start();
+            const auto start = Clock::now();
+            DrawFrame(boxes, context);
+            best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+            result.cacheMisses += cacheMisses.Stop();
+            result.branchMisses += branchMisses.Stop();
+        }
+        Result Finish(std::size_t objects, unsigned int frames)
+        {
+            result.hasCounters = cacheMisses.IsAvailable() && branchMisses.IsAvailable();
+            result.nsPerDraw = best / double(objects);
+            // 预热一帧；每次绘制 9 个绑定，TransformCbuf 多一对 Map / Unmap，再加 DrawIndexed
+            if (context.GetDrawCount() != objects * (frames + 1u) || context.GetCallCount() != context.GetDrawCount() * 12u)
+            {
+                throw std::runtime_error("unexpected device call count");
+            }
+            return result;
+        }
+    private:
+        CountingContext context;
+        HardwareCounter cacheMisses;
+        HardwareCounter branchMisses;
+        Result result = {};
+        double best = 1e30;
+    };
+
+    // pEvict 为空时连续画（数据都在缓存里），否则每帧之前先把缓存挤掉，只计绘制的时间；
+    // 三条路径一帧一帧轮流画，机器负载的漂移对三条一样；时间取各自最快的一帧（沙箱里别的进程的干扰只会让帧变慢），
+    // 计数器是所有帧的总数
+    template<class LegacyBoxes, class PooledBoxes>
+    std::array<Result, 3> Measure(const LegacyBoxes& legacyBoxes, const PooledBoxes& pooledBoxes, unsigned int frames,
+        std::vector<unsigned char>* pEvict)
+    {
+        Path legacy;
+        Path pooled;
+        Path streamed;
+        legacy.Warmup(legacyBoxes);
+        pooled.Warmup(pooledBoxes);
+        Pooled::Drawable::SetBindStreamEnabled(true);
+        streamed.Warmup(pooledBoxes);
+        Pooled::Drawable::SetBindStreamEnabled(false);
+        for (unsigned int f = 0u; f < frames; f++)
+        {
+            legacy.Frame(legacyBoxes, pEvict);
+            pooled.Frame(pooledBoxes, pEvict);
+            Pooled::Drawable::SetBindStreamEnabled(true);
+            streamed.Frame(pooledBoxes, pEvict);
+            Pooled::Drawable::SetBindStreamEnabled(false);
+        }
+        return { legacy.Finish(legacyBoxes.size(), frames), pooled.Finish(pooledBoxes.size(), frames),
+            streamed.Finish(pooledBoxes.size(), frames) };
+    }
+
+    std::string Describe(const Result& r, std::size_t draws)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << r.nsPerDraw << " ns/draw";
+        if (r.hasCounters)
+        {
+            out << std::setprecision(2) << ", " << double(r.cacheMisses) / double(draws) << " cache misses/draw, "
+                << double(r.branchMisses) / double(draws) << " branch misses/draw";
+        }
+        return out.str();
+    }
+
+    struct SpawnResult
+    {
+        double spawnMs;
+        double allocationsPerObject;
+        double firstFrameMs;
+        unsigned long long firstFrameAllocations;
+        unsigned long long frameAllocations;
+        double linesPerObject;
+        std::uint64_t cacheMisses;
+        bool hasCounters;
+    };
+
+    // 建 count 个物体、画第一帧（现在的布局在这里编译命令流）和下一帧，数主线程的堆分配；
+    // 再按实际地址数每个物体一次绘制读到的、它自己的缓存行
+    template<class Box>
+    SpawnResult Spawn(BoxResources& resources, std::vector<FakeResource>& transformBuffers, const std::vector<Matrix>& transforms, unsigned int count)
+    {
+        SpawnResult r = {};
+        std::vector<std::unique_ptr<Box>> boxes;
+        boxes.reserve(count);
+        CountingContext context;
+        HardwareCounter cacheMisses(HardwareEvent::CacheMisses);
+        auto allocations = MemoryTracker::GetThreadAllocationCount();
+        auto start = Clock::now();
+        for (unsigned int i = 0u; i < count; i++)
+        {
+            const auto t = i % transforms.size();
+            boxes.push_back(std::make_unique<Box>(resources, transformBuffers[t], transforms[t]));
+        }
+        r.spawnMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        r.allocationsPerObject = double(MemoryTracker::GetThreadAllocationCount() - allocations) / double(count);
+
+        allocations = MemoryTracker::GetThreadAllocationCount();
+        cacheMisses.Start();
+        start = Clock::now();
+        DrawFrame(boxes, context);
+        r.firstFrameMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        r.cacheMisses = cacheMisses.Stop();
+        r.hasCounters = cacheMisses.IsAvailable();
+        r.firstFrameAllocations = MemoryTracker::GetThreadAllocationCount() - allocations;
+        allocations = MemoryTracker::GetThreadAllocationCount();
+        DrawFrame(boxes, context);
+        r.frameAllocations = MemoryTracker::GetThreadAllocationCount() - allocations;
+
+        std::vector<std::uintptr_t> lines;
+        std::size_t total = 0u;
+        for (const auto& pBox : boxes)
+        {
+            lines.clear();
+            pBox->CollectLines(lines, sizeof(Box));
+            std::sort(lines.begin(), lines.end());
+            total += std::size_t(std::unique(lines.begin(), lines.end()) - lines.begin());
+        }
+        r.linesPerObject = double(total) / double(count);
+        return r;
+    }
+
+    std::string Describe(const SpawnResult& r, unsigned int count)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << r.spawnMs << " ms, " << std::setprecision(2) << r.allocationsPerObject
+            << " allocations/object; first frame " << std::setprecision(1) << r.firstFrameMs << " ms, "
+            << r.firstFrameAllocations << " allocations; next frame " << r.frameAllocations << " allocations; "
+            << std::setprecision(2) << r.linesPerObject << " own cache lines/draw";
+        if (r.hasCounters)
+        {
+            out << ", " << double(r.cacheMisses) / double(count) << " cache misses/draw in the first frame";
+        }
+        return out.str();
+    }
+
+    template<class Boxes>
+    std::uint64_t FrameHash(const Boxes& boxes)
+    {
+        RecordingContext context;
+        DrawFrame(boxes, context);
+        return context.GetHash();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int objects = 10000u;
+    unsigned int frames = 100u;
+    unsigned int spawn = 100000u;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--objects" && i + 1 < argc)
+        {
+            objects = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            frames = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--spawn" && i + 1 < argc)
+        {
+            spawn = unsigned(std::stoul(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "usage: BindBench [--objects N] [--frames N] [--spawn N]" << std::endl;
+            return 1;
+        }
+    }
+    if (objects == 0u || frames == 0u || spawn == 0u)
+    {
+        std::cerr << "need at least one object, frame and spawned object" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        BoxResources resources;
+        std::vector<FakeResource> transformBuffers(objects);
+        std::vector<Matrix> transforms(objects);
+        std::mt19937 rng(1234u);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (auto& t : transforms)
+        {
+            for (auto& row : t.m)
+            {
+                for (auto& v : row)
+                {
+                    v = dist(rng);
+                }
+            }
+        }
+
+        std::vector<std::unique_ptr<Legacy::Box>> legacyBoxes;
+        std::vector<std::unique_ptr<Pooled::Box>> pooledBoxes;
+        for (unsigned int i = 0u; i < objects; i++)
+        {
+            legacyBoxes.push_back(std::make_unique<Legacy::Box>(resources, transformBuffers[i], transforms[i]));
+        }
+        for (unsigned int i = 0u; i < objects; i++)
+        {
+            pooledBoxes.push_back(std::make_unique<Pooled::Box>(resources, transformBuffers[i], transforms[i]));
+        }
+
+        const std::size_t draws = std::size_t(objects) * frames;
+        std::vector<unsigned char> evict(evictBytes);
+        std::cout << objects << " boxes x " << frames << " frames, 9 binds per draw" << std::endl;
+        for (const auto pEvict : { static_cast<std::vector<unsigned char>*>(nullptr), &evict })
+        {
+            const auto [legacy, pooled, streamed] = Measure(legacyBoxes, pooledBoxes, frames, pEvict);
+            std::cout << (pEvict ? "cold cache (evicted before each frame)" : "warm cache") << std::endl;
+            std::cout << "  unique_ptr + virtual Bind   " << Describe(legacy, draws) << std::endl;
+            std::cout << "  BindPool handles            " << Describe(pooled, draws) << std::endl;
+            std::cout << "  BindStream                  " << Describe(streamed, draws) << std::endl;
+        }
+        if (!HardwareCounter(HardwareEvent::CacheMisses).IsAvailable())
+        {
+            std::cout << "(hardware cache/branch counters unavailable here: cache and branch misses are not measured)" << std::endl;
+        }
+
+        const auto legacySpawn = Spawn<Legacy::Box>(resources, transformBuffers, transforms, spawn);
+        const auto pooledSpawn = Spawn<Pooled::Box>(resources, transformBuffers, transforms, spawn);
+        // 第一帧编译命令流
+        Pooled::Drawable::SetBindStreamEnabled(true);
+        const auto streamSpawn = Spawn<Pooled::Box>(resources, transformBuffers, transforms, spawn);
+        Pooled::Drawable::SetBindStreamEnabled(false);
+        std::cout << "spawn " << spawn << " boxes, then draw them twice (sizeof Box: " << sizeof(Legacy::Box) << " B before, "
+                  << sizeof(Pooled::Box) << " B now)" << std::endl;
+        std::cout << "  unique_ptr + virtual Bind   " << Describe(legacySpawn, spawn) << std::endl;
+        std::cout << "  BindPool handles            " << Describe(pooledSpawn, spawn) << std::endl;
+        std::cout << "  BindStream                  " << Describe(streamSpawn, spawn) << std::endl;
+
+        bool ok = true;
+        // make_unique<Box> 本身一次；之前还有 binds 的 vector 和 TransformCbuf 各一次
+        if (legacySpawn.allocationsPerObject < 3.0 || pooledSpawn.allocationsPerObject > 1.0 || streamSpawn.allocationsPerObject > 1.0)
+        {
+            std::cout << "FAIL: expected 3 allocations per legacy box and 1 per pooled box" << std::endl;
+            ok = false;
+        }
+        if (legacySpawn.frameAllocations != 0u || pooledSpawn.firstFrameAllocations != 0u || pooledSpawn.frameAllocations != 0u ||
+            streamSpawn.firstFrameAllocations != 0u || streamSpawn.frameAllocations != 0u)
+        {
+            std::cout << "FAIL: drawing allocated on the heap" << std::endl;
+            ok = false;
+        }
+        if (pooledSpawn.linesPerObject > legacySpawn.linesPerObject)
+        {
+            std::cout << "FAIL: a pooled box reads more of its own cache lines per draw than a legacy box" << std::endl;
+            ok = false;
+        }
+        const auto legacyHash = FrameHash(legacyBoxes);
+        Pooled::Drawable::SetBindStreamEnabled(false);
+        const auto pooledHash = FrameHash(pooledBoxes);
+        Pooled::Drawable::SetBindStreamEnabled(true);
+        const auto streamHash = FrameHash(pooledBoxes);
+        Pooled::Drawable::SetBindStreamEnabled(false);
+        if (legacyHash != pooledHash || legacyHash != streamHash)
+        {
+            std::cout << "FAIL: the bind paths made different device calls" << std::endl;
+            ok = false;
+        }
+        std::cout << (ok ? "OK" : "FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
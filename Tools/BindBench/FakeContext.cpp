@@ -0,0 +1,170 @@
+#include "FakeContext.h"
+#include <cstring>
+
+void CountingContext::IASetVertexBuffer(void* pBuffer, UINT stride_in) noexcept
+{
+    calls++;
+    pVertexBuffer = pBuffer;
+    stride = stride_in;
+}
+
+void CountingContext::IASetIndexBuffer(void* pBuffer, UINT format_in) noexcept
+{
+    calls++;
+    pIndexBuffer = pBuffer;
+    format = format_in;
+}
+
+void CountingContext::IASetInputLayout(void* pLayout) noexcept
+{
+    calls++;
+    pInputLayout = pLayout;
+}
+
+void CountingContext::IASetPrimitiveTopology(UINT topology_in) noexcept
+{
+    calls++;
+    topology = topology_in;
+}
+
+void CountingContext::VSSetShader(void* pShader) noexcept
+{
+    calls++;
+    pVertexShader = pShader;
+}
+
+void CountingContext::PSSetShader(void* pShader) noexcept
+{
+    calls++;
+    pPixelShader = pShader;
+}
+
+void CountingContext::VSSetConstantBuffer(UINT, void* pBuffer) noexcept
+{
+    calls++;
+    pVertexConstants = pBuffer;
+}
+
+void CountingContext::PSSetConstantBuffer(UINT, void* pBuffer) noexcept
+{
+    calls++;
+    pPixelConstants = pBuffer;
+}
+
+void CountingContext::RSSetState(void* pState) noexcept
+{
+    calls++;
+    pRasterizer = pState;
+}
+
+void* CountingContext::Map(void* pBuffer) noexcept
+{
+    calls++;
+    pMapped = pBuffer;
+    return mapped;
+}
+
+void CountingContext::Unmap(void*) noexcept
+{
+    calls++;
+    pMapped = nullptr;
+}
+
+void CountingContext::DrawIndexed(UINT count, UINT, int) noexcept
+{
+    calls++;
+    draws++;
+    indices += count;
+}
+
+void RecordingContext::Mix(std::uint64_t value) noexcept
+{
+    calls++;
+    hash = (hash ^ value) * 1099511628211ull;
+}
+
+void RecordingContext::IASetVertexBuffer(void* pBuffer, UINT stride) noexcept
+{
+    Mix(1u);
+    Mix(std::uintptr_t(pBuffer));
+    Mix(stride);
+}
+
+void RecordingContext::IASetIndexBuffer(void* pBuffer, UINT format) noexcept
+{
+    Mix(2u);
+    Mix(std::uintptr_t(pBuffer));
+    Mix(format);
+}
+
+void RecordingContext::IASetInputLayout(void* pLayout) noexcept
+{
+    Mix(3u);
+    Mix(std::uintptr_t(pLayout));
+}
+
+void RecordingContext::IASetPrimitiveTopology(UINT topology) noexcept
+{
+    Mix(4u);
+    Mix(topology);
+}
+
+void RecordingContext::VSSetShader(void* pShader) noexcept
+{
+    Mix(5u);
+    Mix(std::uintptr_t(pShader));
+}
+
+void RecordingContext::PSSetShader(void* pShader) noexcept
+{
+    Mix(6u);
+    Mix(std::uintptr_t(pShader));
+}
+
+void RecordingContext::VSSetConstantBuffer(UINT slot, void* pBuffer) noexcept
+{
+    Mix(7u);
+    Mix(slot);
+    Mix(std::uintptr_t(pBuffer));
+}
+
+void RecordingContext::PSSetConstantBuffer(UINT slot, void* pBuffer) noexcept
+{
+    Mix(8u);
+    Mix(slot);
+    Mix(std::uintptr_t(pBuffer));
+}
+
+void RecordingContext::RSSetState(void* pState) noexcept
+{
+    Mix(9u);
+    Mix(std::uintptr_t(pState));
+}
+
+void* RecordingContext::Map(void* pBuffer) noexcept
+{
+    Mix(10u);
+    Mix(std::uintptr_t(pBuffer));
+    return mapped;
+}
+
+void RecordingContext::Unmap(void* pBuffer) noexcept
+{
+    Mix(11u);
+    Mix(std::uintptr_t(pBuffer));
+    std::uint64_t words[8];
+    std::memcpy(words, mapped, sizeof(words));
+    for (const auto w : words)
+    {
+        Mix(w);
+    }
+}
+
+void RecordingContext::DrawIndexed(UINT count, UINT startIndex, int baseVertex) noexcept
+{
+    draws++;
+    Mix(12u);
+    Mix(count);
+    Mix(startIndex);
+    Mix(std::uint64_t(std::int64_t(baseVertex)));
+}
@@ -0,0 +1,105 @@
+#pragma once
+// BindBench 用的设备上下文替身。
+// 代替 ID3D11DeviceContext：虚函数在另一个编译单元里实现，编译器看不到里面，和真的 COM 调用一样不能内联
+#include <cstdint>
+
+using UINT = unsigned int;
+
+class FakeContext
+{
+public:
+    virtual ~FakeContext() = default;
+    virtual void IASetVertexBuffer(void* pBuffer, UINT stride) noexcept = 0;
+    virtual void IASetIndexBuffer(void* pBuffer, UINT format) noexcept = 0;
+    virtual void IASetInputLayout(void* pLayout) noexcept = 0;
+    virtual void IASetPrimitiveTopology(UINT topology) noexcept = 0;
+    virtual void VSSetShader(void* pShader) noexcept = 0;
+    virtual void PSSetShader(void* pShader) noexcept = 0;
+    virtual void VSSetConstantBuffer(UINT slot, void* pBuffer) noexcept = 0;
+    virtual void PSSetConstantBuffer(UINT slot, void* pBuffer) noexcept = 0;
+    virtual void RSSetState(void* pState) noexcept = 0;
+    // 返回一块 64 字节的可写内存
+    virtual void* Map(void* pBuffer) noexcept = 0;
+    virtual void Unmap(void* pBuffer) noexcept = 0;
+    virtual void DrawIndexed(UINT count, UINT startIndex, int baseVertex) noexcept = 0;
+};
+
+// 只记下当前状态和调用次数，计时用；和真的上下文一样 Set 调用都很便宜
+class CountingContext : public FakeContext
+{
+public:
+    void IASetVertexBuffer(void* pBuffer, UINT stride) noexcept override;
+    void IASetIndexBuffer(void* pBuffer, UINT format) noexcept override;
+    void IASetInputLayout(void* pLayout) noexcept override;
+    void IASetPrimitiveTopology(UINT topology) noexcept override;
+    void VSSetShader(void* pShader) noexcept override;
+    void PSSetShader(void* pShader) noexcept override;
+    void VSSetConstantBuffer(UINT slot, void* pBuffer) noexcept override;
+    void PSSetConstantBuffer(UINT slot, void* pBuffer) noexcept override;
+    void RSSetState(void* pState) noexcept override;
+    void* Map(void* pBuffer) noexcept override;
+    void Unmap(void* pBuffer) noexcept override;
+    void DrawIndexed(UINT count, UINT startIndex, int baseVertex) noexcept override;
+    unsigned long long GetCallCount() const noexcept
+    {
+        return calls;
+    }
+    unsigned long long GetDrawCount() const noexcept
+    {
+        return draws;
+    }
+private:
+    unsigned long long calls = 0u;
+    unsigned long long draws = 0u;
+    unsigned long long indices = 0u;
+    void* pVertexBuffer = nullptr;
+    void* pIndexBuffer = nullptr;
+    void* pInputLayout = nullptr;
+    void* pVertexShader = nullptr;
+    void* pPixelShader = nullptr;
+    void* pVertexConstants = nullptr;
+    void* pPixelConstants = nullptr;
+    void* pRasterizer = nullptr;
+    void* pMapped = nullptr;
+    UINT stride = 0u;
+    UINT format = 0u;
+    UINT topology = 0u;
+    alignas(16) unsigned char mapped[64] = {};
+};
+
+// 把收到的每个调用（包括 Map 里写进去的字节）按顺序混进一个哈希，两种绑定路径做的事一样哈希就一样
+class RecordingContext : public FakeContext
+{
+public:
+    void IASetVertexBuffer(void* pBuffer, UINT stride) noexcept override;
+    void IASetIndexBuffer(void* pBuffer, UINT format) noexcept override;
+    void IASetInputLayout(void* pLayout) noexcept override;
+    void IASetPrimitiveTopology(UINT topology) noexcept override;
+    void VSSetShader(void* pShader) noexcept override;
+    void PSSetShader(void* pShader) noexcept override;
+    void VSSetConstantBuffer(UINT slot, void* pBuffer) noexcept override;
+    void PSSetConstantBuffer(UINT slot, void* pBuffer) noexcept override;
+    void RSSetState(void* pState) noexcept override;
+    void* Map(void* pBuffer) noexcept override;
+    void Unmap(void* pBuffer) noexcept override;
+    void DrawIndexed(UINT count, UINT startIndex, int baseVertex) noexcept override;
+    std::uint64_t GetHash() const noexcept
+    {
+        return hash;
+    }
+    unsigned long long GetCallCount() const noexcept
+    {
+        return calls;
+    }
+    unsigned long long GetDrawCount() const noexcept
+    {
+        return draws;
+    }
+private:
+    void Mix(std::uint64_t value) noexcept;
+private:
+    std::uint64_t hash = 14695981039346656037ull;
+    unsigned long long calls = 0u;
+    unsigned long long draws = 0u;
+    alignas(16) unsigned char mapped[64] = {};
+};
@@ -0,0 +1,81 @@
+#pragma once
+// 当前线程的硬件计数器（缓存未命中、分支预测失败）。
+// 只在 Linux 上用 perf_event_open 实现；其他平台、虚拟机里没有 PMU、或者 perf_event_paranoid 不允许时 IsAvailable 返回 false
+#include <cstdint>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+enum class HardwareEvent
+{
+    CacheMisses,
+    BranchMisses
+};
+
+class HardwareCounter
+{
+public:
+    explicit HardwareCounter(HardwareEvent event) noexcept
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = event == HardwareEvent::CacheMisses ? PERF_COUNT_HW_CACHE_MISSES : PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void)event;
+#endif
+    }
+    HardwareCounter(const HardwareCounter&) = delete;
+    HardwareCounter& operator=(const HardwareCounter&) = delete;
+    ~HardwareCounter()
+    {
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+#endif
+    }
+    bool IsAvailable() const noexcept
+    {
+        return fd >= 0;
+    }
+    void Start() noexcept
+    {
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    // 从 Start 到现在的事件数，不可用时返回 0
+    std::uint64_t Stop() noexcept
+    {
+        std::uint64_t value = 0u;
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &value, sizeof(value)) != ssize_t(sizeof(value)))
+            {
+                value = 0u;
+            }
+        }
+#endif
+        return value;
+    }
+private:
+    int fd = -1;
+};
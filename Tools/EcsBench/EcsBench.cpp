@@ -0,0 +1,375 @@
+// ECS 的创建、更新和遍历测试：
+// 1. 组件和 App 的盒子一样：BoxMotion 的 13 个 float、64 字节的世界矩阵、一个空的 BoxInstance 标记，
+//    变换按 BoxMotion::GetTransformXM 的顺序算（自转、平移 r、绕原点转、往远处平移）；
+// 2. 创建 --entities 个实体：逐个 Create、CreateMany，以及原来的做法——每个物体 make_unique 一个带虚函数的堆对象；
+//    堆对象建两份：按遍历顺序连续分配的（刚启动、分配器把它们排成一条），和按打乱的顺序分配的（场景增删过之后）；
+// 3. 更新（推进运动并写矩阵）：ForEach、ParallelForEach 和两份堆对象的虚函数 Update，
+//    只读遍历（把所有平移加起来，相当于绘制时读矩阵）：ForEach 和两份堆对象；
+//    每一轮各跑一遍，跑 --passes 轮取各自最快的，机器负载的漂移对各方一样；
+// 4. 检查：实体数对，ECS 和两份堆对象更新同样遍数之后的矩阵一致。
+// usage: EcsBench [--entities N] [--passes N] [--threads N]
+#include "Ecs.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr float dt = 1.0f / 60.0f;
+
+    // 和 SceneComponents.h 的 BoxMotion / WorldTransform / BoxInstance 同样的布局（那边依赖 DirectXMath）
+    struct BoxMotion
+    {
+        void Advance(float dt) noexcept
+        {
+            roll += droll * dt;
+            pitch += dpitch * dt;
+            yaw += dyaw * dt;
+            theta += dtheta * dt;
+            phi += dphi * dt;
+            chi += dchi * dt;
+        }
+        float r;
+        float roll;
+        float pitch;
+        float yaw;
+        float theta;
+        float phi;
+        float chi;
+        float droll;
+        float dpitch;
+        float dyaw;
+        float dtheta;
+        float dphi;
+        float dchi;
+    };
+    struct WorldTransform
+    {
+        float m[4][4];
+    };
+    struct BoxInstance
+    {
+        unsigned char unused;
+    };
+
+    // XMMatrixRotationRollPitchYaw 的 3x3 部分（行向量）
+    void RotationRollPitchYaw(float pitch, float yaw, float roll, float out[3][3]) noexcept
+    {
+        const float cp = std::cos(pitch), sp = std::sin(pitch);
+        const float cy = std::cos(yaw), sy = std::sin(yaw);
+        const float cr = std::cos(roll), sr = std::sin(roll);
+        out[0][0] = cr * cy + sr * sp * sy;
+        out[0][1] = sr * cp;
+        out[0][2] = sr * sp * cy - cr * sy;
+        out[1][0] = cr * sp * sy - sr * cy;
+        out[1][1] = cr * cp;
+        out[1][2] = sr * sy + cr * sp * cy;
+        out[2][0] = cp * sy;
+        out[2][1] = -sp;
+        out[2][2] = cp * cy;
+    }
+
+    // RotationRollPitchYaw(pitch, yaw, roll) * Translation(r, 0, 0) * RotationRollPitchYaw(theta, phi, chi) * Translation(0, 0, 20)
+    void ComputeTransform(const BoxMotion& motion, WorldTransform& transform) noexcept
+    {
+        float local[3][3];
+        float world[3][3];
+        RotationRollPitchYaw(motion.pitch, motion.yaw, motion.roll, local);
+        RotationRollPitchYaw(motion.theta, motion.phi, motion.chi, world);
+        for (int row = 0; row < 3; row++)
+        {
+            for (int col = 0; col < 3; col++)
+            {
+                transform.m[row][col] = local[row][0] * world[0][col] + local[row][1] * world[1][col] + local[row][2] * world[2][col];
+            }
+            transform.m[row][3] = 0.0f;
+        }
+        for (int col = 0; col < 3; col++)
+        {
+            transform.m[3][col] = motion.r * world[0][col];
+        }
+        transform.m[3][2] += 20.0f;
+        transform.m[3][3] = 1.0f;
+    }
+
+    // 和 App 生成盒子用的分布一样
+    std::vector<BoxMotion> RandomMotions(std::size_t count)
+    {
+        std::mt19937 rng(1234u);
+        std::uniform_real_distribution<float> adist(0.0f, 3.1415f * 2.0f);
+        std::uniform_real_distribution<float> ddist(0.0f, 3.1415f * 2.0f);
+        std::uniform_real_distribution<float> odist(0.0f, 3.1415f * 0.3f);
+        std::uniform_real_distribution<float> rdist(6.0f, 20.0f);
+        std::vector<BoxMotion> motions(count);
+        for (auto& m : motions)
+        {
+            m = {};
+            m.r = rdist(rng);
+            m.droll = ddist(rng);
+            m.dpitch = ddist(rng);
+            m.dyaw = ddist(rng);
+            m.dphi = odist(rng);
+            m.dtheta = odist(rng);
+            m.dchi = odist(rng);
+            m.chi = adist(rng);
+            m.theta = adist(rng);
+            m.phi = adist(rng);
+        }
+        return motions;
+    }
+
+    // ECS 之前的做法：每个盒子一个 Drawable 派生的堆对象，每帧经过基类指针调用 Update
+    class SceneObject
+    {
+    public:
+        virtual ~SceneObject() = default;
+        virtual void Update(float dt) noexcept = 0;
+        virtual const WorldTransform& GetTransform() const noexcept = 0;
+    };
+
+    class BoxObject : public SceneObject
+    {
+    public:
+        explicit BoxObject(const BoxMotion& motion) noexcept
+            :
+            motion(motion),
+            transform{}
+        {}
+        void Update(float dt) noexcept override
+        {
+            motion.Advance(dt);
+            ComputeTransform(motion, transform);
+        }
+        const WorldTransform& GetTransform() const noexcept override
+        {
+            return transform;
+        }
+    private:
+        BoxMotion motion;
+        WorldTransform transform;
+    };
+
+    double Ms(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    using Objects = std::vector<std::unique_ptr<SceneObject>>;
+
+    double Time(const std::function<void()>& f)
+    {
+        const auto start = Clock::now();
+        f();
+        return Ms(start);
+    }
+
+    double SumTranslations(World& world)
+    {
+        double sum = 0.0;
+        world.ForEach<const WorldTransform, const BoxInstance>([&sum](const WorldTransform& transform, const BoxInstance&) {
+            sum += double(transform.m[3][0]) + double(transform.m[3][1]) + double(transform.m[3][2]);
+        });
+        return sum;
+    }
+
+    double SumTranslations(const Objects& objects)
+    {
+        double sum = 0.0;
+        for (const auto& pObject : objects)
+        {
+            const auto& transform = pObject->GetTransform();
+            sum += double(transform.m[3][0]) + double(transform.m[3][1]) + double(transform.m[3][2]);
+        }
+        return sum;
+    }
+
+    std::string PerEntity(double ms, std::size_t count)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << ms << " ms (" << ms * 1e6 / double(count) << " ns/entity)";
+        return out.str();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t entities = 1000000u;
+    unsigned int passes = 9u;
+    unsigned int threads = 0u;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--entities" && i + 1 < argc)
+        {
+            entities = std::size_t(std::stoull(argv[++i]));
+        }
+        else if (arg == "--passes" && i + 1 < argc)
+        {
+            passes = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            threads = unsigned(std::stoul(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "usage: EcsBench [--entities N] [--passes N] [--threads N]" << std::endl;
+            return 1;
+        }
+    }
+    if (entities == 0u || passes == 0u)
+    {
+        std::cerr << "need at least one entity and one pass" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        const auto motions = RandomMotions(entities);
+        ThreadPool pool(threads);
+        std::cout << entities << " entities (BoxMotion " << sizeof(BoxMotion) << " B, WorldTransform " << sizeof(WorldTransform)
+                  << " B, BoxInstance " << sizeof(BoxInstance) << " B), " << pool.GetWorkerCount() << " workers" << std::endl;
+        bool ok = true;
+
+        // 创建
+        double createMs;
+        {
+            World world;
+            const auto start = Clock::now();
+            for (std::size_t i = 0u; i < entities; i++)
+            {
+                world.Create(motions[i], WorldTransform{}, BoxInstance{});
+            }
+            createMs = Ms(start);
+            if (world.GetEntityCount() != entities)
+            {
+                std::cout << "FAIL: Create made " << world.GetEntityCount() << " entities" << std::endl;
+                ok = false;
+            }
+        }
+        World world;
+        auto start = Clock::now();
+        // CreateMany 不构造组件，每个都要写
+        world.CreateMany<BoxMotion, WorldTransform, BoxInstance>(entities,
+            [&motions](std::size_t i, BoxMotion& motion, WorldTransform& transform, BoxInstance& instance) {
+                motion = motions[i];
+                transform = {};
+                instance = {};
+            });
+        const auto createManyMs = Ms(start);
+        if (world.GetEntityCount() != entities || world.GetArchetypeCount() != 1u)
+        {
+            std::cout << "FAIL: CreateMany made " << world.GetEntityCount() << " entities in " << world.GetArchetypeCount() << " archetypes" << std::endl;
+            ok = false;
+        }
+        Objects objects;
+        start = Clock::now();
+        objects.reserve(entities);
+        for (std::size_t i = 0u; i < entities; i++)
+        {
+            objects.push_back(std::make_unique<BoxObject>(motions[i]));
+        }
+        const auto objectsMs = Ms(start);
+        // 同样的物体，按打乱的顺序分配，遍历顺序和地址顺序无关
+        Objects scattered(entities);
+        {
+            std::vector<std::size_t> order(entities);
+            for (std::size_t i = 0u; i < entities; i++)
+            {
+                order[i] = i;
+            }
+            std::shuffle(order.begin(), order.end(), std::mt19937(99u));
+            for (const auto i : order)
+            {
+                scattered[i] = std::make_unique<BoxObject>(motions[i]);
+            }
+        }
+        std::cout << "spawn" << std::endl;
+        std::cout << "  World::Create      " << PerEntity(createMs, entities) << std::endl;
+        std::cout << "  World::CreateMany  " << PerEntity(createManyMs, entities) << std::endl;
+        std::cout << "  heap objects       " << PerEntity(objectsMs, entities) << std::endl;
+
+        // 更新：每轮 ECS 串行、并行各推进一步，堆对象各一步，最后给堆对象补上 passes 步，几方推进的步数一样
+        const auto updateObjects = [](Objects& set) {
+            for (auto& pObject : set)
+            {
+                pObject->Update(dt);
+            }
+        };
+        double forEachMs = 1e30;
+        double parallelMs = 1e30;
+        double virtualMs = 1e30;
+        double scatteredMs = 1e30;
+        for (unsigned int p = 0u; p < passes; p++)
+        {
+            forEachMs = std::min(forEachMs, Time([&world] {
+                world.ForEach<BoxMotion, WorldTransform>([](BoxMotion& motion, WorldTransform& transform) {
+                    motion.Advance(dt);
+                    ComputeTransform(motion, transform);
+                });
+            }));
+            parallelMs = std::min(parallelMs, Time([&world, &pool] {
+                world.ParallelForEach<BoxMotion, WorldTransform>(pool, [](BoxMotion& motion, WorldTransform& transform) {
+                    motion.Advance(dt);
+                    ComputeTransform(motion, transform);
+                });
+            }));
+            virtualMs = std::min(virtualMs, Time([&] { updateObjects(objects); }));
+            scatteredMs = std::min(scatteredMs, Time([&] { updateObjects(scattered); }));
+        }
+        for (unsigned int p = 0u; p < passes; p++)
+        {
+            updateObjects(objects);
+            updateObjects(scattered);
+        }
+        std::cout << "update, best of " << passes << " (" << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+        std::cout << "  ForEach            " << PerEntity(forEachMs, entities) << std::endl;
+        std::cout << "  ParallelForEach    " << PerEntity(parallelMs, entities) << std::endl;
+        std::cout << "  virtual Update     " << PerEntity(virtualMs, entities) << std::endl;
+        std::cout << "    scattered        " << PerEntity(scatteredMs, entities) << std::endl;
+
+        // 只读遍历
+        double ecsSum = 0.0;
+        double objectSum = 0.0;
+        double scatteredSum = 0.0;
+        double iterateMs = 1e30;
+        double iterateObjectsMs = 1e30;
+        double iterateScatteredMs = 1e30;
+        for (unsigned int p = 0u; p < passes; p++)
+        {
+            iterateMs = std::min(iterateMs, Time([&] { ecsSum = SumTranslations(world); }));
+            iterateObjectsMs = std::min(iterateObjectsMs, Time([&] { objectSum = SumTranslations(objects); }));
+            iterateScatteredMs = std::min(iterateScatteredMs, Time([&] { scatteredSum = SumTranslations(scattered); }));
+        }
+        std::cout << "iterate (read translation), best of " << passes << std::endl;
+        std::cout << "  ForEach            " << PerEntity(iterateMs, entities) << std::endl;
+        std::cout << "  heap objects       " << PerEntity(iterateObjectsMs, entities) << std::endl;
+        std::cout << "    scattered        " << PerEntity(iterateScatteredMs, entities) << std::endl;
+
+        if (std::abs(ecsSum - objectSum) > 1e-9 * std::abs(objectSum) || ecsSum == 0.0 || scatteredSum != objectSum)
+        {
+            std::cout << std::setprecision(17) << "FAIL: ECS and heap objects disagree after the same updates: " << ecsSum << " vs "
+                      << objectSum << " vs " << scatteredSum << std::endl;
+            ok = false;
+        }
+        std::cout << (ok ? "OK" : "FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,427 @@
+// 每帧 CPU 部分的无头模拟，检查稳定运行时没有堆分配：
+// 1. 按 App::DoFrame 的顺序跑一帧：ECS 上并行推进运动和 LOD 选择（LodSelector::Update），
+//    用 App 的投影剔除、从近到远排序的绘制列表（DrawList，和 DrawBoxes 一样放在 FrameMemory 上）并按级别统计，
+//    纹理流送（TextureStreamer::Update，候选列表在 FrameMemory 上），计数器 EndFrame，
+//    半秒一次的标题（栈上格式化）和内存预算检查，最后 FrameMemory::NextFrame；
+// 2. 先预热到纹理全部流送到目标层、没有在读的层（至少 8 帧，和 App 的 warmupFrames 一样），
+//    再跑 --frames 帧，每帧前后取主线程的 MemoryTracker::GetThreadAllocationCount；
+// 3. 检查：预热之后每一帧的差值都是 0，LOD 选择一直在换级（不是什么都没做的帧），有实例被剔除也有实例留下，
+//    报告 FrameMemory 的高水位；
+// 4. 同样的绘制列表用 FrameMemory 和用 std::allocator 各建 --frames 次，比较每帧的耗时和堆分配次数。
+// usage: FrameSim [--instances N] [--frames N] [--textures N] [--threads N]
+#include "DrawList.h"
+#include "Ecs.h"
+#include "FrameArena.h"
+#include "ImageCodecs.h"
+#include "LodSelector.h"
+#include "MemoryTracker.h"
+#include "PerfCounters.h"
+#include "TextureStreamer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr unsigned int warmupFrames = 8u;
+    constexpr unsigned int maxWarmupFrames = 600u;
+    constexpr float dt = 1.0f / 60.0f;
+    // App 的投影和窗口
+    constexpr float projectionYScale = 4.0f / 3.0f;
+    constexpr float viewportHeight = 600.0f;
+    constexpr float titleSeconds = 0.5f;
+    // XMMatrixPerspectiveLH(1, 3/4, 0.5, 40)，行向量
+    constexpr float projection[4][4] = {
+        { 1.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 4.0f / 3.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 40.0f / 39.5f, 1.0f },
+        { 0.0f, 0.0f, -0.5f * 40.0f / 39.5f, 0.0f },
+    };
+    constexpr float modelRadius = 1.0f;
+    // 各级 LOD 的三角形数和几何误差（半径 1 的模型）
+    const std::vector<float> lodErrors = { 0.004f, 0.012f, 0.03f };
+    constexpr std::uint32_t lodTriangles[] = { 20000u, 10000u, 5000u, 2500u };
+
+    // 实例在深度 3 到 35 之间往返，一直有实例穿过切换点；横向分散开，近的时候两边的会出视锥
+    struct Orbit
+    {
+        float phase;
+        float speed;
+    };
+    struct Position
+    {
+        float center[3];
+    };
+
+    void AnimateInstances(World& world, ThreadPool& pool, const LodSelector& selector, float t)
+    {
+        world.ParallelForEach<const Orbit, Position, LodState>(pool, [&selector, t](const Orbit& orbit, Position& position, LodState& lod) {
+            position.center[2] = 19.0f + 16.0f * std::sin(t * orbit.speed + orbit.phase);
+            selector.Update(lod, LodSelector::ProjectedDiameter(position.center[2], modelRadius, projectionYScale, viewportHeight), dt);
+        });
+    }
+
+    // 和 DrawBoxes 一样：剔除、排序，Allocator 决定列表放在哪里
+    template<typename Allocator = FrameAllocator<DrawItem<LodState>>>
+    DrawList<LodState, Allocator> BuildDrawList(World& world)
+    {
+        DrawList<LodState, Allocator> drawList(projection, world.Count<Position, LodState>());
+        world.ForEach<const Position, const LodState>([&drawList](const Position& position, const LodState& lod) {
+            drawList.Add(lod, position.center, modelRadius);
+        });
+        drawList.SortFrontToBack();
+        return drawList;
+    }
+
+    // 每级一个计数，淡入淡出中的实例两级都画；返回这一帧画的三角形数
+    std::uint64_t CountDraws(World& world, unsigned int levels, std::size_t& visible)
+    {
+        const auto drawList = BuildDrawList(world);
+        visible = drawList.size();
+        FrameVector<std::uint32_t> perLevel(levels, 0u);
+        for (const auto& item : drawList)
+        {
+            perLevel[item.pObject->level]++;
+            if (item.pObject->IsFading())
+            {
+                perLevel[item.pObject->previous]++;
+            }
+        }
+        std::uint64_t triangles = 0u;
+        for (unsigned int l = 0u; l < levels; l++)
+        {
+            PerfCounters::Add(PerfCounter::DrawCalls, perLevel[l]);
+            PerfCounters::Add(PerfCounter::IndicesDrawn, std::int64_t(perLevel[l]) * lodTriangles[l] * 3);
+            triangles += std::uint64_t(perLevel[l]) * lodTriangles[l];
+        }
+        return triangles;
+    }
+
+    // 和 App::DoFrame 的标题、App::CheckMemoryBudgets 一样
+    void RefreshTitle(unsigned int& overBudgetTags, std::string& lastTitle)
+    {
+        char title[160] = "DirectX11 | ";
+        PerfCounters::FormatSummary(title + std::strlen(title), sizeof(title) - std::strlen(title));
+        // 窗口标题在这里换成拷贝到一个预留过容量的字符串
+        lastTitle.assign(title);
+        for (unsigned int t = 0u; t < unsigned(MemoryTag::Count); t++)
+        {
+            const auto usage = MemoryTracker::GetUsage(MemoryTag(t));
+            const auto bit = 1u << t;
+            if (usage.IsOverBudget() && !(overBudgetTags & bit))
+            {
+                char line[128];
+                std::snprintf(line, sizeof(line), "[Memory] %s over budget: %lld KB of %lld KB\n",
+                    MemoryTracker::GetTagName(MemoryTag(t)), usage.GetTotalBytes() / 1024, usage.budgetBytes / 1024);
+                std::fputs(line, stdout);
+            }
+            overBudgetTags = usage.IsOverBudget() ? overBudgetTags | bit : overBudgetTags & ~bit;
+        }
+    }
+
+    std::vector<std::string> WriteTextures(const std::filesystem::path& dir, unsigned int count, std::size_t& totalBytes)
+    {
+        std::filesystem::create_directories(dir);
+        std::vector<std::string> paths;
+        totalBytes = 0u;
+        for (unsigned int i = 0u; i < count; i++)
+        {
+            const std::uint32_t size = 256u << (i % 3u);
+            Image image(size, size, ImageFormat::BC1, 0u);
+            for (std::uint32_t level = 0u; level < image.GetMipCount(); level++)
+            {
+                std::memset(image.GetMipData(level), int(i * 16u + level), image.GetMip(level).size);
+                totalBytes += image.GetMip(level).size;
+            }
+            const auto bytes = ImageCodecs::EncodeDds(image);
+            paths.push_back((dir / ("texture" + std::to_string(i) + ".dds")).string());
+            std::ofstream file(paths.back(), std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+            if (!file)
+            {
+                throw std::runtime_error("cannot write " + paths.back());
+            }
+        }
+        return paths;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int instances = 5000u;
+    unsigned int frames = 1200u;
+    unsigned int textureCount = 6u;
+    unsigned int threads = 0u;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--instances" && i + 1 < argc)
+        {
+            instances = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            frames = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--textures" && i + 1 < argc)
+        {
+            textureCount = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            threads = unsigned(std::stoul(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "usage: FrameSim [--instances N] [--frames N] [--textures N] [--threads N]" << std::endl;
+            return 1;
+        }
+    }
+    if (instances == 0u || frames == 0u || textureCount == 0u)
+    {
+        std::cerr << "need at least one instance, frame and texture" << std::endl;
+        return 1;
+    }
+
+    const auto dir = std::filesystem::temp_directory_path() / "FrameSim";
+    try
+    {
+        std::size_t totalBytes;
+        const auto paths = WriteTextures(dir, textureCount, totalBytes);
+        // 预算放得下所有层，稳定之后不再有读取
+        SimulatedStreamingDevice device;
+        TextureStreamer streamer(device, totalBytes);
+        std::vector<StreamedTextureId> ids;
+        for (const auto& path : paths)
+        {
+            ids.push_back(streamer.Register(path, false));
+        }
+
+        ThreadPool pool(threads);
+        World world;
+        // CreateMany 不构造组件，每个都要写
+        world.CreateMany<Orbit, Position, LodState>(instances, [instances](std::size_t i, Orbit& orbit, Position& position, LodState& lod) {
+            orbit.phase = 6.2831853f * float(i) / float(instances);
+            orbit.speed = 0.3f + 0.4f * float(i % 7u) / 7.0f;
+            position.center[0] = (float(i % 11u) - 5.0f) * 2.5f;
+            position.center[1] = (float(i % 5u) - 2.0f) * 2.0f;
+            position.center[2] = 19.0f;
+            lod = {};
+        });
+        const LodSelector selector(lodErrors, 1.0f, LodSettings{});
+        unsigned int overBudgetTags = 0u;
+        std::string title;
+        title.reserve(256u);
+
+        unsigned long long frameAllocations = 0u;
+        unsigned int framesWithAllocations = 0u;
+        unsigned int worstFrame = 0u;
+        unsigned long long worstAllocations = 0u;
+        unsigned long long levelChanges = 0u;
+        std::uint64_t triangles = 0u;
+        std::size_t visible = 0u;
+        std::size_t minVisible = instances;
+        std::size_t maxVisible = 0u;
+        float titleTimer = 0.0f;
+        unsigned int warmup = 0u;
+        double measuredMs = 0.0;
+        for (unsigned int f = 0u; f < maxWarmupFrames + frames; f++)
+        {
+            // 预热：纹理都到了目标层、没有在读的层之后再数
+            const bool measuring = warmup != 0u;
+            if (!measuring && f >= warmupFrames && streamer.GetLoadsInFlight() == 0u)
+            {
+                bool settled = true;
+                for (const auto id : ids)
+                {
+                    settled &= streamer.GetResidentMip(id) == streamer.GetTargetMip(id);
+                }
+                if (settled)
+                {
+                    warmup = f;
+                    continue;
+                }
+            }
+            if (measuring && f >= warmup + frames)
+            {
+                break;
+            }
+            if (!measuring && f == maxWarmupFrames)
+            {
+                throw std::runtime_error("textures did not settle within " + std::to_string(maxWarmupFrames) + " frames");
+            }
+
+            const auto start = Clock::now();
+            const auto allocationsBefore = MemoryTracker::GetThreadAllocationCount();
+            const float t = float(f) * dt;
+            AnimateInstances(world, pool, selector, t);
+            triangles = CountDraws(world, selector.GetLevelCount(), visible);
+            for (std::size_t i = 0u; i < ids.size(); i++)
+            {
+                streamer.ReportUsage(ids[i], 200.0f * float(1u + i % 4u));
+            }
+            if (!measuring)
+            {
+                streamer.WaitForLoads();
+        // 只有绘制列表，分别放在 FrameMemory 和通用堆上
+        const auto listFrameMemory = [&world] {
+            const auto drawList = BuildDrawList(world);
+            FrameMemory::NextFrame();
+            return drawList.size();
+        };
+        const auto listHeap = [&world] {
+            const auto drawList = BuildDrawList<std::allocator<DrawItem<LodState>>>(world);
+            FrameMemory::NextFrame();
+            return drawList.size();
+        };
+        const auto timeLists = [frames](auto&& build, unsigned long long& allocations) {
+            const auto allocationsBefore = MemoryTracker::GetThreadAllocationCount();
+            const auto start = Clock::now();
+            std::size_t sink = 0u;
+            for (unsigned int f = 0u; f < frames; f++)
+            {
+                sink += build();
+            }
+            const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / frames;
+            allocations = MemoryTracker::GetThreadAllocationCount() - allocationsBefore;
+            return sink != 0u ? us : 0.0;
+        };
+        unsigned long long frameMemoryAllocations;
+        unsigned long long heapAllocations;
+        double frameMemoryUs = 1e30;
+        double heapUs = 1e30;
+        // 交替跑三遍取最快的
+        for (int r = 0; r < 3; r++)
+        {
+            frameMemoryUs = std::min(frameMemoryUs, timeLists(listFrameMemory, frameMemoryAllocations));
+            heapUs = std::min(heapUs, timeLists(listHeap, heapAllocations));
+        }
+            }
+            streamer.Update();
+            PerfCounters::Set(PerfCounter::FrameTimeMs, dt * 1000.0f);
+            PerfCounters::Set(PerfCounter::Entities, double(world.GetEntityCount()));
+            PerfCounters::EndFrame();
+            MemoryTracker::EndFrame();
+            titleTimer += dt;
+            if (titleTimer >= titleSeconds)
+            {
+                titleTimer = 0.0f;
+                RefreshTitle(overBudgetTags, title);
+            }
+            // Graphics::EndFrame 里做的
+            FrameMemory::NextFrame();
+            const auto made = MemoryTracker::GetThreadAllocationCount() - allocationsBefore;
+
+            if (measuring)
+            {
+                measuredMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                frameAllocations += made;
+                if (made != 0u)
+                {
+                    framesWithAllocations++;
+                    if (made > worstAllocations)
+                    {
+                        worstAllocations = made;
+                        worstFrame = f;
+                    }
+                }
+                levelChanges += PerfCounters::GetFrameValue(PerfCounter::DrawCalls) > double(visible) ? 1u : 0u;
+                minVisible = std::min(minVisible, visible);
+                maxVisible = std::max(maxVisible, visible);
+            }
+        }
+        streamer.WaitForLoads();
+        // 只有绘制列表，分别放在 FrameMemory 和通用堆上
+        const auto listFrameMemory = [&world] {
+            const auto drawList = BuildDrawList(world);
+            FrameMemory::NextFrame();
+            return drawList.size();
+        };
+        const auto listHeap = [&world] {
+            const auto drawList = BuildDrawList<std::allocator<DrawItem<LodState>>>(world);
+            FrameMemory::NextFrame();
+            return drawList.size();
+        };
+        const auto timeLists = [frames](auto&& build, unsigned long long& allocations) {
+            const auto allocationsBefore = MemoryTracker::GetThreadAllocationCount();
+            const auto start = Clock::now();
+            std::size_t sink = 0u;
+            for (unsigned int f = 0u; f < frames; f++)
+            {
+                sink += build();
+            }
+            const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / frames;
+            allocations = MemoryTracker::GetThreadAllocationCount() - allocationsBefore;
+            return sink != 0u ? us : 0.0;
+        };
+        unsigned long long frameMemoryAllocations;
+        unsigned long long heapAllocations;
+        double frameMemoryUs = 1e30;
+        double heapUs = 1e30;
+        // 交替跑三遍取最快的
+        for (int r = 0; r < 3; r++)
+        {
+            frameMemoryUs = std::min(frameMemoryUs, timeLists(listFrameMemory, frameMemoryAllocations));
+            heapUs = std::min(heapUs, timeLists(listHeap, heapAllocations));
+        }
+
+        std::cout << instances << " instances, " << selector.GetLevelCount() << " LOD levels, " << textureCount
+                  << " streamed textures, " << pool.GetWorkerCount() << " workers" << std::endl;
+        std::cout << "warmup " << warmup << " frames, then " << frames << " frames at " << measuredMs / frames << " ms" << std::endl;
+        std::cout << "last frame: " << triangles / 1000u << "k triangles, title \"" << title << "\"" << std::endl;
+        std::cout << "frames with crossfading instances: " << levelChanges << std::endl;
+        std::cout << "draw list: " << minVisible << " to " << maxVisible << " of " << instances << " instances in the frustum" << std::endl;
+        std::cout << "draw list build + sort, " << frames << " frames: FrameMemory " << frameMemoryUs << " us/frame, "
+                  << double(frameMemoryAllocations) / frames << " heap allocations/frame; std::allocator " << heapUs
+                  << " us/frame, " << double(heapAllocations) / frames << " heap allocations/frame" << std::endl;
+        std::cout << "FrameMemory high water mark: " << FrameMemory::GetHighWaterMark() << " bytes" << std::endl;
+        std::cout << "heap allocations after warmup: " << frameAllocations << " in " << framesWithAllocations << " frames";
+        if (framesWithAllocations != 0u)
+        {
+            std::cout << " (worst: frame " << worstFrame << ", " << worstAllocations << ")";
+        }
+        std::cout << std::endl;
+        std::cout << MemoryTracker::GetReport();
+
+        bool ok = true;
+        if (framesWithAllocations != 0u)
+        {
+            std::cout << "FAIL: steady-state frames allocated on the heap" << std::endl;
+            ok = false;
+        }
+        if (minVisible == 0u || maxVisible == instances)
+        {
+            std::cout << "FAIL: the draw list culled everything or nothing" << std::endl;
+            ok = false;
+        }
+        if (frameMemoryAllocations != 0u)
+        {
+            std::cout << "FAIL: the FrameMemory draw list allocated on the heap" << std::endl;
+            ok = false;
+        }
+        if (levelChanges == 0u)
+        {
+            std::cout << "FAIL: no instance changed LOD, the frames did no work" << std::endl;
+            ok = false;
+        }
+        std::filesystem::remove_all(dir);
+        std::cout << (ok ? "OK" : "FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::filesystem::remove_all(dir);
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
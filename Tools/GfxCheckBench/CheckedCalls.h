@@ -0,0 +1,82 @@
+#pragma once
+// GfxCheckBench 的两份调用代码共用的声明。
+// 只替身 GraphicsThrowMacros.h 用到的那几个名字（HRESULT、Graphics::HrException、infoManager），宏本身用引擎里的原文件
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using HRESULT = long;
+#ifndef FAILED
+#define FAILED(hr) (HRESULT(hr) < 0)
+#define SUCCEEDED(hr) (HRESULT(hr) >= 0)
+#endif
+
+class Graphics
+{
+public:
+    class HrException
+    {
+    public:
+        HrException(int line, const char* file, HRESULT hr, std::vector<std::string> infoMsgs = {}) noexcept
+            :
+            line(line),
+            file(file),
+            hr(hr),
+            info(std::move(infoMsgs))
+        {}
+        int line;
+        const char* file;
+        HRESULT hr;
+        std::vector<std::string> info;
+    };
+};
+
+// 代替 ID3D11DeviceContext：虚函数在另一个编译单元里实现，编译器看不到里面，和真的 COM 调用一样不能内联
+class FakeContext
+{
+public:
+    virtual ~FakeContext() = default;
+    virtual HRESULT Map(unsigned int buffer) noexcept = 0;
+    virtual void DrawIndexed(unsigned int count, unsigned int startIndex, int baseVertex) noexcept = 0;
+};
+
+// 和 DxgiInfoManager::Mark 一样的环形调用点记录；失败路径上的 GetMessages 这里返回空
+class FakeInfoManager
+{
+public:
+    void Mark(const char* file, int line) noexcept
+    {
+        callSites[nCallSites++ % maxCallSites] = { file,line };
+    }
+    std::vector<std::string> GetMessages()
+    {
+        return {};
+    }
+    unsigned long long GetCallSiteCount() const noexcept
+    {
+        return nCallSites;
+    }
+private:
+    struct CallSite
+    {
+        const char* file;
+        int line;
+    };
+    static constexpr unsigned int maxCallSites = 64u;
+    CallSite callSites[maxCallSites] = {};
+    unsigned long long nCallSites = 0u;
+};
+
+// 一帧里每个物体的调用：一次 Map（有返回值）加一次 DrawIndexed（没有返回值），返回 Map 失败的次数
+using FrameFunction = std::uint64_t (*)(FakeContext& context, FakeInfoManager& info, unsigned int objects);
+
+struct PolicyCalls
+{
+    FrameFunction info;
+    FrameFunction hr;
+    FrameFunction unchecked;
+};
+
+// 调试版本（GFX_MARK_CALL 生效）和 Release（定义了 NDEBUG）各一份
+PolicyCalls GetDebugCalls() noexcept;
+PolicyCalls GetReleaseCalls() noexcept;
@@ -0,0 +1,33 @@
+// 被 DebugCalls.cpp / ReleaseCalls.cpp 各包含一次，两边 NDEBUG 不同，包含它的地方要先包含 CheckedCalls.h 并套一层命名空间
+#include "GraphicsThrowMacros.h"
+
+namespace
+{
+    // 写法和引擎的热路径一样：Map 按 Check 检查（Unchecked 时失败就跳过，像 ConstantBuffer::Update），
+    // DrawIndexed 用 GFX_CHECK_CALL（像 Graphics::DrawIndexed）
+    template<class Check>
+    std::uint64_t RunFrame(FakeContext& context, [[maybe_unused]] FakeInfoManager& infoManager, unsigned int objects)
+    {
+        HRESULT hr;
+        std::uint64_t failures = 0u;
+        for (unsigned int i = 0u; i < objects; i++)
+        {
+            GFX_CHECK_HR(Check, context.Map(i));
+            if constexpr (!Check::checkResult)
+            {
+                if (FAILED(hr))
+                {
+                    failures++;
+                    continue;
+                }
+            }
+            GFX_CHECK_CALL(Check, context.DrawIndexed(36u, 0u, 0));
+        }
+        return failures;
+    }
+
+    PolicyCalls MakeCalls() noexcept
+    {
+        return { &RunFrame<GfxCheck::Info>, &RunFrame<GfxCheck::Hr>, &RunFrame<GfxCheck::Unchecked> };
+    }
+}
@@ -0,0 +1,14 @@
+#undef NDEBUG
+#define IS_DEBUG 1
+#include "CheckedCalls.h"
+
+// GfxCheck 的策略在两份里定义不同（Info::captureInfo），各放进自己的命名空间，不然同一个程序里有两个定义
+namespace DebugBuild
+{
+#include "CheckedCalls.inl"
+}
+
+PolicyCalls GetDebugCalls() noexcept
+{
+    return DebugBuild::MakeCalls();
+}
@@ -0,0 +1,168 @@
+// GraphicsThrowMacros.h 里错误检查策略（GfxCheck::Info / Hr / Unchecked）在热路径上的开销，无头基准：
+// 1. 每帧 --objects 个物体，每个物体一次 Map（GFX_CHECK_HR）加一次 DrawIndexed（GFX_CHECK_CALL），和引擎的每物体路径一样；
+// 2. 设备上下文换成空的虚接口（Map 返回成功，DrawIndexed 只计数），所以测到的只有检查本身和一次虚调用；
+// 3. 同一份调用代码按调试版本和 Release 各编译一次（各在自己的命名空间里，策略的两种定义不会冲突）；
+//    每轮把 Info、Hr、Unchecked 和第二遍 Unchecked 交替各跑 --frames 帧，跑 --repeats 轮，每种取最快的一轮，
+//    这样机器的快慢变化对四行的影响一样。噪声取两遍 Unchecked 的差，以及两种构建里展开完全一样的代码
+//    （Hr、Unchecked 只差在放的位置）之间的差里最大的，比 Unchecked 多出来的不超过它就报告为没有可测的开销；
+// 4. 检查：调用次数都对得上，只有调试版本的 Info 记了调用点。
+// usage: GfxCheckBench [--objects N] [--frames N] [--repeats N]
+#include "CheckedCalls.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    class CountingContext : public FakeContext
+    {
+    public:
+        HRESULT Map(unsigned int buffer) noexcept override
+        {
+            maps++;
+            lastBuffer = buffer;
+            return 0;
+        }
+        void DrawIndexed(unsigned int count, unsigned int, int) noexcept override
+        {
+            draws++;
+            indices += count;
+        }
+        unsigned long long maps = 0u;
+        unsigned long long draws = 0u;
+        unsigned long long indices = 0u;
+        unsigned int lastBuffer = 0u;
+    };
+
+    struct Result
+    {
+        double nsPerObject;
+        unsigned long long callSites;
+    };
+
+    // 跑一次（--frames 帧），返回每个物体的纳秒数
+    Result RunOnce(FrameFunction run, unsigned int objects, unsigned int frames)
+    {
+        CountingContext context;
+        FakeInfoManager info;
+        std::uint64_t failures = 0u;
+        const auto start = Clock::now();
+        for (unsigned int f = 0u; f < frames; f++)
+        {
+            failures += run(context, info, objects);
+        }
+        const auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        const auto expected = static_cast<unsigned long long>(objects) * frames;
+        if (failures != 0u || context.maps != expected || context.draws != expected)
+        {
+            throw std::runtime_error("call counts do not match");
+        }
+        return { ns / double(expected), info.GetCallSiteCount() };
+    }
+
+    // Info、Hr、Unchecked、Unchecked 交替跑，每种取最快的一次
+    std::array<Result, 4> Measure(const PolicyCalls& calls, unsigned int objects, unsigned int frames, unsigned int repeats)
+    {
+        const FrameFunction runs[] = { calls.info, calls.hr, calls.unchecked, calls.unchecked };
+        std::array<Result, 4> best;
+        best.fill({ 1e30, 0u });
+        for (unsigned int r = 0u; r < repeats; r++)
+        {
+            for (std::size_t i = 0u; i < best.size(); i++)
+            {
+                const auto result = RunOnce(runs[i], objects, frames);
+                best[i] = { std::min(best[i].nsPerObject, result.nsPerObject), result.callSites };
+            }
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int objects = 10000u;
+    unsigned int frames = 100u;
+    unsigned int repeats = 101u;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--objects" && i + 1 < argc)
+        {
+            objects = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            frames = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--repeats" && i + 1 < argc)
+        {
+            repeats = unsigned(std::stoul(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "usage: GfxCheckBench [--objects N] [--frames N] [--repeats N]" << std::endl;
+            return 1;
+        }
+    }
+    if (objects == 0u || frames == 0u || repeats == 0u)
+    {
+        std::cerr << "need at least one object, frame and repeat" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::cout << objects << " objects x " << frames << " frames, one Map + one DrawIndexed per object, best of "
+                  << repeats << " interleaved runs" << std::endl;
+        std::cout << "build    policy       ns/object  over unchecked  call sites marked" << std::endl;
+        bool ok = true;
+        const auto expected = static_cast<unsigned long long>(objects) * frames;
+        const auto debugResults = Measure(GetDebugCalls(), objects, frames, repeats);
+        const auto releaseResults = Measure(GetReleaseCalls(), objects, frames, repeats);
+        // 噪声：两遍 Unchecked 的差，以及两种构建里展开完全一样的 Hr、Unchecked 之间的差（只是代码放的位置不同）
+        const auto noise = std::max({ std::abs(debugResults[3].nsPerObject - debugResults[2].nsPerObject),
+                                      std::abs(releaseResults[3].nsPerObject - releaseResults[2].nsPerObject),
+                                      std::abs(debugResults[1].nsPerObject - releaseResults[1].nsPerObject),
+                                      std::abs(debugResults[2].nsPerObject - releaseResults[2].nsPerObject) });
+        const char* const names[] = { "Info", "Hr", "Unchecked", "Unchecked'" };
+        for (const bool debug : { true, false })
+        {
+            const auto& results = debug ? debugResults : releaseResults;
+            const auto unchecked = results[2].nsPerObject;
+            for (std::size_t i = 0u; i < results.size(); i++)
+            {
+                const auto over = results[i].nsPerObject - unchecked;
+                char line[160];
+                std::snprintf(line, sizeof(line), "%-8s %-10s %11.2f %15.2f %18llu%s", debug ? "debug" : "release", names[i],
+                    results[i].nsPerObject, over, results[i].callSites,
+                    i < 2u && over <= noise ? "  (no cost above noise)" : "");
+                std::cout << line << std::endl;
+                // 只有调试版本的 Info 记调用点，每次 draw 一个
+                const auto wantSites = debug && i == 0u ? expected : 0u;
+                if (results[i].callSites != wantSites)
+                {
+                    std::cout << "FAIL: " << names[i] << " marked " << results[i].callSites << " call sites, expected "
+                              << wantSites << std::endl;
+                    ok = false;
+                }
+            }
+        }
+        char line[160];
+        std::snprintf(line, sizeof(line), "noise: %.2f ns/object (repeat of Unchecked, and the same Hr / Unchecked code in both builds)", noise);
+        std::cout << line << std::endl;
+        std::cout << (ok ? "OK" : "FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef NDEBUG
+#define NDEBUG
+#endif
+#define IS_DEBUG 0
+#include "CheckedCalls.h"
+
+// 见 DebugCalls.cpp
+namespace ReleaseBuild
+{
+#include "CheckedCalls.inl"
+}
+
+PolicyCalls GetReleaseCalls() noexcept
+{
+    return ReleaseBuild::MakeCalls();
+}
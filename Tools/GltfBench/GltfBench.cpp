@@ -0,0 +1,1052 @@
+// .glb 加载的无头基准：GltfLoader（映射文件、零拷贝访问器、只解码场景用到的网格）对比朴素的加载器
+// （整个文件读进内存，所有网格都解码成 MeshVertex + 32 位索引）。
+// 两者最后都把要交给 CreateBuffer 的数据拷进一块暂存内存，模拟驱动在创建缓冲时的那一次拷贝。
+// 1. JSON 解析器的小测试，截断 / 损坏的 .glb 只能抛 MeshException；
+// 2. 生成一个场景：一半网格交错存放（32 位索引）、其余分开存放（16 位索引）、量化位置、三角形带，
+//    还有只被第二个场景引用的网格（默认场景用不到）；检查两种加载器得到的实例和几何相同；
+// 3. 每种加载器在单独的子进程里跑（峰值 RSS 才互不影响），报告最好的时间和峰值 RSS。
+// 给了 .glb 文件时只测这些文件。
+// usage: GltfBench [files...] [--megabytes N] [--iterations N] [--threads N] [--keep]
+#include "GltfLoader.h"
+#include "Json.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include "MappedFile.h"
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using Matrix = std::array<float, 16>;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // peak resident set of this process in KB
+    std::size_t PeakRssKb()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters = {};
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+        return counters.PeakWorkingSetSize / 1024u;
+#else
+        rusage usage = {};
+        getrusage(RUSAGE_SELF, &usage);
+        return std::size_t(usage.ru_maxrss);
+#endif
+    }
+
+#ifdef _WIN32
+    using FileView = MappedFile;
+#else
+    // 只读映射整个文件，和引擎的 MappedFile 接口一样
+    class FileView
+    {
+    public:
+        explicit FileView(const std::string& path)
+        {
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("cannot open " + path);
+            }
+            struct stat st = {};
+            fstat(fd, &st);
+            size = std::size_t(st.st_size);
+            if (size > 0u)
+            {
+                const auto p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED)
+                {
+                    close(fd);
+                    throw std::runtime_error("cannot map " + path);
+                }
+                pData = static_cast<const std::byte*>(p);
+            }
+            close(fd);
+        }
+        FileView(const FileView&) = delete;
+        FileView& operator=(const FileView&) = delete;
+        ~FileView()
+        {
+            if (pData != nullptr)
+            {
+                munmap(const_cast<std::byte*>(pData), size);
+            }
+        }
+        const std::byte* GetData() const noexcept
+        {
+            return pData;
+        }
+        std::size_t GetSize() const noexcept
+        {
+            return size;
+        }
+    private:
+        const std::byte* pData = nullptr;
+        std::size_t size = 0u;
+    };
+#endif
+
+    std::vector<std::byte> ReadFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            throw std::runtime_error("cannot open " + path);
+        }
+        std::vector<std::byte> data(std::size_t(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size()));
+        return data;
+    }
+
+    int Check(bool condition, const std::string& what)
+    {
+        if (!condition)
+        {
+            std::cout << "FAILED: " << what << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    std::uint64_t Hash(std::uint64_t hash, const void* pData, std::size_t size)
+    {
+        const auto p = static_cast<const unsigned char*>(pData);
+        for (std::size_t i = 0u; i < size; i++)
+        {
+            hash = (hash ^ p[i]) * 0x100000001B3u;
+        }
+        return hash;
+    }
+
+    // ---------------------------------------------------------------- 生成测试场景
+
+    class GlbWriter
+    {
+    public:
+        std::uint32_t AddView(const void* pData, std::size_t size, std::uint32_t stride = 0u)
+        {
+            // 每个视图 4 字节对齐
+            while (bin.size() % 4u != 0u)
+            {
+                bin.push_back(std::byte(0));
+            }
+            std::ostringstream view;
+            view << "{\"buffer\":0,\"byteOffset\":" << bin.size() << ",\"byteLength\":" << size;
+            if (stride != 0u)
+            {
+                view << ",\"byteStride\":" << stride;
+            }
+            view << "}";
+            views.push_back(view.str());
+            const auto p = static_cast<const std::byte*>(pData);
+            bin.insert(bin.end(), p, p + size);
+            return std::uint32_t(views.size() - 1u);
+        }
+        std::uint32_t AddAccessor(std::uint32_t view, std::size_t offset, std::uint32_t componentType, std::size_t count,
+            const char* type, bool normalized = false, const float* pMin = nullptr, const float* pMax = nullptr)
+        {
+            std::ostringstream accessor;
+            accessor << "{\"bufferView\":" << view << ",\"byteOffset\":" << offset << ",\"componentType\":" << componentType
+                << ",\"count\":" << count << ",\"type\":\"" << type << "\"";
+            if (normalized)
+            {
+                accessor << ",\"normalized\":true";
+            }
+            if (pMin != nullptr)
+            {
+                accessor << std::setprecision(9) << ",\"min\":[" << pMin[0] << "," << pMin[1] << "," << pMin[2]
+                    << "],\"max\":[" << pMax[0] << "," << pMax[1] << "," << pMax[2] << "]";
+            }
+            accessor << "}";
+            accessors.push_back(accessor.str());
+            return std::uint32_t(accessors.size() - 1u);
+        }
+        std::string Finish(const std::string& body) const
+        {
+            std::ostringstream json;
+            json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"GltfBench\"},\"buffers\":[{\"byteLength\":" << bin.size() << "}]";
+            const auto writeArray = [&json](const char* name, const std::vector<std::string>& items) {
+                json << ",\"" << name << "\":[";
+                for (std::size_t i = 0u; i < items.size(); i++)
+                {
+                    json << (i != 0u ? "," : "") << items[i];
+                }
+                json << "]";
+            };
+            writeArray("bufferViews", views);
+            writeArray("accessors", accessors);
+            json << body << "}";
+            auto text = json.str();
+            while (text.size() % 4u != 0u)
+            {
+                text += ' ';
+            }
+            const auto binSize = (bin.size() + 3u) / 4u * 4u;
+            std::string file(12u + 8u + text.size() + 8u + binSize, '\0');
+            const auto put = [&file](std::size_t at, std::uint32_t v) { std::memcpy(&file[at], &v, 4u); };
+            put(0u, 0x46546C67u);
+            put(4u, 2u);
+            put(8u, std::uint32_t(file.size()));
+            put(12u, std::uint32_t(text.size()));
+            put(16u, 0x4E4F534Au);
+            std::memcpy(&file[20u], text.data(), text.size());
+            put(20u + text.size(), std::uint32_t(binSize));
+            put(24u + text.size(), 0x004E4942u);
+            std::memcpy(&file[28u + text.size()], bin.data(), bin.size());
+            return file;
+        }
+    private:
+        std::vector<std::byte> bin;
+        std::vector<std::string> views;
+        std::vector<std::string> accessors;
+    };
+
+    // n x n 的起伏网格，顶点在 [-0.5,0.5] 的范围里
+    void GridVertex(std::size_t n, std::size_t i, std::size_t j, std::size_t seed, float* p, float* normal, float* uv)
+    {
+        const auto u = float(i) / float(n - 1u);
+        const auto v = float(j) / float(n - 1u);
+        const auto phase = float(seed) * 0.7f;
+        p[0] = u - 0.5f;
+        p[1] = 0.05f * std::sin(u * 12.0f + phase) * std::cos(v * 9.0f - phase);
+        p[2] = v - 0.5f;
+        normal[0] = -0.6f * std::cos(u * 12.0f + phase) * std::cos(v * 9.0f - phase);
+        normal[1] = 1.0f;
+        normal[2] = 0.45f * std::sin(u * 12.0f + phase) * std::sin(v * 9.0f - phase);
+        const auto length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        for (int c = 0; c < 3; c++)
+        {
+            normal[c] /= length;
+        }
+        uv[0] = u;
+        uv[1] = v;
+    }
+
+    template<typename Index>
+    std::vector<Index> GridTriangles(std::size_t n)
+    {
+        std::vector<Index> indices;
+        indices.reserve((n - 1u) * (n - 1u) * 6u);
+        for (std::size_t i = 0u; i + 1u < n; i++)
+        {
+            for (std::size_t j = 0u; j + 1u < n; j++)
+            {
+                const auto a = Index(i * n + j);
+                const auto b = Index(a + 1u);
+                const auto c = Index(a + n);
+                const auto d = Index(c + 1u);
+                indices.insert(indices.end(), { a, c, b, b, c, d });
+            }
+        }
+        return indices;
+    }
+
+    struct Generated
+    {
+        std::string file;
+        std::size_t meshes;
+        std::size_t meshesUsed;
+        std::size_t instances;
+        std::size_t triangles;
+    };
+
+    // 四种网格轮流：0 交错 + 32 位索引（大），1 分开存放 + 16 位索引，2 量化位置（short normalized），3 三角形带。
+    // 前 3/4 的网格挂在默认场景里（有的被引用好几次，有的挂在更深的层级），其余只在第二个场景里
+    Generated Generate(std::size_t megabytes)
+    {
+        constexpr std::size_t meshCount = 24u;
+        constexpr std::size_t usedCount = 18u;
+        constexpr std::size_t smallN = 256u;
+        constexpr std::size_t stripN = 128u;
+        // 1、2、3 类的大小固定，剩下的分给 0 类（交错顶点 32 字节 + 每个顶点大约 6 个 32 位索引）
+        const std::size_t fixedBytes = (meshCount / 4u) * (smallN * smallN * (32u + 12u) + smallN * smallN * (8u + 12u + 8u + 12u) +
+            stripN * stripN * (32u + 8u));
+        const auto target = megabytes * 1024u * 1024u;
+        const auto perLarge = target > fixedBytes ? (target - fixedBytes) / (meshCount / 4u) : 0u;
+        const auto largeN = std::max<std::size_t>(2u, std::size_t(std::sqrt(double(perLarge) / 56.0)));
+
+        GlbWriter writer;
+        Generated g = {};
+        g.meshes = meshCount;
+        g.meshesUsed = usedCount;
+        std::vector<std::string> meshes;
+        std::vector<std::size_t> meshTriangles;
+        for (std::size_t m = 0u; m < meshCount; m++)
+        {
+            const auto kind = m % 4u;
+            const auto n = kind == 0u ? largeN : kind == 3u ? stripN : smallN;
+            std::vector<float> positions(n * n * 3u);
+            std::vector<float> normals(n * n * 3u);
+            std::vector<float> uvs(n * n * 2u);
+            float min[3] = { 1e30f, 1e30f, 1e30f };
+            float max[3] = { -1e30f, -1e30f, -1e30f };
+            for (std::size_t i = 0u; i < n; i++)
+            {
+                for (std::size_t j = 0u; j < n; j++)
+                {
+                    const auto v = i * n + j;
+                    GridVertex(n, i, j, m, &positions[v * 3u], &normals[v * 3u], &uvs[v * 2u]);
+                    for (int c = 0; c < 3; c++)
+                    {
+                        min[c] = std::min(min[c], positions[v * 3u + c]);
+                        max[c] = std::max(max[c], positions[v * 3u + c]);
+                    }
+                }
+            }
+            const auto count = n * n;
+            std::ostringstream primitive;
+            std::size_t triangles = 0u;
+            if (kind == 0u)
+            {
+                std::vector<float> interleaved(count * 8u);
+                for (std::size_t v = 0u; v < count; v++)
+                {
+                    std::memcpy(&interleaved[v * 8u], &positions[v * 3u], 12u);
+                    std::memcpy(&interleaved[v * 8u + 3u], &normals[v * 3u], 12u);
+                    std::memcpy(&interleaved[v * 8u + 6u], &uvs[v * 2u], 8u);
+                }
+                const auto view = writer.AddView(interleaved.data(), interleaved.size() * 4u, 32u);
+                const auto indices = GridTriangles<std::uint32_t>(n);
+                triangles = indices.size() / 3u;
+                primitive << "{\"attributes\":{\"POSITION\":" << writer.AddAccessor(view, 0u, 5126u, count, "VEC3", false, min, max)
+                    << ",\"NORMAL\":" << writer.AddAccessor(view, 12u, 5126u, count, "VEC3")
+                    << ",\"TEXCOORD_0\":" << writer.AddAccessor(view, 24u, 5126u, count, "VEC2")
+                    << "},\"indices\":" << writer.AddAccessor(writer.AddView(indices.data(), indices.size() * 4u), 0u, 5125u, indices.size(), "SCALAR")
+                    << "}";
+            }
+            else if (kind == 1u || kind == 3u)
+            {
+                const auto pv = writer.AddView(positions.data(), positions.size() * 4u);
+                const auto nv = writer.AddView(normals.data(), normals.size() * 4u);
+                primitive << "{\"attributes\":{\"POSITION\":" << writer.AddAccessor(pv, 0u, 5126u, count, "VEC3", false, min, max)
+                    << ",\"NORMAL\":" << writer.AddAccessor(nv, 0u, 5126u, count, "VEC3");
+                std::vector<std::uint16_t> indices;
+                if (kind == 1u)
+                {
+                    indices = GridTriangles<std::uint16_t>(n);
+                    triangles = indices.size() / 3u;
+                }
+                else
+                {
+                    // 每两行一条带，行之间用两个重复的顶点接起来（退化三角形）
+                    for (std::size_t i = 0u; i + 1u < n; i++)
+                    {
+                        if (i != 0u)
+                        {
+                            indices.push_back(indices.back());
+                            indices.push_back(std::uint16_t(i * n));
+                        }
+                        for (std::size_t j = 0u; j < n; j++)
+                        {
+                            indices.push_back(std::uint16_t(i * n + j));
+                            indices.push_back(std::uint16_t((i + 1u) * n + j));
+                        }
+                    }
+                    triangles = indices.size() - 2u;
+                }
+                primitive << "},\"indices\":" << writer.AddAccessor(writer.AddView(indices.data(), indices.size() * 2u), 0u, 5123u, indices.size(), "SCALAR");
+                if (kind == 3u)
+                {
+                    primitive << ",\"mode\":5";
+                }
+                primitive << "}";
+            }
+            else
+            {
+                // KHR_mesh_quantization 的写法：short normalized，每个顶点补到 8 字节
+                std::vector<std::int16_t> quantized(count * 4u, 0);
+                for (std::size_t v = 0u; v < count; v++)
+                {
+                    for (int c = 0; c < 3; c++)
+                    {
+                        quantized[v * 4u + c] = std::int16_t(std::lround(positions[v * 3u + c] * 32767.0f));
+                    }
+                }
+                const auto indices = GridTriangles<std::uint16_t>(n);
+                triangles = indices.size() / 3u;
+                primitive << "{\"attributes\":{\"POSITION\":"
+                    << writer.AddAccessor(writer.AddView(quantized.data(), quantized.size() * 2u, 8u), 0u, 5122u, count, "VEC3", true)
+                    << "},\"indices\":" << writer.AddAccessor(writer.AddView(indices.data(), indices.size() * 2u), 0u, 5123u, indices.size(), "SCALAR")
+                    << "}";
+            }
+            meshes.push_back("{\"name\":\"mesh" + std::to_string(m) + "\",\"primitives\":[" + primitive.str() + "]}");
+            meshTriangles.push_back(triangles);
+        }
+
+        // 节点：0 是默认场景的根，下面 4 个组，每个用到的网格挂 1-3 个实例，每隔几个网格再挂一条两层的链；
+        // 第二个场景的根下面挂没用到的网格
+        std::vector<std::string> nodes(1u);
+        std::vector<std::vector<std::size_t>> children(1u);
+        const auto addNode = [&](std::size_t parent, const std::string& body) {
+            nodes.push_back(body);
+            children.emplace_back();
+            children[parent].push_back(nodes.size() - 1u);
+            return nodes.size() - 1u;
+        };
+        std::vector<std::size_t> groups;
+        for (std::size_t k = 0u; k < 4u; k++)
+        {
+            const auto angle = 0.5f * float(k);
+            std::ostringstream body;
+            body << std::setprecision(9) << "\"rotation\":[0," << std::sin(angle * 0.5f) << ",0," << std::cos(angle * 0.5f)
+                << "],\"translation\":[" << float(k) * 1.5f - 2.25f << ",0,0]";
+            groups.push_back(addNode(0u, body.str()));
+        }
+        for (std::size_t m = 0u; m < usedCount; m++)
+        {
+            for (std::size_t copy = 0u; copy < 1u + m % 3u; copy++)
+            {
+                std::ostringstream body;
+                body << "\"mesh\":" << m << ",\"translation\":[0," << float(copy) * 0.3f << "," << float(m) * 0.2f - 1.8f << "]";
+                const auto node = addNode(groups[m % 4u], body.str());
+                g.instances++;
+                g.triangles += meshTriangles[m];
+                if (m % 4u == 1u && copy == 0u)
+                {
+                    const auto middle = addNode(node, "\"scale\":[0.5,0.5,0.5],\"translation\":[0,1,0]");
+                    addNode(middle, "\"mesh\":" + std::to_string(m) +
+                        ",\"matrix\":[1,0,0,0, 0,0,1,0, 0,-1,0,0, 0.25,0.5,0,1]");
+                    g.instances++;
+                    g.triangles += meshTriangles[m];
+                }
+            }
+        }
+        nodes.push_back("\"name\":\"library\"");
+        children.emplace_back();
+        const auto library = nodes.size() - 1u;
+        for (std::size_t m = usedCount; m < meshCount; m++)
+        {
+            addNode(library, "\"mesh\":" + std::to_string(m));
+        }
+        nodes[0] = "\"name\":\"root\"";
+
+        std::ostringstream body;
+        body << ",\"scene\":0,\"scenes\":[{\"nodes\":[0]},{\"nodes\":[" << library << "]}],\"nodes\":[";
+        for (std::size_t n = 0u; n < nodes.size(); n++)
+        {
+            body << (n != 0u ? "," : "") << "{" << nodes[n];
+            if (!children[n].empty())
+            {
+                body << ",\"children\":[";
+                for (std::size_t c = 0u; c < children[n].size(); c++)
+                {
+                    body << (c != 0u ? "," : "") << children[n][c];
+                }
+                body << "]";
+            }
+            body << "}";
+        }
+        body << "],\"meshes\":[";
+        for (std::size_t m = 0u; m < meshes.size(); m++)
+        {
+            body << (m != 0u ? "," : "") << meshes[m];
+        }
+        body << "]";
+        g.file = writer.Finish(body.str());
+        return g;
+    }
+
+    // ---------------------------------------------------------------- 朴素的加载器
+
+    struct NaiveInstance
+    {
+        std::size_t primitive;
+        Matrix world;
+    };
+
+    struct NaiveScene
+    {
+        // 文件里的每个 primitive，不管用没用到
+        std::vector<MeshData> primitives;
+        std::vector<NaiveInstance> instances;
+    };
+
+    // 一个元素的第 c 个分量，规则和 GltfLoader 一样
+    float ReadFloat(const std::byte* p, std::uint32_t componentType, bool normalized)
+    {
+        switch (componentType)
+        {
+        case 5120u: { const auto v = float(std::int8_t(p[0])); return normalized ? std::max(v / 127.0f, -1.0f) : v; }
+        case 5121u: { const auto v = float(std::uint8_t(p[0])); return normalized ? v / 255.0f : v; }
+        case 5122u: { std::int16_t v; std::memcpy(&v, p, 2u); return normalized ? std::max(float(v) / 32767.0f, -1.0f) : float(v); }
+        case 5123u: { std::uint16_t v; std::memcpy(&v, p, 2u); return normalized ? float(v) / 65535.0f : float(v); }
+        case 5125u: { std::uint32_t v; std::memcpy(&v, p, 4u); return float(v); }
+        default: { float v; std::memcpy(&v, p, 4u); return v; }
+        }
+    }
+
+    // 不做任何检查，只用来对照生成的（合法的）文件
+    NaiveScene NaiveLoad(const std::string& path)
+    {
+        const auto data = ReadFile(path);
+        std::uint32_t jsonLength;
+        std::memcpy(&jsonLength, &data[12], 4u);
+        JsonValue root;
+        std::string error;
+        if (!JsonValue::Parse(reinterpret_cast<const char*>(&data[20]), jsonLength, root, error))
+        {
+            throw std::runtime_error(error);
+        }
+        const auto pBin = &data[20u + jsonLength + 8u];
+        const auto& accessors = *root.Find("accessors");
+        const auto& views = *root.Find("bufferViews");
+        // 每个访问器只查一次 JSON，循环里按 stride 读分量
+        struct Accessor
+        {
+            const std::byte* p;
+            std::size_t stride;
+            std::size_t componentSize;
+            std::uint32_t componentType;
+            bool normalized;
+            float Read(std::size_t i, std::size_t c) const
+            {
+                return ReadFloat(p + i * stride + c * componentSize, componentType, normalized);
+            }
+        };
+        const auto resolve = [&](long long index) {
+            const auto& a = accessors[std::size_t(index)];
+            const auto& view = views[std::size_t(a.GetInt("bufferView", 0))];
+            const auto type = a.GetString("type");
+            const auto components = type == "SCALAR" ? 1u : type == "VEC2" ? 2u : type == "VEC3" ? 3u : 4u;
+            const auto component = std::uint32_t(a.GetInt("componentType", 0));
+            const std::size_t componentSize = component == 5120u || component == 5121u ? 1u : component == 5122u || component == 5123u ? 2u : 4u;
+            const auto stride = view.GetInt("byteStride", 0) != 0 ? std::size_t(view.GetInt("byteStride", 0)) : components * componentSize;
+            return Accessor{ pBin + view.GetInt("byteOffset", 0) + a.GetInt("byteOffset", 0), stride, componentSize, component,
+                a.GetBool("normalized", false) };
+        };
+
+        NaiveScene scene;
+        std::vector<std::size_t> meshFirst;
+        const auto& meshes = *root.Find("meshes");
+        for (std::size_t m = 0u; m < meshes.GetSize(); m++)
+        {
+            meshFirst.push_back(scene.primitives.size());
+            const auto& primitives = *meshes[m].Find("primitives");
+            for (std::size_t p = 0u; p < primitives.GetSize(); p++)
+            {
+                const auto& primitive = primitives[p];
+                const auto& attributes = *primitive.Find("attributes");
+                const auto normalIndex = attributes.GetInt("NORMAL", -1);
+                const auto uvIndex = attributes.GetInt("TEXCOORD_0", -1);
+                const auto position = resolve(attributes.GetInt("POSITION", -1));
+                const auto normal = resolve(normalIndex >= 0 ? normalIndex : attributes.GetInt("POSITION", -1));
+                const auto uv = resolve(uvIndex >= 0 ? uvIndex : attributes.GetInt("POSITION", -1));
+                const auto count = std::size_t(accessors[std::size_t(attributes.GetInt("POSITION", -1))].GetInt("count", 0));
+                MeshData mesh;
+                mesh.vertices.resize(count);
+                for (std::size_t v = 0u; v < count; v++)
+                {
+                    auto& vertex = mesh.vertices[v];
+                    vertex = {};
+                    for (std::size_t c = 0u; c < 3u; c++)
+                    {
+                        vertex.position[c] = position.Read(v, c);
+                        vertex.normal[c] = normalIndex >= 0 ? normal.Read(v, c) : 0.0f;
+                    }
+                    for (std::size_t c = 0u; uvIndex >= 0 && c < 2u; c++)
+                    {
+                        vertex.texCoord[c] = uv.Read(v, c);
+                    }
+                }
+                const auto indexAccessor = primitive.GetInt("indices", -1);
+                const auto indices = resolve(indexAccessor);
+                const auto indexCount = std::size_t(accessors[std::size_t(indexAccessor)].GetInt("count", 0));
+                std::vector<std::uint32_t> source(indexCount);
+                for (std::size_t i = 0u; i < indexCount; i++)
+                {
+                    source[i] = std::uint32_t(indices.Read(i, 0u));
+                }
+                if (primitive.GetInt("mode", 4) == 5)
+                {
+                    for (std::size_t i = 0u; i + 2u < source.size(); i++)
+                    {
+                        mesh.indices.insert(mesh.indices.end(), { source[i], source[i + 1u + i % 2u], source[i + 2u - i % 2u] });
+                    }
+                }
+                else
+                {
+                    mesh.indices = source;
+                }
+                scene.primitives.push_back(std::move(mesh));
+            }
+        }
+
+        // 深度优先展开节点层级
+        const auto& nodes = *root.Find("nodes");
+        const std::function<void(std::size_t, const Matrix&)> visit = [&](std::size_t n, const Matrix& parent) {
+            const auto& node = nodes[n];
+            Matrix local = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+            if (const auto pMatrix = node.Find("matrix"))
+            {
+                for (std::size_t i = 0u; i < 16u; i++)
+                {
+                    local[i] = float((*pMatrix)[i].GetNumber());
+                }
+            }
+            else
+            {
+                float t[3] = { 0, 0, 0 }, q[4] = { 0, 0, 0, 1 }, s[3] = { 1, 1, 1 };
+                const auto get = [&node](const char* key, float* pOut, std::size_t count) {
+                    if (const auto pValue = node.Find(key))
+                    {
+                        for (std::size_t i = 0u; i < count; i++)
+                        {
+                            pOut[i] = float((*pValue)[i].GetNumber());
+                        }
+                    }
+                };
+                get("translation", t, 3u);
+                get("rotation", q, 4u);
+                get("scale", s, 3u);
+                const float x = q[0], y = q[1], z = q[2], w = q[3];
+                // 行向量约定：第 i 行是旋转后的第 i 个轴乘以缩放
+                const float rows[3][3] = {
+                    { 1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w) },
+                    { 2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w) },
+                    { 2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y) } };
+                for (int i = 0; i < 3; i++)
+                {
+                    for (int j = 0; j < 3; j++)
+                    {
+                        local[i * 4 + j] = rows[i][j] * s[i];
+                    }
+                    local[12 + i] = t[i];
+                }
+            }
+            Matrix world;
+            for (int i = 0; i < 4; i++)
+            {
+                for (int j = 0; j < 4; j++)
+                {
+                    world[i * 4 + j] = local[i * 4] * parent[j] + local[i * 4 + 1] * parent[4 + j] +
+                        local[i * 4 + 2] * parent[8 + j] + local[i * 4 + 3] * parent[12 + j];
+                }
+            }
+            const auto mesh = node.GetInt("mesh", -1);
+            if (mesh >= 0)
+            {
+                const auto& primitives = *meshes[std::size_t(mesh)].Find("primitives");
+                for (std::size_t p = 0u; p < primitives.GetSize(); p++)
+                {
+                    scene.instances.push_back({ meshFirst[std::size_t(mesh)] + p, world });
+                }
+            }
+            if (const auto pChildren = node.Find("children"))
+            {
+                for (std::size_t c = 0u; c < pChildren->GetSize(); c++)
+                {
+                    visit(std::size_t((*pChildren)[c].GetNumber()), world);
+                }
+            }
+        };
+        const Matrix toLeftHanded = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 1 };
+        const auto& roots = *(*root.Find("scenes"))[std::size_t(root.GetInt("scene", 0))].Find("nodes");
+        for (std::size_t r = 0u; r < roots.GetSize(); r++)
+        {
+            visit(std::size_t(roots[r].GetNumber()), toLeftHanded);
+        }
+        return scene;
+    }
+
+    // ---------------------------------------------------------------- 模拟上传和比较
+
+    // CreateBuffer 会把 pSysMem 拷一次；两种加载器都把各自要上传的字节拷进同一块暂存内存
+    struct Uploader
+    {
+        std::vector<std::byte> staging;
+        std::size_t bytes = 0u;
+        void Upload(const std::byte* pData, std::size_t size)
+        {
+            if (staging.size() < size)
+            {
+                staging.resize(size);
+            }
+            std::memcpy(staging.data(), pData, size);
+            bytes += size;
+        }
+    };
+
+    std::size_t UploadMapped(const GltfScene& scene, Uploader& uploader)
+    {
+        for (const auto& g : scene.geometries)
+        {
+            uploader.Upload(g.GetPositions(), g.GetPositionBytes());
+            uploader.Upload(g.GetIndices(), std::size_t(g.GetIndexCount()) * g.GetIndexSize());
+        }
+        return scene.geometries.size();
+    }
+
+    std::size_t UploadNaive(const NaiveScene& scene, Uploader& uploader)
+    {
+        for (const auto& p : scene.primitives)
+        {
+            uploader.Upload(reinterpret_cast<const std::byte*>(p.vertices.data()), p.vertices.size() * sizeof(MeshVertex));
+            uploader.Upload(reinterpret_cast<const std::byte*>(p.indices.data()), p.indices.size() * 4u);
+        }
+        return scene.primitives.size();
+    }
+
+    // 实例的指纹：几何内容（位置和三角形）加上取整后的世界矩阵；两种加载器的实例顺序不同，排序后比较
+    std::uint64_t Fingerprint(std::uint64_t geometryHash, const float* world)
+    {
+        auto hash = geometryHash;
+        for (int i = 0; i < 16; i++)
+        {
+            const auto rounded = std::int64_t(std::llround(double(world[i]) * 1000.0));
+            hash = Hash(hash, &rounded, sizeof(rounded));
+        }
+        return hash;
+    }
+
+    std::uint64_t HashGeometry(const std::vector<float>& positions, const std::vector<std::uint32_t>& indices)
+    {
+        return Hash(Hash(0xCBF29CE484222325u, positions.data(), positions.size() * 4u), indices.data(), indices.size() * 4u);
+    }
+
+    std::vector<std::uint64_t> Fingerprints(const GltfScene& scene)
+    {
+        std::vector<std::uint64_t> geometryHashes;
+        for (const auto& g : scene.geometries)
+        {
+            std::vector<float> positions(std::size_t(g.GetVertexCount()) * 3u);
+            for (std::size_t v = 0u; v < g.GetVertexCount(); v++)
+            {
+                std::memcpy(&positions[v * 3u], g.GetPositions() + v * g.GetPositionStride(), 12u);
+            }
+            std::vector<std::uint32_t> indices(g.GetIndexCount());
+            for (std::size_t i = 0u; i < indices.size(); i++)
+            {
+                if (g.GetIndexSize() == 2u)
+                {
+                    std::uint16_t index;
+                    std::memcpy(&index, g.GetIndices() + i * 2u, 2u);
+                    indices[i] = index;
+                }
+                else
+                {
+                    std::memcpy(&indices[i], g.GetIndices() + i * 4u, 4u);
+                }
+            }
+            geometryHashes.push_back(HashGeometry(positions, indices));
+        }
+        std::vector<std::uint64_t> result;
+        for (const auto& instance : scene.instances)
+        {
+            result.push_back(Fingerprint(geometryHashes[instance.geometry], &instance.world[0][0]));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<std::uint64_t> Fingerprints(const NaiveScene& scene)
+    {
+        std::vector<std::uint64_t> geometryHashes;
+        for (const auto& p : scene.primitives)
+        {
+            std::vector<float> positions;
+            for (const auto& v : p.vertices)
+            {
+                positions.insert(positions.end(), v.position, v.position + 3);
+            }
+            geometryHashes.push_back(HashGeometry(positions, p.indices));
+        }
+        std::vector<std::uint64_t> result;
+        for (const auto& instance : scene.instances)
+        {
+            result.push_back(Fingerprint(geometryHashes[instance.primitive], instance.world.data()));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    // ---------------------------------------------------------------- 检查
+
+    int CheckJson()
+    {
+        int failures = 0;
+        const std::string text = "{ \"a\": [1, -2.5e3, 0.125, true, false, null], \"s\": \"x\\\"\\\\\\/\\n\\u00e9\\ud83d\\ude00\","
+            " \"o\": {\"k\": {}}, \"e\": [] }";
+        JsonValue root;
+        std::string error;
+        failures += Check(JsonValue::Parse(text.data(), text.size(), root, error), "JSON parse: " + error);
+        const auto pArray = root.Find("a");
+        failures += Check(pArray != nullptr && pArray->GetSize() == 6u && (*pArray)[1].GetNumber() == -2500.0 &&
+            (*pArray)[2].GetNumber() == 0.125 && (*pArray)[3].GetBool() && !(*pArray)[4].GetBool(true) &&
+            (*pArray)[5].GetType() == JsonValue::Type::Null, "JSON array values");
+        failures += Check(root.GetString("s") == "x\"\\/\n\xC3\xA9\xF0\x9F\x98\x80", "JSON string escapes");
+        failures += Check(root.Find("o") != nullptr && root.Find("o")->Find("k") != nullptr && root.Find("e")->GetSize() == 0u,
+            "JSON nested objects");
+        const char* bad[] = { "{", "[1,]", "{\"a\" 1}", "01", "\"abc", "[1] x", "\"\\ud800\"", "tru", "{\"a\":-}" };
+        for (const auto b : bad)
+        {
+            failures += Check(!JsonValue::Parse(b, std::strlen(b), root, error), std::string("JSON should reject ") + b);
+        }
+        const std::string deep(1000u, '[');
+        failures += Check(!JsonValue::Parse(deep.data(), deep.size(), root, error), "JSON nesting limit");
+        return failures;
+    }
+
+    // 截断和随机改字节：只能成功或者抛 MeshException
+    // file 的前 length 个字节；length 为 0 时不拷（空 vector 的 data() 是 null，memmove 0 个字节到 null 会有 -Wnonnull 警告）
+    std::vector<std::byte> Prefix(const std::string& file, std::size_t length)
+    {
+        std::vector<std::byte> bytes(length);
+        if (length > 0u)
+        {
+            std::memcpy(bytes.data(), file.data(), length);
+        }
+        return bytes;
+    }
+
+    int CheckCorruptFiles(const std::string& file)
+    {
+        int failures = 0;
+        std::size_t rejected = 0u;
+        std::uint64_t state = 12345u;
+        const auto next = [&state]() {
+            state = state * 6364136223846793005u + 1442695040888963407u;
+            return std::size_t(state >> 33u);
+        };
+        // JSON 块在前面几十 KB 里，改那里的字节最容易出问题
+        const auto jsonEnd = std::min<std::size_t>(file.size(), 20u + std::size_t(*reinterpret_cast<const std::uint32_t*>(&file[12])) + 8u);
+        for (int trial = 0; trial < 300; trial++)
+        {
+            std::vector<std::byte> copy;
+            if (trial < 100)
+            {
+                const auto length = trial < 50 ? next() % jsonEnd : next() % file.size();
+                copy = Prefix(file, length);
+            }
+            else
+            {
+                copy = Prefix(file, file.size());
+                for (int k = 0; k < 1 + trial % 3; k++)
+                {
+                    copy[next() % jsonEnd] = std::byte(next() & 0xFFu);
+                }
+            }
+            try
+            {
+                GltfLoader::Load(copy.data(), copy.size(), "corrupt");
+            }
+            catch (const MeshException&)
+            {
+                rejected++;
+            }
+            catch (const std::exception& e)
+            {
+                failures += Check(false, std::string("corrupt file threw a non-mesh exception: ") + e.what());
+            }
+        }
+        std::cout << "corrupt files: " << rejected << " of 300 rejected, the rest loaded" << std::endl;
+        return failures;
+    }
+
+    // 子进程：加载一次并上传，输出 "毫秒 峰值KB 上传字节"
+    int RunChild(const std::string& mode, const std::string& path, unsigned int threads)
+    {
+        Uploader uploader;
+        std::unique_ptr<ThreadPool> pPool;
+        if (threads != 1u)
+        {
+            pPool = std::make_unique<ThreadPool>(threads == 0u ? 0u : threads - 1u);
+        }
+        const auto start = Clock::now();
+        if (mode == "naive")
+        {
+            const auto scene = NaiveLoad(path);
+            UploadNaive(scene, uploader);
+        }
+        else
+        {
+            const FileView file(path);
+            const auto scene = GltfLoader::Load(file.GetData(), file.GetSize(), path, pPool.get());
+            UploadMapped(scene, uploader);
+        }
+        const auto ms = MillisecondsSince(start);
+        std::cout << std::fixed << std::setprecision(3) << ms << " " << PeakRssKb() << " " << uploader.bytes << std::endl;
+        return 0;
+    }
+
+    struct ChildResult
+    {
+        double bestMs = 1e30;
+        std::size_t peakKb = 0u;
+        std::size_t uploadBytes = 0u;
+    };
+
+    ChildResult RunChildren(const std::string& self, const std::string& mode, const std::string& path, unsigned int threads,
+        unsigned int iterations)
+    {
+        ChildResult result;
+        const auto output = (std::filesystem::temp_directory_path() / "GltfBench_child.txt").string();
+        for (unsigned int i = 0u; i < iterations; i++)
+        {
+            const auto command = "\"" + self + "\" --child " + mode + " --threads " + std::to_string(threads) + " \"" + path + "\" > \"" + output + "\"";
+            if (std::system(command.c_str()) != 0)
+            {
+                throw std::runtime_error("child failed: " + command);
+            }
+            std::ifstream in(output);
+            double ms;
+            std::size_t kb;
+            std::size_t bytes;
+            if (!(in >> ms >> kb >> bytes))
+            {
+                throw std::runtime_error("child printed nothing: " + command);
+            }
+            result.bestMs = std::min(result.bestMs, ms);
+            result.peakKb = std::max(result.peakKb, kb);
+            result.uploadBytes = bytes;
+        }
+        std::filesystem::remove(output);
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    std::size_t megabytes = 256u;
+    unsigned int iterations = 3u;
+    unsigned int threads = 0u;
+    std::string childMode;
+    bool keep = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--keep")
+        {
+            keep = true;
+            continue;
+        }
+        if (arg.rfind("--", 0u) != 0u)
+        {
+            paths.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            std::cerr << "usage: GltfBench [files...] [--megabytes N] [--iterations N] [--threads N] [--keep]" << std::endl;
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--child") childMode = value;
+        else if (arg == "--megabytes") megabytes = std::size_t(std::stoull(value));
+        else if (arg == "--iterations") iterations = unsigned(std::stoul(value));
+        else if (arg == "--threads") threads = unsigned(std::stoul(value));
+        else
+        {
+            std::cerr << "unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        if (!childMode.empty())
+        {
+            return paths.size() == 1u ? RunChild(childMode, paths[0], threads) : 1;
+        }
+        if (iterations == 0u)
+        {
+            std::cerr << "bad options" << std::endl;
+            return 1;
+        }
+        int failures = CheckJson();
+        std::vector<std::string> generatedPaths;
+        if (paths.empty())
+        {
+            const auto start = Clock::now();
+            const auto g = Generate(megabytes);
+            std::cout << "generated " << std::fixed << std::setprecision(1) << g.file.size() / 1048576.0 << " MB: " << g.meshes
+                << " meshes (" << g.meshesUsed << " in the default scene), " << g.instances << " instances, " << g.triangles
+                << " triangles drawn, in " << std::setprecision(0) << MillisecondsSince(start) << " ms" << std::endl;
+            failures += CheckCorruptFiles(g.file);
+            const auto path = (std::filesystem::temp_directory_path() / "GltfBench.glb").string();
+            std::ofstream(path, std::ios::binary).write(g.file.data(), std::streamsize(g.file.size()));
+            paths.push_back(path);
+            generatedPaths.push_back(path);
+        }
+
+        ThreadPool pool(threads);
+        const auto totalThreads = pool.GetWorkerCount() + 1u;
+        for (const auto& path : paths)
+        {
+            const auto name = std::filesystem::path(path).filename().string();
+            // 先在本进程里各加载一次，比较结果
+            {
+                const FileView file(path);
+                const auto scene = GltfLoader::Load(file.GetData(), file.GetSize(), name, &pool);
+                const auto single = GltfLoader::Load(file.GetData(), file.GetSize(), name);
+                const auto& s = scene.stats;
+                std::cout << name << ": " << s.nodesUsed << "/" << s.nodes << " nodes, " << s.meshesUsed << "/" << s.meshes << " meshes, "
+                    << scene.geometries.size() << " geometries, " << scene.instances.size() << " instances; "
+                    << std::setprecision(1) << s.bytesInPlace / 1048576.0 << " MB in place, " << s.bytesDecoded / 1048576.0 << " MB decoded"
+                    << std::endl;
+                const auto fingerprints = Fingerprints(scene);
+                failures += Check(fingerprints == Fingerprints(single), name + ": threaded load differs from single-threaded");
+                if (!generatedPaths.empty())
+                {
+                    failures += Check(fingerprints == Fingerprints(NaiveLoad(path)), name + ": differs from the naive loader");
+                }
+            }
+            const auto self = std::filesystem::absolute(argv[0]).string();
+            const std::pair<std::string, ChildResult> results[] = {
+                { "naive, 1 thread", RunChildren(self, "naive", path, 1u, iterations) },
+                { "mapped, 1 thread", RunChildren(self, "mapped", path, 1u, iterations) },
+                { "mapped, " + std::to_string(totalThreads) + " threads", RunChildren(self, "mapped", path, totalThreads, iterations) } };
+            std::cout << "load + upload, best of " << iterations << " (each in a fresh process)" << std::endl;
+            for (const auto& r : results)
+            {
+                std::cout << "  " << std::left << std::setw(22) << r.first << std::right << std::fixed << std::setprecision(1)
+                    << std::setw(9) << r.second.bestMs << " ms" << std::setw(9) << r.second.peakKb / 1024.0 << " MB peak RSS"
+                    << std::setw(9) << r.second.uploadBytes / 1048576.0 << " MB uploaded" << std::endl;
+            }
+        }
+        if (!keep)
+        {
+            for (const auto& path : generatedPaths)
+            {
+                std::filesystem::remove(path);
+            }
+        }
+        std::cout << (failures == 0 ? "all checks passed" : "some checks FAILED") << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,688 @@
+// 导入时 LOD 生成（MeshSimplifier）的无头基准和检查：
+// 1. 生成两个模型导入：带纹理接缝和极点的起伏球（封闭），开放边界的地形网格；
+// 2. 每个模型按 --ratios 生成 LOD 链，单线程和线程池各一次，报告时间、每级的三角形数、
+//    简化器自己估计的误差和实测的误差（原网格顶点到简化后表面的最大 / 平均距离，相对包围盒最长边）；
+// 3. 检查：下标有效、没有退化三角形、各级三角形数递减、两种线程数的结果相同、
+//    锁定边界时开放边界的边一条不少、封闭的模型简化后依然封闭（接缝没有撕开）；
+// 4. 估算运行时的节省：模型缩放到半径 3，放在箱子轨道的距离上（6 到 20），
+//    每个距离选误差投影到屏幕上不超过 1 像素的最粗一级，平均三角形数和只画原网格相比；
+// 5. 模拟运行时的选择（App 的 --model-count）：几百个实例在箱子轨道上运动，每帧用 LodSelector 选级，
+//    报告每帧提交的三角形、换级频率、交叉淡入淡出的开销，对比不带滞后 / 不淡入淡出，检查选中的级别不超过误差。
+// 给了模型文件时只测这些文件。
+// usage: LodBench [model files...] [--triangles N] [--ratios 0.5,0.25,...] [--max-error E] [--threads N]
+#include "LodSelector.h"
+#include "MeshImporter.h"
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    // App 的投影：XMMatrixPerspectiveLH(1, 3/4, 0.5, 40)，窗口 800x600
+    constexpr double tanHalfFovY = 0.75;
+    constexpr double screenHeight = 600.0;
+    constexpr double modelRadius = 3.0;
+    constexpr std::size_t orbitInstances = 500u;
+    constexpr double orbitSeconds = 20.0;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::vector<std::byte> ReadFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            throw std::runtime_error("cannot open " + path);
+        }
+        std::vector<std::byte> data(std::size_t(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size()));
+        return data;
+    }
+
+    int Check(bool condition, const std::string& what)
+    {
+        if (!condition)
+        {
+            std::cout << "FAILED: " << what << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    MeshData ImportObjText(const std::string& text, const std::string& name)
+    {
+        return MeshImporter::ImportObj(reinterpret_cast<const std::byte*>(text.data()), text.size(), name);
+    }
+
+    // 经纬度球，半径随经纬度起伏；u = 0 和 u = 1 的两列是纹理接缝，两极各有一圈顶点位置相同
+    std::string GenerateSphere(std::size_t targetTriangles)
+    {
+        const auto rings = std::size_t(std::sqrt(double(targetTriangles) / 4.0)) + 2u;
+        const auto segments = rings * 2u;
+        std::string v, vt, vn, f;
+        char line[160];
+        const double pi = 3.14159265358979323846;
+        for (std::size_t r = 0u; r <= rings; r++)
+        {
+            for (std::size_t s = 0u; s <= segments; s++)
+            {
+                const auto theta = pi * double(r) / double(rings);
+                const auto phi = 2.0 * pi * double(s % segments) / double(segments);
+                const auto bump = 1.0 + 0.08 * std::sin(theta * 7.0) * std::cos(phi * 5.0);
+                // 两极的一圈顶点位置要逐位相同（sin(pi) 不是 0，打印出来会有 -0.0000000）
+                const auto pole = r == 0u || r == rings;
+                const double d[3] = { pole ? 0.0 : std::sin(theta) * std::cos(phi), r == 0u ? 1.0 : r == rings ? -1.0 : std::cos(theta),
+                    pole ? 0.0 : std::sin(theta) * std::sin(phi) };
+                std::snprintf(line, sizeof(line), "v %.7f %.7f %.7f\n", d[0] * bump, d[1] * bump, d[2] * bump);
+                v += line;
+                std::snprintf(line, sizeof(line), "vn %.5f %.5f %.5f\n", d[0], d[1], d[2]);
+                vn += line;
+                std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", double(s) / double(segments), 1.0 - double(r) / double(rings));
+                vt += line;
+            }
+        }
+        for (std::size_t r = 0u; r < rings; r++)
+        {
+            for (std::size_t s = 0u; s < segments; s++)
+            {
+                const auto a = r * (segments + 1u) + s + 1u;
+                const auto b = a + segments + 1u;
+                // 两极只要一个三角形
+                if (r != 0u)
+                {
+                    std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", a, a, a, a + 1u, a + 1u, a + 1u, b, b, b);
+                    f += line;
+                }
+                if (r + 1u != rings)
+                {
+                    std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", a + 1u, a + 1u, a + 1u,
+                        b + 1u, b + 1u, b + 1u, b, b, b);
+                    f += line;
+                }
+            }
+        }
+        return "# generated by LodBench\n" + v + vt + vn + f;
+    }
+
+    // 起伏的开放网格，边界上的顶点应该原样保留
+    std::string GenerateTerrain(std::size_t targetTriangles)
+    {
+        const auto side = std::size_t(std::sqrt(double(targetTriangles) / 2.0)) + 1u;
+        std::string v, vt, f;
+        char line[160];
+        for (std::size_t j = 0u; j <= side; j++)
+        {
+            for (std::size_t i = 0u; i <= side; i++)
+            {
+                const auto x = double(i) / double(side) * 20.0 - 10.0;
+                const auto z = double(j) / double(side) * 20.0 - 10.0;
+                const auto y = 1.5 * std::sin(x * 0.4) * std::cos(z * 0.3) + 0.3 * std::sin(x * 1.7 + z * 1.1);
+                std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", x, y, z);
+                v += line;
+                std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", double(i) / double(side), double(j) / double(side));
+                vt += line;
+            }
+        }
+        for (std::size_t j = 0u; j < side; j++)
+        {
+            for (std::size_t i = 0u; i < side; i++)
+            {
+                const auto a = j * (side + 1u) + i + 1u;
+                const auto b = a + side + 1u;
+                std::snprintf(line, sizeof(line), "f %zu/%zu %zu/%zu %zu/%zu %zu/%zu\n", a, a, b, b, b + 1u, b + 1u, a + 1u, a + 1u);
+                f += line;
+            }
+        }
+        return "# generated by LodBench\n" + v + vt + f;
+    }
+
+    // 按位置归类的顶点编号（和 MeshSimplifier 一样逐位比较）
+    std::vector<std::uint32_t> PositionClasses(const MeshData& mesh)
+    {
+        std::vector<std::pair<std::array<std::uint32_t, 3>, std::uint32_t>> keys(mesh.vertices.size());
+        for (std::size_t v = 0u; v < mesh.vertices.size(); v++)
+        {
+            std::memcpy(keys[v].first.data(), mesh.vertices[v].position, 12u);
+            keys[v].second = std::uint32_t(v);
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector<std::uint32_t> classes(mesh.vertices.size());
+        std::uint32_t next = 0u;
+        for (std::size_t i = 0u; i < keys.size(); i++)
+        {
+            if (i != 0u && keys[i].first != keys[i - 1u].first)
+            {
+                next++;
+            }
+            classes[keys[i].second] = next;
+        }
+        return classes;
+    }
+
+    // 按位置算的开放边（没有反向边的有向边），排好序
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> OpenEdges(const std::vector<std::uint32_t>& indices,
+        const std::vector<std::uint32_t>& classes)
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+        for (std::size_t i = 0u; i < indices.size(); i++)
+        {
+            edges.emplace_back(classes[indices[i]], classes[indices[i - i % 3u + (i + 1u) % 3u]]);
+        }
+        std::sort(edges.begin(), edges.end());
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> open;
+        for (const auto& e : edges)
+        {
+            if (!std::binary_search(edges.begin(), edges.end(), std::make_pair(e.second, e.first)))
+            {
+                open.push_back(e);
+            }
+        }
+        return open;
+    }
+
+    double PointTriangleDistance(const double* p, const double* a, const double* b, const double* c)
+    {
+        // Ericson, Real-Time Collision Detection 5.1.5
+        const auto sub = [](const double* x, const double* y, double* out) {
+            for (int k = 0; k < 3; k++) out[k] = x[k] - y[k];
+        };
+        const auto dot = [](const double* x, const double* y) { return x[0] * y[0] + x[1] * y[1] + x[2] * y[2]; };
+        double ab[3], ac[3], ap[3], bp[3], cp[3], q[3];
+        sub(b, a, ab);
+        sub(c, a, ac);
+        sub(p, a, ap);
+        const auto d1 = dot(ab, ap), d2 = dot(ac, ap);
+        const auto distanceTo = [&](const double* x) {
+            double d[3];
+            sub(p, x, d);
+            return std::sqrt(dot(d, d));
+        };
+        if (d1 <= 0.0 && d2 <= 0.0) return distanceTo(a);
+        sub(p, b, bp);
+        const auto d3 = dot(ab, bp), d4 = dot(ac, bp);
+        if (d3 >= 0.0 && d4 <= d3) return distanceTo(b);
+        const auto vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+        {
+            const auto t = d1 / (d1 - d3);
+            for (int k = 0; k < 3; k++) q[k] = a[k] + t * ab[k];
+            return distanceTo(q);
+        }
+        sub(p, c, cp);
+        const auto d5 = dot(ab, cp), d6 = dot(ac, cp);
+        if (d6 >= 0.0 && d5 <= d6) return distanceTo(c);
+        const auto vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+        {
+            const auto t = d2 / (d2 - d6);
+            for (int k = 0; k < 3; k++) q[k] = a[k] + t * ac[k];
+            return distanceTo(q);
+        }
+        const auto va = d3 * d6 - d5 * d4;
+        if (va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0)
+        {
+            const auto t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            for (int k = 0; k < 3; k++) q[k] = b[k] + t * (c[k] - b[k]);
+            return distanceTo(q);
+        }
+        const auto denominator = 1.0 / (va + vb + vc);
+        const auto v = vb * denominator, w = vc * denominator;
+        for (int k = 0; k < 3; k++) q[k] = a[k] + ab[k] * v + ac[k] * w;
+        return distanceTo(q);
+    }
+
+    struct MeasuredError
+    {
+        double max = 0.0;
+        double mean = 0.0;
+    };
+
+    // 原网格的顶点（最多约 20000 个样本）到简化后表面的距离；三角形放进均匀网格，按环向外找，
+    // 已经找到的距离不超过搜过的范围就停
+    MeasuredError Measure(const MeshData& mesh, const std::vector<std::uint32_t>& indices)
+    {
+        constexpr int cells = 32;
+        double extent = 0.0;
+        for (int c = 0; c < 3; c++)
+        {
+            extent = std::max(extent, double(mesh.boundsMax[c] - mesh.boundsMin[c]));
+        }
+        const auto h = extent / cells;
+        const auto cellOf = [&](double x, int c) {
+            return std::clamp(int((x - mesh.boundsMin[c]) / h), 0, cells - 1);
+        };
+        std::vector<std::vector<std::uint32_t>> grid(cells * cells * cells);
+        for (std::uint32_t t = 0u; t * 3u < indices.size(); t++)
+        {
+            int lo[3], hi[3];
+            for (int c = 0; c < 3; c++)
+            {
+                float mn = mesh.vertices[indices[t * 3u]].position[c], mx = mn;
+                for (int k = 1; k < 3; k++)
+                {
+                    mn = std::min(mn, mesh.vertices[indices[t * 3u + k]].position[c]);
+                    mx = std::max(mx, mesh.vertices[indices[t * 3u + k]].position[c]);
+                }
+                lo[c] = cellOf(mn, c);
+                hi[c] = cellOf(mx, c);
+            }
+            for (int x = lo[0]; x <= hi[0]; x++)
+                for (int y = lo[1]; y <= hi[1]; y++)
+                    for (int z = lo[2]; z <= hi[2]; z++)
+                        grid[(x * cells + y) * cells + z].push_back(t);
+        }
+        std::vector<std::uint32_t> stamp(indices.size() / 3u, 0u);
+        std::uint32_t query = 0u;
+        MeasuredError result;
+        std::size_t samples = 0u;
+        const auto step = std::max<std::size_t>(1u, mesh.vertices.size() / 20000u);
+        for (std::size_t v = 0u; v < mesh.vertices.size(); v += step)
+        {
+            query++;
+            double p[3];
+            int home[3];
+            for (int c = 0; c < 3; c++)
+            {
+                p[c] = mesh.vertices[v].position[c];
+                home[c] = cellOf(p[c], c);
+            }
+            double best = 1e30;
+            for (int ring = 0; ring < cells && best > (ring - 1) * h; ring++)
+            {
+                for (int x = home[0] - ring; x <= home[0] + ring; x++)
+                    for (int y = home[1] - ring; y <= home[1] + ring; y++)
+                        for (int z = home[2] - ring; z <= home[2] + ring; z++)
+                        {
+                            const bool onRing = std::max({ std::abs(x - home[0]), std::abs(y - home[1]), std::abs(z - home[2]) }) == ring;
+                            if (!onRing || x < 0 || y < 0 || z < 0 || x >= cells || y >= cells || z >= cells)
+                                continue;
+                            for (const auto t : grid[(x * cells + y) * cells + z])
+                            {
+                                if (stamp[t] == query)
+                                    continue;
+                                stamp[t] = query;
+                                double corners[3][3];
+                                for (int k = 0; k < 3; k++)
+                                    for (int c = 0; c < 3; c++)
+                                        corners[k][c] = mesh.vertices[indices[t * 3u + k]].position[c];
+                                best = std::min(best, PointTriangleDistance(p, corners[0], corners[1], corners[2]));
+                            }
+                        }
+            }
+            result.max = std::max(result.max, best);
+            result.mean += best;
+            samples++;
+        }
+        result.mean /= double(std::max<std::size_t>(1u, samples));
+        result.max /= extent;
+        result.mean /= extent;
+        return result;
+    }
+
+    std::vector<float> ParseRatios(const std::string& text)
+    {
+        std::vector<float> ratios;
+        std::stringstream in(text);
+        std::string item;
+        while (std::getline(in, item, ','))
+        {
+            ratios.push_back(std::stof(item));
+        }
+        return ratios;
+    }
+
+    // 运行时的 LOD 选择器，和 Mesh 一样：误差换成模型空间的距离，半径是包围盒的外接球
+    LodSelector MakeSelector(const MeshData& mesh, const LodSettings& settings)
+    {
+        float extent = 0.0f, radiusSq = 0.0f;
+        for (int c = 0; c < 3; c++)
+        {
+            const auto size = mesh.boundsMax[c] - mesh.boundsMin[c];
+            extent = std::max(extent, size);
+            radiusSq += size * size * 0.25f;
+        }
+        std::vector<float> errors;
+        for (const auto& lod : mesh.lods)
+        {
+            errors.push_back(lod.error * extent);
+        }
+        return LodSelector(errors, std::sqrt(radiusSq), settings);
+    }
+
+    std::size_t LevelTriangles(const MeshData& mesh, unsigned int level)
+    {
+        return level == 0u ? mesh.GetTriangleCount() : mesh.lods[level - 1u].GetTriangleCount();
+    }
+
+    // 模型缩放到半径 modelRadius，在 [6,20] 的距离上均匀取样，每个距离选屏幕误差 <= 1 像素的最粗一级
+    double OrbitTriangleFraction(const MeshData& mesh)
+    {
+        const auto selector = MakeSelector(mesh, {});
+        double drawn = 0.0;
+        constexpr int samples = 141;
+        for (int i = 0; i < samples; i++)
+        {
+            const auto distance = 6.0 + 14.0 * i / (samples - 1);
+            const auto diameter = LodSelector::ProjectedDiameter(float(distance), float(modelRadius),
+                float(1.0 / tanHalfFovY), float(screenHeight));
+            drawn += double(LevelTriangles(mesh, selector.Select(diameter)));
+        }
+        return drawn / samples / double(mesh.GetTriangleCount());
+    }
+
+    struct SelectionResult
+    {
+        // 每帧提交的三角形（过渡中两级都算），占都画原网格的比例
+        double triangleFraction = 0.0;
+        double switchesPerSecond = 0.0;
+        // 平均每帧在过渡中的实例比例
+        double fadingFraction = 0.0;
+        double nsPerUpdate = 0.0;
+        // 选中的级别投影到屏幕上超过 pixelError 的次数
+        std::size_t overErrorSelections = 0u;
+        bool simulated = false;
+    };
+
+    // App 的 --model-count：实例缩放到半径 1，按 BoxMotion 的轨道（以 z = 20 为中心、半径 6 到 20、
+    // 三个角度以 0 到 0.3pi/s 转动）运动，60 帧每秒模拟 seconds 秒，每帧每个实例用 LodSelector::Update 选级；
+    // bob 是再叠加的 2 Hz 深度抖动的幅度
+    // atThresholds：不按轨道运动，放在深度 10，实例均匀分到各级的切换点上（缩放到投影直径在切换点的 +-3% 以内），
+    // 只有 bob 的抖动
+    SelectionResult SimulateOrbits(const MeshData& mesh, const LodSettings& settings, std::size_t instances, double seconds,
+        float bob, bool atThresholds)
+    {
+        struct Orbit
+        {
+            float r, theta, phi, chi, dtheta, dphi, dchi;
+            LodState lod;
+        };
+        constexpr float instanceRadius = 1.0f;
+        constexpr float dt = 1.0f / 60.0f;
+        const auto selector = MakeSelector(mesh, settings);
+        std::mt19937 rng(7u);
+        std::uniform_real_distribution<float> adist(0.0f, 3.1415f * 2.0f);
+        std::uniform_real_distribution<float> odist(0.0f, 3.1415f * 0.3f);
+        std::uniform_real_distribution<float> rdist(6.0f, 20.0f);
+        std::uniform_real_distribution<float> tdist(0.97f, 1.03f);
+        const auto projectionYScale = float(1.0 / tanHalfFovY);
+        std::vector<Orbit> orbits(instances);
+        std::vector<float> radii(instances, instanceRadius);
+        constexpr float thresholdDepth = 10.0f;
+        // 切换点的直径比 projectionYScale * screenHeight 还大时相机已经在包围球里面，到不了
+        std::vector<unsigned int> reachable;
+        for (unsigned int level = 1u; level < selector.GetLevelCount(); level++)
+        {
+            if (selector.GetMaxDiameter(level) < 0.9f * projectionYScale * float(screenHeight))
+            {
+                reachable.push_back(level);
+            }
+        }
+        if (atThresholds && reachable.empty())
+        {
+            return {};
+        }
+        for (std::size_t i = 0u; i < instances; i++)
+        {
+            orbits[i] = { rdist(rng), adist(rng), adist(rng), adist(rng), odist(rng), odist(rng), odist(rng), {} };
+            if (atThresholds)
+            {
+                // ProjectedDiameter 反过来算
+                const auto level = reachable[i % reachable.size()];
+                radii[i] = selector.GetMaxDiameter(level) * thresholdDepth / (projectionYScale * float(screenHeight)) *
+                    tdist(rng);
+            }
+        }
+        const auto frames = std::size_t(seconds / dt);
+        double submitted = 0.0, full = 0.0, fading = 0.0;
+        std::size_t switches = 0u;
+        SelectionResult result;
+        std::vector<float> diameters(instances);
+        double updateNs = 0.0;
+        for (std::size_t f = 0u; f < frames; f++)
+        {
+            for (std::size_t i = 0u; i < instances; i++)
+            {
+                auto& o = orbits[i];
+                o.theta += o.dtheta * dt;
+                o.phi += o.dphi * dt;
+                o.chi += o.dchi * dt;
+                // (r,0,0) 经过 RotationRollPitchYaw(theta, phi, chi) 之后的 z，再平移 20
+                const auto orbitZ = atThresholds ? thresholdDepth : 20.0f + o.r * (std::sin(o.chi) * std::sin(o.theta) *
+                    std::cos(o.phi) - std::cos(o.chi) * std::sin(o.phi));
+                const auto z = orbitZ + bob * std::sin(4.0f * 3.1415f * dt * float(f) + o.chi);
+                diameters[i] = LodSelector::ProjectedDiameter(z, radii[i], projectionYScale, float(screenHeight));
+            }
+            const auto start = Clock::now();
+            for (std::size_t i = 0u; i < instances; i++)
+            {
+                switches += selector.Update(orbits[i].lod, diameters[i], dt) ? 1u : 0u;
+            }
+            updateNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            for (std::size_t i = 0u; i < instances; i++)
+            {
+                const auto& lod = orbits[i].lod;
+                submitted += double(LevelTriangles(mesh, lod.level));
+                if (lod.IsFading())
+                {
+                    submitted += double(LevelTriangles(mesh, lod.previous));
+                    fading += 1.0;
+                }
+                full += double(mesh.GetTriangleCount());
+                // 选中的一级不能比不带滞后的选择更粗（变粗时更严，变细时一超过就换），误差就不会超过 pixelError
+                if (lod.level > selector.Select(diameters[i]))
+                {
+                    result.overErrorSelections++;
+                }
+            }
+        }
+        result.simulated = true;
+        result.triangleFraction = submitted / full;
+        result.switchesPerSecond = double(switches) / (double(instances) * seconds);
+        result.fadingFraction = fading / double(frames * instances);
+        result.nsPerUpdate = updateNs / double(frames * instances);
+        return result;
+    }
+
+    int Run(const std::string& name, MeshData mesh, const std::vector<float>& ratios, const MeshSimplifyOptions& options,
+        ThreadPool& pool, bool closed)
+    {
+        int failures = 0;
+        const auto classes = PositionClasses(mesh);
+        const auto originalOpen = OpenEdges(mesh.indices, classes);
+        std::cout << name << ": " << mesh.vertices.size() << " vertices, " << mesh.GetTriangleCount() << " triangles, "
+            << originalOpen.size() << " open edges" << (options.lockBorder ? "" : " (border not locked)") << std::endl;
+
+        auto start = Clock::now();
+        MeshSimplifier::BuildLods(mesh, ratios, options);
+        const auto singleMs = MillisecondsSince(start);
+        auto pooled = mesh;
+        start = Clock::now();
+        MeshSimplifier::BuildLods(pooled, ratios, options, &pool);
+        const auto pooledMs = MillisecondsSince(start);
+
+        failures += Check(pooled.lods.size() == mesh.lods.size(), name + ": threaded build made a different number of levels");
+        std::cout << "  level  triangles   of LOD0   estimated   measured max / mean" << std::endl;
+        auto previous = mesh.GetTriangleCount();
+        for (std::size_t l = 0u; l < mesh.lods.size(); l++)
+        {
+            const auto& lod = mesh.lods[l];
+            const auto measured = Measure(mesh, lod.indices);
+            std::cout << "  " << std::setw(5) << l + 1u << std::setw(11) << lod.GetTriangleCount() << std::fixed
+                << std::setprecision(1) << std::setw(9) << 100.0 * lod.GetTriangleCount() / mesh.GetTriangleCount() << "%"
+                << std::setprecision(5) << std::setw(12) << lod.error << std::setw(12) << measured.max << " / "
+                << measured.mean << std::endl;
+            const auto label = name + " level " + std::to_string(l + 1u);
+            failures += Check(lod.GetTriangleCount() < previous, label + ": not fewer triangles than the previous level");
+            previous = lod.GetTriangleCount();
+            bool valid = lod.indices.size() % 3u == 0u;
+            for (std::size_t i = 0u; valid && i < lod.indices.size(); i += 3u)
+            {
+                const auto a = lod.indices[i], b = lod.indices[i + 1u], c = lod.indices[i + 2u];
+                valid = a < mesh.vertices.size() && b < mesh.vertices.size() && c < mesh.vertices.size() &&
+                    classes[a] != classes[b] && classes[b] != classes[c] && classes[a] != classes[c];
+            }
+            failures += Check(valid, label + ": bad or degenerate triangles");
+            failures += Check(l < pooled.lods.size() && pooled.lods[l].indices == lod.indices, label + ": threaded result differs");
+            const auto open = OpenEdges(lod.indices, classes);
+            if (closed)
+            {
+                failures += Check(open.empty(), label + ": closed mesh has " + std::to_string(open.size()) + " open edges");
+            }
+            if (options.lockBorder)
+            {
+                failures += Check(open == originalOpen, label + ": border edges changed");
+            }
+            // 估计的误差应该和实测的同一个量级
+            failures += Check(measured.max <= std::max(4.0 * lod.error, 1e-4) + 1e-3, label + ": measured error far above the estimate");
+        }
+        std::cout << std::setprecision(1) << "  built in " << singleMs << " ms on 1 thread, " << pooledMs << " ms on "
+            << pool.GetWorkerCount() + 1u << std::endl;
+        std::cout << "  box orbit (6-20 units, <= 1 px error): " << 100.0 * OrbitTriangleFraction(mesh) << "% of LOD0 triangles"
+            << std::endl;
+
+        // 运行时选择：默认设置、不带滞后、不淡入淡出
+        LodSettings noHysteresis;
+        noHysteresis.hysteresis = 0.0f;
+        LodSettings noFade;
+        noFade.fadeSeconds = 0.0f;
+        const std::pair<const char*, LodSettings> variants[] = {
+            { "default", LodSettings{} }, { "no hysteresis", noHysteresis }, { "no fade", noFade } };
+        std::cout << "  runtime selection, " << orbitInstances << " instances on box orbits for " << orbitSeconds
+            << " s:" << std::endl;
+        // 轨道上；停在切换点附近、深度按 2 Hz 抖动 +-0.05（例如浮动的物体），这时才看得出滞后的作用。
+        // 切换点的实例大小不一，三角形的比例没有意义。
+        // 网格很细时误差很小，1 px 的切换点要物体比屏幕大几十倍（相机在包围球里面），放不上去；
+        // 所有切换直径都和 pixelError 成正比、滞后是相对的，所以放大 pixelError 把最细一级的切换点挪到半个屏幕高，
+        // 效果和换一块大屏幕一样
+        const auto halfScreen = 0.5f * float(1.0 / tanHalfFovY) * float(screenHeight);
+        const auto finestSwitch = mesh.lods.empty() ? 0.0f : MakeSelector(mesh, {}).GetMaxDiameter(1u);
+        const auto thresholdScale = finestSwitch > halfScreen ? halfScreen / finestSwitch : 1.0f;
+        double switchesWithHysteresis = 0.0, switchesWithout = 0.0;
+        for (const auto atThresholds : { false, true })
+        {
+            if (atThresholds && thresholdScale < 1.0f)
+            {
+                std::cout << "    (at switch points: pixel error scaled to " << std::setprecision(3) << thresholdScale
+                    << " px so the switch points fit on screen)" << std::endl;
+            }
+            for (auto [label, settings] : variants)
+            {
+                if (atThresholds)
+                {
+                    settings.pixelError *= thresholdScale;
+                }
+                const auto r = SimulateOrbits(mesh, settings, orbitInstances, orbitSeconds, atThresholds ? 0.05f : 0.0f,
+                    atThresholds);
+                const auto variant = std::string(label) + (atThresholds ? ", at switch points" : "");
+                if (!r.simulated)
+                {
+                    std::cout << "    " << variant << ": every switch point needs the camera inside the bounds" << std::endl;
+                    continue;
+                }
+                std::cout << "    " << std::left << std::setw(32) << variant << std::right << std::setprecision(1)
+                    << 100.0 * r.triangleFraction << "% of LOD0 triangles/frame, " << std::setprecision(3)
+                    << r.switchesPerSecond << " switches/instance/s, " << std::setprecision(1) << 100.0 * r.fadingFraction
+                    << "% fading, " << r.nsPerUpdate << " ns/update" << std::endl;
+                failures += Check(r.overErrorSelections == 0u, name + " " + variant + ": " +
+                    std::to_string(r.overErrorSelections) + " selections over the pixel error");
+                if (atThresholds && settings.fadeSeconds > 0.0f)
+                {
+                    (settings.hysteresis > 0.0f ? switchesWithHysteresis : switchesWithout) = r.switchesPerSecond;
+                }
+            }
+        }
+        // 停在切换点上抖动时，不带滞后的每次越过都会切换，带滞后的几乎不切换
+        if (!mesh.lods.empty())
+        {
+            failures += Check(switchesWithout > 0.0 && switchesWithHysteresis < 0.25 * switchesWithout,
+                name + ": hysteresis does not reduce switches at switch points");
+        }
+        return failures;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    std::size_t triangles = 500000u;
+    std::vector<float> ratios = { 0.5f, 0.25f, 0.125f, 0.0625f };
+    MeshSimplifyOptions options;
+    unsigned int threads = 0u;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg.rfind("--", 0u) != 0u)
+        {
+            paths.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            std::cerr << "usage: LodBench [model files...] [--triangles N] [--ratios 0.5,0.25,...] [--max-error E] [--threads N]"
+                << std::endl;
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--triangles") triangles = std::size_t(std::stoull(value));
+        else if (arg == "--ratios") ratios = ParseRatios(value);
+        else if (arg == "--max-error") options.maxError = std::stof(value);
+        else if (arg == "--threads") threads = unsigned(std::stoul(value));
+        else
+        {
+            std::cerr << "unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        ThreadPool pool(threads);
+        int failures = 0;
+        if (paths.empty())
+        {
+            auto start = Clock::now();
+            auto sphere = ImportObjText(GenerateSphere(triangles), "sphere");
+            auto terrain = ImportObjText(GenerateTerrain(triangles), "terrain");
+            std::cout << "generated and imported in " << std::fixed << std::setprecision(0) << MillisecondsSince(start) << " ms"
+                << std::endl;
+            failures += Run("sphere", std::move(sphere), ratios, options, pool, true);
+            failures += Run("terrain", terrain, ratios, options, pool, false);
+            auto unlocked = options;
+            unlocked.lockBorder = false;
+            failures += Run("terrain", std::move(terrain), ratios, unlocked, pool, false);
+        }
+        for (const auto& path : paths)
+        {
+            const auto data = ReadFile(path);
+            auto mesh = MeshImporter::Import(data.data(), data.size(), path, {}, &pool);
+            failures += Run(std::filesystem::path(path).filename().string(), std::move(mesh), ratios, options, pool, false);
+        }
+        std::cout << (failures == 0 ? "all checks passed" : "some checks FAILED") << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
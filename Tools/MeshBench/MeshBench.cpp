@@ -0,0 +1,397 @@
+// OBJ / PLY 导入的无头基准和正确性检查：
+// 1. MeshImporter::ParseFloat 和 strtof 对比（多种写法的随机数），误差不能超过 1 ulp；
+// 2. 几个手写的小文件：负下标、多边形、缺法线、额外的 PLY 元素和属性、大端二进制；
+// 3. 生成同一张网格的 OBJ、ascii PLY、二进制 PLY，先全部读进内存（不计磁盘时间），分别用单线程和线程池导入，
+//    报告 MB/s 和 百万三角形/s，并检查三种格式、两种线程数导入的结果逐字节相同。
+// 给了模型文件时只测这些文件。
+// usage: MeshBench [model files...] [--triangles N] [--iterations N] [--threads N] [--keep]
+#include "MeshImporter.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::vector<std::byte> ReadFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("cannot open " + path);
+        }
+        std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::vector<std::byte> data(bytes.size());
+        std::memcpy(data.data(), bytes.data(), bytes.size());
+        return data;
+    }
+
+    MeshData ImportString(const std::string& text, const MeshImportOptions& options = {})
+    {
+        return MeshImporter::Import(reinterpret_cast<const std::byte*>(text.data()), text.size(), "inline", options);
+    }
+
+    bool SameMesh(const MeshData& a, const MeshData& b)
+    {
+        return a.vertices.size() == b.vertices.size() && a.indices == b.indices &&
+            std::memcmp(a.vertices.data(), b.vertices.data(), a.vertices.size() * sizeof(MeshVertex)) == 0;
+    }
+
+    int Check(bool condition, const std::string& what)
+    {
+        if (!condition)
+        {
+            std::cout << "  FAILED: " << what << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    int CheckParseFloat()
+    {
+        std::mt19937 rng(5u);
+        std::uniform_real_distribution<double> magnitude(-12.0, 12.0);
+        const char* const formats[] = { "%.9g", "%.6f", "%e", "%.3f", "%.17g", "%.0f" };
+        std::size_t exact = 0u, oneUlp = 0u, worse = 0u, total = 0u;
+        char text[64];
+        for (int i = 0; i < 200000; i++)
+        {
+            const auto value = std::pow(10.0, magnitude(rng)) * (rng() & 1u ? -1.0 : 1.0);
+            for (const auto format : formats)
+            {
+                std::snprintf(text, sizeof(text), format, value);
+                const auto expected = std::strtof(text, nullptr);
+                const char* p = text;
+                float parsed;
+                if (!MeshImporter::ParseFloat(p, text + std::strlen(text), parsed) || *p != '\0')
+                {
+                    worse++;
+                    continue;
+                }
+                std::int32_t a, b;
+                std::memcpy(&a, &expected, 4u);
+                std::memcpy(&b, &parsed, 4u);
+                const auto ulps = std::abs(std::int64_t(a) - std::int64_t(b));
+                exact += ulps == 0;
+                oneUlp += ulps == 1;
+                worse += ulps > 1;
+                total++;
+            }
+        }
+        std::cout << "ParseFloat vs strtof: " << total << " numbers, " << exact << " exact, " << oneUlp << " off by 1 ulp, "
+            << worse << " worse" << std::endl;
+        return Check(worse == 0u, "ParseFloat is more than 1 ulp away from strtof");
+    }
+
+    int CheckSmallFiles()
+    {
+        int failures = 0;
+        // 五边形（3 个三角形）+ 负下标的三角形，没有法线
+        const auto obj = ImportString(
+            "# comment\n"
+            "o thing\n"
+            "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0.5 1.5 0\nv 0 1 0\n"
+            "vt 0 0\nvt 1 0\nvt 1 1\n"
+            "f 1/1 2/2 3/3 4/3 5/1\r\n"
+            "usemtl foo\n"
+            "f -3/-1 -2/-2 -1/-3\n");
+        failures += Check(obj.GetTriangleCount() == 4u, "OBJ polygon fan triangle count");
+        failures += Check(obj.vertices.size() == 6u, "OBJ weld keeps distinct position/texcoord pairs");
+        // 逆时针朝 +z 的面转到左手系后朝 -z
+        failures += Check(std::abs(obj.vertices[0].normal[2] + 1.0f) < 1e-6f, "OBJ generated normal points along -z");
+        failures += Check(obj.vertices[0].texCoord[1] == 1.0f, "OBJ v is flipped");
+        // f -3/-1 -2/-2 -1/-3 是 (3/3, 4/2, 5/1)，第二个角是新顶点；转换时交换了后两个角
+        failures += Check(obj.indices[9] == 2u && obj.indices[10] == 4u && obj.indices[11] == 5u, "OBJ negative indices");
+
+        bool threw = false;
+        try
+        {
+            ImportString("v 0 0 0\nv 1 0 0\nf 1 2 3\n");
+        }
+        catch (const MeshException&)
+        {
+            threw = true;
+        }
+        failures += Check(threw, "OBJ out-of-range index throws");
+
+        // 额外的元素和属性、四边形面
+        const auto ply = ImportString(
+            "ply\nformat ascii 1.0\ncomment test\n"
+            "element material 1\nproperty float shininess\n"
+            "element vertex 4\nproperty float x\nproperty float y\nproperty float z\nproperty uchar red\n"
+            "property float nx\nproperty float ny\nproperty float nz\n"
+            "element face 1\nproperty uchar flags\nproperty list uchar int vertex_indices\n"
+            "end_header\n"
+            "0.5\n"
+            "0 0 0 255 0 0 1\n1 0 0 255 0 0 1\n1 1 0 255 0 0 1\n0 1 0 255 0 0 1\n"
+            "7 4 0 1 2 3\n");
+        failures += Check(ply.GetTriangleCount() == 2u && ply.vertices.size() == 4u, "ascii PLY with extra elements");
+        failures += Check(ply.vertices[0].normal[2] == -1.0f, "ascii PLY normals are read and converted");
+
+        // 大端二进制：4 个顶点（double），一个 ushort 下标的四边形
+        std::string binary = "ply\nformat binary_big_endian 1.0\nelement vertex 4\n"
+            "property double x\nproperty double y\nproperty double z\n"
+            "element face 1\nproperty list uchar ushort vertex_indices\nend_header\n";
+        const double corners[4][3] = { { 0, 0, 0 }, { 2, 0, 0 }, { 2, 2, 0 }, { 0, 2, 0 } };
+        for (const auto& c : corners)
+        {
+            for (const auto v : c)
+            {
+                unsigned char raw[8];
+                std::memcpy(raw, &v, 8u);
+                std::reverse(raw, raw + 8);
+                binary.append(reinterpret_cast<const char*>(raw), 8u);
+            }
+        }
+        binary += char(4);
+        for (const unsigned short i : { 0, 1, 2, 3 })
+        {
+            binary += char(i >> 8);
+            binary += char(i & 0xFF);
+        }
+        const auto be = ImportString(binary);
+        failures += Check(be.GetTriangleCount() == 2u && be.vertices.size() == 4u && be.vertices[2].position[1] == 2.0f,
+            "big-endian binary PLY");
+        return failures;
+    }
+
+    struct Generated
+    {
+        std::string obj;
+        std::string plyAscii;
+        std::string plyBinary;
+        std::size_t vertices;
+        std::size_t triangles;
+    };
+
+    // side x side 个四边形的起伏网格，每个顶点的 8 个数字先格式化成文本；二进制 PLY 存 ParseFloat 解析文本的结果，
+    // 所以三种格式导入后应该逐字节相同
+    Generated Generate(std::size_t targetTriangles)
+    {
+        const auto side = std::size_t(std::sqrt(double(targetTriangles) / 2.0)) + 1u;
+        Generated g;
+        g.vertices = (side + 1u) * (side + 1u);
+        g.triangles = side * side * 2u;
+        std::string vertexText, normalText, texText, plyVertexText;
+        std::string plyVertexBinary;
+        char line[160];
+        for (std::size_t j = 0u; j <= side; j++)
+        {
+            for (std::size_t i = 0u; i <= side; i++)
+            {
+                const auto x = double(i) / side * 20.0 - 10.0;
+                const auto z = double(j) / side * 20.0 - 10.0;
+                const auto y = std::sin(x * 0.7) * std::cos(z * 0.5);
+                const auto dx = 0.7 * std::cos(x * 0.7) * std::cos(z * 0.5);
+                const auto dz = -0.5 * std::sin(x * 0.7) * std::sin(z * 0.5);
+                const auto length = std::sqrt(dx * dx + 1.0 + dz * dz);
+                const double values[8] = { x, y, z, -dx / length, 1.0 / length, -dz / length, double(i) / side, double(j) / side };
+                char numbers[8][32];
+                for (int k = 0; k < 8; k++)
+                {
+                    std::snprintf(numbers[k], sizeof(numbers[k]), "%.6f", values[k]);
+                    const char* p = numbers[k];
+                    float f;
+                    MeshImporter::ParseFloat(p, p + std::strlen(p), f);
+                    plyVertexBinary.append(reinterpret_cast<const char*>(&f), 4u);
+                }
+                std::snprintf(line, sizeof(line), "v %s %s %s\n", numbers[0], numbers[1], numbers[2]);
+                vertexText += line;
+                std::snprintf(line, sizeof(line), "vn %s %s %s\n", numbers[3], numbers[4], numbers[5]);
+                normalText += line;
+                std::snprintf(line, sizeof(line), "vt %s %s\n", numbers[6], numbers[7]);
+                texText += line;
+                // 8 个数直接接到字符串后面，不经过 line（最长 8 x 31 个字符，放不下）
+                for (int k = 0; k < 8; k++)
+                {
+                    plyVertexText += numbers[k];
+                    plyVertexText += k == 7 ? '\n' : ' ';
+                }
+            }
+        }
+        std::string objFaces, plyFaceText, plyFaceBinary;
+        for (std::size_t j = 0u; j < side; j++)
+        {
+            for (std::size_t i = 0u; i < side; i++)
+            {
+                // 右手系里从 +y 往下看是逆时针
+                const std::uint32_t q[4] = {
+                    std::uint32_t(j * (side + 1u) + i), std::uint32_t((j + 1u) * (side + 1u) + i),
+                    std::uint32_t((j + 1u) * (side + 1u) + i + 1u), std::uint32_t(j * (side + 1u) + i + 1u) };
+                std::snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n",
+                    q[0] + 1u, q[0] + 1u, q[0] + 1u, q[1] + 1u, q[1] + 1u, q[1] + 1u,
+                    q[2] + 1u, q[2] + 1u, q[2] + 1u, q[3] + 1u, q[3] + 1u, q[3] + 1u);
+                objFaces += line;
+                std::snprintf(line, sizeof(line), "4 %u %u %u %u\n", q[0], q[1], q[2], q[3]);
+                plyFaceText += line;
+                plyFaceBinary += char(4);
+                plyFaceBinary.append(reinterpret_cast<const char*>(q), sizeof(q));
+            }
+        }
+        g.obj = "# generated by MeshBench\n" + vertexText + texText + normalText + objFaces;
+        const auto header = [&](const char* format) {
+            return std::string("ply\nformat ") + format + " 1.0\nelement vertex " + std::to_string(g.vertices) +
+                "\nproperty float x\nproperty float y\nproperty float z\nproperty float nx\nproperty float ny\nproperty float nz\n"
+                "property float u\nproperty float v\nelement face " + std::to_string(side * side) +
+                "\nproperty list uchar uint vertex_indices\nend_header\n";
+        };
+        g.plyAscii = header("ascii") + plyVertexText + plyFaceText;
+        g.plyBinary = header("binary_little_endian") + plyVertexBinary + plyFaceBinary;
+        return g;
+    }
+
+    struct Timing
+    {
+        double bestMs;
+        MeshData mesh;
+    };
+
+    Timing TimeImport(const std::vector<std::byte>& data, const std::string& name, ThreadPool* pPool, unsigned int iterations)
+    {
+        Timing t{ 1e30, {} };
+        for (unsigned int i = 0u; i < iterations; i++)
+        {
+            const auto start = Clock::now();
+            auto mesh = MeshImporter::Import(data.data(), data.size(), name, {}, pPool);
+            t.bestMs = std::min(t.bestMs, MillisecondsSince(start));
+            t.mesh = std::move(mesh);
+        }
+        return t;
+    }
+
+    void Report(const std::string& name, std::size_t bytes, const Timing& single, const Timing& pooled)
+    {
+        const auto mb = double(bytes) / (1024.0 * 1024.0);
+        const auto tris = double(single.mesh.GetTriangleCount()) / 1e6;
+        std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(8) << mb << " MB" << std::setw(10) << single.bestMs << " ms" << std::setw(8) << mb / single.bestMs * 1000.0 << " MB/s"
+            << std::setprecision(2) << std::setw(7) << tris / single.bestMs * 1000.0 << " Mtri/s"
+            << std::setprecision(1) << std::setw(10) << pooled.bestMs << " ms" << std::setprecision(2) << std::setw(7)
+            << single.bestMs / pooled.bestMs << "x" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    std::size_t triangles = 2000000u;
+    unsigned int iterations = 3u;
+    unsigned int threads = 0u;
+    bool keep = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--keep")
+        {
+            keep = true;
+            continue;
+        }
+        if (arg.rfind("--", 0u) != 0u)
+        {
+            paths.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            std::cerr << "usage: MeshBench [model files...] [--triangles N] [--iterations N] [--threads N] [--keep]" << std::endl;
+            return 1;
+        }
+        const auto value = std::stoull(argv[++i]);
+        if (arg == "--triangles") triangles = std::size_t(value);
+        else if (arg == "--iterations") iterations = unsigned(value);
+        else if (arg == "--threads") threads = unsigned(value);
+        else
+        {
+            std::cerr << "unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (iterations == 0u || triangles == 0u)
+    {
+        std::cerr << "bad options" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        ThreadPool pool(threads);
+        int failures = 0;
+        std::vector<std::string> generatedPaths;
+        if (paths.empty())
+        {
+            failures += CheckParseFloat();
+            failures += CheckSmallFiles();
+            const auto start = Clock::now();
+            const auto g = Generate(triangles);
+            std::cout << "generated a " << g.triangles << "-triangle grid in " << std::fixed << std::setprecision(0)
+                << MillisecondsSince(start) << " ms" << std::endl;
+            const auto dir = std::filesystem::temp_directory_path();
+            const std::pair<const char*, const std::string*> files[] = {
+                { "MeshBench.obj", &g.obj }, { "MeshBench_ascii.ply", &g.plyAscii }, { "MeshBench_binary.ply", &g.plyBinary } };
+            for (const auto& f : files)
+            {
+                const auto path = (dir / f.first).string();
+                std::ofstream(path, std::ios::binary).write(f.second->data(), std::streamsize(f.second->size()));
+                paths.push_back(path);
+                generatedPaths.push_back(path);
+            }
+        }
+
+        std::cout << "import, best of " << iterations << "; single thread, then " << pool.GetWorkerCount() + 1u << " threads" << std::endl;
+        std::vector<MeshData> results;
+        for (const auto& path : paths)
+        {
+            const auto data = ReadFile(path);
+            const auto name = std::filesystem::path(path).filename().string();
+            const auto single = TimeImport(data, name, nullptr, iterations);
+            auto pooled = TimeImport(data, name, &pool, iterations);
+            Report(name, data.size(), single, pooled);
+            failures += Check(SameMesh(single.mesh, pooled.mesh), name + ": threaded import differs from single-threaded");
+            results.push_back(std::move(pooled.mesh));
+        }
+        if (!generatedPaths.empty())
+        {
+            const auto side = std::size_t(std::sqrt(double(triangles) / 2.0)) + 1u;
+            failures += Check(results[0].vertices.size() == (side + 1u) * (side + 1u) && results[0].GetTriangleCount() == side * side * 2u,
+                "OBJ vertex / triangle count after welding");
+            failures += Check(SameMesh(results[0], results[1]), "OBJ and ascii PLY imports differ");
+            failures += Check(SameMesh(results[0], results[2]), "OBJ and binary PLY imports differ");
+            if (!keep)
+            {
+                for (const auto& path : generatedPaths)
+                {
+                    std::filesystem::remove(path);
+                }
+            }
+        }
+        if (failures != 0)
+        {
+            std::cout << failures << " problem(s) found" << std::endl;
+            return 1;
+        }
+        std::cout << "all checks passed" << std::endl;
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,598 @@
+// 分簇（MeshletBuilder）和按簇的 CPU 剔除（MeshletCulling）的无头基准和检查：
+// 1. 生成几个模型（起伏的球、圆环、地形）写成 OBJ 再导入，或者测给定的模型文件；像 App 一样生成 LOD 链；
+// 2. 原网格和每级 LOD 分簇，单线程和线程池各一次，报告时间、簇数、每簇平均的三角形 / 顶点数、有法线锥的簇的比例；
+// 3. 检查：三角形一个不多一个不少（顶点顺序不变）、每簇不超过 64 个顶点 / 124 个三角形、簇在索引里首尾相接、
+//    包围球包住所有顶点、两种线程数的结果相同；
+// 4. 三种视角下剔除：App 里转动的 --model（半径 3，距离 12），贴近相机、一部分在屏幕外的特写，
+//    箱子轨道上的小实例（半径 1，--model-count）。报告剩下的三角形比例（视锥 / 背面各剔掉多少个簇），
+//    和逐个三角形判断的理想值相比；每次剔除的耗时，和直接拷贝整个索引列表相比；
+//    检查剔掉的簇里每个三角形确实在视锥外或者背对相机；
+// 5. 对比 coneWeight = 0（只看新增顶点数）时背面剔除的效果。
+// usage: MeshletBench [model files...] [--triangles N] [--cone-weight W] [--threads N]
+#include "MeshImporter.h"
+#include "MeshletBuilder.h"
+#include "MeshletCulling.h"
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr double pi = 3.14159265358979323846;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::vector<std::byte> ReadFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            throw std::runtime_error("cannot open " + path);
+        }
+        std::vector<std::byte> data(std::size_t(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size()));
+        return data;
+    }
+
+    int Check(bool condition, const std::string& what)
+    {
+        if (!condition)
+        {
+            std::cout << "FAILED: " << what << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    MeshData ImportObjText(const std::string& text, const std::string& name)
+    {
+        return MeshImporter::ImportObj(reinterpret_cast<const std::byte*>(text.data()), text.size(), name);
+    }
+
+    // u x v 的网格，position(u, v) 给出点；wrapU / wrapV 时首尾相接（共用位置，纹理坐标不同，形成接缝）。
+    // 三角形按左手系顺时针为正面写出：OBJ 是逆时针为正面，导入时会换成顺时针
+    template<typename F>
+    std::string GenerateGrid(std::size_t columns, std::size_t rows, F&& position)
+    {
+        std::string v, vt, f;
+        char line[160];
+        for (std::size_t r = 0u; r <= rows; r++)
+        {
+            for (std::size_t c = 0u; c <= columns; c++)
+            {
+                const auto p = position(double(c) / double(columns), double(r) / double(rows));
+                std::snprintf(line, sizeof(line), "v %.7f %.7f %.7f\n", p[0], p[1], p[2]);
+                v += line;
+                std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", double(c) / double(columns), double(r) / double(rows));
+                vt += line;
+            }
+        }
+        for (std::size_t r = 0u; r < rows; r++)
+        {
+            for (std::size_t c = 0u; c < columns; c++)
+            {
+                const auto a = r * (columns + 1u) + c + 1u;
+                const auto b = a + columns + 1u;
+                std::snprintf(line, sizeof(line), "f %zu/%zu %zu/%zu %zu/%zu\nf %zu/%zu %zu/%zu %zu/%zu\n",
+                    a, a, a + 1u, a + 1u, b, b, a + 1u, a + 1u, b + 1u, b + 1u, b, b);
+                f += line;
+            }
+        }
+        return "# generated by MeshletBench\n" + v + vt + f;
+    }
+
+    // 起伏的球（极点退化成一圈同位置的顶点，简单起见不合并）
+    std::string GenerateSphere(std::size_t targetTriangles)
+    {
+        const auto rows = std::size_t(std::sqrt(double(targetTriangles) / 4.0)) + 2u;
+        return GenerateGrid(rows * 2u, rows, [](double u, double v) {
+            const auto theta = pi * v, phi = -2.0 * pi * u;
+            const auto bump = 1.0 + 0.08 * std::sin(theta * 7.0) * std::cos(phi * 5.0);
+            return std::array<double, 3>{ std::sin(theta) * std::cos(phi) * bump, std::cos(theta) * bump,
+                std::sin(theta) * std::sin(phi) * bump };
+        });
+    }
+
+    // 圆环：内圈朝向各异，背面剔除比球难
+    std::string GenerateTorus(std::size_t targetTriangles)
+    {
+        const auto rows = std::size_t(std::sqrt(double(targetTriangles) / 8.0)) + 2u;
+        return GenerateGrid(rows * 4u, rows, [](double u, double v) {
+            const auto a = 2.0 * pi * u, b = 2.0 * pi * v;
+            const auto ring = 1.0 + 0.35 * std::cos(b);
+            return std::array<double, 3>{ ring * std::cos(a), 0.35 * std::sin(b), ring * std::sin(a) };
+        });
+    }
+
+    // 朝上的起伏地形，开放网格
+    std::string GenerateTerrain(std::size_t targetTriangles)
+    {
+        const auto side = std::size_t(std::sqrt(double(targetTriangles) / 2.0)) + 1u;
+        return GenerateGrid(side, side, [](double u, double v) {
+            const auto x = u * 2.0 - 1.0, z = 1.0 - v * 2.0;
+            return std::array<double, 3>{ x, 0.1 * std::sin(x * 9.0) * std::cos(z * 7.0), z };
+        });
+    }
+
+    // 行向量约定的 4x4 矩阵（和 DirectXMath 一样，v' = v * m）
+    struct Matrix
+    {
+        float m[4][4];
+    };
+
+    Matrix Multiply(const Matrix& a, const Matrix& b)
+    {
+        Matrix r = {};
+        for (int i = 0; i < 4; i++)
+        {
+            for (int j = 0; j < 4; j++)
+            {
+                for (int k = 0; k < 4; k++)
+                {
+                    r.m[i][j] += a.m[i][k] * b.m[k][j];
+                }
+            }
+        }
+        return r;
+    }
+
+    Matrix Identity()
+    {
+        return { { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } };
+    }
+
+    Matrix Translation(float x, float y, float z)
+    {
+        auto r = Identity();
+        r.m[3][0] = x;
+        r.m[3][1] = y;
+        r.m[3][2] = z;
+        return r;
+    }
+
+    Matrix Scaling(float s)
+    {
+        auto r = Identity();
+        r.m[0][0] = r.m[1][1] = r.m[2][2] = s;
+        return r;
+    }
+
+    // XMMatrixRotationRollPitchYaw(pitch, yaw, roll)：先绕 z 转 roll，再绕 x 转 pitch，最后绕 y 转 yaw
+    Matrix Rotation(float pitch, float yaw, float roll)
+    {
+        const float cr = std::cos(roll), sr = std::sin(roll);
+        const float cp = std::cos(pitch), sp = std::sin(pitch);
+        const float cy = std::cos(yaw), sy = std::sin(yaw);
+        const Matrix z = { { { cr, sr, 0, 0 }, { -sr, cr, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } };
+        const Matrix x = { { { 1, 0, 0, 0 }, { 0, cp, sp, 0 }, { 0, -sp, cp, 0 }, { 0, 0, 0, 1 } } };
+        const Matrix y = { { { cy, 0, -sy, 0 }, { 0, 1, 0, 0 }, { sy, 0, cy, 0 }, { 0, 0, 0, 1 } } };
+        return Multiply(Multiply(z, x), y);
+    }
+
+    // App 的投影：XMMatrixPerspectiveLH(1, 3/4, 0.5, 40)
+    Matrix Projection()
+    {
+        constexpr float n = 0.5f, f = 40.0f;
+        const float q = f / (f - n);
+        return { { { 2.0f * n / 1.0f, 0, 0, 0 }, { 0, 2.0f * n / 0.75f, 0, 0 }, { 0, 0, q, 1 }, { 0, 0, -n * q, 0 } } };
+    }
+
+    // 仿射矩阵的逆作用在原点上：相机（原点）在模型空间的位置
+    std::array<float, 3> CameraInModelSpace(const Matrix& world)
+    {
+        // 解 p * A + t = 0，A 是左上 3x3，t 是平移：p = -t * A^-1
+        const auto& m = world.m;
+        const double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+            m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+        double inv[3][3];
+        inv[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) / det;
+        inv[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) / det;
+        inv[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) / det;
+        inv[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) / det;
+        inv[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) / det;
+        inv[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) / det;
+        inv[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) / det;
+        inv[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) / det;
+        inv[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) / det;
+        std::array<float, 3> p = {};
+        for (int j = 0; j < 3; j++)
+        {
+            double s = 0.0;
+            for (int k = 0; k < 3; k++)
+            {
+                s -= m[3][k] * inv[k][j];
+            }
+            p[j] = float(s);
+        }
+        return p;
+    }
+
+    // App 的 FitBounds：包围盒中心移到原点，对角线的一半缩放到 radius
+    Matrix FitBounds(const MeshData& mesh, float radius)
+    {
+        float halfDiagonal = 0.0f;
+        float center[3];
+        for (int c = 0; c < 3; c++)
+        {
+            center[c] = (mesh.boundsMin[c] + mesh.boundsMax[c]) * 0.5f;
+            const auto half = (mesh.boundsMax[c] - mesh.boundsMin[c]) * 0.5f;
+            halfDiagonal += half * half;
+        }
+        halfDiagonal = std::sqrt(halfDiagonal);
+        return Multiply(Translation(-center[0], -center[1], -center[2]), Scaling(halfDiagonal > 0.0f ? radius / halfDiagonal : 1.0f));
+    }
+
+    struct View
+    {
+        Matrix world;
+    };
+
+    // 转动的 --model：半径 3、距离 12，绕 y 转一圈，每 10 度一个，另外再俯仰 30 度转一圈
+    std::vector<View> SpinningViews(const MeshData& mesh)
+    {
+        std::vector<View> views;
+        for (int tilt = 0; tilt < 2; tilt++)
+        {
+            for (int i = 0; i < 36; i++)
+            {
+                views.push_back({ Multiply(Multiply(FitBounds(mesh, 3.0f), Rotation(float(tilt) * 0.52f, float(i) * float(pi) / 18.0f, 0.0f)),
+                    Translation(0.0f, 0.0f, 12.0f)) });
+            }
+        }
+        return views;
+    }
+
+    // 特写：半径 3，中心在相机前 4.5、偏右 2.5，大半在屏幕外
+    std::vector<View> CloseUpViews(const MeshData& mesh)
+    {
+        std::vector<View> views;
+        for (int i = 0; i < 36; i++)
+        {
+            views.push_back({ Multiply(Multiply(FitBounds(mesh, 3.0f), Rotation(0.3f, float(i) * float(pi) / 18.0f, 0.0f)),
+                Translation(2.5f, 0.0f, 4.5f)) });
+        }
+        return views;
+    }
+
+    // --model-count 的实例：半径 1，BoxMotion::Random 的轨道上随机取的姿态（可能在相机后面）
+    std::vector<View> OrbitViews(const MeshData& mesh)
+    {
+        std::mt19937 rng(11u);
+        std::uniform_real_distribution<float> adist(0.0f, 3.1415f * 2.0f);
+        std::uniform_real_distribution<float> rdist(6.0f, 20.0f);
+        std::vector<View> views;
+        for (int i = 0; i < 200; i++)
+        {
+            const auto spin = Rotation(adist(rng), adist(rng), adist(rng));
+            const auto orbit = Rotation(adist(rng), adist(rng), adist(rng));
+            views.push_back({ Multiply(Multiply(Multiply(Multiply(FitBounds(mesh, 1.0f), spin), Translation(rdist(rng), 0.0f, 0.0f)), orbit),
+                Translation(0.0f, 0.0f, 20.0f)) });
+        }
+        return views;
+    }
+
+    struct CullResult
+    {
+        MeshletCullStats stats;
+        // 逐个三角形判断（整个在某个视锥平面外、或者背对相机）后剩下的
+        std::size_t idealTriangles = 0u;
+        std::size_t totalTriangles = 0u;
+        double cullNs = 0.0;
+        double copyNs = 0.0;
+        // 只做可见性测试、不拷索引时每个簇的耗时
+        double testNs = 0.0;
+        std::size_t wrongCulls = 0u;
+    };
+
+    double PlaneDistance(const float* plane, const double* p)
+    {
+        return plane[0] * p[0] + plane[1] * p[1] + plane[2] * p[2] + plane[3];
+    }
+
+    // 剔掉的簇里的三角形必须真的看不见；顺便统计逐个三角形剔除的理想结果
+    CullResult EvaluateViews(const MeshData& mesh, const std::vector<std::uint32_t>& indices, const std::vector<Meshlet>& meshlets,
+        const std::vector<View>& views)
+    {
+        CullResult result;
+        const auto projection = Projection();
+        std::vector<std::uint32_t> out(indices.size());
+        std::vector<MeshletCullView> cullViews;
+        for (const auto& view : views)
+        {
+            const auto camera = CameraInModelSpace(view.world);
+            const float cameraArray[3] = { camera[0], camera[1], camera[2] };
+            cullViews.push_back(MeshletCullView::FromMatrix(Multiply(view.world, projection).m, cameraArray));
+        }
+        for (const auto& cullView : cullViews)
+        {
+            // 在 double 里逐个三角形判断，没有容差：整个在某个平面外，或者（侧对着也算）背对相机
+            const auto triangleInvisible = [&](std::size_t i) {
+                double p[3][3];
+                for (int k = 0; k < 3; k++)
+                {
+                    for (int c = 0; c < 3; c++)
+                    {
+                        p[k][c] = mesh.vertices[indices[i + k]].position[c];
+                    }
+                }
+                for (const auto& plane : cullView.planes)
+                {
+                    if (PlaneDistance(plane, p[0]) < 0.0 && PlaneDistance(plane, p[1]) < 0.0 && PlaneDistance(plane, p[2]) < 0.0)
+                    {
+                        return true;
+                    }
+                }
+                // (b - a) x (c - a) 指向正面
+                const double ab[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+                const double ac[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+                const double n[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+                const double toCamera[3] = { cullView.camera[0] - p[0][0], cullView.camera[1] - p[0][1], cullView.camera[2] - p[0][2] };
+                return n[0] * toCamera[0] + n[1] * toCamera[1] + n[2] * toCamera[2] <= 0.0;
+            };
+            for (std::size_t i = 0u; i < indices.size(); i += 3u)
+            {
+                result.idealTriangles += triangleInvisible(i) ? 0u : 1u;
+            }
+            for (const auto& meshlet : meshlets)
+            {
+                if (MeshletCulling::IsVisible(meshlet, cullView, &result.stats))
+                {
+                    continue;
+                }
+                for (std::size_t t = 0u; t < meshlet.triangleCount; t++)
+                {
+                    result.wrongCulls += triangleInvisible(meshlet.firstIndex + t * 3u) ? 0u : 1u;
+                }
+            }
+            result.stats.triangles += MeshletCulling::Cull(meshlets.data(), meshlets.size(), indices.data(), cullView, out.data()) / 3u;
+            result.stats.meshlets += meshlets.size();
+            result.totalTriangles += indices.size() / 3u;
+        }
+
+        // 计时：所有视角循环几遍，至少 50 ms；对照是把整个索引列表拷一遍（不剔除也要上传的量）
+        std::size_t rounds = 0u;
+        const auto start = Clock::now();
+        std::size_t sink = 0u;
+        while (MillisecondsSince(start) < 50.0)
+        {
+            for (const auto& cullView : cullViews)
+            {
+                sink += MeshletCulling::Cull(meshlets.data(), meshlets.size(), indices.data(), cullView, out.data());
+            }
+            rounds++;
+        }
+        result.cullNs = MillisecondsSince(start) * 1e6 / double(rounds * cullViews.size());
+        rounds = 0u;
+        const auto copyStart = Clock::now();
+        while (MillisecondsSince(copyStart) < 50.0)
+        {
+            for (std::size_t v = 0u; v < cullViews.size(); v++)
+            {
+                std::memcpy(out.data(), indices.data(), indices.size() * sizeof(std::uint32_t));
+                sink += out[v % out.size()];
+            }
+            rounds++;
+        }
+        result.copyNs = MillisecondsSince(copyStart) * 1e6 / double(rounds * cullViews.size());
+        rounds = 0u;
+        const auto testStart = Clock::now();
+        while (MillisecondsSince(testStart) < 50.0)
+        {
+            for (const auto& cullView : cullViews)
+            {
+                for (const auto& meshlet : meshlets)
+                {
+                    sink += MeshletCulling::IsVisible(meshlet, cullView) ? 1u : 0u;
+                }
+            }
+            rounds++;
+        }
+        result.testNs = MillisecondsSince(testStart) * 1e6 / double(rounds * cullViews.size() * meshlets.size());
+        if (sink == 1u)
+        {
+            std::cout << "";
+        }
+        return result;
+    }
+
+    using Triangle = std::array<std::uint32_t, 3>;
+
+    // 三角形转到最小的下标开头（不改变环绕方向），排序后比较集合
+    std::vector<Triangle> CanonicalTriangles(const std::vector<std::uint32_t>& indices)
+    {
+        std::vector<Triangle> triangles;
+        for (std::size_t i = 0u; i + 2u < indices.size(); i += 3u)
+        {
+            Triangle t = { indices[i], indices[i + 1u], indices[i + 2u] };
+            std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+            triangles.push_back(t);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    int CheckMeshlets(const std::string& label, const MeshData& mesh, const std::vector<std::uint32_t>& original,
+        const std::vector<std::uint32_t>& indices, const std::vector<Meshlet>& meshlets)
+    {
+        int failures = 0;
+        failures += Check(CanonicalTriangles(original) == CanonicalTriangles(indices), label + ": triangles changed");
+        std::uint32_t next = 0u;
+        bool contiguous = true, withinLimits = true, bounded = true;
+        std::vector<std::uint32_t> seen(mesh.vertices.size(), ~0u);
+        for (std::size_t m = 0u; m < meshlets.size(); m++)
+        {
+            const auto& meshlet = meshlets[m];
+            contiguous = contiguous && meshlet.firstIndex == next;
+            next = meshlet.firstIndex + meshlet.triangleCount * 3u;
+            std::size_t vertices = 0u;
+            for (std::uint32_t i = meshlet.firstIndex; i < next && i < indices.size(); i++)
+            {
+                const auto v = indices[i];
+                if (seen[v] != m)
+                {
+                    seen[v] = std::uint32_t(m);
+                    vertices++;
+                }
+                const auto* p = mesh.vertices[v].position;
+                const float d[3] = { p[0] - meshlet.center[0], p[1] - meshlet.center[1], p[2] - meshlet.center[2] };
+                bounded = bounded && std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) <= meshlet.radius * 1.0001f + 1e-6f;
+            }
+            withinLimits = withinLimits && meshlet.triangleCount >= 1u && meshlet.triangleCount <= MeshletBuilder::maxTriangles &&
+                vertices == meshlet.vertexCount && vertices <= MeshletBuilder::maxVertices;
+        }
+        failures += Check(contiguous && next == indices.size(), label + ": meshlets do not tile the index list");
+        failures += Check(withinLimits, label + ": meshlet over the vertex / triangle limit or wrong vertex count");
+        failures += Check(bounded, label + ": bounding sphere misses a vertex");
+        return failures;
+    }
+
+    int Run(const std::string& name, MeshData mesh, const MeshletOptions& options, ThreadPool& pool)
+    {
+        int failures = 0;
+        // 和 App 的默认一样生成三级 LOD
+        MeshSimplifier::BuildLods(mesh, { 0.5f, 0.25f, 0.125f }, {}, &pool);
+        std::cout << name << ": " << mesh.vertices.size() << " vertices, " << mesh.GetTriangleCount() << " triangles, "
+            << mesh.lods.size() << " LODs" << std::endl;
+        const auto original = mesh;
+
+        auto start = Clock::now();
+        auto single = mesh;
+        MeshletBuilder::BuildAll(single, options);
+        const auto singleMs = MillisecondsSince(start);
+        start = Clock::now();
+        MeshletBuilder::BuildAll(mesh, options, &pool);
+        const auto pooledMs = MillisecondsSince(start);
+        std::cout << std::fixed << std::setprecision(1) << "  built in " << singleMs << " ms on 1 thread, " << pooledMs << " ms on "
+            << pool.GetWorkerCount() + 1u << " (" << 1e3 * singleMs / double(original.GetTriangleCount()) << " us per 1k LOD0 triangles)"
+            << std::endl;
+
+        std::cout << "  level  meshlets  triangles/meshlet  vertices/meshlet  with cone" << std::endl;
+        for (std::size_t l = 0u; l <= mesh.lods.size(); l++)
+        {
+            const auto& indices = l == 0u ? mesh.indices : mesh.lods[l - 1u].indices;
+            const auto& meshlets = l == 0u ? mesh.meshlets : mesh.lods[l - 1u].meshlets;
+            const auto& originalIndices = l == 0u ? original.indices : original.lods[l - 1u].indices;
+            const auto label = name + " level " + std::to_string(l);
+            failures += CheckMeshlets(label, mesh, originalIndices, indices, meshlets);
+            const auto& singleIndices = l == 0u ? single.indices : single.lods[l - 1u].indices;
+            failures += Check(singleIndices == indices, label + ": threaded result differs");
+            double triangles = 0.0, vertices = 0.0, cones = 0.0;
+            for (const auto& m : meshlets)
+            {
+                triangles += m.triangleCount;
+                vertices += m.vertexCount;
+                cones += m.coneCutoff <= 1.0f ? 1.0 : 0.0;
+            }
+            const auto n = double(std::max<std::size_t>(meshlets.size(), 1u));
+            std::cout << "  " << std::setw(5) << l << std::setw(10) << meshlets.size() << std::setw(19) << triangles / n
+                << std::setw(18) << vertices / n << std::setw(10) << 100.0 * cones / n << "%" << std::endl;
+        }
+
+        std::cout << "  LOD0 culling     remaining  ideal   frustum / backface meshlets  us/cull  (copy all)  test ns/meshlet" << std::endl;
+        const std::pair<const char*, std::vector<View>> viewSets[] = {
+            { "spinning", SpinningViews(mesh) }, { "close-up", CloseUpViews(mesh) }, { "orbit", OrbitViews(mesh) } };
+        for (const auto& [label, views] : viewSets)
+        {
+            const auto r = EvaluateViews(mesh, mesh.indices, mesh.meshlets, views);
+            const auto meshlets = double(r.stats.meshlets);
+            std::cout << "  " << std::left << std::setw(14) << label << std::right << std::setprecision(1) << std::setw(10)
+                << 100.0 * double(r.stats.triangles) / double(r.totalTriangles) << "%" << std::setw(6)
+                << 100.0 * double(r.idealTriangles) / double(r.totalTriangles) << "%" << std::setw(14)
+                << 100.0 * double(r.stats.frustumCulled) / meshlets << "% / " << 100.0 * double(r.stats.backfaceCulled) / meshlets
+                << "%" << std::setw(14) << r.cullNs / 1e3 << std::setw(12) << r.copyNs / 1e3 << std::setw(17)
+                << r.testNs << std::endl;
+            failures += Check(r.wrongCulls == 0u, name + " " + label + ": " + std::to_string(r.wrongCulls) + " visible triangles culled");
+        }
+
+        // coneWeight = 0：簇只按共享顶点生长，法线锥更宽
+        auto plain = original;
+        auto plainOptions = options;
+        plainOptions.coneWeight = 0.0f;
+        plain.meshlets = MeshletBuilder::Build(plain, plain.indices, plainOptions);
+        const auto spinning = EvaluateViews(plain, plain.indices, plain.meshlets, viewSets[0].second);
+        std::cout << "  cone weight 0: " << plain.meshlets.size() << " meshlets, spinning "
+            << 100.0 * double(spinning.stats.triangles) / double(spinning.totalTriangles) << "% remaining" << std::endl;
+        return failures;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    std::size_t triangles = 500000u;
+    MeshletOptions options;
+    unsigned int threads = 0u;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg.rfind("--", 0u) != 0u)
+        {
+            paths.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            std::cerr << "usage: MeshletBench [model files...] [--triangles N] [--cone-weight W] [--threads N]" << std::endl;
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--triangles") triangles = std::size_t(std::stoull(value));
+        else if (arg == "--cone-weight") options.coneWeight = std::stof(value);
+        else if (arg == "--threads") threads = unsigned(std::stoul(value));
+        else
+        {
+            std::cerr << "unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        ThreadPool pool(threads);
+        int failures = 0;
+        if (paths.empty())
+        {
+            const auto start = Clock::now();
+            auto sphere = ImportObjText(GenerateSphere(triangles), "sphere");
+            auto torus = ImportObjText(GenerateTorus(triangles), "torus");
+            auto terrain = ImportObjText(GenerateTerrain(triangles), "terrain");
+            std::cout << "generated and imported in " << std::fixed << std::setprecision(0) << MillisecondsSince(start) << " ms"
+                << std::endl;
+            failures += Run("sphere", std::move(sphere), options, pool);
+            failures += Run("torus", std::move(torus), options, pool);
+            failures += Run("terrain", std::move(terrain), options, pool);
+        }
+        for (const auto& path : paths)
+        {
+            const auto data = ReadFile(path);
+            auto mesh = MeshImporter::Import(data.data(), data.size(), path, {}, &pool);
+            failures += Run(std::filesystem::path(path).filename().string(), std::move(mesh), options, pool);
+        }
+        std::cout << (failures == 0 ? "all checks passed" : "some checks FAILED") << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,289 @@
+// PerfCounters 的开销测试：
+// 1. 单线程连续 --calls 次 PerfCounters::Add，和 volatile 普通自增、共享的 std::atomic fetch_add 对比，各跑 --repeats 遍取最快的；
+//    按一次盒子绘制的 5 次 Add（Binds、Maps、BytesMapped、DrawCalls、IndicesDrawn）折算成每次绘制的开销；
+// 2. --threads 个线程同时各加 --calls 次：每线程一份的 PerfCounters::Add 和所有线程共享一个原子计数器；
+// 3. EndFrame：有 --threads 个活着的线程各自带一份计数时每帧汇总的耗时，已注册的计数器个数和注册满 maxCounters 个时各测一次；
+// 4. 检查：每帧的值和累计值等于实际加上去的次数，中途退出的线程的计数不丢，量表取最后一次 Set 的值。
+// usage: PerfCounterBench [--calls N] [--threads N] [--repeats N] [--frames N]
+#include "PerfCounters.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    // 一次 Box 绘制里引擎调 Add 的次数：Drawable::Draw 的 Binds，TransformCbuf 的 Maps 和 BytesMapped，Graphics::DrawIndexed 的 DrawCalls 和 IndicesDrawn
+    constexpr unsigned int addsPerDraw = 5u;
+
+    volatile std::int64_t plainCounter = 0;
+    std::atomic<std::int64_t> sharedCounter{ 0 };
+
+    double Ms(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    template<typename F>
+    double BestOf(unsigned int repeats, F&& f)
+    {
+        double best = 1e30;
+        for (unsigned int r = 0u; r < repeats; r++)
+        {
+            const auto start = Clock::now();
+            f();
+            best = std::min(best, Ms(start));
+        }
+        return best;
+    }
+
+    std::string PerCall(double ms, unsigned long long count)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << ms << " ms (" << std::setprecision(2) << ms * 1e6 / double(count) << " ns/call)";
+        return out.str();
+    }
+
+    // 所有线程建好之后一起开跑，计时从放行算到全部结束
+    template<typename F>
+    double RunThreads(unsigned int threads, F&& f)
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool go = false;
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0u; t < threads; t++)
+        {
+            workers.emplace_back([&] {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&go] { return go; });
+                }
+                f();
+            });
+        }
+        const auto start = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            go = true;
+        }
+        cv.notify_all();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        return Ms(start);
+    }
+
+    // 一直活着的线程，每个都已经 Add 过一次，所以 EndFrame 要遍历它们的计数块
+    class IdleThreads
+    {
+    public:
+        IdleThreads(unsigned int threads, unsigned int id)
+        {
+            for (unsigned int t = 0u; t < threads; t++)
+            {
+                workers.emplace_back([this, id] {
+                    PerfCounters::Add(id);
+                    std::unique_lock<std::mutex> lock(mutex);
+                    nReady++;
+                    cv.notify_all();
+                    cv.wait(lock, [this] { return done; });
+                });
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this, threads] { return nReady == threads; });
+        }
+        ~IdleThreads()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                done = true;
+            }
+            cv.notify_all();
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+        }
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        unsigned int nReady = 0u;
+        bool done = false;
+        std::vector<std::thread> workers;
+    };
+
+    bool Expect(const char* what, double actual, double expected)
+    {
+        if (actual != expected)
+        {
+            std::cout << std::setprecision(17) << "FAIL: " << what << " is " << actual << ", expected " << expected << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long long calls = 20000000u;
+    unsigned int threads = std::max(2u, std::thread::hardware_concurrency());
+    unsigned int repeats = 5u;
+    unsigned int frames = 10000u;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--calls" && i + 1 < argc)
+        {
+            calls = std::stoull(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            threads = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--repeats" && i + 1 < argc)
+        {
+            repeats = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            frames = unsigned(std::stoul(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "usage: PerfCounterBench [--calls N] [--threads N] [--repeats N] [--frames N]" << std::endl;
+            return 1;
+        }
+    }
+    if (calls == 0u || threads == 0u || repeats == 0u || frames == 0u)
+    {
+        std::cerr << "need at least one call, thread, repeat and frame" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        bool ok = true;
+        const auto id = PerfCounters::Register("BenchAdds", PerfCounters::Kind::Counter);
+        const auto gauge = PerfCounters::Register("BenchGauge", PerfCounters::Kind::Gauge);
+        std::cout << calls << " calls, " << threads << " threads, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+        // 单线程
+        PerfCounters::EndFrame();
+        const auto addMs = BestOf(repeats, [id, calls] {
+            for (unsigned long long i = 0u; i < calls; i++)
+            {
+                PerfCounters::Add(id);
+            }
+        });
+        PerfCounters::EndFrame();
+        ok &= Expect("single-thread frame value", PerfCounters::GetFrameValue(id), double(calls) * repeats);
+        const auto plainMs = BestOf(repeats, [calls] {
+            for (unsigned long long i = 0u; i < calls; i++)
+            {
+                plainCounter = plainCounter + 1;
+            }
+        });
+        const auto atomicMs = BestOf(repeats, [calls] {
+            for (unsigned long long i = 0u; i < calls; i++)
+            {
+                sharedCounter.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        std::cout << "one thread, best of " << repeats << std::endl;
+        std::cout << "  PerfCounters::Add   " << PerCall(addMs, calls) << std::endl;
+        std::cout << "  volatile ++         " << PerCall(plainMs, calls) << std::endl;
+        std::cout << "  atomic fetch_add    " << PerCall(atomicMs, calls) << std::endl;
+        std::cout << "  " << addsPerDraw << " Adds / box draw   " << std::fixed << std::setprecision(2)
+                  << addMs * 1e6 / double(calls) * addsPerDraw << " ns/draw" << std::endl;
+
+        // 多线程同时加；ns/call 是墙钟时间除以所有线程的调用总数
+        const auto total = calls * threads;
+        PerfCounters::EndFrame();
+        double threadAddMs = 1e30;
+        double threadAtomicMs = 1e30;
+        for (unsigned int r = 0u; r < repeats; r++)
+        {
+            threadAddMs = std::min(threadAddMs, RunThreads(threads, [id, calls] {
+                for (unsigned long long i = 0u; i < calls; i++)
+                {
+                    PerfCounters::Add(id);
+                }
+            }));
+            threadAtomicMs = std::min(threadAtomicMs, RunThreads(threads, [calls] {
+                for (unsigned long long i = 0u; i < calls; i++)
+                {
+                    sharedCounter.fetch_add(1, std::memory_order_relaxed);
+                }
+            }));
+        }
+        // 这些线程都已经退出，计数要从 retired 里算进来
+        PerfCounters::EndFrame();
+        ok &= Expect("multi-thread frame value", PerfCounters::GetFrameValue(id), double(total) * repeats);
+        std::cout << threads << " threads at once, best of " << repeats << std::endl;
+        std::cout << "  PerfCounters::Add   " << PerCall(threadAddMs, total) << std::endl;
+        std::cout << "  shared atomic       " << PerCall(threadAtomicMs, total) << std::endl;
+
+        // EndFrame：主线程加上 threads 个活着的线程各一份计数块
+        {
+            const IdleThreads idle(threads, id);
+            PerfCounters::EndFrame();
+            ok &= Expect("idle threads frame value", PerfCounters::GetFrameValue(id), double(threads));
+            const auto frameCountBefore = PerfCounters::GetFrameCount();
+            auto start = Clock::now();
+            for (unsigned int f = 0u; f < frames; f++)
+            {
+                PerfCounters::EndFrame();
+            }
+            const auto registeredUs = Ms(start) * 1e3 / frames;
+            const auto registered = PerfCounters::GetCount();
+            ok &= Expect("frame count", double(PerfCounters::GetFrameCount() - frameCountBefore), double(frames));
+            while (PerfCounters::GetCount() < PerfCounters::maxCounters)
+            {
+                PerfCounters::Register("BenchFiller", PerfCounters::Kind::Counter);
+            }
+            start = Clock::now();
+            for (unsigned int f = 0u; f < frames; f++)
+            {
+                PerfCounters::EndFrame();
+            }
+            const auto fullUs = Ms(start) * 1e3 / frames;
+            std::cout << "EndFrame with " << threads + 1u << " thread blocks, mean of " << frames << " frames" << std::endl;
+            std::cout << "  " << std::setw(2) << registered << " counters         " << std::setprecision(2) << registeredUs << " us/frame" << std::endl;
+            std::cout << "  " << std::setw(2) << PerfCounters::maxCounters << " counters         " << fullUs << " us/frame" << std::endl;
+        }
+
+        // 计数、累计和量表
+        const auto totalBefore = PerfCounters::GetTotal(id);
+        PerfCounters::Add(id, 7);
+        PerfCounters::Add(id, -2);
+        PerfCounters::Set(gauge, 1.5);
+        PerfCounters::Set(gauge, 2.5);
+        PerfCounters::EndFrame();
+        ok &= Expect("signed adds", PerfCounters::GetFrameValue(id), 5.0);
+        ok &= Expect("running total", PerfCounters::GetTotal(id) - totalBefore, 5.0);
+        ok &= Expect("gauge", PerfCounters::GetFrameValue(gauge), 2.5);
+        PerfCounters::EndFrame();
+        ok &= Expect("empty frame", PerfCounters::GetFrameValue(id), 0.0);
+        ok &= Expect("gauge keeps its value", PerfCounters::GetFrameValue(gauge), 2.5);
+
+        std::cout << (ok ? "OK" : "FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,346 @@
+// CpuSampler 的无头基准和正确性检查：
+// 1. 非 64 整数倍大小的图（UNORM 和 sRGB）转成 TiledImage 再转回来，逐字节相同；
+//    随机 UV 上双线性（每一层）和三线性的结果在两种布局上完全一致，并和逐点的 double 参考实现比较；
+// 2. 大图（默认 4096x4096 带完整 mip 链）上用几种访问模式采样，比较 Morton 分块和行优先布局的 采样/µs：
+//    rows 沿纹理的行走，columns 沿列走（纹理转 90°），rotated 转 30°，random 完全随机，
+//    trilinear 是 rotated 的走法加上 lod 1.5。
+// usage: SamplerBench [--size N] [--screen N] [--iterations N]
+#include "CpuSampler.h"
+#include "MipChain.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    Image MakeNoise(std::uint32_t width, std::uint32_t height, ImageFormat format, std::uint32_t seed)
+    {
+        Image image(width, height, format);
+        std::mt19937 rng(seed);
+        auto p = image.GetMipData(0u);
+        for (std::size_t i = 0u; i < image.GetMip(0u).size; i++)
+        {
+            p[i] = std::byte(rng() >> 24);
+        }
+        MipChain::Generate(image, MipFilter::Box);
+        return image;
+    }
+
+    // 逐点的参考实现，按 D3D 的规则直接在行优先的数据上算
+    SampledColor ReferenceBilinear(const Image& image, std::uint32_t level, float u, float v, AddressMode mode)
+    {
+        const auto& mip = image.GetMip(level);
+        const auto srgb = Image::IsSrgb(image.GetFormat());
+        const auto axis = [mode](double c, std::uint32_t size, long& i0, long& i1, double& frac) {
+            if (mode == AddressMode::Wrap)
+            {
+                c -= std::floor(c);
+            }
+            else
+            {
+                c = std::clamp(c, 0.0, 1.0);
+            }
+            const auto p = c * size - 0.5;
+            const auto f = std::floor(p);
+            frac = p - f;
+            i0 = long(f);
+            i1 = i0 + 1;
+            if (mode == AddressMode::Wrap)
+            {
+                i0 = (i0 + long(size)) % long(size);
+                i1 = i1 % long(size);
+            }
+            else
+            {
+                i0 = std::clamp(i0, 0l, long(size) - 1);
+                i1 = std::clamp(i1, 0l, long(size) - 1);
+            }
+        };
+        long x0, x1, y0, y1;
+        double fx, fy;
+        axis(u, mip.width, x0, x1, fx);
+        axis(v, mip.height, y0, y1, fy);
+        const auto channel = [&](long x, long y, int c) {
+            const auto b = std::uint8_t(image.GetMipData(level)[std::size_t(y) * mip.rowPitch + std::size_t(x) * 4u + c]);
+            return srgb && c < 3 ? double(MipChain::SrgbToLinear(b)) : b / 255.0;
+        };
+        float out[4];
+        for (int c = 0; c < 4; c++)
+        {
+            const auto top = channel(x0, y0, c) * (1.0 - fx) + channel(x1, y0, c) * fx;
+            const auto bottom = channel(x0, y1, c) * (1.0 - fx) + channel(x1, y1, c) * fx;
+            out[c] = float(top * (1.0 - fy) + bottom * fy);
+        }
+        return { out[0], out[1], out[2], out[3] };
+    }
+
+    float MaxError(const SampledColor& a, const SampledColor& b)
+    {
+        return std::max({ std::abs(a.r - b.r), std::abs(a.g - b.g), std::abs(a.b - b.b), std::abs(a.a - b.a) });
+    }
+
+    // 返回发现的问题数
+    int CheckImage(std::uint32_t width, std::uint32_t height, ImageFormat format)
+    {
+        const auto source = MakeNoise(width, height, format, width * 31u + height);
+        const TiledImage tiled(source);
+        const LinearImage linear(source);
+        const auto name = std::to_string(width) + "x" + std::to_string(height) + (Image::IsSrgb(format) ? " srgb" : " unorm");
+        int failures = 0;
+
+        const auto back = tiled.ToImage();
+        for (std::uint32_t i = 0u; i < source.GetMipCount(); i++)
+        {
+            if (std::memcmp(back.GetMipData(i), source.GetMipData(i), source.GetMip(i).size) != 0)
+            {
+                std::cout << "  " << name << ": level " << i << " does not survive the tiled round trip" << std::endl;
+                failures++;
+            }
+        }
+
+        const std::size_t count = 20001u;
+        std::mt19937 rng(7u);
+        std::uniform_real_distribution<float> coord(-3.0f, 3.0f);
+        std::uniform_real_distribution<float> lodDist(-1.0f, float(source.GetMipCount()));
+        std::vector<float> u(count), v(count), lod(count);
+        for (std::size_t i = 0u; i < count; i++)
+        {
+            u[i] = coord(rng);
+            v[i] = coord(rng);
+            lod[i] = lodDist(rng);
+        }
+        // 正好落在像素中心和边上的点
+        u[0] = 0.0f; v[0] = 0.0f;
+        u[1] = 1.0f; v[1] = 1.0f;
+        u[2] = 0.5f / width; v[2] = 0.5f / height;
+        u[3] = -1e-9f; v[3] = 1.0f - 1e-7f;
+
+        std::vector<SampledColor> a(count), b(count);
+        float worst = 0.0f;
+        for (const auto mode : { AddressMode::Wrap, AddressMode::Clamp })
+        {
+            const auto modeName = mode == AddressMode::Wrap ? "wrap" : "clamp";
+            for (std::uint32_t level = 0u; level < source.GetMipCount(); level++)
+            {
+                CpuSampler::Bilinear(tiled, level, u.data(), v.data(), count, mode, a.data());
+                CpuSampler::Bilinear(linear, level, u.data(), v.data(), count, mode, b.data());
+                if (std::memcmp(a.data(), b.data(), count * sizeof(SampledColor)) != 0)
+                {
+                    std::cout << "  " << name << ": bilinear " << modeName << " level " << level << " differs between layouts" << std::endl;
+                    failures++;
+                }
+                for (std::size_t i = 0u; i < count; i += 7u)
+                {
+                    worst = std::max(worst, MaxError(b[i], ReferenceBilinear(source, level, u[i], v[i], mode)));
+                }
+                // 单点接口走同一条路
+                const auto single = CpuSampler::Bilinear(tiled, level, u[5], v[5], mode);
+                if (std::memcmp(&single, &a[5], sizeof(single)) != 0)
+                {
+                    std::cout << "  " << name << ": single-sample bilinear differs from the batch" << std::endl;
+                    failures++;
+                }
+            }
+            CpuSampler::Trilinear(tiled, u.data(), v.data(), lod.data(), count, mode, a.data());
+            CpuSampler::Trilinear(linear, u.data(), v.data(), lod.data(), count, mode, b.data());
+            if (std::memcmp(a.data(), b.data(), count * sizeof(SampledColor)) != 0)
+            {
+                std::cout << "  " << name << ": trilinear " << modeName << " differs between layouts" << std::endl;
+                failures++;
+            }
+            const auto last = float(source.GetMipCount() - 1u);
+            for (std::size_t i = 0u; i < count; i += 7u)
+            {
+                const auto l = std::clamp(lod[i], 0.0f, last);
+                const auto l0 = std::uint32_t(l);
+                const auto t = l - float(l0);
+                const auto c0 = ReferenceBilinear(source, l0, u[i], v[i], mode);
+                const auto c1 = ReferenceBilinear(source, std::min(l0 + 1u, std::uint32_t(last)), u[i], v[i], mode);
+                const SampledColor ref = { c0.r + (c1.r - c0.r) * t, c0.g + (c1.g - c0.g) * t, c0.b + (c1.b - c0.b) * t, c0.a + (c1.a - c0.a) * t };
+                worst = std::max(worst, MaxError(b[i], ref));
+            }
+        }
+        std::cout << "  " << std::left << std::setw(18) << name << std::right << " max error vs reference " << std::scientific << std::setprecision(2) << worst << std::defaultfloat << std::endl;
+        if (worst > 1e-4f)
+        {
+            std::cout << "  " << name << ": error against the reference is too large" << std::endl;
+            failures++;
+        }
+        return failures;
+    }
+
+    struct Pattern
+    {
+        std::string name;
+        std::vector<float> u;
+        std::vector<float> v;
+        std::vector<float> lod;
+    };
+
+    // screen x screen 个采样点，按屏幕行扫描；(u,v) = 中心 + R(angle) * (屏幕坐标 - 中心) * scale
+    Pattern MakeWalk(const std::string& name, std::uint32_t screen, float angle, float lod)
+    {
+        Pattern p{ name, {}, {}, {} };
+        const auto n = std::size_t(screen) * screen;
+        p.u.resize(n);
+        p.v.resize(n);
+        p.lod.assign(n, lod);
+        const auto c = std::cos(angle) / screen;
+        const auto s = std::sin(angle) / screen;
+        for (std::uint32_t y = 0u; y < screen; y++)
+        {
+            for (std::uint32_t x = 0u; x < screen; x++)
+            {
+                const auto dx = float(x) - 0.5f * screen;
+                const auto dy = float(y) - 0.5f * screen;
+                p.u[std::size_t(y) * screen + x] = 0.5f + c * dx - s * dy;
+                p.v[std::size_t(y) * screen + x] = 0.5f + s * dx + c * dy;
+            }
+        }
+        return p;
+    }
+
+    Pattern MakeRandom(std::uint32_t screen)
+    {
+        Pattern p{ "random", {}, {}, {} };
+        const auto n = std::size_t(screen) * screen;
+        std::mt19937 rng(99u);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        p.u.resize(n);
+        p.v.resize(n);
+        p.lod.assign(n, 0.0f);
+        for (std::size_t i = 0u; i < n; i++)
+        {
+            p.u[i] = dist(rng);
+            p.v[i] = dist(rng);
+        }
+        return p;
+    }
+
+    template<class Texture>
+    double Measure(const Texture& texture, const Pattern& p, bool trilinear, unsigned int iterations, double& checksum)
+    {
+        // 一批 4096 个点，输出缓冲一直在缓存里
+        constexpr std::size_t batch = 4096u;
+        std::vector<SampledColor> out(batch);
+        double best = 1e30;
+        for (unsigned int it = 0u; it < iterations; it++)
+        {
+            const auto start = Clock::now();
+            for (std::size_t i = 0u; i < p.u.size(); i += batch)
+            {
+                const auto n = std::min(batch, p.u.size() - i);
+                if (trilinear)
+                {
+                    CpuSampler::Trilinear(texture, p.u.data() + i, p.v.data() + i, p.lod.data() + i, n, AddressMode::Wrap, out.data());
+                }
+                else
+                {
+                    CpuSampler::Bilinear(texture, 0u, p.u.data() + i, p.v.data() + i, n, AddressMode::Wrap, out.data());
+                }
+                checksum += out[n - 1u].r;
+            }
+            best = std::min(best, MillisecondsSince(start));
+        }
+        return double(p.u.size()) / (best * 1000.0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::uint32_t size = 4096u;
+    std::uint32_t screen = 2048u;
+    unsigned int iterations = 3u;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "usage: SamplerBench [--size N] [--screen N] [--iterations N]" << std::endl;
+            return 1;
+        }
+        const auto value = unsigned(std::stoul(argv[++i]));
+        if (arg == "--size") size = value;
+        else if (arg == "--screen") screen = value;
+        else if (arg == "--iterations") iterations = value;
+        else
+        {
+            std::cerr << "unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (size == 0u || screen == 0u || iterations == 0u)
+    {
+        std::cerr << "bad options" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::cout << "correctness" << std::endl;
+        int failures = 0;
+        failures += CheckImage(1000u, 600u, ImageFormat::RGBA8);
+        failures += CheckImage(1000u, 600u, ImageFormat::RGBA8Srgb);
+        failures += CheckImage(64u, 1u, ImageFormat::RGBA8);
+        failures += CheckImage(3u, 130u, ImageFormat::RGBA8Srgb);
+
+        const auto start = Clock::now();
+        const auto source = MakeNoise(size, size, ImageFormat::RGBA8, 1u);
+        const auto generateMs = MillisecondsSince(start);
+        const auto tileStart = Clock::now();
+        const TiledImage tiled(source);
+        const auto tileMs = MillisecondsSince(tileStart);
+        const LinearImage linear(source);
+        std::cout << std::fixed << std::setprecision(1)
+            << size << "x" << size << " RGBA8 with " << source.GetMipCount() << " levels ("
+            << double(source.GetDataSize()) / (1024.0 * 1024.0) << " MB): mips " << generateMs << " ms, tiling " << tileMs << " ms" << std::endl;
+        std::cout << screen << "x" << screen << " samples per pass, best of " << iterations << ", samples/us" << std::endl;
+
+        const auto pi = 3.14159265f;
+        const std::vector<Pattern> patterns = {
+            MakeWalk("rows", screen, 0.0f, 0.0f),
+            MakeWalk("columns", screen, 0.5f * pi, 0.0f),
+            MakeWalk("rotated", screen, pi / 6.0f, 0.0f),
+            MakeRandom(screen),
+            MakeWalk("trilinear", screen, pi / 6.0f, 1.5f),
+        };
+        std::cout << "  pattern      linear     tiled   speedup" << std::endl;
+        double checksum = 0.0;
+        for (const auto& p : patterns)
+        {
+            const auto trilinear = p.name == "trilinear";
+            const auto l = Measure(linear, p, trilinear, iterations, checksum);
+            const auto t = Measure(tiled, p, trilinear, iterations, checksum);
+            std::cout << "  " << std::left << std::setw(10) << p.name << std::right << std::setprecision(1)
+                << std::setw(9) << l << std::setw(10) << t << std::setprecision(2) << std::setw(9) << t / l << "x" << std::endl;
+        }
+        std::cout << "(checksum " << std::setprecision(1) << checksum << ")" << std::endl;
+
+        if (failures != 0)
+        {
+            std::cout << failures << " problem(s) found" << std::endl;
+            return 1;
+        }
+        std::cout << "all checks passed" << std::endl;
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,398 @@
+// 场景快照（SceneSnapshot）的无头基准：
+// 1. 按 App 不带 --load-scene 时的做法生成 --boxes 个箱子（CreateMany，mt19937 随机运动参数，算出世界矩阵），计时；
+// 2. SceneSnapshot::Save 写到临时目录，报告时间和文件大小；
+// 3. 和 App 的 --load-scene 一样映射文件再 SceneSnapshot::Load 进一个新的 World，跑 --repeats 次取最快的：
+//    一次文件在页缓存里，一次每次加载前先把文件从页缓存里丢掉（只在 Linux 上能做，posix_fadvise）；
+//    再单独测 Load 本身（整个文件已经读进内存，只有解析和按 chunk 的批量实例化），
+//    对照：把同样的组件数组逐个 World::Create（数据已经在内存里，不算读文件）；
+// 4. 检查：加载出来的实体和保存的逐个相同，损坏的文件（截断、改了版本号）只会抛 SceneSnapshot::Exception。
+// usage: SnapshotBench [--boxes N] [--repeats N] [--keep]
+#include "Ecs.h"
+#include "SceneComponents.h"
+#include "SceneSnapshot.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include "MappedFile.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double MillisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+#ifdef _WIN32
+    using FileView = MappedFile;
+
+    bool DropFromPageCache(const std::string&)
+    {
+        return false;
+    }
+#else
+    // 只读映射整个文件，和引擎的 MappedFile 接口一样
+    class FileView
+    {
+    public:
+        explicit FileView(const std::string& path)
+        {
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("cannot open " + path);
+            }
+            struct stat st = {};
+            fstat(fd, &st);
+            size = std::size_t(st.st_size);
+            if (size > 0u)
+            {
+                const auto p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED)
+                {
+                    close(fd);
+                    throw std::runtime_error("cannot map " + path);
+                }
+                pData = static_cast<const std::byte*>(p);
+            }
+            close(fd);
+        }
+        FileView(const FileView&) = delete;
+        FileView& operator=(const FileView&) = delete;
+        ~FileView()
+        {
+            if (pData != nullptr)
+            {
+                munmap(const_cast<std::byte*>(pData), size);
+            }
+        }
+        const std::byte* GetData() const noexcept
+        {
+            return pData;
+        }
+        std::size_t GetSize() const noexcept
+        {
+            return size;
+        }
+    private:
+        const std::byte* pData = nullptr;
+        std::size_t size = 0u;
+    };
+
+    // 下一次读要从磁盘来；文件已经写回磁盘的页才能丢掉，先 fsync
+    bool DropFromPageCache(const std::string& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        const bool dropped = fsync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        close(fd);
+        return dropped;
+    }
+#endif
+
+    // BoxMotion::GetTransformXM 的标量版本（SceneSystems.cpp 要 DirectXMath）：
+    // RotationRollPitchYaw(pitch, yaw, roll) * Translation(r, 0, 0) * RotationRollPitchYaw(theta, phi, chi) * Translation(0, 0, 20)
+    void RotationRollPitchYaw(float pitch, float yaw, float roll, float out[3][3]) noexcept
+    {
+        const float cp = std::cos(pitch), sp = std::sin(pitch);
+        const float cy = std::cos(yaw), sy = std::sin(yaw);
+        const float cr = std::cos(roll), sr = std::sin(roll);
+        out[0][0] = cr * cy + sr * sp * sy;
+        out[0][1] = sr * cp;
+        out[0][2] = sr * sp * cy - cr * sy;
+        out[1][0] = cr * sp * sy - sr * cy;
+        out[1][1] = cr * cp;
+        out[1][2] = sr * sy + cr * sp * cy;
+        out[2][0] = cp * sy;
+        out[2][1] = -sp;
+        out[2][2] = cp * cy;
+    }
+
+    void ComputeTransform(const BoxMotion& motion, WorldTransform& transform) noexcept
+    {
+        float local[3][3];
+        float world[3][3];
+        RotationRollPitchYaw(motion.pitch, motion.yaw, motion.roll, local);
+        RotationRollPitchYaw(motion.theta, motion.phi, motion.chi, world);
+        auto& m = transform.matrix.m;
+        for (int row = 0; row < 3; row++)
+        {
+            for (int col = 0; col < 3; col++)
+            {
+                m[row][col] = local[row][0] * world[0][col] + local[row][1] * world[1][col] + local[row][2] * world[2][col];
+            }
+            m[row][3] = 0.0f;
+        }
+        for (int col = 0; col < 3; col++)
+        {
+            m[3][col] = motion.r * world[0][col];
+        }
+        m[3][2] += 20.0f;
+        m[3][3] = 1.0f;
+    }
+
+    // App 的构造函数里生成箱子的做法（BoxMotion::Random 和同样的分布）
+    void GenerateBoxes(World& world, std::size_t count)
+    {
+        std::mt19937 rng(1234u);
+        std::uniform_real_distribution<float> adist(0.0f, 3.1415f * 2.0f);
+        std::uniform_real_distribution<float> ddist(0.0f, 3.1415f * 2.0f);
+        std::uniform_real_distribution<float> odist(0.0f, 3.1415f * 0.3f);
+        std::uniform_real_distribution<float> rdist(6.0f, 20.0f);
+        world.CreateMany<BoxMotion, WorldTransform, BoxInstance>(count,
+            [&](std::size_t, BoxMotion& m, WorldTransform& transform, BoxInstance& instance) {
+                m = {};
+                m.r = rdist(rng);
+                m.droll = ddist(rng);
+                m.dpitch = ddist(rng);
+                m.dyaw = ddist(rng);
+                m.dphi = odist(rng);
+                m.dtheta = odist(rng);
+                m.dchi = odist(rng);
+                m.chi = adist(rng);
+                m.theta = adist(rng);
+                m.phi = adist(rng);
+                ComputeTransform(m, transform);
+                instance = {};
+            });
+    }
+
+    struct Boxes
+    {
+        std::vector<BoxMotion> motions;
+        std::vector<WorldTransform> transforms;
+    };
+
+    Boxes Collect(World& world)
+    {
+        Boxes boxes;
+        world.ForEach<const BoxMotion, const WorldTransform, const BoxInstance>(
+            [&boxes](const BoxMotion& m, const WorldTransform& t, const BoxInstance&) {
+                boxes.motions.push_back(m);
+                boxes.transforms.push_back(t);
+            });
+        return boxes;
+    }
+
+    bool SameBoxes(const Boxes& a, const Boxes& b)
+    {
+        return a.motions.size() == b.motions.size() && a.transforms.size() == b.transforms.size() &&
+            std::memcmp(a.motions.data(), b.motions.data(), a.motions.size() * sizeof(BoxMotion)) == 0 &&
+            std::memcmp(a.transforms.data(), b.transforms.data(), a.transforms.size() * sizeof(WorldTransform)) == 0;
+    }
+
+    // 和 App 的 --load-scene 一样：映射文件，解析进 world
+    std::size_t LoadSnapshot(const std::string& path, World& world)
+    {
+        const FileView file(path);
+        return SceneSnapshot::Load(file.GetData(), file.GetSize(), path, world);
+    }
+
+    // 损坏的文件只能抛 SceneSnapshot::Exception，不能读越界
+    bool RejectsCorruptFiles(const std::string& path, const std::filesystem::path& dir)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes(std::istreambuf_iterator<char>(in), {});
+        const auto corruptPath = (dir / "corrupt.scene").string();
+        const auto rejects = [&corruptPath](const std::vector<char>& data) {
+            {
+                std::ofstream out(corruptPath, std::ios::binary | std::ios::trunc);
+                out.write(data.data(), std::streamsize(data.size()));
+            }
+            World world;
+            try
+            {
+                LoadSnapshot(corruptPath, world);
+            }
+            catch (const SceneSnapshot::Exception&)
+            {
+                return world.GetEntityCount() == 0u;
+            }
+            return false;
+        };
+        bool ok = true;
+        for (const auto size : { std::size_t(0u), std::size_t(16u), bytes.size() / 2u, bytes.size() - 1u })
+        {
+            ok &= rejects(std::vector<char>(bytes.begin(), bytes.begin() + std::ptrdiff_t(size)));
+        }
+        // version 在 8 字节的 magic 之后
+        auto badVersion = bytes;
+        badVersion[8] ^= 0x7F;
+        ok &= rejects(badVersion);
+        std::filesystem::remove(corruptPath);
+        return ok;
+    }
+
+    std::string Rate(double ms, std::size_t bytes)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << ms << " ms (" << std::setprecision(2) << double(bytes) / (ms * 1e6) << " GB/s)";
+        return out.str();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t boxCount = 1000000u;
+    unsigned int repeats = 5u;
+    bool keep = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--boxes" && i + 1 < argc)
+        {
+            boxCount = std::size_t(std::stoull(argv[++i]));
+        }
+        else if (arg == "--repeats" && i + 1 < argc)
+        {
+            repeats = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--keep")
+        {
+            keep = true;
+        }
+        else
+        {
+            std::cerr << "usage: SnapshotBench [--boxes N] [--repeats N] [--keep]" << std::endl;
+            return 1;
+        }
+    }
+    if (boxCount == 0u || repeats == 0u)
+    {
+        std::cerr << "need at least one box and one repeat" << std::endl;
+        return 1;
+    }
+
+    const auto dir = std::filesystem::temp_directory_path() / "SnapshotBench";
+    try
+    {
+        std::filesystem::create_directories(dir);
+        const auto path = (dir / "boxes.scene").string();
+        bool ok = true;
+
+        Boxes saved;
+        double generateMs;
+        double saveMs;
+        {
+            World world;
+            auto start = Clock::now();
+            GenerateBoxes(world, boxCount);
+            generateMs = MillisecondsSince(start);
+            start = Clock::now();
+            SceneSnapshot::Save(path, world);
+            saveMs = MillisecondsSince(start);
+            saved = Collect(world);
+        }
+        const auto fileBytes = std::size_t(std::filesystem::file_size(path));
+
+        double warmMs = 1e30;
+        double coldMs = 1e30;
+        bool dropped = true;
+        for (unsigned int r = 0u; r < repeats; r++)
+        {
+            for (const bool cold : { false, true })
+            {
+                if (cold && !(dropped = dropped && DropFromPageCache(path)))
+                {
+                    continue;
+                }
+                World world;
+                const auto start = Clock::now();
+                const auto count = LoadSnapshot(path, world);
+                const auto ms = MillisecondsSince(start);
+                (cold ? coldMs : warmMs) = std::min(cold ? coldMs : warmMs, ms);
+                if (r == 0u && !cold && (count != boxCount || !SameBoxes(Collect(world), saved)))
+                {
+                    std::cout << "FAIL: loaded " << count << " boxes that differ from the saved ones" << std::endl;
+                    ok = false;
+                }
+            }
+        }
+
+        // 不算映射和读文件：整个文件已经读进内存，只测解析和批量实例化
+        double parseMs = 1e30;
+        {
+            std::ifstream in(path, std::ios::binary);
+            std::vector<char> bytes(std::istreambuf_iterator<char>(in), {});
+            for (unsigned int r = 0u; r < repeats; r++)
+            {
+                World world;
+                const auto start = Clock::now();
+                SceneSnapshot::Load(reinterpret_cast<const std::byte*>(bytes.data()), bytes.size(), path, world);
+                parseMs = std::min(parseMs, MillisecondsSince(start));
+            }
+        }
+
+        // 对照：同样的数据已经在内存里，逐个 Create
+        double createMs = 1e30;
+        for (unsigned int r = 0u; r < repeats; r++)
+        {
+            World world;
+            const auto start = Clock::now();
+            for (std::size_t i = 0u; i < saved.motions.size(); i++)
+            {
+                world.Create(saved.motions[i], saved.transforms[i], BoxInstance{});
+            }
+            createMs = std::min(createMs, MillisecondsSince(start));
+        }
+
+        std::cout << boxCount << " boxes, snapshot " << std::fixed << std::setprecision(1) << double(fileBytes) / (1024.0 * 1024.0)
+                  << " MB (" << sizeof(BoxMotion) + sizeof(WorldTransform) << " B per box)" << std::endl;
+        std::cout << "  generate like App (CreateMany + mt19937)   " << generateMs << " ms" << std::endl;
+        std::cout << "  SceneSnapshot::Save                        " << Rate(saveMs, fileBytes) << std::endl;
+        std::cout << "  map + Load, page cache warm                " << Rate(warmMs, fileBytes) << ", best of " << repeats << std::endl;
+        if (dropped)
+        {
+            std::cout << "  map + Load, page cache dropped             " << Rate(coldMs, fileBytes) << ", best of " << repeats << std::endl;
+        }
+        else
+        {
+            std::cout << "  (cannot drop the file from the page cache here)" << std::endl;
+        }
+        std::cout << "  Load only, file already in memory          " << Rate(parseMs, fileBytes) << ", best of " << repeats << std::endl;
+        std::cout << "  World::Create per box, data in memory      " << Rate(createMs, fileBytes) << ", best of " << repeats << std::endl;
+
+        if (!RejectsCorruptFiles(path, dir))
+        {
+            std::cout << "FAIL: a corrupt snapshot was loaded or threw something else" << std::endl;
+            ok = false;
+        }
+        if (!keep)
+        {
+            std::filesystem::remove_all(dir);
+        }
+        std::cout << (ok ? "OK" : "FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        if (!keep)
+        {
+            std::filesystem::remove_all(dir);
+        }
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
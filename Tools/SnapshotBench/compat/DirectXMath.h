@@ -0,0 +1,11 @@
+#pragma once
+// 非 Windows 上编译 SnapshotBench 用：只有 SceneComponents.h 需要的两个名字。
+// 布局和 Windows SDK 里的 XMFLOAT4X4 一样（16 个 float），快照文件两边通用；XMMATRIX 只出现在声明里
+namespace DirectX
+{
+    struct XMFLOAT4X4
+    {
+        float m[4][4];
+    };
+    struct XMMATRIX;
+}
@@ -0,0 +1,287 @@
+// 纹理流送的无头模拟：在临时目录里生成一组带完整 mip 链的 BC1 DDS，让每张纹理贴在一个来回远近移动、
+// 时而转出视野的物体上，用 SimulatedStreamingDevice 跑 TextureStreamer。
+// 每帧检查：常驻字节不超过预算、流送器和设备的账一致；设备本身检查每次只加一层，新层的内容也和文件里那一层对得上。
+// 对几档预算各跑一遍，打印 预算 -> 画质（平均差几层、多少比例的可见纹理到了目标）的表，最后一档再把预算砍半检查强制淘汰。
+// 第 0 号物体停在两层的分界附近抖动，用来检查迟滞：它的目标层不应该来回跳。
+// usage: StreamingSim [--textures N] [--frames N] [--frame-ms N] [--sync] [--keep]
+#include "ImageCodecs.h"
+#include "MemoryTracker.h"
+#include "TextureStreamer.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::uint8_t Pattern(StreamedTextureId id, std::uint32_t level)
+    {
+        return std::uint8_t(id * 16u + level * 3u + 1u);
+    }
+
+    // 在模拟设备的基础上检查新层的内容：每层都用 Pattern 填满，读错偏移就对不上
+    class CheckingDevice : public SimulatedStreamingDevice
+    {
+    public:
+        void SetResidency(StreamedTextureId id, std::uint32_t mostDetailedMip, const Image* pNewLevels) override
+        {
+            SimulatedStreamingDevice::SetResidency(id, mostDetailedMip, pNewLevels);
+            if (pNewLevels == nullptr)
+            {
+                return;
+            }
+            for (std::uint32_t i = 0u; i < pNewLevels->GetMipCount(); i++)
+            {
+                const auto p = reinterpret_cast<const std::uint8_t*>(pNewLevels->GetMipData(i));
+                const auto size = pNewLevels->GetMip(i).size;
+                const auto expected = Pattern(id, mostDetailedMip + i);
+                if (p[0] != expected || p[size / 2u] != expected || p[size - 1u] != expected)
+                {
+                    throw std::runtime_error("texture " + std::to_string(id) + " mip " +
+                        std::to_string(mostDetailedMip + i) + " has the wrong contents");
+                }
+            }
+        }
+    };
+
+    struct Object
+    {
+        double distance;
+        double amplitude;
+        double speed;
+        double phase;
+        // 0 表示一直可见
+        double turnSpeed;
+    };
+
+    struct RunResult
+    {
+        double meanDeficit;
+        double atTargetFraction;
+        std::size_t peakResident;
+        std::size_t streamedBytes;
+        unsigned long long residencyChanges;
+        unsigned int hoverTargetChanges;
+    };
+
+    // 屏幕高 600 像素、竖直视角 90 度时，1 个单位大小的物体在距离 d 处大约占 300 / d 像素；物体边长 4 个单位
+    float ScreenSize(double distance)
+    {
+        return float(1200.0 / distance);
+    }
+
+    RunResult Run(const std::vector<std::string>& paths, const std::vector<Object>& objects, std::size_t budget,
+        unsigned int frames, unsigned int frameMs, bool sync, bool shrink)
+    {
+        CheckingDevice device;
+        TextureStreamer streamer(device, budget);
+        std::vector<StreamedTextureId> ids;
+        for (const auto& path : paths)
+        {
+            ids.push_back(streamer.Register(path, false));
+        }
+        RunResult r = {};
+        double deficit = 0.0;
+        unsigned long long visibleFrames = 0u;
+        unsigned long long atTarget = 0u;
+        auto hoverTarget = streamer.GetTargetMip(ids[0]);
+        for (unsigned int f = 0u; f < frames; f++)
+        {
+            if (shrink && f == frames / 2u)
+            {
+                budget /= 2u;
+                streamer.SetBudget(budget);
+            }
+            const double t = f / 60.0;
+            for (std::size_t i = 0u; i < objects.size(); i++)
+            {
+                const auto& o = objects[i];
+                if (o.turnSpeed != 0.0 && std::cos(t * o.turnSpeed + o.phase) < -0.3)
+                {
+                    continue;
+                }
+                streamer.ReportUsage(ids[i], ScreenSize(o.distance * std::exp(o.amplitude * std::sin(t * o.speed + o.phase))));
+            }
+            if (sync)
+            {
+                streamer.WaitForLoads();
+            }
+            streamer.Update();
+
+            const auto resident = streamer.GetResidentBytes();
+            if (resident > budget)
+            {
+                throw std::runtime_error("frame " + std::to_string(f) + ": " + std::to_string(resident) +
+                    " bytes resident, budget " + std::to_string(budget));
+            }
+            if (resident != device.GetResidentBytes())
+            {
+                throw std::runtime_error("frame " + std::to_string(f) + ": streamer and device disagree on resident bytes");
+            }
+            r.peakResident = std::max(r.peakResident, resident);
+            for (std::size_t i = 0u; i < objects.size(); i++)
+            {
+                const auto& o = objects[i];
+                if (o.turnSpeed != 0.0 && std::cos(t * o.turnSpeed + o.phase) < -0.3)
+                {
+                    continue;
+                }
+                const auto residentMip = streamer.GetResidentMip(ids[i]);
+                const auto targetMip = streamer.GetTargetMip(ids[i]);
+                visibleFrames++;
+                atTarget += residentMip <= targetMip ? 1u : 0u;
+                deficit += residentMip > targetMip ? residentMip - targetMip : 0u;
+            }
+            // 第一帧从尾部定到初始目标不算
+            if (f != 0u && streamer.GetTargetMip(ids[0]) != hoverTarget)
+            {
+                r.hoverTargetChanges++;
+            }
+            hoverTarget = streamer.GetTargetMip(ids[0]);
+            MemoryTracker::EndFrame();
+            if (frameMs != 0u)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(frameMs));
+            }
+        }
+        streamer.WaitForLoads();
+        std::cout << streamer.GetReport();
+        r.meanDeficit = visibleFrames != 0u ? deficit / double(visibleFrames) : 0.0;
+        r.atTargetFraction = visibleFrames != 0u ? double(atTarget) / double(visibleFrames) : 1.0;
+        r.streamedBytes = device.GetUploadedBytes();
+        r.residencyChanges = device.GetResidencyChanges();
+        return r;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int textureCount = 24u;
+    unsigned int frames = 1200u;
+    unsigned int frameMs = 2u;
+    bool sync = false;
+    bool keep = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--textures" && i + 1 < argc)
+        {
+            textureCount = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            frames = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--frame-ms" && i + 1 < argc)
+        {
+            frameMs = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--sync")
+        {
+            sync = true;
+        }
+        else if (arg == "--keep")
+        {
+            keep = true;
+        }
+        else
+        {
+            std::cerr << "usage: StreamingSim [--textures N] [--frames N] [--frame-ms N] [--sync] [--keep]" << std::endl;
+            return 1;
+        }
+    }
+    if (textureCount == 0u || frames == 0u)
+    {
+        std::cerr << "need at least one texture and one frame" << std::endl;
+        return 1;
+    }
+
+    const auto dir = std::filesystem::temp_directory_path() / "StreamingSim";
+    try
+    {
+        // 2048 / 512 / 1024 轮流，BC1 完整 mip 链
+        std::filesystem::create_directories(dir);
+        std::vector<std::string> paths;
+        std::size_t totalBytes = 0u;
+        for (unsigned int i = 0u; i < textureCount; i++)
+        {
+            const std::uint32_t size = 512u << ((i + 2u) % 3u);
+            Image image(size, size, ImageFormat::BC1, 0u);
+            for (std::uint32_t level = 0u; level < image.GetMipCount(); level++)
+            {
+                std::memset(image.GetMipData(level), Pattern(i, level), image.GetMip(level).size);
+                totalBytes += image.GetMip(level).size;
+            }
+            const auto bytes = ImageCodecs::EncodeDds(image);
+            paths.push_back((dir / ("texture" + std::to_string(i) + ".dds")).string());
+            std::ofstream file(paths.back(), std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+            if (!file)
+            {
+                std::cerr << "cannot write " << paths.back() << std::endl;
+                return 1;
+            }
+        }
+
+        // 第 0 号停在 1024 像素附近（2048 的纹理在第 0 / 1 层之间）抖动半层以内；其余的远近往返，一部分会转出视野
+        std::vector<Object> objects;
+        objects.push_back({ 1200.0 / 1024.0, 0.15, 3.0, 0.0, 0.0 });
+        for (unsigned int i = 1u; i < textureCount; i++)
+        {
+            objects.push_back({ 1.5 + 2.0 * (i % 5u), 1.2, 0.3 + 0.07 * (i % 7u), 0.9 * i, (i % 3u) == 0u ? 0.0 : 0.2 + 0.05 * (i % 4u) });
+        }
+
+        std::cout << textureCount << " textures, " << totalBytes / 1024u << " KB with all mips, " << frames << " frames"
+                  << (sync ? " (loads finish within the frame)" : "") << std::endl;
+        const double fractions[] = { 1.0, 0.5, 0.25, 0.125 };
+        std::vector<RunResult> results;
+        for (const auto fraction : fractions)
+        {
+            const auto budget = std::size_t(double(totalBytes) * fraction);
+            std::cout << "--- budget " << budget / 1024u << " KB" << std::endl;
+            results.push_back(Run(paths, objects, budget, frames, frameMs, sync, false));
+        }
+        std::cout << "--- budget " << std::size_t(double(totalBytes) * 0.5) / 1024u << " KB, halved at frame " << frames / 2u << std::endl;
+        const auto shrunk = Run(paths, objects, std::size_t(double(totalBytes) * 0.5), frames, frameMs, sync, true);
+
+        std::cout << std::endl << "budget   peak KB   at target  mean deficit  streamed KB  residency changes  hover target changes" << std::endl;
+        for (std::size_t i = 0u; i < results.size(); i++)
+        {
+            const auto& r = results[i];
+            std::cout << std::fixed << std::setprecision(3) << std::setw(6) << fractions[i] << std::setw(10) << r.peakResident / 1024u
+                      << std::setprecision(1) << std::setw(11) << 100.0 * r.atTargetFraction << "%" << std::setprecision(3)
+                      << std::setw(14) << r.meanDeficit << std::setw(13) << r.streamedBytes / 1024u << std::setw(19) << r.residencyChanges
+                      << std::setw(22) << r.hoverTargetChanges << std::endl;
+        }
+        std::cout << "halved: peak " << shrunk.peakResident / 1024u << " KB, " << std::setprecision(1) << 100.0 * shrunk.atTargetFraction
+                  << "% at target" << std::endl;
+        std::cout << MemoryTracker::GetReport();
+        // 迟滞：抖动不到半层，目标最多在开始时定一次
+        for (const auto& r : results)
+        {
+            if (r.hoverTargetChanges > 1u)
+            {
+                std::cerr << "FAIL: the texture hovering at a mip boundary changed target " << r.hoverTargetChanges << " times" << std::endl;
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "FAIL: " << e.what() << std::endl;
+        return 1;
+    }
+    if (!keep)
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+    std::cout << "OK" << std::endl;
+    return 0;
+}
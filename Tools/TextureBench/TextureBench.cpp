@@ -0,0 +1,1751 @@
+// 图像管线的无头基准和自检：
+// 1. 自己生成 PNG（stored / 固定 Huffman / 动态 Huffman 和混合块的 deflate，多个 IDAT，1~16 位灰度、调色板、tRNS）、
+//    TGA（无压缩和 RLE，两种行序）和 DDS（DX10 头和传统头），解出来的像素必须和生成时的逐字节相同；
+//    Inflate 单独测混合块类型的流和放不下的输出缓冲；
+// 2. mip：已知线性渐变的 Box / Kaiser mip 和按线性空间算出的期望值比较（gamma-correct），误差不超过容差；
+//    黑白棋盘格缩小一级后必须是线性 0.5（sRGB 188）而不是 128，alpha 按线性平均；
+// 3. 截断的文件必须抛 ImageException，几处关键字段改坏也必须被拒绝；随机改坏的字节可以解出图来，但不能抛别的异常；
+// 4. 块压缩：生成的图在每种格式、每个档位下 Encode -> Decode 的 PSNR 不低于各自的下限，慢的档位不比快的差，
+//    线程池和单线程的输出相同；BC 图像 EncodeDds -> DecodeDds 逐字节不变；磁盘缓存的文件就是结果的 DDS，读回来的数据相同；
+// 5. 把文件全部读进内存，再分别用单线程和线程池反复解码 + 生成 mip，按输入文件字节数和输出像素字节数报告 MB/s。
+//    没给文件时测生成的 1024x1024 PNG 和 RLE TGA。
+// 给了 --compress 时再测块压缩：按所有 mip 层的像素数报告 Mpix/s，并把第 0 层解压回来报告 PSNR。
+// usage: TextureBench [image files...] [--filter box|kaiser] [--no-mips] [--linear] [--iterations N] [--threads N]
+//                     [--compress bc1|bc3|bc4|bc5|bc7] [--quality fast|normal|high]
+#include "BlockCompression.h"
+#include "ImageCodecs.h"
+#include "ImageLoader.h"
+#include "MipChain.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Result
+    {
+        double seconds;
+        std::size_t outputBytes;
+    };
+
+    template<typename F>
+    Result Measure(unsigned int iterations, F&& loadAll)
+    {
+        std::size_t outputBytes = 0u;
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0u; i < iterations; i++)
+        {
+            outputBytes += loadAll();
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return { seconds,outputBytes };
+    }
+
+    void Report(const char* label, const Result& r, std::size_t inputBytes, unsigned int iterations)
+    {
+        const double mb = 1024.0 * 1024.0;
+        std::cout << std::left << std::setw(14) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << double(inputBytes) * iterations / mb / r.seconds << " MB/s in"
+                  << std::setw(10) << double(r.outputBytes) / mb / r.seconds << " MB/s out"
+                  << std::setw(10) << r.seconds * 1000.0 / iterations << " ms/pass" << std::endl;
+    }
+
+    bool ParseCompression(const std::string& name, TextureCompression& compression)
+    {
+        const std::pair<const char*, TextureCompression> names[] = {
+            { "bc1",TextureCompression::BC1 },{ "bc3",TextureCompression::BC3 },{ "bc4",TextureCompression::BC4 },
+            { "bc5",TextureCompression::BC5 },{ "bc7",TextureCompression::BC7 },
+        };
+        for (const auto& n : names)
+        {
+            if (name == n.first)
+            {
+                compression = n.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t CountPixels(const Image& image)
+    {
+        std::size_t pixels = 0u;
+        for (std::uint32_t level = 0u; level < image.GetMipCount(); level++)
+        {
+            pixels += std::size_t(image.GetMip(level).width) * image.GetMip(level).height;
+        }
+        return pixels;
+    }
+
+    void BenchCompression(const std::vector<Image>& images, TextureCompression compression, BcQuality quality,
+        unsigned int iterations, ThreadPool& pool)
+    {
+        std::size_t pixels = 0u;
+        for (const auto& image : images)
+        {
+            pixels += CountPixels(image);
+        }
+        const auto single = Measure(iterations, [&]() {
+            for (const auto& image : images)
+            {
+                BlockCompression::Encode(image, compression, quality);
+            }
+            return std::size_t(0u);
+        });
+        // 线程池按块行并行，单张图也能用满所有线程
+        const auto parallel = Measure(iterations, [&]() {
+            for (const auto& image : images)
+            {
+                BlockCompression::Encode(image, compression, quality, &pool);
+            }
+            return std::size_t(0u);
+        });
+        const auto report = [&](const std::string& label, const Result& r) {
+            std::cout << std::left << std::setw(14) << label << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << double(pixels) * iterations / 1e6 / r.seconds << " Mpix/s"
+                      << std::setw(10) << r.seconds * 1000.0 / iterations << " ms/pass" << std::endl;
+        };
+        report("1 thread", single);
+        report(std::to_string(pool.GetWorkerCount() + 1u) + " threads", parallel);
+        for (std::size_t i = 0u; i < images.size(); i++)
+        {
+            const auto decoded = BlockCompression::Decode(BlockCompression::Encode(images[i], compression, quality, &pool));
+            std::cout << "  image " << i << ": " << std::setprecision(2)
+                      << BlockCompression::ComputePsnr(images[i], decoded, BlockCompression::GetChannelCount(compression))
+                      << " dB PSNR" << std::endl;
+        }
+    }
+
+    int Check(bool condition, const std::string& what)
+    {
+        if (!condition)
+        {
+            std::cout << "FAILED: " << what << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    std::uint32_t Noise(std::uint32_t x, std::uint32_t y, std::uint32_t c)
+    {
+        auto h = x * 0x8DA6B343u ^ y * 0xD8163841u ^ c * 0xCB1AB31Fu;
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    }
+
+    // ---------------------------------------------------------------- zlib / deflate 编码
+    // 只为生成测试输入：哈希链找匹配，按块选 stored / 固定 / 动态 Huffman，不追求压缩率
+    enum class Deflate
+    {
+        Stored,
+        Fixed,
+        // 分成两个动态块，后一块的匹配可以指回前一块
+        Dynamic,
+        // stored、固定、动态轮流，测 stored 块前面还剩半个字节的情况
+        Mixed,
+    };
+
+    constexpr std::uint16_t lengthBase[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+    constexpr std::uint8_t lengthExtra[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+    constexpr std::uint16_t distanceBase[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+    constexpr std::uint8_t distanceExtra[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<std::uint8_t>& out)
+            :
+            out(out)
+        {}
+        // 低位先出
+        void Put(std::uint32_t value, int n)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                if (nBits == 0)
+                {
+                    out.push_back(0u);
+                }
+                out.back() |= std::uint8_t(((value >> i) & 1u) << nBits);
+                nBits = (nBits + 1) & 7;
+            }
+        }
+        // Huffman 码字高位先出
+        void PutCode(std::uint32_t code, int length)
+        {
+            for (int i = length - 1; i >= 0; i--)
+            {
+                Put(code >> i, 1);
+            }
+        }
+        void Align()
+        {
+            nBits = 0;
+        }
+    private:
+        std::vector<std::uint8_t>& out;
+        int nBits = 0;
+    };
+
+    struct Token
+    {
+        // 0 = literal
+        std::uint16_t length;
+        std::uint16_t distance;
+        std::uint8_t literal;
+    };
+
+    std::vector<Token> FindMatches(const std::vector<std::uint8_t>& data)
+    {
+        constexpr std::size_t window = 32768u;
+        constexpr int maxChain = 32;
+        std::vector<std::int32_t> head(1u << 15, -1);
+        std::vector<std::int32_t> prev(data.size(), -1);
+        const auto hash = [&data](std::size_t i) {
+            return ((std::uint32_t(data[i]) << 10) ^ (std::uint32_t(data[i + 1u]) << 5) ^ data[i + 2u]) & 0x7FFFu;
+        };
+        std::vector<Token> tokens;
+        for (std::size_t i = 0u; i < data.size();)
+        {
+            std::size_t bestLength = 0u;
+            std::size_t bestDistance = 0u;
+            if (i + 3u <= data.size())
+            {
+                const auto limit = std::min<std::size_t>(258u, data.size() - i);
+                int chain = 0;
+                for (auto j = head[hash(i)]; j >= 0 && i - std::size_t(j) <= window && chain < maxChain; j = prev[std::size_t(j)], chain++)
+                {
+                    // 可以和当前位置重叠（距离小于长度），解码器要逐字节拷
+                    std::size_t length = 0u;
+                    while (length < limit && data[std::size_t(j) + length] == data[i + length])
+                    {
+                        length++;
+                    }
+                    if (length > bestLength)
+                    {
+                        bestLength = length;
+                        bestDistance = i - std::size_t(j);
+                    }
+                }
+            }
+            const auto advance = bestLength >= 3u ? bestLength : 1u;
+            tokens.push_back(bestLength >= 3u ? Token{ std::uint16_t(bestLength),std::uint16_t(bestDistance),0u } : Token{ 0u,0u,data[i] });
+            for (auto k = i; k < i + advance; k++)
+            {
+                if (k + 3u <= data.size())
+                {
+                    const auto h = hash(k);
+                    prev[k] = head[h];
+                    head[h] = std::int32_t(k);
+                }
+            }
+            i += advance;
+        }
+        return tokens;
+    }
+
+    int LengthSymbol(std::uint32_t length)
+    {
+        int i = 28;
+        while (lengthBase[i] > length)
+        {
+            i--;
+        }
+        return i;
+    }
+
+    int DistanceSymbol(std::uint32_t distance)
+    {
+        int i = 29;
+        while (distanceBase[i] > distance)
+        {
+            i--;
+        }
+        return i;
+    }
+
+    // 按频率建 Huffman 树，超过 maxLength 的码长按 zlib 的办法压回来：拿掉一个最长的码，把一个更短的码拆成两个
+    std::vector<std::uint8_t> CodeLengths(const std::vector<std::uint32_t>& freq, int maxLength)
+    {
+        std::vector<std::uint8_t> lengths(freq.size(), 0u);
+        std::vector<int> symbols;
+        for (std::size_t i = 0u; i < freq.size(); i++)
+        {
+            if (freq[i] != 0u)
+            {
+                symbols.push_back(int(i));
+            }
+        }
+        if (symbols.size() < 2u)
+        {
+            // 只有一个码字的树解码器也认，码长 1
+            lengths[symbols.empty() ? 0u : std::size_t(symbols[0])] = 1u;
+            return lengths;
+        }
+        using Node = std::pair<std::uint64_t, int>;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+        std::vector<int> parent(symbols.size() * 2u, -1);
+        for (std::size_t i = 0u; i < symbols.size(); i++)
+        {
+            queue.push({ freq[std::size_t(symbols[i])],int(i) });
+        }
+        int next = int(symbols.size());
+        while (queue.size() > 1u)
+        {
+            const auto a = queue.top();
+            queue.pop();
+            const auto b = queue.top();
+            queue.pop();
+            parent[std::size_t(a.second)] = parent[std::size_t(b.second)] = next;
+            queue.push({ a.first + b.first,next++ });
+        }
+        std::vector<int> count(std::size_t(maxLength) + 1u, 0);
+        for (std::size_t i = 0u; i < symbols.size(); i++)
+        {
+            int depth = 0;
+            for (int n = int(i); parent[std::size_t(n)] >= 0; n = parent[std::size_t(n)])
+            {
+                depth++;
+            }
+            count[std::size_t(std::min(depth, maxLength))]++;
+        }
+        const auto kraft = [&count, maxLength]() {
+            std::uint32_t total = 0u;
+            for (int l = 1; l <= maxLength; l++)
+            {
+                total += std::uint32_t(count[std::size_t(l)]) << (maxLength - l);
+            }
+            return total;
+        };
+        while (kraft() > (1u << maxLength))
+        {
+            count[std::size_t(maxLength)]--;
+            for (int l = maxLength - 1; l > 0; l--)
+            {
+                if (count[std::size_t(l)] != 0)
+                {
+                    count[std::size_t(l)]--;
+                    count[std::size_t(l) + 1u] += 2;
+                    break;
+                }
+            }
+        }
+        // 频率高的拿短码
+        std::stable_sort(symbols.begin(), symbols.end(), [&freq](int a, int b) {
+            return freq[std::size_t(a)] > freq[std::size_t(b)];
+        });
+        std::size_t s = 0u;
+        for (int l = 1; l <= maxLength; l++)
+        {
+            for (int k = 0; k < count[std::size_t(l)]; k++)
+            {
+                lengths[std::size_t(symbols[s++])] = std::uint8_t(l);
+            }
+        }
+        return lengths;
+    }
+
+    std::vector<std::uint16_t> CanonicalCodes(const std::vector<std::uint8_t>& lengths)
+    {
+        int count[16] = {};
+        for (const auto l : lengths)
+        {
+            count[l]++;
+        }
+        count[0] = 0;
+        int nextCode[16] = {};
+        for (int l = 1, code = 0; l < 16; l++)
+        {
+            code = (code + count[l - 1]) << 1;
+            nextCode[l] = code;
+        }
+        std::vector<std::uint16_t> codes(lengths.size(), 0u);
+        for (std::size_t i = 0u; i < lengths.size(); i++)
+        {
+            if (lengths[i] != 0u)
+            {
+                codes[i] = std::uint16_t(nextCode[lengths[i]]++);
+            }
+        }
+        return codes;
+    }
+
+    struct HuffmanCode
+    {
+        std::vector<std::uint8_t> lengths;
+        std::vector<std::uint16_t> codes;
+    };
+
+    HuffmanCode MakeCode(std::vector<std::uint8_t> lengths)
+    {
+        auto codes = CanonicalCodes(lengths);
+        return { std::move(lengths),std::move(codes) };
+    }
+
+    // 码长序列写成 0~15 和 16/17/18 重复符号，附带的额外位放在第二项
+    std::vector<std::pair<int, std::uint32_t>> RunLengthCodeLengths(const std::vector<std::uint8_t>& lengths)
+    {
+        std::vector<std::pair<int, std::uint32_t>> out;
+        for (std::size_t i = 0u; i < lengths.size();)
+        {
+            const auto v = lengths[i];
+            std::size_t run = 1u;
+            while (i + run < lengths.size() && lengths[i + run] == v)
+            {
+                run++;
+            }
+            i += run;
+            if (v == 0u)
+            {
+                while (run >= 11u)
+                {
+                    const auto n = std::min<std::size_t>(run, 138u);
+                    out.push_back({ 18,std::uint32_t(n - 11u) });
+                    run -= n;
+                }
+                if (run >= 3u)
+                {
+                    out.push_back({ 17,std::uint32_t(run - 3u) });
+                    run = 0u;
+                }
+            }
+            else
+            {
+                out.push_back({ v,0u });
+                run--;
+                while (run >= 3u)
+                {
+                    const auto n = std::min<std::size_t>(run, 6u);
+                    out.push_back({ 16,std::uint32_t(n - 3u) });
+                    run -= n;
+                }
+            }
+            for (; run > 0u; run--)
+            {
+                out.push_back({ v,0u });
+            }
+        }
+        return out;
+    }
+
+    void PutTokens(BitWriter& bits, const Token* pBegin, const Token* pEnd, const HuffmanCode& literal, const HuffmanCode& distance)
+    {
+        for (auto t = pBegin; t != pEnd; t++)
+        {
+            if (t->length == 0u)
+            {
+                bits.PutCode(literal.codes[t->literal], literal.lengths[t->literal]);
+                continue;
+            }
+            const auto l = LengthSymbol(t->length);
+            bits.PutCode(literal.codes[std::size_t(257 + l)], literal.lengths[std::size_t(257 + l)]);
+            bits.Put(t->length - lengthBase[l], lengthExtra[l]);
+            const auto d = DistanceSymbol(t->distance);
+            bits.PutCode(distance.codes[std::size_t(d)], distance.lengths[std::size_t(d)]);
+            bits.Put(t->distance - distanceBase[d], distanceExtra[d]);
+        }
+        bits.PutCode(literal.codes[256], literal.lengths[256]);
+    }
+
+    void PutDynamicBlock(BitWriter& bits, const Token* pBegin, const Token* pEnd, bool final)
+    {
+        std::vector<std::uint32_t> literalFreq(286, 0u);
+        std::vector<std::uint32_t> distanceFreq(30, 0u);
+        for (auto t = pBegin; t != pEnd; t++)
+        {
+            if (t->length == 0u)
+            {
+                literalFreq[t->literal]++;
+            }
+            else
+            {
+                literalFreq[std::size_t(257 + LengthSymbol(t->length))]++;
+                distanceFreq[std::size_t(DistanceSymbol(t->distance))]++;
+            }
+        }
+        literalFreq[256] = 1u;
+        const auto literal = MakeCode(CodeLengths(literalFreq, 15));
+        const auto distance = MakeCode(CodeLengths(distanceFreq, 15));
+        std::size_t nLiteral = 286u;
+        while (nLiteral > 257u && literal.lengths[nLiteral - 1u] == 0u)
+        {
+            nLiteral--;
+        }
+        std::size_t nDistance = 30u;
+        while (nDistance > 1u && distance.lengths[nDistance - 1u] == 0u)
+        {
+            nDistance--;
+        }
+        std::vector<std::uint8_t> all(literal.lengths.begin(), literal.lengths.begin() + std::ptrdiff_t(nLiteral));
+        all.insert(all.end(), distance.lengths.begin(), distance.lengths.begin() + std::ptrdiff_t(nDistance));
+        const auto runs = RunLengthCodeLengths(all);
+        std::vector<std::uint32_t> codeLengthFreq(19, 0u);
+        for (const auto& r : runs)
+        {
+            codeLengthFreq[std::size_t(r.first)]++;
+        }
+        const auto codeLength = MakeCode(CodeLengths(codeLengthFreq, 7));
+        static constexpr std::uint8_t order[19] = { 16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15 };
+        int nCodeLength = 19;
+        while (nCodeLength > 4 && codeLength.lengths[order[nCodeLength - 1]] == 0u)
+        {
+            nCodeLength--;
+        }
+        bits.Put(final ? 1u : 0u, 1);
+        bits.Put(2u, 2);
+        bits.Put(std::uint32_t(nLiteral - 257u), 5);
+        bits.Put(std::uint32_t(nDistance - 1u), 5);
+        bits.Put(std::uint32_t(nCodeLength - 4), 4);
+        for (int i = 0; i < nCodeLength; i++)
+        {
+            bits.Put(codeLength.lengths[order[i]], 3);
+        }
+        for (const auto& r : runs)
+        {
+            bits.PutCode(codeLength.codes[std::size_t(r.first)], codeLength.lengths[std::size_t(r.first)]);
+            if (r.first >= 16)
+            {
+                bits.Put(r.second, r.first == 16 ? 2 : r.first == 17 ? 3 : 7);
+            }
+        }
+        PutTokens(bits, pBegin, pEnd, literal, distance);
+    }
+
+    std::vector<std::uint8_t> Zlib(const std::vector<std::uint8_t>& data, Deflate mode)
+    {
+        std::vector<std::uint8_t> out = { 0x78u,0x01u };
+        BitWriter bits(out);
+        const auto tokens = FindMatches(data);
+        static const auto fixed = [] {
+            std::vector<std::uint8_t> literal(288, 8u);
+            std::fill(literal.begin() + 144, literal.begin() + 256, std::uint8_t(9u));
+            std::fill(literal.begin() + 256, literal.begin() + 280, std::uint8_t(7u));
+            return std::make_pair(MakeCode(literal), MakeCode(std::vector<std::uint8_t>(30, 5u)));
+        }();
+        // 按 token 切块，stored 块写出这些 token 覆盖的原始字节
+        const std::size_t nBlocks = mode == Deflate::Mixed ? 5u : mode == Deflate::Dynamic ? 2u : 1u;
+        std::size_t pos = 0u;
+        for (std::size_t b = 0u; b < nBlocks; b++)
+        {
+            const auto first = tokens.size() * b / nBlocks;
+            const auto last = tokens.size() * (b + 1u) / nBlocks;
+            const bool final = b + 1u == nBlocks;
+            auto kind = mode;
+            if (mode == Deflate::Mixed)
+            {
+                static constexpr Deflate cycle[] = { Deflate::Fixed,Deflate::Stored,Deflate::Dynamic,Deflate::Stored,Deflate::Fixed };
+                kind = cycle[b];
+            }
+            std::size_t bytes = 0u;
+            for (auto t = first; t < last; t++)
+            {
+                bytes += tokens[t].length == 0u ? 1u : tokens[t].length;
+            }
+            if (kind == Deflate::Stored)
+            {
+                // 空块也要写，保证最后一块带 final
+                do
+                {
+                    const auto n = std::min<std::size_t>(bytes, 65535u);
+                    bytes -= n;
+                    bits.Put(final && bytes == 0u ? 1u : 0u, 1);
+                    bits.Put(0u, 2);
+                    bits.Align();
+                    out.push_back(std::uint8_t(n));
+                    out.push_back(std::uint8_t(n >> 8));
+                    out.push_back(std::uint8_t(~n));
+                    out.push_back(std::uint8_t(~n >> 8));
+                    out.insert(out.end(), data.begin() + std::ptrdiff_t(pos), data.begin() + std::ptrdiff_t(pos + n));
+                    pos += n;
+                } while (bytes > 0u);
+            }
+            else if (kind == Deflate::Fixed)
+            {
+                bits.Put(final ? 1u : 0u, 1);
+                bits.Put(1u, 2);
+                PutTokens(bits, tokens.data() + first, tokens.data() + last, fixed.first, fixed.second);
+                pos += bytes;
+            }
+            else
+            {
+                PutDynamicBlock(bits, tokens.data() + first, tokens.data() + last, final);
+                pos += bytes;
+            }
+        }
+        bits.Align();
+        std::uint32_t a = 1u;
+        std::uint32_t b = 0u;
+        for (const auto v : data)
+        {
+            a = (a + v) % 65521u;
+            b = (b + a) % 65521u;
+        }
+        const auto adler = (b << 16) | a;
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            out.push_back(std::uint8_t(adler >> shift));
+        }
+        return out;
+    }
+
+    // ---------------------------------------------------------------- 生成 PNG / TGA / DDS
+    std::uint32_t Crc32(const std::uint8_t* p, std::size_t size)
+    {
+        static const auto table = [] {
+            std::array<std::uint32_t, 256> t{};
+            for (std::uint32_t i = 0u; i < 256u; i++)
+            {
+                auto c = i;
+                for (int k = 0; k < 8; k++)
+                {
+                    c = (c & 1u) != 0u ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[i] = c;
+            }
+            return t;
+        }();
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (std::size_t i = 0u; i < size; i++)
+        {
+            crc = table[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void PutBE32(std::vector<std::uint8_t>& out, std::uint32_t v)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            out.push_back(std::uint8_t(v >> shift));
+        }
+    }
+
+    void PutLE16(std::vector<std::uint8_t>& out, std::uint32_t v)
+    {
+        out.push_back(std::uint8_t(v));
+        out.push_back(std::uint8_t(v >> 8));
+    }
+
+    void PutLE32(std::vector<std::uint8_t>& out, std::uint32_t v)
+    {
+        PutLE16(out, v);
+        PutLE16(out, v >> 16);
+    }
+
+    void PutChunk(std::vector<std::uint8_t>& png, const char* type, const std::uint8_t* pData, std::size_t size)
+    {
+        PutBE32(png, std::uint32_t(size));
+        const auto start = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), pData, pData + size);
+        PutBE32(png, Crc32(png.data() + start, png.size() - start));
+    }
+
+    std::vector<std::byte> ToBytes(const std::vector<std::uint8_t>& v)
+    {
+        return std::vector<std::byte>(reinterpret_cast<const std::byte*>(v.data()), reinterpret_cast<const std::byte*>(v.data()) + v.size());
+    }
+
+    struct PngCase
+    {
+        const char* name;
+        std::uint32_t colorType;
+        std::uint32_t depth;
+        Deflate deflate;
+        std::size_t idatCount;
+        // 灰度 / RGB 的 tRNS 透明色取 (0,0) 像素的值，调色板的 tRNS 给前几项 alpha
+        bool transparency;
+    };
+
+    struct GeneratedImage
+    {
+        std::vector<std::byte> file;
+        std::uint32_t width;
+        std::uint32_t height;
+        // 期望解出来的紧密排列 RGBA8
+        std::vector<std::uint8_t> rgba;
+    };
+
+    // 采样值：左半边是慢慢变化的渐变（匹配多），右半边是噪声（多是字面量）
+    std::uint32_t PngSample(std::uint32_t x, std::uint32_t y, std::uint32_t c, std::uint32_t width, std::uint32_t depth)
+    {
+        const auto v16 = x < width / 2u ? ((x / 3u * 9u + y * 5u + c * 60u) & 0xFFu) * 257u : Noise(x, y, c) & 0xFFFFu;
+        return v16 >> (16u - depth);
+    }
+
+    GeneratedImage MakePng(const PngCase& pc, std::uint32_t width, std::uint32_t height)
+    {
+        static constexpr std::uint32_t channelCounts[] = { 1u,0u,3u,1u,2u,0u,4u };
+        const auto channels = channelCounts[pc.colorType];
+        const auto maxSample = (1u << pc.depth) - 1u;
+        const auto paletteSize = pc.colorType == 3u ? std::min(1u << pc.depth, 180u) : 0u;
+        const auto sample = [&](std::uint32_t x, std::uint32_t y, std::uint32_t c) {
+            const auto s = PngSample(x, y, c, width, pc.depth);
+            return pc.colorType == 3u ? PngSample(x, y, 0u, width, 8u) % paletteSize : s;
+        };
+        std::vector<std::array<std::uint8_t, 4>> palette(paletteSize);
+        for (std::uint32_t i = 0u; i < paletteSize; i++)
+        {
+            palette[i] = { std::uint8_t(i * 5u),std::uint8_t(255u - i * 3u),std::uint8_t(i * i),std::uint8_t(pc.transparency && i < 16u ? i * 16u : 255u) };
+        }
+        std::uint32_t key[4] = {};
+        for (std::uint32_t c = 0u; c < channels && pc.colorType != 3u; c++)
+        {
+            key[c] = sample(0u, 0u, c);
+        }
+        const auto high = [&pc](std::uint32_t s) {
+            return std::uint8_t(pc.depth == 16u ? s >> 8 : s);
+        };
+
+        GeneratedImage out{ {},width,height,std::vector<std::uint8_t>(std::size_t(width) * height * 4u) };
+        const std::size_t bitsPerPixel = std::size_t(channels) * pc.depth;
+        const std::size_t rowBytes = (width * bitsPerPixel + 7u) / 8u;
+        const std::size_t bpp = std::max<std::size_t>(bitsPerPixel / 8u, 1u);
+        std::vector<std::uint8_t> filtered;
+        std::vector<std::uint8_t> prev(rowBytes, 0u);
+        std::vector<std::uint8_t> row(rowBytes);
+        for (std::uint32_t y = 0u; y < height; y++)
+        {
+            std::fill(row.begin(), row.end(), std::uint8_t(0u));
+            for (std::uint32_t x = 0u; x < width; x++)
+            {
+                std::uint32_t s[4] = {};
+                for (std::uint32_t c = 0u; c < channels; c++)
+                {
+                    s[c] = sample(x, y, c);
+                    const auto bit = (std::size_t(x) * channels + c) * pc.depth;
+                    if (pc.depth < 8u)
+                    {
+                        row[bit / 8u] |= std::uint8_t(s[c] << (8u - pc.depth - bit % 8u));
+                    }
+                    else if (pc.depth == 8u)
+                    {
+                        row[bit / 8u] = std::uint8_t(s[c]);
+                    }
+                    else
+                    {
+                        row[bit / 8u] = std::uint8_t(s[c] >> 8);
+                        row[bit / 8u + 1u] = std::uint8_t(s[c]);
+                    }
+                }
+                const auto dst = &out.rgba[(std::size_t(y) * width + x) * 4u];
+                const bool keyed = pc.transparency && s[0] == key[0] && s[1] == key[1] && s[2] == key[2];
+                switch (pc.colorType)
+                {
+                case 0u:
+                    dst[0] = dst[1] = dst[2] = pc.depth < 8u ? std::uint8_t(s[0] * 255u / maxSample) : high(s[0]);
+                    dst[3] = keyed ? 0u : 255u;
+                    break;
+                case 2u:
+                    dst[0] = high(s[0]);
+                    dst[1] = high(s[1]);
+                    dst[2] = high(s[2]);
+                    dst[3] = keyed ? 0u : 255u;
+                    break;
+                case 3u:
+                    std::memcpy(dst, palette[s[0]].data(), 4u);
+                    break;
+                case 4u:
+                    dst[0] = dst[1] = dst[2] = high(s[0]);
+                    dst[3] = high(s[1]);
+                    break;
+                default:
+                    for (int c = 0; c < 4; c++)
+                    {
+                        dst[c] = high(s[c]);
+                    }
+                    break;
+                }
+            }
+            // 五种过滤器按行轮流用，预测值取未过滤的数据
+            const auto filter = y % 5u;
+            filtered.push_back(std::uint8_t(filter));
+            for (std::size_t i = 0u; i < rowBytes; i++)
+            {
+                const int a = i >= bpp ? row[i - bpp] : 0;
+                const int b = prev[i];
+                const int c = i >= bpp ? prev[i - bpp] : 0;
+                int predictor = 0;
+                switch (filter)
+                {
+                case 1u: predictor = a; break;
+                case 2u: predictor = b; break;
+                case 3u: predictor = (a + b) >> 1; break;
+                case 4u:
+                {
+                    const int p = a + b - c;
+                    const int pa = std::abs(p - a);
+                    const int pb = std::abs(p - b);
+                    const int pcc = std::abs(p - c);
+                    predictor = pa <= pb && pa <= pcc ? a : pb <= pcc ? b : c;
+                    break;
+                }
+                default: break;
+                }
+                filtered.push_back(std::uint8_t(row[i] - predictor));
+            }
+            prev = row;
+        }
+
+        std::vector<std::uint8_t> png = { 0x89u,'P','N','G','\r','\n',0x1Au,'\n' };
+        std::vector<std::uint8_t> header;
+        PutBE32(header, width);
+        PutBE32(header, height);
+        header.insert(header.end(), { std::uint8_t(pc.depth),std::uint8_t(pc.colorType),0u,0u,0u });
+        PutChunk(png, "IHDR", header.data(), header.size());
+        // 辅助块解码器应当跳过
+        PutChunk(png, "tEXt", reinterpret_cast<const std::uint8_t*>("Comment\0test"), 12u);
+        if (pc.colorType == 3u)
+        {
+            std::vector<std::uint8_t> plte;
+            std::vector<std::uint8_t> trns;
+            for (const auto& p : palette)
+            {
+                plte.insert(plte.end(), p.begin(), p.begin() + 3);
+                trns.push_back(p[3]);
+            }
+            PutChunk(png, "PLTE", plte.data(), plte.size());
+            if (pc.transparency)
+            {
+                PutChunk(png, "tRNS", trns.data(), std::min<std::size_t>(trns.size(), 16u));
+            }
+        }
+        else if (pc.transparency)
+        {
+            std::vector<std::uint8_t> trns;
+            for (std::uint32_t c = 0u; c < channels; c++)
+            {
+                trns.push_back(std::uint8_t(key[c] >> 8));
+                trns.push_back(std::uint8_t(key[c]));
+            }
+            PutChunk(png, "tRNS", trns.data(), trns.size());
+        }
+        const auto stream = Zlib(filtered, pc.deflate);
+        for (std::size_t i = 0u; i < pc.idatCount; i++)
+        {
+            const auto begin = stream.size() * i / pc.idatCount;
+            const auto end = stream.size() * (i + 1u) / pc.idatCount;
+            PutChunk(png, "IDAT", stream.data() + begin, end - begin);
+        }
+        PutChunk(png, "IEND", nullptr, 0u);
+        out.file = ToBytes(png);
+        return out;
+    }
+
+    // bytesPerPixel 1 是灰度；行序按 topDown，RLE 包跨行
+    GeneratedImage MakeTga(std::uint32_t width, std::uint32_t height, std::uint32_t bytesPerPixel, bool rle, bool topDown, std::uint32_t idLength)
+    {
+        GeneratedImage out{ {},width,height,std::vector<std::uint8_t>(std::size_t(width) * height * 4u) };
+        // 文件里的像素顺序（BGR / BGRA / 灰度）
+        std::vector<std::array<std::uint8_t, 4>> pixels;
+        for (std::uint32_t row = 0u; row < height; row++)
+        {
+            const auto y = topDown ? row : height - 1u - row;
+            for (std::uint32_t x = 0u; x < width; x++)
+            {
+                // 左边 4x2 的色块（RLE 出重复包），右边噪声（出原样包）
+                std::uint8_t v[4];
+                for (std::uint32_t c = 0u; c < 4u; c++)
+                {
+                    v[c] = std::uint8_t(x < width / 2u ? (x / 4u * 40u + y / 2u * 70u + c * 90u) : Noise(x, y, c + 4u));
+                }
+                const auto dst = &out.rgba[(std::size_t(y) * width + x) * 4u];
+                if (bytesPerPixel == 1u)
+                {
+                    pixels.push_back({ v[0],0u,0u,0u });
+                    dst[0] = dst[1] = dst[2] = v[0];
+                    dst[3] = 255u;
+                }
+                else
+                {
+                    pixels.push_back({ v[2],v[1],v[0],v[3] });
+                    dst[0] = v[0];
+                    dst[1] = v[1];
+                    dst[2] = v[2];
+                    dst[3] = bytesPerPixel == 4u ? v[3] : 255u;
+                }
+            }
+        }
+        std::vector<std::uint8_t> tga = { std::uint8_t(idLength),0u,std::uint8_t(bytesPerPixel == 1u ? (rle ? 11u : 3u) : (rle ? 10u : 2u)),
+            0u,0u,0u,0u,0u,0u,0u,0u,0u };
+        PutLE16(tga, width);
+        PutLE16(tga, height);
+        tga.push_back(std::uint8_t(bytesPerPixel * 8u));
+        tga.push_back(std::uint8_t((topDown ? 0x20u : 0u) | (bytesPerPixel == 4u ? 8u : 0u)));
+        for (std::uint32_t i = 0u; i < idLength; i++)
+        {
+            tga.push_back(std::uint8_t('a' + i));
+        }
+        const auto putPixel = [&](std::size_t i) {
+            tga.insert(tga.end(), pixels[i].begin(), pixels[i].begin() + std::ptrdiff_t(bytesPerPixel));
+        };
+        const auto same = [&](std::size_t a, std::size_t b) {
+            return std::memcmp(pixels[a].data(), pixels[b].data(), bytesPerPixel) == 0;
+        };
+        for (std::size_t i = 0u; i < pixels.size();)
+        {
+            if (!rle)
+            {
+                putPixel(i++);
+                continue;
+            }
+            std::size_t run = 1u;
+            while (i + run < pixels.size() && run < 128u && same(i, i + run))
+            {
+                run++;
+            }
+            if (run >= 2u)
+            {
+                tga.push_back(std::uint8_t(0x80u | (run - 1u)));
+                putPixel(i);
+                i += run;
+                continue;
+            }
+            // 原样包一直延伸到下一段重复之前
+            std::size_t n = 1u;
+            while (i + n < pixels.size() && n < 128u && !(i + n + 1u < pixels.size() && same(i + n, i + n + 1u)))
+            {
+                n++;
+            }
+            tga.push_back(std::uint8_t(n - 1u));
+            for (std::size_t k = 0u; k < n; k++)
+            {
+                putPixel(i + k);
+            }
+            i += n;
+        }
+        out.file = ToBytes(tga);
+        return out;
+    }
+
+    // 传统 DDS 头（没有 DX10 扩展）；fourCC 为空时是 32 位 RGB 掩码格式
+    std::vector<std::uint8_t> LegacyDdsHeader(std::uint32_t width, std::uint32_t height, std::uint32_t mipCount, const char* fourCC,
+        std::uint32_t rMask, std::uint32_t bMask, std::uint32_t aMask)
+    {
+        std::vector<std::uint8_t> dds = { 'D','D','S',' ' };
+        PutLE32(dds, 124u);
+        PutLE32(dds, 0x1u | 0x2u | 0x4u | 0x1000u | (mipCount > 1u ? 0x20000u : 0u));
+        PutLE32(dds, height);
+        PutLE32(dds, width);
+        PutLE32(dds, 0u);
+        PutLE32(dds, 0u);
+        PutLE32(dds, mipCount);
+        dds.resize(4u + 72u, 0u);
+        PutLE32(dds, 32u);
+        PutLE32(dds, fourCC != nullptr ? 0x4u : 0x40u | (aMask != 0u ? 0x1u : 0u));
+        if (fourCC != nullptr)
+        {
+            dds.insert(dds.end(), fourCC, fourCC + 4);
+        }
+        else
+        {
+            PutLE32(dds, 0u);
+        }
+        PutLE32(dds, fourCC != nullptr ? 0u : 32u);
+        PutLE32(dds, rMask);
+        PutLE32(dds, 0x0000FF00u);
+        PutLE32(dds, bMask);
+        PutLE32(dds, aMask);
+        PutLE32(dds, 0x1000u);
+        dds.resize(4u + 124u, 0u);
+        return dds;
+    }
+
+    // 第 0 层（没有 mip）和期望的紧密排列 RGBA8 逐字节比较
+    bool SamePixels(const Image& image, const GeneratedImage& expected)
+    {
+        if (image.GetWidth() != expected.width || image.GetHeight() != expected.height || image.GetMipCount() != 1u ||
+            Image::IsCompressed(image.GetFormat()))
+        {
+            return false;
+        }
+        const auto& mip = image.GetMip(0u);
+        const auto p = reinterpret_cast<const std::uint8_t*>(image.GetMipData(0u));
+        for (std::uint32_t y = 0u; y < expected.height; y++)
+        {
+            if (std::memcmp(p + std::size_t(y) * mip.rowPitch, &expected.rgba[std::size_t(y) * expected.width * 4u], expected.width * 4u) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool SameLevels(const Image& a, const Image& b)
+    {
+        if (a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight() || a.GetFormat() != b.GetFormat() || a.GetMipCount() != b.GetMipCount())
+        {
+            return false;
+        }
+        for (std::uint32_t level = 0u; level < a.GetMipCount(); level++)
+        {
+            if (std::memcmp(a.GetMipData(level), b.GetMipData(level), a.GetMip(level).size) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 解码测试用到的文件，之后也拿来做损坏文件测试
+    struct NamedFile
+    {
+        std::string name;
+        std::vector<std::byte> data;
+    };
+
+    int CheckDecoders(std::vector<NamedFile>& corpus)
+    {
+        int failures = 0;
+        // 奇数尺寸：1/2/4 位的行末有不满一字节的填充
+        constexpr std::uint32_t width = 37u;
+        constexpr std::uint32_t height = 23u;
+        const PngCase pngCases[] = {
+            { "rgba8 stored",6u,8u,Deflate::Stored,1u,false },
+            { "rgb8 fixed",2u,8u,Deflate::Fixed,1u,false },
+            { "rgba8 dynamic, 3 IDAT",6u,8u,Deflate::Dynamic,3u,false },
+            { "rgba8 mixed blocks",6u,8u,Deflate::Mixed,2u,false },
+            { "gray8 fixed, tRNS",0u,8u,Deflate::Fixed,1u,true },
+            { "gray-alpha8 dynamic",4u,8u,Deflate::Dynamic,1u,false },
+            { "rgb16 stored, tRNS",2u,16u,Deflate::Stored,1u,true },
+            { "rgba16 dynamic",6u,16u,Deflate::Dynamic,2u,false },
+            { "gray16 fixed",0u,16u,Deflate::Fixed,1u,false },
+            { "gray-alpha16 mixed",4u,16u,Deflate::Mixed,1u,false },
+            { "gray1 stored",0u,1u,Deflate::Stored,1u,false },
+            { "gray2 fixed, tRNS",0u,2u,Deflate::Fixed,1u,true },
+            { "gray4 dynamic",0u,4u,Deflate::Dynamic,1u,false },
+            { "palette8 dynamic, tRNS",3u,8u,Deflate::Dynamic,1u,true },
+            { "palette4 fixed",3u,4u,Deflate::Fixed,1u,false },
+            { "palette2 stored, tRNS",3u,2u,Deflate::Stored,1u,true },
+            { "palette1 dynamic",3u,1u,Deflate::Dynamic,1u,false },
+        };
+        for (const auto& pc : pngCases)
+        {
+            const auto png = MakePng(pc, width, height);
+            const bool srgb = pc.colorType != 0u;
+            const auto image = ImageCodecs::Decode(png.file.data(), png.file.size(), "test.png", srgb);
+            failures += Check(SamePixels(image, png) && image.GetFormat() == (srgb ? ImageFormat::RGBA8Srgb : ImageFormat::RGBA8),
+                std::string("PNG ") + pc.name + " decodes to the generated pixels");
+            corpus.push_back({ std::string(pc.name) + ".png",png.file });
+        }
+
+        struct TgaCase
+        {
+            const char* name;
+            std::uint32_t bytesPerPixel;
+            bool rle;
+            bool topDown;
+            std::uint32_t idLength;
+        };
+        const TgaCase tgaCases[] = {
+            { "raw 24 bottom-up",3u,false,false,0u },
+            { "raw 32 top-down, image id",4u,false,true,5u },
+            { "raw gray",1u,false,false,0u },
+            { "rle 32 bottom-up",4u,true,false,0u },
+            { "rle 24 top-down",3u,true,true,3u },
+            { "rle gray",1u,true,false,0u },
+        };
+        for (const auto& tc : tgaCases)
+        {
+            const auto tga = MakeTga(width, height, tc.bytesPerPixel, tc.rle, tc.topDown, tc.idLength);
+            const auto image = ImageCodecs::Decode(tga.file.data(), tga.file.size(), "test.TGA", false);
+            failures += Check(SamePixels(image, tga) && image.GetFormat() == ImageFormat::RGBA8,
+                std::string("TGA ") + tc.name + " decodes to the generated pixels");
+            corpus.push_back({ std::string(tc.name) + ".tga",tga.file });
+        }
+
+        // DDS：EncodeDds 写的 DX10 头要原样读回来（包括整条 mip 链）
+        {
+            const auto png = MakePng(pngCases[0], width, height);
+            auto image = ImageCodecs::Decode(png.file.data(), png.file.size(), "test.png", true);
+            MipChain::Generate(image, MipFilter::Box);
+            const auto dds = ImageCodecs::EncodeDds(image);
+            failures += Check(SameLevels(ImageCodecs::Decode(dds.data(), dds.size(), "test.dds", false), image),
+                "DDS written by EncodeDds reads back with every mip level");
+            corpus.push_back({ "dx10.dds",dds });
+        }
+        // 传统头：BGRX（没有 alpha 的要补成 255）、BGRA、带 3 层 mip 的 RGBA
+        {
+            struct LegacyCase
+            {
+                const char* name;
+                std::uint32_t rMask;
+                std::uint32_t bMask;
+                std::uint32_t aMask;
+                std::uint32_t mipCount;
+            };
+            const LegacyCase legacyCases[] = {
+                { "BGRX",0x00FF0000u,0x000000FFu,0u,1u },
+                { "BGRA",0x00FF0000u,0x000000FFu,0xFF000000u,1u },
+                { "RGBA with mips",0x000000FFu,0x00FF0000u,0xFF000000u,3u },
+            };
+            for (const auto& lc : legacyCases)
+            {
+                auto dds = LegacyDdsHeader(width, height, lc.mipCount, nullptr, lc.rMask, lc.bMask, lc.aMask);
+                Image expected(width, height, ImageFormat::RGBA8Srgb, lc.mipCount);
+                for (std::uint32_t level = 0u; level < lc.mipCount; level++)
+                {
+                    const auto& mip = expected.GetMip(level);
+                    const auto p = reinterpret_cast<std::uint8_t*>(expected.GetMipData(level));
+                    for (std::size_t i = 0u; i < mip.size; i += 4u)
+                    {
+                        const std::uint8_t rgba[4] = { std::uint8_t(Noise(std::uint32_t(i), level, 0u)),std::uint8_t(i),
+                            std::uint8_t(level * 50u),std::uint8_t(Noise(std::uint32_t(i), level, 1u)) };
+                        const bool bgr = lc.rMask == 0x00FF0000u;
+                        dds.insert(dds.end(), { rgba[bgr ? 2 : 0],rgba[1],rgba[bgr ? 0 : 2],rgba[3] });
+                        std::memcpy(p + i, rgba, 4u);
+                        p[i + 3u] = lc.aMask != 0u ? rgba[3] : 255u;
+                    }
+                }
+                const auto file = ToBytes(dds);
+                failures += Check(SameLevels(ImageCodecs::Decode(file.data(), file.size(), "legacy.dds", true), expected),
+                    std::string("legacy DDS ") + lc.name + " decodes to the written pixels");
+                corpus.push_back({ std::string(lc.name) + ".dds",file });
+            }
+            // FourCC 的块压缩数据原样拷贝；传统头按 srgb 参数决定色彩空间，ATI2 没有 sRGB
+            const std::pair<const char*, ImageFormat> fourCCs[] = { { "DXT1",ImageFormat::BC1Srgb },{ "DXT5",ImageFormat::BC3Srgb },{ "ATI2",ImageFormat::BC5 } };
+            for (const auto& f : fourCCs)
+            {
+                auto dds = LegacyDdsHeader(16u, 8u, 3u, f.first, 0u, 0u, 0u);
+                Image expected(16u, 8u, f.second, 3u);
+                for (std::uint32_t level = 0u; level < 3u; level++)
+                {
+                    const auto p = reinterpret_cast<std::uint8_t*>(expected.GetMipData(level));
+                    for (std::size_t i = 0u; i < expected.GetMip(level).size; i++)
+                    {
+                        p[i] = std::uint8_t(Noise(std::uint32_t(i), level, 2u));
+                        dds.push_back(p[i]);
+                    }
+                }
+                const auto file = ToBytes(dds);
+                failures += Check(SameLevels(ImageCodecs::Decode(file.data(), file.size(), "legacy.dds", true), expected),
+                    std::string("legacy DDS ") + f.first + " keeps its blocks and mips");
+            }
+        }
+
+        // Inflate 直接测：长流（多个 65535 字节的 stored 块、32 KB 窗口边上的匹配）在各种块类型下解出同样的数据；
+        // 输出缓冲少一个字节必须报错而不是写越界
+        std::vector<std::uint8_t> data(200000u);
+        for (std::size_t i = 0u; i < data.size(); i++)
+        {
+            data[i] = (i / 5000u) % 2u == 0u ? std::uint8_t(i / 7u) : std::uint8_t(Noise(std::uint32_t(i % 40000u), 0u, 3u) & 0x0Fu);
+        }
+        for (const auto mode : { Deflate::Stored,Deflate::Fixed,Deflate::Dynamic,Deflate::Mixed })
+        {
+            const auto stream = ToBytes(Zlib(data, mode));
+            std::vector<std::byte> out(data.size() + 1u);
+            const auto n = ImageCodecs::Inflate(stream.data(), stream.size(), out.data(), out.size(), "inflate");
+            failures += Check(n == data.size() && std::memcmp(out.data(), data.data(), n) == 0,
+                "Inflate of a " + std::to_string(stream.size()) + " byte stream returns the original data");
+            bool threw = false;
+            try
+            {
+                ImageCodecs::Inflate(stream.data(), stream.size(), out.data(), data.size() - 1u, "inflate");
+            }
+            catch (const ImageException&)
+            {
+                threw = true;
+            }
+            failures += Check(threw, "Inflate rejects an output buffer one byte too small");
+        }
+        std::cout << "decoders: " << std::size(pngCases) << " PNG, " << std::size(tgaCases) << " TGA, 7 DDS, 4 zlib streams checked" << std::endl;
+        return failures;
+    }
+
+    // ---------------------------------------------------------------- mip 检查
+    std::uint8_t ToSrgb8(double linear)
+    {
+        linear = std::clamp(linear, 0.0, 1.0);
+        const auto s = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+        return std::uint8_t(s * 255.0 + 0.5);
+    }
+
+    int CheckMips()
+    {
+        int failures = 0;
+        for (int v = 0; v < 256; v++)
+        {
+            failures += Check(MipChain::LinearToSrgb(MipChain::SrgbToLinear(std::uint8_t(v))) == v,
+                "sRGB " + std::to_string(v) + " survives the round trip through linear");
+        }
+        // 线性空间里的渐变：R 沿 x、G 沿 y、B 常数 0.5、alpha 沿 x。2x2 平均保持线性渐变，
+        // 所以每层的期望值就是按该层坐标算的渐变（Kaiser 的权重对称且和为 1，内部也一样）
+        constexpr std::uint32_t width = 64u;
+        constexpr std::uint32_t height = 32u;
+        for (const auto filter : { MipFilter::Box,MipFilter::Kaiser })
+        {
+            const bool kaiser = filter == MipFilter::Kaiser;
+            Image image(width, height, ImageFormat::RGBA8Srgb);
+            auto p = reinterpret_cast<std::uint8_t*>(image.GetMipData(0u));
+            for (std::uint32_t y = 0u; y < height; y++)
+            {
+                for (std::uint32_t x = 0u; x < width; x++, p += 4)
+                {
+                    p[0] = ToSrgb8((x + 0.5) / width);
+                    p[1] = ToSrgb8((y + 0.5) / height);
+                    p[2] = ToSrgb8(0.5);
+                    p[3] = std::uint8_t((x + 0.5) / width * 255.0 + 0.5);
+                }
+            }
+            MipChain::Generate(image, filter);
+            failures += Check(image.GetMipCount() == 7u && image.GetMip(6u).width == 1u && image.GetMip(6u).height == 1u,
+                "64x32 gets a 7 level chain down to 1x1");
+            // 误差按 8 位的 sRGB 值算。每层从上一层量化后的结果算出，误差会累积一点。
+            // Kaiser 在边上按钳位取样，渐变在最外两个像素不再是线性的，只检查内部
+            int worst = 0;
+            for (std::uint32_t level = 1u; level < image.GetMipCount(); level++)
+            {
+                const auto& mip = image.GetMip(level);
+                const auto q = reinterpret_cast<const std::uint8_t*>(image.GetMipData(level));
+                for (std::uint32_t y = 0u; y < mip.height; y++)
+                {
+                    for (std::uint32_t x = 0u; x < mip.width; x++)
+                    {
+                        const auto px = q + std::size_t(y) * mip.rowPitch + x * 4u;
+                        const bool insideX = !kaiser || (x >= 2u && x + 2u < mip.width);
+                        const bool insideY = !kaiser || (y >= 2u && y + 2u < mip.height);
+                        const auto err = [&worst](std::uint8_t actual, std::uint8_t expected) {
+                            worst = std::max(worst, std::abs(int(actual) - int(expected)));
+                        };
+                        if (insideX)
+                        {
+                            err(px[0], ToSrgb8((x + 0.5) / mip.width));
+                            err(px[3], std::uint8_t((x + 0.5) / mip.width * 255.0 + 0.5));
+                        }
+                        if (insideY)
+                        {
+                            err(px[1], ToSrgb8((y + 0.5) / mip.height));
+                        }
+                        // 常数在哪里都不变，包括钳位的边上
+                        err(px[2], ToSrgb8(0.5));
+                    }
+                }
+            }
+            const int tolerance = 1;
+            failures += Check(worst <= tolerance, std::string(kaiser ? "Kaiser" : "box") + " mips of a linear gradient are off by " +
+                std::to_string(worst) + ", more than " + std::to_string(tolerance));
+            std::cout << (kaiser ? "kaiser" : "box   ") << " mips of a linear gradient: worst error " << worst << " (8-bit sRGB)" << std::endl;
+
+            // 黑白棋盘格：gamma-correct 的平均是线性 0.5 = sRGB 188，直接平均 sRGB 值会得到 128。
+            // alpha 和非 sRGB 的格式按线性平均，得到 128
+            for (const auto format : { ImageFormat::RGBA8Srgb,ImageFormat::RGBA8 })
+            {
+                Image checker(16u, 16u, format);
+                auto c = reinterpret_cast<std::uint8_t*>(checker.GetMipData(0u));
+                for (std::uint32_t y = 0u; y < 16u; y++)
+                {
+                    for (std::uint32_t x = 0u; x < 16u; x++, c += 4)
+                    {
+                        const std::uint8_t v = (x + y) % 2u == 0u ? 255u : 0u;
+                        c[0] = c[1] = c[2] = c[3] = v;
+                    }
+                }
+                MipChain::Generate(checker, filter);
+                const int expectedRgb = format == ImageFormat::RGBA8Srgb ? 188 : 128;
+                const auto& mip = checker.GetMip(1u);
+                const auto q = reinterpret_cast<const std::uint8_t*>(checker.GetMipData(1u));
+                bool good = true;
+                for (std::uint32_t y = 0u; y < mip.height; y++)
+                {
+                    for (std::uint32_t x = 0u; x < mip.width; x++)
+                    {
+                        if (kaiser && (x < 2u || y < 2u || x + 2u >= mip.width || y + 2u >= mip.height))
+                        {
+                            continue;
+                        }
+                        const auto px = q + std::size_t(y) * mip.rowPitch + x * 4u;
+                        for (int k = 0; k < 4; k++)
+                        {
+                            good &= std::abs(int(px[k]) - (k < 3 ? expectedRgb : 128)) <= 1;
+                        }
+                    }
+                }
+                failures += Check(good, std::string(kaiser ? "Kaiser" : "box") + " mip of a checkerboard averages in " +
+                    (format == ImageFormat::RGBA8Srgb ? "linear light" : "stored values"));
+            }
+        }
+        return failures;
+    }
+
+    // ---------------------------------------------------------------- 损坏的文件
+    bool Rejects(const std::vector<std::byte>& file, const std::string& name, int& failures)
+    {
+        try
+        {
+            ImageCodecs::Decode(file.data(), file.size(), name, true);
+        }
+        catch (const ImageException&)
+        {
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            failures += Check(false, name + ": corrupt file threw a non-image exception: " + e.what());
+            return true;
+        }
+        return false;
+    }
+
+    int CheckCorruptFiles(const std::vector<NamedFile>& corpus)
+    {
+        int failures = 0;
+        std::uint64_t state = 12345u;
+        const auto next = [&state]() {
+            state = state * 6364136223846793005u + 1442695040888963407u;
+            return std::size_t(state >> 33u);
+        };
+        // 截断的一律拒绝：PNG 找不到 IEND，TGA / DDS 像素数据不够
+        std::size_t truncated = 0u;
+        std::size_t rejected = 0u;
+        std::size_t trials = 0u;
+        for (const auto& f : corpus)
+        {
+            for (int trial = 0; trial < 40; trial++)
+            {
+                const auto length = trial < 20 ? next() % std::min<std::size_t>(f.data.size(), 160u) : next() % f.data.size();
+                const std::vector<std::byte> copy(f.data.begin(), f.data.begin() + std::ptrdiff_t(length));
+                const bool rejectedCopy = Rejects(copy, f.name, failures);
+                failures += Check(rejectedCopy, f.name + " truncated to " + std::to_string(length) + " bytes is accepted");
+                truncated++;
+            }
+            // 随机改几个字节：头里的字段最容易出问题，一半的改动落在前 64 字节
+            for (int trial = 0; trial < 40; trial++)
+            {
+                auto copy = f.data;
+                for (int k = 0; k < 1 + trial % 3; k++)
+                {
+                    const auto range = trial % 2 == 0 ? std::min<std::size_t>(copy.size(), 64u) : copy.size();
+                    copy[next() % range] = std::byte(next() & 0xFFu);
+                }
+                rejected += Rejects(copy, f.name, failures) ? 1u : 0u;
+                trials++;
+            }
+        }
+        // 这些改动必须被发现（文件名对应 CheckDecoders 里的语料）
+        struct Poke
+        {
+            const char* file;
+            std::size_t offset;
+            std::uint8_t value;
+            const char* what;
+        };
+        // PNG：8 字节签名，IHDR 数据从 16 开始；tEXt 块 24 字节，第一个 IDAT 的类型在 61，数据从 65 开始（zlib 头 2 字节，然后是第一个块头）
+        const Poke pokes[] = {
+            { "rgba8 stored.png",0u,0x88u,"bad PNG signature" },
+            { "rgba8 stored.png",15u,'X',"first chunk is not IHDR" },
+            { "rgba8 stored.png",19u,0u,"zero width" },
+            { "rgba8 stored.png",16u,1u,"width above the D3D11 limit" },
+            { "rgba8 stored.png",24u,3u,"bit depth 3" },
+            { "rgba8 stored.png",25u,5u,"color type 5" },
+            { "rgba8 stored.png",28u,1u,"interlaced" },
+            { "rgba8 stored.png",64u,'X',"unknown critical chunk" },
+            { "rgba8 stored.png",65u,0x79u,"bad zlib header" },
+            { "rgba8 stored.png",68u,0u,"stored block length does not match its complement" },
+            { "rgba8 stored.png",72u,5u,"filter type 5" },
+            { "rgb8 fixed.png",67u,0x07u,"deflate block type 3" },
+            { "palette8 dynamic, tRNS.png",24u,16u,"16-bit palette" },
+            { "raw 24 bottom-up.tga",1u,1u,"color-mapped TGA" },
+            { "raw 24 bottom-up.tga",2u,1u,"TGA image type 1" },
+            { "raw 24 bottom-up.tga",12u,0u,"zero width TGA" },
+            { "raw 24 bottom-up.tga",16u,16u,"16-bit TGA" },
+            { "dx10.dds",4u,125u,"bad DDS header size" },
+            { "dx10.dds",16u,0u,"zero width DDS" },
+            { "dx10.dds",28u,20u,"more mips than the size allows" },
+            { "dx10.dds",113u,0x02u,"cubemap DDS" },
+            { "dx10.dds",128u,2u,"unsupported DXGI format" },
+            { "dx10.dds",132u,4u,"3D DDS" },
+            { "BGRX.dds",84u,'X',"DDS FourCC flag without a known FourCC" },
+        };
+        for (const auto& poke : pokes)
+        {
+            const auto f = std::find_if(corpus.begin(), corpus.end(), [&poke](const NamedFile& n) { return n.name == poke.file; });
+            if (f == corpus.end())
+            {
+                failures += Check(false, std::string("no generated file named ") + poke.file);
+                continue;
+            }
+            auto copy = f->data;
+            copy[poke.offset] = std::byte(poke.value);
+            if (poke.offset == 84u)
+            {
+                // 同时打开 FourCC 标志
+                copy[80u] = std::byte(0x4u);
+            }
+            const bool rejectedCopy = Rejects(copy, f->name, failures);
+            failures += Check(rejectedCopy, f->name + ": " + poke.what + " is accepted");
+        }
+        std::cout << "corrupt files: " << truncated << " truncations and " << std::size(pokes) << " bad fields rejected, "
+                  << rejected << " of " << trials << " random corruptions rejected, the rest decoded" << std::endl;
+        return failures;
+    }
+
+    // 没给文件时的基准输入：像照片的平滑渐变加噪声，边长是 4 的倍数
+    std::vector<NamedFile> MakeBenchFiles(std::uint32_t size)
+    {
+        std::vector<std::uint8_t> filtered;
+        std::vector<std::uint8_t> tga = { 0u,0u,10u,0u,0u,0u,0u,0u,0u,0u,0u,0u };
+        PutLE16(tga, size);
+        PutLE16(tga, size);
+        tga.insert(tga.end(), { 32u,0x28u });
+        for (std::uint32_t y = 0u; y < size; y++)
+        {
+            filtered.push_back(0u);
+            for (std::uint32_t x = 0u; x < size; x++)
+            {
+                for (std::uint32_t c = 0u; c < 4u; c++)
+                {
+                    const auto smooth = c == 3u ? 255u : (x * (c + 1u) + y * (3u - c)) / 8u;
+                    filtered.push_back(std::uint8_t(smooth + (Noise(x, y, c) & 3u)));
+                }
+            }
+        }
+        // TGA 用 RLE，但按 4x4 的色块重复才有重复包
+        for (std::uint32_t y = 0u; y < size; y++)
+        {
+            for (std::uint32_t x = 0u; x < size; x += 4u)
+            {
+                const auto src = &filtered[std::size_t(y / 4u * 4u) * (size * 4u + 1u) + 1u + x * 4u];
+                tga.insert(tga.end(), { 0x83u,src[2],src[1],src[0],src[3] });
+            }
+        }
+        std::vector<std::uint8_t> png = { 0x89u,'P','N','G','\r','\n',0x1Au,'\n' };
+        std::vector<std::uint8_t> header;
+        PutBE32(header, size);
+        PutBE32(header, size);
+        header.insert(header.end(), { 8u,6u,0u,0u,0u });
+        PutChunk(png, "IHDR", header.data(), header.size());
+        const auto stream = Zlib(filtered, Deflate::Dynamic);
+        PutChunk(png, "IDAT", stream.data(), stream.size());
+        PutChunk(png, "IEND", nullptr, 0u);
+        return { { "generated.png",ToBytes(png) },{ "generated.tga",ToBytes(tga) } };
+    }
+
+    // ---------------------------------------------------------------- 块压缩检查
+    // 70x54：边长不是 4 的倍数，边缘块要补齐。左边平滑渐变加一点噪声，右边是硬边的色块，alpha 是径向渐变（opaque 时全是 255）
+    Image MakeCompressionSource(bool srgb, bool opaque = false)
+    {
+        constexpr std::uint32_t width = 70u;
+        constexpr std::uint32_t height = 54u;
+        Image image(width, height, srgb ? ImageFormat::RGBA8Srgb : ImageFormat::RGBA8);
+        auto p = reinterpret_cast<std::uint8_t*>(image.GetMipData(0u));
+        for (std::uint32_t y = 0u; y < height; y++)
+        {
+            for (std::uint32_t x = 0u; x < width; x++, p += 4)
+            {
+                const auto noise = [&](std::uint32_t c) {
+                    return int(Noise(x, y, c + 8u) & 7u) - 4;
+                };
+                int rgb[3];
+                if (x < width / 2u)
+                {
+                    rgb[0] = int(x * 7u);
+                    rgb[1] = int(y * 4u + 20u);
+                    rgb[2] = int(128.0 + 100.0 * std::sin((x + y) * 0.15));
+                }
+                else
+                {
+                    const bool on = ((x / 5u) + (y / 3u)) % 2u == 0u;
+                    rgb[0] = on ? 230 : 30;
+                    rgb[1] = on ? 200 : 60;
+                    rgb[2] = on ? 40 : 180;
+                }
+                for (int c = 0; c < 3; c++)
+                {
+                    p[c] = std::uint8_t(std::clamp(rgb[c] + noise(std::uint32_t(c)), 0, 255));
+                }
+                const auto dx = double(x) - width / 2.0;
+                const auto dy = double(y) - height / 2.0;
+                p[3] = opaque ? 255u : std::uint8_t(std::clamp(255.0 - std::sqrt(dx * dx + dy * dy) * 6.0, 0.0, 255.0));
+            }
+        }
+        return image;
+    }
+
+    int CheckCompression(ThreadPool& pool)
+    {
+        int failures = 0;
+        struct Floor
+        {
+            const char* name;
+            TextureCompression compression;
+            // 第 0 层 Encode -> Decode 的 PSNR 下限（dB），按 fast / normal / high；实测值再留 1 dB 左右的余量
+            double psnr[3];
+        };
+        const Floor floors[] = {
+            { "bc1",TextureCompression::BC1,{ 28.0,29.5,30.0 } },
+            { "bc3",TextureCompression::BC3,{ 29.5,31.0,31.0 } },
+            { "bc4",TextureCompression::BC4,{ 36.5,37.5,39.0 } },
+            { "bc5",TextureCompression::BC5,{ 37.0,38.0,40.0 } },
+            { "bc7",TextureCompression::BC7,{ 29.0,31.0,35.5 } },
+        };
+        static const char* const qualityNames[] = { "fast","normal","high" };
+        const auto translucent = MakeCompressionSource(true);
+        // BC1 把 alpha < 128 的像素编成透明，解出来 RGB 是 0，PSNR 用不透明的源算；透明的阈值单独检查
+        const auto opaque = MakeCompressionSource(true, true);
+        std::cout << "block compression PSNR on a generated " << translucent.GetWidth() << "x" << translucent.GetHeight()
+                  << " image, dB (floor)" << std::endl;
+        for (const auto& f : floors)
+        {
+            const auto& source = f.compression == TextureCompression::BC1 ? opaque : translucent;
+            std::cout << "  " << f.name;
+            double previous = 0.0;
+            for (int q = 0; q < 3; q++)
+            {
+                const auto quality = BcQuality(q);
+                const auto encoded = BlockCompression::Encode(source, f.compression, quality);
+                const auto psnr = BlockCompression::ComputePsnr(source, BlockCompression::Decode(encoded),
+                    BlockCompression::GetChannelCount(f.compression));
+                std::cout << std::fixed << std::setprecision(2) << std::setw(8) << psnr << " (" << std::setprecision(1) << f.psnr[q] << ")";
+                failures += Check(psnr >= f.psnr[q], std::string(f.name) + " " + qualityNames[q] + ": " + std::to_string(psnr) +
+                    " dB PSNR is below the " + std::to_string(f.psnr[q]) + " dB floor");
+                // 更慢的档位不能更差
+                failures += Check(psnr >= previous, std::string(f.name) + " " + qualityNames[q] + " is worse than the faster preset");
+                previous = psnr;
+                // 按块行分给线程池的结果和单线程的逐字节相同
+                failures += Check(SameLevels(BlockCompression::Encode(source, f.compression, quality, &pool), encoded),
+                    std::string(f.name) + " " + qualityNames[q] + ": thread pool output differs from the single-threaded one");
+            }
+            std::cout << std::endl;
+        }
+        {
+            const auto decoded = BlockCompression::Decode(BlockCompression::Encode(translucent, TextureCompression::BC1, BcQuality::Normal));
+            const auto src = reinterpret_cast<const std::uint8_t*>(translucent.GetMipData(0u));
+            const auto dst = reinterpret_cast<const std::uint8_t*>(decoded.GetMipData(0u));
+            bool good = true;
+            for (std::size_t i = 0u; i < translucent.GetMip(0u).size; i += 4u)
+            {
+                good &= dst[i + 3u] == (src[i + 3u] < 128u ? 0u : 255u) && (src[i + 3u] >= 128u || (dst[i] | dst[i + 1u] | dst[i + 2u]) == 0u);
+            }
+            failures += Check(good, "bc1: pixels with alpha below 128 do not decode to transparent black, or others lose their alpha");
+        }
+
+        // EncodeDds -> DecodeDds 对整条 mip 链的块压缩数据逐字节不变，格式（包括 sRGB）也不变
+        for (const bool srgb : { true,false })
+        {
+            auto mipped = MakeCompressionSource(srgb);
+            MipChain::Generate(mipped, MipFilter::Box);
+            for (const auto& f : floors)
+            {
+                const auto encoded = BlockCompression::Encode(mipped, f.compression, BcQuality::Fast);
+                const auto dds = ImageCodecs::EncodeDds(encoded);
+                failures += Check(SameLevels(ImageCodecs::DecodeDds(dds.data(), dds.size(), "bc.dds", !srgb), encoded),
+                    std::string(f.name) + (srgb ? " srgb" : " linear") + ": DDS round trip changes the blocks or the format");
+            }
+        }
+
+        // 磁盘缓存：第一次写进去的文件就是结果的 DDS，第二次读回同样的数据；
+        // 缓存命中时用的确实是文件里的内容（换成别的合法 DDS 就返回那一份）；坏掉的缓存重新生成
+        const auto directory = std::filesystem::temp_directory_path() /
+            ("TextureBench-cache-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        {
+            const auto png = MakeBenchFiles(64u).front();
+            const ImageLoader::Source file{ png.name,png.data.data(),png.data.size() };
+            ImageLoadOptions options;
+            options.compression = TextureCompression::BC7;
+            const auto uncached = ImageLoader::LoadFromMemory(file, options);
+            options.cacheDirectory = directory.string();
+            const auto first = ImageLoader::LoadFromMemory(file, options);
+            std::vector<std::filesystem::path> cached;
+            for (const auto& entry : std::filesystem::directory_iterator(directory))
+            {
+                cached.push_back(entry.path());
+            }
+            failures += Check(cached.size() == 1u, "the cache directory holds " + std::to_string(cached.size()) + " files, expected 1");
+            if (cached.size() == 1u)
+            {
+                const auto readCache = [&cached]() {
+                    std::ifstream in(cached[0], std::ios::binary);
+                    return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+                };
+                const auto writeCache = [&cached](const std::vector<std::byte>& data) {
+                    std::ofstream out(cached[0], std::ios::binary | std::ios::trunc);
+                    out.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+                };
+                const auto expected = ImageCodecs::EncodeDds(uncached);
+                const auto onDisk = readCache();
+                failures += Check(SameLevels(first, uncached), "the first cached load differs from an uncached one");
+                failures += Check(onDisk.size() == expected.size() && std::memcmp(onDisk.data(), expected.data(), expected.size()) == 0,
+                    "the cache file is not the DDS of the loaded image");
+                failures += Check(SameLevels(ImageLoader::LoadFromMemory(file, options), uncached), "a cache hit returns different data");
+
+                auto other = BlockCompression::Encode(MakeCompressionSource(true), TextureCompression::BC7, BcQuality::Fast);
+                writeCache(ImageCodecs::EncodeDds(other));
+                failures += Check(SameLevels(ImageLoader::LoadFromMemory(file, options), other), "a cache hit does not return the cached file");
+
+                writeCache(std::vector<std::byte>(expected.begin(), expected.begin() + 100));
+                failures += Check(SameLevels(ImageLoader::LoadFromMemory(file, options), uncached), "a truncated cache file is not regenerated");
+                const auto rewritten = readCache();
+                failures += Check(rewritten.size() == expected.size() && std::memcmp(rewritten.data(), expected.data(), expected.size()) == 0,
+                    "the regenerated cache file differs from the original");
+            }
+        }
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+        return failures;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    ImageLoadOptions options;
+    unsigned int iterations = 5u;
+    unsigned int threads = 0u;
+    auto compression = TextureCompression::None;
+    auto quality = BcQuality::Normal;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc)
+        {
+            options.mipFilter = std::string(argv[++i]) == "kaiser" ? MipFilter::Kaiser : MipFilter::Box;
+        }
+        else if (arg == "--no-mips")
+        {
+            options.generateMips = false;
+        }
+        else if (arg == "--linear")
+        {
+            options.srgb = false;
+        }
+        else if (arg == "--iterations" && i + 1 < argc)
+        {
+            iterations = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            threads = unsigned(std::stoul(argv[++i]));
+        }
+        else if (arg == "--compress" && i + 1 < argc)
+        {
+            if (!ParseCompression(argv[++i], compression))
+            {
+                std::cerr << "unknown compression format " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--quality" && i + 1 < argc)
+        {
+            const std::string name = argv[++i];
+            quality = name == "fast" ? BcQuality::Fast : name == "high" ? BcQuality::High : BcQuality::Normal;
+        }
+        else if (arg.compare(0u, 2u, "--") != 0)
+        {
+            paths.push_back(arg);
+        }
+        else
+        {
+            iterations = 0u;
+            break;
+        }
+    }
+    if (iterations == 0u)
+    {
+        std::cerr << "usage: TextureBench [image files...] [--filter box|kaiser] [--no-mips] [--linear] "
+                     "[--iterations N] [--threads N] [--compress bc1|bc3|bc4|bc5|bc7] [--quality fast|normal|high]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        int failures = 0;
+        std::vector<NamedFile> corpus;
+        failures += CheckDecoders(corpus);
+        failures += CheckMips();
+        failures += CheckCorruptFiles(corpus);
+        ThreadPool pool(threads);
+        failures += CheckCompression(pool);
+
+        // 文件读取不计时，只测 CPU 管线
+        std::vector<NamedFile> files;
+        if (paths.empty())
+        {
+            files = MakeBenchFiles(1024u);
+        }
+        for (const auto& path : paths)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+            {
+                std::cerr << "cannot open " << path << std::endl;
+                return 1;
+            }
+            const std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            const auto pBytes = reinterpret_cast<const std::byte*>(bytes.data());
+            files.push_back({ path,std::vector<std::byte>(pBytes, pBytes + bytes.size()) });
+        }
+        std::vector<ImageLoader::Source> sources;
+        std::size_t inputBytes = 0u;
+        for (const auto& f : files)
+        {
+            sources.push_back({ f.name,f.data.data(),f.data.size() });
+            inputBytes += f.data.size();
+        }
+
+        // 先解一遍：检查文件并打印基本信息，也让查找表在计时前初始化好
+        for (const auto& source : sources)
+        {
+            const auto image = ImageLoader::LoadFromMemory(source, options);
+            std::cout << source.name << ": " << image.GetWidth() << "x" << image.GetHeight()
+                      << ", " << image.GetMipCount() << " mips, " << image.GetDataSize() << " bytes" << std::endl;
+        }
+        const auto single = Measure(iterations, [&]() {
+            std::size_t bytes = 0u;
+            for (const auto& source : sources)
+            {
+                bytes += ImageLoader::LoadFromMemory(source, options).GetDataSize();
+            }
+            return bytes;
+        });
+        const auto parallel = Measure(iterations, [&]() {
+            std::size_t bytes = 0u;
+            for (const auto& image : ImageLoader::LoadMany(pool, sources, options))
+            {
+                bytes += image.GetDataSize();
+            }
+            return bytes;
+        });
+        std::cout << files.size() << " files, " << inputBytes << " bytes, " << iterations << " iterations, "
+                  << (options.generateMips ? (options.mipFilter == MipFilter::Kaiser ? "kaiser" : "box") : "no")
+                  << " mips" << std::endl;
+        Report("1 thread", single, inputBytes, iterations);
+        Report((std::to_string(pool.GetWorkerCount() + 1u) + " threads").c_str(), parallel, inputBytes, iterations);
+        if (compression != TextureCompression::None)
+        {
+            std::vector<Image> images;
+            for (const auto& source : sources)
+            {
+                images.push_back(ImageLoader::LoadFromMemory(source, options));
+                if (Image::IsCompressed(images.back().GetFormat()))
+                {
+                    std::cerr << source.name << " is already block compressed" << std::endl;
+                    return 1;
+                }
+            }
+            static const char* const qualityNames[] = { "fast","normal","high" };
+            std::cout << "block compression, " << qualityNames[int(quality)] << " quality" << std::endl;
+            BenchCompression(images, compression, quality, iterations, pool);
+        }
+        std::cout << (failures == 0 ? "all checks passed" : "some checks FAILED") << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
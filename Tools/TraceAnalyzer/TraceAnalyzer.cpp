@@ -0,0 +1,229 @@
+// 读取 TryDirectX11 用 --trace=path 录下的图形调用 trace，报告：
+// 冗余绑定（绑定的对象和参数与该槽位当前状态相同）、常量缓冲上传字节数、
+// 按管线状态（VS/PS/InputLayout/Topology）统计的 draw 数、以及相邻两次 draw 之间的状态变化次数直方图。
+// usage: TraceAnalyzer <trace file> [--top N]
+#include "TraceFormat.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    struct OpStats
+    {
+        unsigned long long binds = 0u;
+        unsigned long long redundant = 0u;
+    };
+
+    struct SlotState
+    {
+        std::uint64_t object;
+        std::uint32_t arg;
+    };
+
+    // VS, PS, InputLayout, Topology
+    using PipelineKey = std::tuple<std::uint64_t, std::uint64_t, std::uint64_t, std::uint32_t>;
+
+    bool ReadTrace(const std::string& path, std::vector<TraceRecord>& records)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "cannot open " << path << std::endl;
+            return false;
+        }
+        TraceHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, traceMagic, sizeof(traceMagic)) != 0)
+        {
+            std::cerr << path << " is not a graphics trace" << std::endl;
+            return false;
+        }
+        if (header.version != traceVersion || header.recordSize != sizeof(TraceRecord))
+        {
+            std::cerr << path << ": unsupported trace version " << header.version
+                      << " (expected " << traceVersion << ")" << std::endl;
+            return false;
+        }
+        TraceRecord r;
+        while (file.read(reinterpret_cast<char*>(&r), sizeof(r)))
+        {
+            records.push_back(r);
+        }
+        if (file.gcount() != 0)
+        {
+            std::cerr << "warning: ignoring truncated record at end of trace" << std::endl;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: TraceAnalyzer <trace file> [--top N]" << std::endl;
+        return 1;
+    }
+    std::size_t top = 10u;
+    for (int i = 2; i + 1 < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--top") == 0)
+        {
+            top = std::stoul(argv[++i]);
+        }
+    }
+    std::vector<TraceRecord> records;
+    if (!ReadTrace(argv[1], records))
+    {
+        return 1;
+    }
+
+    const auto nOps = std::size_t(TraceBindOp::Count);
+    std::vector<OpStats> opStats(nOps);
+    // (op, slot) -> current state; D3D11 state carries over between frames, so this does too
+    std::map<std::pair<std::size_t, std::uint32_t>, SlotState> state;
+    std::map<PipelineKey, unsigned long long> drawsPerPipeline;
+    // number of effective state changes since the previous draw -> how many draws saw that many
+    std::map<unsigned int, unsigned long long> changeHistogram;
+    unsigned long long frames = 0u;
+    // 记录数超过 GraphicsTrace::maxRecordsPerFrame、后面的调用没记下来的帧
+    unsigned long long truncatedFrames = 0u;
+    unsigned long long draws = 0u;
+    unsigned long long indices = 0u;
+    unsigned long long maps = 0u;
+    unsigned long long mapBytes = 0u;
+    unsigned int changesSinceDraw = 0u;
+
+    const auto current = [&state](TraceBindOp op) {
+        const auto it = state.find({ std::size_t(op), 0u });
+        return it == state.end() ? SlotState{ 0u,0u } : it->second;
+    };
+
+    for (const auto& r : records)
+    {
+        switch (r.kind)
+        {
+        case TraceRecordKind::Bind:
+        {
+            if (std::size_t(r.op) >= nOps)
+            {
+                std::cerr << "warning: unknown bind op " << int(r.op) << std::endl;
+                break;
+            }
+            // 常量缓冲、纹理、采样器按槽位区分，其他状态只有一个槽，arg 是状态的一部分（stride、格式、拓扑）
+            const bool perSlot = r.op == TraceBindOp::VertexConstantBuffer || r.op == TraceBindOp::PixelConstantBuffer ||
+                r.op == TraceBindOp::PixelShaderResource || r.op == TraceBindOp::PixelSampler;
+            const auto key = std::make_pair(std::size_t(r.op), perSlot ? r.arg : 0u);
+            const SlotState value = { r.object, perSlot ? 0u : r.arg };
+            auto& stats = opStats[std::size_t(r.op)];
+            stats.binds++;
+            const auto it = state.find(key);
+            if (it != state.end() && it->second.object == value.object && it->second.arg == value.arg)
+            {
+                stats.redundant++;
+            }
+            else
+            {
+                state[key] = value;
+                changesSinceDraw++;
+            }
+            break;
+        }
+        case TraceRecordKind::Map:
+            maps++;
+            mapBytes += r.arg;
+            break;
+        case TraceRecordKind::Draw:
+        {
+            draws++;
+            indices += r.arg;
+            const PipelineKey pipeline = {
+                current(TraceBindOp::VertexShader).object,
+                current(TraceBindOp::PixelShader).object,
+                current(TraceBindOp::InputLayout).object,
+                current(TraceBindOp::Topology).arg
+            };
+            drawsPerPipeline[pipeline]++;
+            changeHistogram[changesSinceDraw]++;
+            changesSinceDraw = 0u;
+            break;
+        }
+        case TraceRecordKind::FrameEnd:
+            frames++;
+            truncatedFrames += r.arg != 0u ? 1u : 0u;
+            break;
+        default:
+            std::cerr << "warning: unknown record kind " << int(r.kind) << std::endl;
+            break;
+        }
+    }
+
+    const auto perFrame = [frames](unsigned long long n) {
+        return frames == 0u ? 0.0 : double(n) / double(frames);
+    };
+    unsigned long long binds = 0u;
+    unsigned long long redundant = 0u;
+    for (const auto& s : opStats)
+    {
+        binds += s.binds;
+        redundant += s.redundant;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "frames          " << frames << " (" << truncatedFrames << " truncated)" << std::endl
+              << "draws           " << draws << " (" << perFrame(draws) << "/frame, "
+              << perFrame(indices) << " indices/frame)" << std::endl
+              << "binds           " << binds << " (" << perFrame(binds) << "/frame)" << std::endl
+              << "redundant binds " << redundant << " ("
+              << (binds == 0u ? 0.0 : 100.0 * double(redundant) / double(binds)) << "%)" << std::endl
+              << "cbuffer maps    " << maps << " (" << perFrame(maps) << "/frame, "
+              << perFrame(mapBytes) << " bytes/frame, " << mapBytes << " bytes total)" << std::endl;
+
+    std::cout << std::endl << "binds by type" << std::endl;
+    for (std::size_t i = 0u; i < nOps; i++)
+    {
+        if (opStats[i].binds == 0u)
+        {
+            continue;
+        }
+        std::cout << "  " << std::left << std::setw(22) << traceBindOpNames[i] << std::right
+                  << std::setw(10) << opStats[i].binds
+                  << std::setw(10) << opStats[i].redundant << " redundant ("
+                  << 100.0 * double(opStats[i].redundant) / double(opStats[i].binds) << "%)" << std::endl;
+    }
+
+    std::vector<std::pair<PipelineKey, unsigned long long>> pipelines(drawsPerPipeline.begin(), drawsPerPipeline.end());
+    std::sort(pipelines.begin(), pipelines.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    std::cout << std::endl << "draws per pipeline state (" << pipelines.size() << " distinct, top " << top << ")" << std::endl;
+    for (std::size_t i = 0u; i < std::min(top, pipelines.size()); i++)
+    {
+        const auto& [key, count] = pipelines[i];
+        char line[160];
+        std::snprintf(line, sizeof(line), "  VS %016llx PS %016llx IL %016llx topo %2u : %llu draws",
+                      (unsigned long long)std::get<0>(key), (unsigned long long)std::get<1>(key),
+                      (unsigned long long)std::get<2>(key), std::get<3>(key), count);
+        std::cout << line << std::endl;
+    }
+
+    std::cout << std::endl << "state changes before each draw" << std::endl;
+    unsigned long long peak = 0u;
+    for (const auto& [changes, count] : changeHistogram)
+    {
+        peak = std::max(peak, count);
+    }
+    constexpr unsigned long long barWidth = 50u;
+    for (const auto& [changes, count] : changeHistogram)
+    {
+        std::cout << "  " << std::setw(3) << changes << " |" << std::string(std::size_t(count * barWidth / peak), '#')
+                  << " " << count << std::endl;
+    }
+    return 0;
+}
@@ -1,21 +1,179 @@
 #include "App.h"
 #include "Box.h"
+#include "GltfLoader.h"
+#include "MappedFile.h"
+#include "MemoryTracker.h"
+#include "Mesh.h"
+#include "MeshImporter.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "ModelPart.h"
+#include "PerfCounters.h"
+#include "PerfHud.h"
+#include "SceneComponents.h"
+#include "SceneSnapshot.h"
+#include "SceneSystems.h"
 #include <memory>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 
-App::App()
+namespace {
+    // value of "--name=value" in the command line, empty if absent (values cannot contain spaces)
+    std::string GetOption(const std::string &commandLine, const std::string &name) {
+        const auto key = "--" + name + "=";
+        const auto pos = commandLine.find(key);
+        if (pos == std::string::npos) {
+            return {};
+        }
+        const auto begin = pos + key.size();
+        return commandLine.substr(begin, commandLine.find(' ', begin) - begin);
+    }
+
+    // "--memory-budget=Scene:64,Bindables:8"，单位 MB
+    void ApplyMemoryBudgets(const std::string &option) {
+        for (size_t begin = 0u; begin < option.size();) {
+            auto end = option.find(',', begin);
+            if (end == std::string::npos) {
+                end = option.size();
+            }
+            const auto entry = option.substr(begin, end - begin);
+            const auto colon = entry.find(':');
+            for (size_t t = 0u; colon != std::string::npos && t < size_t(MemoryTag::Count); t++) {
+                if (entry.compare(0u, colon, MemoryTracker::GetTagName(MemoryTag(t))) == 0) {
+                    MemoryTracker::SetBudget(MemoryTag(t), std::stoll(entry.substr(colon + 1u)) * 1024 * 1024);
+                }
+            }
+            begin = end + 1u;
+        }
+    }
+
+    // "--lods=0.5,0.25"：每一级占原网格三角形数的比例；没给时 0.5,0.25,0.125，"none" 不生成
+    std::vector<float> ParseLodRatios(const std::string &option) {
+        if (option.empty()) {
+            return {0.5f, 0.25f, 0.125f};
+        }
+        std::vector<float> ratios;
+        for (size_t begin = 0u; option != "none" && begin < option.size();) {
+            auto end = option.find(',', begin);
+            if (end == std::string::npos) {
+                end = option.size();
+            }
+            ratios.push_back(std::stof(option.substr(begin, end - begin)));
+            begin = end + 1u;
+        }
+        return ratios;
+    }
+
+    // 包围盒中心移到原点，对角线的一半缩放到 radius
+    DirectX::XMMATRIX FitBounds(const float (&boundsMin)[3], const float (&boundsMax)[3], float radius) {
+        float center[3];
+        float halfDiagonal = 0.0f;
+        for (int c = 0; c < 3; c++) {
+            center[c] = (boundsMin[c] + boundsMax[c]) * 0.5f;
+            const auto half = (boundsMax[c] - boundsMin[c]) * 0.5f;
+            halfDiagonal += half * half;
+        }
+        halfDiagonal = std::sqrt(halfDiagonal);
+        const auto scale = halfDiagonal > 0.0f ? radius / halfDiagonal : 1.0f;
+        return DirectX::XMMatrixTranslation(-center[0], -center[1], -center[2]) *
+               DirectX::XMMatrixScaling(scale, scale, scale);
+    }
+}
+
+App::App(const std::string &commandLine)
         :
-        wnd(800, 600, _T("学习 DirectX11")) {
-    std::mt19937 rng(std::random_device{}());
+        // 回放时由主线程注入输入，消息泵必须也在主线程上
+        wnd(800, 600, _T("学习 DirectX11"), commandLine.find("--input-thread") != std::string::npos &&
+                                             GetOption(commandLine, "replay").empty()) {
+    Drawable::SetBindStreamEnabled(commandLine.find("--bind-stream") != std::string::npos);
+    wnd.Gfx().GetLatencyTracker().EnableLogging(commandLine.find("--latency-log") != std::string::npos);
+    ApplyMemoryBudgets(GetOption(commandLine, "memory-budget"));
+    std::uint32_t seed;
+    if (const auto replayPath = GetOption(commandLine, "replay"); !replayPath.empty()) {
+        MemoryScope memoryScope(MemoryTag::Recording);
+        pReplayer = std::make_unique<FrameReplayer>(replayPath,
+                GetOption(commandLine, "replay-timing") == "original" ? FrameReplayer::Timing::Original
+                                                                       : FrameReplayer::Timing::Fixed);
+        seed = pReplayer->GetSeed();
+    } else {
+        const auto seedOption = GetOption(commandLine, "seed");
+        seed = seedOption.empty() ? std::random_device{}() : std::uint32_t(std::stoul(seedOption));
+        if (const auto recordPath = GetOption(commandLine, "record"); !recordPath.empty()) {
+            MemoryScope memoryScope(MemoryTag::Recording);
+            pRecorder = std::make_unique<FrameRecorder>(recordPath, seed);
+        }
+    }
+    std::mt19937 rng(seed);
     std::uniform_real_distribution<float> adist(0.0f, 3.1415f * 2.0f);
     std::uniform_real_distribution<float> ddist(0.0f, 3.1415f * 2.0f);
     std::uniform_real_distribution<float> odist(0.0f, 3.1415f * 0.3f);
     std::uniform_real_distribution<float> rdist(6.0f, 20.0f);
-    // 80 个箱子
-    for (auto i = 0; i < 80; i++) {
-        boxes.push_back(std::make_unique<Box>(
-                wnd.Gfx(), rng, adist,
-                ddist, odist, rdist
-        ));
+    {
+        MemoryScope memoryScope(MemoryTag::Bindables);
+        pBox = std::make_unique<Box>(wnd.Gfx());
+        if (commandLine.find("--perf-hud") != std::string::npos) {
+            pPerfHud = std::make_unique<PerfHud>(wnd.Gfx());
+        }
+    }
+    if (const auto modelPath = GetOption(commandLine, "model"); !modelPath.empty()) {
+        LodSettings lodSettings;
+        if (const auto pixelError = GetOption(commandLine, "lod-pixel-error"); !pixelError.empty()) {
+            lodSettings.pixelError = std::stof(pixelError);
+        }
+        if (const auto fade = GetOption(commandLine, "lod-fade"); !fade.empty()) {
+            lodSettings.fadeSeconds = std::stof(fade);
+        }
+        LoadModel(modelPath, ParseLodRatios(GetOption(commandLine, "lods")), lodSettings,
+                  GetOption(commandLine, "meshlet-culling") == "on");
+    }
+    {
+        MemoryScope memoryScope(MemoryTag::Scene);
+        if (const auto scenePath = GetOption(commandLine, "load-scene"); !scenePath.empty()) {
+            const auto start = std::chrono::steady_clock::now();
+            const MappedFile file(scenePath);
+            const auto count = SceneSnapshot::Load(file.GetData(), file.GetSize(), scenePath, world);
+            const auto ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+            char line[160];
+            std::snprintf(line, sizeof(line), "[Scene] loaded %zu entities from %s in %.2f ms\n",
+                          count, scenePath.c_str(), ms);
+            OutputDebugStringA(line);
+        } else {
+            // 默认 80 个箱子；加载了 glTF 场景时默认不要箱子
+            const auto gltfPath = GetOption(commandLine, "gltf");
+            if (!gltfPath.empty()) {
+                LoadGltf(gltfPath);
+            }
+            const auto countOption = GetOption(commandLine, "box-count");
+            const size_t count = countOption.empty() ? (gltfPath.empty() ? 80u : 0u) : std::stoul(countOption);
+            world.CreateMany<BoxMotion, WorldTransform, BoxInstance>(count,
+                    [&](size_t, BoxMotion &motion, WorldTransform &transform, BoxInstance &) {
+                        motion = BoxMotion::Random(rng, adist, ddist, odist, rdist);
+                        DirectX::XMStoreFloat4x4(&transform.matrix, motion.GetTransformXM());
+                    });
+        }
+        // 在箱子之后取随机数，箱子的布局和不加模型时一样
+        if (const auto countOption = GetOption(commandLine, "model-count"); pModel && !countOption.empty()) {
+            world.CreateMany<BoxMotion, WorldTransform, MeshInstance>(std::stoul(countOption),
+                    [&](size_t, BoxMotion &motion, WorldTransform &transform, MeshInstance &instance) {
+                        motion = BoxMotion::Random(rng, adist, ddist, odist, rdist);
+                        DirectX::XMStoreFloat4x4(&transform.matrix, motion.GetTransformXM());
+                        // CreateMany 不构造组件，LOD 状态要从第 0 级、不在淡入淡出开始
+                        instance = {};
+                    });
+        }
+        if (const auto scenePath = GetOption(commandLine, "save-scene"); !scenePath.empty()) {
+            SceneSnapshot::Save(scenePath, world);
+        }
+    }
+    if (const auto dumpPath = GetOption(commandLine, "perf-dump"); !dumpPath.empty()) {
+        const auto intervalOption = GetOption(commandLine, "perf-dump-interval");
+        PerfCounters::EnableDump(dumpPath, intervalOption.empty() ? 60u : unsigned(std::stoul(intervalOption)));
+    }
+    if (const auto tracePath = GetOption(commandLine, "trace"); !tracePath.empty()) {
+        const auto framesOption = GetOption(commandLine, "trace-frames");
+        wnd.Gfx().BeginTrace(tracePath, framesOption.empty() ? 60u : std::stoull(framesOption));
     }
     // 由于 CPU 中矩阵通常是行主序的，但 HLSL 中默认是列主序的，如果不想在 shader 里面转置，就要在传数据前转置一下。
     wnd.Gfx().SetProjection(
@@ -31,18 +189,214 @@ int App::Go() {
             // if return optional has value, means we're quitting so return exit code
             return *ecode;
         }
+        if (pReplayer && pReplayer->IsFinished()) {
+            return 0;
+        }
         DoFrame();
     }
 }
 
-App::~App() {}
+App::~App() {
+    OutputDebugStringA(wnd.Gfx().GetLatencyTracker().GetReport().c_str());
+    OutputDebugStringA(MemoryTracker::GetReport().c_str());
+    if (pReplayer) {
+        OutputDebugStringA(pReplayer->GetReport().c_str());
+    }
+}
 
 void App::DoFrame() {
+#ifndef NDEBUG
+    const auto allocationsBefore = MemoryTracker::GetThreadAllocationCount();
+#endif
     auto dt = timer.Mark();
+    if (pReplayer) {
+        // 丢掉真实输入，换成录制的这一帧
+        wnd.kbd.Flush();
+        wnd.mouse.Flush();
+        if (!pReplayer->NextFrame(dt, wnd.kbd, wnd.mouse)) {
+            return;
+        }
+    } else if (pRecorder) {
+        pRecorder->BeginFrame(dt);
+    }
+    ConsumeInput();
     wnd.Gfx().ClearBuffer(0.07f, 0.0f, 0.12f);
-    for (auto &b : boxes) {
-        b->Update(dt);
-        b->Draw(wnd.Gfx());
+    AnimateBoxes(world, threadPool, dt);
+    DrawBoxes(world, wnd.Gfx(), *pBox);
+    DrawModels(world, wnd.Gfx(), modelParts);
+    if (pModel) {
+        DrawMeshes(world, wnd.Gfx(), *pModel, DirectX::XMLoadFloat4x4(&modelInstanceFit), dt);
+        modelAngle += dt * 0.5f;
+        pModel->DrawInstance(wnd.Gfx(), DirectX::XMLoadFloat4x4(&modelFit) *
+                                        DirectX::XMMatrixRotationY(modelAngle) *
+                                        DirectX::XMMatrixTranslation(0.0f, 0.0f, 12.0f), modelLod, dt);
+    }
+    // 精灵没有混合、z 是 0，最后画就盖在场景上面
+    if (pPerfHud) {
+        pPerfHud->Draw(wnd.Gfx(), dt * 1000.0f);
     }
     wnd.Gfx().EndFrame();
+    if (pRecorder) {
+        pRecorder->EndFrame();
+    }
+    PerfCounters::Set(PerfCounter::FrameTimeMs, dt * 1000.0f);
+    PerfCounters::Set(PerfCounter::Entities, double(world.GetEntityCount()));
+    PerfCounters::EndFrame();
+    MemoryTracker::EndFrame();
+    // 标题栏读数，半秒刷新一次
+    if (titleTimer.Peek() >= 0.5f) {
+        titleTimer.Mark();
+        char title[160] = "DirectX11 | ";
+        PerfCounters::FormatSummary(title + std::strlen(title), sizeof(title) - std::strlen(title));
+        wnd.SetTitle(title);
+        CheckMemoryBudgets();
+    }
+#ifndef NDEBUG
+    // 预热之后的帧不应该再走通用堆，每帧的临时数据用 FrameMemory
+    const auto frameAllocations = MemoryTracker::GetThreadAllocationCount() - allocationsBefore;
+    if (frameAllocations != 0u && wnd.Gfx().GetFrameId() > warmupFrames) {
+        char line[96];
+        std::snprintf(line, sizeof(line), "[FrameMemory] frame %llu made %llu heap allocations\n",
+                      wnd.Gfx().GetFrameId() - 1u, frameAllocations);
+        OutputDebugStringA(line);
+    }
+#endif
+}
+
+void App::LoadModel(const std::string &path, const std::vector<float> &lodRatios, const LodSettings &lodSettings,
+                    bool meshletCulling) {
+    MemoryScope memoryScope(MemoryTag::Meshes);
+    const auto start = std::chrono::steady_clock::now();
+    MeshData data;
+    {
+        // 映射只在解析期间需要，解析完的 MeshData 自己持有数据
+        const MappedFile file(path);
+        data = MeshImporter::Import(file.GetData(), file.GetSize(), path, {}, &threadPool);
+    }
+    const auto parsed = std::chrono::steady_clock::now();
+    MeshSimplifier::BuildLods(data, lodRatios, {}, &threadPool);
+    const auto simplified = std::chrono::steady_clock::now();
+    if (meshletCulling) {
+        // 要在 BuildLods 之后：各级 LOD 也要分簇
+        MeshletBuilder::BuildAll(data, {}, &threadPool);
+    }
+    const auto clustered = std::chrono::steady_clock::now();
+    pModel = std::make_unique<Mesh>(wnd.Gfx(), data, lodSettings);
+    const auto created = std::chrono::steady_clock::now();
+
+    DirectX::XMStoreFloat4x4(&modelFit, FitBounds(data.boundsMin, data.boundsMax, modelRadius));
+    DirectX::XMStoreFloat4x4(&modelInstanceFit, FitBounds(data.boundsMin, data.boundsMax, modelInstanceRadius));
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "[Mesh] %s: %zu vertices, %zu triangles, parsed in %.1f ms, LODs in %.1f ms, buffers in %.1f ms\n",
+                  path.c_str(), data.vertices.size(), data.GetTriangleCount(),
+                  std::chrono::duration<float, std::milli>(parsed - start).count(),
+                  std::chrono::duration<float, std::milli>(simplified - parsed).count(),
+                  std::chrono::duration<float, std::milli>(created - clustered).count());
+    OutputDebugStringA(line);
+    if (meshletCulling) {
+        size_t meshletCount = data.meshlets.size();
+        for (const auto &lod : data.lods) {
+            meshletCount += lod.meshlets.size();
+        }
+        std::snprintf(line, sizeof(line), "[Mesh]   %zu meshlets (%zu in LOD 0) in %.1f ms\n", meshletCount, data.meshlets.size(),
+                      std::chrono::duration<float, std::milli>(clustered - simplified).count());
+        OutputDebugStringA(line);
+    }
+    for (size_t l = 0u; l < data.lods.size(); l++) {
+        const auto &lod = data.lods[l];
+        std::snprintf(line, sizeof(line), "[Mesh]   LOD %zu: %zu triangles (%.1f%%), error %.4f of the model size\n",
+                      l + 1u, lod.GetTriangleCount(), 100.0 * double(lod.GetTriangleCount()) / double(data.GetTriangleCount()),
+                      lod.error);
+        OutputDebugStringA(line);
+    }
+}
+
+void App::LoadGltf(const std::string &path) {
+    const auto start = std::chrono::steady_clock::now();
+    const MappedFile file(path);
+    GltfScene scene;
+    {
+        MemoryScope memoryScope(MemoryTag::Meshes);
+        scene = GltfLoader::Load(file.GetData(), file.GetSize(), path, &threadPool);
+    }
+    const auto parsed = std::chrono::steady_clock::now();
+    // BindPool 和 DxgiInfoManager 不是线程安全的，缓冲在主线程上逐个创建；零拷贝的缓冲直接从映射的文件读
+    modelParts.resize(scene.geometries.size());
+    for (size_t g = 0u; g < scene.geometries.size(); g++) {
+        const auto &geometry = scene.geometries[g];
+        if (geometry.GetVertexCount() > 0u && geometry.GetIndexCount() > 0u) {
+            modelParts[g] = std::make_unique<ModelPart>(wnd.Gfx(), geometry);
+        }
+    }
+    const auto created = std::chrono::steady_clock::now();
+
+    // 整个场景放到箱子原来所在的位置
+    const auto fit = FitBounds(scene.boundsMin, scene.boundsMax, sceneRadius) *
+                     DirectX::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
+    std::vector<const GltfInstance *> instances;
+    for (const auto &instance : scene.instances) {
+        if (modelParts[instance.geometry]) {
+            instances.push_back(&instance);
+        }
+    }
+    world.CreateMany<WorldTransform, ModelInstance>(instances.size(),
+            [&](size_t i, WorldTransform &transform, ModelInstance &model) {
+                const auto &instance = *instances[i];
+                DirectX::XMStoreFloat4x4(&transform.matrix,
+                                         DirectX::XMLoadFloat4x4(
+                                                 reinterpret_cast<const DirectX::XMFLOAT4X4 *>(instance.world)) * fit);
+                model.part = instance.geometry;
+            });
+
+    const auto &stats = scene.stats;
+    char line[320];
+    std::snprintf(line, sizeof(line),
+                  "[glTF] %s: %zu/%zu nodes, %zu/%zu meshes, %zu instances, %.1f MB in place, %.1f MB decoded, "
+                  "parsed in %.1f ms, buffers in %.1f ms\n",
+                  path.c_str(), stats.nodesUsed, stats.nodes, stats.meshesUsed, stats.meshes, instances.size(),
+                  stats.bytesInPlace / 1048576.0, stats.bytesDecoded / 1048576.0,
+                  std::chrono::duration<float, std::milli>(parsed - start).count(),
+                  std::chrono::duration<float, std::milli>(created - parsed).count());
+    OutputDebugStringA(line);
+}
+
+void App::CheckMemoryBudgets() noexcept {
+    // 每个标签越过预算时报一次，回落后再越过会再报
+    for (unsigned int t = 0u; t < unsigned(MemoryTag::Count); t++) {
+        const auto usage = MemoryTracker::GetUsage(MemoryTag(t));
+        const auto bit = 1u << t;
+        if (usage.IsOverBudget() && !(overBudgetTags & bit)) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "[Memory] %s over budget: %lld KB of %lld KB\n",
+                          MemoryTracker::GetTagName(MemoryTag(t)), usage.GetTotalBytes() / 1024,
+                          usage.budgetBytes / 1024);
+            OutputDebugStringA(line);
+        }
+        overBudgetTags = usage.IsOverBudget() ? overBudgetTags | bit : overBudgetTags & ~bit;
+    }
+}
+
+void App::ConsumeInput() {
+    // 把本帧读到的输入登记到当前帧号上，Present 时就能算出最新输入到 Present 的延迟
+    auto &latency = wnd.Gfx().GetLatencyTracker();
+    const auto frameId = wnd.Gfx().GetFrameId();
+    for (auto e = wnd.kbd.ReadKey(); e.IsValid(); e = wnd.kbd.ReadKey()) {
+        latency.OnInputConsumed(frameId, e.GetTimestamp());
+        if (pRecorder) {
+            pRecorder->RecordKey(e);
+        }
+    }
+    while (!wnd.kbd.CharIsEmpty()) {
+        const auto c = wnd.kbd.ReadChar();
+        if (pRecorder) {
+            pRecorder->RecordChar(c);
+        }
+    }
+    for (auto e = wnd.mouse.Read(); e.IsValid(); e = wnd.mouse.Read()) {
+        latency.OnInputConsumed(frameId, e.GetTimestamp());
+        if (pRecorder) {
+            pRecorder->RecordMouse(e);
+        }
+    }
 }
@@ -1,18 +1,70 @@
 #pragma once
 #include "Window.h"
 #include "ChiliTimer.h"
+#include "Ecs.h"
+#include "FrameRecording.h"
+#include "LodSelector.h"
 
 class App
 {
 public:
-	App();
+	// commandLine: "--input-thread" runs the window message pump on its own thread,
+	// "--bind-stream" executes compiled bind streams instead of the per-bindable Bind calls (off by default, it measured slower),
+	// "--latency-log" writes every frame's input latency to the debugger output (the histogram is always written on exit),
+	// "--box-count=N" spawns N random boxes (default 80),
+	// "--load-scene=path" loads boxes from a scene snapshot instead, "--save-scene=path" writes the scene after startup,
+	// "--seed=N" fixes the scene seed, "--record=path" records seed, frame times and input,
+	// "--replay=path" replays a recording and exits at its end ("--replay-timing=original" paces frames like the recording),
+	// "--trace=path" captures a graphics trace of the first "--trace-frames=N" frames (default 60),
+	// "--perf-hud" draws a frame time graph over the scene with the sprite batch,
+	// "--perf-dump=path" writes perf counters every "--perf-dump-interval=N" frames (default 60; .json for JSON Lines, else CSV),
+	// "--memory-budget=Tag:MB,..." sets per-tag memory budgets (see MemoryTag); the per-tag breakdown is dumped on exit,
+	// "--model=path" imports an OBJ / PLY file on the thread pool and shows it spinning in front of the camera,
+	// "--lods=0.5,0.25,..." sets the triangle ratios of its simplified LODs (default 0.5,0.25,0.125; "none" for no LODs),
+	// "--model-count=N" also puts N smaller copies of it on box orbits (default 0),
+	// "--lod-pixel-error=P" picks the coarsest LOD whose error stays within P pixels on screen (default 1),
+	// "--lod-fade=S" cross-fades LOD switches over S seconds (default 0.25, 0 switches instantly),
+	// "--meshlet-culling=on" splits it and its LODs into meshlets and culls them on the CPU every draw (frustum and normal cone),
+	// "--gltf=path" loads the default scene of a .glb file in place of the random boxes
+	App(const std::string& commandLine = "");
 	// master frame / message loop
 	int Go();
 	~App();
 private:
 	void DoFrame();
+	void ConsumeInput();
+	void CheckMemoryBudgets() noexcept;
+	void LoadModel(const std::string& path, const std::vector<float>& lodRatios, const LodSettings& lodSettings,
+		bool meshletCulling);
+	// scene entities go into world, in the Scene memory scope of the caller
+	void LoadGltf(const std::string& path);
 private:
+	// frames allowed to allocate from the heap while caches and arenas grow
+	static constexpr unsigned long long warmupFrames = 8u;
+	static constexpr float modelRadius = 3.0f;
+	static constexpr float modelInstanceRadius = 1.0f;
+	static constexpr float sceneRadius = 12.0f;
 	Window wnd;
 	ChiliTimer timer;
-	std::vector<std::unique_ptr<class Box>> boxes;
+	ChiliTimer titleTimer;
+	ThreadPool threadPool;
+	// 场景里的实体；所有箱子共用一个 Box 绘制
+	World world;
+	std::unique_ptr<class Box> pBox;
+	// --perf-hud
+	std::unique_ptr<class PerfHud> pPerfHud;
+	// --model, scaled to fit a sphere of radius modelRadius
+	std::unique_ptr<class Mesh> pModel;
+	DirectX::XMFLOAT4X4 modelFit;
+	// same for the MeshInstance entities, radius modelInstanceRadius
+	DirectX::XMFLOAT4X4 modelInstanceFit;
+	float modelAngle = 0.0f;
+	LodState modelLod;
+	// --gltf, one per primitive (nullptr for empty ones); instances are ModelInstance entities
+	std::vector<std::unique_ptr<class ModelPart>> modelParts;
+	// at most one of these is active
+	std::unique_ptr<FrameRecorder> pRecorder;
+	std::unique_ptr<FrameReplayer> pReplayer;
+	// bit t set while MemoryTag(t) is over its budget
+	unsigned int overBudgetTags = 0u;
 };
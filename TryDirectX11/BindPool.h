@@ -0,0 +1,10 @@
+#pragma once
+#include "BindPoolCore.h"
+#include "Graphics.h"
+
+class BindStream;
+
+// 引擎里的 Bindable 绑定到 Graphics、录进 BindStream
+using BindRegistry = BasicBindRegistry<Graphics, BindStream>;
+template<class T>
+using BindPool = BasicBindPool<T, BindRegistry>;
@@ -0,0 +1,175 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// BindPool 里和 D3D 无关的部分：句柄、按类型的函数表、每个类型的连续存储。
+// 设备上下文和命令流的类型是模板参数，引擎用 Graphics / BindStream（见 BindPool.h），Tools/BindBench 用它的替身，两边跑的是同一份代码。
+
+// 指向某个 BindPool 槽位的 32 位句柄：
+// 低 20 位是槽位下标，接着 6 位是代数（槽位被回收再利用时加一，用来发现悬空句柄），最高 6 位是类型编号。
+class BindHandle
+{
+public:
+    static constexpr unsigned int indexBits = 20u;
+    static constexpr unsigned int generationBits = 6u;
+    static constexpr unsigned int typeBits = 6u;
+    BindHandle() = default;
+    BindHandle(std::uint32_t type, std::uint32_t index, std::uint32_t generation) noexcept
+        :
+        value((type << (indexBits + generationBits)) |
+            ((generation & generationMask) << indexBits) |
+            (index & indexMask))
+    {}
+    bool IsValid() const noexcept
+    {
+        return value != invalid;
+    }
+    std::uint32_t GetIndex() const noexcept
+    {
+        return value & indexMask;
+    }
+    std::uint32_t GetGeneration() const noexcept
+    {
+        return (value >> indexBits) & generationMask;
+    }
+    std::uint32_t GetType() const noexcept
+    {
+        return value >> (indexBits + generationBits);
+    }
+    bool operator==(BindHandle rhs) const noexcept
+    {
+        return value == rhs.value;
+    }
+    bool operator!=(BindHandle rhs) const noexcept
+    {
+        return value != rhs.value;
+    }
+private:
+    static constexpr std::uint32_t indexMask = (1u << indexBits) - 1u;
+    static constexpr std::uint32_t generationMask = (1u << generationBits) - 1u;
+    static constexpr std::uint32_t invalid = 0xFFFFFFFFu;
+    std::uint32_t value = invalid;
+};
+
+// 每种具体的 Bindable 类型注册一组函数，句柄里的类型编号就是这张表的下标。
+// 通过表分发时调用的是具体类型的 Bind（非虚调用），对象本身则连续存放在各自的 BindPool 里。
+template<class C, class S>
+class BasicBindRegistry
+{
+public:
+    using Context = C;
+    using Stream = S;
+    using BindFn = void(*)(std::uint32_t index, Context& context) noexcept;
+    using RecordFn = void(*)(std::uint32_t index, Stream& stream);
+    using ReleaseFn = void(*)(BindHandle handle) noexcept;
+    static constexpr std::uint32_t maxTypes = 1u << BindHandle::typeBits;
+    static std::uint32_t Register(BindFn bind, RecordFn record, ReleaseFn release) noexcept
+    {
+        // 只在每种类型第一次 Emplace 时调用一次（BindPool<T>::TypeId 里的函数内静态变量）
+        assert("Too many bindable types for BindHandle::typeBits" && nTypes < maxTypes);
+        table[nTypes] = { bind, record, release };
+        return nTypes++;
+    }
+    static void Bind(BindHandle handle, Context& context) noexcept
+    {
+        table[handle.GetType()].bind(handle.GetIndex(), context);
+    }
+    static void Record(BindHandle handle, Stream& stream)
+    {
+        table[handle.GetType()].record(handle.GetIndex(), stream);
+    }
+    static void Release(BindHandle handle) noexcept
+    {
+        table[handle.GetType()].release(handle);
+    }
+private:
+    struct Entry
+    {
+        BindFn bind;
+        RecordFn record;
+        ReleaseFn release;
+    };
+    static std::array<Entry, maxTypes> table;
+    static std::uint32_t nTypes;
+};
+
+template<class C, class S>
+std::array<typename BasicBindRegistry<C, S>::Entry, BasicBindRegistry<C, S>::maxTypes> BasicBindRegistry<C, S>::table = {};
+template<class C, class S>
+std::uint32_t BasicBindRegistry<C, S>::nTypes = 0u;
+
+// 一种具体 Bindable 类型的连续存储。和 DrawableBase 的 staticBinds 一样，每个类型一份静态存储。
+// 注意：Emplace 可能让 vector 扩容，之前 Get 拿到的引用会失效，只能长期保存句柄；不是线程安全的。
+template<class T, class Registry>
+class BasicBindPool
+{
+public:
+    template<typename... Args>
+    static BindHandle Emplace(Args&&... args)
+    {
+        std::uint32_t index;
+        if (!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            assert("BindPool is full" && slots.size() < (1u << BindHandle::indexBits));
+            index = std::uint32_t(slots.size());
+            slots.emplace_back();
+        }
+        auto& slot = slots[index];
+        slot.object.emplace(std::forward<Args>(args)...);
+        return BindHandle(TypeId(), index, slot.generation);
+    }
+    static T& Get(BindHandle handle) noexcept
+    {
+        assert("Handle refers to another bindable type" && Owns(handle));
+        auto& slot = slots[handle.GetIndex()];
+        assert("Stale bindable handle" && slot.object && handle.GetGeneration() == (slot.generation & ((1u << BindHandle::generationBits) - 1u)));
+        return *slot.object;
+    }
+    static bool Owns(BindHandle handle) noexcept
+    {
+        return handle.IsValid() && handle.GetType() == TypeId();
+    }
+    static void Release(BindHandle handle) noexcept
+    {
+        auto& slot = slots[handle.GetIndex()];
+        slot.object.reset();
+        slot.generation++;
+        freeSlots.push_back(handle.GetIndex());
+    }
+    static std::uint32_t TypeId() noexcept
+    {
+        static const auto id = Registry::Register(&BindAt, &RecordAt, &Release);
+        return id;
+    }
+private:
+    static void BindAt(std::uint32_t index, typename Registry::Context& context) noexcept
+    {
+        // 限定名调用，编译器直接调用 T::Bind，不走虚表
+        slots[index].object->T::Bind(context);
+    }
+    static void RecordAt(std::uint32_t index, typename Registry::Stream& stream)
+    {
+        slots[index].object->T::Record(stream);
+    }
+private:
+    struct Slot
+    {
+        std::optional<T> object;
+        std::uint32_t generation = 0u;
+    };
+    static std::vector<Slot> slots;
+    static std::vector<std::uint32_t> freeSlots;
+};
+
+template<class T, class Registry>
+std::vector<typename BasicBindPool<T, Registry>::Slot> BasicBindPool<T, Registry>::slots;
+template<class T, class Registry>
+std::vector<std::uint32_t> BasicBindPool<T, Registry>::freeSlots;
@@ -0,0 +1,178 @@
+#include "BindStream.h"
+#include "GraphicsTrace.h"
+#include "PerfCounters.h"
+#include "TransformCbuf.h"
+
+void BindStream::PushVertexBuffer(ID3D11Buffer* pBuffer, UINT stride)
+{
+    Push(Op::VertexBuffer, stride, pBuffer);
+}
+
+void BindStream::PushIndexBuffer(ID3D11Buffer* pBuffer, DXGI_FORMAT format)
+{
+    Push(Op::IndexBuffer, UINT(format), pBuffer);
+}
+
+void BindStream::PushInputLayout(ID3D11InputLayout* pLayout)
+{
+    Push(Op::InputLayout, 0u, pLayout);
+}
+
+void BindStream::PushTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+    Push(Op::Topology, UINT(topology), nullptr);
+}
+
+void BindStream::PushVertexShader(ID3D11VertexShader* pShader)
+{
+    Push(Op::VertexShader, 0u, pShader);
+}
+
+void BindStream::PushPixelShader(ID3D11PixelShader* pShader)
+{
+    Push(Op::PixelShader, 0u, pShader);
+}
+
+void BindStream::PushVertexConstantBuffer(ID3D11Buffer* pBuffer, UINT slot)
+{
+    Push(Op::VertexConstantBuffer, slot, pBuffer);
+}
+
+void BindStream::PushPixelConstantBuffer(ID3D11Buffer* pBuffer, UINT slot)
+{
+    Push(Op::PixelConstantBuffer, slot, pBuffer);
+}
+
+void BindStream::PushPixelShaderResource(ID3D11ShaderResourceView* pView, UINT slot)
+{
+    Push(Op::PixelShaderResource, slot, pView);
+}
+
+void BindStream::PushPixelSampler(ID3D11SamplerState* pSampler, UINT slot)
+{
+    Push(Op::PixelSampler, slot, pSampler);
+}
+
+void BindStream::PushRasterizer(ID3D11RasterizerState* pRasterizer)
+{
+    Push(Op::Rasterizer, 0u, pRasterizer);
+}
+
+void BindStream::PushTransform(const TransformCbuf& cbuf, UINT slot)
+{
+    Push(Op::Transform, slot, const_cast<TransformCbuf*>(&cbuf));
+}
+
+void BindStream::PushStreamedPixelShaderResource(ID3D11ShaderResourceView* const* ppView, UINT slot)
+{
+    Push(Op::StreamedPixelShaderResource, slot, const_cast<ID3D11ShaderResourceView**>(ppView));
+}
+
+void BindStream::Execute(Graphics& gfx) const noexcept
+{
+    const auto pContext = gfx.pContext.Get();
+    PerfCounters::Add(PerfCounter::Binds, std::int64_t(commands.size()));
+    for (const auto& c : commands)
+    {
+        switch (c.op)
+        {
+        case Op::VertexBuffer:
+        {
+            const auto pBuffer = static_cast<ID3D11Buffer*>(c.pObject);
+            const UINT offset = 0u;
+            pContext->IASetVertexBuffers(0u, 1u, &pBuffer, &c.arg, &offset);
+            break;
+        }
+        case Op::IndexBuffer:
+            pContext->IASetIndexBuffer(static_cast<ID3D11Buffer*>(c.pObject), DXGI_FORMAT(c.arg), 0u);
+            break;
+        case Op::InputLayout:
+            pContext->IASetInputLayout(static_cast<ID3D11InputLayout*>(c.pObject));
+            break;
+        case Op::Topology:
+            pContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY(c.arg));
+            break;
+        case Op::VertexShader:
+            pContext->VSSetShader(static_cast<ID3D11VertexShader*>(c.pObject), nullptr, 0u);
+            break;
+        case Op::PixelShader:
+            pContext->PSSetShader(static_cast<ID3D11PixelShader*>(c.pObject), nullptr, 0u);
+            break;
+        case Op::VertexConstantBuffer:
+        {
+            const auto pBuffer = static_cast<ID3D11Buffer*>(c.pObject);
+            pContext->VSSetConstantBuffers(c.arg, 1u, &pBuffer);
+            break;
+        }
+        case Op::PixelConstantBuffer:
+        {
+            const auto pBuffer = static_cast<ID3D11Buffer*>(c.pObject);
+            pContext->PSSetConstantBuffers(c.arg, 1u, &pBuffer);
+            break;
+        }
+        case Op::PixelShaderResource:
+        {
+            const auto pView = static_cast<ID3D11ShaderResourceView*>(c.pObject);
+            pContext->PSSetShaderResources(c.arg, 1u, &pView);
+            break;
+        }
+        case Op::PixelSampler:
+        {
+            const auto pSampler = static_cast<ID3D11SamplerState*>(c.pObject);
+            pContext->PSSetSamplers(c.arg, 1u, &pSampler);
+            break;
+        }
+        case Op::Rasterizer:
+            pContext->RSSetState(static_cast<ID3D11RasterizerState*>(c.pObject));
+            break;
+        case Op::Transform:
+            // 限定名调用，不走虚表；矩阵每次绘制都不一样，命令里只能存 TransformCbuf 本身
+            static_cast<TransformCbuf*>(c.pObject)->TransformCbuf::Bind(gfx);
+            break;
+        case Op::StreamedPixelShaderResource:
+            pContext->PSSetShaderResources(c.arg, 1u, static_cast<ID3D11ShaderResourceView* const*>(c.pObject));
+            break;
+        }
+    }
+}
+
+void BindStream::Trace(GraphicsTrace& trace) const noexcept
+{
+    for (const auto& c : commands)
+    {
+        if (c.op == Op::Transform)
+        {
+            const auto pBuffer = static_cast<const TransformCbuf*>(c.pObject)->GetBuffer();
+            trace.Map(pBuffer, sizeof(DirectX::XMMATRIX));
+            trace.Bind(TraceBindOp::VertexConstantBuffer, c.arg, pBuffer);
+        }
+        else if (c.op == Op::StreamedPixelShaderResource)
+        {
+            trace.Bind(TraceBindOp::PixelShaderResource, c.arg, *static_cast<ID3D11ShaderResourceView* const*>(c.pObject));
+        }
+        else
+        {
+            trace.Bind(static_cast<TraceBindOp>(c.op), c.arg, c.pObject);
+        }
+    }
+}
+
+void BindStream::Clear() noexcept
+{
+    commands.clear();
+}
+
+bool BindStream::IsEmpty() const noexcept
+{
+    return commands.empty();
+}
+
+size_t BindStream::GetSize() const noexcept
+{
+    return commands.size();
+}
+
+void BindStream::Push(Op op, UINT arg, void* pObject)
+{
+    commands.push_back({ op,arg,pObject });
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Graphics.h"
+#include "SmallVector.h"
+
+class GraphicsTrace;
+class TransformCbuf;
+
+// 一组绑定编译成的扁平命令数组：DrawableBase<T> 的 static binds 每个类型编译一份，
+// 每个 Drawable 自己的 Bindable（Box 只有一个 TransformCbuf）再编译一份很短的。
+// 每条命令带一个类型标签和执行它所需的裸指针，Execute 用一个 switch 顺序执行，不经过 Bindable 的虚函数。
+// 裸 COM 指针由 pool 里的 Bindable 持有（ComPtr），对象在 pool 里移动不会改变它们，
+// 所以只要对应的 Bindable 还活着命令流就有效；Bindable 增减时会重新编译。
+class BindStream
+{
+public:
+    enum class Op : unsigned char
+    {
+        VertexBuffer,
+        IndexBuffer,
+        InputLayout,
+        Topology,
+        VertexShader,
+        PixelShader,
+        VertexConstantBuffer,
+        PixelConstantBuffer,
+        PixelShaderResource,
+        PixelSampler,
+        Rasterizer,
+        // 更新并绑定变换常量缓冲：执行时直接调用 TransformCbuf::Bind（非虚），矩阵在那里从 Drawable 取
+        Transform,
+        // 流送纹理换 mip 时会换一个新的视图，执行时才从 pObject 指向的位置读出当前的视图
+        StreamedPixelShaderResource,
+    };
+public:
+    void PushVertexBuffer(ID3D11Buffer* pBuffer, UINT stride);
+    void PushIndexBuffer(ID3D11Buffer* pBuffer, DXGI_FORMAT format);
+    void PushInputLayout(ID3D11InputLayout* pLayout);
+    void PushTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+    void PushVertexShader(ID3D11VertexShader* pShader);
+    void PushPixelShader(ID3D11PixelShader* pShader);
+    void PushVertexConstantBuffer(ID3D11Buffer* pBuffer, UINT slot);
+    void PushPixelConstantBuffer(ID3D11Buffer* pBuffer, UINT slot);
+    void PushPixelShaderResource(ID3D11ShaderResourceView* pView, UINT slot);
+    void PushPixelSampler(ID3D11SamplerState* pSampler, UINT slot);
+    void PushRasterizer(ID3D11RasterizerState* pRasterizer);
+    // cbuf lives inside its Drawable, slot is only used by Trace (TransformCbuf::Bind binds its own slot)
+    void PushTransform(const TransformCbuf& cbuf, UINT slot);
+    // ppView must stay valid as long as the stream, the view it points to may change between frames
+    void PushStreamedPixelShaderResource(ID3D11ShaderResourceView* const* ppView, UINT slot);
+    void Execute(Graphics& gfx) const noexcept;
+    // writes what Execute would do to a trace; Transform shows up as a 64 byte map plus a vertex cbuffer bind,
+    // a streamed view as a plain pixel shader resource bind of the current view
+    void Trace(GraphicsTrace& trace) const noexcept;
+    void Clear() noexcept;
+    bool IsEmpty() const noexcept;
+    size_t GetSize() const noexcept;
+private:
+    struct Command
+    {
+        Op op;
+        // stride / slot / DXGI_FORMAT / D3D11_PRIMITIVE_TOPOLOGY，视 op 而定
+        UINT arg;
+        // ID3D11Buffer / ID3D11InputLayout / 着色器 / 视图 / 采样器 / 光栅化状态；
+        // StreamedPixelShaderResource 是指向视图指针的指针，Transform 是 TransformCbuf
+        void* pObject;
+    };
+    void Push(Op op, UINT arg, void* pObject);
+private:
+    // 内联一条，正好放下一个实例的 Transform；static 的命令流每个类型一份，放在堆上
+    SmallVector<Command, 1> commands;
+};
@@ -1,10 +1,14 @@
 #pragma once
 #include "Graphics.h"
 
+class BindStream;
+
 class Bindable
 {
 public:
     virtual void Bind(Graphics& gfx) noexcept = 0;
+    // 把 Bind 要做的事记录成命令流里的一条命令（见 BindStream），只在编译绑定集合时调用
+    virtual void Record(BindStream& stream) const = 0;
     virtual ~Bindable() = default;
 protected:
     static ID3D11DeviceContext* GetContext(Graphics& gfx) noexcept;
@@ -1,9 +1,15 @@
 #pragma once
 
 #include "ConstantBuffers.h"
+#include "DynamicIndexBuffer.h"
+#include "DynamicVertexBuffer.h"
 #include "IndexBuffer.h"
 #include "InputLayout.h"
 #include "PixelShader.h"
+#include "Rasterizer.h"
+#include "Sampler.h"
+#include "StreamedTexture.h"
+#include "Texture.h"
 #include "Topology.h"
 #include "TransformCbuf.h"
 #include "VertexBuffer.h"
@@ -0,0 +1,1149 @@
+#include "BlockCompression.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+#include <limits>
+#include <utility>
+
+#define BC_EXCEPT( note ) ImageException( __LINE__,__FILE__,"BlockCompression",(note) )
+
+namespace
+{
+    // ---------------------------------------------------------------- 块的读取
+    // 4x4 块按通道分开存放（SoA）：c[通道][像素]，像素按行排列，一次 SSE 运算处理一行 4 个像素
+    struct alignas( 16 ) Block
+    {
+        float c[4][16];
+    };
+
+    constexpr std::uint32_t allPixels = 0xFFFFu;
+
+    // 边缘不满 4x4 的块用最后一行 / 列补齐
+    void LoadBlock( const Image::Mip& mip,const std::uint8_t* pData,std::uint32_t bx,std::uint32_t by,Block& block ) noexcept
+    {
+        const auto zero = _mm_setzero_si128();
+        for( std::uint32_t y = 0u; y < 4u; y++ )
+        {
+            const auto row = pData + std::size_t( std::min( by * 4u + y,mip.height - 1u ) ) * mip.rowPitch;
+            alignas( 16 ) std::uint8_t pixels[16];
+            if( bx * 4u + 4u <= mip.width )
+            {
+                std::memcpy( pixels,row + bx * 16u,16u );
+            }
+            else
+            {
+                for( std::uint32_t x = 0u; x < 4u; x++ )
+                {
+                    std::memcpy( pixels + x * 4u,row + std::min( bx * 4u + x,mip.width - 1u ) * 4u,4u );
+                }
+            }
+            // 4 个像素展开成 4 个 (r,g,b,a) 再转置成 4 个通道
+            const auto v = _mm_load_si128( reinterpret_cast<const __m128i*>( pixels ) );
+            const auto lo = _mm_unpacklo_epi8( v,zero );
+            const auto hi = _mm_unpackhi_epi8( v,zero );
+            auto p0 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo,zero ) );
+            auto p1 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo,zero ) );
+            auto p2 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi,zero ) );
+            auto p3 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi,zero ) );
+            _MM_TRANSPOSE4_PS( p0,p1,p2,p3 );
+            _mm_store_ps( block.c[0] + y * 4u,p0 );
+            _mm_store_ps( block.c[1] + y * 4u,p1 );
+            _mm_store_ps( block.c[2] + y * 4u,p2 );
+            _mm_store_ps( block.c[3] + y * 4u,p3 );
+        }
+    }
+
+    // 一个通道的 16 个值打包成字节，给 BC4 用
+    __m128i PackChannel( const Block& block,int channel ) noexcept
+    {
+        const auto c = block.c[channel];
+        const auto a = _mm_packs_epi32( _mm_cvtps_epi32( _mm_load_ps( c ) ),_mm_cvtps_epi32( _mm_load_ps( c + 4 ) ) );
+        const auto b = _mm_packs_epi32( _mm_cvtps_epi32( _mm_load_ps( c + 8 ) ),_mm_cvtps_epi32( _mm_load_ps( c + 12 ) ) );
+        return _mm_packus_epi16( a,b );
+    }
+
+    // ---------------------------------------------------------------- 通用的端点拟合
+    // mask 里的像素在前 channels 个通道上沿主轴投影，取两端作为端点。
+    // pca 为 false 时主轴取包围盒对角线，各分量的符号跟方差最大的通道的协方差走
+    void ComputeEndpoints( const Block& b,std::uint32_t mask,int channels,bool pca,float e0[4],float e1[4] ) noexcept
+    {
+        float mean[4] = {};
+        float lo[4] = { 255.0f,255.0f,255.0f,255.0f };
+        float hi[4] = {};
+        int n = 0;
+        for( int i = 0; i < 16; i++ )
+        {
+            if( ( mask >> i ) & 1u )
+            {
+                for( int ch = 0; ch < channels; ch++ )
+                {
+                    mean[ch] += b.c[ch][i];
+                    lo[ch] = std::min( lo[ch],b.c[ch][i] );
+                    hi[ch] = std::max( hi[ch],b.c[ch][i] );
+                }
+                n++;
+            }
+        }
+        float cov[4][4] = {};
+        for( int ch = 0; ch < channels; ch++ )
+        {
+            mean[ch] /= float( n );
+        }
+        for( int i = 0; i < 16; i++ )
+        {
+            if( ( mask >> i ) & 1u )
+            {
+                float d[4];
+                for( int ch = 0; ch < channels; ch++ )
+                {
+                    d[ch] = b.c[ch][i] - mean[ch];
+                }
+                for( int j = 0; j < channels; j++ )
+                {
+                    for( int k = 0; k < channels; k++ )
+                    {
+                        cov[j][k] += d[j] * d[k];
+                    }
+                }
+            }
+        }
+        int major = 0;
+        for( int ch = 1; ch < channels; ch++ )
+        {
+            if( cov[ch][ch] > cov[major][major] )
+            {
+                major = ch;
+            }
+        }
+        float axis[4] = {};
+        if( pca )
+        {
+            // 幂迭代，从方差最大通道那一行出发，收敛很快
+            for( int ch = 0; ch < channels; ch++ )
+            {
+                axis[ch] = cov[major][ch];
+            }
+            for( int iteration = 0; iteration < 8; iteration++ )
+            {
+                float next[4] = {};
+                float length = 0.0f;
+                for( int j = 0; j < channels; j++ )
+                {
+                    for( int k = 0; k < channels; k++ )
+                    {
+                        next[j] += cov[j][k] * axis[k];
+                    }
+                    length = std::max( length,std::abs( next[j] ) );
+                }
+                if( length < 1e-6f )
+                {
+                    break;
+                }
+                for( int ch = 0; ch < channels; ch++ )
+                {
+                    axis[ch] = next[ch] / length;
+                }
+            }
+        }
+        else
+        {
+            for( int ch = 0; ch < channels; ch++ )
+            {
+                axis[ch] = cov[major][ch] < 0.0f ? lo[ch] - hi[ch] : hi[ch] - lo[ch];
+            }
+        }
+        float length2 = 0.0f;
+        for( int ch = 0; ch < channels; ch++ )
+        {
+            length2 += axis[ch] * axis[ch];
+        }
+        float tMin = 0.0f;
+        float tMax = 0.0f;
+        if( length2 > 1e-12f )
+        {
+            tMin = std::numeric_limits<float>::max();
+            tMax = -tMin;
+            for( int i = 0; i < 16; i++ )
+            {
+                if( ( mask >> i ) & 1u )
+                {
+                    float t = 0.0f;
+                    for( int ch = 0; ch < channels; ch++ )
+                    {
+                        t += ( b.c[ch][i] - mean[ch] ) * axis[ch];
+                    }
+                    tMin = std::min( tMin,t );
+                    tMax = std::max( tMax,t );
+                }
+            }
+            tMin /= length2;
+            tMax /= length2;
+        }
+        for( int ch = 0; ch < 4; ch++ )
+        {
+            e0[ch] = ch < channels ? std::clamp( mean[ch] + axis[ch] * tMin,0.0f,255.0f ) : 0.0f;
+            e1[ch] = ch < channels ? std::clamp( mean[ch] + axis[ch] * tMax,0.0f,255.0f ) : 0.0f;
+        }
+    }
+
+    // 已知每个像素在 e0 -> e1 上的位置 w，按最小二乘重新求端点；矩阵奇异（所有像素用同一个索引）时返回 false
+    bool SolveEndpoints( const Block& b,std::uint32_t mask,int channels,const float w[16],float e0[4],float e1[4] ) noexcept
+    {
+        float aa = 0.0f;
+        float ab = 0.0f;
+        float bb = 0.0f;
+        float x0[4] = {};
+        float x1[4] = {};
+        for( int i = 0; i < 16; i++ )
+        {
+            if( ( mask >> i ) & 1u )
+            {
+                const float a = 1.0f - w[i];
+                aa += a * a;
+                ab += a * w[i];
+                bb += w[i] * w[i];
+                for( int ch = 0; ch < channels; ch++ )
+                {
+                    x0[ch] += a * b.c[ch][i];
+                    x1[ch] += w[i] * b.c[ch][i];
+                }
+            }
+        }
+        const float det = aa * bb - ab * ab;
+        if( std::abs( det ) < 1e-3f )
+        {
+            return false;
+        }
+        for( int ch = 0; ch < channels; ch++ )
+        {
+            e0[ch] = std::clamp( ( bb * x0[ch] - ab * x1[ch] ) / det,0.0f,255.0f );
+            e1[ch] = std::clamp( ( aa * x1[ch] - ab * x0[ch] ) / det,0.0f,255.0f );
+        }
+        return true;
+    }
+
+    // 每个像素在 count 个调色板颜色里选前 channels 个通道平方误差最小的，返回 mask 里像素的总误差
+    float SelectIndices( const Block& b,const std::uint8_t palette[][4],int count,int channels,std::uint32_t mask,std::uint8_t indices[16] ) noexcept
+    {
+        __m128 entries[16][4];
+        for( int k = 0; k < count; k++ )
+        {
+            for( int ch = 0; ch < channels; ch++ )
+            {
+                entries[k][ch] = _mm_set1_ps( float( palette[k][ch] ) );
+            }
+        }
+        float error = 0.0f;
+        for( int group = 0; group < 4; group++ )
+        {
+            __m128 px[4];
+            for( int ch = 0; ch < channels; ch++ )
+            {
+                px[ch] = _mm_load_ps( b.c[ch] + group * 4 );
+            }
+            auto best = _mm_set1_ps( std::numeric_limits<float>::max() );
+            auto bestIndex = _mm_setzero_si128();
+            for( int k = 0; k < count; k++ )
+            {
+                auto d = _mm_setzero_ps();
+                for( int ch = 0; ch < channels; ch++ )
+                {
+                    const auto diff = _mm_sub_ps( px[ch],entries[k][ch] );
+                    d = _mm_add_ps( d,_mm_mul_ps( diff,diff ) );
+                }
+                const auto less = _mm_castps_si128( _mm_cmplt_ps( d,best ) );
+                best = _mm_min_ps( d,best );
+                bestIndex = _mm_or_si128( _mm_and_si128( less,_mm_set1_epi32( k ) ),_mm_andnot_si128( less,bestIndex ) );
+            }
+            alignas( 16 ) float bestError[4];
+            alignas( 16 ) std::int32_t index[4];
+            _mm_store_ps( bestError,best );
+            _mm_store_si128( reinterpret_cast<__m128i*>( index ),bestIndex );
+            for( int j = 0; j < 4; j++ )
+            {
+                const int i = group * 4 + j;
+                indices[i] = std::uint8_t( index[j] );
+                if( ( mask >> i ) & 1u )
+                {
+                    error += bestError[j];
+                }
+            }
+        }
+        return error;
+    }
+
+    // ---------------------------------------------------------------- BC1 颜色块
+    std::uint16_t To565( const float c[4] ) noexcept
+    {
+        const auto r = int( c[0] * ( 31.0f / 255.0f ) + 0.5f );
+        const auto g = int( c[1] * ( 63.0f / 255.0f ) + 0.5f );
+        const auto b = int( c[2] * ( 31.0f / 255.0f ) + 0.5f );
+        return std::uint16_t( ( r << 11 ) | ( g << 5 ) | b );
+    }
+
+    // 编码器按解码器的整数运算建调色板，选出的索引和解码结果一致
+    void Bc1Palette( std::uint16_t c0,std::uint16_t c1,bool fourColor,std::uint8_t palette[4][4] ) noexcept
+    {
+        const int a[3] = { ( ( c0 >> 11 ) << 3 ) | ( c0 >> 13 ),( ( ( c0 >> 5 ) & 63 ) << 2 ) | ( ( c0 >> 9 ) & 3 ),( ( c0 & 31 ) << 3 ) | ( ( c0 >> 2 ) & 7 ) };
+        const int b[3] = { ( ( c1 >> 11 ) << 3 ) | ( c1 >> 13 ),( ( ( c1 >> 5 ) & 63 ) << 2 ) | ( ( c1 >> 9 ) & 3 ),( ( c1 & 31 ) << 3 ) | ( ( c1 >> 2 ) & 7 ) };
+        for( int ch = 0; ch < 3; ch++ )
+        {
+            palette[0][ch] = std::uint8_t( a[ch] );
+            palette[1][ch] = std::uint8_t( b[ch] );
+            palette[2][ch] = std::uint8_t( fourColor ? ( 2 * a[ch] + b[ch] ) / 3 : ( a[ch] + b[ch] ) / 2 );
+            palette[3][ch] = std::uint8_t( fourColor ? ( a[ch] + 2 * b[ch] ) / 3 : 0 );
+        }
+        palette[0][3] = palette[1][3] = palette[2][3] = 255u;
+        palette[3][3] = fourColor ? 255u : 0u;
+    }
+
+    struct Bc1Result
+    {
+        std::uint16_t c0;
+        std::uint16_t c1;
+        bool fourColor;
+        std::uint8_t indices[16];
+        float error;
+    };
+
+    // transparent 里的像素固定用 3 色模式的透明索引 3，不计误差
+    Bc1Result EvaluateBc1( const Block& b,const float e0[4],const float e1[4],std::uint32_t transparent,bool alwaysFourColor ) noexcept
+    {
+        Bc1Result r;
+        r.c0 = To565( e0 );
+        r.c1 = To565( e1 );
+        // BC1 里 c0 > c1 是 4 色模式，否则是 3 色 + 透明；BC3 的颜色块总是 4 色
+        if( !alwaysFourColor && ( transparent == 0u ) == ( r.c0 < r.c1 ) )
+        {
+            std::swap( r.c0,r.c1 );
+        }
+        r.fourColor = alwaysFourColor || r.c0 > r.c1;
+        std::uint8_t palette[4][4];
+        Bc1Palette( r.c0,r.c1,r.fourColor,palette );
+        r.error = SelectIndices( b,palette,r.fourColor ? 4 : 3,3,~transparent & allPixels,r.indices );
+        for( int i = 0; i < 16; i++ )
+        {
+            if( ( transparent >> i ) & 1u )
+            {
+                r.indices[i] = 3u;
+            }
+        }
+        return r;
+    }
+
+    int GetRefineIterations( BcQuality quality ) noexcept
+    {
+        return quality == BcQuality::Fast ? 0 : quality == BcQuality::Normal ? 1 : 4;
+    }
+
+    void EncodeBc1Color( const Block& b,BcQuality quality,bool alwaysFourColor,std::uint8_t* out ) noexcept
+    {
+        std::uint32_t transparent = 0u;
+        if( !alwaysFourColor )
+        {
+            for( int i = 0; i < 16; i++ )
+            {
+                if( b.c[3][i] < 128.0f )
+                {
+                    transparent |= 1u << i;
+                }
+            }
+        }
+        const auto opaque = ~transparent & allPixels;
+        Bc1Result best;
+        if( opaque == 0u )
+        {
+            best.c0 = best.c1 = 0u;
+            std::fill( best.indices,best.indices + 16,std::uint8_t( 3u ) );
+        }
+        else
+        {
+            float e0[4];
+            float e1[4];
+            ComputeEndpoints( b,opaque,3,quality != BcQuality::Fast,e0,e1 );
+            best = EvaluateBc1( b,e0,e1,transparent,alwaysFourColor );
+            const float fourColorWeights[4] = { 0.0f,1.0f,1.0f / 3.0f,2.0f / 3.0f };
+            const float threeColorWeights[4] = { 0.0f,1.0f,0.5f,0.0f };
+            for( int i = 0; i < GetRefineIterations( quality ) && best.error > 0.0f; i++ )
+            {
+                const auto weights = best.fourColor ? fourColorWeights : threeColorWeights;
+                float w[16];
+                for( int p = 0; p < 16; p++ )
+                {
+                    w[p] = weights[best.indices[p]];
+                }
+                if( !SolveEndpoints( b,opaque,3,w,e0,e1 ) )
+                {
+                    break;
+                }
+                const auto candidate = EvaluateBc1( b,e0,e1,transparent,alwaysFourColor );
+                if( candidate.error >= best.error )
+                {
+                    break;
+                }
+                best = candidate;
+            }
+        }
+        std::uint32_t bits = 0u;
+        for( int i = 0; i < 16; i++ )
+        {
+            bits |= std::uint32_t( best.indices[i] ) << ( 2 * i );
+        }
+        out[0] = std::uint8_t( best.c0 );
+        out[1] = std::uint8_t( best.c0 >> 8 );
+        out[2] = std::uint8_t( best.c1 );
+        out[3] = std::uint8_t( best.c1 >> 8 );
+        std::memcpy( out + 4,&bits,4u );
+    }
+
+    void DecodeBc1( const std::uint8_t* in,bool alwaysFourColor,std::uint8_t px[16][4] ) noexcept
+    {
+        const auto c0 = std::uint16_t( in[0] | ( in[1] << 8 ) );
+        const auto c1 = std::uint16_t( in[2] | ( in[3] << 8 ) );
+        std::uint32_t bits;
+        std::memcpy( &bits,in + 4,4u );
+        std::uint8_t palette[4][4];
+        Bc1Palette( c0,c1,alwaysFourColor || c0 > c1,palette );
+        for( int i = 0; i < 16; i++ )
+        {
+            std::memcpy( px[i],palette[( bits >> ( 2 * i ) ) & 3u],4u );
+        }
+    }
+
+    // ---------------------------------------------------------------- BC4 单通道块
+    // e0 > e1 时是 8 值模式，否则是 6 值 + 0 + 255
+    void Bc4Palette( int e0,int e1,std::uint8_t palette[8] ) noexcept
+    {
+        palette[0] = std::uint8_t( e0 );
+        palette[1] = std::uint8_t( e1 );
+        if( e0 > e1 )
+        {
+            for( int i = 1; i < 7; i++ )
+            {
+                palette[i + 1] = std::uint8_t( ( ( 7 - i ) * e0 + i * e1 ) / 7 );
+            }
+        }
+        else
+        {
+            for( int i = 1; i < 5; i++ )
+            {
+                palette[i + 1] = std::uint8_t( ( ( 5 - i ) * e0 + i * e1 ) / 5 );
+            }
+            palette[6] = 0u;
+            palette[7] = 255u;
+        }
+    }
+
+    // 16 个值正好一个 SSE 寄存器：对每个调色板值求 |v - p|，逐字节取最小；返回平方误差和
+    std::uint32_t SelectBc4( __m128i values,const std::uint8_t palette[8],std::uint8_t indices[16] ) noexcept
+    {
+        auto best = _mm_set1_epi8( -1 );
+        auto bestIndex = _mm_setzero_si128();
+        for( int k = 0; k < 8; k++ )
+        {
+            const auto p = _mm_set1_epi8( char( palette[k] ) );
+            const auto d = _mm_or_si128( _mm_subs_epu8( values,p ),_mm_subs_epu8( p,values ) );
+            // d >= best 时保留原来的索引
+            const auto keep = _mm_cmpeq_epi8( _mm_max_epu8( d,best ),d );
+            bestIndex = _mm_or_si128( _mm_and_si128( keep,bestIndex ),_mm_andnot_si128( keep,_mm_set1_epi8( char( k ) ) ) );
+            best = _mm_min_epu8( d,best );
+        }
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( indices ),bestIndex );
+        const auto zero = _mm_setzero_si128();
+        const auto lo = _mm_unpacklo_epi8( best,zero );
+        const auto hi = _mm_unpackhi_epi8( best,zero );
+        auto sum = _mm_add_epi32( _mm_madd_epi16( lo,lo ),_mm_madd_epi16( hi,hi ) );
+        sum = _mm_add_epi32( sum,_mm_shuffle_epi32( sum,_MM_SHUFFLE( 1,0,3,2 ) ) );
+        sum = _mm_add_epi32( sum,_mm_shuffle_epi32( sum,_MM_SHUFFLE( 2,3,0,1 ) ) );
+        return std::uint32_t( _mm_cvtsi128_si32( sum ) );
+    }
+
+    void EncodeBc4( __m128i values,BcQuality quality,std::uint8_t* out ) noexcept
+    {
+        alignas( 16 ) std::uint8_t v[16];
+        _mm_store_si128( reinterpret_cast<__m128i*>( v ),values );
+        int lo = 255;
+        int hi = 0;
+        // 6 值模式自带 0 和 255，端点只需要覆盖中间的值
+        int innerLo = 255;
+        int innerHi = 0;
+        for( const auto x : v )
+        {
+            lo = std::min( lo,int( x ) );
+            hi = std::max( hi,int( x ) );
+            if( x != 0u && x != 255u )
+            {
+                innerLo = std::min( innerLo,int( x ) );
+                innerHi = std::max( innerHi,int( x ) );
+            }
+        }
+        int bestE0 = hi;
+        int bestE1 = lo;
+        std::uint8_t bestIndices[16];
+        std::uint32_t bestError = std::numeric_limits<std::uint32_t>::max();
+        const auto tryEndpoints = [&]( int e0,int e1 ) noexcept {
+            std::uint8_t palette[8];
+            std::uint8_t indices[16];
+            Bc4Palette( e0,e1,palette );
+            const auto error = SelectBc4( values,palette,indices );
+            if( error < bestError )
+            {
+                bestError = error;
+                bestE0 = e0;
+                bestE1 = e1;
+                std::memcpy( bestIndices,indices,16u );
+            }
+        };
+        // 端点向内收一点，中间的插值点常常能对得更准
+        const int range = quality == BcQuality::Fast ? 0 : quality == BcQuality::Normal ? 1 : 3;
+        tryEndpoints( hi,lo );
+        for( int i = 0; i <= range && bestError > 0u; i++ )
+        {
+            for( int j = 0; j <= range; j++ )
+            {
+                if( ( i != 0 || j != 0 ) && hi - i > lo + j )
+                {
+                    tryEndpoints( hi - i,lo + j );
+                }
+            }
+        }
+        if( quality == BcQuality::High && bestError > 0u && innerLo <= innerHi )
+        {
+            tryEndpoints( innerLo,innerHi );
+        }
+        out[0] = std::uint8_t( bestE0 );
+        out[1] = std::uint8_t( bestE1 );
+        std::uint64_t bits = 0u;
+        for( int i = 0; i < 16; i++ )
+        {
+            bits |= std::uint64_t( bestIndices[i] ) << ( 3 * i );
+        }
+        for( int i = 0; i < 6; i++ )
+        {
+            out[2 + i] = std::uint8_t( bits >> ( 8 * i ) );
+        }
+    }
+
+    void DecodeBc4( const std::uint8_t* in,std::uint8_t values[16] ) noexcept
+    {
+        std::uint8_t palette[8];
+        Bc4Palette( in[0],in[1],palette );
+        std::uint64_t bits = 0u;
+        for( int i = 0; i < 6; i++ )
+        {
+            bits |= std::uint64_t( in[2 + i] ) << ( 8 * i );
+        }
+        for( int i = 0; i < 16; i++ )
+        {
+            values[i] = palette[( bits >> ( 3 * i ) ) & 7u];
+        }
+    }
+
+    // ---------------------------------------------------------------- BC7
+    constexpr int weights2[4] = { 0,21,43,64 };
+    constexpr int weights3[8] = { 0,9,18,27,37,46,55,64 };
+    constexpr int weights4[16] = { 0,4,9,13,17,21,26,30,34,38,43,47,51,55,60,64 };
+
+    int Interpolate( int e0,int e1,int weight ) noexcept
+    {
+        return ( ( 64 - weight ) * e0 + weight * e1 + 32 ) >> 6;
+    }
+
+    // BC7 的字段从最低位开始紧密排列
+    class BitWriter
+    {
+    public:
+        explicit BitWriter( std::uint8_t* p ) noexcept
+            :
+            p( p )
+        {
+            std::memset( p,0,16u );
+        }
+        void Write( std::uint32_t value,int bits ) noexcept
+        {
+            for( int i = 0; i < bits; i++,pos++ )
+            {
+                p[pos >> 3] |= std::uint8_t( ( ( value >> i ) & 1u ) << ( pos & 7 ) );
+            }
+        }
+    private:
+        std::uint8_t* p;
+        int pos = 0;
+    };
+
+    class BitReader
+    {
+    public:
+        explicit BitReader( const std::uint8_t* p ) noexcept
+            :
+            p( p )
+        {}
+        int Read( int bits ) noexcept
+        {
+            int value = 0;
+            for( int i = 0; i < bits; i++,pos++ )
+            {
+                value |= ( ( p[pos >> 3] >> ( pos & 7 ) ) & 1 ) << i;
+            }
+            return value;
+        }
+    private:
+        const std::uint8_t* p;
+        int pos = 0;
+    };
+
+    // mode 6：单子集 RGBA，7 位端点 + 每端一个 p 位，4 位索引
+    struct Mode6
+    {
+        std::uint8_t q0[4];
+        std::uint8_t q1[4];
+        int p0;
+        int p1;
+        std::uint8_t indices[16];
+        float error;
+    };
+
+    // p 位是一个端点 4 个通道共用的最低位，按 4 个通道的总误差选
+    void QuantizeMode6( const float e[4],std::uint8_t q[4],int& p ) noexcept
+    {
+        float bestError = std::numeric_limits<float>::max();
+        for( int pbit = 0; pbit < 2; pbit++ )
+        {
+            std::uint8_t candidate[4];
+            float error = 0.0f;
+            for( int ch = 0; ch < 4; ch++ )
+            {
+                const int v = std::clamp( int( ( e[ch] - float( pbit ) ) * 0.5f + 0.5f ),0,127 );
+                candidate[ch] = std::uint8_t( v );
+                const float d = float( v * 2 + pbit ) - e[ch];
+                error += d * d;
+            }
+            if( error < bestError )
+            {
+                bestError = error;
+                std::memcpy( q,candidate,4u );
+                p = pbit;
+            }
+        }
+    }
+
+    Mode6 EvaluateMode6( const Block& b,const float e0[4],const float e1[4] ) noexcept
+    {
+        Mode6 m;
+        QuantizeMode6( e0,m.q0,m.p0 );
+        QuantizeMode6( e1,m.q1,m.p1 );
+        std::uint8_t palette[16][4];
+        for( int k = 0; k < 16; k++ )
+        {
+            for( int ch = 0; ch < 4; ch++ )
+            {
+                palette[k][ch] = std::uint8_t( Interpolate( m.q0[ch] * 2 + m.p0,m.q1[ch] * 2 + m.p1,weights4[k] ) );
+            }
+        }
+        m.error = SelectIndices( b,palette,16,4,allPixels,m.indices );
+        // 第一个像素（anchor）的索引不存最高位，必须小于 8；权重表是对称的，交换端点后索引取反，结果不变
+        if( m.indices[0] >= 8u )
+        {
+            std::swap( m.q0,m.q1 );
+            std::swap( m.p0,m.p1 );
+            for( auto& i : m.indices )
+            {
+                i = std::uint8_t( 15u - i );
+            }
+        }
+        return m;
+    }
+
+    // mode 5：单子集，RGB 7 位端点和 alpha 8 位端点分开插值，各用 2 位索引；
+    // rotation 把 alpha 和 R/G/B 之一交换，让和其他通道不相关的那个通道单独编码
+    struct Mode5
+    {
+        int rotation;
+        std::uint8_t c0[3];
+        std::uint8_t c1[3];
+        std::uint8_t a0;
+        std::uint8_t a1;
+        std::uint8_t colorIndices[16];
+        std::uint8_t alphaIndices[16];
+        float error;
+    };
+
+    float EvaluateMode5Color( const Block& b,const float e0[4],const float e1[4],Mode5& m ) noexcept
+    {
+        std::uint8_t palette[4][4] = {};
+        int expanded[2][3];
+        for( int ch = 0; ch < 3; ch++ )
+        {
+            m.c0[ch] = std::uint8_t( std::clamp( int( e0[ch] * ( 127.0f / 255.0f ) + 0.5f ),0,127 ) );
+            m.c1[ch] = std::uint8_t( std::clamp( int( e1[ch] * ( 127.0f / 255.0f ) + 0.5f ),0,127 ) );
+            expanded[0][ch] = ( m.c0[ch] << 1 ) | ( m.c0[ch] >> 6 );
+            expanded[1][ch] = ( m.c1[ch] << 1 ) | ( m.c1[ch] >> 6 );
+        }
+        for( int k = 0; k < 4; k++ )
+        {
+            for( int ch = 0; ch < 3; ch++ )
+            {
+                palette[k][ch] = std::uint8_t( Interpolate( expanded[0][ch],expanded[1][ch],weights2[k] ) );
+            }
+        }
+        return SelectIndices( b,palette,4,3,allPixels,m.colorIndices );
+    }
+
+    Mode5 EncodeMode5( const Block& source,int rotation ) noexcept
+    {
+        Block b = source;
+        if( rotation != 0 )
+        {
+            std::swap( b.c[3],b.c[rotation - 1] );
+        }
+        Mode5 m;
+        m.rotation = rotation;
+        float e0[4];
+        float e1[4];
+        ComputeEndpoints( b,allPixels,3,true,e0,e1 );
+        float colorError = EvaluateMode5Color( b,e0,e1,m );
+        float w[16];
+        for( int i = 0; i < 16; i++ )
+        {
+            w[i] = float( weights2[m.colorIndices[i]] ) / 64.0f;
+        }
+        if( colorError > 0.0f && SolveEndpoints( b,allPixels,3,w,e0,e1 ) )
+        {
+            Mode5 refined = m;
+            const auto refinedError = EvaluateMode5Color( b,e0,e1,refined );
+            if( refinedError < colorError )
+            {
+                m = refined;
+                colorError = refinedError;
+            }
+        }
+        // alpha 是标量，端点直接取最小最大值
+        const auto alpha = b.c[3];
+        m.a0 = std::uint8_t( *std::min_element( alpha,alpha + 16 ) );
+        m.a1 = std::uint8_t( *std::max_element( alpha,alpha + 16 ) );
+        int alphaPalette[4];
+        for( int k = 0; k < 4; k++ )
+        {
+            alphaPalette[k] = Interpolate( m.a0,m.a1,weights2[k] );
+        }
+        float alphaError = 0.0f;
+        for( int i = 0; i < 16; i++ )
+        {
+            float best = std::numeric_limits<float>::max();
+            for( int k = 0; k < 4; k++ )
+            {
+                const float d = alpha[i] - float( alphaPalette[k] );
+                if( d * d < best )
+                {
+                    best = d * d;
+                    m.alphaIndices[i] = std::uint8_t( k );
+                }
+            }
+            alphaError += best;
+        }
+        // 两组索引各自的 anchor 都要小于 2
+        if( m.colorIndices[0] >= 2u )
+        {
+            std::swap( m.c0,m.c1 );
+            for( auto& i : m.colorIndices )
+            {
+                i = std::uint8_t( 3u - i );
+            }
+        }
+        if( m.alphaIndices[0] >= 2u )
+        {
+            std::swap( m.a0,m.a1 );
+            for( auto& i : m.alphaIndices )
+            {
+                i = std::uint8_t( 3u - i );
+            }
+        }
+        m.error = colorError + alphaError;
+        return m;
+    }
+
+    void EncodeBc7( const Block& b,BcQuality quality,std::uint8_t* out ) noexcept
+    {
+        float e0[4];
+        float e1[4];
+        ComputeEndpoints( b,allPixels,4,quality != BcQuality::Fast,e0,e1 );
+        auto best = EvaluateMode6( b,e0,e1 );
+        for( int i = 0; i < GetRefineIterations( quality ) && best.error > 0.0f; i++ )
+        {
+            float w[16];
+            for( int p = 0; p < 16; p++ )
+            {
+                w[p] = float( weights4[best.indices[p]] ) / 64.0f;
+            }
+            // 端点可能因为 anchor 被交换过，按量化后的实际顺序求解
+            if( !SolveEndpoints( b,allPixels,4,w,e0,e1 ) )
+            {
+                break;
+            }
+            const auto candidate = EvaluateMode6( b,e0,e1 );
+            if( candidate.error >= best.error )
+            {
+                break;
+            }
+            best = candidate;
+        }
+        if( quality == BcQuality::High && best.error > 0.0f )
+        {
+            Mode5 best5 = {};
+            best5.error = best.error;
+            for( int rotation = 0; rotation < 4; rotation++ )
+            {
+                const auto candidate = EncodeMode5( b,rotation );
+                if( candidate.error < best5.error )
+                {
+                    best5 = candidate;
+                }
+            }
+            if( best5.error < best.error )
+            {
+                BitWriter w( out );
+                w.Write( 1u << 5,6 );
+                w.Write( std::uint32_t( best5.rotation ),2 );
+                for( int ch = 0; ch < 3; ch++ )
+                {
+                    w.Write( best5.c0[ch],7 );
+                    w.Write( best5.c1[ch],7 );
+                }
+                w.Write( best5.a0,8 );
+                w.Write( best5.a1,8 );
+                for( int i = 0; i < 16; i++ )
+                {
+                    w.Write( best5.colorIndices[i],i == 0 ? 1 : 2 );
+                }
+                for( int i = 0; i < 16; i++ )
+                {
+                    w.Write( best5.alphaIndices[i],i == 0 ? 1 : 2 );
+                }
+                return;
+            }
+        }
+        BitWriter w( out );
+        w.Write( 1u << 6,7 );
+        for( int ch = 0; ch < 4; ch++ )
+        {
+            w.Write( best.q0[ch],7 );
+            w.Write( best.q1[ch],7 );
+        }
+        w.Write( std::uint32_t( best.p0 ),1 );
+        w.Write( std::uint32_t( best.p1 ),1 );
+        for( int i = 0; i < 16; i++ )
+        {
+            w.Write( best.indices[i],i == 0 ? 3 : 4 );
+        }
+    }
+
+    // 一组索引，第一个像素少存一位
+    void ReadIndices( BitReader& r,int bits,int indices[16] ) noexcept
+    {
+        for( int i = 0; i < 16; i++ )
+        {
+            indices[i] = r.Read( i == 0 ? bits - 1 : bits );
+        }
+    }
+
+    void DecodeBc7( const std::uint8_t* in,std::uint8_t px[16][4] )
+    {
+        BitReader r( in );
+        int mode = 0;
+        while( mode < 8 && r.Read( 1 ) == 0 )
+        {
+            mode++;
+        }
+        if( mode == 8 )
+        {
+            // 保留的编码，规定解成全 0
+            std::memset( px,0,64u );
+            return;
+        }
+        if( mode < 4 || mode == 7 )
+        {
+            throw BC_EXCEPT( "BC7 mode " + std::to_string( mode ) + " (multiple subsets) is not supported by the CPU decoder" );
+        }
+        const int rotation = mode == 6 ? 0 : r.Read( 2 );
+        const int indexMode = mode == 4 ? r.Read( 1 ) : 0;
+        const int colorBits = mode == 4 ? 5 : 7;
+        const int alphaBits = mode == 4 ? 6 : mode == 5 ? 8 : 7;
+        int e[2][4];
+        for( int ch = 0; ch < 3; ch++ )
+        {
+            e[0][ch] = r.Read( colorBits );
+            e[1][ch] = r.Read( colorBits );
+        }
+        e[0][3] = r.Read( alphaBits );
+        e[1][3] = r.Read( alphaBits );
+        if( mode == 6 )
+        {
+            const int p0 = r.Read( 1 );
+            const int p1 = r.Read( 1 );
+            for( int ch = 0; ch < 4; ch++ )
+            {
+                e[0][ch] = ( e[0][ch] << 1 ) | p0;
+                e[1][ch] = ( e[1][ch] << 1 ) | p1;
+            }
+        }
+        else
+        {
+            // 高位复制到低位扩展成 8 位
+            for( int ch = 0; ch < 4; ch++ )
+            {
+                const int bits = ch < 3 ? colorBits : alphaBits;
+                for( auto& end : e )
+                {
+                    end[ch] = ( end[ch] << ( 8 - bits ) ) | ( end[ch] >> ( 2 * bits - 8 ) );
+                }
+            }
+        }
+        int colorIndices[16];
+        int alphaIndices[16];
+        const int* colorWeights = weights4;
+        const int* alphaWeights = weights4;
+        if( mode == 6 )
+        {
+            ReadIndices( r,4,colorIndices );
+            std::memcpy( alphaIndices,colorIndices,sizeof( colorIndices ) );
+        }
+        else if( mode == 5 )
+        {
+            ReadIndices( r,2,colorIndices );
+            ReadIndices( r,2,alphaIndices );
+            colorWeights = alphaWeights = weights2;
+        }
+        else
+        {
+            // mode 4 先存 2 位那组再存 3 位那组，indexMode 决定哪组给颜色
+            int indices2[16];
+            int indices3[16];
+            ReadIndices( r,2,indices2 );
+            ReadIndices( r,3,indices3 );
+            std::memcpy( colorIndices,indexMode == 0 ? indices2 : indices3,sizeof( colorIndices ) );
+            std::memcpy( alphaIndices,indexMode == 0 ? indices3 : indices2,sizeof( alphaIndices ) );
+            colorWeights = indexMode == 0 ? weights2 : weights3;
+            alphaWeights = indexMode == 0 ? weights3 : weights2;
+        }
+        for( int i = 0; i < 16; i++ )
+        {
+            for( int ch = 0; ch < 3; ch++ )
+            {
+                px[i][ch] = std::uint8_t( Interpolate( e[0][ch],e[1][ch],colorWeights[colorIndices[i]] ) );
+            }
+            px[i][3] = std::uint8_t( Interpolate( e[0][3],e[1][3],alphaWeights[alphaIndices[i]] ) );
+            if( rotation != 0 )
+            {
+                std::swap( px[i][3],px[i][rotation - 1] );
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------- 按格式分派
+    void EncodeBlock( const Block& b,ImageFormat format,BcQuality quality,std::uint8_t* out ) noexcept
+    {
+        switch( format )
+        {
+        case ImageFormat::BC1:
+        case ImageFormat::BC1Srgb:
+            EncodeBc1Color( b,quality,false,out );
+            break;
+        case ImageFormat::BC3:
+        case ImageFormat::BC3Srgb:
+            EncodeBc4( PackChannel( b,3 ),quality,out );
+            EncodeBc1Color( b,quality,true,out + 8 );
+            break;
+        case ImageFormat::BC4:
+            EncodeBc4( PackChannel( b,0 ),quality,out );
+            break;
+        case ImageFormat::BC5:
+            EncodeBc4( PackChannel( b,0 ),quality,out );
+            EncodeBc4( PackChannel( b,1 ),quality,out + 8 );
+            break;
+        default:
+            EncodeBc7( b,quality,out );
+            break;
+        }
+    }
+
+    void DecodeBlock( const std::uint8_t* in,ImageFormat format,std::uint8_t px[16][4] )
+    {
+        std::uint8_t values[16];
+        switch( format )
+        {
+        case ImageFormat::BC1:
+        case ImageFormat::BC1Srgb:
+            DecodeBc1( in,false,px );
+            break;
+        case ImageFormat::BC3:
+        case ImageFormat::BC3Srgb:
+            DecodeBc1( in + 8,true,px );
+            DecodeBc4( in,values );
+            for( int i = 0; i < 16; i++ )
+            {
+                px[i][3] = values[i];
+            }
+            break;
+        case ImageFormat::BC4:
+        case ImageFormat::BC5:
+            std::memset( px,0,64u );
+            DecodeBc4( in,values );
+            for( int i = 0; i < 16; i++ )
+            {
+                px[i][0] = values[i];
+                px[i][3] = 255u;
+            }
+            if( format == ImageFormat::BC5 )
+            {
+                DecodeBc4( in + 8,values );
+                for( int i = 0; i < 16; i++ )
+                {
+                    px[i][1] = values[i];
+                }
+            }
+            break;
+        default:
+            DecodeBc7( in,px );
+            break;
+        }
+    }
+}
+
+Image BlockCompression::Encode( const Image& source,TextureCompression compression,BcQuality quality,ThreadPool* pPool )
+{
+    assert( "Source must be uncompressed RGBA8" && !Image::IsCompressed( source.GetFormat() ) );
+    assert( "No compression format given" && compression != TextureCompression::None );
+    const auto format = GetFormat( compression,Image::IsSrgb( source.GetFormat() ) );
+    Image result( source.GetWidth(),source.GetHeight(),format,source.GetMipCount() );
+    const auto blockSize = Image::GetElementSize( format );
+    // 所有 mip 层的块行排成一条，按块行分给线程
+    std::size_t firstRow[Image::maxMipCount + 1u] = {};
+    for( std::uint32_t level = 0u; level < source.GetMipCount(); level++ )
+    {
+        firstRow[level + 1u] = firstRow[level] + ( source.GetMip( level ).height + 3u ) / 4u;
+    }
+    const auto encodeRows = [&]( std::size_t begin,std::size_t end ) noexcept {
+        std::uint32_t level = 0u;
+        Block block;
+        for( auto row = begin; row < end; row++ )
+        {
+            while( row >= firstRow[level + 1u] )
+            {
+                level++;
+            }
+            const auto& mip = source.GetMip( level );
+            const auto src = reinterpret_cast<const std::uint8_t*>( source.GetMipData( level ) );
+            const auto by = std::uint32_t( row - firstRow[level] );
+            const auto dst = reinterpret_cast<std::uint8_t*>( result.GetMipData( level ) ) + std::size_t( by ) * result.GetMip( level ).rowPitch;
+            for( std::uint32_t bx = 0u; bx < ( mip.width + 3u ) / 4u; bx++ )
+            {
+                LoadBlock( mip,src,bx,by,block );
+                EncodeBlock( block,format,quality,dst + bx * blockSize );
+            }
+        }
+    };
+    const auto rows = firstRow[source.GetMipCount()];
+    if( pPool != nullptr )
+    {
+        pPool->ParallelFor( rows,1u,encodeRows );
+    }
+    else
+    {
+        encodeRows( 0u,rows );
+    }
+    return result;
+}
+
+Image BlockCompression::Decode( const Image& source )
+{
+    const auto format = source.GetFormat();
+    if( !Image::IsCompressed( format ) )
+    {
+        throw BC_EXCEPT( "Image is not block compressed" );
+    }
+    Image result( source.GetWidth(),source.GetHeight(),Image::IsSrgb( format ) ? ImageFormat::RGBA8Srgb : ImageFormat::RGBA8,source.GetMipCount() );
+    const auto blockSize = Image::GetElementSize( format );
+    for( std::uint32_t level = 0u; level < source.GetMipCount(); level++ )
+    {
+        const auto& mip = result.GetMip( level );
+        const auto src = reinterpret_cast<const std::uint8_t*>( source.GetMipData( level ) );
+        const auto dst = reinterpret_cast<std::uint8_t*>( result.GetMipData( level ) );
+        for( std::uint32_t by = 0u; by < ( mip.height + 3u ) / 4u; by++ )
+        {
+            for( std::uint32_t bx = 0u; bx < ( mip.width + 3u ) / 4u; bx++ )
+            {
+                std::uint8_t px[16][4];
+                DecodeBlock( src + std::size_t( by ) * source.GetMip( level ).rowPitch + bx * blockSize,format,px );
+                // 边缘块只写图像范围内的像素
+                for( std::uint32_t y = 0u; y < 4u && by * 4u + y < mip.height; y++ )
+                {
+                    for( std::uint32_t x = 0u; x < 4u && bx * 4u + x < mip.width; x++ )
+                    {
+                        std::memcpy( dst + std::size_t( by * 4u + y ) * mip.rowPitch + ( bx * 4u + x ) * 4u,px[y * 4u + x],4u );
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+double BlockCompression::ComputePsnr( const Image& reference,const Image& test,std::uint32_t channelCount )
+{
+    if( Image::IsCompressed( reference.GetFormat() ) || Image::IsCompressed( test.GetFormat() ) ||
+        reference.GetWidth() != test.GetWidth() || reference.GetHeight() != test.GetHeight() )
+    {
+        throw BC_EXCEPT( "PSNR needs two uncompressed images of the same size" );
+    }
+    const auto& a = reference.GetMip( 0u );
+    const auto& b = test.GetMip( 0u );
+    const auto pa = reinterpret_cast<const std::uint8_t*>( reference.GetMipData( 0u ) );
+    const auto pb = reinterpret_cast<const std::uint8_t*>( test.GetMipData( 0u ) );
+    double sum = 0.0;
+    for( std::uint32_t y = 0u; y < a.height; y++ )
+    {
+        std::uint64_t rowSum = 0u;
+        for( std::uint32_t x = 0u; x < a.width; x++ )
+        {
+            for( std::uint32_t ch = 0u; ch < channelCount; ch++ )
+            {
+                const int d = int( pa[std::size_t( y ) * a.rowPitch + x * 4u + ch] ) - int( pb[std::size_t( y ) * b.rowPitch + x * 4u + ch] );
+                rowSum += std::uint64_t( d * d );
+            }
+        }
+        sum += double( rowSum );
+    }
+    if( sum == 0.0 )
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    const auto mse = sum / ( double( a.width ) * a.height * channelCount );
+    return 10.0 * std::log10( 255.0 * 255.0 / mse );
+}
+
+std::uint32_t BlockCompression::GetChannelCount( TextureCompression compression ) noexcept
+{
+    switch( compression )
+    {
+    case TextureCompression::BC1: return 3u;
+    case TextureCompression::BC4: return 1u;
+    case TextureCompression::BC5: return 2u;
+    default: return 4u;
+    }
+}
+
+ImageFormat BlockCompression::GetFormat( TextureCompression compression,bool srgb ) noexcept
+{
+    switch( compression )
+    {
+    case TextureCompression::BC1: return srgb ? ImageFormat::BC1Srgb : ImageFormat::BC1;
+    case TextureCompression::BC3: return srgb ? ImageFormat::BC3Srgb : ImageFormat::BC3;
+    case TextureCompression::BC4: return ImageFormat::BC4;
+    case TextureCompression::BC5: return ImageFormat::BC5;
+    case TextureCompression::BC7: return srgb ? ImageFormat::BC7Srgb : ImageFormat::BC7;
+    default: return srgb ? ImageFormat::RGBA8Srgb : ImageFormat::RGBA8;
+    }
+}
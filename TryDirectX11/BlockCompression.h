@@ -0,0 +1,48 @@
+#pragma once
+#include "Image.h"
+#include <cstdint>
+
+class ThreadPool;
+
+enum class TextureCompression : std::uint8_t
+{
+    None,
+    // RGB，alpha 只有透明 / 不透明两种（< 128 的像素编成透明）
+    BC1,
+    // BC1 的颜色 + BC4 的 alpha
+    BC3,
+    // 单通道（取 R），适合高度图、遮蔽等
+    BC4,
+    // 双通道（取 R、G），适合切线空间法线
+    BC5,
+    // RGBA，质量最好，编码也最慢
+    BC7,
+};
+
+enum class BcQuality : std::uint8_t
+{
+    // 包围盒端点，不做精修；适合导入时预览
+    Fast,
+    // 主轴（PCA）端点 + 一轮最小二乘精修
+    Normal,
+    // 多轮精修和更大的端点搜索；BC7 还会尝试 mode 5 的四种通道旋转
+    High,
+};
+
+// BC1/3/4/5/7 的 CPU 编码器和验证用的解码器。每次编码一个 4x4 块，块内按通道分开存放，
+// 用 SSE 一次算 4 个像素（BC4 一次 16 个）；块之间互不依赖，给了线程池就按块行并行。
+// BC7 只用单子集的 mode 6 和 mode 5，解码器也只支持单子集的 mode 4/5/6，遇到其他 mode 抛 ImageException
+namespace BlockCompression
+{
+    // 压缩 RGBA8 图像的所有 mip 层。源是 sRGB 时 BC1/3/7 输出对应的 sRGB 格式（BC4/BC5 没有 sRGB 版本）。
+    // 边长不必是 4 的倍数，边缘块用最后一行 / 列补齐。
+    // 不能在 pPool 自己的任务里传入 pPool（ThreadPool 不支持嵌套分发），这时传 nullptr 在当前线程编码
+    Image Encode( const Image& source,TextureCompression compression,BcQuality quality,ThreadPool* pPool = nullptr );
+    // 解压所有 mip 层到 RGBA8 / RGBA8Srgb；BC4 解成 (r,0,0,255)，BC5 解成 (r,g,0,255)，和 D3D 采样结果一致
+    Image Decode( const Image& source );
+    // 比较两张 RGBA8 图像第 0 层的前 channelCount 个通道，完全相同时返回 +inf
+    double ComputePsnr( const Image& reference,const Image& test,std::uint32_t channelCount = 4u );
+    // 该压缩格式实际保存的通道数（BC1 按 RGB 算）
+    std::uint32_t GetChannelCount( TextureCompression compression ) noexcept;
+    ImageFormat GetFormat( TextureCompression compression,bool srgb ) noexcept;
+}
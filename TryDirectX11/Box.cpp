@@ -2,23 +2,10 @@
 #include "BindableBase.h"
 #include "GraphicsThrowMacros.h"
 
-Box::Box(Graphics &gfx,
-         std::mt19937 &rng,
-         std::uniform_real_distribution<float> &adist,
-         std::uniform_real_distribution<float> &ddist,
-         std::uniform_real_distribution<float> &odist,
-         std::uniform_real_distribution<float> &rdist)
+Box::Box(Graphics &gfx)
         :
-        r(rdist(rng)),
-        droll(ddist(rng)),
-        dpitch(ddist(rng)),
-        dyaw(ddist(rng)),
-        dphi(odist(rng)),
-        dtheta(odist(rng)),
-        dchi(odist(rng)),
-        chi(adist(rng)),
-        theta(adist(rng)),
-        phi(adist(rng)) {
+        transformCbuf(gfx, *this) {
+    DirectX::XMStoreFloat4x4(&transform, DirectX::XMMatrixIdentity());
 
     // 不重复添加重复的资源
     if (!IsStaticInitialized()) {
@@ -41,13 +28,14 @@ Box::Box(Graphics &gfx,
                         {-1.0f, 1.0f,  1.0f},
                         {1.0f,  1.0f,  1.0f},
                 };
-        AddStaticBind(std::make_unique<VertexBuffer>(gfx, vertices));
+        AddStaticBind(BindPool<VertexBuffer>::Emplace(gfx, vertices));
 
-        auto pvs = std::make_unique<VertexShader>(gfx, L"VertexShader.cso");
-        auto pvsbc = pvs->GetBytecode();
-        AddStaticBind(std::move(pvs));
+        const auto vs = BindPool<VertexShader>::Emplace(gfx, L"VertexShader.cso");
+        // blob 由 ComPtr 持有，pool 扩容移动对象也不影响这个指针
+        auto pvsbc = BindPool<VertexShader>::Get(vs).GetBytecode();
+        AddStaticBind(vs);
 
-        AddStaticBind(std::make_unique<PixelShader>(gfx, L"PixelShader.cso"));
+        AddStaticBind(BindPool<PixelShader>::Emplace(gfx, L"PixelShader.cso"));
 
         // create index buffer 索引默认情况下为 16 位
         const std::vector<unsigned short> indices =
@@ -59,7 +47,7 @@ Box::Box(Graphics &gfx,
                         0, 4, 2, 2, 4, 6,
                         0, 1, 4, 1, 5, 4
                 };
-        AddStaticIndexBuffer(std::make_unique<IndexBuffer>(gfx, indices));
+        AddStaticIndexBuffer(BindPool<IndexBuffer>::Emplace(gfx, indices));
 
         // lookup table for cube face colors
         // 给正方形每一个面一个颜色，因为顶点是共用的，所以顶点颜色会插值，我们可以给每个面都配一个单独的顶点和颜色，
@@ -83,7 +71,7 @@ Box::Box(Graphics &gfx,
                                 {0.0f, 1.0f, 1.0f},
                         }
                 };
-        AddStaticBind(std::make_unique<PixelConstantBuffer<ConstantBuffer2>>(gfx, cb2));
+        AddStaticBind(BindPool<PixelConstantBuffer<ConstantBuffer2>>::Emplace(gfx, cb2));
 
         const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
                 {
@@ -108,30 +96,25 @@ Box::Box(Graphics &gfx,
                 };
         // 在定义了顶点结构体之后，我们必须设法描述该顶点结构体的分量结构，使 Direct3D 知道该如何使用每个分量，如何读取顶点数据。
         // 这一描述信息是以输入布局（ID3D11InputLayout）的形式提供给 Direct3D 的 。
-        AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
+        AddStaticBind(BindPool<InputLayout>::Emplace(gfx, ied, pvsbc));
 
-        AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+        AddStaticBind(BindPool<Topology>::Emplace(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+
+        // 顺时针为正面；glTF 模型会换成逆时针，所以这里也要显式绑定
+        AddStaticBind(BindPool<Rasterizer>::Emplace(gfx, false));
     } else {
         SetIndexFromStatic();
     }
 
     // 单独绑定是因为每个 Cube 的变换方式都不一样
-    AddBind(std::make_unique<TransformCbuf>(gfx, *this));
+    AddInlineBind(transformCbuf);
 }
 
-void Box::Update(float dt) noexcept {
-    roll += droll * dt;
-    pitch += dpitch * dt;
-    yaw += dyaw * dt;
-    theta += dtheta * dt;
-    phi += dphi * dt;
-    chi += dchi * dt;
+void Box::DrawInstance(Graphics &gfx, DirectX::FXMMATRIX world) noexcept(!IS_DEBUG) {
+    DirectX::XMStoreFloat4x4(&transform, world);
+    Draw(gfx);
 }
 
 DirectX::XMMATRIX Box::GetTransformXM() const noexcept {
-    return DirectX::XMMatrixRotationRollPitchYaw(pitch, yaw, roll) *
-           DirectX::XMMatrixTranslation(r, 0.0f, 0.0f) *
-           DirectX::XMMatrixRotationRollPitchYaw(theta, phi, chi) *
-           // 离摄像机远一点
-           DirectX::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
+    return DirectX::XMLoadFloat4x4(&transform);
 }
@@ -1,33 +1,18 @@
 #pragma once
 #include "DrawbleBase.h"
+#include "TransformCbuf.h"
 
+// 箱子的网格、着色器和变换常量缓冲。运动参数已经移到 ECS 的 BoxMotion 组件里，
+// 所有箱子实体共享一个 Box，用 DrawInstance 按各自的世界矩阵绘制。
 class Box : public DrawableBase<Box>
 {
 public:
-    // mt19937 Mersenne Twister算法译为马特赛特旋转演算法，是伪随机数发生器之一
-    Box(Graphics& gfx, std::mt19937& rng,
-        std::uniform_real_distribution<float>& adist,
-        std::uniform_real_distribution<float>& ddist,
-        std::uniform_real_distribution<float>& odist,
-        std::uniform_real_distribution<float>& rdist);
-    void Update(float dt) noexcept override;
+    Box(Graphics& gfx);
+    void DrawInstance(Graphics& gfx, DirectX::FXMMATRIX world) noexcept(!IS_DEBUG);
     DirectX::XMMATRIX GetTransformXM() const noexcept override;
 private:
-    // positional
-    float r;
-    float roll = 0.0f;
-    float pitch = 0.0f;
-    float yaw = 0.0f;
-    float theta;
-    float phi;
-    float chi;
-    // speed (delta/s)
-    // 角速度
-    float droll;
-    float dpitch;
-    float dyaw;
-    // 世界空间中旋转
-    float dtheta;
-    float dphi;
-    float dchi;
+    // world matrix of the instance being drawn
+    DirectX::XMFLOAT4X4 transform;
+    // 每个 Box 自己的变换常量缓冲，直接是成员，不放进 BindPool
+    TransformCbuf transformCbuf;
 };
\ No newline at end of file
@@ -20,6 +20,15 @@
 ******************************************************************************************/
 #pragma once
 
+// IS_DEBUG follows NDEBUG unless the build defines it; Release must see 0 so noexcept(!IS_DEBUG) really is noexcept
+#ifndef IS_DEBUG
+#ifdef NDEBUG
+#define IS_DEBUG 0
+#else
+#define IS_DEBUG 1
+#endif
+#endif
+
 // target Windows 7 or later
 #define _WIN32_WINNT 0x0601
 #include <sdkddkver.h>
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Bindable.h"
+#include "BindStream.h"
 #include "GraphicsThrowMacros.h"
+#include "PerfCounters.h"
 
 // 到目前为止，我们一直使用的是静态缓冲（static buffer），它的内容是在初始化时固定下来的。相比之下，动态缓冲（dynamic buffer）的内容可以在每一帧中进行修改。
 // 当实现一些动画效果时，我们通常使用动态缓冲区。例如，我们要模拟一个水波效果，并通过函数 f(x ,z ,t) 来描述水波方程，计算当时间为 t 时，
@@ -13,7 +15,9 @@
 template<typename C>
 class ConstantBuffer : public Bindable {
 public:
-    void Update(Graphics &gfx, const C &consts) {
+    // 调用点必须自己选错误检查策略（见 GraphicsThrowMacros.h）：每个物体每帧都更新的用 GfxCheck::Unchecked
+    template<class Check>
+    void Update(Graphics &gfx, const C &consts) noexcept(!Check::checkResult) {
         INFOMAN(gfx);
         D3D11_MAPPED_SUBRESOURCE msr;
         // D3D11_USAGE_DYNAMIC：表示应用程序（CPU）会频繁更新资源中的数据内 容（例如，每帧更新一次）。GPU 可以从这种资源中读取数据，
@@ -28,13 +32,21 @@ public:
         //   D3D11_MAP_READ：表示应用程序（CPU）会读取 GPU 缓冲的的一个副本到系统内存中。
         // 4．MapFlags：可选标志，这里不使用，所以设置为 0；具体细节可参见 SDK 文档。
         // 5．pMappedResource：返回一个指向 D3D11_MAPPED_SUBRESOURCE 的指针，这样我们就可以访问用于读/写的资源数据。
-        GFX_THROW_INFO(GetContext(gfx)->Map(
+        GFX_CHECK_HR(Check, GetContext(gfx)->Map(
                 pConstantBuffer.Get(), 0u,
                 D3D11_MAP_WRITE_DISCARD, 0u,
                 &msr
         ));
+        if constexpr (!Check::checkResult) {
+            // 不抛异常，但也不能往无效的指针里写（设备丢失会在 Present 时报出来）
+            if (FAILED(hr)) {
+                return;
+            }
+        }
         memcpy(msr.pData, &consts, sizeof(consts));
         GetContext(gfx)->Unmap(pConstantBuffer.Get(), 0u);
+        PerfCounters::Add(PerfCounter::Maps);
+        PerfCounters::Add(PerfCounter::BytesMapped, sizeof(consts));
     }
 
     ConstantBuffer(Graphics &gfx, const C &consts) {
@@ -50,6 +62,9 @@ public:
         D3D11_SUBRESOURCE_DATA csd = {};
         csd.pSysMem = &consts;
         GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&cbd, &csd, &pConstantBuffer));
+        PerfCounters::Add(PerfCounter::BuffersCreated);
+        PerfCounters::Add(PerfCounter::BufferBytesCreated, cbd.ByteWidth);
+        gpuMemory.Track(GpuMemoryKind::Buffer, cbd.ByteWidth);
     }
 
     ConstantBuffer(Graphics &gfx) {
@@ -63,10 +78,18 @@ public:
         cbd.ByteWidth = sizeof(C);
         cbd.StructureByteStride = 0u;
         GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&cbd, nullptr, &pConstantBuffer));
+        PerfCounters::Add(PerfCounter::BuffersCreated);
+        PerfCounters::Add(PerfCounter::BufferBytesCreated, cbd.ByteWidth);
+        gpuMemory.Track(GpuMemoryKind::Buffer, cbd.ByteWidth);
+    }
+
+    ID3D11Buffer *GetBuffer() const noexcept {
+        return pConstantBuffer.Get();
     }
 
 protected:
     Microsoft::WRL::ComPtr<ID3D11Buffer> pConstantBuffer;
+    GpuAllocation gpuMemory;
 };
 
 template<typename C>
@@ -82,6 +105,10 @@ public:
         GetContext(gfx)->VSSetConstantBuffers(0u, 1u, pConstantBuffer.GetAddressOf());
     }
 
+    void Record(BindStream &stream) const override {
+        stream.PushVertexConstantBuffer(pConstantBuffer.Get(), 0u);
+    }
+
 };
 
 template<typename C>
@@ -94,4 +121,8 @@ public:
     void Bind(Graphics &gfx) noexcept override {
         GetContext(gfx)->PSSetConstantBuffers(0u, 1u, pConstantBuffer.GetAddressOf());
     }
+
+    void Record(BindStream &stream) const override {
+        stream.PushPixelConstantBuffer(pConstantBuffer.Get(), 0u);
+    }
 };
\ No newline at end of file
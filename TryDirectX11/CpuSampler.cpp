@@ -0,0 +1,277 @@
+#include "CpuSampler.h"
+#include "MipChain.h"
+#include <algorithm>
+#include <emmintrin.h>
+
+#define SAMPLER_EXCEPT( note ) ImageException( __LINE__,__FILE__,"CpuSampler",(note) )
+
+LinearImage::LinearImage( const Image& image )
+    :
+    image( image )
+{
+    if( image.IsEmpty() || Image::IsCompressed( image.GetFormat() ) )
+    {
+        throw SAMPLER_EXCEPT( "LinearImage needs a non-empty RGBA8 or RGBA8Srgb image" );
+    }
+}
+
+std::uint32_t LinearImage::GetWidth() const noexcept
+{
+    return image.GetWidth();
+}
+
+std::uint32_t LinearImage::GetHeight() const noexcept
+{
+    return image.GetHeight();
+}
+
+ImageFormat LinearImage::GetFormat() const noexcept
+{
+    return image.GetFormat();
+}
+
+std::uint32_t LinearImage::GetMipCount() const noexcept
+{
+    return image.GetMipCount();
+}
+
+LinearImage::LevelView LinearImage::GetLevel( std::uint32_t level ) const noexcept
+{
+    const auto& mip = image.GetMip( level );
+    return { image.GetMipData( level ),mip.width,mip.height,mip.rowPitch };
+}
+
+namespace
+{
+    // sRGB 转线性的表，乘好 255，和 UNORM 的像素落在同一个范围里，最后统一乘 1/255
+    struct SrgbTable
+    {
+        float v[256];
+        SrgbTable() noexcept
+        {
+            for( int i = 0; i < 256; i++ )
+            {
+                v[i] = MipChain::SrgbToLinear( std::uint8_t( i ) ) * 255.0f;
+            }
+        }
+    };
+
+    const SrgbTable& GetSrgbTable() noexcept
+    {
+        static const SrgbTable table;
+        return table;
+    }
+
+    // SSE2 没有 roundps，截断之后比原值大的减 1
+    __m128 Floor( __m128 v ) noexcept
+    {
+        const auto t = _mm_cvtepi32_ps( _mm_cvttps_epi32( v ) );
+        return _mm_sub_ps( t,_mm_and_ps( _mm_cmpgt_ps( t,v ),_mm_set1_ps( 1.0f ) ) );
+    }
+
+    // 一个轴上四个点的双线性足迹：左（上）、右（下）两列的下标和右边那列的权重
+    void Address( __m128 u,__m128 size,AddressMode mode,__m128i& i0,__m128i& i1,__m128& frac ) noexcept
+    {
+        if( mode == AddressMode::Wrap )
+        {
+            u = _mm_sub_ps( u,Floor( u ) );
+        }
+        else
+        {
+            // 截到 [0,1] 和在像素下标上截断结果一样，顺便避免 cvttps 溢出
+            u = _mm_min_ps( _mm_max_ps( u,_mm_setzero_ps() ),_mm_set1_ps( 1.0f ) );
+        }
+        const auto p = _mm_sub_ps( _mm_mul_ps( u,size ),_mm_set1_ps( 0.5f ) );
+        auto f0 = Floor( p );
+        frac = _mm_sub_ps( p,f0 );
+        auto f1 = _mm_add_ps( f0,_mm_set1_ps( 1.0f ) );
+        if( mode == AddressMode::Wrap )
+        {
+            // f0 in [-1, size - 1], f1 in [0, size]
+            f0 = _mm_add_ps( f0,_mm_and_ps( _mm_cmplt_ps( f0,_mm_setzero_ps() ),size ) );
+            f1 = _mm_sub_ps( f1,_mm_and_ps( _mm_cmpge_ps( f1,size ),size ) );
+        }
+        else
+        {
+            const auto last = _mm_sub_ps( size,_mm_set1_ps( 1.0f ) );
+            f0 = _mm_min_ps( _mm_max_ps( f0,_mm_setzero_ps() ),last );
+            f1 = _mm_min_ps( f1,last );
+        }
+        i0 = _mm_cvttps_epi32( f0 );
+        i1 = _mm_cvttps_epi32( f1 );
+    }
+
+    // 0..255 的四个通道
+    template<bool srgb>
+    __m128 Decode( std::uint32_t texel ) noexcept
+    {
+        if constexpr( srgb )
+        {
+            const auto& t = GetSrgbTable().v;
+            return _mm_setr_ps( t[texel & 0xFFu],t[( texel >> 8u ) & 0xFFu],t[( texel >> 16u ) & 0xFFu],float( texel >> 24u ) );
+        }
+        else
+        {
+            const auto zero = _mm_setzero_si128();
+            auto i = _mm_cvtsi32_si128( int( texel ) );
+            i = _mm_unpacklo_epi8( i,zero );
+            i = _mm_unpacklo_epi16( i,zero );
+            return _mm_cvtepi32_ps( i );
+        }
+    }
+
+    // 四个点各在自己的层（views[k]）上做双线性，结果还是 0..255
+    template<class Texture,bool srgb>
+    void Bilinear4( const typename Texture::LevelView* const views[4],__m128 u,__m128 v,AddressMode mode,__m128 out[4] ) noexcept
+    {
+        const auto width = _mm_setr_ps( float( views[0]->width ),float( views[1]->width ),float( views[2]->width ),float( views[3]->width ) );
+        const auto height = _mm_setr_ps( float( views[0]->height ),float( views[1]->height ),float( views[2]->height ),float( views[3]->height ) );
+        __m128i x0,x1,y0,y1;
+        __m128 fx,fy;
+        Address( u,width,mode,x0,x1,fx );
+        Address( v,height,mode,y0,y1,fy );
+        const auto one = _mm_set1_ps( 1.0f );
+        const auto gx = _mm_sub_ps( one,fx );
+        const auto gy = _mm_sub_ps( one,fy );
+        alignas( 16 ) std::int32_t ix0[4],ix1[4],iy0[4],iy1[4];
+        alignas( 16 ) float w00[4],w10[4],w01[4],w11[4];
+        _mm_store_si128( reinterpret_cast<__m128i*>( ix0 ),x0 );
+        _mm_store_si128( reinterpret_cast<__m128i*>( ix1 ),x1 );
+        _mm_store_si128( reinterpret_cast<__m128i*>( iy0 ),y0 );
+        _mm_store_si128( reinterpret_cast<__m128i*>( iy1 ),y1 );
+        _mm_store_ps( w00,_mm_mul_ps( gx,gy ) );
+        _mm_store_ps( w10,_mm_mul_ps( fx,gy ) );
+        _mm_store_ps( w01,_mm_mul_ps( gx,fy ) );
+        _mm_store_ps( w11,_mm_mul_ps( fx,fy ) );
+        for( int k = 0; k < 4; k++ )
+        {
+            const auto& view = *views[k];
+            const auto c0 = Texture::ColumnOffset( view,ix0[k] );
+            const auto c1 = Texture::ColumnOffset( view,ix1[k] );
+            const auto r0 = Texture::RowOffset( view,iy0[k] );
+            const auto r1 = Texture::RowOffset( view,iy1[k] );
+            const auto t00 = Decode<srgb>( Texture::Fetch( view,r0 + c0 ) );
+            const auto t10 = Decode<srgb>( Texture::Fetch( view,r0 + c1 ) );
+            const auto t01 = Decode<srgb>( Texture::Fetch( view,r1 + c0 ) );
+            const auto t11 = Decode<srgb>( Texture::Fetch( view,r1 + c1 ) );
+            out[k] = _mm_add_ps(
+                _mm_add_ps( _mm_mul_ps( t00,_mm_set1_ps( w00[k] ) ),_mm_mul_ps( t10,_mm_set1_ps( w10[k] ) ) ),
+                _mm_add_ps( _mm_mul_ps( t01,_mm_set1_ps( w01[k] ) ),_mm_mul_ps( t11,_mm_set1_ps( w11[k] ) ) ) );
+        }
+    }
+
+    // 凑不满四个的尾巴用最后一个点补齐，补出来的结果不写回
+    void LoadGroup( const float* p,std::size_t i,std::size_t count,float out[4] ) noexcept
+    {
+        for( std::size_t k = 0u; k < 4u; k++ )
+        {
+            out[k] = p[std::min( i + k,count - 1u )];
+        }
+    }
+
+    void StoreGroup( const __m128 colors[4],std::size_t i,std::size_t count,SampledColor* pOut ) noexcept
+    {
+        const auto scale = _mm_set1_ps( 1.0f / 255.0f );
+        for( std::size_t k = 0u; k < 4u && i + k < count; k++ )
+        {
+            _mm_storeu_ps( &pOut[i + k].r,_mm_mul_ps( colors[k],scale ) );
+        }
+    }
+
+    template<class Texture,bool srgb>
+    void BilinearImpl( const Texture& texture,std::uint32_t level,const float* pU,const float* pV,std::size_t count,
+        AddressMode mode,SampledColor* pOut ) noexcept
+    {
+        const auto view = texture.GetLevel( level );
+        const typename Texture::LevelView* const views[4] = { &view,&view,&view,&view };
+        alignas( 16 ) float u[4],v[4];
+        __m128 colors[4];
+        for( std::size_t i = 0u; i < count; i += 4u )
+        {
+            if( i + 4u <= count )
+            {
+                Bilinear4<Texture,srgb>( views,_mm_loadu_ps( pU + i ),_mm_loadu_ps( pV + i ),mode,colors );
+            }
+            else
+            {
+                LoadGroup( pU,i,count,u );
+                LoadGroup( pV,i,count,v );
+                Bilinear4<Texture,srgb>( views,_mm_load_ps( u ),_mm_load_ps( v ),mode,colors );
+            }
+            StoreGroup( colors,i,count,pOut );
+        }
+    }
+
+    template<class Texture,bool srgb>
+    void TrilinearImpl( const Texture& texture,const float* pU,const float* pV,const float* pLod,std::size_t count,
+        AddressMode mode,SampledColor* pOut ) noexcept
+    {
+        typename Texture::LevelView levels[Image::maxMipCount];
+        const auto mipCount = texture.GetMipCount();
+        for( std::uint32_t i = 0u; i < mipCount; i++ )
+        {
+            levels[i] = texture.GetLevel( i );
+        }
+        const auto maxLod = _mm_set1_ps( float( mipCount - 1u ) );
+        alignas( 16 ) float u[4],v[4],lod[4],t[4];
+        alignas( 16 ) std::int32_t l0[4];
+        __m128 fine[4],coarse[4];
+        for( std::size_t i = 0u; i < count; i += 4u )
+        {
+            LoadGroup( pU,i,count,u );
+            LoadGroup( pV,i,count,v );
+            LoadGroup( pLod,i,count,lod );
+            const auto clamped = _mm_min_ps( _mm_max_ps( _mm_load_ps( lod ),_mm_setzero_ps() ),maxLod );
+            const auto base = Floor( clamped );
+            _mm_store_ps( t,_mm_sub_ps( clamped,base ) );
+            _mm_store_si128( reinterpret_cast<__m128i*>( l0 ),_mm_cvttps_epi32( base ) );
+            const typename Texture::LevelView* fineViews[4];
+            const typename Texture::LevelView* coarseViews[4];
+            for( int k = 0; k < 4; k++ )
+            {
+                fineViews[k] = &levels[l0[k]];
+                coarseViews[k] = &levels[std::min( std::uint32_t( l0[k] ) + 1u,mipCount - 1u )];
+            }
+            Bilinear4<Texture,srgb>( fineViews,_mm_load_ps( u ),_mm_load_ps( v ),mode,fine );
+            Bilinear4<Texture,srgb>( coarseViews,_mm_load_ps( u ),_mm_load_ps( v ),mode,coarse );
+            for( int k = 0; k < 4; k++ )
+            {
+                fine[k] = _mm_add_ps( fine[k],_mm_mul_ps( _mm_sub_ps( coarse[k],fine[k] ),_mm_set1_ps( t[k] ) ) );
+            }
+            StoreGroup( fine,i,count,pOut );
+        }
+    }
+}
+
+template<class Texture>
+void CpuSampler::Bilinear( const Texture& texture,std::uint32_t level,const float* pU,const float* pV,std::size_t count,
+    AddressMode mode,SampledColor* pOut ) noexcept
+{
+    if( Image::IsSrgb( texture.GetFormat() ) )
+    {
+        BilinearImpl<Texture,true>( texture,level,pU,pV,count,mode,pOut );
+    }
+    else
+    {
+        BilinearImpl<Texture,false>( texture,level,pU,pV,count,mode,pOut );
+    }
+}
+
+template<class Texture>
+void CpuSampler::Trilinear( const Texture& texture,const float* pU,const float* pV,const float* pLod,std::size_t count,
+    AddressMode mode,SampledColor* pOut ) noexcept
+{
+    if( Image::IsSrgb( texture.GetFormat() ) )
+    {
+        TrilinearImpl<Texture,true>( texture,pU,pV,pLod,count,mode,pOut );
+    }
+    else
+    {
+        TrilinearImpl<Texture,false>( texture,pU,pV,pLod,count,mode,pOut );
+    }
+}
+
+template void CpuSampler::Bilinear<TiledImage>( const TiledImage&,std::uint32_t,const float*,const float*,std::size_t,AddressMode,SampledColor* ) noexcept;
+template void CpuSampler::Bilinear<LinearImage>( const LinearImage&,std::uint32_t,const float*,const float*,std::size_t,AddressMode,SampledColor* ) noexcept;
+template void CpuSampler::Trilinear<TiledImage>( const TiledImage&,const float*,const float*,const float*,std::size_t,AddressMode,SampledColor* ) noexcept;
+template void CpuSampler::Trilinear<LinearImage>( const LinearImage&,const float*,const float*,const float*,std::size_t,AddressMode,SampledColor* ) noexcept;
@@ -0,0 +1,90 @@
+#pragma once
+#include "TiledImage.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// 行优先的 Image 套上和 TiledImage 一样的接口（LevelView / GetLevel / RowOffset / ColumnOffset / Fetch），
+// CpuSampler 两种布局都能采，Tools/SamplerBench 拿它当对照组
+class LinearImage
+{
+public:
+    struct LevelView
+    {
+        const std::byte* pData;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t rowPitch;
+    };
+public:
+    // 只保存引用，image 要比 LinearImage 活得久；必须是 RGBA8 / RGBA8Srgb
+    explicit LinearImage( const Image& image );
+    std::uint32_t GetWidth() const noexcept;
+    std::uint32_t GetHeight() const noexcept;
+    ImageFormat GetFormat() const noexcept;
+    std::uint32_t GetMipCount() const noexcept;
+    LevelView GetLevel( std::uint32_t level ) const noexcept;
+    static std::size_t RowOffset( const LevelView& level,std::uint32_t y ) noexcept
+    {
+        return std::size_t( y ) * level.rowPitch;
+    }
+    static std::size_t ColumnOffset( const LevelView&,std::uint32_t x ) noexcept
+    {
+        return std::size_t( x ) * 4u;
+    }
+    static std::uint32_t Fetch( const LevelView& level,std::size_t offset ) noexcept
+    {
+        std::uint32_t texel;
+        std::memcpy( &texel,level.pData + offset,4u );
+        return texel;
+    }
+private:
+    const Image& image;
+};
+
+enum class AddressMode : std::uint8_t
+{
+    // 坐标取小数部分，边上的双线性足迹绕到对边
+    Wrap,
+    // 坐标截到 [0,1]，边上的像素向外延伸
+    Clamp,
+};
+
+struct SampledColor
+{
+    float r;
+    float g;
+    float b;
+    float a;
+};
+
+// CPU 上的纹理过滤，结果和 D3D11 的 MIN_MAG_MIP_LINEAR 采样器一致（像素中心在 +0.5 处）。
+// 四个采样点一组：寻址、权重用 SSE 一次算四个点，每个点的 4 个（三线性 8 个）像素各占一个 __m128 做混合。
+// sRGB 格式先查表转到线性再滤波，返回值总是线性的 [0,1]。
+// Texture 是 TiledImage 或 LinearImage（在 CpuSampler.cpp 里显式实例化）；
+// Wrap 模式要求 |u|、|v| < 2^23，超出时小数部分已经没有精度
+namespace CpuSampler
+{
+    template<class Texture>
+    void Bilinear( const Texture& texture,std::uint32_t level,const float* pU,const float* pV,std::size_t count,
+        AddressMode mode,SampledColor* pOut ) noexcept;
+    // lod 是 mip 层号（带小数），超出 [0, mipCount - 1] 时截断
+    template<class Texture>
+    void Trilinear( const Texture& texture,const float* pU,const float* pV,const float* pLod,std::size_t count,
+        AddressMode mode,SampledColor* pOut ) noexcept;
+
+    template<class Texture>
+    SampledColor Bilinear( const Texture& texture,std::uint32_t level,float u,float v,AddressMode mode ) noexcept
+    {
+        SampledColor c;
+        Bilinear( texture,level,&u,&v,1u,mode,&c );
+        return c;
+    }
+    template<class Texture>
+    SampledColor Trilinear( const Texture& texture,float u,float v,float lod,AddressMode mode ) noexcept
+    {
+        SampledColor c;
+        Trilinear( texture,&u,&v,&lod,1u,mode,&c );
+        return c;
+    }
+}
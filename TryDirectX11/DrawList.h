@@ -0,0 +1,72 @@
+#pragma once
+#include "FrameArena.h"
+#include "MeshletCulling.h"
+#include <algorithm>
+#include <cstddef>
+
+template<typename T>
+struct DrawItem
+{
+	// 裁剪空间的 w，也就是到相机平面的距离
+	float depth;
+	const T* pObject;
+};
+
+// 一帧的绘制列表：包围球在视锥外的物体不进列表，剩下的按深度从近到远排，先画近的让 early-z 挡掉后面的像素。
+// 元素默认放在 FrameMemory 上，列表只活这一帧，建表和排序都不走通用堆
+template<typename T, typename Allocator = FrameAllocator<DrawItem<T>>>
+class DrawList
+{
+public:
+	// viewProjection 和 MeshletCullView::FromMatrix 一样是行向量矩阵；capacity 是最多会加进来的物体个数
+	DrawList(const float (&viewProjection)[4][4], std::size_t capacity, const Allocator& allocator = Allocator())
+		:
+		view(MeshletCullView::FromMatrix(viewProjection, { 0.0f, 0.0f, 0.0f })),
+		items(allocator)
+	{
+		for (int r = 0; r < 4; r++)
+		{
+			depthColumn[r] = viewProjection[r][3];
+		}
+		items.reserve(capacity);
+	}
+	// 在视锥里就加进列表并返回 true
+	bool Add(const T& object, const float (&center)[3], float radius)
+	{
+		if (!MeshletCulling::IsSphereVisible(view, center, radius))
+		{
+			nCulled++;
+			return false;
+		}
+		const auto depth = depthColumn[0] * center[0] + depthColumn[1] * center[1] + depthColumn[2] * center[2] + depthColumn[3];
+		items.push_back({ depth, &object });
+		return true;
+	}
+	void SortFrontToBack()
+	{
+		std::sort(items.begin(), items.end(), [](const DrawItem<T>& a, const DrawItem<T>& b) {
+			return a.depth < b.depth;
+		});
+	}
+	auto begin() const noexcept
+	{
+		return items.begin();
+	}
+	auto end() const noexcept
+	{
+		return items.end();
+	}
+	std::size_t size() const noexcept
+	{
+		return items.size();
+	}
+	std::size_t GetCulledCount() const noexcept
+	{
+		return nCulled;
+	}
+private:
+	MeshletCullView view;
+	float depthColumn[4];
+	std::vector<DrawItem<T>, Allocator> items;
+	std::size_t nCulled = 0u;
+};
@@ -1,31 +1,113 @@
 #include "Drawable.h"
 #include "GraphicsThrowMacros.h"
+#include "Bindable.h"
 #include "IndexBuffer.h"
+#include "PerfCounters.h"
 #include <cassert>
-#include <typeinfo>
+
+bool Drawable::bindStreamEnabled = false;
 
 void Drawable::Draw( Graphics& gfx ) const noexcept(!IS_DEBUG)
 {
-    for( auto& b : binds )
+    if( const auto pTrace = gfx.GetTrace() )
+    {
+        // 两种路径做的事一样，trace 统一按命令流记录
+        CompileBindStream();
+        stream.Trace( *pTrace );
+        GetStaticStream().Trace( *pTrace );
+    }
+    if( bindStreamEnabled )
+    {
+        CompileBindStream();
+        stream.Execute( gfx );
+        GetStaticStream().Execute( gfx );
+    }
+    else
+    {
+        PerfCounters::Add( PerfCounter::Binds,std::int64_t( inlineBinds.size() + binds.size() + GetStaticBinds().size() ) );
+        for( const auto p : inlineBinds )
+        {
+            p->Bind( gfx );
+        }
+        // 句柄里带着类型编号，直接查表调用具体类型的 Bind，对象都在各自 pool 的连续内存里
+        for( const auto h : binds )
+        {
+            BindRegistry::Bind( h,gfx );
+        }
+        for( const auto h : GetStaticBinds() )
+        {
+            BindRegistry::Bind( h,gfx );
+        }
+    }
+    gfx.DrawIndexed( indexCount,startIndex,0 );
+}
+
+void Drawable::CompileBindStream() const
+{
+    // 顺序和逐个 Bind 一样（先实例的再 static 的），结果才一致
+    if( stream.IsEmpty() )
     {
-        b->Bind( gfx );
+        for( const auto p : inlineBinds )
+        {
+            p->Record( stream );
+        }
+        for( const auto h : binds )
+        {
+            BindRegistry::Record( h,stream );
+        }
     }
-    for( auto& b : GetStaticBinds() )
+    auto& staticStream = GetStaticStream();
+    if( staticStream.IsEmpty() )
+    {
+        for( const auto h : GetStaticBinds() )
+        {
+            BindRegistry::Record( h,staticStream );
+        }
+    }
+}
+
+void Drawable::AddBind( BindHandle bind ) noexcept(!IS_DEBUG)
+{
+    assert( "*Must* use AddIndexBuffer to bind index buffer" && !BindPool<IndexBuffer>::Owns( bind ) );
+    binds.push_back( bind );
+    stream.Clear();
+}
+
+void Drawable::AddInlineBind( Bindable& bind ) noexcept
+{
+    inlineBinds.push_back( &bind );
+    stream.Clear();
+}
+
+void Drawable::AddIndexBuffer( BindHandle ibuf ) noexcept(!IS_DEBUG)
+{
+    assert( "Attempting to add index buffer a second time" && indexCount == 0u );
+    indexCount = BindPool<IndexBuffer>::Get( ibuf ).GetCount();
+    binds.push_back( ibuf );
+    stream.Clear();
+}
+
+void Drawable::SetIndexRange( UINT start,UINT count ) noexcept
+{
+    startIndex = start;
+    indexCount = count;
+}
+
+Drawable::~Drawable()
+{
+    // 实例自己的 Bindable 归还给 pool；static binds 跟 pool 一起活到程序结束
+    for( const auto h : binds )
     {
-        b->Bind( gfx );
+        BindRegistry::Release( h );
     }
-    gfx.DrawIndexed( pIndexBuffer->GetCount() );
 }
 
-void Drawable::AddBind( std::unique_ptr<Bindable> bind ) noexcept(!IS_DEBUG)
+void Drawable::SetBindStreamEnabled( bool enable ) noexcept
 {
-    assert( "*Must* use AddIndexBuffer to bind index buffer" && typeid(*bind) != typeid(IndexBuffer) );
-    binds.push_back( std::move( bind ) );
+    bindStreamEnabled = enable;
 }
 
-void Drawable::AddIndexBuffer( std::unique_ptr<IndexBuffer> ibuf ) noexcept(!IS_DEBUG)
+bool Drawable::BindStreamIsEnabled() noexcept
 {
-    assert( "Attempting to add index buffer a second time" && pIndexBuffer == nullptr );
-    pIndexBuffer = ibuf.get();
-    binds.push_back( std::move( ibuf ) );
-}
\ No newline at end of file
+    return bindStreamEnabled;
+}
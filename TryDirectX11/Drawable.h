@@ -1,5 +1,8 @@
 #pragma once
 #include "Graphics.h"
+#include "BindPool.h"
+#include "BindStream.h"
+#include "SmallVector.h"
 #include <DirectXMath.h>
 
 class Bindable;
@@ -13,14 +16,35 @@ public:
     Drawable(const Drawable&) = delete;
     virtual DirectX::XMMATRIX GetTransformXM() const noexcept = 0;
     void Draw(Graphics& gfx) const noexcept(!IS_DEBUG);
-    virtual void Update(float dt) noexcept = 0;
-    void AddBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG);
-    void AddIndexBuffer(std::unique_ptr<class IndexBuffer> ibuf) noexcept(!IS_DEBUG);
-    virtual ~Drawable() = default;
+    // 传入 BindPool<T>::Emplace 返回的句柄，Drawable 析构时归还给 pool
+    void AddBind(BindHandle bind) noexcept(!IS_DEBUG);
+    void AddIndexBuffer(BindHandle ibuf) noexcept(!IS_DEBUG);
+    virtual ~Drawable();
+    // true: Draw 执行编译好的 BindStream；false（默认）: 逐个通过 BindRegistry 调用 Bind
+    static void SetBindStreamEnabled(bool enable) noexcept;
+    static bool BindStreamIsEnabled() noexcept;
+protected:
+    // 派生类自己的成员 Bindable（例如 TransformCbuf），就放在 Drawable 对象里，不经过 pool，也不由 Drawable 释放；
+    // 它们在 pool 句柄之前绑定
+    void AddInlineBind(Bindable& bind) noexcept;
+    // 只画索引缓冲里的一段（例如几级 LOD 放在同一个索引缓冲里），默认是整个缓冲
+    void SetIndexRange(UINT start, UINT count) noexcept;
 private:
     // Drawable 也要访问 Static Bind
-    virtual const std::vector<std::unique_ptr<Bindable>>& GetStaticBinds() const noexcept = 0;
+    virtual const std::vector<BindHandle>& GetStaticBinds() const noexcept = 0;
+    // static binds 编译成的命令流，同一类型的 Drawable 共用一份（DrawableBase<T> 里的静态成员）
+    virtual BindStream& GetStaticStream() const noexcept = 0;
+    // no-op for the streams that are already compiled
+    void CompileBindStream() const;
 private:
-    const IndexBuffer* pIndexBuffer = nullptr;
-    std::vector<std::unique_ptr<Bindable>> binds;
-};
\ No newline at end of file
+    // 创建时从 IndexBuffer 取一次，Draw 时不用再通过句柄去找
+    UINT indexCount = 0u;
+    UINT startIndex = 0u;
+    // 常见情况下一个 Drawable 只有一个自己的 Bindable（TransformCbuf），内联存储省掉每个对象的堆分配；
+    // 每个 Drawable 都会读到这些成员，所以容量按 Box 取最小，对象尽量少占缓存行
+    SmallVector<Bindable*, 1> inlineBinds;
+    SmallVector<BindHandle, 2> binds;
+    // 只有这个 Drawable 自己的 Bindable：第一次 Draw 时编译，绑定集合变化时清空
+    mutable BindStream stream;
+    static bool bindStreamEnabled;
+};
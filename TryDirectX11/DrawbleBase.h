@@ -12,41 +12,52 @@ public:
     {
         return !staticBinds.empty();
     }
-    void AddStaticBind( std::unique_ptr<Bindable> bind ) noexcept(!IS_DEBUG)
+    void AddStaticBind( BindHandle bind ) noexcept(!IS_DEBUG)
     {
-        assert( "*Must* use AddIndexBuffer to bind index buffer" && typeid(*bind) != typeid(IndexBuffer) );
-        staticBinds.push_back( std::move( bind ) );
+        assert( "*Must* use AddIndexBuffer to bind index buffer" && !BindPool<IndexBuffer>::Owns( bind ) );
+        staticBinds.push_back( bind );
+        staticStream.Clear();
     }
-    void AddStaticIndexBuffer( std::unique_ptr<IndexBuffer> ibuf ) noexcept(!IS_DEBUG)
+    void AddStaticIndexBuffer( BindHandle ibuf ) noexcept(!IS_DEBUG)
     {
-        assert( "Attempting to add index buffer a second time" && pIndexBuffer == nullptr );
-        pIndexBuffer = ibuf.get();
-        staticBinds.push_back( std::move( ibuf ) );
+        assert( "Attempting to add index buffer a second time" && indexCount == 0u );
+        indexCount = BindPool<IndexBuffer>::Get( ibuf ).GetCount();
+        staticBinds.push_back( ibuf );
+        staticStream.Clear();
     }
 
-    // 因为 Drawable Draw 中对每个 Cube 都要调用 pIndexBuffer->GetCount()，而如果这个 Cube 没有初始化
-    // （我们修改成某些 Bindable 只需初始化一次），pIndexBuffer 就是空的，因此这里是重新在 staticBinds 里面再找出来
+    // 因为 Drawable Draw 中对每个 Cube 都要用到 indexCount，而如果这个 Cube 没有初始化
+    // （我们修改成某些 Bindable 只需初始化一次），indexCount 就是 0，因此这里是重新在 staticBinds 里面再找出来
     void SetIndexFromStatic() noexcept(!IS_DEBUG)
     {
-        assert( "Attempting to add index buffer a second time" && pIndexBuffer == nullptr );
-        for( const auto& b : staticBinds )
+        assert( "Attempting to add index buffer a second time" && indexCount == 0u );
+        for( const auto h : staticBinds )
         {
-            if( const auto p = dynamic_cast<IndexBuffer*>(b.get()) )
+            // 比较句柄里的类型编号，不再需要 dynamic_cast
+            if( BindPool<IndexBuffer>::Owns( h ) )
             {
-                pIndexBuffer = p;
+                indexCount = BindPool<IndexBuffer>::Get( h ).GetCount();
                 return;
             }
         }
-        assert( "Failed to find index buffer in static binds" && pIndexBuffer != nullptr );
+        assert( "Failed to find index buffer in static binds" && indexCount != 0u );
     }
 private:
-    const std::vector<std::unique_ptr<Bindable>>& GetStaticBinds() const noexcept override
+    const std::vector<BindHandle>& GetStaticBinds() const noexcept override
     {
         return staticBinds;
     }
+    BindStream& GetStaticStream() const noexcept override
+    {
+        return staticStream;
+    }
 private:
-    static std::vector<std::unique_ptr<Bindable>> staticBinds;
+    static std::vector<BindHandle> staticBinds;
+    // staticBinds 编译成的命令流，所有 T 的实例共用，第一次用命令流画 T 时编译
+    static BindStream staticStream;
 };
 
 template<class T>
-std::vector<std::unique_ptr<Bindable>> DrawableBase<T>::staticBinds;
\ No newline at end of file
+std::vector<BindHandle> DrawableBase<T>::staticBinds;
+template<class T>
+BindStream DrawableBase<T>::staticStream;
\ No newline at end of file
@@ -2,7 +2,8 @@
 #include "Window.h"
 #include "Graphics.h"
 #include <dxgidebug.h>
-#include <memory>
+#include <algorithm>
+#include <sstream>
 #include "GraphicsThrowMacros.h"
 #include "WindowsThrowMacros.h"
 
@@ -42,22 +43,83 @@ void DxgiInfoManager::Set() noexcept
 	next = pDxgiInfoQueue->GetNumStoredMessages(DXGI_DEBUG_ALL);
 }
 
-std::vector<std::string> DxgiInfoManager::GetMessages() const
+bool DxgiInfoManager::Harvest()
+{
+	nHarvestedCallSites = nCallSites;
+	nCallSites = 0u;
+	const auto end = pDxgiInfoQueue->GetNumStoredMessages(DXGI_DEBUG_ALL);
+	// 绝大多数帧什么消息都没有，一次计数查询就结束了
+	if (end == next)
+	{
+		offsets.clear();
+		return false;
+	}
+	// 队列被清空过（或者超出了存储上限被截断），从头开始读
+	const auto first = end < next ? 0u : next;
+	const auto severe = Decode(first, end);
+	next = end;
+	// 纯 INFO / MESSAGE 级别的消息（比如创建资源时的提示）不算问题
+	return severe;
+}
+
+std::vector<std::string> DxgiInfoManager::GetHarvestedMessages() const
 {
 	std::vector<std::string> messages;
+	for (const auto o : offsets)
+	{
+		messages.emplace_back(&arena[o]);
+	}
+	// 调用点只在真的出了消息时才格式化
+	if (nHarvestedCallSites > 0u)
+	{
+		messages.emplace_back("[Call Sites] (most recent last)");
+		const auto n = std::min<unsigned long long>(nHarvestedCallSites, maxCallSites);
+		for (auto i = nHarvestedCallSites - n; i < nHarvestedCallSites; i++)
+		{
+			const auto& site = callSites[i % maxCallSites];
+			std::ostringstream oss;
+			oss << site.file << "(" << site.line << ")";
+			messages.push_back(oss.str());
+		}
+	}
+	return messages;
+}
+
+std::vector<std::string> DxgiInfoManager::GetMessages()
+{
 	const auto end = pDxgiInfoQueue->GetNumStoredMessages(DXGI_DEBUG_ALL);
-	for (auto i = next; i < end; i++)
+	Decode(end < next ? 0u : next, end);
+	std::vector<std::string> messages;
+	for (const auto o : offsets)
+	{
+		messages.emplace_back(&arena[o]);
+	}
+	return messages;
+}
+
+bool DxgiInfoManager::Decode(unsigned long long first, unsigned long long end)
+{
+	bool severe = false;
+	arena.clear();
+	offsets.clear();
+	for (auto i = first; i < end; i++)
 	{
 		HRESULT hr;
 		SIZE_T messageLength;
 		// get the size of message i in bytes
 		GFX_THROW_NOINFO(pDxgiInfoQueue->GetMessage(DXGI_DEBUG_ALL, i, nullptr, &messageLength));
-		// allocate memory for message
-		auto bytes = std::make_unique<byte[]>(messageLength);
-		auto pMessage = reinterpret_cast<DXGI_INFO_QUEUE_MESSAGE*>(bytes.get());
-		// get the message and push its description into the vector
+		if (scratch.size() < messageLength)
+		{
+			scratch.resize(messageLength);
+		}
+		auto pMessage = reinterpret_cast<DXGI_INFO_QUEUE_MESSAGE*>(scratch.data());
+		// get the message and append its description to the arena
 		GFX_THROW_NOINFO(pDxgiInfoQueue->GetMessage(DXGI_DEBUG_ALL, i, pMessage, &messageLength));
-		messages.emplace_back(pMessage->pDescription);
+		offsets.push_back(arena.size());
+		arena.insert(arena.end(), pMessage->pDescription, pMessage->pDescription + pMessage->DescriptionByteLength);
+		// DescriptionByteLength 包含结尾的 '\0'，保险起见再补一个
+		arena.push_back('\0');
+		severe |= pMessage->Severity <= DXGI_INFO_QUEUE_MESSAGE_SEVERITY_WARNING;
 	}
-	return messages;
+	return severe;
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include "ChiliWin.h"
 #include <wrl.h>
+#include <array>
+#include <string>
 #include <vector>
 #include <dxgidebug.h>
 
@@ -11,9 +13,38 @@ public:
 	~DxgiInfoManager() = default;
 	DxgiInfoManager(const DxgiInfoManager&) = delete;
 	DxgiInfoManager& operator=(const DxgiInfoManager&) = delete;
+	// skip every message stored so far
 	void Set() noexcept;
-	std::vector<std::string> GetMessages() const;
+	// remember a call site that may produce debug messages; no info queue access, just two stores
+	void Mark(const char* file, int line) noexcept
+	{
+		callSites[nCallSites++ % maxCallSites] = { file,line };
+	}
+	// called once per frame: only reads the queue when the stored message count changed,
+	// decodes the new messages into a reused buffer and returns whether any is a warning or worse
+	bool Harvest();
+	// messages decoded by the last Harvest() plus the call sites marked since the one before it
+	std::vector<std::string> GetHarvestedMessages() const;
+	// messages stored since the last Set()/Harvest() (error path)
+	std::vector<std::string> GetMessages();
 private:
+	// returns whether any decoded message is a warning or worse
+	bool Decode(unsigned long long first, unsigned long long end);
+private:
+	struct CallSite
+	{
+		const char* file;
+		int line;
+	};
+	static constexpr unsigned int maxCallSites = 64u;
 	unsigned long long next = 0u;
-    Microsoft::WRL::ComPtr<IDXGIInfoQueue> pDxgiInfoQueue;
-};
\ No newline at end of file
+	// raw DXGI_INFO_QUEUE_MESSAGE bytes, grown on demand and never shrunk
+	std::vector<char> scratch;
+	// decoded descriptions, '\0' separated; offsets index into it
+	std::vector<char> arena;
+	std::vector<size_t> offsets;
+	std::array<CallSite, maxCallSites> callSites = {};
+	unsigned long long nCallSites = 0u;
+	unsigned long long nHarvestedCallSites = 0u;
+	Microsoft::WRL::ComPtr<IDXGIInfoQueue> pDxgiInfoQueue;
+};
@@ -0,0 +1,59 @@
+#include "DynamicIndexBuffer.h"
+#include "BindStream.h"
+#include "GraphicsThrowMacros.h"
+#include "PerfCounters.h"
+#include <cassert>
+#include <cstring>
+
+DynamicIndexBuffer::DynamicIndexBuffer(Graphics &gfx, DXGI_FORMAT format, UINT capacity)
+        :
+        format(format),
+        indexSize(format == DXGI_FORMAT_R16_UINT ? 2u : 4u),
+        capacity(capacity) {
+    INFOMAN(gfx);
+    // D3D11_BUFFER_DESC 参数介绍看 VertexBuffer
+    D3D11_BUFFER_DESC ibd = {};
+    ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
+    ibd.Usage = D3D11_USAGE_DYNAMIC;
+    ibd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    ibd.MiscFlags = 0u;
+    ibd.ByteWidth = indexSize * capacity;
+    ibd.StructureByteStride = indexSize;
+    GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&ibd, nullptr, &pIndexBuffer));
+    PerfCounters::Add(PerfCounter::BuffersCreated);
+    PerfCounters::Add(PerfCounter::BufferBytesCreated, ibd.ByteWidth);
+    gpuMemory.Track(GpuMemoryKind::Buffer, ibd.ByteWidth);
+}
+
+UINT DynamicIndexBuffer::Append(Graphics &gfx, const void *pIndices, UINT count) {
+    assert("Too many indices for the dynamic index buffer" && count <= capacity);
+    INFOMAN(gfx);
+    auto mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+    if (position + count > capacity) {
+        // 驱动会给一块新的内存，GPU 还在读的旧内容不受影响
+        mapType = D3D11_MAP_WRITE_DISCARD;
+        position = 0u;
+    }
+    D3D11_MAPPED_SUBRESOURCE msr;
+    // 每批一次，不是每次 draw；Info 只在失败时才多取调试消息，成功时和 Hr 一样只是一次比较
+    GFX_CHECK_HR(GfxCheck::Info, GetContext(gfx)->Map(pIndexBuffer.Get(), 0u, mapType, 0u, &msr));
+    std::memcpy(static_cast<char *>(msr.pData) + std::size_t(position) * indexSize, pIndices, std::size_t(count) * indexSize);
+    GetContext(gfx)->Unmap(pIndexBuffer.Get(), 0u);
+    PerfCounters::Add(PerfCounter::Maps);
+    PerfCounters::Add(PerfCounter::BytesMapped, std::int64_t(count) * indexSize);
+    const auto first = position;
+    position += count;
+    return first;
+}
+
+void DynamicIndexBuffer::Bind(Graphics &gfx) noexcept {
+    GetContext(gfx)->IASetIndexBuffer(pIndexBuffer.Get(), format, 0u);
+}
+
+void DynamicIndexBuffer::Record(BindStream &stream) const {
+    stream.PushIndexBuffer(pIndexBuffer.Get(), format);
+}
+
+UINT DynamicIndexBuffer::GetCapacity() const noexcept {
+    return capacity;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "Bindable.h"
+
+// CPU 每帧重写的索引缓冲（例如按簇剔除之后压缩的索引列表），和 DynamicVertexBuffer 一样按环形缓冲 Append：
+// 用 D3D11_MAP_WRITE_NO_OVERWRITE 接在上次写的后面，写满了才 D3D11_MAP_WRITE_DISCARD 从头写
+class DynamicIndexBuffer : public Bindable
+{
+public:
+    // format 是 DXGI_FORMAT_R16_UINT 或 DXGI_FORMAT_R32_UINT
+    DynamicIndexBuffer(Graphics& gfx, DXGI_FORMAT format, UINT capacity);
+    // copies count indices (at most the capacity) and returns the index of the first one, to pass as the start index of the draw
+    UINT Append(Graphics& gfx, const void* pIndices, UINT count);
+    void Bind(Graphics& gfx) noexcept override;
+    void Record(BindStream& stream) const override;
+    UINT GetCapacity() const noexcept;
+protected:
+    DXGI_FORMAT format;
+    UINT indexSize;
+    UINT capacity;
+    // 下一个可以用 NO_OVERWRITE 写的索引
+    UINT position = 0u;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> pIndexBuffer;
+    GpuAllocation gpuMemory;
+};
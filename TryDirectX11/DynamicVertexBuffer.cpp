@@ -0,0 +1,59 @@
+#include "DynamicVertexBuffer.h"
+#include "BindStream.h"
+#include "GraphicsThrowMacros.h"
+#include "PerfCounters.h"
+#include <cassert>
+#include <cstring>
+
+DynamicVertexBuffer::DynamicVertexBuffer(Graphics &gfx, UINT stride, UINT capacity)
+        :
+        stride(stride),
+        capacity(capacity) {
+    INFOMAN(gfx);
+    // D3D11_BUFFER_DESC 参数介绍看 VertexBuffer
+    D3D11_BUFFER_DESC bd = {};
+    bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    bd.Usage = D3D11_USAGE_DYNAMIC;
+    bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    bd.MiscFlags = 0u;
+    bd.ByteWidth = stride * capacity;
+    bd.StructureByteStride = stride;
+    GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&bd, nullptr, &pVertexBuffer));
+    PerfCounters::Add(PerfCounter::BuffersCreated);
+    PerfCounters::Add(PerfCounter::BufferBytesCreated, bd.ByteWidth);
+    gpuMemory.Track(GpuMemoryKind::Buffer, bd.ByteWidth);
+}
+
+UINT DynamicVertexBuffer::Append(Graphics &gfx, const void *pVertices, UINT count) {
+    assert("Too many vertices for the dynamic vertex buffer" && count <= capacity);
+    INFOMAN(gfx);
+    auto mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+    if (position + count > capacity) {
+        // 驱动会给一块新的内存，GPU 还在读的旧内容不受影响
+        mapType = D3D11_MAP_WRITE_DISCARD;
+        position = 0u;
+    }
+    D3D11_MAPPED_SUBRESOURCE msr;
+    // 每批一次，不是每次 draw；Info 只在失败时才多取调试消息，成功时和 Hr 一样只是一次比较
+    GFX_CHECK_HR(GfxCheck::Info, GetContext(gfx)->Map(pVertexBuffer.Get(), 0u, mapType, 0u, &msr));
+    std::memcpy(static_cast<char *>(msr.pData) + std::size_t(position) * stride, pVertices, std::size_t(count) * stride);
+    GetContext(gfx)->Unmap(pVertexBuffer.Get(), 0u);
+    PerfCounters::Add(PerfCounter::Maps);
+    PerfCounters::Add(PerfCounter::BytesMapped, std::int64_t(count) * stride);
+    const auto first = position;
+    position += count;
+    return first;
+}
+
+void DynamicVertexBuffer::Bind(Graphics &gfx) noexcept {
+    const UINT offset = 0u;
+    GetContext(gfx)->IASetVertexBuffers(0u, 1u, pVertexBuffer.GetAddressOf(), &stride, &offset);
+}
+
+void DynamicVertexBuffer::Record(BindStream &stream) const {
+    stream.PushVertexBuffer(pVertexBuffer.Get(), stride);
+}
+
+UINT DynamicVertexBuffer::GetCapacity() const noexcept {
+    return capacity;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Bindable.h"
+
+// CPU 每帧重写的顶点缓冲（精灵之类）。Append 用 D3D11_MAP_WRITE_NO_OVERWRITE 接在上次写的后面，
+// 写满了才用 D3D11_MAP_WRITE_DISCARD 换一块新的从头写，同一帧里多次 Append 不用等 GPU 读完前面的顶点
+class DynamicVertexBuffer : public Bindable
+{
+public:
+    DynamicVertexBuffer(Graphics& gfx, UINT stride, UINT capacity);
+    // copies count vertices (at most the capacity) and returns the index of the first one, to pass as the base vertex of the draw
+    UINT Append(Graphics& gfx, const void* pVertices, UINT count);
+    void Bind(Graphics& gfx) noexcept override;
+    void Record(BindStream& stream) const override;
+    UINT GetCapacity() const noexcept;
+protected:
+    UINT stride;
+    UINT capacity;
+    // 下一个可以用 NO_OVERWRITE 写的顶点
+    UINT position = 0u;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> pVertexBuffer;
+    GpuAllocation gpuMemory;
+};
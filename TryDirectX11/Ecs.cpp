@@ -0,0 +1,222 @@
+#include "Ecs.h"
+#include <algorithm>
+
+std::array<ComponentRegistry::Info, ComponentRegistry::maxComponents> ComponentRegistry::infos = {};
+std::uint32_t ComponentRegistry::nComponents = 0u;
+
+const ComponentRegistry::Info& ComponentRegistry::GetInfo(std::uint32_t id) noexcept
+{
+    return infos[id];
+}
+
+std::uint32_t ComponentRegistry::Register(std::size_t size, std::size_t alignment) noexcept
+{
+    assert("Too many component types for a 64-bit archetype mask" && nComponents < maxComponents);
+    infos[nComponents] = { size,alignment };
+    return nComponents++;
+}
+
+namespace
+{
+    // 对 mask 里的每个组件编号调用 f(id)，按编号从小到大
+    template<class F>
+    void ForEachComponent(std::uint64_t mask, F&& f)
+    {
+        for (std::uint32_t id = 0u; mask != 0u; id++, mask >>= 1u)
+        {
+            if (mask & 1u)
+            {
+                f(id);
+            }
+        }
+    }
+
+    std::size_t AlignUp(std::size_t offset, std::size_t alignment)
+    {
+        return (offset + alignment - 1u) & ~(alignment - 1u);
+    }
+}
+
+Archetype::Archetype(std::uint64_t mask)
+    :
+    mask(mask)
+{
+    // 先按每行总字节数估计容量，再算上每段数组的对齐填充，放不下就减一行重来
+    std::size_t rowSize = sizeof(Entity);
+    ForEachComponent(mask, [&rowSize](std::uint32_t id) {
+        rowSize += ComponentRegistry::GetInfo(id).size;
+    });
+    auto rows = chunkSize / rowSize;
+    while (true)
+    {
+        std::size_t offset = sizeof(Entity) * rows;
+        ForEachComponent(mask, [this, rows, &offset](std::uint32_t id) {
+            const auto& info = ComponentRegistry::GetInfo(id);
+            // 每段数组至少 16 字节对齐，方便 SIMD 处理
+            offset = AlignUp(offset, std::max<std::size_t>(info.alignment, 16u));
+            offsets[id] = std::uint32_t(offset);
+            offset += info.size * rows;
+        });
+        if (offset <= chunkSize)
+        {
+            break;
+        }
+        rows--;
+    }
+    assert("Components too large for one chunk" && rows > 0u);
+    capacity = std::uint32_t(rows);
+}
+
+std::uint64_t Archetype::GetMask() const noexcept
+{
+    return mask;
+}
+
+std::size_t Archetype::GetSize() const noexcept
+{
+    return size;
+}
+
+std::uint32_t Archetype::GetChunkCapacity() const noexcept
+{
+    return capacity;
+}
+
+std::size_t Archetype::GetChunkCount() const noexcept
+{
+    return (size + capacity - 1u) / capacity;
+}
+
+std::uint32_t Archetype::GetChunkSize(std::size_t chunk) const noexcept
+{
+    return std::uint32_t(std::min<std::size_t>(capacity, size - chunk * capacity));
+}
+
+Entity* Archetype::GetEntities(std::size_t chunk) noexcept
+{
+    return reinterpret_cast<Entity*>(chunks[chunk]->data);
+}
+
+void* Archetype::GetComponent(std::uint32_t componentId, std::size_t row) noexcept
+{
+    assert("Archetype does not contain this component" && (mask & (1ull << componentId)) != 0u);
+    const auto& info = ComponentRegistry::GetInfo(componentId);
+    return chunks[row / capacity]->data + offsets[componentId] + (row % capacity) * info.size;
+}
+
+std::size_t Archetype::PushBack(Entity e)
+{
+    Reserve(size + 1u);
+    const auto row = size++;
+    GetEntities(row / capacity)[row % capacity] = e;
+    return row;
+}
+
+void Archetype::Reserve(std::size_t rows)
+{
+    while (chunks.size() * capacity < rows)
+    {
+        // 不用 make_unique，省掉 16KB 的清零
+        chunks.push_back(std::unique_ptr<Chunk>(new Chunk));
+    }
+}
+
+Entity Archetype::SwapRemove(std::size_t row) noexcept
+{
+    const auto last = --size;
+    if (row == last)
+    {
+        return {};
+    }
+    ForEachComponent(mask, [this, row, last](std::uint32_t id) {
+        std::memcpy(GetComponent(id, row), GetComponent(id, last), ComponentRegistry::GetInfo(id).size);
+    });
+    const auto moved = GetEntities(last / capacity)[last % capacity];
+    GetEntities(row / capacity)[row % capacity] = moved;
+    // 空出来的 chunk 留着，下次增长时复用
+    return moved;
+}
+
+void World::Destroy(Entity e) noexcept
+{
+    assert("Destroying a dead entity" && IsAlive(e));
+    auto& r = records[e.GetIndex()];
+    const auto moved = r.pArchetype->SwapRemove(r.row);
+    if (moved.IsValid())
+    {
+        records[moved.GetIndex()].row = r.row;
+    }
+    r.pArchetype = nullptr;
+    r.generation++;
+    freeIndices.push_back(e.GetIndex());
+    entityCount--;
+}
+
+bool World::IsAlive(Entity e) const noexcept
+{
+    return e.IsValid() && e.GetIndex() < records.size() &&
+        records[e.GetIndex()].pArchetype != nullptr &&
+        records[e.GetIndex()].generation == e.GetGeneration();
+}
+
+std::size_t World::GetEntityCount() const noexcept
+{
+    return entityCount;
+}
+
+std::size_t World::GetArchetypeCount() const noexcept
+{
+    return archetypes.size();
+}
+
+Entity World::AllocateEntity()
+{
+    entityCount++;
+    if (!freeIndices.empty())
+    {
+        const auto index = freeIndices.back();
+        freeIndices.pop_back();
+        return { index,records[index].generation };
+    }
+    records.emplace_back();
+    return { std::uint32_t(records.size() - 1u),0u };
+}
+
+void World::Place(Entity e, Archetype& archetype, std::size_t row) noexcept
+{
+    auto& r = records[e.GetIndex()];
+    r.pArchetype = &archetype;
+    r.row = row;
+}
+
+Archetype& World::GetArchetype(std::uint64_t mask)
+{
+    // archetype 数量很少，线性查找就够了
+    for (auto& p : archetypes)
+    {
+        if (p->GetMask() == mask)
+        {
+            return *p;
+        }
+    }
+    archetypes.push_back(std::make_unique<Archetype>(mask));
+    return *archetypes.back();
+}
+
+void World::Migrate(Entity e, std::uint64_t newMask)
+{
+    auto& r = records[e.GetIndex()];
+    auto& src = *r.pArchetype;
+    auto& dst = GetArchetype(newMask);
+    const auto newRow = dst.PushBack(e);
+    // 两边都有的组件拷过去，新增的组件由调用者构造
+    ForEachComponent(src.GetMask() & newMask, [&](std::uint32_t id) {
+        std::memcpy(dst.GetComponent(id, newRow), src.GetComponent(id, r.row), ComponentRegistry::GetInfo(id).size);
+    });
+    const auto moved = src.SwapRemove(r.row);
+    if (moved.IsValid())
+    {
+        records[moved.GetIndex()].row = r.row;
+    }
+    Place(e, dst, newRow);
+}
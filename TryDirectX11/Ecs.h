@@ -0,0 +1,290 @@
+#pragma once
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// 基于 archetype 的实体组件系统：拥有完全相同组件集合的实体放在同一个 Archetype 里，
+// Archetype 按 16KB 的 chunk 存储，chunk 内每种组件一段连续数组（SoA），system 按组件查询逐 chunk 遍历。
+// 组件必须是平凡可复制的（移动实体就是 memcpy），不做析构。
+
+class Entity
+{
+public:
+    Entity() = default;
+    Entity(std::uint32_t index, std::uint32_t generation) noexcept
+        :
+        index(index),
+        generation(generation)
+    {}
+    bool IsValid() const noexcept
+    {
+        return index != invalid;
+    }
+    std::uint32_t GetIndex() const noexcept
+    {
+        return index;
+    }
+    std::uint32_t GetGeneration() const noexcept
+    {
+        return generation;
+    }
+    bool operator==(Entity rhs) const noexcept
+    {
+        return index == rhs.index && generation == rhs.generation;
+    }
+    bool operator!=(Entity rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+private:
+    static constexpr std::uint32_t invalid = 0xFFFFFFFFu;
+    std::uint32_t index = invalid;
+    std::uint32_t generation = 0u;
+};
+
+// 组件类型第一次用到时分配一个编号（0..63），archetype 用 64 位掩码表示它包含哪些组件
+class ComponentRegistry
+{
+public:
+    static constexpr std::uint32_t maxComponents = 64u;
+    struct Info
+    {
+        std::size_t size;
+        std::size_t alignment;
+    };
+    template<class T>
+    static std::uint32_t GetId() noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "ECS components are moved with memcpy");
+        static const auto id = Register(sizeof(T), alignof(T));
+        return id;
+    }
+    static const Info& GetInfo(std::uint32_t id) noexcept;
+private:
+    static std::uint32_t Register(std::size_t size, std::size_t alignment) noexcept;
+private:
+    static std::array<Info, maxComponents> infos;
+    static std::uint32_t nComponents;
+};
+
+template<class... Cs>
+std::uint64_t ComponentMask() noexcept
+{
+    return (0ull | ... | (1ull << ComponentRegistry::GetId<std::remove_cv_t<Cs>>()));
+}
+
+class Archetype
+{
+public:
+    static constexpr std::size_t chunkSize = 16u * 1024u;
+    explicit Archetype(std::uint64_t mask);
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+    std::uint64_t GetMask() const noexcept;
+    // entities in this archetype
+    std::size_t GetSize() const noexcept;
+    // rows per chunk
+    std::uint32_t GetChunkCapacity() const noexcept;
+    // chunks holding at least one entity (only the last one can be partially filled)
+    std::size_t GetChunkCount() const noexcept;
+    std::uint32_t GetChunkSize(std::size_t chunk) const noexcept;
+    Entity* GetEntities(std::size_t chunk) noexcept;
+    // start of the SoA array of component T in a chunk
+    template<class T>
+    T* GetArray(std::size_t chunk) noexcept
+    {
+        const auto id = ComponentRegistry::GetId<std::remove_cv_t<T>>();
+        assert("Archetype does not contain this component" && (mask & (1ull << id)) != 0u);
+        return reinterpret_cast<T*>(chunks[chunk]->data + offsets[id]);
+    }
+    void* GetComponent(std::uint32_t componentId, std::size_t row) noexcept;
+    // appends a row for e; component memory is left uninitialized
+    std::size_t PushBack(Entity e);
+    void Reserve(std::size_t rows);
+    // fills the hole with the last row; returns the entity that moved into 'row' (invalid if 'row' was last)
+    Entity SwapRemove(std::size_t row) noexcept;
+private:
+    struct alignas(64) Chunk
+    {
+        std::byte data[chunkSize];
+    };
+    std::uint64_t mask;
+    std::uint32_t capacity;
+    // byte offset of each component array inside a chunk; the Entity array is at offset 0
+    std::array<std::uint32_t, ComponentRegistry::maxComponents> offsets = {};
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::size_t size = 0u;
+};
+
+// 实体的容器。结构性修改（创建、销毁、增删组件）不能和 ForEach / ParallelForEach 同时进行。
+class World
+{
+public:
+    World() = default;
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+    template<class... Cs>
+    Entity Create(const Cs&... components)
+    {
+        const auto e = AllocateEntity();
+        auto& archetype = GetArchetype(ComponentMask<Cs...>());
+        const auto row = archetype.PushBack(e);
+        (new(archetype.GetComponent(ComponentRegistry::GetId<Cs>(), row)) Cs(components), ...);
+        Place(e, archetype, row);
+        return e;
+    }
+    // 批量创建：init(i, Cs&...) 直接在 chunk 里写第 i 个实体的组件，没有中间拷贝
+    template<class... Cs, class F>
+    void CreateMany(std::size_t count, F&& init)
+    {
+        auto& archetype = GetArchetype(ComponentMask<Cs...>());
+        archetype.Reserve(archetype.GetSize() + count);
+        records.reserve(records.size() + count);
+        for (std::size_t i = 0u; i < count; i++)
+        {
+            const auto e = AllocateEntity();
+            const auto row = archetype.PushBack(e);
+            init(i, *static_cast<Cs*>(archetype.GetComponent(ComponentRegistry::GetId<Cs>(), row))...);
+            Place(e, archetype, row);
+        }
+    }
+    // 同 CreateMany，但每个 chunk 只回调一次 init(first, n, Cs*...)：
+    // 指针指向这段新实体在 chunk 里的第一行，可以直接整段 memcpy 进去（例如从场景文件加载）
+    template<class... Cs, class F>
+    void CreateManyChunked(std::size_t count, F&& init)
+    {
+        Archetype& archetype = GetArchetype(ComponentMask<Cs...>());
+        archetype.Reserve(archetype.GetSize() + count);
+        records.reserve(records.size() + count);
+        const auto capacity = archetype.GetChunkCapacity();
+        for (std::size_t done = 0u; done < count;)
+        {
+            const auto first = archetype.GetSize();
+            const auto chunk = first / capacity;
+            const auto offset = first % capacity;
+            const auto n = std::min<std::size_t>(count - done, capacity - offset);
+            for (std::size_t i = 0u; i < n; i++)
+            {
+                const auto e = AllocateEntity();
+                Place(e, archetype, archetype.PushBack(e));
+            }
+            init(done, std::uint32_t(n), (archetype.GetArray<Cs>(chunk) + offset)...);
+            done += n;
+        }
+    }
+    void Destroy(Entity e) noexcept;
+    bool IsAlive(Entity e) const noexcept;
+    template<class T>
+    bool Has(Entity e) const noexcept
+    {
+        assert(IsAlive(e));
+        return (records[e.GetIndex()].pArchetype->GetMask() & ComponentMask<T>()) != 0u;
+    }
+    template<class T>
+    T& Get(Entity e) noexcept
+    {
+        assert("Entity does not have this component" && Has<T>(e));
+        const auto& r = records[e.GetIndex()];
+        return *static_cast<T*>(r.pArchetype->GetComponent(ComponentRegistry::GetId<T>(), r.row));
+    }
+    // 增删组件会把实体搬到另一个 archetype
+    template<class T>
+    void AddComponent(Entity e, const T& component)
+    {
+        assert("Entity already has this component" && !Has<T>(e));
+        Migrate(e, records[e.GetIndex()].pArchetype->GetMask() | ComponentMask<T>());
+        new(&Get<T>(e)) T(component);
+    }
+    template<class T>
+    void RemoveComponent(Entity e)
+    {
+        assert("Entity does not have this component" && Has<T>(e));
+        Migrate(e, records[e.GetIndex()].pArchetype->GetMask() & ~ComponentMask<T>());
+    }
+    // f(Cs&...) for every entity having at least the components Cs (const Cs for read-only access)
+    template<class... Cs, class F>
+    void ForEach(F&& f)
+    {
+        const auto mask = ComponentMask<Cs...>();
+        for (auto& pArchetype : archetypes)
+        {
+            if ((pArchetype->GetMask() & mask) != mask)
+            {
+                continue;
+            }
+            for (std::size_t c = 0u; c < pArchetype->GetChunkCount(); c++)
+            {
+                RunChunk(pArchetype->GetChunkSize(c), f, pArchetype->GetArray<Cs>(c)...);
+            }
+        }
+    }
+    // 同 ForEach，但以 chunk 为单位分给线程池；f 会被多个线程同时调用
+    template<class... Cs, class F>
+    void ParallelForEach(ThreadPool& pool, F&& f)
+    {
+        const auto mask = ComponentMask<Cs...>();
+        for (auto& pArchetype : archetypes)
+        {
+            if ((pArchetype->GetMask() & mask) != mask)
+            {
+                continue;
+            }
+            auto& archetype = *pArchetype;
+            pool.ParallelFor(archetype.GetChunkCount(), 1u, [&archetype, &f](std::size_t begin, std::size_t end) {
+                for (auto c = begin; c < end; c++)
+                {
+                    RunChunk(archetype.GetChunkSize(c), f, archetype.GetArray<Cs>(c)...);
+                }
+            });
+        }
+    }
+    // 至少有组件 Cs 的实体个数，ForEach 之前用来预留容量
+    template<class... Cs>
+    std::size_t Count() const noexcept
+    {
+        const auto mask = ComponentMask<Cs...>();
+        std::size_t count = 0u;
+        for (const auto& pArchetype : archetypes)
+        {
+            if ((pArchetype->GetMask() & mask) == mask)
+            {
+                count += pArchetype->GetSize();
+            }
+        }
+        return count;
+    }
+    std::size_t GetEntityCount() const noexcept;
+    std::size_t GetArchetypeCount() const noexcept;
+private:
+    template<class F, class... Ps>
+    static void RunChunk(std::uint32_t n, F& f, Ps*... arrays)
+    {
+        for (std::uint32_t i = 0u; i < n; i++)
+        {
+            f(arrays[i]...);
+        }
+    }
+    Entity AllocateEntity();
+    void Place(Entity e, Archetype& archetype, std::size_t row) noexcept;
+    Archetype& GetArchetype(std::uint64_t mask);
+    void Migrate(Entity e, std::uint64_t newMask);
+private:
+    struct Record
+    {
+        Archetype* pArchetype = nullptr;
+        std::size_t row = 0u;
+        std::uint32_t generation = 0u;
+    };
+    std::vector<Record> records;
+    std::vector<std::uint32_t> freeIndices;
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::size_t entityCount = 0u;
+};
@@ -0,0 +1,126 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+FrameArena::FrameArena(std::size_t initialCapacity)
+{
+	AddBlock(initialCapacity);
+}
+
+void* FrameArena::Allocate(std::size_t size, std::size_t alignment)
+{
+	assert("Alignment must be a power of two" && (alignment & (alignment - 1u)) == 0u);
+	// 对齐的是实际地址而不是块内偏移，块本身只保证 new 的默认对齐
+	const auto alignUp = [alignment](const Block& b, std::size_t o) {
+		const auto base = reinterpret_cast<std::uintptr_t>(b.data.get());
+		return std::size_t(((base + o + alignment - 1u) & ~std::uintptr_t(alignment - 1u)) - base);
+	};
+	auto aligned = alignUp(blocks.back(), offset);
+	if (aligned + size > blocks.back().size)
+	{
+		usedInFullBlocks += offset;
+		AddBlock(size + alignment);
+		aligned = alignUp(blocks.back(), 0u);
+	}
+	offset = aligned + size;
+	highWaterMark = std::max(highWaterMark, GetUsed());
+	return blocks.back().data.get() + aligned;
+}
+
+void FrameArena::Reset()
+{
+	if (blocks.size() > 1u)
+	{
+		// 上一帧用了多块，合并成一块，稳定之后就不会再分配
+		std::size_t total = 0u;
+		for (const auto& b : blocks)
+		{
+			total += b.size;
+		}
+		blocks.clear();
+		AddBlock(total);
+	}
+	offset = 0u;
+	usedInFullBlocks = 0u;
+}
+
+std::size_t FrameArena::GetUsed() const noexcept
+{
+	return usedInFullBlocks + offset;
+}
+
+std::size_t FrameArena::GetCapacity() const noexcept
+{
+	std::size_t total = 0u;
+	for (const auto& b : blocks)
+	{
+		total += b.size;
+	}
+	return total;
+}
+
+std::size_t FrameArena::GetHighWaterMark() const noexcept
+{
+	return highWaterMark;
+}
+
+void FrameArena::AddBlock(std::size_t minSize)
+{
+	// 新块至少是已有容量的两倍，避免反复小块增长
+	const auto size = std::max(minSize, GetCapacity() * 2u);
+	// 不用 make_unique，省掉清零
+	blocks.push_back({ std::unique_ptr<char[]>(new char[size]),size });
+	offset = 0u;
+}
+
+namespace
+{
+	std::atomic<unsigned long long> currentFrame{ 0u };
+	std::atomic<std::size_t> globalHighWaterMark{ 0u };
+
+	struct ThreadArenas
+	{
+		FrameArena arenas[FrameMemory::nBufferedFrames];
+		unsigned long long frame = 0u;
+		~ThreadArenas()
+		{
+			for (const auto& a : arenas)
+			{
+				auto mark = globalHighWaterMark.load(std::memory_order_relaxed);
+				while (mark < a.GetHighWaterMark() &&
+					!globalHighWaterMark.compare_exchange_weak(mark, a.GetHighWaterMark(), std::memory_order_relaxed))
+				{}
+			}
+		}
+	};
+	thread_local ThreadArenas threadArenas;
+}
+
+FrameArena& FrameMemory::Get()
+{
+	const auto frame = currentFrame.load(std::memory_order_acquire);
+	auto& arena = threadArenas.arenas[frame % nBufferedFrames];
+	if (threadArenas.frame != frame)
+	{
+		threadArenas.frame = frame;
+		// 这个槽里放的是至少 nBufferedFrames 帧以前的数据
+		auto mark = globalHighWaterMark.load(std::memory_order_relaxed);
+		while (mark < arena.GetHighWaterMark() &&
+			!globalHighWaterMark.compare_exchange_weak(mark, arena.GetHighWaterMark(), std::memory_order_relaxed))
+		{}
+		arena.Reset();
+	}
+	return arena;
+}
+
+void FrameMemory::NextFrame() noexcept
+{
+	currentFrame.fetch_add(1u, std::memory_order_release);
+}
+
+std::size_t FrameMemory::GetHighWaterMark() noexcept
+{
+	return globalHighWaterMark.load(std::memory_order_relaxed);
+}
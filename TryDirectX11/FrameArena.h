@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// 线性（bump）分配器：分配只是移动指针，释放什么都不做，整块在 Reset 时一次性回收。
+// 适合只活一帧的临时数据：排序列表、剔除结果、命令数据等。
+class FrameArena
+{
+public:
+	explicit FrameArena(std::size_t initialCapacity = 64u * 1024u);
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+	void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+	// forget everything allocated so far; if the last frame overflowed into extra blocks,
+	// they are merged into one big enough block so the next frame stays on a single block
+	void Reset();
+	std::size_t GetUsed() const noexcept;
+	std::size_t GetCapacity() const noexcept;
+	// most bytes ever in use between two resets
+	std::size_t GetHighWaterMark() const noexcept;
+private:
+	void AddBlock(std::size_t minSize);
+private:
+	struct Block
+	{
+		std::unique_ptr<char[]> data;
+		std::size_t size;
+	};
+	std::vector<Block> blocks;
+	// bump pointer inside blocks.back()
+	std::size_t offset = 0u;
+	// bytes used in every block but the last one
+	std::size_t usedInFullBlocks = 0u;
+	std::size_t highWaterMark = 0u;
+};
+
+// 每个线程、每帧一个 arena，三份轮换：第 N 帧分配的数据在第 N+3 帧开始之前都有效，
+// 所以被 GPU 或者其他线程延后一两帧消费的数据也不会被提前覆盖。
+class FrameMemory
+{
+public:
+	static constexpr unsigned int nBufferedFrames = 3u;
+	// arena of the calling thread for the current frame (reset lazily the first time a thread touches a new frame)
+	static FrameArena& Get();
+	// called by Graphics::EndFrame
+	static void NextFrame() noexcept;
+	// high water mark over every thread and every buffered frame
+	static std::size_t GetHighWaterMark() noexcept;
+};
+
+// STL allocator adapter over a FrameArena; deallocate is a no-op
+template<typename T>
+class FrameAllocator
+{
+	template<typename U>
+	friend class FrameAllocator;
+public:
+	using value_type = T;
+	// 容器赋值 / 交换时连同 arena 一起换，成员容器每帧可以换到当帧的 arena 上（见 FrameRecorder::BeginFrame）
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	FrameAllocator()
+		:
+		pArena(&FrameMemory::Get())
+	{}
+	explicit FrameAllocator(FrameArena& arena) noexcept
+		:
+		pArena(&arena)
+	{}
+	template<typename U>
+	FrameAllocator(const FrameAllocator<U>& other) noexcept
+		:
+		pArena(other.pArena)
+	{}
+	T* allocate(std::size_t n)
+	{
+		return static_cast<T*>(pArena->Allocate(n * sizeof(T), alignof(T)));
+	}
+	void deallocate(T*, std::size_t) noexcept
+	{}
+	template<typename U>
+	bool operator==(const FrameAllocator<U>& rhs) const noexcept
+	{
+		return pArena == rhs.pArena;
+	}
+	template<typename U>
+	bool operator!=(const FrameAllocator<U>& rhs) const noexcept
+	{
+		return pArena != rhs.pArena;
+	}
+private:
+	FrameArena* pArena;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -0,0 +1,298 @@
+#include "FrameRecording.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#define RECORDING_EXCEPT( note ) FrameRecordingException( __LINE__,__FILE__,path,(note) )
+
+namespace
+{
+    constexpr char magic[8] = { 'D','X','1','1','R','E','C','\0' };
+    // bump when the frame or event encoding changes
+    constexpr std::uint32_t version = 1u;
+
+    struct FileHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t seed;
+    };
+
+    struct FrameHeader
+    {
+        float dt;
+        std::uint16_t keyCount;
+        std::uint16_t charCount;
+        std::uint16_t mouseCount;
+    };
+
+    constexpr std::size_t keyEventSize = 2u;
+    // type + int16 x + int16 y
+    constexpr std::size_t mouseEventSize = 5u;
+}
+
+FrameRecorder::FrameRecorder( const std::string& path,std::uint32_t seed )
+    :
+    path( path ),
+    file( path,std::ios::binary | std::ios::trunc )
+{
+    if( !file )
+    {
+        throw RECORDING_EXCEPT( "Cannot open recording for writing" );
+    }
+    FileHeader header = {};
+    std::memcpy( header.magic,magic,sizeof( magic ) );
+    header.version = version;
+    header.seed = seed;
+    file.write( reinterpret_cast<const char*>( &header ),sizeof( header ) );
+}
+
+void FrameRecorder::BeginFrame( float frameDt )
+{
+    dt = frameDt;
+    // 上一帧的内容在它自己的 arena 上，不用释放；一帧最多也就是键盘和鼠标缓冲能放下的事件数
+    auto& arena = FrameMemory::Get();
+    keyBytes = FrameVector<unsigned char>( FrameAllocator<unsigned char>( arena ) );
+    chars = FrameVector<char>( FrameAllocator<char>( arena ) );
+    mouseBytes = FrameVector<unsigned char>( FrameAllocator<unsigned char>( arena ) );
+    keyBytes.reserve( 256u * keyEventSize );
+    chars.reserve( 256u );
+    mouseBytes.reserve( 1024u * mouseEventSize );
+}
+
+void FrameRecorder::RecordKey( const Keyboard::Event& e )
+{
+    keyBytes.push_back( e.IsPress() ? 1u : 0u );
+    keyBytes.push_back( e.GetCode() );
+}
+
+void FrameRecorder::RecordChar( char c )
+{
+    chars.push_back( c );
+}
+
+void FrameRecorder::RecordMouse( const Mouse::Event& e )
+{
+    const auto x = std::int16_t( e.GetPosX() );
+    const auto y = std::int16_t( e.GetPosY() );
+    unsigned char bytes[mouseEventSize];
+    bytes[0] = static_cast<unsigned char>( e.GetType() );
+    std::memcpy( bytes + 1,&x,sizeof( x ) );
+    std::memcpy( bytes + 3,&y,sizeof( y ) );
+    mouseBytes.insert( mouseBytes.end(),bytes,bytes + mouseEventSize );
+}
+
+void FrameRecorder::EndFrame()
+{
+    const FrameHeader header = {
+        dt,
+        std::uint16_t( keyBytes.size() / keyEventSize ),
+        std::uint16_t( chars.size() ),
+        std::uint16_t( mouseBytes.size() / mouseEventSize )
+    };
+    file.write( reinterpret_cast<const char*>( &header ),sizeof( header ) );
+    file.write( reinterpret_cast<const char*>( keyBytes.data() ),std::streamsize( keyBytes.size() ) );
+    file.write( chars.data(),std::streamsize( chars.size() ) );
+    file.write( reinterpret_cast<const char*>( mouseBytes.data() ),std::streamsize( mouseBytes.size() ) );
+    if( !file )
+    {
+        throw RECORDING_EXCEPT( "Write failed" );
+    }
+}
+
+FrameReplayer::FrameReplayer( const std::string& path,Timing timing )
+    :
+    path( path ),
+    timing( timing ),
+    pFile( std::make_unique<MappedFile>( path ) )
+{
+    const auto pHeader = Read( sizeof( FileHeader ) );
+    if( pHeader == nullptr )
+    {
+        throw RECORDING_EXCEPT( "File too small for a recording header" );
+    }
+    FileHeader header;
+    std::memcpy( &header,pHeader,sizeof( header ) );
+    if( std::memcmp( header.magic,magic,sizeof( magic ) ) != 0 )
+    {
+        throw RECORDING_EXCEPT( "Not a frame recording" );
+    }
+    if( header.version != version )
+    {
+        std::ostringstream oss;
+        oss << "Unsupported recording version " << header.version << " (expected " << version << ")";
+        throw RECORDING_EXCEPT( oss.str() );
+    }
+    seed = header.seed;
+}
+
+// 在这里析构，MappedFile 在头文件里只有前置声明
+FrameReplayer::~FrameReplayer() = default;
+
+std::uint32_t FrameReplayer::GetSeed() const noexcept
+{
+    return seed;
+}
+
+bool FrameReplayer::NextFrame( float& dt,Keyboard& kbd,Mouse& mouse )
+{
+    if( finished )
+    {
+        return false;
+    }
+    FrameHeader header;
+    const auto pHeader = Read( sizeof( header ) );
+    if( pHeader == nullptr )
+    {
+        finished = true;
+        end = Clock::now();
+        return false;
+    }
+    std::memcpy( &header,pHeader,sizeof( header ) );
+    const auto pKeys = Read( header.keyCount * keyEventSize );
+    const auto pChars = Read( header.charCount );
+    const auto pMice = Read( header.mouseCount * mouseEventSize );
+    if( (header.keyCount != 0u && pKeys == nullptr) ||
+        (header.charCount != 0u && pChars == nullptr) ||
+        (header.mouseCount != 0u && pMice == nullptr) )
+    {
+        throw RECORDING_EXCEPT( "Truncated frame" );
+    }
+
+    const auto now = Clock::now();
+    if( frameCount == 0u )
+    {
+        start = now;
+        nextFrameTime = now;
+    }
+    if( timing == Timing::Original )
+    {
+        // 录制时这一帧是在上一帧之后 dt 秒开始的
+        nextFrameTime += std::chrono::duration_cast<Clock::duration>( std::chrono::duration<float>( header.dt ) );
+        std::this_thread::sleep_until( nextFrameTime );
+    }
+    frameCount++;
+    dt = header.dt;
+
+    // 调用 Window 在收到消息时调用的同一组函数，事件和状态快照都会照常更新
+    for( std::uint16_t i = 0u; i < header.keyCount; i++ )
+    {
+        const auto code = static_cast<unsigned char>( pKeys[i * keyEventSize + 1u] );
+        if( pKeys[i * keyEventSize] != std::byte( 0 ) )
+        {
+            kbd.OnKeyPressed( code );
+        }
+        else
+        {
+            kbd.OnKeyReleased( code );
+        }
+    }
+    for( std::uint16_t i = 0u; i < header.charCount; i++ )
+    {
+        kbd.OnChar( std::to_integer<char>( pChars[i] ) );
+    }
+    for( std::uint16_t i = 0u; i < header.mouseCount; i++ )
+    {
+        const auto p = pMice + i * mouseEventSize;
+        std::int16_t x;
+        std::int16_t y;
+        std::memcpy( &x,p + 1,sizeof( x ) );
+        std::memcpy( &y,p + 3,sizeof( y ) );
+        switch( static_cast<Mouse::Event::Type>( std::to_integer<int>( p[0] ) ) )
+        {
+        case Mouse::Event::Type::LPress:
+            mouse.OnLeftPressed( x,y );
+            break;
+        case Mouse::Event::Type::LRelease:
+            mouse.OnLeftReleased( x,y );
+            break;
+        case Mouse::Event::Type::RPress:
+            mouse.OnRightPressed( x,y );
+            break;
+        case Mouse::Event::Type::RRelease:
+            mouse.OnRightReleased( x,y );
+            break;
+        case Mouse::Event::Type::WheelUp:
+            mouse.OnWheelUp( x,y );
+            break;
+        case Mouse::Event::Type::WheelDown:
+            mouse.OnWheelDown( x,y );
+            break;
+        case Mouse::Event::Type::Move:
+            mouse.OnMouseMove( x,y );
+            break;
+        case Mouse::Event::Type::Enter:
+            mouse.OnMouseEnter();
+            break;
+        case Mouse::Event::Type::Leave:
+            mouse.OnMouseLeave();
+            break;
+        default:
+            throw RECORDING_EXCEPT( "Unknown mouse event type" );
+        }
+    }
+    return true;
+}
+
+bool FrameReplayer::IsFinished() const noexcept
+{
+    return finished;
+}
+
+unsigned long long FrameReplayer::GetFrameCount() const noexcept
+{
+    return frameCount;
+}
+
+std::string FrameReplayer::GetReport() const
+{
+    const auto last = finished ? end : Clock::now();
+    const auto ms = frameCount == 0u ? 0.0 : std::chrono::duration<double, std::milli>( last - start ).count();
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision( 3 )
+        << "[Replay] " << path << ": " << frameCount << " frames in " << ms << " ms"
+        << " (" << (frameCount == 0u ? 0.0 : ms / double( frameCount )) << " ms/frame, "
+        << (timing == Timing::Fixed ? "fixed" : "original") << " timing)" << std::endl;
+    return oss.str();
+}
+
+const std::byte* FrameReplayer::Read( std::size_t size )
+{
+    if( pFile->GetSize() - cursor < size )
+    {
+        return nullptr;
+    }
+    const auto p = pFile->GetData() + cursor;
+    cursor += size;
+    return p;
+}
+
+FrameRecordingException::FrameRecordingException( int line,const char* file,std::string path,std::string note ) noexcept
+    :
+    ChiliException( line,file ),
+    path( std::move( path ) ),
+    note( std::move( note ) )
+{}
+
+const char* FrameRecordingException::what() const noexcept
+{
+    std::ostringstream oss;
+    oss << GetType() << std::endl
+        << "[Path] " << path << std::endl
+        << "[Note] " << note << std::endl
+        << GetOriginString();
+    whatBuffer = oss.str();
+    return whatBuffer.c_str();
+}
+
+const char* FrameRecordingException::GetType() const noexcept
+{
+    return "Frame Recording Exception";
+}
+
+const std::string& FrameRecordingException::GetNote() const noexcept
+{
+    return note;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "ChiliException.h"
+#include "FrameArena.h"
+#include "Keyboard.h"
+#include "Mouse.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 录制 / 回放一次运行：随机种子、每帧的 dt，以及每帧 App 消费到的全部键盘和鼠标事件。
+// 文件格式：FileHeader，然后逐帧 FrameHeader + 按键事件(type,code) + 字符 + 鼠标事件(type,x,y)，没有对齐填充。
+// 回放时把事件重新注入 Keyboard / Mouse，所以 App 看到的输入序列和录制时完全一样。
+
+class FrameRecordingException : public ChiliException
+{
+public:
+    FrameRecordingException( int line,const char* file,std::string path,std::string note ) noexcept;
+    const char* what() const noexcept override;
+    const char* GetType() const noexcept override;
+    const std::string& GetNote() const noexcept;
+private:
+    std::string path;
+    std::string note;
+};
+
+class FrameRecorder
+{
+public:
+    FrameRecorder( const std::string& path,std::uint32_t seed );
+    FrameRecorder( const FrameRecorder& ) = delete;
+    FrameRecorder& operator=( const FrameRecorder& ) = delete;
+    // call order per frame: BeginFrame, Record* for every consumed event, EndFrame
+    void BeginFrame( float dt );
+    void RecordKey( const Keyboard::Event& e );
+    void RecordChar( char c );
+    void RecordMouse( const Mouse::Event& e );
+    void EndFrame();
+private:
+    std::string path;
+    std::ofstream file;
+    float dt = 0.0f;
+    // 事件先按类型分开攒着，EndFrame 时连同数量一起写出；
+    // 只活一帧，BeginFrame 时换到当帧的 FrameMemory 上并预留容量，录制时不走通用堆
+    FrameVector<unsigned char> keyBytes;
+    FrameVector<char> chars;
+    FrameVector<unsigned char> mouseBytes;
+};
+
+class FrameReplayer
+{
+public:
+    enum class Timing
+    {
+        // recorded dt is fed to the simulation but frames run back to back (benchmarks)
+        Fixed,
+        // frames are additionally paced to the recorded wall-clock timing
+        Original,
+    };
+public:
+    FrameReplayer( const std::string& path,Timing timing );
+    FrameReplayer( const FrameReplayer& ) = delete;
+    FrameReplayer& operator=( const FrameReplayer& ) = delete;
+    ~FrameReplayer();
+    std::uint32_t GetSeed() const noexcept;
+    // injects the next frame's input into kbd / mouse and returns its dt; false once the recording is exhausted
+    bool NextFrame( float& dt,Keyboard& kbd,Mouse& mouse );
+    bool IsFinished() const noexcept;
+    unsigned long long GetFrameCount() const noexcept;
+    // replayed frames and wall time between the first frame and the end of the recording
+    std::string GetReport() const;
+private:
+    const std::byte* Read( std::size_t size );
+private:
+    using Clock = std::chrono::steady_clock;
+    std::string path;
+    Timing timing;
+    std::unique_ptr<class MappedFile> pFile;
+    std::size_t cursor = 0u;
+    std::uint32_t seed = 0u;
+    bool finished = false;
+    unsigned long long frameCount = 0u;
+    Clock::time_point start;
+    Clock::time_point end;
+    Clock::time_point nextFrameTime;
+};
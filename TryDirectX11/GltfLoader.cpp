@@ -0,0 +1,764 @@
+#include "GltfLoader.h"
+#include "Json.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#define MESH_EXCEPT( note ) MeshException( __LINE__,__FILE__,name,(note) )
+
+namespace
+{
+    constexpr std::uint32_t glbMagic = 0x46546C67u;   // "glTF"
+    constexpr std::uint32_t jsonChunkType = 0x4E4F534Au;
+    constexpr std::uint32_t binChunkType = 0x004E4942u;
+
+    constexpr std::uint32_t componentByte = 5120u;
+    constexpr std::uint32_t componentUnsignedByte = 5121u;
+    constexpr std::uint32_t componentShort = 5122u;
+    constexpr std::uint32_t componentUnsignedShort = 5123u;
+    constexpr std::uint32_t componentUnsignedInt = 5125u;
+    constexpr std::uint32_t componentFloat = 5126u;
+
+    constexpr std::uint32_t modeTriangles = 4u;
+    constexpr std::uint32_t modeTriangleStrip = 5u;
+    constexpr std::uint32_t modeTriangleFan = 6u;
+
+    // 世界矩阵按层并行时每个任务的节点数
+    constexpr std::size_t nodesPerTask = 256u;
+
+    using Matrix = float[4][4];
+    struct NodeMatrix
+    {
+        Matrix m;
+    };
+
+    // .glb 是小端的，引擎只跑在小端机器上
+    std::uint32_t ReadU32( const std::byte* p ) noexcept
+    {
+        std::uint32_t value;
+        std::memcpy( &value,p,4u );
+        return value;
+    }
+
+    std::uint32_t GetComponentSize( std::uint32_t componentType ) noexcept
+    {
+        switch( componentType )
+        {
+        case componentByte:
+        case componentUnsignedByte:
+            return 1u;
+        case componentShort:
+        case componentUnsignedShort:
+            return 2u;
+        case componentUnsignedInt:
+        case componentFloat:
+            return 4u;
+        default:
+            return 0u;
+        }
+    }
+
+    std::uint32_t GetComponentCount( const std::string& type ) noexcept
+    {
+        if( type == "SCALAR" ) return 1u;
+        if( type == "VEC2" ) return 2u;
+        if( type == "VEC3" ) return 3u;
+        if( type == "VEC4" ) return 4u;
+        if( type == "MAT2" ) return 4u;
+        if( type == "MAT3" ) return 9u;
+        if( type == "MAT4" ) return 16u;
+        return 0u;
+    }
+
+    // normalized 整数按 glTF 规定的方式换算到 [0,1] / [-1,1]
+    float ReadComponent( const std::byte* p,std::uint32_t componentType,bool normalized ) noexcept
+    {
+        switch( componentType )
+        {
+        case componentByte:
+        {
+            const auto v = static_cast<std::int8_t>( *p );
+            return normalized ? std::max( float( v ) / 127.0f,-1.0f ) : float( v );
+        }
+        case componentUnsignedByte:
+        {
+            const auto v = static_cast<std::uint8_t>( *p );
+            return normalized ? float( v ) / 255.0f : float( v );
+        }
+        case componentShort:
+        {
+            std::int16_t v;
+            std::memcpy( &v,p,2u );
+            return normalized ? std::max( float( v ) / 32767.0f,-1.0f ) : float( v );
+        }
+        case componentUnsignedShort:
+        {
+            std::uint16_t v;
+            std::memcpy( &v,p,2u );
+            return normalized ? float( v ) / 65535.0f : float( v );
+        }
+        case componentUnsignedInt:
+            return float( ReadU32( p ) );
+        default:
+        {
+            float v;
+            std::memcpy( &v,p,4u );
+            return v;
+        }
+        }
+    }
+
+    std::uint32_t ReadIndex( const std::byte* p,std::uint32_t componentType ) noexcept
+    {
+        if( componentType == componentUnsignedByte )
+        {
+            return static_cast<std::uint8_t>( *p );
+        }
+        if( componentType == componentUnsignedShort )
+        {
+            std::uint16_t v;
+            std::memcpy( &v,p,2u );
+            return v;
+        }
+        return ReadU32( p );
+    }
+
+    void Multiply( const Matrix& a,const Matrix& b,Matrix& out ) noexcept
+    {
+        for( int i = 0; i < 4; i++ )
+        {
+            for( int j = 0; j < 4; j++ )
+            {
+                out[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j] + a[i][3] * b[3][j];
+            }
+        }
+    }
+
+    // 节点的局部矩阵，转成行向量约定；格式不对的成员当作没有
+    void GetLocalMatrix( const JsonValue& node,Matrix& local ) noexcept
+    {
+        const auto pMatrix = node.Find( "matrix" );
+        if( pMatrix != nullptr && pMatrix->GetSize() == 16u )
+        {
+            // glTF 按列主序存列向量约定的矩阵，按行读出来正好是转置，也就是行向量约定的矩阵
+            for( std::size_t i = 0u; i < 16u; i++ )
+            {
+                local[i / 4u][i % 4u] = float( ( *pMatrix )[i].GetNumber( i % 5u == 0u ? 1.0 : 0.0 ) );
+            }
+            return;
+        }
+        const auto readVector = [&node]( const char* key,float* pOut,std::size_t n ) {
+            const auto pValue = node.Find( key );
+            if( pValue != nullptr && pValue->GetSize() == n )
+            {
+                for( std::size_t i = 0u; i < n; i++ )
+                {
+                    pOut[i] = float( ( *pValue )[i].GetNumber( pOut[i] ) );
+                }
+            }
+        };
+        float t[3] = { 0.0f,0.0f,0.0f };
+        float q[4] = { 0.0f,0.0f,0.0f,1.0f };
+        float s[3] = { 1.0f,1.0f,1.0f };
+        readVector( "translation",t,3u );
+        readVector( "rotation",q,4u );
+        readVector( "scale",s,3u );
+        // T * R * S（列向量）转置成 S * R^T * T；r 是列向量约定的旋转矩阵
+        const float r[3][3] = {
+            { 1.0f - 2.0f * ( q[1] * q[1] + q[2] * q[2] ),2.0f * ( q[0] * q[1] - q[2] * q[3] ),2.0f * ( q[0] * q[2] + q[1] * q[3] ) },
+            { 2.0f * ( q[0] * q[1] + q[2] * q[3] ),1.0f - 2.0f * ( q[0] * q[0] + q[2] * q[2] ),2.0f * ( q[1] * q[2] - q[0] * q[3] ) },
+            { 2.0f * ( q[0] * q[2] - q[1] * q[3] ),2.0f * ( q[1] * q[2] + q[0] * q[3] ),1.0f - 2.0f * ( q[0] * q[0] + q[1] * q[1] ) } };
+        for( int i = 0; i < 3; i++ )
+        {
+            for( int j = 0; j < 3; j++ )
+            {
+                local[i][j] = s[i] * r[j][i];
+            }
+            local[i][3] = 0.0f;
+            local[3][i] = t[i];
+        }
+        local[3][3] = 1.0f;
+    }
+
+    // 包围盒经过仿射变换之后的包围盒（中心 + 半边长的做法）
+    void TransformBounds( const float min[3],const float max[3],const Matrix& m,float outMin[3],float outMax[3] ) noexcept
+    {
+        float center[3];
+        float extent[3];
+        for( int i = 0; i < 3; i++ )
+        {
+            center[i] = ( min[i] + max[i] ) * 0.5f;
+            extent[i] = ( max[i] - min[i] ) * 0.5f;
+        }
+        for( int j = 0; j < 3; j++ )
+        {
+            const auto c = center[0] * m[0][j] + center[1] * m[1][j] + center[2] * m[2][j] + m[3][j];
+            const auto e = std::fabs( extent[0] * m[0][j] ) + std::fabs( extent[1] * m[1][j] ) + std::fabs( extent[2] * m[2][j] );
+            outMin[j] = c - e;
+            outMax[j] = c + e;
+        }
+    }
+
+    // 访问器解析到 BIN 块里的一段：第 i 个元素在 pData + i * stride
+    struct Accessor
+    {
+        const std::byte* pData;
+        std::uint32_t count;
+        std::uint32_t stride;
+        std::uint32_t componentType;
+        std::uint32_t components;
+        bool normalized;
+        bool hasBounds;
+        float min[3];
+        float max[3];
+    };
+}
+
+// JSON 里用到的几个数组和 BIN 块；GltfGeometry 的友元，负责填它的私有成员
+class GltfGeometryBuilder
+{
+public:
+    GltfGeometryBuilder( const JsonValue& root,const std::byte* pBin,std::size_t binSize,const std::string& name )
+        :
+        pAccessors( root.Find( "accessors" ) ),
+        pBufferViews( root.Find( "bufferViews" ) ),
+        pBin( pBin ),
+        binSize( binSize ),
+        name( name )
+    {
+        // 只支持一个 buffer，而且是 BIN 块本身
+        const auto pBuffers = root.Find( "buffers" );
+        binIsBuffer0 = pBin != nullptr && pBuffers != nullptr && pBuffers->GetSize() > 0u &&
+            ( *pBuffers )[0].Find( "uri" ) == nullptr;
+    }
+    // primitive must have a POSITION attribute and a triangle mode; returns the bytes viewed in place and decoded
+    void Build( const JsonValue& primitive,GltfGeometry& geometry,std::size_t& bytesInPlace,std::size_t& bytesDecoded ) const
+    {
+        const auto positions = Resolve( primitive.Find( "attributes" )->GetInt( "POSITION",-1 ) );
+        if( positions.components != 3u || positions.componentType == componentUnsignedInt )
+        {
+            throw MESH_EXCEPT( "POSITION must be a VEC3 of floats or (normalized) 8 / 16 bit integers" );
+        }
+        geometry.vertexCount = positions.count;
+        const bool aligned = reinterpret_cast<std::uintptr_t>( positions.pData ) % 4u == 0u;
+        if( positions.componentType == componentFloat && aligned && positions.stride % 4u == 0u )
+        {
+            geometry.pPositions = positions.pData;
+            geometry.positionStride = positions.stride;
+            bytesInPlace += geometry.GetPositionBytes();
+        }
+        else
+        {
+            // 量化的位置（KHR_mesh_quantization）或没对齐，解码成 float3
+            geometry.decodedPositions.resize( std::size_t( positions.count ) * 3u );
+            const auto componentSize = GetComponentSize( positions.componentType );
+            for( std::size_t i = 0u; i < positions.count; i++ )
+            {
+                for( std::size_t c = 0u; c < 3u; c++ )
+                {
+                    geometry.decodedPositions[i * 3u + c] = ReadComponent(
+                        positions.pData + i * positions.stride + c * componentSize,positions.componentType,positions.normalized );
+                }
+            }
+            geometry.positionStride = 12u;
+            bytesDecoded += geometry.decodedPositions.size() * sizeof( float );
+        }
+        // 整数访问器的 min / max 是没有换算的原始值，只信任 float 的
+        if( positions.hasBounds && positions.componentType == componentFloat )
+        {
+            std::copy( positions.min,positions.min + 3,geometry.boundsMin );
+            std::copy( positions.max,positions.max + 3,geometry.boundsMax );
+        }
+        else
+        {
+            ComputeBounds( geometry );
+        }
+
+        const auto mode = std::uint32_t( primitive.GetInt( "mode",modeTriangles ) );
+        const auto indicesIndex = primitive.GetInt( "indices",-1 );
+        std::vector<std::uint32_t> source;
+        if( indicesIndex >= 0 )
+        {
+            const auto indices = Resolve( indicesIndex );
+            if( indices.components != 1u || ( indices.componentType != componentUnsignedByte &&
+                indices.componentType != componentUnsignedShort && indices.componentType != componentUnsignedInt ) )
+            {
+                throw MESH_EXCEPT( "indices must be unsigned 8 / 16 / 32 bit scalars" );
+            }
+            const auto indexSize = GetComponentSize( indices.componentType );
+            const bool indicesAligned = reinterpret_cast<std::uintptr_t>( indices.pData ) % indexSize == 0u;
+            if( mode == modeTriangles && indexSize >= 2u && indices.stride == indexSize && indicesAligned )
+            {
+                geometry.pIndices = indices.pData;
+                geometry.indexSize = indexSize;
+                geometry.indexCount = indices.count - indices.count % 3u;
+                bytesInPlace += std::size_t( geometry.indexCount ) * indexSize;
+                return;
+            }
+            source.resize( indices.count );
+            for( std::size_t i = 0u; i < indices.count; i++ )
+            {
+                source[i] = ReadIndex( indices.pData + i * indices.stride,indices.componentType );
+            }
+        }
+        else
+        {
+            source.resize( positions.count );
+            for( std::uint32_t i = 0u; i < positions.count; i++ )
+            {
+                source[i] = i;
+            }
+        }
+        DecodeIndices( source,mode,geometry );
+        bytesDecoded += geometry.decodedIndices.size();
+    }
+private:
+    Accessor Resolve( long long index ) const
+    {
+        if( pAccessors == nullptr || index < 0 || std::size_t( index ) >= pAccessors->GetSize() )
+        {
+            throw MESH_EXCEPT( "accessor index out of range" );
+        }
+        const auto& accessor = ( *pAccessors )[std::size_t( index )];
+        if( accessor.Find( "sparse" ) != nullptr )
+        {
+            throw MESH_EXCEPT( "sparse accessors are not supported" );
+        }
+        Accessor result = {};
+        result.componentType = std::uint32_t( accessor.GetInt( "componentType",0 ) );
+        result.components = GetComponentCount( accessor.GetString( "type" ) );
+        result.normalized = accessor.GetBool( "normalized",false );
+        const auto count = accessor.GetInt( "count",-1 );
+        const auto componentSize = GetComponentSize( result.componentType );
+        if( componentSize == 0u || result.components == 0u || count < 0 || count > std::numeric_limits<std::uint32_t>::max() )
+        {
+            throw MESH_EXCEPT( "accessor " + std::to_string( index ) + " has an invalid type or count" );
+        }
+        result.count = std::uint32_t( count );
+
+        const auto viewIndex = accessor.GetInt( "bufferView",-1 );
+        if( viewIndex < 0 || pBufferViews == nullptr || std::size_t( viewIndex ) >= pBufferViews->GetSize() )
+        {
+            throw MESH_EXCEPT( "accessor " + std::to_string( index ) + " has no buffer view (not supported)" );
+        }
+        const auto& view = ( *pBufferViews )[std::size_t( viewIndex )];
+        if( view.GetInt( "buffer",-1 ) != 0 || !binIsBuffer0 )
+        {
+            throw MESH_EXCEPT( "only the GLB binary chunk is supported as a buffer" );
+        }
+        const auto viewOffset = view.GetInt( "byteOffset",0 );
+        const auto viewLength = view.GetInt( "byteLength",-1 );
+        if( viewOffset < 0 || viewLength < 0 || std::size_t( viewOffset ) > binSize ||
+            std::size_t( viewLength ) > binSize - std::size_t( viewOffset ) )
+        {
+            throw MESH_EXCEPT( "buffer view " + std::to_string( viewIndex ) + " is outside the binary chunk" );
+        }
+        const auto elementSize = std::size_t( componentSize ) * result.components;
+        const auto byteStride = view.GetInt( "byteStride",0 );
+        if( byteStride != 0 && ( byteStride < static_cast<long long>( elementSize ) || byteStride > 252 ) )
+        {
+            throw MESH_EXCEPT( "buffer view " + std::to_string( viewIndex ) + " has an invalid byteStride" );
+        }
+        result.stride = byteStride != 0 ? std::uint32_t( byteStride ) : std::uint32_t( elementSize );
+        const auto offset = accessor.GetInt( "byteOffset",0 );
+        // 最后一个元素只需要 elementSize 字节
+        if( offset < 0 || ( result.count > 0u &&
+            std::size_t( offset ) + std::size_t( result.count - 1u ) * result.stride + elementSize > std::size_t( viewLength ) ) )
+        {
+            throw MESH_EXCEPT( "accessor " + std::to_string( index ) + " runs past its buffer view" );
+        }
+        result.pData = pBin + viewOffset + offset;
+
+        const auto pMin = accessor.Find( "min" );
+        const auto pMax = accessor.Find( "max" );
+        result.hasBounds = pMin != nullptr && pMax != nullptr && pMin->GetSize() == 3u && pMax->GetSize() == 3u;
+        if( result.hasBounds )
+        {
+            for( std::size_t c = 0u; c < 3u; c++ )
+            {
+                result.min[c] = float( ( *pMin )[c].GetNumber() );
+                result.max[c] = float( ( *pMax )[c].GetNumber() );
+            }
+        }
+        return result;
+    }
+    static void ComputeBounds( GltfGeometry& geometry ) noexcept
+    {
+        if( geometry.vertexCount == 0u )
+        {
+            return;
+        }
+        std::fill( std::begin( geometry.boundsMin ),std::end( geometry.boundsMin ),std::numeric_limits<float>::max() );
+        std::fill( std::begin( geometry.boundsMax ),std::end( geometry.boundsMax ),std::numeric_limits<float>::lowest() );
+        const auto pBase = geometry.GetPositions();
+        for( std::size_t i = 0u; i < geometry.vertexCount; i++ )
+        {
+            float p[3];
+            std::memcpy( p,pBase + i * geometry.positionStride,sizeof( p ) );
+            for( int c = 0; c < 3; c++ )
+            {
+                geometry.boundsMin[c] = std::min( geometry.boundsMin[c],p[c] );
+                geometry.boundsMax[c] = std::max( geometry.boundsMax[c],p[c] );
+            }
+        }
+    }
+    // 三角形带和扇按 glTF 规定的顶点顺序展开成列表，绕向保持逆时针
+    static void DecodeIndices( const std::vector<std::uint32_t>& source,std::uint32_t mode,GltfGeometry& geometry )
+    {
+        std::vector<std::uint32_t> list;
+        const auto n = source.size();
+        if( mode == modeTriangleStrip || mode == modeTriangleFan )
+        {
+            list.reserve( n > 2u ? ( n - 2u ) * 3u : 0u );
+            for( std::size_t i = 0u; i + 2u < n; i++ )
+            {
+                if( mode == modeTriangleStrip )
+                {
+                    list.push_back( source[i] );
+                    list.push_back( source[i + 1u + i % 2u] );
+                    list.push_back( source[i + 2u - i % 2u] );
+                }
+                else
+                {
+                    list.push_back( source[i + 1u] );
+                    list.push_back( source[i + 2u] );
+                    list.push_back( source[0] );
+                }
+            }
+        }
+        else
+        {
+            list.assign( source.begin(),source.begin() + std::ptrdiff_t( n - n % 3u ) );
+        }
+        geometry.indexCount = std::uint32_t( list.size() );
+        // 顶点不超过 65536 个时 16 位就够了
+        if( geometry.vertexCount <= 65536u )
+        {
+            geometry.indexSize = 2u;
+            geometry.decodedIndices.resize( list.size() * 2u );
+            for( std::size_t i = 0u; i < list.size(); i++ )
+            {
+                const auto index = std::uint16_t( list[i] );
+                std::memcpy( &geometry.decodedIndices[i * 2u],&index,2u );
+            }
+        }
+        else
+        {
+            geometry.indexSize = 4u;
+            geometry.decodedIndices.resize( list.size() * 4u );
+            std::memcpy( geometry.decodedIndices.data(),list.data(),geometry.decodedIndices.size() );
+        }
+    }
+private:
+    const JsonValue* pAccessors;
+    const JsonValue* pBufferViews;
+    const std::byte* pBin;
+    std::size_t binSize;
+    bool binIsBuffer0;
+    const std::string& name;
+};
+
+const std::byte* GltfGeometry::GetPositions() const noexcept
+{
+    return decodedPositions.empty() ? pPositions : reinterpret_cast<const std::byte*>( decodedPositions.data() );
+}
+
+std::uint32_t GltfGeometry::GetPositionStride() const noexcept
+{
+    return positionStride;
+}
+
+std::uint32_t GltfGeometry::GetPositionBytes() const noexcept
+{
+    return vertexCount == 0u ? 0u : ( vertexCount - 1u ) * positionStride + 12u;
+}
+
+std::uint32_t GltfGeometry::GetVertexCount() const noexcept
+{
+    return vertexCount;
+}
+
+const std::byte* GltfGeometry::GetIndices() const noexcept
+{
+    return decodedIndices.empty() ? pIndices : decodedIndices.data();
+}
+
+std::uint32_t GltfGeometry::GetIndexSize() const noexcept
+{
+    return indexSize;
+}
+
+std::uint32_t GltfGeometry::GetIndexCount() const noexcept
+{
+    return indexCount;
+}
+
+bool GltfGeometry::PositionsDecoded() const noexcept
+{
+    return !decodedPositions.empty();
+}
+
+bool GltfGeometry::IndicesDecoded() const noexcept
+{
+    return !decodedIndices.empty();
+}
+
+GltfScene GltfLoader::Load( const std::byte* pData,std::size_t size,const std::string& name,ThreadPool* pPool )
+{
+    // 12 字节文件头，然后是 JSON 块和可选的 BIN 块，每块 8 字节块头（长度、类型）
+    if( size < 20u || ReadU32( pData ) != glbMagic )
+    {
+        throw MESH_EXCEPT( "not a binary glTF file" );
+    }
+    if( ReadU32( pData + 4u ) != 2u )
+    {
+        throw MESH_EXCEPT( "unsupported glTF container version " + std::to_string( ReadU32( pData + 4u ) ) );
+    }
+    const auto fileLength = std::min<std::size_t>( ReadU32( pData + 8u ),size );
+    const auto jsonLength = ReadU32( pData + 12u );
+    if( ReadU32( pData + 16u ) != jsonChunkType || jsonLength > fileLength - 20u )
+    {
+        throw MESH_EXCEPT( "the first chunk must be JSON" );
+    }
+    const std::byte* pBin = nullptr;
+    std::size_t binSize = 0u;
+    // JSON 块按 4 字节对齐，BIN 块紧跟在后面
+    const auto binHeader = 20u + ( std::size_t( jsonLength ) + 3u ) / 4u * 4u;
+    if( binHeader + 8u <= fileLength && ReadU32( pData + binHeader + 4u ) == binChunkType )
+    {
+        binSize = ReadU32( pData + binHeader );
+        if( binSize > fileLength - binHeader - 8u )
+        {
+            throw MESH_EXCEPT( "the binary chunk is truncated" );
+        }
+        pBin = pData + binHeader + 8u;
+    }
+
+    JsonValue root;
+    std::string error;
+    if( !JsonValue::Parse( reinterpret_cast<const char*>( pData + 20u ),jsonLength,root,error ) )
+    {
+        throw MESH_EXCEPT( "JSON chunk: " + error );
+    }
+    const auto pAsset = root.Find( "asset" );
+    if( pAsset == nullptr || pAsset->GetString( "version" ).compare( 0u,2u,"2." ) != 0 )
+    {
+        throw MESH_EXCEPT( "only glTF 2.x assets are supported" );
+    }
+
+    static const JsonValue none;
+    const auto pNodes = root.Find( "nodes" );
+    const auto pMeshes = root.Find( "meshes" );
+    const auto& nodes = pNodes != nullptr ? *pNodes : none;
+    const auto& meshes = pMeshes != nullptr ? *pMeshes : none;
+    const auto nodeCount = nodes.GetSize();
+    const auto meshCount = meshes.GetSize();
+
+    GltfScene scene;
+    scene.stats.nodes = nodeCount;
+    scene.stats.meshes = meshCount;
+
+    // 根节点：scene 指定的场景（默认第一个）；文件里没有场景时取所有不是别人子节点的节点
+    std::vector<std::uint32_t> level;
+    const auto pScenes = root.Find( "scenes" );
+    if( pScenes != nullptr && pScenes->GetSize() > 0u )
+    {
+        const auto sceneIndex = root.GetInt( "scene",0 );
+        if( sceneIndex < 0 || std::size_t( sceneIndex ) >= pScenes->GetSize() )
+        {
+            throw MESH_EXCEPT( "scene index out of range" );
+        }
+        if( const auto pRoots = ( *pScenes )[std::size_t( sceneIndex )].Find( "nodes" ) )
+        {
+            for( std::size_t i = 0u; i < pRoots->GetSize(); i++ )
+            {
+                level.push_back( std::uint32_t( ( *pRoots )[i].GetNumber( -1.0 ) ) );
+            }
+        }
+    }
+    else
+    {
+        std::vector<bool> isChild( nodeCount,false );
+        for( std::size_t n = 0u; n < nodeCount; n++ )
+        {
+            if( const auto pChildren = nodes[n].Find( "children" ) )
+            {
+                for( std::size_t i = 0u; i < pChildren->GetSize(); i++ )
+                {
+                    const auto child = ( *pChildren )[i].GetNumber( -1.0 );
+                    if( child >= 0.0 && child < double( nodeCount ) )
+                    {
+                        isChild[std::size_t( child )] = true;
+                    }
+                }
+            }
+        }
+        for( std::size_t n = 0u; n < nodeCount; n++ )
+        {
+            if( !isChild[n] )
+            {
+                level.push_back( std::uint32_t( n ) );
+            }
+        }
+    }
+
+    // 从根往下按层收集用到的节点；节点必须是树，出现第二个父节点（包括环）就报错
+    constexpr auto noParent = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> parents( nodeCount,noParent );
+    std::vector<bool> visited( nodeCount,false );
+    std::vector<std::vector<std::uint32_t>> levels;
+    for( const auto n : level )
+    {
+        if( n >= nodeCount || visited[n] )
+        {
+            throw MESH_EXCEPT( "invalid or repeated scene root node" );
+        }
+        visited[n] = true;
+    }
+    while( !level.empty() )
+    {
+        std::vector<std::uint32_t> next;
+        for( const auto n : level )
+        {
+            const auto pChildren = nodes[n].Find( "children" );
+            for( std::size_t i = 0u; pChildren != nullptr && i < pChildren->GetSize(); i++ )
+            {
+                const auto child = ( *pChildren )[i].GetNumber( -1.0 );
+                if( child < 0.0 || child >= double( nodeCount ) || visited[std::size_t( child )] )
+                {
+                    throw MESH_EXCEPT( "node " + std::to_string( n ) + " has an invalid or shared child" );
+                }
+                visited[std::size_t( child )] = true;
+                parents[std::size_t( child )] = n;
+                next.push_back( std::uint32_t( child ) );
+            }
+        }
+        scene.stats.nodesUsed += level.size();
+        levels.push_back( std::move( level ) );
+        level = std::move( next );
+    }
+
+    // 用到的网格，每个的可画 primitive 在 geometries 里连续存放
+    std::vector<std::uint32_t> meshFirst( meshCount,0u );
+    std::vector<std::uint32_t> meshGeometries( meshCount,0u );
+    std::vector<bool> meshUsed( meshCount,false );
+    for( const auto& l : levels )
+    {
+        for( const auto n : l )
+        {
+            const auto mesh = nodes[n].GetInt( "mesh",-1 );
+            if( mesh >= 0 )
+            {
+                if( std::size_t( mesh ) >= meshCount )
+                {
+                    throw MESH_EXCEPT( "node " + std::to_string( n ) + " references a missing mesh" );
+                }
+                meshUsed[std::size_t( mesh )] = true;
+            }
+        }
+    }
+    std::vector<const JsonValue*> primitives;
+    for( std::size_t m = 0u; m < meshCount; m++ )
+    {
+        if( !meshUsed[m] )
+        {
+            continue;
+        }
+        scene.stats.meshesUsed++;
+        meshFirst[m] = std::uint32_t( primitives.size() );
+        const auto pPrimitives = meshes[m].Find( "primitives" );
+        for( std::size_t p = 0u; pPrimitives != nullptr && p < pPrimitives->GetSize(); p++ )
+        {
+            const auto& primitive = ( *pPrimitives )[p];
+            const auto mode = primitive.GetInt( "mode",modeTriangles );
+            const auto pAttributes = primitive.Find( "attributes" );
+            if( ( mode != modeTriangles && mode != modeTriangleStrip && mode != modeTriangleFan ) ||
+                pAttributes == nullptr || pAttributes->Find( "POSITION" ) == nullptr )
+            {
+                scene.stats.primitivesSkipped++;
+                continue;
+            }
+            primitives.push_back( &primitive );
+        }
+        meshGeometries[m] = std::uint32_t( primitives.size() ) - meshFirst[m];
+    }
+
+    // 每个 primitive 一个任务：检查访问器，能零拷贝的只记下指针，其他的解码
+    const GltfGeometryBuilder builder( root,pBin,binSize,name );
+    scene.geometries.resize( primitives.size() );
+    std::vector<std::size_t> bytesInPlace( primitives.size(),0u );
+    std::vector<std::size_t> bytesDecoded( primitives.size(),0u );
+    RunTasks( pPool,primitives.size(),[&]( std::size_t i ) {
+        builder.Build( *primitives[i],scene.geometries[i],bytesInPlace[i],bytesDecoded[i] );
+    } );
+    for( std::size_t i = 0u; i < primitives.size(); i++ )
+    {
+        scene.stats.bytesInPlace += bytesInPlace[i];
+        scene.stats.bytesDecoded += bytesDecoded[i];
+    }
+
+    // 世界矩阵一层一层算，同一层的节点互不依赖，可以并行。根节点的父矩阵是右手系到左手系的转换
+    const Matrix toLeftHanded = {
+        { 1.0f,0.0f,0.0f,0.0f },
+        { 0.0f,1.0f,0.0f,0.0f },
+        { 0.0f,0.0f,-1.0f,0.0f },
+        { 0.0f,0.0f,0.0f,1.0f } };
+    std::vector<NodeMatrix> worlds( nodeCount );
+    for( const auto& l : levels )
+    {
+        RunTasks( pPool,( l.size() + nodesPerTask - 1u ) / nodesPerTask,[&]( std::size_t task ) {
+            const auto last = std::min( l.size(),( task + 1u ) * nodesPerTask );
+            for( auto i = task * nodesPerTask; i < last; i++ )
+            {
+                const auto n = l[i];
+                Matrix local;
+                GetLocalMatrix( nodes[n],local );
+                Multiply( local,parents[n] == noParent ? toLeftHanded : worlds[parents[n]].m,worlds[n].m );
+            }
+        } );
+    }
+
+    // 每个带网格的节点、网格里的每个 primitive 一个实例
+    std::vector<std::uint32_t> meshNodes;
+    for( const auto& l : levels )
+    {
+        for( const auto n : l )
+        {
+            const auto mesh = nodes[n].GetInt( "mesh",-1 );
+            if( mesh >= 0 && meshGeometries[std::size_t( mesh )] > 0u )
+            {
+                meshNodes.push_back( n );
+            }
+        }
+    }
+    for( const auto n : meshNodes )
+    {
+        const auto mesh = std::size_t( nodes[n].GetInt( "mesh",-1 ) );
+        for( std::uint32_t g = 0u; g < meshGeometries[mesh]; g++ )
+        {
+            GltfInstance instance;
+            instance.geometry = meshFirst[mesh] + g;
+            std::memcpy( instance.world,worlds[n].m,sizeof( Matrix ) );
+            scene.instances.push_back( instance );
+        }
+    }
+
+    // 场景包围盒
+    std::fill( std::begin( scene.boundsMin ),std::end( scene.boundsMin ),scene.instances.empty() ? 0.0f : std::numeric_limits<float>::max() );
+    std::fill( std::begin( scene.boundsMax ),std::end( scene.boundsMax ),scene.instances.empty() ? 0.0f : std::numeric_limits<float>::lowest() );
+    for( const auto& instance : scene.instances )
+    {
+        const auto& geometry = scene.geometries[instance.geometry];
+        float min[3];
+        float max[3];
+        TransformBounds( geometry.boundsMin,geometry.boundsMax,instance.world,min,max );
+        for( int c = 0; c < 3; c++ )
+        {
+            scene.boundsMin[c] = std::min( scene.boundsMin[c],min[c] );
+            scene.boundsMax[c] = std::max( scene.boundsMax[c],max[c] );
+        }
+    }
+    return scene;
+}
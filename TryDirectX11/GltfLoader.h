@@ -0,0 +1,83 @@
+#pragma once
+#include "MeshData.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// 一个 primitive 的三角形列表。布局合适时（float3 位置，16 / 32 位索引）直接指向 .glb 的 BIN 块，
+// 交给 VertexBuffer / IndexBuffer 时不经过任何中间拷贝；量化的位置、8 位索引、三角形带 / 扇和没有索引的
+// primitive 才解码到自己的数组。索引不检查范围（D3D11 越界取顶点得到 0，不会出错）
+class GltfGeometry
+{
+    friend class GltfGeometryBuilder;
+public:
+    // float3 at GetPositionStride() byte intervals
+    const std::byte* GetPositions() const noexcept;
+    std::uint32_t GetPositionStride() const noexcept;
+    // 最后一个顶点后面不一定还有 stride - 12 字节，缓冲按这个大小创建
+    std::uint32_t GetPositionBytes() const noexcept;
+    std::uint32_t GetVertexCount() const noexcept;
+    const std::byte* GetIndices() const noexcept;
+    // 2 or 4
+    std::uint32_t GetIndexSize() const noexcept;
+    std::uint32_t GetIndexCount() const noexcept;
+    // true when the data is decoded into this object rather than viewed in the file
+    bool PositionsDecoded() const noexcept;
+    bool IndicesDecoded() const noexcept;
+    // object space
+    float boundsMin[3] = {};
+    float boundsMax[3] = {};
+private:
+    const std::byte* pPositions = nullptr;
+    std::uint32_t positionStride = 12u;
+    std::uint32_t vertexCount = 0u;
+    const std::byte* pIndices = nullptr;
+    std::uint32_t indexSize = 4u;
+    std::uint32_t indexCount = 0u;
+    // 只在不能零拷贝时使用；对象移动时 vector 的存储不动，上面的指针依然有效
+    std::vector<float> decodedPositions;
+    std::vector<std::byte> decodedIndices;
+};
+
+// 场景里的一次绘制：节点层级已经展开成世界矩阵（行向量约定，和 DirectXMath 一样），
+// 并且乘上了右手系到左手系的转换（z 取反），所以三角形在屏幕上是逆时针为正面
+struct GltfInstance
+{
+    std::uint32_t geometry;
+    float world[4][4];
+};
+
+struct GltfLoadStats
+{
+    std::size_t nodes = 0u;
+    std::size_t nodesUsed = 0u;
+    std::size_t meshes = 0u;
+    std::size_t meshesUsed = 0u;
+    // points / lines, or without POSITION
+    std::size_t primitivesSkipped = 0u;
+    // bytes handed to the GPU straight from the file vs. decoded first
+    std::size_t bytesInPlace = 0u;
+    std::size_t bytesDecoded = 0u;
+};
+
+struct GltfScene
+{
+    std::vector<GltfGeometry> geometries;
+    std::vector<GltfInstance> instances;
+    // world space, over all instances
+    float boundsMin[3] = {};
+    float boundsMax[3] = {};
+    GltfLoadStats stats;
+};
+
+// glTF 2.0 二进制（.glb）场景，pData 通常是 MappedFile 映射出来的整个文件，并且要活到场景里的缓冲都创建完。
+// 只处理 scene（没有时用第一个场景）能到达的节点和它们引用的网格，其他网格连访问器都不看。
+// 给了线程池时节点的世界矩阵按层并行计算，各 primitive 的检查 / 解码也并行；出错时抛 MeshException。
+// 只取几何：材质、纹理、蒙皮、动画和外部 .bin 文件都不支持（引用外部 buffer 的访问器会报错）
+namespace GltfLoader
+{
+    GltfScene Load( const std::byte* pData,std::size_t size,const std::string& name,ThreadPool* pPool = nullptr );
+}
@@ -4,6 +4,8 @@
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
 #include "GraphicsThrowMacros.h"
+#include "FrameArena.h"
+#include "PerfCounters.h"
 
 namespace wrl = Microsoft::WRL;
 namespace dx = DirectX;
@@ -13,6 +15,7 @@ namespace dx = DirectX;
 #pragma comment(lib, "D3DCompiler.lib")
 
 Graphics::Graphics(HWND hWnd) {
+    MemoryScope memoryScope(MemoryTag::Graphics);
     DXGI_SWAP_CHAIN_DESC sd = {};
     // 1. BufferDesc：这个结构体描述了待创建后台缓冲区的属性。在这里我们仅关注它的宽度、高
     // 度和像素格式属性。至于其他成员的细节可查看 SDK 文档。
@@ -151,6 +154,9 @@ Graphics::Graphics(HWND hWnd) {
     // 所以我们不需要为它填充任何初始化数据。当执行深度缓存和模板操作时，Direct3D会自动向深度/模板缓冲区写入数据。所以，
     // 我们在这里将第二个参数指定为空值。
     GFX_THROW_INFO(pDevice->CreateTexture2D(&descDepth, nullptr, &pDepthStencil));
+    // 后台缓冲区和深度缓冲区一样大，两者都是每像素 4 字节
+    backBufferMemory.Track(GpuMemoryKind::Texture, std::size_t(descDepth.Width) * descDepth.Height * 4u);
+    depthBufferMemory.Track(GpuMemoryKind::Texture, std::size_t(descDepth.Width) * descDepth.Height * 4u);
 
     // create view of depth stencil texture
     // 这个结构体描述了资源中这个元素数据类型（格式）。如果资源是一个有类型的格式（非 typeless），这个参数可以为空值，
@@ -178,13 +184,17 @@ Graphics::Graphics(HWND hWnd) {
     vp.TopLeftX = 0;
     vp.TopLeftY = 0;
     pContext->RSSetViewports(1u, &vp);
+    viewportWidth = vp.Width;
+    viewportHeight = vp.Height;
 }
 
 void Graphics::EndFrame() {
     HRESULT hr;
 #ifndef NDEBUG
-    infoManager.Set();
+    infoManager.Mark(__FILE__, __LINE__);
 #endif
+    // 输入延迟的终点是帧交给 Present 的时刻（之后的排队和扫描输出不在统计之内）
+    latencyTracker.OnPresent(frameId, LatencyTracker::Clock::now());
     // 该函数的参数是同步区间和显示标识。如果同步区
     // 间是 0 表示立即绘制，1,2,3,4 表示在第 n 个垂直消隐(vertical blanking)之后绘制。
     if (FAILED(hr = pSwap->Present(1u, 0u))) {
@@ -195,6 +205,21 @@ void Graphics::EndFrame() {
             throw GFX_EXCEPT(hr);
         }
     }
+#ifndef NDEBUG
+    // 整帧只查一次 info queue，消息数没变就直接返回
+    if (infoManager.Harvest()) {
+        throw Graphics::InfoException(__LINE__, __FILE__, infoManager.GetHarvestedMessages());
+    }
+#endif
+    if (pTrace) {
+        pTrace->EndFrame(frameId);
+        if (pTrace->IsDone()) {
+            pTrace.reset();
+        }
+    }
+    frameId++;
+    // 这一帧的临时数据在 FrameMemory::nBufferedFrames 帧之后才会被回收
+    FrameMemory::NextFrame();
 }
 
 void Graphics::ClearBuffer(float red, float green, float blue) noexcept {
@@ -204,10 +229,19 @@ void Graphics::ClearBuffer(float red, float green, float blue) noexcept {
     pContext->ClearDepthStencilView(pDSV.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0u);
 }
 
-void Graphics::DrawIndexed(UINT count) noexcept(!IS_DEBUG) {
-    GFX_THROW_INFO_ONLY(pContext->DrawIndexed(count, 0u, 0u));
+void Graphics::DrawIndexed(UINT count) noexcept {
+    DrawIndexed(count, 0u, 0);
+}
 
-    namespace wrl = Microsoft::WRL;
+void Graphics::DrawIndexed(UINT count, UINT startIndex, INT baseVertex) noexcept {
+    if (pTrace) {
+        pTrace->Draw(count, startIndex);
+    }
+    PerfCounters::Add(PerfCounter::DrawCalls);
+    PerfCounters::Add(PerfCounter::IndicesDrawn, count);
+    // 每次 draw 都走这里。DrawIndexed 没有返回值，Info 只是在调试版本里记下调用点（两次写入），
+    // 帧末收取到的消息才能对应到 draw；Release 下和 Unchecked 一样什么都不做（见 Tools/GfxCheckBench）
+    GFX_CHECK_CALL(GfxCheck::Info, pContext->DrawIndexed(count, startIndex, baseVertex));
 }
 
 
@@ -220,6 +254,22 @@ DirectX::XMMATRIX Graphics::GetProjection() const noexcept {
     return projection;
 }
 
+float Graphics::GetViewportWidth() const noexcept {
+    return viewportWidth;
+}
+
+float Graphics::GetViewportHeight() const noexcept {
+    return viewportHeight;
+}
+
+unsigned long long Graphics::GetFrameId() const noexcept {
+    return frameId;
+}
+
+LatencyTracker &Graphics::GetLatencyTracker() noexcept {
+    return latencyTracker;
+}
+
 // Graphics exception stuff
 Graphics::HrException::HrException(int line, const char *file, HRESULT hr, std::vector<std::string> infoMsgs) noexcept
         :
@@ -306,4 +356,13 @@ const char *Graphics::InfoException::GetType() const noexcept {
 
 std::string Graphics::InfoException::GetErrorInfo() const noexcept {
     return info;
-}
\ No newline at end of file
+}
+
+void Graphics::BeginTrace(const std::string &path, unsigned long long nFrames) {
+    MemoryScope memoryScope(MemoryTag::Tracing);
+    pTrace = std::make_unique<GraphicsTrace>(path, nFrames);
+}
+
+GraphicsTrace *Graphics::GetTrace() noexcept {
+    return pTrace.get();
+}
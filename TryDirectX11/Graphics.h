@@ -6,6 +6,9 @@
 #include <wrl.h>
 #include <vector>
 #include "DxgiInfoManager.h"
+#include "LatencyTracker.h"
+#include "GraphicsTrace.h"
+#include "MemoryTracker.h"
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
 #include <memory>
@@ -14,6 +17,7 @@
 
 class Graphics {
     friend class Bindable;
+    friend class BindStream;
 public:
     class Exception : public ChiliException
     {
@@ -58,11 +62,28 @@ public:
     ~Graphics() = default;
     void EndFrame();
     void ClearBuffer( float red,float green,float blue ) noexcept;
-    void DrawIndexed(UINT count) noexcept(!IS_DEBUG);
+    void DrawIndexed(UINT count) noexcept;
+    // 从索引缓冲的第 startIndex 个索引开始，每个索引加上 baseVertex（动态顶点缓冲里的批次用）
+    void DrawIndexed(UINT count, UINT startIndex, INT baseVertex) noexcept;
     void SetProjection(DirectX::FXMMATRIX proj) noexcept;
     DirectX::XMMATRIX GetProjection() const noexcept;
+    // 视口大小（像素），把投影后的大小换算成屏幕像素、屏幕坐标换算成 NDC 时用
+    float GetViewportWidth() const noexcept;
+    float GetViewportHeight() const noexcept;
+    // id of the frame currently being built, advances after each Present
+    unsigned long long GetFrameId() const noexcept;
+    LatencyTracker& GetLatencyTracker() noexcept;
+    // capture the next nFrames frames (0 = until the app exits) into a trace file, see GraphicsTrace
+    void BeginTrace(const std::string& path, unsigned long long nFrames);
+    // nullptr when no trace is being captured
+    GraphicsTrace* GetTrace() noexcept;
 private:
     DirectX::XMMATRIX projection;
+    float viewportWidth = 0.0f;
+    float viewportHeight = 0.0f;
+    unsigned long long frameId = 0u;
+    LatencyTracker latencyTracker;
+    std::unique_ptr<GraphicsTrace> pTrace;
 #ifndef NDEBUG
     DxgiInfoManager infoManager;
 #endif
@@ -71,5 +92,7 @@ private:
     Microsoft::WRL::ComPtr<ID3D11DeviceContext> pContext;
     Microsoft::WRL::ComPtr<ID3D11RenderTargetView> pTarget;
     Microsoft::WRL::ComPtr<ID3D11DepthStencilView> pDSV;
+    GpuAllocation backBufferMemory;
+    GpuAllocation depthBufferMemory;
 };
 
@@ -6,18 +6,62 @@
 #define GFX_EXCEPT_NOINFO(hr) Graphics::HrException( __LINE__,__FILE__,(hr) )
 #define GFX_THROW_NOINFO(hrcall) if( FAILED( hr = (hrcall) ) ) throw Graphics::HrException( __LINE__,__FILE__,hr )
 
+// 调试版本不再在每次调用前 Set()、调用后读 info queue：失败时才去取消息，
+// 没有返回值的调用只记下调用点，消息在 Graphics::EndFrame 里按帧统一收取（DxgiInfoManager::Harvest）
 #ifndef NDEBUG
 #define GFX_EXCEPT(hr) Graphics::HrException( __LINE__,__FILE__,(hr),infoManager.GetMessages() )
-#define GFX_THROW_INFO(hrcall) infoManager.Set(); if( FAILED( hr = (hrcall) ) ) throw GFX_EXCEPT(hr)
 #define GFX_DEVICE_REMOVED_EXCEPT(hr) Graphics::DeviceRemovedException( __LINE__,__FILE__,(hr),infoManager.GetMessages() )
-#define GFX_THROW_INFO_ONLY(call) infoManager.Set(); (call); {auto v = infoManager.GetMessages(); if(!v.empty()) {throw Graphics::InfoException( __LINE__,__FILE__,v);}}
+#define GFX_MARK_CALL(policy) if constexpr( policy::captureInfo ) { infoManager.Mark( __FILE__,__LINE__ ); }
 #else
 #define GFX_EXCEPT(hr) Graphics::HrException( __LINE__,__FILE__,(hr) )
-#define GFX_THROW_INFO(hrcall) GFX_THROW_NOINFO(hrcall)
 #define GFX_DEVICE_REMOVED_EXCEPT(hr) Graphics::DeviceRemovedException( __LINE__,__FILE__,(hr) )
-#define GFX_THROW_INFO_ONLY(call) (call)
+#define GFX_MARK_CALL(policy)
 #endif
 
+// 编译期的错误检查策略，每个调用点按自己的开销选一个：
+// 创建资源这类一次性的调用用 Info，每帧 / 每次 draw 都会走的热路径用 Hr 或 Unchecked。
+// 热路径上现在的选择：Graphics::DrawIndexed 用 Info（只在调试版本记调用点），动态顶点 / 索引缓冲的 Append 用 Info，
+// 每个物体每帧一次的 Map（TransformCbuf、BindStream 的 Transform、Mesh 的淡入淡出）用 Unchecked。
+// 各策略的开销见 Tools/GfxCheckBench
+namespace GfxCheck
+{
+    // HRESULT check, debug layer messages attached on failure and call site recorded for the frame harvest
+    struct Info
+    {
+        static constexpr bool checkResult = true;
+        static constexpr bool captureInfo = IS_DEBUG;
+    };
+    // HRESULT check only
+    struct Hr
+    {
+        static constexpr bool checkResult = true;
+        static constexpr bool captureInfo = false;
+    };
+    // no checks at all; hr is still assigned so the caller can bail out without throwing
+    struct Unchecked
+    {
+        static constexpr bool checkResult = false;
+        static constexpr bool captureInfo = false;
+    };
+}
+
+// check an HRESULT-returning call according to policy
+#define GFX_CHECK_HR(policy,hrcall) \
+    do { \
+        if constexpr( policy::checkResult ) { \
+            if( FAILED( hr = (hrcall) ) ) { \
+                if constexpr( policy::captureInfo ) { throw GFX_EXCEPT( hr ); } \
+                else { throw GFX_EXCEPT_NOINFO( hr ); } \
+            } \
+        } \
+        else { hr = (hrcall); } \
+    } while( false )
+// call without a return value: messages it produces are picked up by the per-frame harvest
+#define GFX_CHECK_CALL(policy,call) do { GFX_MARK_CALL(policy) (call); } while( false )
+
+// 创建资源等一次性的调用；热路径不要用它，直接写 GFX_CHECK_HR / GFX_CHECK_CALL 并选好策略
+#define GFX_THROW_INFO(hrcall) GFX_CHECK_HR( GfxCheck::Info,hrcall )
+
 // macro for importing infomanager into local scope
 // this.GetInfoManager(Graphics& gfx) must exist
 #ifdef NDEBUG
@@ -27,4 +71,4 @@
 // Sometimes it is necessary to enclose macro params otherwise they fail when an expression is
 // used as the argument instead of a single symbol. Doesn't make a difference on this line, just a habit.
 #define INFOMAN(gfx) HRESULT hr; DxgiInfoManager& infoManager = GetInfoManager((gfx))
-#endif
\ No newline at end of file
+#endif
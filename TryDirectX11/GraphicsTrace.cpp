@@ -0,0 +1,104 @@
+#include "GraphicsTrace.h"
+#include "BindStream.h"
+#include <cstring>
+#include <iterator>
+#include <sstream>
+
+static_assert(std::size( traceBindOpNames ) == std::size_t( TraceBindOp::Count ),"Missing trace op name");
+static_assert(std::size_t( BindStream::Op::Rasterizer ) == std::size_t( TraceBindOp::Rasterizer ),
+              "TraceBindOp must follow BindStream::Op");
+
+GraphicsTrace::GraphicsTrace( const std::string& path,unsigned long long nFrames )
+    :
+    path( path ),
+    file( path,std::ios::binary | std::ios::trunc ),
+    framesLeft( nFrames ),
+    unlimited( nFrames == 0u )
+{
+    if( !file )
+    {
+        throw Exception( __LINE__,__FILE__,path,"Cannot open trace for writing" );
+    }
+    TraceHeader header = {};
+    std::memcpy( header.magic,traceMagic,sizeof( traceMagic ) );
+    header.version = traceVersion;
+    header.recordSize = sizeof( TraceRecord );
+    file.write( reinterpret_cast<const char*>( &header ),sizeof( header ) );
+    records.reserve( maxRecordsPerFrame );
+}
+
+void GraphicsTrace::Bind( TraceBindOp op,std::uint32_t arg,const void* pObject ) noexcept
+{
+    Push( TraceRecordKind::Bind,op,arg,reinterpret_cast<std::uintptr_t>( pObject ) );
+}
+
+void GraphicsTrace::Map( const void* pObject,std::uint32_t bytes ) noexcept
+{
+    Push( TraceRecordKind::Map,TraceBindOp::Count,bytes,reinterpret_cast<std::uintptr_t>( pObject ) );
+}
+
+void GraphicsTrace::Draw( std::uint32_t indexCount,std::uint32_t startIndex ) noexcept
+{
+    Push( TraceRecordKind::Draw,TraceBindOp::Count,indexCount,startIndex );
+}
+
+void GraphicsTrace::EndFrame( unsigned long long frameId )
+{
+    if( IsDone() )
+    {
+        return;
+    }
+    // Push 给 FrameEnd 留了最后一个位置
+    records.push_back( { TraceRecordKind::FrameEnd,TraceBindOp::Count,0u,truncated ? 1u : 0u,frameId } );
+    truncated = false;
+    file.write( reinterpret_cast<const char*>( records.data() ),std::streamsize( records.size() * sizeof( TraceRecord ) ) );
+    file.flush();
+    if( !file )
+    {
+        throw Exception( __LINE__,__FILE__,path,"Write failed" );
+    }
+    records.clear();
+    if( !unlimited )
+    {
+        framesLeft--;
+    }
+}
+
+bool GraphicsTrace::IsDone() const noexcept
+{
+    return !unlimited && framesLeft == 0u;
+}
+
+void GraphicsTrace::Push( TraceRecordKind kind,TraceBindOp op,std::uint32_t arg,std::uint64_t object ) noexcept
+{
+    // 只用构造时预留的容量，push_back 不会分配，noexcept 成立
+    if( records.size() + 1u >= maxRecordsPerFrame )
+    {
+        truncated = true;
+        return;
+    }
+    records.push_back( { kind,op,0u,arg,object } );
+}
+
+GraphicsTrace::Exception::Exception( int line,const char* file,std::string path,std::string note ) noexcept
+    :
+    ChiliException( line,file ),
+    path( std::move( path ) ),
+    note( std::move( note ) )
+{}
+
+const char* GraphicsTrace::Exception::what() const noexcept
+{
+    std::ostringstream oss;
+    oss << GetType() << std::endl
+        << "[Path] " << path << std::endl
+        << "[Note] " << note << std::endl
+        << GetOriginString();
+    whatBuffer = oss.str();
+    return whatBuffer.c_str();
+}
+
+const char* GraphicsTrace::Exception::GetType() const noexcept
+{
+    return "Graphics Trace Exception";
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "ChiliException.h"
+#include "TraceFormat.h"
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 把每帧的 bind / map / draw 调用写成二进制 trace（格式见 TraceFormat.h），
+// 离线用 Tools/TraceAnalyzer 分析冗余绑定、常量缓冲上传量、按管线状态的 draw 数等。
+// 记录一帧只是往预留好的数组里追加，帧末一次写盘；数组满了就不再记录这一帧，FrameEnd 上标记为截断（不分配、不抛异常）。
+class GraphicsTrace
+{
+public:
+    class Exception : public ChiliException
+    {
+    public:
+        Exception( int line,const char* file,std::string path,std::string note ) noexcept;
+        const char* what() const noexcept override;
+        const char* GetType() const noexcept override;
+    private:
+        std::string path;
+        std::string note;
+    };
+public:
+    // records per frame, including its FrameEnd
+    static constexpr std::size_t maxRecordsPerFrame = 64u * 1024u;
+    // captures nFrames frames, 0 = until destroyed
+    GraphicsTrace( const std::string& path,unsigned long long nFrames );
+    GraphicsTrace( const GraphicsTrace& ) = delete;
+    GraphicsTrace& operator=( const GraphicsTrace& ) = delete;
+    void Bind( TraceBindOp op,std::uint32_t arg,const void* pObject ) noexcept;
+    void Map( const void* pObject,std::uint32_t bytes ) noexcept;
+    void Draw( std::uint32_t indexCount,std::uint32_t startIndex ) noexcept;
+    void EndFrame( unsigned long long frameId );
+    bool IsDone() const noexcept;
+private:
+    void Push( TraceRecordKind kind,TraceBindOp op,std::uint32_t arg,std::uint64_t object ) noexcept;
+private:
+    std::string path;
+    std::ofstream file;
+    std::vector<TraceRecord> records;
+    unsigned long long framesLeft;
+    bool unlimited;
+    // 这一帧有记录因为数组满了被丢掉
+    bool truncated = false;
+};
@@ -0,0 +1,33 @@
+// LOD 交叉淡入淡出（LodFadeConstants）：新旧两级各画一次，按 4x4 Bayer 矩阵分掉像素，两次正好互补；
+// 不在过渡中时 coverage = 1、complement = 0，所有像素都画
+cbuffer LodFade
+{
+    float coverage;
+    uint complement;
+};
+
+static const float bayer[16] =
+{
+    0.0f, 8.0f, 2.0f, 10.0f,
+    12.0f, 4.0f, 14.0f, 6.0f,
+    3.0f, 11.0f, 1.0f, 9.0f,
+    15.0f, 7.0f, 13.0f, 5.0f,
+};
+
+// 导入的模型没有材质，按三角形第一个顶点的编号散列出一个颜色，能看清网格的密度。
+// 不用 SV_PrimitiveID：按簇剔除后每帧的索引列表不一样，三角形编号会跳，颜色跟着闪
+float4 main(float4 pos : SV_Position, nointerpolation uint vid : VertexId) : SV_Target
+{
+    const uint2 p = uint2(pos.xy) & 3u;
+    const float threshold = (bayer[p.y * 4u + p.x] + 0.5f) / 16.0f;
+    if ((threshold < coverage) == (complement != 0u))
+    {
+        discard;
+    }
+    uint h = vid * 2654435761u;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    float3 c = float3((h & 0xFFu), (h >> 8) & 0xFFu, (h >> 16) & 0xFFu) / 255.0f;
+    return float4(0.25f + 0.75f * c, 1.0f);
+}
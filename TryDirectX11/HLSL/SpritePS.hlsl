@@ -0,0 +1,10 @@
+Texture2D tex;
+SamplerState smp;
+
+float4 main(float2 uv : TexCoord, float4 color : Color) : SV_Target
+{
+    float4 c = tex.Sample(smp, uv) * color;
+    // 没有混合状态，半透明的像素直接丢掉
+    clip(c.a - 0.5f);
+    return c;
+}
@@ -0,0 +1,16 @@
+struct VSOut
+{
+    float2 uv : TexCoord;
+    float4 color : Color;
+    float4 pos : SV_Position;
+};
+
+// 精灵的顶点在 CPU 上已经换算成 NDC（见 SpriteQueue），这里原样输出
+VSOut main(float2 pos : Position, float2 uv : TexCoord, float4 color : Color)
+{
+    VSOut vso;
+    vso.uv = uv;
+    vso.color = color;
+    vso.pos = float4(pos, 0.0f, 1.0f);
+    return vso;
+}
@@ -1,6 +1,8 @@
 struct VSOut
 {
     float4 pos : SV_Position;
+    // 顶点编号，MeshPS 按三角形第一个顶点（provoking vertex）的编号散列颜色
+    nointerpolation uint vid : VertexId;
 };
 
 // 常数缓冲
@@ -8,9 +10,10 @@ cbuffer CBuf{
     matrix transform;
 };
 
-VSOut main(float3 pos : Position)
+VSOut main(float3 pos : Position, uint vid : SV_VertexID)
 {
     VSOut vso;
     vso.pos = mul(float4(pos, 1.0f), transform);
+    vso.vid = vid;
     return vso;
 }
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "Image.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <sstream>
+
+ImageException::ImageException( int line,const char* file,std::string name,std::string note ) noexcept
+    :
+    ChiliException( line,file ),
+    name( std::move( name ) ),
+    note( std::move( note ) )
+{}
+
+const char* ImageException::what() const noexcept
+{
+    std::ostringstream oss;
+    oss << GetType() << std::endl
+        << "[Image] " << name << std::endl
+        << "[Note] " << note << std::endl
+        << GetOriginString();
+    whatBuffer = oss.str();
+    return whatBuffer.c_str();
+}
+
+const char* ImageException::GetType() const noexcept
+{
+    return "Image Exception";
+}
+
+const std::string& ImageException::GetName() const noexcept
+{
+    return name;
+}
+
+const std::string& ImageException::GetNote() const noexcept
+{
+    return note;
+}
+
+Image::Image( std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t mipCount )
+    :
+    width( width ),
+    height( height ),
+    format( format ),
+    mipCount( mipCount == 0u ? GetFullMipCount( width,height ) : mipCount )
+{
+    assert( "Image must not be empty" && width > 0u && height > 0u );
+    assert( "Too many mip levels" && this->mipCount <= GetFullMipCount( width,height ) );
+    dataSize = Layout();
+    pData.reset( new std::byte[dataSize] );
+}
+
+std::uint32_t Image::GetWidth() const noexcept
+{
+    return width;
+}
+
+std::uint32_t Image::GetHeight() const noexcept
+{
+    return height;
+}
+
+ImageFormat Image::GetFormat() const noexcept
+{
+    return format;
+}
+
+std::uint32_t Image::GetMipCount() const noexcept
+{
+    return mipCount;
+}
+
+const Image::Mip& Image::GetMip( std::uint32_t level ) const noexcept
+{
+    assert( level < mipCount );
+    return mips[level];
+}
+
+std::byte* Image::GetMipData( std::uint32_t level ) noexcept
+{
+    assert( level < mipCount );
+    return pData.get() + mips[level].offset;
+}
+
+const std::byte* Image::GetMipData( std::uint32_t level ) const noexcept
+{
+    assert( level < mipCount );
+    return pData.get() + mips[level].offset;
+}
+
+std::size_t Image::GetDataSize() const noexcept
+{
+    return dataSize;
+}
+
+bool Image::IsEmpty() const noexcept
+{
+    return mipCount == 0u;
+}
+
+void Image::AllocateMipChain()
+{
+    const auto full = GetFullMipCount( width,height );
+    if( mipCount == full )
+    {
+        return;
+    }
+    // 第 0 层的位置不会变（偏移总是 0），拷过去就行
+    const auto base = mips[0];
+    mipCount = full;
+    dataSize = Layout();
+    std::unique_ptr<std::byte[]> pNew( new std::byte[dataSize] );
+    std::memcpy( pNew.get(),pData.get(),base.size );
+    pData = std::move( pNew );
+}
+
+bool Image::IsCompressed( ImageFormat format ) noexcept
+{
+    return format != ImageFormat::RGBA8 && format != ImageFormat::RGBA8Srgb;
+}
+
+bool Image::IsSrgb( ImageFormat format ) noexcept
+{
+    switch( format )
+    {
+    case ImageFormat::RGBA8Srgb:
+    case ImageFormat::BC1Srgb:
+    case ImageFormat::BC3Srgb:
+    case ImageFormat::BC7Srgb:
+        return true;
+    default:
+        return false;
+    }
+}
+
+std::uint32_t Image::GetElementSize( ImageFormat format ) noexcept
+{
+    switch( format )
+    {
+    case ImageFormat::RGBA8:
+    case ImageFormat::RGBA8Srgb:
+        return 4u;
+    case ImageFormat::BC1:
+    case ImageFormat::BC1Srgb:
+    case ImageFormat::BC4:
+        return 8u;
+    default:
+        return 16u;
+    }
+}
+
+std::uint32_t Image::GetFullMipCount( std::uint32_t width,std::uint32_t height ) noexcept
+{
+    std::uint32_t n = 1u;
+    for( auto size = std::max( width,height ); size > 1u; size >>= 1u )
+    {
+        n++;
+    }
+    return n;
+}
+
+std::size_t Image::GetLevelSize( std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t level ) noexcept
+{
+    const auto w = std::max( width >> level,1u );
+    const auto h = std::max( height >> level,1u );
+    if( IsCompressed( format ) )
+    {
+        return std::size_t( ( w + 3u ) / 4u ) * ( ( h + 3u ) / 4u ) * GetElementSize( format );
+    }
+    return std::size_t( w ) * h * GetElementSize( format );
+}
+
+std::size_t Image::Layout() noexcept
+{
+    assert( "Too many mip levels" && mipCount <= maxMipCount );
+    const auto compressed = IsCompressed( format );
+    const auto elementSize = GetElementSize( format );
+    std::size_t offset = 0u;
+    for( std::uint32_t level = 0u; level < mipCount; level++ )
+    {
+        auto& m = mips[level];
+        m.width = std::max( width >> level,1u );
+        m.height = std::max( height >> level,1u );
+        const auto columns = compressed ? ( m.width + 3u ) / 4u : m.width;
+        m.rowPitch = columns * elementSize;
+        m.offset = offset;
+        m.size = GetLevelSize( width,height,format,level );
+        // 每层 16 字节对齐，方便 SIMD 读写
+        offset = ( offset + m.size + 15u ) & ~std::size_t( 15u );
+    }
+    return offset;
+}
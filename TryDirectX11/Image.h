@@ -0,0 +1,93 @@
+#pragma once
+#include "ChiliException.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// CPU 端的图像和 mip 链。只用标准 C++（Tools/TextureBench 也要编译），和 DXGI_FORMAT 的对应关系在 Texture.cpp 里。
+
+enum class ImageFormat : std::uint8_t
+{
+    RGBA8,
+    RGBA8Srgb,
+    // 块压缩格式：每 4x4 像素一块，BC1/BC4 每块 8 字节，其余 16 字节
+    BC1,
+    BC1Srgb,
+    BC3,
+    BC3Srgb,
+    BC4,
+    BC5,
+    BC7,
+    BC7Srgb,
+};
+
+class ImageException : public ChiliException
+{
+public:
+    ImageException( int line,const char* file,std::string name,std::string note ) noexcept;
+    const char* what() const noexcept override;
+    const char* GetType() const noexcept override;
+    // file name or whatever the caller used to identify the image
+    const std::string& GetName() const noexcept;
+    const std::string& GetNote() const noexcept;
+private:
+    std::string name;
+    std::string note;
+};
+
+// 所有 mip 层放在同一块内存里，每层 16 字节对齐，行与行紧挨着；
+// 每层的 (数据, rowPitch) 可以直接填进 D3D11_SUBRESOURCE_DATA，一次 CreateTexture2D 建好整条链。
+class Image
+{
+public:
+    struct Mip
+    {
+        std::uint32_t width;
+        std::uint32_t height;
+        // bytes per row of pixels, or per row of 4x4 blocks for BC formats
+        std::uint32_t rowPitch;
+        std::size_t offset;
+        std::size_t size;
+    };
+    static constexpr std::uint32_t maxMipCount = 16u;
+public:
+    Image() = default;
+    // mipCount 0 = full chain down to 1x1; pixel contents are left uninitialized
+    Image( std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t mipCount = 1u );
+    Image( Image&& ) noexcept = default;
+    Image& operator=( Image&& ) noexcept = default;
+    Image( const Image& ) = delete;
+    Image& operator=( const Image& ) = delete;
+    std::uint32_t GetWidth() const noexcept;
+    std::uint32_t GetHeight() const noexcept;
+    ImageFormat GetFormat() const noexcept;
+    std::uint32_t GetMipCount() const noexcept;
+    const Mip& GetMip( std::uint32_t level ) const noexcept;
+    std::byte* GetMipData( std::uint32_t level ) noexcept;
+    const std::byte* GetMipData( std::uint32_t level ) const noexcept;
+    // all levels including alignment padding
+    std::size_t GetDataSize() const noexcept;
+    bool IsEmpty() const noexcept;
+    // grows the image to the full mip chain, keeping level 0; the new levels are uninitialized
+    void AllocateMipChain();
+    static bool IsCompressed( ImageFormat format ) noexcept;
+    static bool IsSrgb( ImageFormat format ) noexcept;
+    // bytes per pixel for uncompressed formats, per 4x4 block for BC formats
+    static std::uint32_t GetElementSize( ImageFormat format ) noexcept;
+    static std::uint32_t GetFullMipCount( std::uint32_t width,std::uint32_t height ) noexcept;
+    // tightly packed size of one level of a width x height image (same as Mip::size)
+    static std::size_t GetLevelSize( std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t level ) noexcept;
+private:
+    // fills mips[0..mipCount) and returns the total size
+    std::size_t Layout() noexcept;
+private:
+    std::uint32_t width = 0u;
+    std::uint32_t height = 0u;
+    ImageFormat format = ImageFormat::RGBA8;
+    std::uint32_t mipCount = 0u;
+    Mip mips[maxMipCount] = {};
+    // 不用 vector，省掉对整块像素的清零
+    std::unique_ptr<std::byte[]> pData;
+    std::size_t dataSize = 0u;
+};
@@ -0,0 +1,1107 @@
+#include "ImageCodecs.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+#define IMAGE_EXCEPT( note ) ImageException( __LINE__,__FILE__,name,(note) )
+
+namespace
+{
+    std::uint16_t ReadLE16( const std::uint8_t* p ) noexcept
+    {
+        return std::uint16_t( p[0] | ( p[1] << 8 ) );
+    }
+
+    std::uint32_t ReadLE32( const std::uint8_t* p ) noexcept
+    {
+        return std::uint32_t( p[0] ) | ( std::uint32_t( p[1] ) << 8 ) | ( std::uint32_t( p[2] ) << 16 ) | ( std::uint32_t( p[3] ) << 24 );
+    }
+
+    void WriteLE32( std::uint8_t* p,std::uint32_t v ) noexcept
+    {
+        p[0] = std::uint8_t( v );
+        p[1] = std::uint8_t( v >> 8 );
+        p[2] = std::uint8_t( v >> 16 );
+        p[3] = std::uint8_t( v >> 24 );
+    }
+
+    std::uint32_t ReadBE32( const std::uint8_t* p ) noexcept
+    {
+        return ( std::uint32_t( p[0] ) << 24 ) | ( std::uint32_t( p[1] ) << 16 ) | ( std::uint32_t( p[2] ) << 8 ) | std::uint32_t( p[3] );
+    }
+
+    // D3D11 的 Texture2D 最大边长
+    constexpr std::uint32_t maxDimension = 16384u;
+
+    // ---------------------------------------------------------------- inflate
+    // 查表解码：码长不超过 fastBits 的符号一次查表得到，更长的按范式 Huffman 逐位比较
+    constexpr int fastBits = 9;
+    constexpr std::uint32_t fastMask = ( 1u << fastBits ) - 1u;
+
+    struct Huffman
+    {
+        // (码长 << 9) | 符号，0 表示需要走慢路径
+        std::uint16_t fast[1u << fastBits];
+        std::uint16_t firstCode[16];
+        std::uint32_t maxCode[17];
+        std::uint16_t firstSymbol[16];
+        std::uint8_t size[288];
+        std::uint16_t value[288];
+    };
+
+    std::uint32_t BitReverse16( std::uint32_t v ) noexcept
+    {
+        v = ( ( v & 0xAAAAu ) >> 1 ) | ( ( v & 0x5555u ) << 1 );
+        v = ( ( v & 0xCCCCu ) >> 2 ) | ( ( v & 0x3333u ) << 2 );
+        v = ( ( v & 0xF0F0u ) >> 4 ) | ( ( v & 0x0F0Fu ) << 4 );
+        v = ( ( v & 0xFF00u ) >> 8 ) | ( ( v & 0x00FFu ) << 8 );
+        return v;
+    }
+
+    // false if the code lengths do not describe a valid prefix code
+    bool BuildHuffman( Huffman& h,const std::uint8_t* lengths,int n ) noexcept
+    {
+        int sizes[17] = {};
+        std::memset( h.fast,0,sizeof( h.fast ) );
+        for( int i = 0; i < n; i++ )
+        {
+            sizes[lengths[i]]++;
+        }
+        sizes[0] = 0;
+        for( int i = 1; i < 16; i++ )
+        {
+            if( sizes[i] > ( 1 << i ) )
+            {
+                return false;
+            }
+        }
+        int nextCode[16];
+        int code = 0;
+        int k = 0;
+        for( int i = 1; i < 16; i++ )
+        {
+            nextCode[i] = code;
+            h.firstCode[i] = std::uint16_t( code );
+            h.firstSymbol[i] = std::uint16_t( k );
+            code += sizes[i];
+            if( sizes[i] != 0 && code - 1 >= ( 1 << i ) )
+            {
+                return false;
+            }
+            h.maxCode[i] = std::uint32_t( code ) << ( 16 - i );
+            code <<= 1;
+            k += sizes[i];
+        }
+        h.maxCode[16] = 0x10000u;
+        for( int i = 0; i < n; i++ )
+        {
+            const int s = lengths[i];
+            if( s == 0 )
+            {
+                continue;
+            }
+            const int c = nextCode[s] - h.firstCode[s] + h.firstSymbol[s];
+            h.size[c] = std::uint8_t( s );
+            h.value[c] = std::uint16_t( i );
+            if( s <= fastBits )
+            {
+                // 低位先出，表下标是反转后的码字，高位随便填
+                for( auto j = BitReverse16( std::uint32_t( nextCode[s] ) ) >> ( 16 - s ); j < ( 1u << fastBits ); j += 1u << s )
+                {
+                    h.fast[j] = std::uint16_t( ( s << 9 ) | i );
+                }
+            }
+            nextCode[s]++;
+        }
+        return true;
+    }
+
+    constexpr std::uint16_t lengthBase[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+    constexpr std::uint8_t lengthExtra[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+    constexpr std::uint16_t distanceBase[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+    constexpr std::uint8_t distanceExtra[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+
+    struct FixedTables
+    {
+        Huffman literal;
+        Huffman distance;
+        FixedTables() noexcept
+        {
+            std::uint8_t lengths[288];
+            std::fill( lengths,lengths + 144,std::uint8_t( 8u ) );
+            std::fill( lengths + 144,lengths + 256,std::uint8_t( 9u ) );
+            std::fill( lengths + 256,lengths + 280,std::uint8_t( 7u ) );
+            std::fill( lengths + 280,lengths + 288,std::uint8_t( 8u ) );
+            BuildHuffman( literal,lengths,288 );
+            std::fill( lengths,lengths + 30,std::uint8_t( 5u ) );
+            BuildHuffman( distance,lengths,30 );
+        }
+    };
+
+    class Inflater
+    {
+    public:
+        Inflater( const std::byte* pData,std::size_t size,std::byte* pOut,std::size_t outSize,const std::string& name ) noexcept
+            :
+            pIn( reinterpret_cast<const std::uint8_t*>( pData ) ),
+            pInEnd( pIn + size ),
+            pOutBegin( reinterpret_cast<std::uint8_t*>( pOut ) ),
+            pOut( pOutBegin ),
+            pOutEnd( pOutBegin + outSize ),
+            name( name )
+        {}
+        std::size_t Run()
+        {
+            if( pInEnd - pIn < 2 )
+            {
+                throw IMAGE_EXCEPT( "zlib stream is truncated" );
+            }
+            const unsigned cmf = pIn[0];
+            const unsigned flg = pIn[1];
+            if( ( cmf & 15u ) != 8u || ( ( cmf << 8 ) | flg ) % 31u != 0u || ( flg & 32u ) != 0u )
+            {
+                throw IMAGE_EXCEPT( "Bad zlib header" );
+            }
+            pIn += 2;
+            static const FixedTables fixed;
+            bool final;
+            do
+            {
+                final = GetBits( 1 ) != 0u;
+                switch( GetBits( 2 ) )
+                {
+                case 0u:
+                    Stored();
+                    break;
+                case 1u:
+                    Block( fixed.literal,fixed.distance );
+                    break;
+                case 2u:
+                {
+                    Huffman literal;
+                    Huffman distance;
+                    ReadDynamicTables( literal,distance );
+                    Block( literal,distance );
+                    break;
+                }
+                default:
+                    throw IMAGE_EXCEPT( "Bad deflate block type" );
+                }
+            } while( !final );
+            return std::size_t( pOut - pOutBegin );
+        }
+    private:
+        // 保证缓冲里至少有 56 位。数据够长时一次读 8 字节（小端），只前进实际用掉的字节数；
+        // 多读进来的高位和之后真正读到的是同样的字节，再 OR 一次不会变
+        void Fill()
+        {
+            if( pInEnd - pIn >= 8 )
+            {
+                std::uint64_t v;
+                std::memcpy( &v,pIn,8u );
+                bits |= v << nBits;
+                pIn += ( 63 - nBits ) >> 3;
+                nBits |= 56;
+                return;
+            }
+            while( nBits <= 56 )
+            {
+                if( pIn < pInEnd )
+                {
+                    bits |= std::uint64_t( *pIn++ ) << nBits;
+                }
+                else if( ++overrun > 8 )
+                {
+                    // 补进来的 0 已经被用掉了，说明流被截断
+                    throw IMAGE_EXCEPT( "zlib stream is truncated" );
+                }
+                nBits += 8;
+            }
+        }
+        std::uint32_t GetBits( int n )
+        {
+            if( nBits < n )
+            {
+                Fill();
+            }
+            const auto v = std::uint32_t( bits & ( ( 1ull << n ) - 1u ) );
+            bits >>= n;
+            nBits -= n;
+            return v;
+        }
+        int Decode( const Huffman& h )
+        {
+            if( nBits < 16 )
+            {
+                Fill();
+            }
+            if( const auto b = h.fast[bits & fastMask] )
+            {
+                const int s = b >> 9;
+                bits >>= s;
+                nBits -= s;
+                return b & 511;
+            }
+            const auto k = BitReverse16( std::uint32_t( bits & 0xFFFFu ) );
+            int s = fastBits + 1;
+            while( k >= h.maxCode[s] )
+            {
+                s++;
+            }
+            if( s >= 16 )
+            {
+                throw IMAGE_EXCEPT( "Bad Huffman code" );
+            }
+            const auto c = ( k >> ( 16 - s ) ) - h.firstCode[s] + h.firstSymbol[s];
+            if( c >= 288u || h.size[c] != s )
+            {
+                throw IMAGE_EXCEPT( "Bad Huffman code" );
+            }
+            bits >>= s;
+            nBits -= s;
+            return h.value[c];
+        }
+        void Stored()
+        {
+            GetBits( nBits & 7 );
+            const auto length = GetBits( 16 );
+            if( ( length ^ 0xFFFFu ) != GetBits( 16 ) )
+            {
+                throw IMAGE_EXCEPT( "Corrupt stored block" );
+            }
+            // 缓冲里剩下的整字节（包括预读的）退回输入，整块直接从输入拷
+            const int buffered = ( nBits >> 3 ) - overrun;
+            if( buffered < 0 )
+            {
+                throw IMAGE_EXCEPT( "zlib stream is truncated" );
+            }
+            pIn -= buffered;
+            bits = 0u;
+            nBits = 0;
+            overrun = 0;
+            if( std::size_t( pInEnd - pIn ) < length )
+            {
+                throw IMAGE_EXCEPT( "zlib stream is truncated" );
+            }
+            if( std::size_t( pOutEnd - pOut ) < length )
+            {
+                throw IMAGE_EXCEPT( "Decompressed data is larger than expected" );
+            }
+            std::memcpy( pOut,pIn,length );
+            pIn += length;
+            pOut += length;
+        }
+        void ReadDynamicTables( Huffman& literal,Huffman& distance )
+        {
+            static constexpr std::uint8_t order[19] = { 16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15 };
+            const int nLiteral = int( GetBits( 5 ) ) + 257;
+            const int nDistance = int( GetBits( 5 ) ) + 1;
+            const int nCodeLength = int( GetBits( 4 ) ) + 4;
+            std::uint8_t codeLengths[19] = {};
+            for( int i = 0; i < nCodeLength; i++ )
+            {
+                codeLengths[order[i]] = std::uint8_t( GetBits( 3 ) );
+            }
+            Huffman codeLength;
+            if( !BuildHuffman( codeLength,codeLengths,19 ) )
+            {
+                throw IMAGE_EXCEPT( "Bad code length table" );
+            }
+            std::uint8_t lengths[286 + 32];
+            const int total = nLiteral + nDistance;
+            for( int n = 0; n < total; )
+            {
+                const int c = Decode( codeLength );
+                if( c < 16 )
+                {
+                    lengths[n++] = std::uint8_t( c );
+                    continue;
+                }
+                std::uint8_t fill = 0u;
+                int repeat;
+                if( c == 16 )
+                {
+                    if( n == 0 )
+                    {
+                        throw IMAGE_EXCEPT( "Bad code length repeat" );
+                    }
+                    fill = lengths[n - 1];
+                    repeat = int( GetBits( 2 ) ) + 3;
+                }
+                else if( c == 17 )
+                {
+                    repeat = int( GetBits( 3 ) ) + 3;
+                }
+                else if( c == 18 )
+                {
+                    repeat = int( GetBits( 7 ) ) + 11;
+                }
+                else
+                {
+                    throw IMAGE_EXCEPT( "Bad code length symbol" );
+                }
+                if( total - n < repeat )
+                {
+                    throw IMAGE_EXCEPT( "Bad code length repeat" );
+                }
+                std::memset( lengths + n,fill,std::size_t( repeat ) );
+                n += repeat;
+            }
+            if( !BuildHuffman( literal,lengths,nLiteral ) || !BuildHuffman( distance,lengths + nLiteral,nDistance ) )
+            {
+                throw IMAGE_EXCEPT( "Bad Huffman table" );
+            }
+        }
+        void Block( const Huffman& literal,const Huffman& distance )
+        {
+            while( true )
+            {
+                int z = Decode( literal );
+                if( z < 256 )
+                {
+                    if( pOut == pOutEnd )
+                    {
+                        throw IMAGE_EXCEPT( "Decompressed data is larger than expected" );
+                    }
+                    *pOut++ = std::uint8_t( z );
+                    continue;
+                }
+                if( z == 256 )
+                {
+                    return;
+                }
+                z -= 257;
+                if( z >= 29 )
+                {
+                    throw IMAGE_EXCEPT( "Bad length symbol" );
+                }
+                const std::size_t length = lengthBase[z] + GetBits( lengthExtra[z] );
+                z = Decode( distance );
+                if( z >= 30 )
+                {
+                    throw IMAGE_EXCEPT( "Bad distance symbol" );
+                }
+                const std::size_t dist = distanceBase[z] + GetBits( distanceExtra[z] );
+                if( std::size_t( pOut - pOutBegin ) < dist )
+                {
+                    throw IMAGE_EXCEPT( "Distance points before the start of the data" );
+                }
+                if( std::size_t( pOutEnd - pOut ) < length )
+                {
+                    throw IMAGE_EXCEPT( "Decompressed data is larger than expected" );
+                }
+                const auto pSrc = pOut - dist;
+                if( dist == 1u )
+                {
+                    std::memset( pOut,*pSrc,length );
+                }
+                else if( dist >= length )
+                {
+                    std::memcpy( pOut,pSrc,length );
+                }
+                else
+                {
+                    // 源和目标重叠，必须逐字节拷
+                    for( std::size_t i = 0u; i < length; i++ )
+                    {
+                        pOut[i] = pSrc[i];
+                    }
+                }
+                pOut += length;
+            }
+        }
+    private:
+        const std::uint8_t* pIn;
+        const std::uint8_t* pInEnd;
+        std::uint8_t* pOutBegin;
+        std::uint8_t* pOut;
+        std::uint8_t* pOutEnd;
+        std::uint64_t bits = 0u;
+        int nBits = 0;
+        // zero bytes fed past the end of the input
+        int overrun = 0;
+        const std::string& name;
+    };
+
+    // ---------------------------------------------------------------- png
+    int Paeth( int a,int b,int c ) noexcept
+    {
+        const int p = a + b - c;
+        const int pa = std::abs( p - a );
+        const int pb = std::abs( p - b );
+        const int pc = std::abs( p - c );
+        if( pa <= pb && pa <= pc )
+        {
+            return a;
+        }
+        return pb <= pc ? b : c;
+    }
+
+    // ---------------------------------------------------------------- tga
+    // src 是 BGR / BGRA / 灰度
+    void TgaPixel( std::uint8_t* dst,const std::uint8_t* src,std::uint32_t bytesPerPixel ) noexcept
+    {
+        if( bytesPerPixel == 1u )
+        {
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = 255u;
+            return;
+        }
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+        dst[3] = bytesPerPixel == 4u ? src[3] : 255u;
+    }
+
+    bool EndsWith( const std::string& s,const char* suffix ) noexcept
+    {
+        const auto n = std::strlen( suffix );
+        if( s.size() < n )
+        {
+            return false;
+        }
+        for( std::size_t i = 0u; i < n; i++ )
+        {
+            if( std::tolower( static_cast<unsigned char>( s[s.size() - n + i] ) ) != suffix[i] )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+std::size_t ImageCodecs::Inflate( const std::byte* pData,std::size_t size,std::byte* pOut,std::size_t outSize,const std::string& name )
+{
+    return Inflater( pData,size,pOut,outSize,name ).Run();
+}
+
+Image ImageCodecs::DecodePng( const std::byte* pData,std::size_t size,const std::string& name,bool srgb )
+{
+    static constexpr std::uint8_t signature[8] = { 0x89,'P','N','G','\r','\n',0x1A,'\n' };
+    const auto p = reinterpret_cast<const std::uint8_t*>( pData );
+    if( size < 8u + 25u || std::memcmp( p,signature,8u ) != 0 )
+    {
+        throw IMAGE_EXCEPT( "Not a PNG file" );
+    }
+    std::uint32_t width = 0u;
+    std::uint32_t height = 0u;
+    std::uint32_t depth = 0u;
+    std::uint32_t colorType = 0u;
+    std::uint8_t palette[256][4] = {};
+    std::uint32_t paletteSize = 0u;
+    // tRNS 对灰度 / RGB 给出一个透明色（按原始采样值比较）
+    bool hasColorKey = false;
+    std::uint16_t colorKey[3] = {};
+    // IDAT 通常有好几块，拼起来才是完整的 zlib 流；只有一块时直接用原数据
+    std::vector<std::pair<const std::uint8_t*, std::uint32_t>> idats;
+    std::size_t idatSize = 0u;
+    bool seenHeader = false;
+    // CRC 不校验
+    for( std::size_t pos = 8u; ; )
+    {
+        if( size - pos < 12u )
+        {
+            throw IMAGE_EXCEPT( "PNG is truncated (no IEND)" );
+        }
+        const auto length = ReadBE32( p + pos );
+        const auto type = p + pos + 4u;
+        const auto chunk = p + pos + 8u;
+        if( size - pos - 12u < length )
+        {
+            throw IMAGE_EXCEPT( "PNG chunk runs past the end of the file" );
+        }
+        pos += 12u + length;
+        if( std::memcmp( type,"IHDR",4u ) == 0 )
+        {
+            if( length != 13u )
+            {
+                throw IMAGE_EXCEPT( "Bad IHDR" );
+            }
+            width = ReadBE32( chunk );
+            height = ReadBE32( chunk + 4u );
+            depth = chunk[8];
+            colorType = chunk[9];
+            if( chunk[10] != 0u || chunk[11] != 0u )
+            {
+                throw IMAGE_EXCEPT( "Unknown PNG compression or filter method" );
+            }
+            if( chunk[12] != 0u )
+            {
+                throw IMAGE_EXCEPT( "Interlaced (Adam7) PNG is not supported" );
+            }
+            seenHeader = true;
+        }
+        else if( !seenHeader )
+        {
+            throw IMAGE_EXCEPT( "PNG does not start with IHDR" );
+        }
+        else if( std::memcmp( type,"PLTE",4u ) == 0 )
+        {
+            paletteSize = length / 3u;
+            if( paletteSize > 256u || paletteSize * 3u != length )
+            {
+                throw IMAGE_EXCEPT( "Bad PLTE" );
+            }
+            for( std::uint32_t i = 0u; i < paletteSize; i++ )
+            {
+                palette[i][0] = chunk[i * 3u];
+                palette[i][1] = chunk[i * 3u + 1u];
+                palette[i][2] = chunk[i * 3u + 2u];
+                palette[i][3] = 255u;
+            }
+        }
+        else if( std::memcmp( type,"tRNS",4u ) == 0 )
+        {
+            if( colorType == 3u )
+            {
+                for( std::uint32_t i = 0u; i < length && i < 256u; i++ )
+                {
+                    palette[i][3] = chunk[i];
+                }
+            }
+            else if( ( colorType == 0u && length == 2u ) || ( colorType == 2u && length == 6u ) )
+            {
+                hasColorKey = true;
+                for( std::uint32_t i = 0u; i < length / 2u; i++ )
+                {
+                    colorKey[i] = std::uint16_t( ( chunk[i * 2u] << 8 ) | chunk[i * 2u + 1u] );
+                }
+            }
+        }
+        else if( std::memcmp( type,"IDAT",4u ) == 0 )
+        {
+            idats.emplace_back( chunk,length );
+            idatSize += length;
+        }
+        else if( std::memcmp( type,"IEND",4u ) == 0 )
+        {
+            break;
+        }
+        else if( ( type[0] & 0x20u ) == 0u )
+        {
+            // 首字母大写的是关键块，不认识就不能正确解码
+            throw IMAGE_EXCEPT( "Unknown critical PNG chunk" );
+        }
+    }
+
+    std::uint32_t channels;
+    switch( colorType )
+    {
+    case 0u: channels = 1u; break;
+    case 2u: channels = 3u; break;
+    case 3u: channels = 1u; break;
+    case 4u: channels = 2u; break;
+    case 6u: channels = 4u; break;
+    default: throw IMAGE_EXCEPT( "Bad PNG color type" );
+    }
+    const bool depthValid = depth == 8u || ( depth == 16u && colorType != 3u ) ||
+        ( ( depth == 1u || depth == 2u || depth == 4u ) && ( colorType == 0u || colorType == 3u ) );
+    if( !depthValid )
+    {
+        throw IMAGE_EXCEPT( "Bad PNG bit depth for its color type" );
+    }
+    if( width == 0u || height == 0u || width > maxDimension || height > maxDimension )
+    {
+        throw IMAGE_EXCEPT( "PNG size is zero or larger than a D3D11 texture allows" );
+    }
+    if( colorType == 3u && paletteSize == 0u )
+    {
+        throw IMAGE_EXCEPT( "Palette PNG without PLTE" );
+    }
+    if( idats.empty() )
+    {
+        throw IMAGE_EXCEPT( "PNG has no image data" );
+    }
+
+    const std::size_t bitsPerPixel = std::size_t( channels ) * depth;
+    const std::size_t rowBytes = ( std::size_t( width ) * bitsPerPixel + 7u ) / 8u;
+    // 过滤器里“左边的像素”相隔的字节数，不足一字节按一字节
+    const std::size_t bpp = std::max<std::size_t>( bitsPerPixel / 8u,1u );
+    const std::size_t rawSize = ( rowBytes + 1u ) * height;
+    std::unique_ptr<std::byte[]> raw( new std::byte[rawSize] );
+    std::size_t inflated;
+    if( idats.size() == 1u )
+    {
+        inflated = Inflate( reinterpret_cast<const std::byte*>( idats[0].first ),idats[0].second,raw.get(),rawSize,name );
+    }
+    else
+    {
+        std::unique_ptr<std::byte[]> stream( new std::byte[idatSize] );
+        std::size_t offset = 0u;
+        for( const auto& d : idats )
+        {
+            std::memcpy( stream.get() + offset,d.first,d.second );
+            offset += d.second;
+        }
+        inflated = Inflate( stream.get(),idatSize,raw.get(),rawSize,name );
+    }
+    if( inflated != rawSize )
+    {
+        throw IMAGE_EXCEPT( "PNG image data is truncated" );
+    }
+
+    // 原地反过滤：每行第一个字节是过滤类型，上一行已经还原过
+    const auto rows = reinterpret_cast<std::uint8_t*>( raw.get() );
+    const std::vector<std::uint8_t> zeroRow( rowBytes,0u );
+    for( std::uint32_t y = 0u; y < height; y++ )
+    {
+        const auto filter = rows[y * ( rowBytes + 1u )];
+        const auto cur = rows + y * ( rowBytes + 1u ) + 1u;
+        const auto prev = y == 0u ? zeroRow.data() : cur - ( rowBytes + 1u );
+        switch( filter )
+        {
+        case 0u:
+            break;
+        case 1u:
+            for( std::size_t i = bpp; i < rowBytes; i++ )
+            {
+                cur[i] = std::uint8_t( cur[i] + cur[i - bpp] );
+            }
+            break;
+        case 2u:
+            for( std::size_t i = 0u; i < rowBytes; i++ )
+            {
+                cur[i] = std::uint8_t( cur[i] + prev[i] );
+            }
+            break;
+        case 3u:
+            for( std::size_t i = 0u; i < bpp; i++ )
+            {
+                cur[i] = std::uint8_t( cur[i] + ( prev[i] >> 1 ) );
+            }
+            for( std::size_t i = bpp; i < rowBytes; i++ )
+            {
+                cur[i] = std::uint8_t( cur[i] + ( ( cur[i - bpp] + prev[i] ) >> 1 ) );
+            }
+            break;
+        case 4u:
+            for( std::size_t i = 0u; i < bpp; i++ )
+            {
+                cur[i] = std::uint8_t( cur[i] + prev[i] );
+            }
+            for( std::size_t i = bpp; i < rowBytes; i++ )
+            {
+                cur[i] = std::uint8_t( cur[i] + Paeth( cur[i - bpp],prev[i],prev[i - bpp] ) );
+            }
+            break;
+        default:
+            throw IMAGE_EXCEPT( "Bad PNG filter type" );
+        }
+    }
+
+    // 展开成 RGBA8
+    Image image( width,height,srgb ? ImageFormat::RGBA8Srgb : ImageFormat::RGBA8 );
+    const auto& mip = image.GetMip( 0u );
+    const auto pixels = reinterpret_cast<std::uint8_t*>( image.GetMipData( 0u ) );
+    const std::uint32_t sampleMask = ( 1u << depth ) - 1u;
+    for( std::uint32_t y = 0u; y < height; y++ )
+    {
+        const auto src = rows + y * ( rowBytes + 1u ) + 1u;
+        const auto dst = pixels + std::size_t( y ) * mip.rowPitch;
+        if( depth < 8u )
+        {
+            for( std::uint32_t x = 0u; x < width; x++ )
+            {
+                const auto bit = std::size_t( x ) * depth;
+                const auto v = ( src[bit / 8u] >> ( 8u - depth - bit % 8u ) ) & sampleMask;
+                auto d = dst + x * 4u;
+                if( colorType == 3u )
+                {
+                    if( v >= paletteSize )
+                    {
+                        throw IMAGE_EXCEPT( "PNG palette index out of range" );
+                    }
+                    std::memcpy( d,palette[v],4u );
+                }
+                else
+                {
+                    d[0] = d[1] = d[2] = std::uint8_t( v * 255u / sampleMask );
+                    d[3] = hasColorKey && v == colorKey[0] ? 0u : 255u;
+                }
+            }
+            continue;
+        }
+        // 16 位采样只保留高字节，透明色用完整的 16 位比较
+        const std::uint32_t step = depth / 8u;
+        const auto sample = [src,step]( std::size_t i ) noexcept {
+            return step == 1u ? std::uint16_t( src[i] ) : std::uint16_t( ( src[i * 2u] << 8 ) | src[i * 2u + 1u] );
+        };
+        switch( colorType )
+        {
+        case 0u:
+            for( std::uint32_t x = 0u; x < width; x++ )
+            {
+                const auto g = src[x * step];
+                dst[x * 4u] = dst[x * 4u + 1u] = dst[x * 4u + 2u] = g;
+                dst[x * 4u + 3u] = hasColorKey && sample( x ) == colorKey[0] ? 0u : 255u;
+            }
+            break;
+        case 2u:
+            for( std::uint32_t x = 0u; x < width; x++ )
+            {
+                dst[x * 4u] = src[( x * 3u ) * step];
+                dst[x * 4u + 1u] = src[( x * 3u + 1u ) * step];
+                dst[x * 4u + 2u] = src[( x * 3u + 2u ) * step];
+                dst[x * 4u + 3u] = hasColorKey && sample( x * 3u ) == colorKey[0] &&
+                    sample( x * 3u + 1u ) == colorKey[1] && sample( x * 3u + 2u ) == colorKey[2] ? 0u : 255u;
+            }
+            break;
+        case 3u:
+            for( std::uint32_t x = 0u; x < width; x++ )
+            {
+                if( src[x] >= paletteSize )
+                {
+                    throw IMAGE_EXCEPT( "PNG palette index out of range" );
+                }
+                std::memcpy( dst + x * 4u,palette[src[x]],4u );
+            }
+            break;
+        case 4u:
+            for( std::uint32_t x = 0u; x < width; x++ )
+            {
+                dst[x * 4u] = dst[x * 4u + 1u] = dst[x * 4u + 2u] = src[( x * 2u ) * step];
+                dst[x * 4u + 3u] = src[( x * 2u + 1u ) * step];
+            }
+            break;
+        default:
+            if( step == 1u )
+            {
+                std::memcpy( dst,src,std::size_t( width ) * 4u );
+            }
+            else
+            {
+                for( std::uint32_t i = 0u; i < width * 4u; i++ )
+                {
+                    dst[i] = src[i * 2u];
+                }
+            }
+            break;
+        }
+    }
+    return image;
+}
+
+Image ImageCodecs::DecodeTga( const std::byte* pData,std::size_t size,const std::string& name,bool srgb )
+{
+    const auto p = reinterpret_cast<const std::uint8_t*>( pData );
+    if( size < 18u )
+    {
+        throw IMAGE_EXCEPT( "TGA header is truncated" );
+    }
+    const std::uint32_t idLength = p[0];
+    const std::uint32_t colorMapType = p[1];
+    const std::uint32_t imageType = p[2];
+    const std::uint32_t width = ReadLE16( p + 12u );
+    const std::uint32_t height = ReadLE16( p + 14u );
+    const std::uint32_t pixelDepth = p[16];
+    const bool topDown = ( p[17] & 0x20u ) != 0u;
+    if( colorMapType != 0u )
+    {
+        throw IMAGE_EXCEPT( "Color-mapped TGA is not supported" );
+    }
+    const bool rle = imageType == 10u || imageType == 11u;
+    const bool gray = imageType == 3u || imageType == 11u;
+    if( imageType != 2u && imageType != 3u && !rle )
+    {
+        throw IMAGE_EXCEPT( "Unsupported TGA image type" );
+    }
+    if( gray ? pixelDepth != 8u : pixelDepth != 24u && pixelDepth != 32u )
+    {
+        throw IMAGE_EXCEPT( "Unsupported TGA pixel depth" );
+    }
+    if( width == 0u || height == 0u || width > maxDimension || height > maxDimension )
+    {
+        throw IMAGE_EXCEPT( "TGA size is zero or larger than a D3D11 texture allows" );
+    }
+    const std::uint32_t bytesPerPixel = pixelDepth / 8u;
+    std::size_t pos = 18u + idLength;
+
+    Image image( width,height,srgb ? ImageFormat::RGBA8Srgb : ImageFormat::RGBA8 );
+    const auto& mip = image.GetMip( 0u );
+    const auto pixels = reinterpret_cast<std::uint8_t*>( image.GetMipData( 0u ) );
+    // 默认原点在左下角
+    const auto row = [&]( std::uint32_t y ) noexcept {
+        return pixels + std::size_t( topDown ? y : height - 1u - y ) * mip.rowPitch;
+    };
+    if( !rle )
+    {
+        if( size < pos || ( size - pos ) / bytesPerPixel / width < height )
+        {
+            throw IMAGE_EXCEPT( "TGA pixel data is truncated" );
+        }
+        for( std::uint32_t y = 0u; y < height; y++ )
+        {
+            const auto dst = row( y );
+            for( std::uint32_t x = 0u; x < width; x++, pos += bytesPerPixel )
+            {
+                TgaPixel( dst + x * 4u,p + pos,bytesPerPixel );
+            }
+        }
+        return image;
+    }
+    // RLE：包头最高位为 1 是重复包（一个像素重复 n 次），否则是 n 个原样的像素；包可以跨行
+    std::uint32_t x = 0u;
+    std::uint32_t y = 0u;
+    while( y < height )
+    {
+        if( pos >= size )
+        {
+            throw IMAGE_EXCEPT( "TGA pixel data is truncated" );
+        }
+        const std::uint32_t header = p[pos++];
+        const std::uint32_t count = ( header & 0x7Fu ) + 1u;
+        const bool run = ( header & 0x80u ) != 0u;
+        const std::size_t need = std::size_t( run ? 1u : count ) * bytesPerPixel;
+        if( size - pos < need )
+        {
+            throw IMAGE_EXCEPT( "TGA pixel data is truncated" );
+        }
+        for( std::uint32_t i = 0u; i < count; i++ )
+        {
+            if( y == height )
+            {
+                throw IMAGE_EXCEPT( "TGA RLE packet runs past the image" );
+            }
+            TgaPixel( row( y ) + x * 4u,p + pos + ( run ? 0u : i * bytesPerPixel ),bytesPerPixel );
+            if( ++x == width )
+            {
+                x = 0u;
+                y++;
+            }
+        }
+        pos += need;
+    }
+    return image;
+}
+
+ImageCodecs::DdsInfo ImageCodecs::ReadDdsInfo( const std::byte* pData,std::size_t size,const std::string& name,bool srgb )
+{
+    const auto p = reinterpret_cast<const std::uint8_t*>( pData );
+    if( size < 4u + 124u || std::memcmp( p,"DDS ",4u ) != 0 )
+    {
+        throw IMAGE_EXCEPT( "Not a DDS file" );
+    }
+    const auto h = p + 4u;
+    if( ReadLE32( h ) != 124u )
+    {
+        throw IMAGE_EXCEPT( "Bad DDS header size" );
+    }
+    const auto flags = ReadLE32( h + 4u );
+    const auto height = ReadLE32( h + 8u );
+    const auto width = ReadLE32( h + 12u );
+    const auto mipMapCount = ReadLE32( h + 24u );
+    const auto pfFlags = ReadLE32( h + 76u );
+    const auto fourCC = h + 80u;
+    const auto rgbBitCount = ReadLE32( h + 84u );
+    const auto rMask = ReadLE32( h + 88u );
+    const auto gMask = ReadLE32( h + 92u );
+    const auto bMask = ReadLE32( h + 96u );
+    const auto caps2 = ReadLE32( h + 108u );
+    constexpr std::uint32_t ddsdMipMapCount = 0x20000u;
+    constexpr std::uint32_t ddpfAlphaPixels = 0x1u;
+    constexpr std::uint32_t ddpfFourCC = 0x4u;
+    constexpr std::uint32_t ddpfRgb = 0x40u;
+    constexpr std::uint32_t ddsCaps2Cubemap = 0x200u;
+    constexpr std::uint32_t ddsCaps2Volume = 0x200000u;
+    if( ( caps2 & ( ddsCaps2Cubemap | ddsCaps2Volume ) ) != 0u )
+    {
+        throw IMAGE_EXCEPT( "Only 2D DDS textures are supported" );
+    }
+    if( width == 0u || height == 0u || width > maxDimension || height > maxDimension )
+    {
+        throw IMAGE_EXCEPT( "DDS size is zero or larger than a D3D11 texture allows" );
+    }
+    std::size_t pos = 4u + 124u;
+    ImageFormat format;
+    bool swapRedBlue = false;
+    bool forceOpaque = false;
+    if( ( pfFlags & ddpfFourCC ) != 0u && std::memcmp( fourCC,"DX10",4u ) == 0 )
+    {
+        if( size < pos + 20u )
+        {
+            throw IMAGE_EXCEPT( "DDS DX10 header is truncated" );
+        }
+        const auto dxgiFormat = ReadLE32( p + pos );
+        const auto dimension = ReadLE32( p + pos + 4u );
+        const auto arraySize = ReadLE32( p + pos + 12u );
+        pos += 20u;
+        // D3D11_RESOURCE_DIMENSION_TEXTURE2D
+        if( dimension != 3u || arraySize != 1u )
+        {
+            throw IMAGE_EXCEPT( "Only single 2D DDS textures are supported" );
+        }
+        // DXGI_FORMAT 的数值，这个文件不依赖 dxgiformat.h
+        switch( dxgiFormat )
+        {
+        case 28u: format = ImageFormat::RGBA8; break;
+        case 29u: format = ImageFormat::RGBA8Srgb; break;
+        case 87u: format = ImageFormat::RGBA8; swapRedBlue = true; break;
+        case 91u: format = ImageFormat::RGBA8Srgb; swapRedBlue = true; break;
+        case 71u: format = ImageFormat::BC1; break;
+        case 72u: format = ImageFormat::BC1Srgb; break;
+        case 77u: format = ImageFormat::BC3; break;
+        case 78u: format = ImageFormat::BC3Srgb; break;
+        case 80u: format = ImageFormat::BC4; break;
+        case 83u: format = ImageFormat::BC5; break;
+        case 98u: format = ImageFormat::BC7; break;
+        case 99u: format = ImageFormat::BC7Srgb; break;
+        default: throw IMAGE_EXCEPT( "Unsupported DXGI format " + std::to_string( dxgiFormat ) );
+        }
+    }
+    else if( ( pfFlags & ddpfFourCC ) != 0u )
+    {
+        if( std::memcmp( fourCC,"DXT1",4u ) == 0 )
+        {
+            format = srgb ? ImageFormat::BC1Srgb : ImageFormat::BC1;
+        }
+        else if( std::memcmp( fourCC,"DXT4",4u ) == 0 || std::memcmp( fourCC,"DXT5",4u ) == 0 )
+        {
+            format = srgb ? ImageFormat::BC3Srgb : ImageFormat::BC3;
+        }
+        else if( std::memcmp( fourCC,"ATI1",4u ) == 0 || std::memcmp( fourCC,"BC4U",4u ) == 0 )
+        {
+            format = ImageFormat::BC4;
+        }
+        else if( std::memcmp( fourCC,"ATI2",4u ) == 0 || std::memcmp( fourCC,"BC5U",4u ) == 0 )
+        {
+            format = ImageFormat::BC5;
+        }
+        else
+        {
+            throw IMAGE_EXCEPT( "Unsupported DDS FourCC " + std::string( reinterpret_cast<const char*>( fourCC ),4u ) );
+        }
+    }
+    else if( ( pfFlags & ddpfRgb ) != 0u && rgbBitCount == 32u && gMask == 0x0000FF00u &&
+        ( ( rMask == 0x000000FFu && bMask == 0x00FF0000u ) || ( rMask == 0x00FF0000u && bMask == 0x000000FFu ) ) )
+    {
+        format = srgb ? ImageFormat::RGBA8Srgb : ImageFormat::RGBA8;
+        swapRedBlue = rMask == 0x00FF0000u;
+        forceOpaque = ( pfFlags & ddpfAlphaPixels ) == 0u;
+    }
+    else
+    {
+        throw IMAGE_EXCEPT( "Unsupported DDS pixel format" );
+    }
+
+    const auto mipCount = ( flags & ddsdMipMapCount ) != 0u && mipMapCount != 0u ? mipMapCount : 1u;
+    if( mipCount > Image::GetFullMipCount( width,height ) )
+    {
+        throw IMAGE_EXCEPT( "DDS has more mip levels than its size allows" );
+    }
+    std::size_t dataSize = 0u;
+    for( std::uint32_t level = 0u; level < mipCount; level++ )
+    {
+        dataSize += Image::GetLevelSize( width,height,format,level );
+    }
+    if( size - pos < dataSize )
+    {
+        throw IMAGE_EXCEPT( "DDS pixel data is truncated" );
+    }
+    return { width,height,mipCount,format,pos,swapRedBlue,forceOpaque };
+}
+
+Image ImageCodecs::DecodeDds( const std::byte* pData,std::size_t size,const std::string& name,bool srgb )
+{
+    const auto info = ReadDdsInfo( pData,size,name,srgb );
+    const auto p = reinterpret_cast<const std::uint8_t*>( pData );
+    auto pos = info.dataOffset;
+    Image image( info.width,info.height,info.format,info.mipCount );
+    // DDS 里每层也是紧密排列的，和 Image 的行布局一样，逐层拷贝
+    for( std::uint32_t level = 0u; level < info.mipCount; level++ )
+    {
+        const auto& mip = image.GetMip( level );
+        const auto dst = reinterpret_cast<std::uint8_t*>( image.GetMipData( level ) );
+        std::memcpy( dst,p + pos,mip.size );
+        pos += mip.size;
+        if( info.swapRedBlue || info.forceOpaque )
+        {
+            for( std::size_t i = 0u; i < mip.size; i += 4u )
+            {
+                if( info.swapRedBlue )
+                {
+                    std::swap( dst[i],dst[i + 2u] );
+                }
+                if( info.forceOpaque )
+                {
+                    dst[i + 3u] = 255u;
+                }
+            }
+        }
+    }
+    return image;
+}
+
+std::vector<std::byte> ImageCodecs::EncodeDds( const Image& image )
+{
+    std::uint32_t dxgiFormat = 0u;
+    switch( image.GetFormat() )
+    {
+    case ImageFormat::RGBA8: dxgiFormat = 28u; break;
+    case ImageFormat::RGBA8Srgb: dxgiFormat = 29u; break;
+    case ImageFormat::BC1: dxgiFormat = 71u; break;
+    case ImageFormat::BC1Srgb: dxgiFormat = 72u; break;
+    case ImageFormat::BC3: dxgiFormat = 77u; break;
+    case ImageFormat::BC3Srgb: dxgiFormat = 78u; break;
+    case ImageFormat::BC4: dxgiFormat = 80u; break;
+    case ImageFormat::BC5: dxgiFormat = 83u; break;
+    case ImageFormat::BC7: dxgiFormat = 98u; break;
+    case ImageFormat::BC7Srgb: dxgiFormat = 99u; break;
+    }
+    const auto mipCount = image.GetMipCount();
+    std::size_t size = 4u + 124u + 20u;
+    for( std::uint32_t level = 0u; level < mipCount; level++ )
+    {
+        size += image.GetMip( level ).size;
+    }
+    std::vector<std::byte> file( size );
+    const auto p = reinterpret_cast<std::uint8_t*>( file.data() );
+    std::memcpy( p,"DDS ",4u );
+    const auto h = p + 4u;
+    const auto compressed = Image::IsCompressed( image.GetFormat() );
+    // CAPS | HEIGHT | WIDTH | PIXELFORMAT | MIPMAPCOUNT，再加 LINEARSIZE 或 PITCH
+    WriteLE32( h,124u );
+    WriteLE32( h + 4u,0x1u | 0x2u | 0x4u | 0x1000u | 0x20000u | ( compressed ? 0x80000u : 0x8u ) );
+    WriteLE32( h + 8u,image.GetHeight() );
+    WriteLE32( h + 12u,image.GetWidth() );
+    WriteLE32( h + 16u,compressed ? std::uint32_t( image.GetMip( 0u ).size ) : image.GetMip( 0u ).rowPitch );
+    WriteLE32( h + 24u,mipCount );
+    WriteLE32( h + 72u,32u );
+    WriteLE32( h + 76u,0x4u );
+    std::memcpy( h + 80u,"DX10",4u );
+    // TEXTURE，有 mip 时再加 COMPLEX | MIPMAP
+    WriteLE32( h + 104u,0x1000u | ( mipCount > 1u ? 0x400008u : 0u ) );
+    auto pos = p + 4u + 124u;
+    WriteLE32( pos,dxgiFormat );
+    // D3D11_RESOURCE_DIMENSION_TEXTURE2D，数组大小 1
+    WriteLE32( pos + 4u,3u );
+    WriteLE32( pos + 12u,1u );
+    pos += 20u;
+    for( std::uint32_t level = 0u; level < mipCount; level++ )
+    {
+        const auto& mip = image.GetMip( level );
+        std::memcpy( pos,image.GetMipData( level ),mip.size );
+        pos += mip.size;
+    }
+    return file;
+}
+
+Image ImageCodecs::Decode( const std::byte* pData,std::size_t size,const std::string& name,bool srgb )
+{
+    const auto p = reinterpret_cast<const std::uint8_t*>( pData );
+    if( size >= 8u && p[0] == 0x89u && std::memcmp( p + 1u,"PNG",3u ) == 0 )
+    {
+        return DecodePng( pData,size,name,srgb );
+    }
+    if( size >= 4u && std::memcmp( p,"DDS ",4u ) == 0 )
+    {
+        return DecodeDds( pData,size,name,srgb );
+    }
+    // TGA 没有魔数，只能看扩展名
+    if( EndsWith( name,".tga" ) )
+    {
+        return DecodeTga( pData,size,name,srgb );
+    }
+    throw IMAGE_EXCEPT( "Unknown image format (expected PNG, DDS or .tga)" );
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "Image.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 自己实现的图像解码器，不依赖 WIC / 第三方库。全部是纯函数，可以在任意线程上并行调用。
+// 出错时抛 ImageException，name 只用来填进异常里。
+namespace ImageCodecs
+{
+    // 8/16 位灰度、灰度+alpha、RGB、RGBA，以及 1/2/4/8 位调色板和灰度；不支持 Adam7 隔行扫描。
+    // 输出 RGBA8（srgb 为 true 时是 RGBA8Srgb）
+    Image DecodePng( const std::byte* pData,std::size_t size,const std::string& name,bool srgb );
+    // 无压缩和 RLE 的真彩色 / 灰度（8/24/32 位），不支持调色板
+    Image DecodeTga( const std::byte* pData,std::size_t size,const std::string& name,bool srgb );
+    struct DdsInfo
+    {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t mipCount;
+        ImageFormat format;
+        // 第 0 层在文件里的偏移，之后各层紧挨着排列，大小是 Image::GetLevelSize
+        std::size_t dataOffset;
+        // BGRA 要交换 R 和 B；没有 alpha 的 RGB 要把 alpha 填成 255
+        bool swapRedBlue;
+        bool forceOpaque;
+    };
+    // 只解析 DDS 头并检查数据长度，不拷贝像素；参数和 DecodeDds 一样。
+    // 最多读前 148 字节，所以 pData 可以只是文件开头，size 传整个文件的大小（纹理流送就这样按层读文件）
+    DdsInfo ReadDdsInfo( const std::byte* pData,std::size_t size,const std::string& name,bool srgb );
+    // 2D 纹理：RGBA8 / BGRA8、BC1/3/4/5/7（DX10 扩展头或传统 FourCC），保留文件里已有的 mip 链。
+    // 传统头没有色彩空间信息，srgb 决定 RGBA8 / BC1 / BC3 是否当作 sRGB
+    Image DecodeDds( const std::byte* pData,std::size_t size,const std::string& name,bool srgb );
+    // 写成带 DX10 扩展头的 DDS（包括所有 mip 层），DecodeDds 能原样读回来
+    std::vector<std::byte> EncodeDds( const Image& image );
+    // 按文件头的魔数选择上面的解码器
+    Image Decode( const std::byte* pData,std::size_t size,const std::string& name,bool srgb );
+    // zlib 流（RFC 1950/1951）解压到 pOut，返回写入的字节数；数据超过 outSize 视为损坏。不校验 Adler-32
+    std::size_t Inflate( const std::byte* pData,std::size_t size,std::byte* pOut,std::size_t outSize,const std::string& name );
+}
@@ -0,0 +1,167 @@
+#include "ImageLoader.h"
+#include "ImageCodecs.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace
+{
+    // 编码器的输出变了就加一，让旧的缓存全部失效
+    constexpr std::uint64_t cacheVersion = 1u;
+
+    // 每次吃 8 字节的 64 位哈希，只用来区分缓存文件，不需要抗碰撞
+    std::uint64_t Hash( const std::byte* pData,std::size_t size,std::uint64_t seed ) noexcept
+    {
+        constexpr std::uint64_t k0 = 0x9E3779B97F4A7C15ull;
+        constexpr std::uint64_t k1 = 0xC2B2AE3D27D4EB4Full;
+        auto h = seed ^ ( size * k0 );
+        std::size_t i = 0u;
+        for( ; i + 8u <= size; i += 8u )
+        {
+            std::uint64_t w;
+            std::memcpy( &w,pData + i,8u );
+            h ^= w * k0;
+            h = ( ( h << 31 ) | ( h >> 33 ) ) * k1;
+        }
+        std::uint64_t tail = 0u;
+        std::memcpy( &tail,pData + i,size - i );
+        h ^= tail * k0;
+        // murmur3 的收尾混合
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    std::filesystem::path GetCachePath( const ImageLoader::Source& source,const ImageLoadOptions& options )
+    {
+        const std::uint8_t settings[] = {
+            std::uint8_t( options.srgb ),
+            std::uint8_t( options.generateMips ),
+            std::uint8_t( options.mipFilter ),
+            std::uint8_t( options.compression ),
+            std::uint8_t( options.compressionQuality ),
+        };
+        const auto key = Hash( reinterpret_cast<const std::byte*>( settings ),sizeof( settings ),
+            Hash( source.pData,source.size,cacheVersion ) );
+        char fileName[32];
+        std::snprintf( fileName,sizeof( fileName ),"%016llx.dds",static_cast<unsigned long long>( key ) );
+        return std::filesystem::path( options.cacheDirectory ) / fileName;
+    }
+
+    bool ReadCache( const std::filesystem::path& path,const std::string& name,Image& image )
+    {
+        std::ifstream file( path,std::ios::binary | std::ios::ate );
+        if( !file )
+        {
+            return false;
+        }
+        std::vector<std::byte> data( std::size_t( file.tellg() ) );
+        file.seekg( 0 );
+        if( !file.read( reinterpret_cast<char*>( data.data() ),std::streamsize( data.size() ) ) )
+        {
+            return false;
+        }
+        // 写了一半或者被别的东西改坏的缓存，重新生成一份覆盖掉
+        try
+        {
+            image = ImageCodecs::DecodeDds( data.data(),data.size(),name,false );
+            return true;
+        }
+        catch( const ImageException& )
+        {
+            return false;
+        }
+    }
+
+    // 先写临时文件再改名，几个线程同时写同一个缓存时读的一方不会看到半个文件
+    void WriteCache( const std::filesystem::path& path,const Image& image )
+    {
+        std::error_code ec;
+        std::filesystem::create_directories( path.parent_path(),ec );
+        const auto data = ImageCodecs::EncodeDds( image );
+        auto temp = path;
+        temp += ".tmp" + std::to_string( std::hash<std::thread::id>{}( std::this_thread::get_id() ) );
+        bool written;
+        {
+            std::ofstream file( temp,std::ios::binary | std::ios::trunc );
+            written = bool( file.write( reinterpret_cast<const char*>( data.data() ),std::streamsize( data.size() ) ) );
+        }
+        if( written )
+        {
+            std::filesystem::rename( temp,path,ec );
+        }
+        if( !written || ec )
+        {
+            std::filesystem::remove( temp,ec );
+        }
+    }
+
+    Image Process( const ImageLoader::Source& source,const ImageLoadOptions& options )
+    {
+        auto image = ImageCodecs::Decode( source.pData,source.size,source.name,options.srgb );
+        if( options.generateMips && image.GetMipCount() == 1u && !Image::IsCompressed( image.GetFormat() ) )
+        {
+            MipChain::Generate( image,options.mipFilter );
+        }
+        if( options.compression != TextureCompression::None && !Image::IsCompressed( image.GetFormat() ) &&
+            image.GetWidth() % 4u == 0u && image.GetHeight() % 4u == 0u )
+        {
+            image = BlockCompression::Encode( image,options.compression,options.compressionQuality );
+        }
+        return image;
+    }
+}
+
+Image ImageLoader::LoadFromMemory( const Source& source,const ImageLoadOptions& options )
+{
+    // 只缓存压缩的结果：不压缩时解码 + 生成 mip 并不比读一个大得多的 DDS 慢多少
+    if( options.compression == TextureCompression::None || options.cacheDirectory.empty() )
+    {
+        return Process( source,options );
+    }
+    const auto path = GetCachePath( source,options );
+    Image image;
+    if( ReadCache( path,source.name,image ) )
+    {
+        return image;
+    }
+    image = Process( source,options );
+    WriteCache( path,image );
+    return image;
+}
+
+std::vector<Image> ImageLoader::LoadMany( ThreadPool& pool,const std::vector<Source>& sources,const ImageLoadOptions& options )
+{
+    std::vector<Image> images( sources.size() );
+    // ThreadPool 的任务不能抛异常，先各自接住
+    std::vector<std::exception_ptr> errors( sources.size() );
+    pool.ParallelFor( sources.size(),1u,[&]( std::size_t begin,std::size_t end ) {
+        for( auto i = begin; i < end; i++ )
+        {
+            try
+            {
+                images[i] = LoadFromMemory( sources[i],options );
+            }
+            catch( ... )
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    } );
+    for( const auto& e : errors )
+    {
+        if( e )
+        {
+            std::rethrow_exception( e );
+        }
+    }
+    return images;
+}
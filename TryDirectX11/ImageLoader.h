@@ -0,0 +1,40 @@
+#pragma once
+#include "BlockCompression.h"
+#include "Image.h"
+#include "MipChain.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+struct ImageLoadOptions
+{
+    // 颜色贴图是 sRGB，法线 / 粗糙度等数据贴图应该关掉
+    bool srgb = true;
+    // 文件里没有 mip 链时生成（块压缩的 DDS 除外）
+    bool generateMips = true;
+    MipFilter mipFilter = MipFilter::Box;
+    // 生成 mip 之后压缩。第 0 层边长不是 4 的倍数的图保持 RGBA8（D3D11 要求 BC 纹理按整块对齐）
+    TextureCompression compression = TextureCompression::None;
+    BcQuality compressionQuality = BcQuality::Normal;
+    // 非空时压缩结果以 DDS 文件缓存在这个目录下，文件名是源文件内容和上面各选项的 hash；目录不存在会自动创建
+    std::string cacheDirectory;
+};
+
+// 解码 + 生成 mip，纯 CPU，不碰 D3D；Texture 和 Tools/TextureBench 共用
+namespace ImageLoader
+{
+    struct Source
+    {
+        // used for format detection (.tga) and error messages
+        std::string name;
+        const std::byte* pData;
+        std::size_t size;
+    };
+    // 压缩也在当前线程完成（LoadMany 已经按文件并行了）；缓存文件读写失败时当作没有缓存
+    Image LoadFromMemory( const Source& source,const ImageLoadOptions& options );
+    // 每个源一个任务，在线程池上并行解码；结果和 sources 一一对应。
+    // 任何一个失败时等全部结束后重新抛出第一个失败的异常
+    std::vector<Image> LoadMany( ThreadPool& pool,const std::vector<Source>& sources,const ImageLoadOptions& options );
+}
@@ -1,22 +1,46 @@
 #include "IndexBuffer.h"
+#include "BindStream.h"
 #include "GraphicsThrowMacros.h"
+#include "PerfCounters.h"
 
 // create index buffer 索引默认情况下为 16 位
 IndexBuffer::IndexBuffer(Graphics &gfx, const std::vector<unsigned short> &indices)
         :
-        count((UINT) indices.size()) {
+        count((UINT) indices.size()),
+        format(DXGI_FORMAT_R16_UINT) {
+    Create(gfx, indices.data(), sizeof(unsigned short));
+}
+
+IndexBuffer::IndexBuffer(Graphics &gfx, const std::vector<std::uint32_t> &indices)
+        :
+        count((UINT) indices.size()),
+        format(DXGI_FORMAT_R32_UINT) {
+    Create(gfx, indices.data(), sizeof(std::uint32_t));
+}
+
+IndexBuffer::IndexBuffer(Graphics &gfx, const void *pIndices, UINT count, DXGI_FORMAT format)
+        :
+        count(count),
+        format(format) {
+    Create(gfx, pIndices, format == DXGI_FORMAT_R16_UINT ? 2u : 4u);
+}
+
+void IndexBuffer::Create(Graphics &gfx, const void *pIndices, UINT indexSize) {
     INFOMAN(gfx);
     // D3D11_BUFFER_DESC 参数介绍看上面
     D3D11_BUFFER_DESC ibd = {};
     ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
     ibd.CPUAccessFlags = 0u;
     ibd.MiscFlags = 0u;
-    ibd.ByteWidth = UINT(count * sizeof(unsigned short));
+    ibd.ByteWidth = count * indexSize;
     ibd.Usage = D3D11_USAGE_DEFAULT;
-    ibd.StructureByteStride = sizeof(unsigned short);
+    ibd.StructureByteStride = indexSize;
     D3D11_SUBRESOURCE_DATA isd = {};
-    isd.pSysMem = indices.data();
+    isd.pSysMem = pIndices;
     GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&ibd, &isd, &pIndexBuffer));
+    PerfCounters::Add(PerfCounter::BuffersCreated);
+    PerfCounters::Add(PerfCounter::BufferBytesCreated, ibd.ByteWidth);
+    gpuMemory.Track(GpuMemoryKind::Buffer, ibd.ByteWidth);
 }
 
 void IndexBuffer::Bind(Graphics &gfx) noexcept {
@@ -26,9 +50,13 @@ void IndexBuffer::Bind(Graphics &gfx) noexcept {
     // 否则会出现问题。索引缓冲区只支持 DXGI_FORMAT_R16_UINT 和 DXGI_FORMAT_R32_UINT 两种格式。
     // 第 3 个参数是一个偏移值，它表示从索引缓冲区的起始位置开始、到输入装配时实际读取数据的位置之间的字节长度。
     // 如果希望跳过索引缓冲区前面的一部分数据，那么可以使用该参数。
-    GetContext(gfx)->IASetIndexBuffer(pIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0u);
+    GetContext(gfx)->IASetIndexBuffer(pIndexBuffer.Get(), format, 0u);
 }
 
 UINT IndexBuffer::GetCount() const noexcept {
     return count;
-}
\ No newline at end of file
+}
+
+void IndexBuffer::Record(BindStream &stream) const {
+    stream.PushIndexBuffer(pIndexBuffer.Get(), format);
+}
@@ -1,16 +1,30 @@
 #pragma once
 
 #include "Bindable.h"
+#include <cstdint>
 
 class IndexBuffer : public Bindable {
 public:
     IndexBuffer(Graphics &gfx, const std::vector<unsigned short> &indices);
 
+    // 32 位索引，超过 65535 个顶点的模型用
+    IndexBuffer(Graphics &gfx, const std::vector<std::uint32_t> &indices);
+
+    // 直接从内存里的索引创建（例如映射进来的 .glb），format 是 DXGI_FORMAT_R16_UINT 或 DXGI_FORMAT_R32_UINT
+    IndexBuffer(Graphics &gfx, const void *pIndices, UINT count, DXGI_FORMAT format);
+
     void Bind(Graphics &gfx) noexcept override;
 
+    void Record(BindStream& stream) const override;
+
     UINT GetCount() const noexcept;
 
+protected:
+    void Create(Graphics &gfx, const void *pIndices, UINT indexSize);
+
 protected:
     UINT count;
+    DXGI_FORMAT format;
     Microsoft::WRL::ComPtr<ID3D11Buffer> pIndexBuffer;
+    GpuAllocation gpuMemory;
 };
\ No newline at end of file
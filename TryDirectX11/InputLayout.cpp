@@ -1,4 +1,5 @@
 #include "InputLayout.h"
+#include "BindStream.h"
 #include "GraphicsThrowMacros.h"
 
 InputLayout::InputLayout( Graphics& gfx,
@@ -19,4 +20,9 @@ InputLayout::InputLayout( Graphics& gfx,
 void InputLayout::Bind( Graphics& gfx ) noexcept
 {
     GetContext( gfx )->IASetInputLayout( pInputLayout.Get() );
-}
\ No newline at end of file
+}
+
+void InputLayout::Record( BindStream& stream ) const
+{
+    stream.PushInputLayout( pInputLayout.Get() );
+}
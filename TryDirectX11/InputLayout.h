@@ -8,6 +8,7 @@ public:
                  const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout,
                  ID3DBlob* pVertexShaderBytecode );
     void Bind( Graphics& gfx ) noexcept override;
+    void Record(BindStream& stream) const override;
 protected:
     Microsoft::WRL::ComPtr<ID3D11InputLayout> pInputLayout;
 };
\ No newline at end of file
@@ -0,0 +1,439 @@
+#include "Json.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+class JsonValue::Parser
+{
+public:
+    Parser( const char* pText,std::size_t size ) noexcept
+        :
+        begin( pText ),
+        p( pText ),
+        end( pText + size )
+    {}
+    bool ParseDocument( JsonValue& root )
+    {
+        if( !ParseValue( root,0u ) )
+        {
+            return false;
+        }
+        SkipSpace();
+        return p == end || Fail( "trailing characters after the document" );
+    }
+    const std::string& GetError() const noexcept
+    {
+        return error;
+    }
+private:
+    static constexpr unsigned int maxDepth = 256u;
+    bool Fail( const char* what )
+    {
+        if( error.empty() )
+        {
+            error = std::string( what ) + " at byte " + std::to_string( p - begin );
+        }
+        return false;
+    }
+    void SkipSpace() noexcept
+    {
+        while( p < end && ( *p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' ) )
+        {
+            p++;
+        }
+    }
+    bool Literal( const char* word )
+    {
+        const auto length = std::strlen( word );
+        if( std::size_t( end - p ) < length || std::memcmp( p,word,length ) != 0 )
+        {
+            return Fail( "invalid literal" );
+        }
+        p += length;
+        return true;
+    }
+    bool ParseValue( JsonValue& value,unsigned int depth )
+    {
+        SkipSpace();
+        if( p == end )
+        {
+            return Fail( "unexpected end of input" );
+        }
+        switch( *p )
+        {
+        case '{':
+            value.type = Type::Object;
+            return ParseObject( value,depth + 1u );
+        case '[':
+            value.type = Type::Array;
+            return ParseArray( value,depth + 1u );
+        case '"':
+            value.type = Type::String;
+            return ParseString( value.string );
+        case 't':
+            value.type = Type::Bool;
+            value.boolean = true;
+            return Literal( "true" );
+        case 'f':
+            value.type = Type::Bool;
+            value.boolean = false;
+            return Literal( "false" );
+        case 'n':
+            value.type = Type::Null;
+            return Literal( "null" );
+        default:
+            value.type = Type::Number;
+            return ParseNumber( value.number );
+        }
+    }
+    bool ParseObject( JsonValue& value,unsigned int depth )
+    {
+        if( depth > maxDepth )
+        {
+            return Fail( "nesting too deep" );
+        }
+        p++;
+        SkipSpace();
+        if( p < end && *p == '}' )
+        {
+            p++;
+            return true;
+        }
+        while( true )
+        {
+            SkipSpace();
+            if( p == end || *p != '"' )
+            {
+                return Fail( "expected a member name" );
+            }
+            value.keys.emplace_back();
+            if( !ParseString( value.keys.back() ) )
+            {
+                return false;
+            }
+            SkipSpace();
+            if( p == end || *p != ':' )
+            {
+                return Fail( "expected ':'" );
+            }
+            p++;
+            value.elements.emplace_back();
+            if( !ParseValue( value.elements.back(),depth ) )
+            {
+                return false;
+            }
+            SkipSpace();
+            if( p < end && *p == ',' )
+            {
+                p++;
+                continue;
+            }
+            if( p < end && *p == '}' )
+            {
+                p++;
+                return true;
+            }
+            return Fail( "expected ',' or '}'" );
+        }
+    }
+    bool ParseArray( JsonValue& value,unsigned int depth )
+    {
+        if( depth > maxDepth )
+        {
+            return Fail( "nesting too deep" );
+        }
+        p++;
+        SkipSpace();
+        if( p < end && *p == ']' )
+        {
+            p++;
+            return true;
+        }
+        while( true )
+        {
+            value.elements.emplace_back();
+            if( !ParseValue( value.elements.back(),depth ) )
+            {
+                return false;
+            }
+            SkipSpace();
+            if( p < end && *p == ',' )
+            {
+                p++;
+                continue;
+            }
+            if( p < end && *p == ']' )
+            {
+                p++;
+                return true;
+            }
+            return Fail( "expected ',' or ']'" );
+        }
+    }
+    bool ParseHex4( unsigned int& code )
+    {
+        if( end - p < 4 )
+        {
+            return Fail( "truncated \\u escape" );
+        }
+        code = 0u;
+        for( int i = 0; i < 4; i++ )
+        {
+            const char c = *p++;
+            code <<= 4u;
+            if( c >= '0' && c <= '9' )
+            {
+                code |= unsigned( c - '0' );
+            }
+            else if( c >= 'a' && c <= 'f' )
+            {
+                code |= unsigned( c - 'a' + 10 );
+            }
+            else if( c >= 'A' && c <= 'F' )
+            {
+                code |= unsigned( c - 'A' + 10 );
+            }
+            else
+            {
+                return Fail( "invalid \\u escape" );
+            }
+        }
+        return true;
+    }
+    static void AppendUtf8( std::string& out,unsigned int code )
+    {
+        if( code < 0x80u )
+        {
+            out += char( code );
+        }
+        else if( code < 0x800u )
+        {
+            out += char( 0xC0u | ( code >> 6u ) );
+            out += char( 0x80u | ( code & 0x3Fu ) );
+        }
+        else if( code < 0x10000u )
+        {
+            out += char( 0xE0u | ( code >> 12u ) );
+            out += char( 0x80u | ( ( code >> 6u ) & 0x3Fu ) );
+            out += char( 0x80u | ( code & 0x3Fu ) );
+        }
+        else
+        {
+            out += char( 0xF0u | ( code >> 18u ) );
+            out += char( 0x80u | ( ( code >> 12u ) & 0x3Fu ) );
+            out += char( 0x80u | ( ( code >> 6u ) & 0x3Fu ) );
+            out += char( 0x80u | ( code & 0x3Fu ) );
+        }
+    }
+    bool ParseString( std::string& out )
+    {
+        p++;
+        while( true )
+        {
+            // 没有转义的一段整段拷贝
+            const auto run = p;
+            while( p < end && *p != '"' && *p != '\\' && static_cast<unsigned char>( *p ) >= 0x20u )
+            {
+                p++;
+            }
+            out.append( run,p );
+            if( p == end )
+            {
+                return Fail( "unterminated string" );
+            }
+            if( *p == '"' )
+            {
+                p++;
+                return true;
+            }
+            if( *p != '\\' )
+            {
+                return Fail( "control character in string" );
+            }
+            if( ++p == end )
+            {
+                return Fail( "unterminated string" );
+            }
+            const char escape = *p++;
+            switch( escape )
+            {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u':
+            {
+                unsigned int code = 0u;
+                if( !ParseHex4( code ) )
+                {
+                    return false;
+                }
+                // UTF-16 代理对
+                if( code >= 0xD800u && code < 0xDC00u )
+                {
+                    unsigned int low = 0u;
+                    if( end - p < 2 || p[0] != '\\' || p[1] != 'u' )
+                    {
+                        return Fail( "unpaired surrogate" );
+                    }
+                    p += 2;
+                    if( !ParseHex4( low ) )
+                    {
+                        return false;
+                    }
+                    if( low < 0xDC00u || low >= 0xE000u )
+                    {
+                        return Fail( "unpaired surrogate" );
+                    }
+                    code = 0x10000u + ( ( code - 0xD800u ) << 10u ) + ( low - 0xDC00u );
+                }
+                else if( code >= 0xDC00u && code < 0xE000u )
+                {
+                    return Fail( "unpaired surrogate" );
+                }
+                AppendUtf8( out,code );
+                break;
+            }
+            default:
+                return Fail( "invalid escape" );
+            }
+        }
+    }
+    bool ParseNumber( double& number )
+    {
+        // from_chars 接受的语法比 JSON 宽（前导 0、没有整数部分），这里先按 JSON 的语法检查一遍
+        auto q = p;
+        if( q < end && *q == '-' )
+        {
+            q++;
+        }
+        if( q == end || *q < '0' || *q > '9' )
+        {
+            return Fail( "invalid value" );
+        }
+        if( *q == '0' && q + 1 < end && q[1] >= '0' && q[1] <= '9' )
+        {
+            return Fail( "leading zero in number" );
+        }
+        const auto result = std::from_chars( p,end,number );
+        if( result.ec == std::errc::invalid_argument )
+        {
+            return Fail( "invalid number" );
+        }
+        // 超出 double 范围时 from_chars 不写 number
+        if( result.ec == std::errc::result_out_of_range )
+        {
+            number = *p == '-' ? -HUGE_VAL : HUGE_VAL;
+        }
+        p = result.ptr;
+        return true;
+    }
+private:
+    const char* begin;
+    const char* p;
+    const char* end;
+    std::string error;
+};
+
+bool JsonValue::Parse( const char* pText,std::size_t size,JsonValue& root,std::string& error )
+{
+    root = JsonValue();
+    Parser parser( pText,size );
+    if( !parser.ParseDocument( root ) )
+    {
+        error = parser.GetError();
+        return false;
+    }
+    return true;
+}
+
+JsonValue::Type JsonValue::GetType() const noexcept
+{
+    return type;
+}
+
+bool JsonValue::IsNumber() const noexcept
+{
+    return type == Type::Number;
+}
+
+std::size_t JsonValue::GetSize() const noexcept
+{
+    return elements.size();
+}
+
+const JsonValue& JsonValue::operator[]( std::size_t i ) const noexcept
+{
+    return elements[i];
+}
+
+const JsonValue* JsonValue::Find( const char* key ) const noexcept
+{
+    if( type != Type::Object )
+    {
+        return nullptr;
+    }
+    for( std::size_t i = 0u; i < keys.size(); i++ )
+    {
+        if( keys[i] == key )
+        {
+            return &elements[i];
+        }
+    }
+    return nullptr;
+}
+
+double JsonValue::GetNumber( double fallback ) const noexcept
+{
+    return type == Type::Number ? number : fallback;
+}
+
+bool JsonValue::GetBool( bool fallback ) const noexcept
+{
+    return type == Type::Bool ? boolean : fallback;
+}
+
+const std::string& JsonValue::GetString() const noexcept
+{
+    static const std::string empty;
+    return type == Type::String ? string : empty;
+}
+
+double JsonValue::GetNumber( const char* key,double fallback ) const noexcept
+{
+    const auto pMember = Find( key );
+    return pMember != nullptr ? pMember->GetNumber( fallback ) : fallback;
+}
+
+long long JsonValue::GetInt( const char* key,long long fallback ) const noexcept
+{
+    const auto pMember = Find( key );
+    if( pMember == nullptr || pMember->type != Type::Number )
+    {
+        return fallback;
+    }
+    // 非整数或者超出范围的都当作没有
+    const auto value = pMember->number;
+    if( value != std::floor( value ) || std::fabs( value ) > 9.0e15 )
+    {
+        return fallback;
+    }
+    return static_cast<long long>( value );
+}
+
+bool JsonValue::GetBool( const char* key,bool fallback ) const noexcept
+{
+    const auto pMember = Find( key );
+    return pMember != nullptr ? pMember->GetBool( fallback ) : fallback;
+}
+
+const std::string& JsonValue::GetString( const char* key ) const noexcept
+{
+    static const std::string empty;
+    const auto pMember = Find( key );
+    return pMember != nullptr ? pMember->GetString() : empty;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 只读的 JSON 树，给 .glb 的 JSON 块用（几十 KB，不值得做流式解析）。
+// 对象成员保持文件里的顺序，按键查找是线性的：glTF 的对象都只有几个成员
+class JsonValue
+{
+public:
+    enum class Type : unsigned char
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+public:
+    // false on malformed input (including nesting deeper than 256), error then says what and where
+    static bool Parse( const char* pText,std::size_t size,JsonValue& root,std::string& error );
+    Type GetType() const noexcept;
+    bool IsNumber() const noexcept;
+    // array elements or object members, 0 for everything else
+    std::size_t GetSize() const noexcept;
+    // i-th array element or object member value
+    const JsonValue& operator[]( std::size_t i ) const noexcept;
+    // nullptr if this is not an object or has no such member
+    const JsonValue* Find( const char* key ) const noexcept;
+    // fallback when the value has another type
+    double GetNumber( double fallback = 0.0 ) const noexcept;
+    bool GetBool( bool fallback = false ) const noexcept;
+    // empty if not a string
+    const std::string& GetString() const noexcept;
+    // 成员的快捷方式：没有这个成员或类型不对时返回 fallback
+    double GetNumber( const char* key,double fallback ) const noexcept;
+    long long GetInt( const char* key,long long fallback ) const noexcept;
+    bool GetBool( const char* key,bool fallback ) const noexcept;
+    const std::string& GetString( const char* key ) const noexcept;
+private:
+    class Parser;
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    // array elements, or object member values with their names in keys
+    std::vector<JsonValue> elements;
+    std::vector<std::string> keys;
+};
@@ -21,55 +21,41 @@
 
 bool Keyboard::KeyIsPressed(unsigned char keycode) const noexcept
 {
-	return keystates[keycode];
+	return SampleState().keystates[keycode];
 }
 
 Keyboard::Event Keyboard::ReadKey() noexcept
 {
-	if (!KeyIsEmpty())
-	{
-		Keyboard::Event e = keybuffer.front();
-		keybuffer.pop();
-		return e;
-	}
-	else
-	{
-		return Keyboard::Event();
-	}
+	Keyboard::Event e;
+	keybuffer.Pop(e);
+	return e;
 }
 
 bool Keyboard::KeyIsEmpty() const noexcept
 {
-	return keybuffer.empty();
+	return keybuffer.IsEmpty();
 }
 
 char Keyboard::ReadChar() noexcept
 {
-	if (!CharIsEmpty())
-	{
-		unsigned char charcode = charbuffer.front();
-		charbuffer.pop();
-		return charcode;
-	}
-	else
-	{
-		return 0;
-	}
+	char charcode = 0;
+	charbuffer.Pop(charcode);
+	return charcode;
 }
 
 bool Keyboard::CharIsEmpty() const noexcept
 {
-	return charbuffer.empty();
+	return charbuffer.IsEmpty();
 }
 
 void Keyboard::FlushKey() noexcept
 {
-	keybuffer = std::queue<Event>();
+	keybuffer.Clear();
 }
 
 void Keyboard::FlushChar() noexcept
 {
-	charbuffer = std::queue<char>();
+	charbuffer.Clear();
 }
 
 void Keyboard::Flush() noexcept
@@ -93,37 +79,58 @@ bool Keyboard::AutorepeatIsEnabled() const noexcept
 	return autorepeatEnabled;
 }
 
+float Keyboard::GetSampleLatency() const noexcept
+{
+	return sampleLatency;
+}
+
+unsigned long long Keyboard::GetKeyOverflowCount() const noexcept
+{
+	return keybuffer.GetOverflowCount();
+}
+
+unsigned long long Keyboard::GetCharOverflowCount() const noexcept
+{
+	return charbuffer.GetOverflowCount();
+}
+
 void Keyboard::OnKeyPressed(unsigned char keycode) noexcept
 {
 	keystates[keycode] = true;
-	keybuffer.push(Keyboard::Event(Keyboard::Event::Type::Press, keycode));
-	TrimBuffer(keybuffer);
+	PublishState();
+	keybuffer.Push(Keyboard::Event(Keyboard::Event::Type::Press, keycode));
 }
 
 void Keyboard::OnKeyReleased(unsigned char keycode) noexcept
 {
 	keystates[keycode] = false;
-	keybuffer.push(Keyboard::Event(Keyboard::Event::Type::Release, keycode));
-	TrimBuffer(keybuffer);
+	PublishState();
+	keybuffer.Push(Keyboard::Event(Keyboard::Event::Type::Release, keycode));
 }
 
 void Keyboard::OnChar(char character) noexcept
 {
-	charbuffer.push(character);
-	TrimBuffer(charbuffer);
+	charbuffer.Push(character);
 }
 
 void Keyboard::ClearState() noexcept
 {
 	keystates.reset();
+	PublishState();
+}
+
+void Keyboard::PublishState() noexcept
+{
+	snapshot.Publish({ keystates,std::chrono::steady_clock::now() });
 }
 
-template<typename T>
-void Keyboard::TrimBuffer(std::queue<T>& buffer) noexcept
+const Keyboard::State& Keyboard::SampleState() const noexcept
 {
-	while (buffer.size() > bufferSize)
+	if (snapshot.Latch())
 	{
-		buffer.pop();
+		const std::chrono::duration<float> latency = std::chrono::steady_clock::now() - snapshot.Get().timestamp;
+		sampleLatency = latency.count();
 	}
+	return snapshot.Get();
 }
 
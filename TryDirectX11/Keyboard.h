@@ -18,12 +18,18 @@
 *	along with The Chili Direct3D Engine.  If not, see <http://www.gnu.org/licenses/>.    *
 ******************************************************************************************/
 #pragma once
-#include <queue>
+#include "RingBuffer.h"
+#include "SnapshotBuffer.h"
+#include <atomic>
 #include <bitset>
+#include <chrono>
 
 class Keyboard
 {
 	friend class Window;
+	// injects recorded input on replay
+	friend class FrameReplayer;
+	static constexpr unsigned int nKeys = 256u;
 public:
 	class Event
 	{
@@ -37,6 +43,8 @@ public:
 	private:
 		Type type;
 		unsigned char code;
+		// 消息到达 HandleMsg 的时刻
+		std::chrono::steady_clock::time_point timestamp;
 	public:
 		Event() noexcept
 			:
@@ -46,7 +54,8 @@ public:
 		Event(Type type, unsigned char code) noexcept
 			:
 			type(type),
-			code(code)
+			code(code),
+			timestamp(std::chrono::steady_clock::now())
 		{}
 		bool IsPress() const noexcept
 		{
@@ -64,6 +73,16 @@ public:
 		{
 			return code;
 		}
+		std::chrono::steady_clock::time_point GetTimestamp() const noexcept
+		{
+			return timestamp;
+		}
+	};
+	// key state as last published by the thread that runs the message pump
+	struct State
+	{
+		std::bitset<nKeys> keystates;
+		std::chrono::steady_clock::time_point timestamp;
 	};
 public:
 	Keyboard() = default;
@@ -83,18 +102,25 @@ public:
 	void EnableAutorepeat() noexcept;
 	void DisableAutorepeat() noexcept;
 	bool AutorepeatIsEnabled() const noexcept;
+	// seconds between the message thread publishing the newest key state and this thread first seeing it
+	float GetSampleLatency() const noexcept;
+	// number of events dropped because the buffer was full
+	unsigned long long GetKeyOverflowCount() const noexcept;
+	unsigned long long GetCharOverflowCount() const noexcept;
 private:
 	void OnKeyPressed(unsigned char keycode) noexcept;
 	void OnKeyReleased(unsigned char keycode) noexcept;
 	void OnChar(char character) noexcept;
 	void ClearState() noexcept;
-	template<typename T>
-	static void TrimBuffer(std::queue<T>& buffer) noexcept;
+	void PublishState() noexcept;
+	const State& SampleState() const noexcept;
 private:
-	static constexpr unsigned int nKeys = 256u;
-	static constexpr unsigned int bufferSize = 16u;
-	bool autorepeatEnabled = false;
+	static constexpr unsigned int bufferSize = 64u;
+	std::atomic<bool> autorepeatEnabled{ false };
+	// keystates is only touched by the message thread, other threads read the published snapshot
 	std::bitset<nKeys> keystates;
-	std::queue<Event> keybuffer;
-	std::queue<char> charbuffer;
+	SnapshotBuffer<State> snapshot;
+	mutable float sampleLatency = 0.0f;
+	RingBuffer<Event, bufferSize> keybuffer;
+	RingBuffer<char, bufferSize> charbuffer;
 };
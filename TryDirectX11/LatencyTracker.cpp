@@ -0,0 +1,133 @@
+#include "LatencyTracker.h"
+#include "ChiliWin.h"
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+void LatencyTracker::OnInputConsumed(unsigned long long frameId, Clock::time_point arrival) noexcept
+{
+	auto& f = pending[frameId % maxFramesInFlight];
+	if (f.frameId != frameId || !f.hasInput)
+	{
+		f.frameId = frameId;
+		f.newestInput = arrival;
+		f.hasInput = true;
+	}
+	else if (arrival > f.newestInput)
+	{
+		f.newestInput = arrival;
+	}
+}
+
+void LatencyTracker::OnPresent(unsigned long long frameId, Clock::time_point presentTime) noexcept
+{
+	auto& f = pending[frameId % maxFramesInFlight];
+	if (f.frameId != frameId || !f.hasInput)
+	{
+		// 这一帧没有消费任何输入
+		return;
+	}
+	f.hasInput = false;
+
+	const float ms = std::chrono::duration<float, std::milli>(presentTime - f.newestInput).count();
+	const auto bucket = std::min(static_cast<unsigned int>(std::max(ms, 0.0f) / bucketWidth), nBuckets);
+	histogram[bucket]++;
+	count++;
+	sum += ms;
+	max = std::max(max, ms);
+
+	if (logging)
+	{
+		// 每帧都会走到这里，用栈上的缓冲格式化，不产生堆分配
+		char line[96];
+		std::snprintf(line, sizeof(line), "[InputLatency] frame %llu: %.2f ms\n", frameId, ms);
+		OutputDebugStringA(line);
+	}
+}
+
+void LatencyTracker::EnableLogging(bool enable) noexcept
+{
+	logging = enable;
+}
+
+unsigned long long LatencyTracker::GetSampleCount() const noexcept
+{
+	return count;
+}
+
+float LatencyTracker::GetPercentile(float p) const noexcept
+{
+	if (count == 0u)
+	{
+		return 0.0f;
+	}
+	const auto target = (unsigned long long)(std::clamp(p, 0.0f, 1.0f) * float(count - 1u));
+	unsigned long long seen = 0u;
+	for (unsigned int i = 0u; i <= nBuckets; i++)
+	{
+		seen += histogram[i];
+		if (seen > target)
+		{
+			// 返回桶的上界
+			return std::min(float(i + 1u) * bucketWidth, max);
+		}
+	}
+	return max;
+}
+
+float LatencyTracker::GetMean() const noexcept
+{
+	return count == 0u ? 0.0f : float(sum / double(count));
+}
+
+float LatencyTracker::GetMax() const noexcept
+{
+	return max;
+}
+
+std::string LatencyTracker::GetReport() const
+{
+	std::ostringstream oss;
+	oss << std::fixed << std::setprecision(2)
+		<< "[Input Latency] samples " << count
+		<< " mean " << GetMean() << " ms"
+		<< " p50 " << GetPercentile(0.5f) << " ms"
+		<< " p95 " << GetPercentile(0.95f) << " ms"
+		<< " p99 " << GetPercentile(0.99f) << " ms"
+		<< " max " << GetMax() << " ms" << std::endl;
+	if (count == 0u)
+	{
+		return oss.str();
+	}
+	const auto peak = *std::max_element(histogram.begin(), histogram.end());
+	constexpr unsigned int barWidth = 50u;
+	for (unsigned int i = 0u; i <= nBuckets; i++)
+	{
+		if (histogram[i] == 0u)
+		{
+			continue;
+		}
+		oss << std::setw(7) << float(i) * bucketWidth;
+		if (i == nBuckets)
+		{
+			oss << "+      ";
+		}
+		else
+		{
+			oss << "-" << std::setw(6) << float(i + 1u) * bucketWidth;
+		}
+		oss << " ms |" << std::string(size_t(histogram[i] * barWidth / peak), '#')
+			<< " " << histogram[i] << std::endl;
+	}
+	return oss.str();
+}
+
+void LatencyTracker::Reset() noexcept
+{
+	pending = {};
+	histogram = {};
+	count = 0u;
+	sum = 0.0;
+	max = 0.0f;
+}
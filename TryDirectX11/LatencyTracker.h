@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <string>
+
+// 统计 "输入到达 HandleMsg" 到 "反映这个输入的帧交给 Present" 之间的延迟。
+// 输入事件本身带有到达时间戳，帧在消费输入时用帧号登记本帧最新的那个输入，
+// Present 时再用同一个帧号取出来算差值，这样以后帧流水线变深（消费和 Present 不在同一帧）也能对上。
+class LatencyTracker
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	LatencyTracker() = default;
+	LatencyTracker(const LatencyTracker&) = delete;
+	LatencyTracker& operator=(const LatencyTracker&) = delete;
+	// frame frameId consumed an input that arrived at 'arrival'; only the newest one per frame is kept
+	void OnInputConsumed(unsigned long long frameId, Clock::time_point arrival) noexcept;
+	// frame frameId is being handed to Present at 'presentTime'
+	void OnPresent(unsigned long long frameId, Clock::time_point presentTime) noexcept;
+	// per-frame log lines go to the debugger output; off by default, the histogram from GetReport is usually enough
+	void EnableLogging(bool enable) noexcept;
+	unsigned long long GetSampleCount() const noexcept;
+	// latency in milliseconds, p in [0,1]; resolution is one histogram bucket
+	float GetPercentile(float p) const noexcept;
+	float GetMean() const noexcept;
+	float GetMax() const noexcept;
+	// summary plus an ascii histogram
+	std::string GetReport() const;
+	void Reset() noexcept;
+private:
+	struct PendingFrame
+	{
+		unsigned long long frameId = 0u;
+		Clock::time_point newestInput;
+		bool hasInput = false;
+	};
+	// how many frames may be in flight between consuming input and presenting
+	static constexpr unsigned int maxFramesInFlight = 8u;
+	static constexpr float bucketWidth = 0.5f;
+	// last bucket collects everything above nBuckets * bucketWidth ms
+	static constexpr unsigned int nBuckets = 128u;
+	std::array<PendingFrame, maxFramesInFlight> pending;
+	std::array<unsigned long long, nBuckets + 1u> histogram = {};
+	unsigned long long count = 0u;
+	double sum = 0.0;
+	float max = 0.0f;
+	bool logging = false;
+};
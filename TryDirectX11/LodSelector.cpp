@@ -0,0 +1,83 @@
+#include "LodSelector.h"
+#include <algorithm>
+
+LodSelector::LodSelector( const std::vector<float>& errors,float radius,const LodSettings& settings )
+    :
+    settings( settings )
+{
+    maxDiameters.reserve( errors.size() + 1u );
+    for( const auto error : errors )
+    {
+        maxDiameters.push_back( error > 0.0f
+            ? settings.pixelError * 2.0f * radius / error
+            : std::numeric_limits<float>::infinity() );
+    }
+}
+
+unsigned int LodSelector::GetLevelCount() const noexcept
+{
+    return static_cast<unsigned int>( maxDiameters.size() );
+}
+
+const LodSettings& LodSelector::GetSettings() const noexcept
+{
+    return settings;
+}
+
+float LodSelector::GetMaxDiameter( unsigned int level ) const noexcept
+{
+    return maxDiameters[level];
+}
+
+unsigned int LodSelector::Select( float diameter ) const noexcept
+{
+    // 误差一般逐级变大，但不依赖这一点：取满足条件的最粗一级
+    unsigned int level = 0u;
+    for( unsigned int i = 1u; i < maxDiameters.size(); i++ )
+    {
+        if( diameter <= maxDiameters[i] )
+        {
+            level = i;
+        }
+    }
+    return level;
+}
+
+bool LodSelector::Update( LodState& state,float diameter,float dt ) const noexcept
+{
+    if( state.IsFading() )
+    {
+        state.fade = settings.fadeSeconds > 0.0f ? std::min( state.fade + dt / settings.fadeSeconds,1.0f ) : 1.0f;
+    }
+    // 变粗要按放大了的直径也满足才行，变细只要当前这一级不再满足；两者之间保持不动
+    const auto coarser = Select( diameter * ( 1.0f + settings.hysteresis ) );
+    const auto finer = Select( diameter );
+    unsigned int target = state.level;
+    if( coarser > state.level )
+    {
+        target = coarser;
+    }
+    else if( finer < state.level )
+    {
+        target = finer;
+    }
+    if( target == state.level )
+    {
+        return false;
+    }
+    // 淡入淡出途中又换级：从当前这一级开始新的过渡，上一次的旧级直接丢掉
+    state.previous = state.level;
+    state.level = static_cast<unsigned char>( target );
+    state.fade = settings.fadeSeconds > 0.0f ? 0.0f : 1.0f;
+    return true;
+}
+
+float LodSelector::ProjectedDiameter( float viewZ,float radius,float projectionYScale,float viewportHeight ) noexcept
+{
+    if( viewZ <= radius )
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+    // 投影后 y 的范围是 [-1,1]，对应 viewportHeight 个像素
+    return radius * projectionYScale / viewZ * viewportHeight;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <limits>
+#include <vector>
+
+struct LodSettings
+{
+    // 允许的屏幕误差（像素）：选简化误差投影到屏幕上不超过它的最粗一级
+    float pixelError = 1.0f;
+    // 变粗时按包围球再大这么多（比例）来算，在切换点附近来回的物体不会每帧换级
+    float hysteresis = 0.15f;
+    // 换级时新旧两级交叉淡入淡出（互补的抖动像素）的时间，0 时直接切换
+    float fadeSeconds = 0.25f;
+};
+
+// 每个实例一份的选择状态，平凡可复制（可以直接放进 ECS 组件）
+struct LodState
+{
+    bool IsFading() const noexcept
+    {
+        return fade < 1.0f;
+    }
+    unsigned char level = 0u;
+    // 淡出中的上一级，只在 IsFading() 时有意义
+    unsigned char previous = 0u;
+    // 0 到 1，新的一级覆盖的像素比例
+    float fade = 1.0f;
+};
+
+// 按包围球投影到屏幕上的直径选 LOD；纯 CPU，const 成员可以在任意线程调用。
+// 第 i 级的几何误差是 e，包围球半径 r，投影直径 D 像素时误差大约是 e / 2r * D 像素，
+// 所以每一级有一个最大直径 pixelError * 2r / e，比它小就看不出这一级和原网格的差别
+class LodSelector
+{
+public:
+    // 只有原网格一级
+    LodSelector() = default;
+    // errors：简化出来的各级的几何误差（和 radius 同一个空间），从细到粗；原网格是第 0 级，不在里面
+    LodSelector( const std::vector<float>& errors,float radius,const LodSettings& settings );
+    unsigned int GetLevelCount() const noexcept;
+    const LodSettings& GetSettings() const noexcept;
+    // 第 level 级的切换点：投影直径不超过它时误差不超过 pixelError
+    float GetMaxDiameter( unsigned int level ) const noexcept;
+    // 不带滞后：误差不超过 pixelError 的最粗一级
+    unsigned int Select( float diameter ) const noexcept;
+    // 带滞后和淡入淡出地推进 state，返回这一帧是否换了级
+    bool Update( LodState& state,float diameter,float dt ) const noexcept;
+    // 相机在原点看 +z（App 没有观察矩阵）：viewZ 是球心的深度，projectionYScale 是投影矩阵的 _22；
+    // 相机在球里面时返回无穷大
+    static float ProjectedDiameter( float viewZ,float radius,float projectionYScale,float viewportHeight ) noexcept;
+private:
+    // 下标是级别，第 0 级是无穷大
+    std::vector<float> maxDiameters = { std::numeric_limits<float>::infinity() };
+    LodSettings settings;
+};
+
+// MeshPS.hlsl 的 LodFade 常数缓冲（常数缓冲的大小要是 16 的倍数）
+struct LodFadeConstants
+{
+    float coverage;
+    unsigned int complement;
+    float padding[2];
+};
@@ -0,0 +1,101 @@
+#include "MappedFile.h"
+#include "Window.h"
+#include <sstream>
+
+#define MAPPED_FILE_LAST_EXCEPT( path ) MappedFile::Exception( __LINE__,__FILE__,(path),GetLastError() )
+
+MappedFile::MappedFile( const std::string& path )
+{
+    // FILE_FLAG_SEQUENTIAL_SCAN 提示系统预读
+    hFile = CreateFileA( path.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,
+                         OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,nullptr );
+    if( hFile == INVALID_HANDLE_VALUE )
+    {
+        throw MAPPED_FILE_LAST_EXCEPT( path );
+    }
+    LARGE_INTEGER fileSize;
+    if( !GetFileSizeEx( hFile,&fileSize ) )
+    {
+        const auto e = MAPPED_FILE_LAST_EXCEPT( path );
+        CloseHandle( hFile );
+        throw e;
+    }
+    size = std::size_t( fileSize.QuadPart );
+    if( size == 0u )
+    {
+        // 空文件不能创建映射
+        return;
+    }
+    hMapping = CreateFileMappingA( hFile,nullptr,PAGE_READONLY,0u,0u,nullptr );
+    if( hMapping == nullptr )
+    {
+        const auto e = MAPPED_FILE_LAST_EXCEPT( path );
+        CloseHandle( hFile );
+        throw e;
+    }
+    pData = static_cast<const std::byte*>( MapViewOfFile( hMapping,FILE_MAP_READ,0u,0u,0u ) );
+    if( pData == nullptr )
+    {
+        const auto e = MAPPED_FILE_LAST_EXCEPT( path );
+        CloseHandle( hMapping );
+        CloseHandle( hFile );
+        throw e;
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if( pData != nullptr )
+    {
+        UnmapViewOfFile( pData );
+    }
+    if( hMapping != nullptr )
+    {
+        CloseHandle( hMapping );
+    }
+    CloseHandle( hFile );
+}
+
+const std::byte* MappedFile::GetData() const noexcept
+{
+    return pData;
+}
+
+std::size_t MappedFile::GetSize() const noexcept
+{
+    return size;
+}
+
+MappedFile::Exception::Exception( int line,const char* file,std::string path,DWORD errorCode ) noexcept
+    :
+    ChiliException( line,file ),
+    path( std::move( path ) ),
+    errorCode( errorCode )
+{}
+
+const char* MappedFile::Exception::what() const noexcept
+{
+    std::ostringstream oss;
+    oss << GetType() << std::endl
+        << "[Path] " << path << std::endl
+        << "[Error Code] " << errorCode << std::endl
+        << "[Description] " << Window::Exception::TranslateErrorCode( HRESULT_FROM_WIN32( errorCode ) ) << std::endl
+        << GetOriginString();
+    whatBuffer = oss.str();
+    return whatBuffer.c_str();
+}
+
+const char* MappedFile::Exception::GetType() const noexcept
+{
+    return "Mapped File Exception";
+}
+
+const std::string& MappedFile::Exception::GetPath() const noexcept
+{
+    return path;
+}
+
+DWORD MappedFile::Exception::GetErrorCode() const noexcept
+{
+    return errorCode;
+}
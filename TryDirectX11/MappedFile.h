@@ -0,0 +1,36 @@
+#pragma once
+#include "ChiliWin.h"
+#include "ChiliException.h"
+#include <cstddef>
+#include <string>
+
+// 只读内存映射整个文件，读取时由系统按页换入，不用先把整个文件拷到自己的缓冲里
+class MappedFile
+{
+public:
+    class Exception : public ChiliException
+    {
+    public:
+        Exception( int line,const char* file,std::string path,DWORD errorCode ) noexcept;
+        const char* what() const noexcept override;
+        const char* GetType() const noexcept override;
+        const std::string& GetPath() const noexcept;
+        DWORD GetErrorCode() const noexcept;
+    private:
+        std::string path;
+        DWORD errorCode;
+    };
+public:
+    explicit MappedFile( const std::string& path );
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+    ~MappedFile();
+    // nullptr for an empty file
+    const std::byte* GetData() const noexcept;
+    std::size_t GetSize() const noexcept;
+private:
+    HANDLE hFile = INVALID_HANDLE_VALUE;
+    HANDLE hMapping = nullptr;
+    const std::byte* pData = nullptr;
+    std::size_t size = 0u;
+};
@@ -0,0 +1,420 @@
+#include "MemoryTracker.h"
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	thread_local unsigned long long threadAllocationCount = 0u;
+	thread_local MemoryTag threadTag = MemoryTag::Untagged;
+
+	constexpr std::size_t nTags = std::size_t(MemoryTag::Count);
+	// 同时存在的线程超过这个数时，多出来的线程直接改全局的原子计数
+	constexpr std::size_t maxThreadSlots = 64u;
+
+	// 堆的字节数和块数每个线程一份（和 PerfCounters 一样只有所属线程写，relaxed 的 load + store，
+	// 不做原子 RMW，各占一条缓存行），读的时候把所有线程加起来。
+	// 释放可能发生在别的线程上，单个线程的值可以是负的，加起来才对
+	struct alignas(64) ThreadSlot
+	{
+		std::atomic<bool> used;
+		std::atomic<long long> hostBytes[nTags];
+		std::atomic<long long> hostBlocks[nTags];
+	};
+	ThreadSlot slots[maxThreadSlots];
+
+	// 都是常量初始化的，全局构造函数里的 new 也能安全计数
+	struct TagCounters
+	{
+		// 已退出的线程和没分到槽的线程的堆计数
+		std::atomic<long long> hostBytes;
+		std::atomic<long long> hostBlocks;
+		// 只在 EndFrame / GetUsage 时按当时的总数更新，不在每次分配时比较
+		std::atomic<long long> hostPeakBytes;
+		std::atomic<long long> gpuBytes[2];
+		std::atomic<long long> budgetBytes;
+	};
+	TagCounters counters[nTags];
+
+	// 线程第一次分配时占一个槽，退出时把槽里的值并到 counters 再归还。
+	// 构造函数是 constexpr，访问时不需要动态初始化；析构的注册（__cxa_thread_atexit）用 calloc，不会回到 operator new
+	struct SlotOwner
+	{
+		constexpr SlotOwner() noexcept = default;
+		~SlotOwner()
+		{
+			if (!pSlot)
+			{
+				return;
+			}
+			for (std::size_t t = 0u; t < nTags; t++)
+			{
+				counters[t].hostBytes.fetch_add(pSlot->hostBytes[t].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+				counters[t].hostBlocks.fetch_add(pSlot->hostBlocks[t].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+			pSlot->used.store(false, std::memory_order_release);
+			// 之后（别的 thread_local 析构时）的分配走全局计数
+			pSlot = nullptr;
+			tried = true;
+		}
+		ThreadSlot* pSlot = nullptr;
+		bool tried = false;
+	};
+	thread_local SlotOwner slotOwner;
+
+	ThreadSlot* GetThreadSlot() noexcept
+	{
+		if (!slotOwner.pSlot && !slotOwner.tried)
+		{
+			slotOwner.tried = true;
+			for (auto& slot : slots)
+			{
+				if (!slot.used.load(std::memory_order_relaxed) && !slot.used.exchange(true, std::memory_order_acquire))
+				{
+					slotOwner.pSlot = &slot;
+					break;
+				}
+			}
+		}
+		return slotOwner.pSlot;
+	}
+
+	void AddHost(MemoryTag tag, long long bytes, long long blocks) noexcept
+	{
+		const auto t = std::size_t(tag);
+		if (auto pSlot = GetThreadSlot())
+		{
+			pSlot->hostBytes[t].store(pSlot->hostBytes[t].load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+			pSlot->hostBlocks[t].store(pSlot->hostBlocks[t].load(std::memory_order_relaxed) + blocks, std::memory_order_relaxed);
+		}
+		else
+		{
+			counters[t].hostBytes.fetch_add(bytes, std::memory_order_relaxed);
+			counters[t].hostBlocks.fetch_add(blocks, std::memory_order_relaxed);
+		}
+	}
+
+	// 所有线程加起来的当前值，顺便更新峰值
+	void SumHost(std::size_t t, long long& bytes, long long& blocks) noexcept
+	{
+		bytes = counters[t].hostBytes.load(std::memory_order_relaxed);
+		blocks = counters[t].hostBlocks.load(std::memory_order_relaxed);
+		for (const auto& slot : slots)
+		{
+			bytes += slot.hostBytes[t].load(std::memory_order_relaxed);
+			blocks += slot.hostBlocks[t].load(std::memory_order_relaxed);
+		}
+		auto peak = counters[t].hostPeakBytes.load(std::memory_order_relaxed);
+		while (bytes > peak && !counters[t].hostPeakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	const char* const tagNames[nTags] = {
+		"Untagged",
+		"Graphics",
+		"Bindables",
+		"Scene",
+		"Recording",
+		"Tracing",
+		"Textures",
+		"Meshes",
+	};
+
+	// 放在每块用户内存正前方；对齐分配时头和块起点之间可能还有填充，offset 是用户指针到块起点的距离
+	struct alignas(16) Header
+	{
+		std::size_t size;
+		std::uint32_t offset;
+		MemoryTag tag;
+	};
+	static_assert(sizeof(Header) == 16u, "Header must keep default new alignment");
+
+	void* Track(void* block, std::size_t size, std::size_t offset) noexcept
+	{
+		auto p = static_cast<std::byte*>(block) + offset;
+		auto& h = reinterpret_cast<Header*>(p)[-1];
+		h.size = size;
+		h.offset = std::uint32_t(offset);
+		h.tag = threadTag;
+		threadAllocationCount++;
+		AddHost(h.tag, static_cast<long long>(size), 1);
+		return p;
+	}
+
+	// 返回块起点
+	void* Untrack(void* p) noexcept
+	{
+		const auto& h = reinterpret_cast<Header*>(p)[-1];
+		AddHost(h.tag, -static_cast<long long>(h.size), -1);
+		return static_cast<std::byte*>(p) - h.offset;
+	}
+
+	// 失败时返回 nullptr，由调用的 operator new 决定抛异常还是返回
+	void* Allocate(std::size_t size) noexcept
+	{
+		if (void* p = std::malloc(sizeof(Header) + size))
+		{
+			return Track(p, size, sizeof(Header));
+		}
+		return nullptr;
+	}
+
+	void* AllocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+	{
+		// 头占掉一个对齐单位，用户指针仍然对齐
+		const auto align = std::size_t(alignment);
+		const auto offset = align < sizeof(Header) ? sizeof(Header) : align;
+#ifdef _MSC_VER
+		if (void* p = _aligned_malloc(offset + size, align))
+#else
+		if (void* p = std::aligned_alloc(align, (offset + size + align - 1u) & ~(align - 1u)))
+#endif
+		{
+			return Track(p, size, offset);
+		}
+		return nullptr;
+	}
+
+	void Free(void* p) noexcept
+	{
+		if (p)
+		{
+			std::free(Untrack(p));
+		}
+	}
+
+	void FreeAligned(void* p) noexcept
+	{
+		if (!p)
+		{
+			return;
+		}
+#ifdef _MSC_VER
+		_aligned_free(Untrack(p));
+#else
+		std::free(Untrack(p));
+#endif
+	}
+
+	// 标准的 operator new：失败时调用 new_handler 再试，没有 new_handler 才抛 bad_alloc
+	template<typename F>
+	void* AllocateOrThrow(F&& allocate)
+	{
+		for (;;)
+		{
+			if (void* p = allocate())
+			{
+				return p;
+			}
+			const auto handler = std::get_new_handler();
+			if (!handler)
+			{
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+	}
+
+	template<typename F>
+	void* AllocateOrNull(F&& allocate) noexcept
+	{
+		try
+		{
+			return AllocateOrThrow(allocate);
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+	}
+}
+
+unsigned long long MemoryTracker::GetThreadAllocationCount() noexcept
+{
+	return threadAllocationCount;
+}
+
+MemoryTag MemoryTracker::GetThreadTag() noexcept
+{
+	return threadTag;
+}
+
+void MemoryTracker::SetThreadTag(MemoryTag tag) noexcept
+{
+	threadTag = tag;
+}
+
+void MemoryTracker::OnGpuAllocate(MemoryTag tag, GpuMemoryKind kind, std::size_t bytes) noexcept
+{
+	counters[std::size_t(tag)].gpuBytes[std::size_t(kind)].fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed);
+}
+
+void MemoryTracker::OnGpuFree(MemoryTag tag, GpuMemoryKind kind, std::size_t bytes) noexcept
+{
+	counters[std::size_t(tag)].gpuBytes[std::size_t(kind)].fetch_sub(static_cast<long long>(bytes), std::memory_order_relaxed);
+}
+
+void MemoryTracker::SetBudget(MemoryTag tag, long long bytes) noexcept
+{
+	counters[std::size_t(tag)].budgetBytes.store(bytes, std::memory_order_relaxed);
+}
+
+MemoryUsage MemoryTracker::GetUsage(MemoryTag tag) noexcept
+{
+	const auto t = std::size_t(tag);
+	const auto& c = counters[t];
+	MemoryUsage u;
+	SumHost(t, u.hostBytes, u.hostBlocks);
+	u.hostPeakBytes = c.hostPeakBytes.load(std::memory_order_relaxed);
+	u.gpuBufferBytes = c.gpuBytes[std::size_t(GpuMemoryKind::Buffer)].load(std::memory_order_relaxed);
+	u.gpuTextureBytes = c.gpuBytes[std::size_t(GpuMemoryKind::Texture)].load(std::memory_order_relaxed);
+	u.budgetBytes = c.budgetBytes.load(std::memory_order_relaxed);
+	return u;
+}
+
+void MemoryTracker::EndFrame() noexcept
+{
+	for (std::size_t t = 0u; t < nTags; t++)
+	{
+		long long bytes, blocks;
+		SumHost(t, bytes, blocks);
+	}
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag) noexcept
+{
+	return tagNames[std::size_t(tag)];
+}
+
+std::string MemoryTracker::GetReport()
+{
+	// 先取数再拼字符串，拼的过程中产生的分配不算进表里
+	std::array<MemoryUsage, nTags> usages;
+	for (std::size_t t = 0u; t < nTags; t++)
+	{
+		usages[t] = GetUsage(MemoryTag(t));
+	}
+	std::string report = "[Memory]   tag          host KB   peak KB   blocks  gpu buf KB  gpu tex KB\n";
+	char line[160];
+	for (std::size_t t = 0u; t < nTags; t++)
+	{
+		const auto& u = usages[t];
+		std::snprintf(line, sizeof(line), "[Memory]   %-10s %9lld %9lld %8lld %11lld %11lld",
+			tagNames[t], u.hostBytes / 1024, u.hostPeakBytes / 1024, u.hostBlocks,
+			u.gpuBufferBytes / 1024, u.gpuTextureBytes / 1024);
+		report += line;
+		if (u.IsOverBudget())
+		{
+			std::snprintf(line, sizeof(line), "  OVER BUDGET (%lld KB)", u.budgetBytes / 1024);
+			report += line;
+		}
+		report += '\n';
+	}
+	return report;
+}
+
+// 可替换的全局 operator new / delete 全部替换掉（数组、nothrow、sized、对齐的各种组合），
+// 不依赖标准库的默认实现转发到哪一个
+void* operator new(std::size_t size)
+{
+	return AllocateOrThrow([size]() noexcept { return Allocate(size); });
+}
+
+void* operator new[](std::size_t size)
+{
+	return AllocateOrThrow([size]() noexcept { return Allocate(size); });
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return AllocateOrNull([size]() noexcept { return Allocate(size); });
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return AllocateOrNull([size]() noexcept { return Allocate(size); });
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	return AllocateOrThrow([=]() noexcept { return AllocateAligned(size, alignment); });
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return AllocateOrThrow([=]() noexcept { return AllocateAligned(size, alignment); });
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateOrNull([=]() noexcept { return AllocateAligned(size, alignment); });
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return AllocateOrNull([=]() noexcept { return AllocateAligned(size, alignment); });
+}
+
+// 大小记在头里，sized delete 传进来的 size 用不上
+void operator delete(void* p) noexcept
+{
+	Free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	Free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	Free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	Free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	Free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	Free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	FreeAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+	FreeAligned(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	FreeAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	FreeAligned(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+	FreeAligned(p);
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 按子系统划分的内存标签。堆分配记在当前线程的标签上（用 MemoryScope 切换），GPU 资源在创建时记账。
+enum class MemoryTag : std::uint8_t
+{
+	Untagged,
+	Graphics,
+	Bindables,
+	Scene,
+	Recording,
+	Tracing,
+	Textures,
+	Meshes,
+	Count
+};
+
+enum class GpuMemoryKind : std::uint8_t
+{
+	Buffer,
+	Texture
+};
+
+struct MemoryUsage
+{
+	// 当前仍未释放的堆字节数和历史峰值
+	long long hostBytes;
+	long long hostPeakBytes;
+	// 仍未释放的块数
+	long long hostBlocks;
+	long long gpuBufferBytes;
+	long long gpuTextureBytes;
+	// 0 表示没有预算
+	long long budgetBytes;
+	long long GetTotalBytes() const noexcept
+	{
+		return hostBytes + gpuBufferBytes + gpuTextureBytes;
+	}
+	bool IsOverBudget() const noexcept
+	{
+		return budgetBytes != 0 && GetTotalBytes() > budgetBytes;
+	}
+};
+
+// 替换了全局 operator new / delete（见 MemoryTracker.cpp），统计当前线程经过通用堆的分配次数，
+// 并在每块内存前面放一个小头记下大小和标签，释放时从对应标签上减掉。
+// 用来验证稳定运行的帧里没有堆分配：帧前后各取一次，差值应该是 0。
+// 各标签的字节数和块数每个线程一份，分配时不碰共享的缓存行，GetUsage 时加起来；
+// 峰值只在 GetUsage 和 EndFrame 时按当时的总数更新，是按帧采样的峰值，不是精确到每次分配的。
+class MemoryTracker
+{
+public:
+	static unsigned long long GetThreadAllocationCount() noexcept;
+	static MemoryTag GetThreadTag() noexcept;
+	static void SetThreadTag(MemoryTag tag) noexcept;
+	static void OnGpuAllocate(MemoryTag tag, GpuMemoryKind kind, std::size_t bytes) noexcept;
+	static void OnGpuFree(MemoryTag tag, GpuMemoryKind kind, std::size_t bytes) noexcept;
+	// 预算包括堆和 GPU 两部分
+	static void SetBudget(MemoryTag tag, long long bytes) noexcept;
+	static MemoryUsage GetUsage(MemoryTag tag) noexcept;
+	// samples every tag's total for the peak; called once per frame by the frame loop
+	static void EndFrame() noexcept;
+	static const char* GetTagName(MemoryTag tag) noexcept;
+	// 每个标签一行的明细表，超出预算的行会标出来
+	static std::string GetReport();
+};
+
+// 作用域内当前线程的堆分配和 GPU 资源都记在 tag 上，离开时恢复原来的标签
+class MemoryScope
+{
+public:
+	explicit MemoryScope(MemoryTag tag) noexcept
+		:
+		previous(MemoryTracker::GetThreadTag())
+	{
+		MemoryTracker::SetThreadTag(tag);
+	}
+	~MemoryScope()
+	{
+		MemoryTracker::SetThreadTag(previous);
+	}
+	MemoryScope(const MemoryScope&) = delete;
+	MemoryScope& operator=(const MemoryScope&) = delete;
+private:
+	MemoryTag previous;
+};
+
+// GPU 资源的记账凭据，放在持有资源的对象里：创建资源后 Track 一次，对象析构时自动从账上减掉
+class GpuAllocation
+{
+public:
+	GpuAllocation() = default;
+	GpuAllocation(const GpuAllocation&) = delete;
+	GpuAllocation& operator=(const GpuAllocation&) = delete;
+	GpuAllocation(GpuAllocation&& other) noexcept
+		:
+		tag(other.tag),
+		kind(other.kind),
+		bytes(other.bytes)
+	{
+		other.bytes = 0u;
+	}
+	GpuAllocation& operator=(GpuAllocation&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			tag = other.tag;
+			kind = other.kind;
+			bytes = other.bytes;
+			other.bytes = 0u;
+		}
+		return *this;
+	}
+	~GpuAllocation()
+	{
+		Reset();
+	}
+	// 记在当前线程的标签上
+	void Track(GpuMemoryKind kind_in, std::size_t bytes_in) noexcept
+	{
+		Reset();
+		tag = MemoryTracker::GetThreadTag();
+		kind = kind_in;
+		bytes = bytes_in;
+		MemoryTracker::OnGpuAllocate(tag, kind, bytes);
+	}
+	void Reset() noexcept
+	{
+		if (bytes != 0u)
+		{
+			MemoryTracker::OnGpuFree(tag, kind, bytes);
+			bytes = 0u;
+		}
+	}
+private:
+	MemoryTag tag = MemoryTag::Untagged;
+	GpuMemoryKind kind = GpuMemoryKind::Buffer;
+	std::size_t bytes = 0u;
+};
@@ -0,0 +1,275 @@
+#include "Mesh.h"
+#include "BindableBase.h"
+#include "MemoryTracker.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    struct LodCounters
+    {
+        unsigned int triangles;
+        unsigned int fullTriangles;
+        unsigned int switches;
+        unsigned int fading;
+        unsigned int meshletsTested;
+        unsigned int meshletsFrustumCulled;
+        unsigned int meshletsBackfaceCulled;
+    };
+
+    // 每个名字只能注册一次，所有 Mesh 共用
+    const LodCounters& GetCounters()
+    {
+        static const LodCounters counters = {
+            // 实际提交的三角形，过渡中两级都算
+            PerfCounters::Register( "LodTriangles",PerfCounters::Kind::Counter ),
+            // 全都画原网格时的三角形数
+            PerfCounters::Register( "LodFullTriangles",PerfCounters::Kind::Counter ),
+            PerfCounters::Register( "LodSwitches",PerfCounters::Kind::Counter ),
+            // 这一帧画了两级的实例数
+            PerfCounters::Register( "LodFading",PerfCounters::Kind::Counter ),
+            // 按簇剔除（带簇的模型）：测试的簇、包围球在视锥外的、法线锥背对相机的
+            PerfCounters::Register( "MeshletsTested",PerfCounters::Kind::Counter ),
+            PerfCounters::Register( "MeshletsFrustumCulled",PerfCounters::Kind::Counter ),
+            PerfCounters::Register( "MeshletsBackfaceCulled",PerfCounters::Kind::Counter ),
+        };
+        return counters;
+    }
+
+    // 原网格在前，各级 LOD 依次接在后面
+    template<typename Index>
+    std::vector<Index> ConcatenateLods( const MeshData& data )
+    {
+        std::size_t total = data.indices.size();
+        for( const auto& lod : data.lods )
+        {
+            total += lod.indices.size();
+        }
+        std::vector<Index> indices;
+        indices.reserve( total );
+        indices.insert( indices.end(),data.indices.begin(),data.indices.end() );
+        for( const auto& lod : data.lods )
+        {
+            indices.insert( indices.end(),lod.indices.begin(),lod.indices.end() );
+        }
+        return indices;
+    }
+
+    template<typename Index>
+    std::size_t CullMeshlets( const std::vector<Meshlet>& meshlets,UINT first,UINT count,const std::vector<Index>& indices,
+        const MeshletCullView& view,std::vector<Index>& out,MeshletCullStats& stats ) noexcept
+    {
+        return MeshletCulling::Cull( meshlets.data() + first,count,indices.data(),view,out.data(),&stats );
+    }
+}
+
+Mesh::Mesh( Graphics& gfx,const MeshData& data,const LodSettings& lodSettings )
+    :
+    transformCbuf( gfx,*this ),
+    fadeCbuf( gfx,LodFadeConstants{ 1.0f,0u } )
+{
+    MemoryScope memoryScope( MemoryTag::Meshes );
+    GetCounters();
+    DirectX::XMStoreFloat4x4( &transform,DirectX::XMMatrixIdentity() );
+
+    // 误差是相对包围盒最长边的，换成模型空间的距离
+    float extent = 0.0f;
+    float radiusSq = 0.0f;
+    for( int c = 0; c < 3; c++ )
+    {
+        const auto size = data.boundsMax[c] - data.boundsMin[c];
+        extent = std::max( extent,size );
+        radiusSq += size * size * 0.25f;
+    }
+    boundsCenter = {
+        ( data.boundsMin[0] + data.boundsMax[0] ) * 0.5f,
+        ( data.boundsMin[1] + data.boundsMax[1] ) * 0.5f,
+        ( data.boundsMin[2] + data.boundsMax[2] ) * 0.5f,
+    };
+    boundsRadius = std::sqrt( radiusSq );
+    std::vector<float> errors;
+    lodRanges.push_back( { 0u,UINT( data.indices.size() ),0u,UINT( data.meshlets.size() ) } );
+    meshlets = data.meshlets;
+    for( const auto& lod : data.lods )
+    {
+        const auto start = lodRanges.back().start + lodRanges.back().count;
+        lodRanges.push_back( { start,UINT( lod.indices.size() ),UINT( meshlets.size() ),UINT( lod.meshlets.size() ) } );
+        for( auto meshlet : lod.meshlets )
+        {
+            meshlet.firstIndex += start;
+            meshlets.push_back( meshlet );
+        }
+        errors.push_back( lod.error * extent );
+    }
+    lodSelector = LodSelector( errors,boundsRadius,lodSettings );
+
+    AddBind( BindPool<VertexBuffer>::Emplace( gfx,data.vertices ) );
+    if( !meshlets.empty() )
+    {
+        // 索引每帧按簇剔除后重写，静态的索引缓冲用不上；容量按所有级别加起来算，一帧里多画几个实例才绕回开头
+        UINT largest = 0u;
+        for( const auto& range : lodRanges )
+        {
+            largest = std::max( largest,range.count );
+        }
+        const auto total = lodRanges.back().start + lodRanges.back().count;
+        const bool small = data.vertices.size() <= std::numeric_limits<unsigned short>::max();
+        if( small )
+        {
+            meshletIndices16 = ConcatenateLods<unsigned short>( data );
+            culledIndices16.resize( largest );
+        }
+        else
+        {
+            meshletIndices32 = ConcatenateLods<std::uint32_t>( data );
+            culledIndices32.resize( largest );
+        }
+        pCulledIndices = std::make_unique<DynamicIndexBuffer>( gfx,small ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT,total );
+        AddInlineBind( *pCulledIndices );
+    }
+    else if( data.vertices.size() <= std::numeric_limits<unsigned short>::max() )
+    {
+        // 16 位索引省一半的显存和带宽
+        AddIndexBuffer( BindPool<IndexBuffer>::Emplace( gfx,ConcatenateLods<unsigned short>( data ) ) );
+    }
+    else if( data.lods.empty() )
+    {
+        AddIndexBuffer( BindPool<IndexBuffer>::Emplace( gfx,data.indices ) );
+    }
+    else
+    {
+        AddIndexBuffer( BindPool<IndexBuffer>::Emplace( gfx,ConcatenateLods<std::uint32_t>( data ) ) );
+    }
+
+    // VertexShader.cso 只读 Position，法线和纹理坐标按 32 字节的步长跳过
+    const auto vs = BindPool<VertexShader>::Emplace( gfx,L"VertexShader.cso" );
+    auto pvsbc = BindPool<VertexShader>::Get( vs ).GetBytecode();
+    AddBind( vs );
+    AddBind( BindPool<PixelShader>::Emplace( gfx,L"MeshPS.cso" ) );
+    const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
+    {
+        { "Position",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D11_INPUT_PER_VERTEX_DATA,0 },
+    };
+    AddBind( BindPool<InputLayout>::Emplace( gfx,ied,pvsbc ) );
+    AddBind( BindPool<Topology>::Emplace( gfx,D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST ) );
+    // 导入时已经换成顺时针
+    AddBind( BindPool<Rasterizer>::Emplace( gfx,false ) );
+
+    AddInlineBind( transformCbuf );
+    AddInlineBind( fadeCbuf );
+}
+
+void Mesh::DrawInstance( Graphics& gfx,DirectX::FXMMATRIX world,LodState& lod,float dt ) noexcept(!IS_DEBUG)
+{
+    namespace dx = DirectX;
+    dx::XMStoreFloat4x4( &transform,world );
+    // 没有观察矩阵，世界空间就是相机空间；半径按缩放最大的轴算
+    const auto center = dx::XMVector3TransformCoord( dx::XMLoadFloat3( &boundsCenter ),world );
+    const auto scale = std::max( { dx::XMVectorGetX( dx::XMVector3Length( world.r[0] ) ),
+                                   dx::XMVectorGetX( dx::XMVector3Length( world.r[1] ) ),
+                                   dx::XMVectorGetX( dx::XMVector3Length( world.r[2] ) ) } );
+    const auto diameter = LodSelector::ProjectedDiameter( dx::XMVectorGetZ( center ),boundsRadius * scale,
+        dx::XMVectorGetY( gfx.GetProjection().r[1] ),gfx.GetViewportHeight() );
+
+    if( pCulledIndices )
+    {
+        // 视锥和相机都换到模型空间：簇的包围球和法线锥不用逐个变换
+        dx::XMFLOAT4X4 clip;
+        dx::XMStoreFloat4x4( &clip,world * gfx.GetProjection() );
+        dx::XMFLOAT3 camera;
+        dx::XMStoreFloat3( &camera,dx::XMMatrixInverse( nullptr,world ).r[3] );
+        const float cameraArray[3] = { camera.x,camera.y,camera.z };
+        cullView = MeshletCullView::FromMatrix( clip.m,cameraArray );
+    }
+
+    const auto& counters = GetCounters();
+    if( lodSelector.Update( lod,diameter,dt ) )
+    {
+        PerfCounters::Add( counters.switches );
+    }
+    if( lod.IsFading() )
+    {
+        // 旧的一级画 1 - fade 的像素，新的一级画剩下的
+        DrawLevel( gfx,lod.previous,1.0f - lod.fade,false );
+        DrawLevel( gfx,lod.level,1.0f - lod.fade,true );
+        PerfCounters::Add( counters.fading );
+    }
+    else
+    {
+        DrawLevel( gfx,lod.level,1.0f,false );
+    }
+    PerfCounters::Add( counters.fullTriangles,lodRanges.front().count / 3u );
+}
+
+void Mesh::DrawLevel( Graphics& gfx,unsigned int level,float coverage,bool complement ) noexcept(!IS_DEBUG)
+{
+    const LodFadeConstants constants = { coverage,complement ? 1u : 0u };
+    if( constants.coverage != fade.coverage || constants.complement != fade.complement )
+    {
+        fadeCbuf.Update<GfxCheck::Unchecked>( gfx,constants );
+        fade = constants;
+    }
+    // 状态可能来自 LOD 更多的另一个 Mesh
+    const auto& range = lodRanges[std::min( level,GetLodCount() - 1u )];
+    const auto& counters = GetCounters();
+    if( !pCulledIndices )
+    {
+        SetIndexRange( range.start,range.count );
+        Draw( gfx );
+        PerfCounters::Add( counters.triangles,range.count / 3u );
+        return;
+    }
+    MeshletCullStats stats;
+    const void* pCulled;
+    UINT count;
+    if( !meshletIndices16.empty() )
+    {
+        count = UINT( CullMeshlets( meshlets,range.firstMeshlet,range.meshletCount,meshletIndices16,cullView,culledIndices16,stats ) );
+        pCulled = culledIndices16.data();
+    }
+    else
+    {
+        count = UINT( CullMeshlets( meshlets,range.firstMeshlet,range.meshletCount,meshletIndices32,cullView,culledIndices32,stats ) );
+        pCulled = culledIndices32.data();
+    }
+    PerfCounters::Add( counters.meshletsTested,std::int64_t( stats.meshlets ) );
+    PerfCounters::Add( counters.meshletsFrustumCulled,std::int64_t( stats.frustumCulled ) );
+    PerfCounters::Add( counters.meshletsBackfaceCulled,std::int64_t( stats.backfaceCulled ) );
+    if( count == 0u )
+    {
+        return;
+    }
+    SetIndexRange( pCulledIndices->Append( gfx,pCulled,count ),count );
+    Draw( gfx );
+    PerfCounters::Add( counters.triangles,count / 3u );
+}
+
+DirectX::XMMATRIX Mesh::GetTransformXM() const noexcept
+{
+    return DirectX::XMLoadFloat4x4( &transform );
+}
+
+std::size_t Mesh::GetTriangleCount() const noexcept
+{
+    return lodRanges.front().count / 3u;
+}
+
+unsigned int Mesh::GetLodCount() const noexcept
+{
+    return static_cast<unsigned int>( lodRanges.size() );
+}
+
+const std::vector<BindHandle>& Mesh::GetStaticBinds() const noexcept
+{
+    static const std::vector<BindHandle> none;
+    return none;
+}
+
+BindStream& Mesh::GetStaticStream() const noexcept
+{
+    // 没有 static binds，永远是空的
+    static BindStream none;
+    return none;
+}
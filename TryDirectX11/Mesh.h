@@ -0,0 +1,59 @@
+#pragma once
+#include "DrawbleBase.h"
+#include "ConstantBuffers.h"
+#include "DynamicIndexBuffer.h"
+#include "LodSelector.h"
+#include "MeshData.h"
+#include "MeshletCulling.h"
+#include "TransformCbuf.h"
+#include <memory>
+
+// 导入的模型。和 Box 不同，所有 Bindable 都是每个 Mesh 自己的（AddBind 进 BindPool，析构时归还），
+// 没有 static binds；模型一般只有几个，不值得共享着色器。顶点数超过 65535 时用 32 位索引。
+// 原网格和 MeshData::lods 的各级接在同一个索引缓冲里（共用顶点缓冲），画的时候按包围球投影到屏幕上的大小选一段。
+// data 带簇（MeshletBuilder::BuildAll）时索引留一份在 CPU 上，每次画先按簇剔除，剩下的索引 Append 进动态索引缓冲再画
+class Mesh : public Drawable
+{
+public:
+    Mesh( Graphics& gfx,const MeshData& data,const LodSettings& lodSettings = {} );
+    // lod 是这个实例自己的选择状态，dt 推进它的淡入淡出；过渡中新旧两级各画一次
+    void DrawInstance( Graphics& gfx,DirectX::FXMMATRIX world,LodState& lod,float dt ) noexcept(!IS_DEBUG);
+    DirectX::XMMATRIX GetTransformXM() const noexcept override;
+    std::size_t GetTriangleCount() const noexcept;
+    // 包括原网格
+    unsigned int GetLodCount() const noexcept;
+private:
+    void DrawLevel( Graphics& gfx,unsigned int level,float coverage,bool complement ) noexcept(!IS_DEBUG);
+    const std::vector<BindHandle>& GetStaticBinds() const noexcept override;
+    BindStream& GetStaticStream() const noexcept override;
+private:
+    struct IndexRange
+    {
+        UINT start;
+        UINT count;
+        // 这一级的簇在 meshlets 里的范围
+        UINT firstMeshlet;
+        UINT meshletCount;
+    };
+    // 下标是级别，第 0 级是原网格
+    std::vector<IndexRange> lodRanges;
+    LodSelector lodSelector;
+    // 模型空间的包围球（包围盒的外接球）
+    DirectX::XMFLOAT3 boundsCenter;
+    float boundsRadius;
+    DirectX::XMFLOAT4X4 transform;
+    TransformCbuf transformCbuf;
+    PixelConstantBuffer<LodFadeConstants> fadeCbuf;
+    // 上一次写进 fadeCbuf 的值，不变时不用 Map
+    LodFadeConstants fade = { 1.0f,0u };
+    // 各级的簇接在一起，firstIndex 已经加上了所在级别的 start；没有簇时为空，直接画静态的索引缓冲
+    std::vector<Meshlet> meshlets;
+    // 和 GPU 上一样接在一起的索引，按顶点数只用其中一种；culled 是剔除的输出，放得下最大的一级
+    std::vector<unsigned short> meshletIndices16;
+    std::vector<std::uint32_t> meshletIndices32;
+    std::vector<unsigned short> culledIndices16;
+    std::vector<std::uint32_t> culledIndices32;
+    std::unique_ptr<DynamicIndexBuffer> pCulledIndices;
+    // DrawInstance 算好，DrawLevel 用
+    MeshletCullView cullView;
+};
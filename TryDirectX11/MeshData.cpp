@@ -0,0 +1,148 @@
+#include "MeshData.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+MeshException::MeshException( int line,const char* file,std::string name,std::string note ) noexcept
+    :
+    ChiliException( line,file ),
+    name( std::move( name ) ),
+    note( std::move( note ) )
+{}
+
+const char* MeshException::what() const noexcept
+{
+    std::ostringstream oss;
+    oss << GetType() << std::endl
+        << "[Mesh] " << name << std::endl
+        << "[Note] " << note << std::endl
+        << GetOriginString();
+    whatBuffer = oss.str();
+    return whatBuffer.c_str();
+}
+
+const char* MeshException::GetType() const noexcept
+{
+    return "Mesh Exception";
+}
+
+const std::string& MeshException::GetName() const noexcept
+{
+    return name;
+}
+
+const std::string& MeshException::GetNote() const noexcept
+{
+    return note;
+}
+
+std::size_t MeshLod::GetTriangleCount() const noexcept
+{
+    return indices.size() / 3u;
+}
+
+std::size_t MeshData::GetTriangleCount() const noexcept
+{
+    return indices.size() / 3u;
+}
+
+void MeshData::ComputeBounds() noexcept
+{
+    if( vertices.empty() )
+    {
+        std::fill( std::begin( boundsMin ),std::end( boundsMin ),0.0f );
+        std::fill( std::begin( boundsMax ),std::end( boundsMax ),0.0f );
+        return;
+    }
+    std::fill( std::begin( boundsMin ),std::end( boundsMin ),std::numeric_limits<float>::max() );
+    std::fill( std::begin( boundsMax ),std::end( boundsMax ),std::numeric_limits<float>::lowest() );
+    for( const auto& v : vertices )
+    {
+        for( int c = 0; c < 3; c++ )
+        {
+            boundsMin[c] = std::min( boundsMin[c],v.position[c] );
+            boundsMax[c] = std::max( boundsMax[c],v.position[c] );
+        }
+    }
+}
+
+void MeshData::GenerateNormals()
+{
+    std::vector<float> sums( vertices.size() * 3u,0.0f );
+    for( std::size_t i = 0u; i + 2u < indices.size(); i += 3u )
+    {
+        const auto& a = vertices[indices[i]].position;
+        const auto& b = vertices[indices[i + 1u]].position;
+        const auto& c = vertices[indices[i + 2u]].position;
+        const float e0[3] = { b[0] - a[0],b[1] - a[1],b[2] - a[2] };
+        const float e1[3] = { c[0] - a[0],c[1] - a[1],c[2] - a[2] };
+        // 左手系顺时针：e0 x e1 指向正面一侧，长度是面积的两倍，正好做权重
+        const float n[3] = {
+            e0[1] * e1[2] - e0[2] * e1[1],
+            e0[2] * e1[0] - e0[0] * e1[2],
+            e0[0] * e1[1] - e0[1] * e1[0] };
+        for( std::size_t k = 0u; k < 3u; k++ )
+        {
+            auto s = &sums[std::size_t( indices[i + k] ) * 3u];
+            s[0] += n[0];
+            s[1] += n[1];
+            s[2] += n[2];
+        }
+    }
+    for( std::size_t i = 0u; i < vertices.size(); i++ )
+    {
+        const auto s = &sums[i * 3u];
+        const auto length = std::sqrt( s[0] * s[0] + s[1] * s[1] + s[2] * s[2] );
+        const auto scale = length > 0.0f ? 1.0f / length : 0.0f;
+        vertices[i].normal[0] = s[0] * scale;
+        vertices[i].normal[1] = s[1] * scale;
+        vertices[i].normal[2] = s[2] * scale;
+    }
+}
+
+std::size_t MeshData::Weld()
+{
+    // 开放寻址，表里存新顶点的下标，容量是 2 的幂、至少两倍于顶点数
+    constexpr auto empty = std::numeric_limits<std::uint32_t>::max();
+    std::size_t capacity = 16u;
+    while( capacity < vertices.size() * 2u )
+    {
+        capacity *= 2u;
+    }
+    std::vector<std::uint32_t> table( capacity,empty );
+    std::vector<std::uint32_t> remap( vertices.size(),empty );
+    std::vector<MeshVertex> welded;
+    welded.reserve( vertices.size() );
+    for( auto& index : indices )
+    {
+        auto& target = remap[index];
+        if( target == empty )
+        {
+            const auto& v = vertices[index];
+            std::uint32_t words[8];
+            std::memcpy( words,&v,sizeof( words ) );
+            std::uint64_t hash = 0xCBF29CE484222325u;
+            for( const auto w : words )
+            {
+                hash = ( hash ^ w ) * 0x100000001B3u;
+            }
+            auto slot = std::size_t( hash ^ ( hash >> 32u ) ) & ( capacity - 1u );
+            while( table[slot] != empty && std::memcmp( &welded[table[slot]],&v,sizeof( MeshVertex ) ) != 0 )
+            {
+                slot = ( slot + 1u ) & ( capacity - 1u );
+            }
+            if( table[slot] == empty )
+            {
+                table[slot] = std::uint32_t( welded.size() );
+                welded.push_back( v );
+            }
+            target = table[slot];
+        }
+        index = target;
+    }
+    const auto removed = vertices.size() - welded.size();
+    vertices = std::move( welded );
+    return removed;
+}
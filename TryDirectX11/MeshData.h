@@ -0,0 +1,76 @@
+#pragma once
+#include "ChiliException.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MeshException : public ChiliException
+{
+public:
+    MeshException( int line,const char* file,std::string name,std::string note ) noexcept;
+    const char* what() const noexcept override;
+    const char* GetType() const noexcept override;
+    // file name or whatever the caller used to identify the mesh
+    const std::string& GetName() const noexcept;
+    const std::string& GetNote() const noexcept;
+private:
+    std::string name;
+    std::string note;
+};
+
+// 32 字节，可以直接交给 VertexBuffer
+struct MeshVertex
+{
+    float position[3];
+    float normal[3];
+    float texCoord[2];
+};
+
+// 一个簇（meshlet）：所在索引数组里从 firstIndex 开始连续的 triangleCount 个三角形，最多引用 64 个不同的顶点。
+// 包围球和法线锥用来整簇剔除（见 MeshletCulling）
+struct Meshlet
+{
+    std::uint32_t firstIndex;
+    std::uint8_t triangleCount;
+    std::uint8_t vertexCount;
+    float center[3];
+    float radius;
+    // 从相机到 coneApex 的方向和 coneAxis 的夹角余弦 >= coneCutoff 时，所有三角形都背对相机；
+    // 法线太分散时 coneCutoff > 1，不做背面剔除
+    float coneApex[3];
+    float coneAxis[3];
+    float coneCutoff;
+};
+
+// 简化出来的一级细节：和原网格共用 vertices（只删三角形、不移动顶点），只有索引不同
+struct MeshLod
+{
+    std::vector<std::uint32_t> indices;
+    // 几何误差，相对包围盒最长边
+    float error = 0.0f;
+    // MeshletBuilder::BuildAll 生成，indices 按簇重排过
+    std::vector<Meshlet> meshlets;
+    std::size_t GetTriangleCount() const noexcept;
+};
+
+// 导入后的三角形列表：左手系、顺时针为正面（和 Box 一样），纹理坐标 v 向下。
+// vertices / indices 就是 VertexBuffer / IndexBuffer 要的数组；纯 CPU，Tools 里也能用
+struct MeshData
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    float boundsMin[3] = {};
+    float boundsMax[3] = {};
+    // 从细到粗，不含原网格（MeshSimplifier::BuildLods 生成）
+    std::vector<MeshLod> lods;
+    // 原网格的簇（MeshletBuilder::BuildAll 生成，indices 按簇重排过）
+    std::vector<Meshlet> meshlets;
+    std::size_t GetTriangleCount() const noexcept;
+    void ComputeBounds() noexcept;
+    // 面积加权的顶点法线，覆盖已有的法线
+    void GenerateNormals();
+    // 合并逐位相同的顶点（例如每个三角形各有一份顶点的模型），返回去掉的顶点数。
+    // 顶点按第一次被引用的顺序重排（顶点缓存更友好），没被引用的顶点丢掉；lods 和簇不跟着改，要在生成 LOD 和簇之前调用
+    std::size_t Weld();
+};
@@ -0,0 +1,1181 @@
+#include "MeshImporter.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#define MESH_EXCEPT( note ) MeshException( __LINE__,__FILE__,name,(note) )
+
+namespace
+{
+    constexpr auto noIndex = std::numeric_limits<std::uint32_t>::max();
+
+    struct Chunk
+    {
+        const char* begin;
+        const char* end;
+    };
+
+    // 按大约 targetSize 切块，每块在换行之后结束，块里都是完整的行
+    std::vector<Chunk> SplitLines( const char* begin,const char* end,ThreadPool* pPool )
+    {
+        // 块数比线程多几倍，抢块时负载更均衡；块太小时分发的开销不划算
+        const std::size_t threads = pPool != nullptr ? pPool->GetWorkerCount() + 1u : 1u;
+        const auto targetSize = std::max<std::size_t>( 256u * 1024u,std::size_t( end - begin ) / ( threads * 8u ) + 1u );
+        std::vector<Chunk> chunks;
+        while( begin < end )
+        {
+            auto split = std::size_t( end - begin ) > targetSize ? begin + targetSize : end;
+            if( split < end )
+            {
+                const auto newline = static_cast<const char*>( std::memchr( split,'\n',std::size_t( end - split ) ) );
+                split = newline != nullptr ? newline + 1 : end;
+            }
+            chunks.push_back( { begin,split } );
+            begin = split;
+        }
+        return chunks;
+    }
+
+    // 不含 '\n'
+    const char* LineEnd( const char* p,const char* end ) noexcept
+    {
+        const auto newline = static_cast<const char*>( std::memchr( p,'\n',std::size_t( end - p ) ) );
+        return newline != nullptr ? newline : end;
+    }
+
+    bool IsSpace( char c ) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    const char* SkipSpaces( const char* p,const char* end ) noexcept
+    {
+        while( p < end && IsSpace( *p ) )
+        {
+            p++;
+        }
+        return p;
+    }
+
+    bool IsDigit( char c ) noexcept
+    {
+        return unsigned( c - '0' ) < 10u;
+    }
+
+    bool ParseInteger( const char*& p,const char* end,long long& value ) noexcept
+    {
+        auto q = p;
+        const auto negative = q < end && *q == '-';
+        if( q < end && ( *q == '-' || *q == '+' ) )
+        {
+            q++;
+        }
+        if( q == end || !IsDigit( *q ) )
+        {
+            return false;
+        }
+        long long v = 0;
+        while( q < end && IsDigit( *q ) )
+        {
+            v = v * 10 + ( *q - '0' );
+            q++;
+        }
+        value = negative ? -v : v;
+        p = q;
+        return true;
+    }
+
+    // 8 个字节都是 '0'..'9'（小端，第一个字符在最低字节）
+    bool IsEightDigits( std::uint64_t v ) noexcept
+    {
+        return ( ( v & 0xF0F0F0F0F0F0F0F0u ) | ( ( ( v + 0x0606060606060606u ) & 0xF0F0F0F0F0F0F0F0u ) >> 4u ) ) ==
+            0x3333333333333333u;
+    }
+
+    // 相邻两位、四位、八位逐级合并，三次乘法换算 8 位数字
+    std::uint32_t ParseEightDigits( std::uint64_t v ) noexcept
+    {
+        v -= 0x3030303030303030u;
+        v = v * 10u + ( v >> 8u );
+        v = ( ( v & 0x000000FF000000FFu ) * ( 100u + ( 1000000ull << 32u ) ) +
+            ( ( v >> 16u ) & 0x000000FF000000FFu ) * ( 1u + ( 10000ull << 32u ) ) ) >> 32u;
+        return std::uint32_t( v );
+    }
+
+    // 最多累加 19 位数字，再多就标记 truncated（交给 strtof）
+    const char* ParseDigits( const char* p,const char* end,std::uint64_t& mantissa,int& digits,bool& truncated ) noexcept
+    {
+        while( end - p >= 8 && digits + 8 <= 19 )
+        {
+            std::uint64_t v;
+            std::memcpy( &v,p,8u );
+            if( !IsEightDigits( v ) )
+            {
+                break;
+            }
+            mantissa = mantissa * 100000000u + ParseEightDigits( v );
+            digits += 8;
+            p += 8;
+        }
+        while( p < end && IsDigit( *p ) )
+        {
+            if( digits < 19 )
+            {
+                mantissa = mantissa * 10u + unsigned( *p - '0' );
+                digits++;
+            }
+            else
+            {
+                truncated = true;
+            }
+            p++;
+        }
+        return p;
+    }
+
+    struct Corner
+    {
+        std::uint32_t position;
+        std::uint32_t texCoord;
+        std::uint32_t normal;
+    };
+
+    // 左右手系转换，然后补法线、算包围盒
+    void Finish( MeshData& mesh,bool hasNormals,const MeshImportOptions& options,const std::string& name )
+    {
+        if( mesh.indices.empty() )
+        {
+            throw MESH_EXCEPT( "The file contains no triangles" );
+        }
+        if( options.convertToLeftHanded )
+        {
+            // z 取反是镜像，相机也跟着镜像，屏幕上看到的绕向不变（还是逆时针），所以还要交换每个三角形的两个顶点
+            for( auto& v : mesh.vertices )
+            {
+                v.position[2] = -v.position[2];
+                v.normal[2] = -v.normal[2];
+                v.texCoord[1] = 1.0f - v.texCoord[1];
+            }
+            for( std::size_t i = 0u; i + 2u < mesh.indices.size(); i += 3u )
+            {
+                std::swap( mesh.indices[i + 1u],mesh.indices[i + 2u] );
+            }
+        }
+        if( !hasNormals && options.generateNormals )
+        {
+            mesh.GenerateNormals();
+        }
+        mesh.ComputeBounds();
+    }
+
+    struct ObjCounts
+    {
+        std::size_t positions = 0u;
+        std::size_t texCoords = 0u;
+        std::size_t normals = 0u;
+        std::size_t triangles = 0u;
+    };
+
+    enum class ObjLine
+    {
+        Position,
+        TexCoord,
+        Normal,
+        Face,
+        Other,
+    };
+
+    // p 指向行首（已跳过空白），返回时 p 指向关键字之后
+    ObjLine ClassifyObjLine( const char*& p,const char* end ) noexcept
+    {
+        if( end - p >= 2 && IsSpace( p[1] ) )
+        {
+            if( p[0] == 'v' )
+            {
+                p += 2;
+                return ObjLine::Position;
+            }
+            if( p[0] == 'f' )
+            {
+                p += 2;
+                return ObjLine::Face;
+            }
+        }
+        if( end - p >= 3 && p[0] == 'v' && IsSpace( p[2] ) )
+        {
+            if( p[1] == 't' )
+            {
+                p += 3;
+                return ObjLine::TexCoord;
+            }
+            if( p[1] == 'n' )
+            {
+                p += 3;
+                return ObjLine::Normal;
+            }
+        }
+        return ObjLine::Other;
+    }
+
+    ObjCounts CountObj( const Chunk& chunk ) noexcept
+    {
+        ObjCounts counts;
+        for( auto p = chunk.begin; p < chunk.end; )
+        {
+            const auto lineEnd = LineEnd( p,chunk.end );
+            p = SkipSpaces( p,lineEnd );
+            switch( ClassifyObjLine( p,lineEnd ) )
+            {
+            case ObjLine::Position:
+                counts.positions++;
+                break;
+            case ObjLine::TexCoord:
+                counts.texCoords++;
+                break;
+            case ObjLine::Normal:
+                counts.normals++;
+                break;
+            case ObjLine::Face:
+            {
+                std::size_t corners = 0u;
+                while( ( p = SkipSpaces( p,lineEnd ) ) < lineEnd )
+                {
+                    corners++;
+                    while( p < lineEnd && !IsSpace( *p ) )
+                    {
+                        p++;
+                    }
+                }
+                counts.triangles += corners >= 3u ? corners - 2u : 0u;
+                break;
+            }
+            default:
+                break;
+            }
+            p = lineEnd + 1;
+        }
+        return counts;
+    }
+
+    struct ObjArrays
+    {
+        std::vector<float> positions;
+        std::vector<float> texCoords;
+        std::vector<float> normals;
+        std::vector<Corner> corners;
+        ObjCounts totals;
+    };
+
+    // OBJ 的下标从 1 开始，负数从当前已有的个数往回数
+    std::uint32_t ResolveObjIndex( long long index,std::size_t countSoFar,std::size_t total,
+        const char* pLine,const char* pFile,const std::string& name )
+    {
+        const auto resolved = index > 0 ? index - 1 : static_cast<long long>( countSoFar ) + index;
+        if( index == 0 || resolved < 0 || static_cast<std::size_t>( resolved ) >= total )
+        {
+            throw MESH_EXCEPT( "Face index " + std::to_string( index ) + " out of range at byte " +
+                std::to_string( pLine - pFile ) );
+        }
+        return static_cast<std::uint32_t>( resolved );
+    }
+
+    void ParseObj( const Chunk& chunk,const ObjCounts& base,ObjArrays& arrays,const char* pFile,const std::string& name )
+    {
+        auto nPositions = base.positions;
+        auto nTexCoords = base.texCoords;
+        auto nNormals = base.normals;
+        auto pCorner = arrays.corners.data() + base.triangles * 3u;
+        for( auto p = chunk.begin; p < chunk.end; )
+        {
+            const auto lineBegin = p;
+            const auto lineEnd = LineEnd( p,chunk.end );
+            p = SkipSpaces( p,lineEnd );
+            const auto kind = ClassifyObjLine( p,lineEnd );
+            const auto parseFloats = [&]( float* pOut,int required,int count ) {
+                for( int i = 0; i < count; i++ )
+                {
+                    p = SkipSpaces( p,lineEnd );
+                    if( !MeshImporter::ParseFloat( p,lineEnd,pOut[i] ) )
+                    {
+                        if( i < required )
+                        {
+                            throw MESH_EXCEPT( "Malformed number at byte " + std::to_string( p - pFile ) );
+                        }
+                        pOut[i] = 0.0f;
+                    }
+                }
+            };
+            switch( kind )
+            {
+            case ObjLine::Position:
+                parseFloats( &arrays.positions[nPositions++ * 3u],3,3 );
+                break;
+            case ObjLine::TexCoord:
+                parseFloats( &arrays.texCoords[nTexCoords++ * 2u],1,2 );
+                break;
+            case ObjLine::Normal:
+                parseFloats( &arrays.normals[nNormals++ * 3u],3,3 );
+                break;
+            case ObjLine::Face:
+            {
+                // 扇形三角化：(0, i - 1, i)
+                Corner first = {};
+                Corner previous = {};
+                std::size_t corners = 0u;
+                while( ( p = SkipSpaces( p,lineEnd ) ) < lineEnd )
+                {
+                    Corner c = { 0u,noIndex,noIndex };
+                    long long index;
+                    if( !ParseInteger( p,lineEnd,index ) )
+                    {
+                        throw MESH_EXCEPT( "Malformed face at byte " + std::to_string( p - pFile ) );
+                    }
+                    c.position = ResolveObjIndex( index,nPositions,arrays.totals.positions,lineBegin,pFile,name );
+                    if( p < lineEnd && *p == '/' )
+                    {
+                        p++;
+                        if( ParseInteger( p,lineEnd,index ) )
+                        {
+                            c.texCoord = ResolveObjIndex( index,nTexCoords,arrays.totals.texCoords,lineBegin,pFile,name );
+                        }
+                        if( p < lineEnd && *p == '/' )
+                        {
+                            p++;
+                            if( ParseInteger( p,lineEnd,index ) )
+                            {
+                                c.normal = ResolveObjIndex( index,nNormals,arrays.totals.normals,lineBegin,pFile,name );
+                            }
+                        }
+                    }
+                    if( p < lineEnd && !IsSpace( *p ) )
+                    {
+                        throw MESH_EXCEPT( "Malformed face at byte " + std::to_string( p - pFile ) );
+                    }
+                    if( corners == 0u )
+                    {
+                        first = c;
+                    }
+                    else if( corners >= 2u )
+                    {
+                        *pCorner++ = first;
+                        *pCorner++ = previous;
+                        *pCorner++ = c;
+                    }
+                    previous = c;
+                    corners++;
+                }
+                if( corners < 3u )
+                {
+                    throw MESH_EXCEPT( "Face with fewer than 3 vertices at byte " + std::to_string( lineBegin - pFile ) );
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            p = lineEnd + 1;
+        }
+    }
+
+    // 同一个 (位置, 纹理坐标, 法线) 组合只生成一个顶点，顶点按第一次出现的顺序排列
+    void WeldCorners( const ObjArrays& arrays,MeshData& mesh )
+    {
+        const auto& corners = arrays.corners;
+        mesh.indices.resize( corners.size() );
+        std::size_t capacity = 16u;
+        while( capacity < std::max( { arrays.totals.positions,arrays.totals.texCoords,arrays.totals.normals } ) * 2u )
+        {
+            capacity *= 2u;
+        }
+        std::vector<std::uint32_t> table( capacity,noIndex );
+        std::vector<Corner> unique;
+        unique.reserve( capacity / 2u );
+        const auto hashOf = []( const Corner& c ) noexcept {
+            return std::size_t( ( c.position * 0x9E3779B1u ) ^ ( c.texCoord * 0x85EBCA77u ) ^ ( c.normal * 0xC2B2AE3Du ) );
+        };
+        for( std::size_t i = 0u; i < corners.size(); i++ )
+        {
+            const auto& c = corners[i];
+            auto slot = hashOf( c ) & ( capacity - 1u );
+            while( table[slot] != noIndex )
+            {
+                const auto& u = unique[table[slot]];
+                if( u.position == c.position && u.texCoord == c.texCoord && u.normal == c.normal )
+                {
+                    break;
+                }
+                slot = ( slot + 1u ) & ( capacity - 1u );
+            }
+            if( table[slot] == noIndex )
+            {
+                table[slot] = std::uint32_t( unique.size() );
+                unique.push_back( c );
+                // 装填率超过一半时翻倍重建
+                if( unique.size() * 2u > capacity )
+                {
+                    capacity *= 2u;
+                    table.assign( capacity,noIndex );
+                    for( std::uint32_t k = 0u; k < unique.size(); k++ )
+                    {
+                        auto s = hashOf( unique[k] ) & ( capacity - 1u );
+                        while( table[s] != noIndex )
+                        {
+                            s = ( s + 1u ) & ( capacity - 1u );
+                        }
+                        table[s] = k;
+                    }
+                    mesh.indices[i] = std::uint32_t( unique.size() - 1u );
+                    continue;
+                }
+            }
+            mesh.indices[i] = table[slot];
+        }
+        mesh.vertices.resize( unique.size() );
+        for( std::size_t i = 0u; i < unique.size(); i++ )
+        {
+            const auto& c = unique[i];
+            auto& v = mesh.vertices[i];
+            std::memcpy( v.position,&arrays.positions[std::size_t( c.position ) * 3u],sizeof( v.position ) );
+            if( c.normal != noIndex )
+            {
+                std::memcpy( v.normal,&arrays.normals[std::size_t( c.normal ) * 3u],sizeof( v.normal ) );
+            }
+            else
+            {
+                std::fill( std::begin( v.normal ),std::end( v.normal ),0.0f );
+            }
+            if( c.texCoord != noIndex )
+            {
+                std::memcpy( v.texCoord,&arrays.texCoords[std::size_t( c.texCoord ) * 2u],sizeof( v.texCoord ) );
+            }
+            else
+            {
+                std::fill( std::begin( v.texCoord ),std::end( v.texCoord ),0.0f );
+            }
+        }
+    }
+
+    enum class PlyType : std::uint8_t
+    {
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Float32,
+        Float64,
+    };
+
+    struct PlyProperty
+    {
+        std::string name;
+        PlyType type;
+        bool isList;
+        PlyType countType;
+    };
+
+    struct PlyElement
+    {
+        std::string name;
+        std::size_t count;
+        std::vector<PlyProperty> properties;
+    };
+
+    enum class PlyFormat
+    {
+        Ascii,
+        BinaryLittleEndian,
+        BinaryBigEndian,
+    };
+
+    std::size_t PlyTypeSize( PlyType type ) noexcept
+    {
+        switch( type )
+        {
+        case PlyType::Int8:
+        case PlyType::UInt8:
+            return 1u;
+        case PlyType::Int16:
+        case PlyType::UInt16:
+            return 2u;
+        case PlyType::Int32:
+        case PlyType::UInt32:
+        case PlyType::Float32:
+            return 4u;
+        default:
+            return 8u;
+        }
+    }
+
+    bool ParsePlyType( const std::string& token,PlyType& type ) noexcept
+    {
+        static const struct
+        {
+            const char* name;
+            PlyType type;
+        } names[] = {
+            { "char",PlyType::Int8 },{ "int8",PlyType::Int8 },
+            { "uchar",PlyType::UInt8 },{ "uint8",PlyType::UInt8 },
+            { "short",PlyType::Int16 },{ "int16",PlyType::Int16 },
+            { "ushort",PlyType::UInt16 },{ "uint16",PlyType::UInt16 },
+            { "int",PlyType::Int32 },{ "int32",PlyType::Int32 },
+            { "uint",PlyType::UInt32 },{ "uint32",PlyType::UInt32 },
+            { "float",PlyType::Float32 },{ "float32",PlyType::Float32 },
+            { "double",PlyType::Float64 },{ "float64",PlyType::Float64 },
+        };
+        for( const auto& n : names )
+        {
+            if( token == n.name )
+            {
+                type = n.type;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    double ReadPlyValue( const std::byte* p,PlyType type,bool swap ) noexcept
+    {
+        unsigned char raw[8];
+        const auto size = PlyTypeSize( type );
+        std::memcpy( raw,p,size );
+        if( swap )
+        {
+            std::reverse( raw,raw + size );
+        }
+        switch( type )
+        {
+        case PlyType::Int8:
+            return double( static_cast<std::int8_t>( raw[0] ) );
+        case PlyType::UInt8:
+            return double( raw[0] );
+        case PlyType::Int16:
+        {
+            std::int16_t v;
+            std::memcpy( &v,raw,2u );
+            return double( v );
+        }
+        case PlyType::UInt16:
+        {
+            std::uint16_t v;
+            std::memcpy( &v,raw,2u );
+            return double( v );
+        }
+        case PlyType::Int32:
+        {
+            std::int32_t v;
+            std::memcpy( &v,raw,4u );
+            return double( v );
+        }
+        case PlyType::UInt32:
+        {
+            std::uint32_t v;
+            std::memcpy( &v,raw,4u );
+            return double( v );
+        }
+        case PlyType::Float32:
+        {
+            float v;
+            std::memcpy( &v,raw,4u );
+            return double( v );
+        }
+        default:
+        {
+            double v;
+            std::memcpy( &v,raw,8u );
+            return v;
+        }
+        }
+    }
+
+    // vertex 元素里各分量对应的属性下标，-1 表示没有
+    struct PlyVertexMap
+    {
+        int slots[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+        bool hasNormals = false;
+        bool hasTexCoords = false;
+    };
+
+    PlyVertexMap MapPlyVertex( const PlyElement& element,const std::string& name )
+    {
+        // x y z nx ny nz u v 依次对应 slots[0..8)
+        static const char* const aliases[8][4] = {
+            { "x" },{ "y" },{ "z" },
+            { "nx" },{ "ny" },{ "nz" },
+            { "u","s","texture_u","texture_s" },
+            { "v","t","texture_v","texture_t" },
+        };
+        PlyVertexMap map;
+        for( int p = 0; p < int( element.properties.size() ); p++ )
+        {
+            const auto& property = element.properties[p];
+            for( int s = 0; s < 8; s++ )
+            {
+                for( const auto alias : aliases[s] )
+                {
+                    if( alias != nullptr && property.name == alias && !property.isList )
+                    {
+                        map.slots[s] = p;
+                    }
+                }
+            }
+        }
+        if( map.slots[0] < 0 || map.slots[1] < 0 || map.slots[2] < 0 )
+        {
+            throw MESH_EXCEPT( "PLY vertex element has no x, y, z properties" );
+        }
+        map.hasNormals = map.slots[3] >= 0 && map.slots[4] >= 0 && map.slots[5] >= 0;
+        map.hasTexCoords = map.slots[6] >= 0 && map.slots[7] >= 0;
+        return map;
+    }
+
+    void StorePlyComponent( MeshVertex& v,int slot,float value ) noexcept
+    {
+        if( slot < 3 )
+        {
+            v.position[slot] = value;
+        }
+        else if( slot < 6 )
+        {
+            v.normal[slot - 3] = value;
+        }
+        else
+        {
+            v.texCoord[slot - 6] = value;
+        }
+    }
+
+    // 扇形三角化，检查下标
+    void AppendPolygon( const long long* pIndices,std::size_t count,std::size_t vertexCount,
+        std::vector<std::uint32_t>& out,const std::string& name )
+    {
+        for( std::size_t i = 0u; i < count; i++ )
+        {
+            if( pIndices[i] < 0 || static_cast<std::size_t>( pIndices[i] ) >= vertexCount )
+            {
+                throw MESH_EXCEPT( "PLY face index " + std::to_string( pIndices[i] ) + " out of range" );
+            }
+        }
+        for( std::size_t i = 2u; i < count; i++ )
+        {
+            out.push_back( std::uint32_t( pIndices[0] ) );
+            out.push_back( std::uint32_t( pIndices[i - 1u] ) );
+            out.push_back( std::uint32_t( pIndices[i] ) );
+        }
+    }
+
+    bool IsFaceList( const PlyProperty& property ) noexcept
+    {
+        return property.isList && ( property.name == "vertex_indices" || property.name == "vertex_index" );
+    }
+
+    void ParsePlyBinary( const std::byte* p,const std::byte* end,const std::vector<PlyElement>& elements,bool swap,
+        MeshData& mesh,bool& hasNormals,ThreadPool* pPool,const std::string& name )
+    {
+        const auto require = [&]( const std::byte* q,std::size_t bytes ) {
+            if( std::size_t( end - q ) < bytes )
+            {
+                throw MESH_EXCEPT( "PLY data is truncated" );
+            }
+        };
+        std::vector<long long> polygon;
+        for( const auto& element : elements )
+        {
+            const auto hasLists = std::any_of( element.properties.begin(),element.properties.end(),
+                []( const PlyProperty& property ) { return property.isList; } );
+            if( element.name == "vertex" )
+            {
+                if( hasLists )
+                {
+                    throw MESH_EXCEPT( "PLY vertex element with list properties is not supported" );
+                }
+                const auto map = MapPlyVertex( element,name );
+                hasNormals = map.hasNormals;
+                std::vector<std::size_t> offsets;
+                std::size_t stride = 0u;
+                for( const auto& property : element.properties )
+                {
+                    offsets.push_back( stride );
+                    stride += PlyTypeSize( property.type );
+                }
+                require( p,stride * element.count );
+                mesh.vertices.resize( element.count );
+                // 定长记录，按顶点区间并行转换
+                constexpr std::size_t verticesPerTask = 65536u;
+                const auto pBase = p;
+                RunTasks( pPool,( element.count + verticesPerTask - 1u ) / verticesPerTask,[&]( std::size_t task ) {
+                    const auto first = task * verticesPerTask;
+                    const auto last = std::min( element.count,first + verticesPerTask );
+                    for( auto i = first; i < last; i++ )
+                    {
+                        auto& v = mesh.vertices[i];
+                        v = {};
+                        const auto record = pBase + i * stride;
+                        for( int s = 0; s < 8; s++ )
+                        {
+                            if( map.slots[s] >= 0 )
+                            {
+                                const auto& property = element.properties[map.slots[s]];
+                                const auto pValue = record + offsets[map.slots[s]];
+                                float value;
+                                // 最常见的小端 float 直接拷
+                                if( property.type == PlyType::Float32 && !swap )
+                                {
+                                    std::memcpy( &value,pValue,4u );
+                                }
+                                else
+                                {
+                                    value = float( ReadPlyValue( pValue,property.type,swap ) );
+                                }
+                                StorePlyComponent( v,s,value );
+                            }
+                        }
+                    }
+                } );
+                p += stride * element.count;
+                continue;
+            }
+            // 其他元素（包括 face）有列表时只能顺序走
+            const auto isFace = element.name == "face";
+            if( isFace )
+            {
+                mesh.indices.reserve( element.count * 3u );
+            }
+            for( std::size_t i = 0u; i < element.count; i++ )
+            {
+                for( const auto& property : element.properties )
+                {
+                    if( !property.isList )
+                    {
+                        require( p,PlyTypeSize( property.type ) );
+                        p += PlyTypeSize( property.type );
+                        continue;
+                    }
+                    require( p,PlyTypeSize( property.countType ) );
+                    const auto count = std::size_t( ReadPlyValue( p,property.countType,swap ) );
+                    p += PlyTypeSize( property.countType );
+                    const auto size = PlyTypeSize( property.type );
+                    require( p,count * size );
+                    if( isFace && IsFaceList( property ) )
+                    {
+                        polygon.resize( count );
+                        for( std::size_t k = 0u; k < count; k++ )
+                        {
+                            if( size == 4u && !swap && property.type != PlyType::Float32 )
+                            {
+                                std::int32_t index;
+                                std::memcpy( &index,p + k * 4u,4u );
+                                polygon[k] = property.type == PlyType::UInt32 ? static_cast<long long>( std::uint32_t( index ) ) : index;
+                            }
+                            else
+                            {
+                                polygon[k] = static_cast<long long>( ReadPlyValue( p + k * size,property.type,swap ) );
+                            }
+                        }
+                        AppendPolygon( polygon.data(),count,mesh.vertices.size(),mesh.indices,name );
+                    }
+                    p += count * size;
+                }
+            }
+        }
+    }
+
+    void ParsePlyAscii( const char* begin,const char* end,const std::vector<PlyElement>& elements,
+        MeshData& mesh,bool& hasNormals,ThreadPool* pPool,const std::string& name )
+    {
+        // 每个元素占一行：先并行数出每块的行数，得到各块第一行的行号，就知道每行属于哪个元素
+        const auto chunks = SplitLines( begin,end,pPool );
+        std::vector<std::size_t> firstLine( chunks.size() + 1u,0u );
+        RunTasks( pPool,chunks.size(),[&]( std::size_t c ) {
+            std::size_t lines = 0u;
+            for( auto p = chunks[c].begin; p < chunks[c].end; p = LineEnd( p,chunks[c].end ) + 1 )
+            {
+                lines++;
+            }
+            firstLine[c + 1u] = lines;
+        } );
+        for( std::size_t c = 0u; c < chunks.size(); c++ )
+        {
+            firstLine[c + 1u] += firstLine[c];
+        }
+        std::vector<std::size_t> elementStart;
+        std::size_t totalLines = 0u;
+        const PlyElement* pVertex = nullptr;
+        std::size_t vertexStart = 0u;
+        for( const auto& element : elements )
+        {
+            elementStart.push_back( totalLines );
+            if( element.name == "vertex" )
+            {
+                pVertex = &element;
+                vertexStart = totalLines;
+            }
+            totalLines += element.count;
+        }
+        if( firstLine.back() < totalLines )
+        {
+            throw MESH_EXCEPT( "PLY data is truncated" );
+        }
+        if( pVertex == nullptr )
+        {
+            throw MESH_EXCEPT( "PLY file has no vertex element" );
+        }
+        const auto map = MapPlyVertex( *pVertex,name );
+        hasNormals = map.hasNormals;
+        mesh.vertices.resize( pVertex->count );
+
+        // 面先写进各块自己的数组，最后按块的顺序拼起来
+        std::vector<std::vector<std::uint32_t>> faces( chunks.size() );
+        RunTasks( pPool,chunks.size(),[&]( std::size_t c ) {
+            auto line = firstLine[c];
+            std::size_t e = std::upper_bound( elementStart.begin(),elementStart.end(),line ) - elementStart.begin() - 1u;
+            std::vector<long long> polygon;
+            float values[64];
+            for( auto p = chunks[c].begin; p < chunks[c].end && line < totalLines; line++ )
+            {
+                const auto lineEnd = LineEnd( p,chunks[c].end );
+                while( line >= elementStart[e] + elements[e].count )
+                {
+                    e++;
+                }
+                const auto& element = elements[e];
+                const auto isVertex = &element == pVertex;
+                const auto isFace = element.name == "face";
+                if( isVertex || isFace )
+                {
+                    for( std::size_t k = 0u; k < element.properties.size(); k++ )
+                    {
+                        const auto& property = element.properties[k];
+                        p = SkipSpaces( p,lineEnd );
+                        if( !property.isList )
+                        {
+                            float value;
+                            if( !MeshImporter::ParseFloat( p,lineEnd,value ) )
+                            {
+                                throw MESH_EXCEPT( "Malformed number at byte " + std::to_string( p - begin ) + " of the PLY body" );
+                            }
+                            if( isVertex && k < 64u )
+                            {
+                                values[k] = value;
+                            }
+                            continue;
+                        }
+                        long long count;
+                        if( !ParseInteger( p,lineEnd,count ) || count < 0 )
+                        {
+                            throw MESH_EXCEPT( "Malformed list at byte " + std::to_string( p - begin ) + " of the PLY body" );
+                        }
+                        polygon.resize( std::size_t( count ) );
+                        for( auto& index : polygon )
+                        {
+                            p = SkipSpaces( p,lineEnd );
+                            if( !ParseInteger( p,lineEnd,index ) )
+                            {
+                                throw MESH_EXCEPT( "Malformed list at byte " + std::to_string( p - begin ) + " of the PLY body" );
+                            }
+                        }
+                        if( isFace && IsFaceList( property ) )
+                        {
+                            AppendPolygon( polygon.data(),polygon.size(),pVertex->count,faces[c],name );
+                        }
+                    }
+                    if( isVertex )
+                    {
+                        auto& v = mesh.vertices[line - vertexStart];
+                        v = {};
+                        for( int s = 0; s < 8; s++ )
+                        {
+                            if( map.slots[s] >= 0 && map.slots[s] < 64 )
+                            {
+                                StorePlyComponent( v,s,values[map.slots[s]] );
+                            }
+                        }
+                    }
+                }
+                p = lineEnd + 1;
+            }
+        } );
+        std::vector<std::size_t> faceOffsets( chunks.size() + 1u,0u );
+        for( std::size_t c = 0u; c < chunks.size(); c++ )
+        {
+            faceOffsets[c + 1u] = faceOffsets[c] + faces[c].size();
+        }
+        mesh.indices.resize( faceOffsets.back() );
+        RunTasks( pPool,chunks.size(),[&]( std::size_t c ) {
+            std::copy( faces[c].begin(),faces[c].end(),mesh.indices.begin() + faceOffsets[c] );
+        } );
+    }
+}
+
+bool MeshImporter::ParseFloat( const char*& p,const char* end,float& value ) noexcept
+{
+    static constexpr double powersOf10[] = {
+        1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,
+        1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22 };
+    const auto start = p;
+    auto q = p;
+    const auto negative = q < end && *q == '-';
+    if( q < end && ( *q == '-' || *q == '+' ) )
+    {
+        q++;
+    }
+    std::uint64_t mantissa = 0u;
+    int digits = 0;
+    bool truncated = false;
+    const auto integerBegin = q;
+    q = ParseDigits( q,end,mantissa,digits,truncated );
+    auto significant = q - integerBegin;
+    int exponent = 0;
+    if( q < end && *q == '.' )
+    {
+        q++;
+        const auto fractionBegin = q;
+        q = ParseDigits( q,end,mantissa,digits,truncated );
+        significant += q - fractionBegin;
+        exponent = -int( q - fractionBegin );
+    }
+    if( significant == 0 )
+    {
+        return false;
+    }
+    if( q < end && ( *q == 'e' || *q == 'E' ) )
+    {
+        auto e = q + 1;
+        const auto negativeExponent = e < end && *e == '-';
+        if( e < end && ( *e == '-' || *e == '+' ) )
+        {
+            e++;
+        }
+        if( e < end && IsDigit( *e ) )
+        {
+            int ev = 0;
+            while( e < end && IsDigit( *e ) )
+            {
+                ev = std::min( ev * 10 + ( *e - '0' ),100000 );
+                e++;
+            }
+            exponent += negativeExponent ? -ev : ev;
+            q = e;
+        }
+    }
+    if( !truncated && mantissa <= ( 1ull << 53u ) && exponent >= -22 && exponent <= 22 )
+    {
+        // 尾数和 10 的幂都能在 double 里精确表示，一次乘除就是正确舍入的 double
+        auto d = double( mantissa );
+        d = exponent < 0 ? d / powersOf10[-exponent] : d * powersOf10[exponent];
+        value = float( negative ? -d : d );
+    }
+    else
+    {
+        // 少见的情况交给 strtof（它要以 '\0' 结尾）
+        char buffer[128];
+        const auto length = std::size_t( q - start );
+        if( length >= sizeof( buffer ) )
+        {
+            value = std::strtof( std::string( start,q ).c_str(),nullptr );
+        }
+        else
+        {
+            std::memcpy( buffer,start,length );
+            buffer[length] = '\0';
+            value = std::strtof( buffer,nullptr );
+        }
+    }
+    p = q;
+    return true;
+}
+
+MeshData MeshImporter::ImportObj( const std::byte* pData,std::size_t size,const std::string& name,
+    const MeshImportOptions& options,ThreadPool* pPool )
+{
+    const auto pFile = reinterpret_cast<const char*>( pData );
+    const auto chunks = SplitLines( pFile,pFile + size,pPool );
+
+    // 1. 各块数自己的 v / vt / vn 行和三角形，前缀和得到每块在最终数组里的起点
+    std::vector<ObjCounts> bases( chunks.size() + 1u );
+    RunTasks( pPool,chunks.size(),[&]( std::size_t c ) {
+        bases[c + 1u] = CountObj( chunks[c] );
+    } );
+    for( std::size_t c = 0u; c < chunks.size(); c++ )
+    {
+        bases[c + 1u].positions += bases[c].positions;
+        bases[c + 1u].texCoords += bases[c].texCoords;
+        bases[c + 1u].normals += bases[c].normals;
+        bases[c + 1u].triangles += bases[c].triangles;
+    }
+    ObjArrays arrays;
+    arrays.totals = bases.back();
+    if( arrays.totals.triangles * 3u >= noIndex )
+    {
+        throw MESH_EXCEPT( "Too many triangles for 32-bit indices" );
+    }
+    arrays.positions.resize( arrays.totals.positions * 3u );
+    arrays.texCoords.resize( arrays.totals.texCoords * 2u );
+    arrays.normals.resize( arrays.totals.normals * 3u );
+    arrays.corners.resize( arrays.totals.triangles * 3u );
+
+    // 2. 各块解析，直接写到自己的区间里
+    RunTasks( pPool,chunks.size(),[&]( std::size_t c ) {
+        ParseObj( chunks[c],bases[c],arrays,pFile,name );
+    } );
+
+    // 3. 合并顶点
+    MeshData mesh;
+    const auto hasNormals = std::all_of( arrays.corners.begin(),arrays.corners.end(),
+        []( const Corner& c ) { return c.normal != noIndex; } );
+    if( !options.weld )
+    {
+        mesh.vertices.resize( arrays.corners.size() );
+        mesh.indices.resize( arrays.corners.size() );
+        RunTasks( pPool,chunks.size(),[&]( std::size_t c ) {
+            for( auto i = bases[c].triangles * 3u; i < bases[c + 1u].triangles * 3u; i++ )
+            {
+                const auto& corner = arrays.corners[i];
+                auto& v = mesh.vertices[i];
+                v = {};
+                std::memcpy( v.position,&arrays.positions[std::size_t( corner.position ) * 3u],sizeof( v.position ) );
+                if( corner.normal != noIndex )
+                {
+                    std::memcpy( v.normal,&arrays.normals[std::size_t( corner.normal ) * 3u],sizeof( v.normal ) );
+                }
+                if( corner.texCoord != noIndex )
+                {
+                    std::memcpy( v.texCoord,&arrays.texCoords[std::size_t( corner.texCoord ) * 2u],sizeof( v.texCoord ) );
+                }
+                mesh.indices[i] = std::uint32_t( i );
+            }
+        } );
+    }
+    else
+    {
+        WeldCorners( arrays,mesh );
+    }
+    Finish( mesh,hasNormals,options,name );
+    return mesh;
+}
+
+MeshData MeshImporter::ImportPly( const std::byte* pData,std::size_t size,const std::string& name,
+    const MeshImportOptions& options,ThreadPool* pPool )
+{
+    const auto pFile = reinterpret_cast<const char*>( pData );
+    const auto pEnd = pFile + size;
+    if( size < 4u || std::memcmp( pFile,"ply",3u ) != 0 )
+    {
+        throw MESH_EXCEPT( "Not a PLY file" );
+    }
+    // 头是一行一条的文本，到 end_header 为止
+    PlyFormat format = PlyFormat::Ascii;
+    bool formatSeen = false;
+    std::vector<PlyElement> elements;
+    const char* pBody = nullptr;
+    for( auto p = LineEnd( pFile,pEnd ) + 1; p < pEnd; )
+    {
+        const auto lineEnd = LineEnd( p,pEnd );
+        std::vector<std::string> tokens;
+        for( auto q = SkipSpaces( p,lineEnd ); q < lineEnd; q = SkipSpaces( q,lineEnd ) )
+        {
+            const auto tokenBegin = q;
+            while( q < lineEnd && !IsSpace( *q ) )
+            {
+                q++;
+            }
+            tokens.emplace_back( tokenBegin,q );
+        }
+        p = lineEnd + 1;
+        if( tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info" )
+        {
+            continue;
+        }
+        if( tokens[0] == "end_header" )
+        {
+            pBody = std::min( p,pEnd );
+            break;
+        }
+        if( tokens[0] == "format" && tokens.size() >= 2u )
+        {
+            if( tokens[1] == "ascii" )
+            {
+                format = PlyFormat::Ascii;
+            }
+            else if( tokens[1] == "binary_little_endian" )
+            {
+                format = PlyFormat::BinaryLittleEndian;
+            }
+            else if( tokens[1] == "binary_big_endian" )
+            {
+                format = PlyFormat::BinaryBigEndian;
+            }
+            else
+            {
+                throw MESH_EXCEPT( "Unknown PLY format " + tokens[1] );
+            }
+            formatSeen = true;
+        }
+        else if( tokens[0] == "element" && tokens.size() >= 3u )
+        {
+            elements.push_back( { tokens[1],std::size_t( std::stoull( tokens[2] ) ),{} } );
+        }
+        else if( tokens[0] == "property" && !elements.empty() )
+        {
+            PlyProperty property = {};
+            if( tokens.size() >= 5u && tokens[1] == "list" )
+            {
+                property.isList = true;
+                if( !ParsePlyType( tokens[2],property.countType ) || !ParsePlyType( tokens[3],property.type ) )
+                {
+                    throw MESH_EXCEPT( "Unknown PLY property type in list " + tokens[4] );
+                }
+                property.name = tokens[4];
+            }
+            else if( tokens.size() >= 3u && ParsePlyType( tokens[1],property.type ) )
+            {
+                property.name = tokens[2];
+            }
+            else
+            {
+                throw MESH_EXCEPT( "Malformed PLY property declaration" );
+            }
+            elements.back().properties.push_back( std::move( property ) );
+        }
+        else
+        {
+            throw MESH_EXCEPT( "Unknown PLY header line starting with " + tokens[0] );
+        }
+    }
+    if( pBody == nullptr || !formatSeen )
+    {
+        throw MESH_EXCEPT( "PLY header is incomplete" );
+    }
+
+    MeshData mesh;
+    bool hasNormals = false;
+    if( format == PlyFormat::Ascii )
+    {
+        ParsePlyAscii( pBody,pEnd,elements,mesh,hasNormals,pPool,name );
+    }
+    else
+    {
+        // 只在小端机器上运行（x86 / ARM Windows），大端文件逐个值交换字节
+        ParsePlyBinary( reinterpret_cast<const std::byte*>( pBody ),pData + size,elements,
+            format == PlyFormat::BinaryBigEndian,mesh,hasNormals,pPool,name );
+    }
+    if( options.weld )
+    {
+        mesh.Weld();
+    }
+    Finish( mesh,hasNormals,options,name );
+    return mesh;
+}
+
+MeshData MeshImporter::Import( const std::byte* pData,std::size_t size,const std::string& name,
+    const MeshImportOptions& options,ThreadPool* pPool )
+{
+    if( size >= 3u && std::memcmp( pData,"ply",3u ) == 0 )
+    {
+        return ImportPly( pData,size,name,options,pPool );
+    }
+    return ImportObj( pData,size,name,options,pPool );
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "MeshData.h"
+#include <cstddef>
+#include <string>
+
+class ThreadPool;
+
+struct MeshImportOptions
+{
+    // 相同的顶点合并：OBJ 按 (位置, 纹理坐标, 法线) 的下标组合，PLY 按顶点内容；关掉时 OBJ 每个角一个顶点
+    bool weld = true;
+    // 文件里没有法线时按面积加权生成
+    bool generateNormals = true;
+    // OBJ / PLY 是右手系、逆时针为正面、v 向上；转成 D3D 的左手系（z 取反）、顺时针、v 向下
+    bool convertToLeftHanded = true;
+};
+
+// OBJ / PLY 导入，解析内存里的文件内容（通常是 MappedFile 映射出来的），纯 CPU，可以在任意线程调用。
+// 给了线程池时按行切块并行解析：先数出每块的顶点和三角形数，前缀和之后各块直接写进最终数组的对应位置；
+// pPool 为 nullptr 时同样的代码在当前线程顺序执行（基准里的单线程对照）。出错时抛 MeshException
+namespace MeshImporter
+{
+    // v / vt / vn / f（任意多边形按扇形三角化，支持负下标），忽略其他语句和材质
+    MeshData ImportObj( const std::byte* pData,std::size_t size,const std::string& name,
+        const MeshImportOptions& options = {},ThreadPool* pPool = nullptr );
+    // ascii、binary_little_endian、binary_big_endian；vertex 元素的 x y z / nx ny nz / u v（或 s t），
+    // face 元素的 vertex_indices（vertex_index）列表，其他元素和属性跳过
+    MeshData ImportPly( const std::byte* pData,std::size_t size,const std::string& name,
+        const MeshImportOptions& options = {},ThreadPool* pPool = nullptr );
+    // 以 "ply" 开头的当 PLY，其余当 OBJ
+    MeshData Import( const std::byte* pData,std::size_t size,const std::string& name,
+        const MeshImportOptions& options = {},ThreadPool* pPool = nullptr );
+    // 十进制浮点数，整数和小数部分每次 8 位数字用 SWAR（一个 64 位寄存器当 8 路 SIMD）换算；
+    // 成功时 p 移到数字之后。结果和 strtof 最多差 1 ulp（超过 19 位有效数字或指数很大时退回 strtod，结果相同）
+    bool ParseFloat( const char*& p,const char* end,float& value ) noexcept;
+}
@@ -0,0 +1,790 @@
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    constexpr auto invalid = std::numeric_limits<std::uint32_t>::max();
+    constexpr std::size_t attributeCount = 5u;
+    // 非锁定边界上的约束平面相对三角形平面的权重
+    constexpr float borderWeight = 10.0f;
+    constexpr unsigned int maxPasses = 100u;
+
+    void Cross( const float* a,const float* b,float* out ) noexcept
+    {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    float Dot( const float* a,const float* b ) noexcept
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // Q(p) = p'Ap + 2b·p + c，平面按面积加权累加；Evaluate 除以总权重，得到到各平面距离平方的加权平均
+    struct Quadric
+    {
+        float a00 = 0.0f,a11 = 0.0f,a22 = 0.0f,a01 = 0.0f,a02 = 0.0f,a12 = 0.0f;
+        float b0 = 0.0f,b1 = 0.0f,b2 = 0.0f;
+        float c = 0.0f;
+        float w = 0.0f;
+        // n 是单位法线，平面是 n·p + d = 0
+        void AddPlane( const float* n,float d,float weight ) noexcept
+        {
+            a00 += weight * n[0] * n[0];
+            a11 += weight * n[1] * n[1];
+            a22 += weight * n[2] * n[2];
+            a01 += weight * n[0] * n[1];
+            a02 += weight * n[0] * n[2];
+            a12 += weight * n[1] * n[2];
+            b0 += weight * n[0] * d;
+            b1 += weight * n[1] * d;
+            b2 += weight * n[2] * d;
+            c += weight * d * d;
+            w += weight;
+        }
+        void Add( const Quadric& q ) noexcept
+        {
+            a00 += q.a00; a11 += q.a11; a22 += q.a22;
+            a01 += q.a01; a02 += q.a02; a12 += q.a12;
+            b0 += q.b0; b1 += q.b1; b2 += q.b2;
+            c += q.c;
+            w += q.w;
+        }
+        float Evaluate( const float* p ) const noexcept
+        {
+            const auto r = a00 * p[0] * p[0] + a11 * p[1] * p[1] + a22 * p[2] * p[2] +
+                2.0f * ( a01 * p[0] * p[1] + a02 * p[0] * p[2] + a12 * p[1] * p[2] ) +
+                2.0f * ( b0 * p[0] + b1 * p[1] + b2 * p[2] ) + c;
+            // 浮点抵消可能得到很小的负数
+            return w > 0.0f ? std::fabs( r ) / w : 0.0f;
+        }
+    };
+
+    // 属性空间里的点二次误差：并进这个顶点的所有原始顶点的属性和 a 的距离平方的加权平均
+    struct AttributeQuadric
+    {
+        float s[attributeCount] = {};
+        float ss = 0.0f;
+        float w = 0.0f;
+        void AddPoint( const float* a,float weight ) noexcept
+        {
+            for( std::size_t k = 0u; k < attributeCount; k++ )
+            {
+                s[k] += weight * a[k];
+                ss += weight * a[k] * a[k];
+            }
+            w += weight;
+        }
+        void Add( const AttributeQuadric& q ) noexcept
+        {
+            for( std::size_t k = 0u; k < attributeCount; k++ )
+            {
+                s[k] += q.s[k];
+            }
+            ss += q.ss;
+            w += q.w;
+        }
+        float Evaluate( const float* a ) const noexcept
+        {
+            auto r = ss;
+            for( std::size_t k = 0u; k < attributeCount; k++ )
+            {
+                r += w * a[k] * a[k] - 2.0f * a[k] * s[k];
+            }
+            return w > 0.0f ? std::fabs( r ) / w : 0.0f;
+        }
+    };
+
+    enum class VertexKind : unsigned char
+    {
+        Manifold,
+        // 开放边界上，只能沿边界折叠（lockBorder 时当作 Locked）
+        Border,
+        // 位置相同、属性不同的一对顶点之一，只能沿接缝和另一侧一起折叠
+        Seam,
+        Locked,
+    };
+
+    struct Collapse
+    {
+        std::uint32_t from;
+        std::uint32_t to;
+        // 排序用：几何误差 + 属性误差
+        float cost;
+        // 几何误差（距离的平方）
+        float error;
+    };
+
+    // 构造时分类顶点、建初始的二次误差；Run 修改自己的副本，所以 BuildLods 每一级拷贝一份
+    class Simplifier
+    {
+    public:
+        Simplifier( const MeshData& mesh,const MeshSimplifyOptions& options )
+            :
+            options( options ),
+            indices( mesh.indices )
+        {
+            const auto vertexCount = mesh.vertices.size();
+            // 归一化到最长边为 1，误差直接是相对值
+            float extent = 0.0f;
+            for( int c = 0; c < 3; c++ )
+            {
+                extent = std::max( extent,mesh.boundsMax[c] - mesh.boundsMin[c] );
+            }
+            if( extent <= 0.0f )
+            {
+                // 调用方没算包围盒
+                float lo[3] = { 0.0f,0.0f,0.0f };
+                float hi[3] = { 0.0f,0.0f,0.0f };
+                for( std::size_t v = 0u; v < vertexCount; v++ )
+                {
+                    for( int c = 0; c < 3; c++ )
+                    {
+                        lo[c] = v == 0u ? mesh.vertices[v].position[c] : std::min( lo[c],mesh.vertices[v].position[c] );
+                        hi[c] = v == 0u ? mesh.vertices[v].position[c] : std::max( hi[c],mesh.vertices[v].position[c] );
+                    }
+                }
+                for( int c = 0; c < 3; c++ )
+                {
+                    extent = std::max( extent,hi[c] - lo[c] );
+                }
+            }
+            const auto scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+            positions.resize( vertexCount * 3u );
+            attributes.resize( vertexCount * attributeCount );
+            for( std::size_t v = 0u; v < vertexCount; v++ )
+            {
+                const auto& vertex = mesh.vertices[v];
+                for( int c = 0; c < 3; c++ )
+                {
+                    positions[v * 3u + c] = ( vertex.position[c] - mesh.boundsMin[c] ) * scale;
+                    attributes[v * attributeCount + c] = vertex.normal[c] * options.normalWeight;
+                }
+                attributes[v * attributeCount + 3u] = vertex.texCoord[0] * options.texCoordWeight;
+                attributes[v * attributeCount + 4u] = vertex.texCoord[1] * options.texCoordWeight;
+            }
+            BuildClasses( mesh );
+            BuildAdjacency();
+            Classify();
+            BuildQuadrics();
+        }
+        MeshLod Run( std::size_t targetTriangles )
+        {
+            float maxError = 0.0f;
+            const auto errorLimit = options.maxError * options.maxError;
+            std::vector<Collapse> candidates;
+            std::vector<Collapse> sorted;
+            for( unsigned int pass = 0u; pass < maxPasses && liveTriangles > targetTriangles; pass++ )
+            {
+                Compact();
+                BuildAdjacency();
+                CollectCandidates( candidates,errorLimit );
+                if( candidates.empty() )
+                {
+                    break;
+                }
+                SortByCost( candidates,sorted );
+                // 一轮只做代价最低的一批：大约够到目标所需的折叠数（每次少两个三角形），代价上限再放宽一半，
+                // 免得一轮里把贵的边也折了，而下一轮本来有更便宜的
+                const auto goal = std::min( sorted.size(),( liveTriangles - targetTriangles ) / 2u + 1u );
+                const auto costLimit = sorted[goal - 1u].cost * 1.5f;
+                std::fill( touched.begin(),touched.end(),false );
+                std::size_t collapses = 0u;
+                for( const auto& candidate : sorted )
+                {
+                    if( candidate.cost > costLimit || liveTriangles <= targetTriangles )
+                    {
+                        break;
+                    }
+                    if( TryCollapse( candidate ) )
+                    {
+                        maxError = std::max( maxError,candidate.error );
+                        collapses++;
+                    }
+                }
+                if( collapses == 0u )
+                {
+                    break;
+                }
+            }
+            Compact();
+            MeshLod lod;
+            lod.indices = std::move( indices );
+            lod.error = std::sqrt( maxError );
+            return lod;
+        }
+    private:
+        // 位置逐位相同的顶点归为一类，sibling 把同一类的顶点串成环
+        void BuildClasses( const MeshData& mesh )
+        {
+            const auto vertexCount = mesh.vertices.size();
+            std::size_t capacity = 16u;
+            while( capacity < vertexCount * 2u )
+            {
+                capacity *= 2u;
+            }
+            std::vector<std::uint32_t> table( capacity,invalid );
+            classOf.assign( vertexCount,invalid );
+            sibling.resize( vertexCount );
+            std::vector<std::uint32_t> classFirst;
+            for( std::size_t v = 0u; v < vertexCount; v++ )
+            {
+                const auto& p = mesh.vertices[v].position;
+                std::uint32_t words[3];
+                std::memcpy( words,p,sizeof( words ) );
+                std::uint64_t hash = 0xCBF29CE484222325u;
+                for( const auto w : words )
+                {
+                    hash = ( hash ^ w ) * 0x100000001B3u;
+                }
+                auto slot = std::size_t( hash ^ ( hash >> 32u ) ) & ( capacity - 1u );
+                while( table[slot] != invalid && std::memcmp( mesh.vertices[table[slot]].position,p,sizeof( words ) ) != 0 )
+                {
+                    slot = ( slot + 1u ) & ( capacity - 1u );
+                }
+                if( table[slot] == invalid )
+                {
+                    table[slot] = std::uint32_t( v );
+                    classOf[v] = std::uint32_t( classFirst.size() );
+                    classFirst.push_back( std::uint32_t( v ) );
+                    sibling[v] = std::uint32_t( v );
+                }
+                else
+                {
+                    // 插到环里第一个顶点后面
+                    const auto first = table[slot];
+                    classOf[v] = classOf[first];
+                    sibling[v] = sibling[first];
+                    sibling[first] = std::uint32_t( v );
+                }
+            }
+            classCount = classFirst.size();
+            touched.assign( classCount,false );
+        }
+        // 每个顶点所在的活三角形，CSR 存储
+        void BuildAdjacency()
+        {
+            const auto vertexCount = classOf.size();
+            adjacencyOffsets.assign( vertexCount + 1u,0u );
+            for( const auto index : indices )
+            {
+                adjacencyOffsets[index + 1u]++;
+            }
+            for( std::size_t v = 0u; v < vertexCount; v++ )
+            {
+                adjacencyOffsets[v + 1u] += adjacencyOffsets[v];
+            }
+            adjacency.resize( indices.size() );
+            std::vector<std::uint32_t> cursor( adjacencyOffsets.begin(),adjacencyOffsets.end() - 1 );
+            for( std::size_t i = 0u; i < indices.size(); i++ )
+            {
+                adjacency[cursor[indices[i]]++] = std::uint32_t( i / 3u );
+            }
+        }
+        bool IsLive( std::uint32_t t ) const noexcept
+        {
+            return indices[t * 3u] != indices[t * 3u + 1u];
+        }
+        // 活三角形里有多少条 a -> b 的有向边
+        std::size_t CountEdges( std::uint32_t a,std::uint32_t b ) const noexcept
+        {
+            std::size_t count = 0u;
+            for( auto i = adjacencyOffsets[a]; i < adjacencyOffsets[a + 1u]; i++ )
+            {
+                const auto t = adjacency[i];
+                for( std::size_t k = 0u; k < 3u && IsLive( t ); k++ )
+                {
+                    if( indices[t * 3u + k] == a && indices[t * 3u + ( k + 1u ) % 3u] == b )
+                    {
+                        count++;
+                    }
+                }
+            }
+            return count;
+        }
+        // 按位置类算的 a -> b 有向边数
+        std::size_t CountClassEdges( std::uint32_t a,std::uint32_t b ) const noexcept
+        {
+            std::size_t count = 0u;
+            auto u = a;
+            do
+            {
+                for( auto i = adjacencyOffsets[u]; i < adjacencyOffsets[u + 1u]; i++ )
+                {
+                    const auto t = adjacency[i];
+                    for( std::size_t k = 0u; k < 3u; k++ )
+                    {
+                        if( indices[t * 3u + k] == u && classOf[indices[t * 3u + ( k + 1u ) % 3u]] == classOf[b] )
+                        {
+                            count++;
+                        }
+                    }
+                }
+                u = sibling[u];
+            } while( u != a );
+            return count;
+        }
+        std::size_t ClassSize( std::uint32_t v ) const noexcept
+        {
+            std::size_t size = 1u;
+            for( auto u = sibling[v]; u != v; u = sibling[u] )
+            {
+                size++;
+            }
+            return size;
+        }
+        void Classify()
+        {
+            const auto vertexCount = classOf.size();
+            std::vector<bool> border( classCount,false );
+            std::vector<bool> complex( classCount,false );
+            std::vector<bool> seam( vertexCount,false );
+            // 边界上的前一个 / 后一个顶点；不止一个时记成自己
+            std::vector<std::uint32_t> borderIn( vertexCount,invalid );
+            std::vector<std::uint32_t> borderOut( vertexCount,invalid );
+            borderEdges.clear();
+            for( std::size_t i = 0u; i < indices.size(); i++ )
+            {
+                const auto a = indices[i];
+                const auto b = indices[i - i % 3u + ( i + 1u ) % 3u];
+                const auto forward = CountClassEdges( a,b );
+                const auto backward = CountClassEdges( b,a );
+                if( forward > 1u || backward > 1u )
+                {
+                    // 非流形边，或者同一条边上两个三角形方向不一致
+                    complex[classOf[a]] = complex[classOf[b]] = true;
+                }
+                else if( backward == 0u )
+                {
+                    border[classOf[a]] = border[classOf[b]] = true;
+                    borderEdges.push_back( std::uint32_t( i ) );
+                    borderOut[a] = borderOut[a] == invalid ? b : a;
+                    borderIn[b] = borderIn[b] == invalid ? a : b;
+                }
+                else if( CountEdges( b,a ) == 0u )
+                {
+                    seam[a] = seam[b] = true;
+                }
+            }
+            kinds.resize( vertexCount );
+            for( std::size_t v = 0u; v < vertexCount; v++ )
+            {
+                const auto c = classOf[v];
+                const auto size = ClassSize( std::uint32_t( v ) );
+                auto kind = VertexKind::Locked;
+                if( complex[c] )
+                {
+                    kind = VertexKind::Locked;
+                }
+                else if( size == 1u && border[c] )
+                {
+                    kind = !options.lockBorder && IsSmoothBorder( std::uint32_t( v ),borderIn[v],borderOut[v] ) ?
+                        VertexKind::Border : VertexKind::Locked;
+                }
+                else if( size == 1u )
+                {
+                    kind = seam[v] ? VertexKind::Locked : VertexKind::Manifold;
+                }
+                else if( size == 2u && !border[c] && seam[v] )
+                {
+                    kind = VertexKind::Seam;
+                }
+                kinds[v] = kind;
+            }
+        }
+        // 边界从 in 经过 v 到 out，转角不超过约 45 度；角上的顶点挪开以后轮廓就变了，
+        // 可只靠二次误差挡不住：两个边界平面的误差被周围三角形的权重平均掉了
+        bool IsSmoothBorder( std::uint32_t v,std::uint32_t in,std::uint32_t out ) const noexcept
+        {
+            if( in == invalid || out == invalid || in == v || out == v )
+            {
+                return false;
+            }
+            const auto p = &positions[v * 3u];
+            const auto pIn = &positions[in * 3u];
+            const auto pOut = &positions[out * 3u];
+            const float e0[3] = { p[0] - pIn[0],p[1] - pIn[1],p[2] - pIn[2] };
+            const float e1[3] = { pOut[0] - p[0],pOut[1] - p[1],pOut[2] - p[2] };
+            return Dot( e0,e1 ) > 0.7f * std::sqrt( Dot( e0,e0 ) * Dot( e1,e1 ) );
+        }
+        void BuildQuadrics()
+        {
+            quadrics.assign( classCount,Quadric{} );
+            attributeQuadrics.assign( classOf.size(),AttributeQuadric{} );
+            for( std::size_t t = 0u; t * 3u < indices.size(); t++ )
+            {
+                const auto i0 = indices[t * 3u];
+                const auto i1 = indices[t * 3u + 1u];
+                const auto i2 = indices[t * 3u + 2u];
+                const auto p0 = &positions[i0 * 3u];
+                float n[3];
+                TriangleNormal( i0,i1,i2,n );
+                const auto length = std::sqrt( Dot( n,n ) );
+                if( length <= 0.0f )
+                {
+                    continue;
+                }
+                const float unit[3] = { n[0] / length,n[1] / length,n[2] / length };
+                const auto area = length * 0.5f;
+                for( const auto v : { i0,i1,i2 } )
+                {
+                    quadrics[classOf[v]].AddPlane( unit,-Dot( unit,p0 ),area );
+                    attributeQuadrics[v].AddPoint( &attributes[v * attributeCount],area / 3.0f );
+                }
+            }
+            if( options.lockBorder )
+            {
+                return;
+            }
+            // 过边界边、垂直于三角形的平面：边界顶点离开边界的代价很高
+            for( const auto i : borderEdges )
+            {
+                const auto t = i / 3u;
+                const auto a = indices[i];
+                const auto b = indices[t * 3u + ( i + 1u ) % 3u];
+                float n[3];
+                TriangleNormal( indices[t * 3u],indices[t * 3u + 1u],indices[t * 3u + 2u],n );
+                const auto pa = &positions[a * 3u];
+                const auto pb = &positions[b * 3u];
+                const float edge[3] = { pb[0] - pa[0],pb[1] - pa[1],pb[2] - pa[2] };
+                float m[3];
+                Cross( edge,n,m );
+                const auto length = std::sqrt( Dot( m,m ) );
+                if( length <= 0.0f )
+                {
+                    continue;
+                }
+                const float unit[3] = { m[0] / length,m[1] / length,m[2] / length };
+                const auto weight = Dot( edge,edge ) * borderWeight;
+                quadrics[classOf[a]].AddPlane( unit,-Dot( unit,pa ),weight );
+                quadrics[classOf[b]].AddPlane( unit,-Dot( unit,pa ),weight );
+            }
+        }
+        void TriangleNormal( std::uint32_t i0,std::uint32_t i1,std::uint32_t i2,float* n ) const noexcept
+        {
+            const auto p0 = &positions[i0 * 3u];
+            const auto p1 = &positions[i1 * 3u];
+            const auto p2 = &positions[i2 * 3u];
+            const float e0[3] = { p1[0] - p0[0],p1[1] - p0[1],p1[2] - p0[2] };
+            const float e1[3] = { p2[0] - p0[0],p2[1] - p0[1],p2[2] - p0[2] };
+            Cross( e0,e1,n );
+        }
+        // 接缝另一侧和 v 位置相同的顶点
+        std::uint32_t Twin( std::uint32_t v ) const noexcept
+        {
+            return sibling[v];
+        }
+        bool SharesTriangle( std::uint32_t a,std::uint32_t b ) const noexcept
+        {
+            for( auto i = adjacencyOffsets[a]; i < adjacencyOffsets[a + 1u]; i++ )
+            {
+                const auto t = adjacency[i];
+                if( IsLive( t ) && ( indices[t * 3u] == b || indices[t * 3u + 1u] == b || indices[t * 3u + 2u] == b ) )
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        // from -> to 是否允许，允许时算代价
+        bool Evaluate( std::uint32_t from,std::uint32_t to,Collapse& out ) const noexcept
+        {
+            const auto kindFrom = kinds[from];
+            const auto kindTo = kinds[to];
+            if( classOf[from] == classOf[to] )
+            {
+                return false;
+            }
+            auto attributeCost = attributeQuadrics[from].Evaluate( &attributes[to * attributeCount] );
+            switch( kindFrom )
+            {
+            case VertexKind::Manifold:
+                break;
+            case VertexKind::Border:
+                // 只能沿边界边，边界才不会缩进去
+                if( ( kindTo != VertexKind::Border && kindTo != VertexKind::Locked ) ||
+                    CountEdges( from,to ) + CountEdges( to,from ) != 1u )
+                {
+                    return false;
+                }
+                break;
+            case VertexKind::Seam:
+            {
+                // 两侧的边都要在：from-to 和 twin(from)-twin(to) 各属于接缝一侧
+                if( kindTo != VertexKind::Seam || !SharesTriangle( Twin( from ),Twin( to ) ) )
+                {
+                    return false;
+                }
+                attributeCost += attributeQuadrics[Twin( from )].Evaluate( &attributes[Twin( to ) * attributeCount] );
+                break;
+            }
+            default:
+                return false;
+            }
+            const auto error = quadrics[classOf[from]].Evaluate( &positions[to * 3u] );
+            out = { from,to,error + attributeCost,error };
+            return true;
+        }
+        // 按代价的浮点数高 11 位（指数和 3 位尾数）做一趟计数排序：同一个桶里的代价相差不到 12.5%，
+        // 顺序无所谓，比 std::sort 快得多（候选的数量是三角形数的 1.5 倍，每轮都要排）
+        static void SortByCost( const std::vector<Collapse>& candidates,std::vector<Collapse>& sorted )
+        {
+            constexpr std::size_t buckets = 2048u;
+            const auto key = []( float cost ) {
+                std::uint32_t bits;
+                std::memcpy( &bits,&cost,4u );
+                // 代价非负，符号位是 0
+                return std::size_t( bits >> 20u ) & ( buckets - 1u );
+            };
+            std::size_t offsets[buckets + 1u] = {};
+            for( const auto& c : candidates )
+            {
+                offsets[key( c.cost ) + 1u]++;
+            }
+            for( std::size_t b = 0u; b < buckets; b++ )
+            {
+                offsets[b + 1u] += offsets[b];
+            }
+            sorted.resize( candidates.size() );
+            for( const auto& c : candidates )
+            {
+                sorted[offsets[key( c.cost )]++] = c;
+            }
+        }
+        void CollectCandidates( std::vector<Collapse>& candidates,float errorLimit ) const
+        {
+            candidates.clear();
+            for( std::size_t i = 0u; i < indices.size(); i++ )
+            {
+                const auto a = indices[i];
+                const auto b = indices[i - i % 3u + ( i + 1u ) % 3u];
+                // 碰到普通顶点的边肯定还有反向的那一半，只从 a < b 的那个三角形取；
+                // 其余的边可能从两个三角形各来一次，重复的在 TryCollapse 里被 touched 挡掉
+                if( a > b && ( kinds[a] == VertexKind::Manifold || kinds[b] == VertexKind::Manifold ) )
+                {
+                    continue;
+                }
+                // 两个方向取便宜的
+                Collapse forward = {};
+                Collapse backward = {};
+                const auto canForward = Evaluate( a,b,forward );
+                const auto canBackward = Evaluate( b,a,backward );
+                if( canForward && ( !canBackward || forward.cost <= backward.cost ) )
+                {
+                    if( forward.error <= errorLimit )
+                    {
+                        candidates.push_back( forward );
+                    }
+                }
+                else if( canBackward && backward.error <= errorLimit )
+                {
+                    candidates.push_back( backward );
+                }
+            }
+        }
+        // from 周围的三角形（不含会消失的）换成 to 之后法线转过头了（超过约 75 度）
+        bool Flips( std::uint32_t from,std::uint32_t to ) const noexcept
+        {
+            const auto pTo = &positions[to * 3u];
+            for( auto i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1u]; i++ )
+            {
+                const auto t = adjacency[i];
+                if( !IsLive( t ) )
+                {
+                    continue;
+                }
+                std::size_t k = 0u;
+                while( indices[t * 3u + k] != from )
+                {
+                    k++;
+                }
+                const auto b = indices[t * 3u + ( k + 1u ) % 3u];
+                const auto c = indices[t * 3u + ( k + 2u ) % 3u];
+                if( classOf[b] == classOf[to] || classOf[c] == classOf[to] )
+                {
+                    continue;
+                }
+                float before[3];
+                TriangleNormal( from,b,c,before );
+                const auto pb = &positions[b * 3u];
+                const auto pc = &positions[c * 3u];
+                const float e0[3] = { pb[0] - pTo[0],pb[1] - pTo[1],pb[2] - pTo[2] };
+                const float e1[3] = { pc[0] - pTo[0],pc[1] - pTo[1],pc[2] - pTo[2] };
+                float after[3];
+                Cross( e0,e1,after );
+                const auto lengths = std::sqrt( Dot( before,before ) * Dot( after,after ) );
+                if( Dot( before,after ) <= 0.25f * lengths )
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        // 连接条件：from 和 to 共同的邻居只能是共享这条边的三角形的第三个顶点，否则折叠后会出现非流形的边
+        bool BreaksLink( std::uint32_t from,std::uint32_t to ) const
+        {
+            std::size_t shared = 0u;
+            const auto gather = [this]( std::uint32_t v,std::vector<std::uint32_t>& out ) {
+                out.clear();
+                for( auto i = adjacencyOffsets[v]; i < adjacencyOffsets[v + 1u]; i++ )
+                {
+                    const auto t = adjacency[i];
+                    for( std::size_t k = 0u; k < 3u && IsLive( t ); k++ )
+                    {
+                        out.push_back( classOf[indices[t * 3u + k]] );
+                    }
+                }
+                std::sort( out.begin(),out.end() );
+                out.erase( std::unique( out.begin(),out.end() ),out.end() );
+            };
+            gather( from,fromNeighbours );
+            gather( to,toNeighbours );
+            for( auto i = adjacencyOffsets[to]; i < adjacencyOffsets[to + 1u]; i++ )
+            {
+                const auto t = adjacency[i];
+                if( IsLive( t ) && ( indices[t * 3u] == from || indices[t * 3u + 1u] == from || indices[t * 3u + 2u] == from ) )
+                {
+                    shared++;
+                }
+            }
+            std::size_t common = 0u;
+            for( const auto c : fromNeighbours )
+            {
+                if( c != classOf[from] && c != classOf[to] && std::binary_search( toNeighbours.begin(),toNeighbours.end(),c ) )
+                {
+                    common++;
+                }
+            }
+            return common > shared;
+        }
+        void Redirect( std::uint32_t from,std::uint32_t to )
+        {
+            for( auto i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1u]; i++ )
+            {
+                const auto t = adjacency[i];
+                if( !IsLive( t ) )
+                {
+                    continue;
+                }
+                auto tri = &indices[t * 3u];
+                for( std::size_t k = 0u; k < 3u; k++ )
+                {
+                    if( tri[k] == from )
+                    {
+                        tri[k] = to;
+                    }
+                }
+                if( tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2] ||
+                    classOf[tri[0]] == classOf[tri[1]] || classOf[tri[1]] == classOf[tri[2]] || classOf[tri[0]] == classOf[tri[2]] )
+                {
+                    // 三个下标都一样就是死三角形（IsLive）
+                    tri[0] = tri[1] = tri[2] = to;
+                    liveTriangles--;
+                }
+            }
+        }
+        bool TryCollapse( const Collapse& collapse )
+        {
+            const auto from = collapse.from;
+            const auto to = collapse.to;
+            if( touched[classOf[from]] || touched[classOf[to]] )
+            {
+                return false;
+            }
+            const bool seam = kinds[from] == VertexKind::Seam;
+            if( Flips( from,to ) || BreaksLink( from,to ) ||
+                ( seam && Flips( Twin( from ),Twin( to ) ) ) )
+            {
+                return false;
+            }
+            quadrics[classOf[to]].Add( quadrics[classOf[from]] );
+            attributeQuadrics[to].Add( attributeQuadrics[from] );
+            Redirect( from,to );
+            if( seam )
+            {
+                attributeQuadrics[Twin( to )].Add( attributeQuadrics[Twin( from )] );
+                Redirect( Twin( from ),Twin( to ) );
+            }
+            touched[classOf[from]] = true;
+            touched[classOf[to]] = true;
+            return true;
+        }
+        void Compact()
+        {
+            std::size_t live = 0u;
+            for( std::size_t t = 0u; t * 3u < indices.size(); t++ )
+            {
+                if( IsLive( std::uint32_t( t ) ) )
+                {
+                    std::copy_n( &indices[t * 3u],3u,&indices[live * 3u] );
+                    live++;
+                }
+            }
+            indices.resize( live * 3u );
+            liveTriangles = live;
+        }
+    private:
+        MeshSimplifyOptions options;
+        std::vector<std::uint32_t> indices;
+        std::size_t liveTriangles = indices.size() / 3u;
+        // 归一化的位置，每个顶点 3 个
+        std::vector<float> positions;
+        // 乘过权重的法线和纹理坐标，每个顶点 attributeCount 个
+        std::vector<float> attributes;
+        std::vector<std::uint32_t> classOf;
+        std::vector<std::uint32_t> sibling;
+        std::size_t classCount = 0u;
+        std::vector<VertexKind> kinds;
+        // 按位置类
+        std::vector<Quadric> quadrics;
+        // 按顶点
+        std::vector<AttributeQuadric> attributeQuadrics;
+        // 开放的边（indices 里边起点的下标），只在不锁边界时给二次误差加约束平面
+        std::vector<std::uint32_t> borderEdges;
+        std::vector<std::uint32_t> adjacencyOffsets;
+        std::vector<std::uint32_t> adjacency;
+        // 这一轮折叠过的位置类，一轮里每个顶点只参与一次折叠，候选的代价就不会过时
+        std::vector<bool> touched;
+        // BreaksLink 的临时数组
+        mutable std::vector<std::uint32_t> fromNeighbours;
+        mutable std::vector<std::uint32_t> toNeighbours;
+    };
+}
+
+MeshLod MeshSimplifier::Simplify( const MeshData& mesh,std::size_t targetTriangles,const MeshSimplifyOptions& options )
+{
+    return Simplifier( mesh,options ).Run( targetTriangles );
+}
+
+void MeshSimplifier::BuildLods( MeshData& mesh,const std::vector<float>& ratios,const MeshSimplifyOptions& options,
+    ThreadPool* pPool )
+{
+    mesh.lods.clear();
+    if( ratios.empty() || mesh.indices.empty() )
+    {
+        return;
+    }
+    // 分类和初始误差只算一次，每一级拷一份去折叠
+    const Simplifier base( mesh,options );
+    std::vector<MeshLod> levels( ratios.size() );
+    RunTasks( pPool,ratios.size(),[&]( std::size_t i ) {
+        auto simplifier = base;
+        const auto target = std::size_t( double( mesh.GetTriangleCount() ) * std::max( 0.0f,ratios[i] ) );
+        levels[i] = simplifier.Run( target );
+    } );
+    auto previous = mesh.GetTriangleCount();
+    for( auto& level : levels )
+    {
+        if( level.GetTriangleCount() < previous - previous / 10u )
+        {
+            previous = level.GetTriangleCount();
+            mesh.lods.push_back( std::move( level ) );
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "MeshData.h"
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+struct MeshSimplifyOptions
+{
+    // 误差（相对包围盒最长边）超过这个值就停，哪怕还没到目标三角形数
+    float maxError = 0.02f;
+    // 开放边界上的顶点不动：拼在一起的网格之间不会裂开，轮廓也不会缩进去
+    bool lockBorder = true;
+    // 法线 / 纹理坐标的偏差折算成距离的权重，0 时只看几何
+    float normalWeight = 0.5f;
+    float texCoordWeight = 1.0f;
+};
+
+// 二次误差度量（Garland-Heckbert）的网格简化，导入时生成 LOD 用；纯 CPU，可以在任意线程调用。
+// 只做半边折叠（把一个顶点并到相邻的顶点上），不产生新顶点，所以各级 LOD 和原网格共用一个顶点缓冲，
+// 属性原样保留；折叠的先后按位置误差加上属性空间里的误差排序。
+// 纹理接缝 / 硬边（位置相同、属性不同的一对顶点）只能沿接缝两侧一起折叠，接缝不会被撕开；
+// 三个以上顶点共享一个位置、非流形边上的顶点不动。每一轮给所有边算代价、排序，互不相邻的折叠一起做
+namespace MeshSimplifier
+{
+    // 简化到 targetTriangles 个三角形或者 options.maxError，先到哪个算哪个
+    MeshLod Simplify( const MeshData& mesh,std::size_t targetTriangles,const MeshSimplifyOptions& options = {} );
+    // 每个 ratio（占原网格三角形数的比例，从大到小）一级，都从原网格简化，给了线程池时各级并行；
+    // 比上一级少不到 10% 三角形的级别（比例 >= 1，或者被 maxError 挡住）不要。结果覆盖 mesh.lods
+    void BuildLods( MeshData& mesh,const std::vector<float>& ratios,const MeshSimplifyOptions& options = {},
+        ThreadPool* pPool = nullptr );
+}
@@ -0,0 +1,296 @@
+#include "MeshletBuilder.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr auto invalid = std::numeric_limits<std::uint32_t>::max();
+    // 法线和锥轴夹角的余弦最小值不超过它时锥太宽，几乎剔不掉什么，不做背面剔除
+    constexpr float minConeDot = 0.1f;
+
+    // 锥的余量：cutoff 加上它、锥顶再往后退 radius 乘它。法线在 double 里算也还有 float 的顶点位置和
+    // IsVisible 里 float 的点积误差，近乎平的簇（地形）锥很窄，擦边的三角形会被错剔，留一点余量保证只多画不少画
+    constexpr double coneEpsilon = 1e-3;
+
+    template<typename T>
+    void Cross( const T* a,const T* b,T* out ) noexcept
+    {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    template<typename T>
+    T Dot( const T* a,const T* b ) noexcept
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // 返回原来的长度，长度为 0 时不动
+    template<typename T>
+    T Normalize( T* v ) noexcept
+    {
+        const auto length = std::sqrt( Dot( v,v ) );
+        if( length > T( 0 ) )
+        {
+            v[0] /= length;
+            v[1] /= length;
+            v[2] /= length;
+        }
+        return length;
+    }
+
+    // 包围球（包围盒中心）和法线锥（做法同 meshoptimizer 的 computeClusterBounds）。
+    // 锥按三角形在 double 里重新算的法线求，再加上 coneEpsilon 的余量
+    void ComputeBounds( Meshlet& meshlet,const MeshData& mesh,const std::uint32_t* pIndices,
+        const std::vector<std::uint32_t>& vertices ) noexcept
+    {
+        float lo[3] = { std::numeric_limits<float>::max(),std::numeric_limits<float>::max(),std::numeric_limits<float>::max() };
+        float hi[3] = { std::numeric_limits<float>::lowest(),std::numeric_limits<float>::lowest(),std::numeric_limits<float>::lowest() };
+        for( const auto v : vertices )
+        {
+            for( int c = 0; c < 3; c++ )
+            {
+                lo[c] = std::min( lo[c],mesh.vertices[v].position[c] );
+                hi[c] = std::max( hi[c],mesh.vertices[v].position[c] );
+            }
+        }
+        float radiusSq = 0.0f;
+        for( int c = 0; c < 3; c++ )
+        {
+            meshlet.center[c] = ( lo[c] + hi[c] ) * 0.5f;
+        }
+        for( const auto v : vertices )
+        {
+            float d[3];
+            for( int c = 0; c < 3; c++ )
+            {
+                d[c] = mesh.vertices[v].position[c] - meshlet.center[c];
+            }
+            radiusSq = std::max( radiusSq,Dot( d,d ) );
+        }
+        meshlet.radius = std::sqrt( radiusSq );
+
+        const auto position = [&]( std::size_t i,double* out ) {
+            const auto& p = mesh.vertices[pIndices[i]].position;
+            out[0] = p[0];
+            out[1] = p[1];
+            out[2] = p[2];
+        };
+        // 单位法线，退化的三角形是 0
+        double normals[MeshletBuilder::maxTriangles * 3u];
+        double axis[3] = {};
+        for( std::size_t t = 0u; t < meshlet.triangleCount; t++ )
+        {
+            double a[3],b[3],c[3];
+            position( t * 3u,a );
+            position( t * 3u + 1u,b );
+            position( t * 3u + 2u,c );
+            const double ab[3] = { b[0] - a[0],b[1] - a[1],b[2] - a[2] };
+            const double ac[3] = { c[0] - a[0],c[1] - a[1],c[2] - a[2] };
+            auto* n = &normals[t * 3u];
+            Cross( ab,ac,n );
+            Normalize( n );
+            for( int k = 0; k < 3; k++ )
+            {
+                axis[k] += n[k];
+            }
+        }
+
+        // 锥轴是法线的平均方向，半角由和轴偏得最多的法线决定
+        std::copy( meshlet.center,meshlet.center + 3,meshlet.coneApex );
+        std::fill( meshlet.coneAxis,meshlet.coneAxis + 3,0.0f );
+        meshlet.coneCutoff = 2.0f;
+        if( Normalize( axis ) == 0.0 )
+        {
+            return;
+        }
+        double minDot = 1.0;
+        for( std::size_t t = 0u; t < meshlet.triangleCount; t++ )
+        {
+            const auto* n = &normals[t * 3u];
+            if( Dot( n,n ) > 0.0 )
+            {
+                minDot = std::min( minDot,Dot( n,axis ) );
+            }
+        }
+        if( minDot <= double( minConeDot ) )
+        {
+            return;
+        }
+        // 锥顶沿轴往后退，直到所有三角形的平面都在锥顶前面：从锥顶看过去全是背面时，从更远处看也是
+        const double center[3] = { meshlet.center[0],meshlet.center[1],meshlet.center[2] };
+        double maxT = 0.0;
+        for( std::size_t t = 0u; t < meshlet.triangleCount; t++ )
+        {
+            const auto* n = &normals[t * 3u];
+            if( Dot( n,n ) == 0.0 )
+            {
+                continue;
+            }
+            double p0[3];
+            position( t * 3u,p0 );
+            const double toCenter[3] = { center[0] - p0[0],center[1] - p0[1],center[2] - p0[2] };
+            maxT = std::max( maxT,Dot( toCenter,n ) / Dot( axis,n ) );
+        }
+        maxT += coneEpsilon * double( meshlet.radius );
+        for( int c = 0; c < 3; c++ )
+        {
+            meshlet.coneApex[c] = float( center[c] - axis[c] * maxT );
+            meshlet.coneAxis[c] = float( axis[c] );
+        }
+        meshlet.coneCutoff = float( std::sqrt( 1.0 - minDot * minDot ) + coneEpsilon );
+    }
+}
+
+std::vector<Meshlet> MeshletBuilder::Build( const MeshData& mesh,std::vector<std::uint32_t>& indices,const MeshletOptions& options )
+{
+    const auto triangleCount = indices.size() / 3u;
+    const auto vertexCount = mesh.vertices.size();
+    // 三角形的单位法线（退化的是 0）；左手系顺时针为正面，(b - a) x (c - a) 指向正面
+    std::vector<float> normals( triangleCount * 3u );
+    for( std::size_t t = 0u; t < triangleCount; t++ )
+    {
+        const auto& a = mesh.vertices[indices[t * 3u]].position;
+        const auto& b = mesh.vertices[indices[t * 3u + 1u]].position;
+        const auto& c = mesh.vertices[indices[t * 3u + 2u]].position;
+        const float ab[3] = { b[0] - a[0],b[1] - a[1],b[2] - a[2] };
+        const float ac[3] = { c[0] - a[0],c[1] - a[1],c[2] - a[2] };
+        Cross( ab,ac,&normals[t * 3u] );
+        Normalize( &normals[t * 3u] );
+    }
+    // 每个顶点用到的三角形；live 是其中还没分出去的个数，为 0 的顶点不用再看
+    std::vector<std::uint32_t> offsets( vertexCount + 1u,0u );
+    for( const auto v : indices )
+    {
+        offsets[v + 1u]++;
+    }
+    for( std::size_t v = 0u; v < vertexCount; v++ )
+    {
+        offsets[v + 1u] += offsets[v];
+    }
+    std::vector<std::uint32_t> adjacency( indices.size() );
+    std::vector<std::uint32_t> live( vertexCount,0u );
+    for( std::size_t i = 0u; i < indices.size(); i++ )
+    {
+        const auto v = indices[i];
+        adjacency[offsets[v] + live[v]++] = std::uint32_t( i / 3u );
+    }
+
+    std::vector<std::uint8_t> emitted( triangleCount,0u );
+    // 顶点属于哪个簇，用来判断加一个三角形要新增几个顶点
+    std::vector<std::uint32_t> owner( vertexCount,invalid );
+    std::vector<std::uint32_t> order;
+    order.reserve( triangleCount );
+    std::vector<Meshlet> meshlets;
+    std::vector<std::uint32_t> meshletVertices;
+    meshletVertices.reserve( maxVertices );
+    std::vector<std::uint32_t> reordered;
+    reordered.reserve( indices.size() );
+    std::size_t cursor = 0u;
+    while( order.size() < triangleCount )
+    {
+        // 没有相邻的三角形可加时，按原来的顺序从下一个没分出去的三角形开始新的簇（导入的网格大体上是空间连续的）
+        while( emitted[cursor] )
+        {
+            cursor++;
+        }
+        const auto id = std::uint32_t( meshlets.size() );
+        const auto first = order.size();
+        meshletVertices.clear();
+        float axis[3] = {};
+        const auto add = [&]( std::uint32_t t ) {
+            emitted[t] = 1u;
+            order.push_back( t );
+            for( std::size_t k = 0u; k < 3u; k++ )
+            {
+                const auto v = indices[t * 3u + k];
+                live[v]--;
+                if( owner[v] != id )
+                {
+                    owner[v] = id;
+                    meshletVertices.push_back( v );
+                }
+            }
+            for( std::size_t c = 0u; c < 3u; c++ )
+            {
+                axis[c] += normals[t * 3u + c];
+            }
+        };
+        add( std::uint32_t( cursor ) );
+        while( order.size() - first < maxTriangles )
+        {
+            float direction[3] = { axis[0],axis[1],axis[2] };
+            Normalize( direction );
+            auto best = invalid;
+            auto bestScore = std::numeric_limits<float>::max();
+            for( const auto v : meshletVertices )
+            {
+                if( live[v] == 0u )
+                {
+                    continue;
+                }
+                for( auto a = offsets[v]; a < offsets[v + 1u]; a++ )
+                {
+                    const auto t = adjacency[a];
+                    if( emitted[t] )
+                    {
+                        continue;
+                    }
+                    std::size_t added = 0u;
+                    for( std::size_t k = 0u; k < 3u; k++ )
+                    {
+                        added += owner[indices[t * 3u + k]] != id ? 1u : 0u;
+                    }
+                    if( meshletVertices.size() + added > maxVertices )
+                    {
+                        continue;
+                    }
+                    const auto score = float( added ) + options.coneWeight * ( 1.0f - Dot( &normals[t * 3u],direction ) );
+                    if( score < bestScore )
+                    {
+                        bestScore = score;
+                        best = t;
+                    }
+                }
+            }
+            if( best == invalid )
+            {
+                break;
+            }
+            add( best );
+        }
+
+        Meshlet meshlet = {};
+        meshlet.firstIndex = std::uint32_t( reordered.size() );
+        meshlet.triangleCount = std::uint8_t( order.size() - first );
+        meshlet.vertexCount = std::uint8_t( meshletVertices.size() );
+        for( auto i = first; i < order.size(); i++ )
+        {
+            const auto t = order[i];
+            reordered.insert( reordered.end(),indices.begin() + t * 3u,indices.begin() + t * 3u + 3u );
+        }
+        ComputeBounds( meshlet,mesh,reordered.data() + meshlet.firstIndex,meshletVertices );
+        meshlets.push_back( meshlet );
+    }
+    indices.swap( reordered );
+    return meshlets;
+}
+
+void MeshletBuilder::BuildAll( MeshData& mesh,const MeshletOptions& options,ThreadPool* pPool )
+{
+    // 第 0 个任务是原网格，各级只改自己的索引，顶点只读
+    RunTasks( pPool,mesh.lods.size() + 1u,[&]( std::size_t i ) {
+        if( i == 0u )
+        {
+            mesh.meshlets = Build( mesh,mesh.indices,options );
+        }
+        else
+        {
+            auto& lod = mesh.lods[i - 1u];
+            lod.meshlets = Build( mesh,lod.indices,options );
+        }
+    } );
+}
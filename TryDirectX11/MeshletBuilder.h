@@ -0,0 +1,27 @@
+#pragma once
+#include "MeshData.h"
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+struct MeshletOptions
+{
+    // 挑下一个三角形时，它的法线和簇的平均法线的偏差（1 - cos）折算成新增顶点数的权重：
+    // 越大簇越平、法线锥越窄（背面剔除得越多），但簇也越零碎
+    float coneWeight = 0.5f;
+};
+
+// 把三角形列表分成簇（meshlet），给 CPU 按簇做视锥和背面剔除（MeshletCulling）用；纯 CPU，可以在任意线程调用。
+// 每个簇从一个三角形开始贪心生长：每次加一个和簇共享顶点、新增顶点最少的三角形（平手时取法线和簇最接近的），
+// 直到 64 个顶点 / 124 个三角形或者没有相邻的三角形。三角形只换位置、不改顶点顺序，正反面不变
+namespace MeshletBuilder
+{
+    constexpr std::size_t maxVertices = 64u;
+    constexpr std::size_t maxTriangles = 124u;
+    // indices 原地按簇重排，返回的簇的 firstIndex 是 indices 里的下标
+    std::vector<Meshlet> Build( const MeshData& mesh,std::vector<std::uint32_t>& indices,const MeshletOptions& options = {} );
+    // 原网格和每级 LOD 各自分簇，写进 mesh.meshlets 和 lod.meshlets；给了线程池时各级并行。
+    // 要在 MeshSimplifier::BuildLods 之后调用（它会覆盖 lods）
+    void BuildAll( MeshData& mesh,const MeshletOptions& options = {},ThreadPool* pPool = nullptr );
+}
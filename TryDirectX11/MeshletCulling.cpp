@@ -0,0 +1,130 @@
+#include "MeshletCulling.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    template<typename Index>
+    std::size_t CullImpl( const Meshlet* pMeshlets,std::size_t count,const Index* pIndices,const MeshletCullView& view,
+        Index* pOut,MeshletCullStats* pStats ) noexcept
+    {
+        std::size_t written = 0u;
+        for( std::size_t i = 0u; i < count; i++ )
+        {
+            const auto& meshlet = pMeshlets[i];
+            if( !MeshletCulling::IsVisible( meshlet,view,pStats ) )
+            {
+                continue;
+            }
+            const std::size_t indexCount = meshlet.triangleCount * 3u;
+            std::memcpy( pOut + written,pIndices + meshlet.firstIndex,indexCount * sizeof( Index ) );
+            written += indexCount;
+        }
+        if( pStats )
+        {
+            pStats->meshlets += count;
+            pStats->triangles += written / 3u;
+        }
+        return written;
+    }
+}
+
+MeshletCullView MeshletCullView::FromMatrix( const float (&m)[4][4],const float (&camera)[3] ) noexcept
+{
+    MeshletCullView view;
+    // 裁剪空间的 x、y、z、w 分别是 v 和 m 的第 0、1、2、3 列的点积
+    const auto column = [&m]( int c,float* out ) {
+        for( int r = 0; r < 4; r++ )
+        {
+            out[r] = m[r][c];
+        }
+    };
+    float x[4],y[4],z[4],w[4];
+    column( 0,x );
+    column( 1,y );
+    column( 2,z );
+    column( 3,w );
+    for( int i = 0; i < 4; i++ )
+    {
+        view.planes[0][i] = w[i] + x[i];
+        view.planes[1][i] = w[i] - x[i];
+        view.planes[2][i] = w[i] + y[i];
+        view.planes[3][i] = w[i] - y[i];
+        view.planes[4][i] = z[i];
+        view.planes[5][i] = w[i] - z[i];
+    }
+    for( auto& plane : view.planes )
+    {
+        const auto length = std::sqrt( plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2] );
+        if( length > 0.0f )
+        {
+            for( auto& p : plane )
+            {
+                p /= length;
+            }
+        }
+    }
+    std::memcpy( view.camera,camera,sizeof( view.camera ) );
+    return view;
+}
+
+void MeshletCullStats::Add( const MeshletCullStats& other ) noexcept
+{
+    meshlets += other.meshlets;
+    frustumCulled += other.frustumCulled;
+    backfaceCulled += other.backfaceCulled;
+    triangles += other.triangles;
+}
+
+bool MeshletCulling::IsSphereVisible( const MeshletCullView& view,const float (&center)[3],float radius ) noexcept
+{
+    for( const auto& plane : view.planes )
+    {
+        const auto distance = plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3];
+        if( distance < -radius )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MeshletCulling::IsVisible( const Meshlet& meshlet,const MeshletCullView& view,MeshletCullStats* pStats ) noexcept
+{
+    if( !IsSphereVisible( view,meshlet.center,meshlet.radius ) )
+    {
+        if( pStats )
+        {
+            pStats->frustumCulled++;
+        }
+        return false;
+    }
+    // 从相机到锥顶的方向和锥轴足够接近（视线顺着所有法线）时，所有三角形都是背面
+    const float d[3] = {
+        meshlet.coneApex[0] - view.camera[0],
+        meshlet.coneApex[1] - view.camera[1],
+        meshlet.coneApex[2] - view.camera[2],
+    };
+    const auto dot = d[0] * meshlet.coneAxis[0] + d[1] * meshlet.coneAxis[1] + d[2] * meshlet.coneAxis[2];
+    if( dot > meshlet.coneCutoff * std::sqrt( d[0] * d[0] + d[1] * d[1] + d[2] * d[2] ) )
+    {
+        if( pStats )
+        {
+            pStats->backfaceCulled++;
+        }
+        return false;
+    }
+    return true;
+}
+
+std::size_t MeshletCulling::Cull( const Meshlet* pMeshlets,std::size_t count,const std::uint32_t* pIndices,const MeshletCullView& view,
+    std::uint32_t* pOut,MeshletCullStats* pStats ) noexcept
+{
+    return CullImpl( pMeshlets,count,pIndices,view,pOut,pStats );
+}
+
+std::size_t MeshletCulling::Cull( const Meshlet* pMeshlets,std::size_t count,const std::uint16_t* pIndices,const MeshletCullView& view,
+    std::uint16_t* pOut,MeshletCullStats* pStats ) noexcept
+{
+    return CullImpl( pMeshlets,count,pIndices,view,pOut,pStats );
+}
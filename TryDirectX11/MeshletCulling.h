@@ -0,0 +1,40 @@
+#pragma once
+#include "MeshData.h"
+#include <cstddef>
+#include <cstdint>
+
+// 模型空间里的视锥和相机位置，每个实例每帧算一次
+struct MeshletCullView
+{
+    // m 是 world * view * projection（行向量，clip = v * m，和 DirectXMath 一样），裁剪空间 z 的范围是 [0,w]；
+    // camera 是相机在模型空间的位置。平面从 m 的列里取出来再归一化，所以 world 里可以有（等比）缩放
+    static MeshletCullView FromMatrix( const float (&m)[4][4],const float (&camera)[3] ) noexcept;
+    // a x + b y + c z + d >= 0 在里面，(a,b,c) 是单位向量：左、右、下、上、近、远
+    float planes[6][4];
+    float camera[3];
+};
+
+struct MeshletCullStats
+{
+    std::size_t meshlets = 0u;
+    std::size_t frustumCulled = 0u;
+    std::size_t backfaceCulled = 0u;
+    // 剩下的三角形
+    std::size_t triangles = 0u;
+    void Add( const MeshletCullStats& other ) noexcept;
+};
+
+// 按簇的 CPU 剔除：包围球在视锥某个平面外面、或者法线锥整个背对相机的簇不要，剩下的簇的索引依次拷到 pOut，
+// 得到每帧压缩过的索引列表。pIndices 是 Meshlet::firstIndex 所指的数组（MeshletBuilder 重排过的），
+// pOut 至少要放得下所有簇的索引；返回写了多少个索引
+namespace MeshletCulling
+{
+    // 只做视锥测试：球心 center（模型空间）、半径 radius 的球和 view 的六个平面
+    bool IsSphereVisible( const MeshletCullView& view,const float (&center)[3],float radius ) noexcept;
+    bool IsVisible( const Meshlet& meshlet,const MeshletCullView& view,MeshletCullStats* pStats = nullptr ) noexcept;
+    std::size_t Cull( const Meshlet* pMeshlets,std::size_t count,const std::uint32_t* pIndices,const MeshletCullView& view,
+        std::uint32_t* pOut,MeshletCullStats* pStats = nullptr ) noexcept;
+    // 16 位索引的版本（顶点不超过 65535 个的网格）
+    std::size_t Cull( const Meshlet* pMeshlets,std::size_t count,const std::uint16_t* pIndices,const MeshletCullView& view,
+        std::uint16_t* pOut,MeshletCullStats* pStats = nullptr ) noexcept;
+}
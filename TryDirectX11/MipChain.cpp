@@ -0,0 +1,237 @@
+#include "MipChain.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+#include <vector>
+
+namespace
+{
+    struct Tables
+    {
+        // 8 位值 -> [0,1] 线性值
+        float srgbToLinear[256];
+        float unorm[256];
+        // 线性值 * 4095 -> sRGB 8 位值。4096 级在暗部的误差也不到半个 8 位台阶
+        std::uint8_t linearToSrgb[4096];
+        // Kaiser 滤波的 8 个权重，对应源像素 2x-3 .. 2x+4
+        float kaiser[8];
+        Tables() noexcept
+        {
+            for( int i = 0; i < 256; i++ )
+            {
+                const float c = float( i ) / 255.0f;
+                srgbToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow( ( c + 0.055f ) / 1.055f,2.4f );
+                unorm[i] = c;
+            }
+            for( int i = 0; i < 4096; i++ )
+            {
+                const float l = float( i ) / 4095.0f;
+                const float s = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow( l,1.0f / 2.4f ) - 0.055f;
+                linearToSrgb[i] = std::uint8_t( s * 255.0f + 0.5f );
+            }
+            // 目标像素 x 的中心在源坐标 2x+1；d 是以目标像素为单位的距离，窗口半宽 2 个目标像素，alpha = 4
+            constexpr double pi = 3.14159265358979323846;
+            constexpr double alpha = 4.0;
+            const auto besselI0 = []( double x ) noexcept {
+                double sum = 1.0;
+                double term = 1.0;
+                for( int k = 1; k < 32; k++ )
+                {
+                    term *= ( x / ( 2.0 * k ) ) * ( x / ( 2.0 * k ) );
+                    sum += term;
+                }
+                return sum;
+            };
+            double total = 0.0;
+            double w[8];
+            for( int k = 0; k < 8; k++ )
+            {
+                const double d = ( k - 3.5 ) / 2.0;
+                const double t = d / 2.0;
+                const double sinc = std::sin( pi * d ) / ( pi * d );
+                w[k] = sinc * besselI0( alpha * std::sqrt( 1.0 - t * t ) ) / besselI0( alpha );
+                total += w[k];
+            }
+            for( int k = 0; k < 8; k++ )
+            {
+                kaiser[k] = float( w[k] / total );
+            }
+        }
+    };
+
+    const Tables& GetTables() noexcept
+    {
+        static const Tables tables;
+        return tables;
+    }
+
+    // std::vector<__m128> 在 GCC 上会丢掉对齐属性，用带对齐的结构体代替
+    struct alignas( 16 ) Float4
+    {
+        float v[4];
+    };
+
+    struct Level
+    {
+        std::uint8_t* pData;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t rowPitch;
+        std::uint8_t* Row( std::uint32_t y ) const noexcept
+        {
+            return pData + std::size_t( y ) * rowPitch;
+        }
+    };
+
+    class Converter
+    {
+    public:
+        Converter( bool srgb ) noexcept
+            :
+            t( GetTables() ),
+            rgb( srgb ? t.srgbToLinear : t.unorm ),
+            srgb( srgb )
+        {}
+        __m128 Load( const std::uint8_t* px ) const noexcept
+        {
+            return _mm_setr_ps( rgb[px[0]],rgb[px[1]],rgb[px[2]],t.unorm[px[3]] );
+        }
+        void Store( std::uint8_t* px,__m128 v ) const noexcept
+        {
+            v = _mm_min_ps( _mm_max_ps( v,_mm_setzero_ps() ),_mm_set1_ps( 1.0f ) );
+            if( srgb )
+            {
+                const auto i = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( v,_mm_setr_ps( 4095.0f,4095.0f,4095.0f,255.0f ) ),_mm_set1_ps( 0.5f ) ) );
+                alignas( 16 ) std::int32_t index[4];
+                _mm_store_si128( reinterpret_cast<__m128i*>( index ),i );
+                px[0] = t.linearToSrgb[index[0]];
+                px[1] = t.linearToSrgb[index[1]];
+                px[2] = t.linearToSrgb[index[2]];
+                px[3] = std::uint8_t( index[3] );
+                return;
+            }
+            auto i = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( v,_mm_set1_ps( 255.0f ) ),_mm_set1_ps( 0.5f ) ) );
+            i = _mm_packs_epi32( i,i );
+            i = _mm_packus_epi16( i,i );
+            const auto packed = _mm_cvtsi128_si32( i );
+            std::memcpy( px,&packed,4u );
+        }
+    private:
+        const Tables& t;
+        const float* rgb;
+        bool srgb;
+    };
+
+    void DownsampleBox( const Level& src,const Level& dst,const Converter& cv ) noexcept
+    {
+        const auto quarter = _mm_set1_ps( 0.25f );
+        for( std::uint32_t y = 0u; y < dst.height; y++ )
+        {
+            // 奇数尺寸时最后一行 / 列和自己平均
+            const auto r0 = src.Row( std::min( 2u * y,src.height - 1u ) );
+            const auto r1 = src.Row( std::min( 2u * y + 1u,src.height - 1u ) );
+            const auto out = dst.Row( y );
+            for( std::uint32_t x = 0u; x < dst.width; x++ )
+            {
+                const auto x0 = std::min( 2u * x,src.width - 1u ) * 4u;
+                const auto x1 = std::min( 2u * x + 1u,src.width - 1u ) * 4u;
+                const auto sum = _mm_add_ps(
+                    _mm_add_ps( cv.Load( r0 + x0 ),cv.Load( r0 + x1 ) ),
+                    _mm_add_ps( cv.Load( r1 + x0 ),cv.Load( r1 + x1 ) ) );
+                cv.Store( out + x * 4u,_mm_mul_ps( sum,quarter ) );
+            }
+        }
+    }
+
+    // 先横向滤波再纵向。横向结果按源行缓存在 8 行的环形缓冲里，相邻两行目标像素共用 6 行
+    void DownsampleKaiser( const Level& src,const Level& dst,const Converter& cv )
+    {
+        constexpr int taps = 8;
+        const auto& w = GetTables().kaiser;
+        __m128 weights[taps];
+        for( int k = 0; k < taps; k++ )
+        {
+            weights[k] = _mm_set1_ps( w[k] );
+        }
+        std::vector<Float4> linearRow( src.width );
+        std::vector<Float4> cache( std::size_t( taps ) * dst.width );
+        long long cachedRow[taps];
+        std::fill( cachedRow,cachedRow + taps,-1000000ll );
+        const auto filterRow = [&]( long long sy,Float4* out ) noexcept {
+            const auto row = src.Row( std::uint32_t( std::clamp<long long>( sy,0,src.height - 1u ) ) );
+            for( std::uint32_t x = 0u; x < src.width; x++ )
+            {
+                _mm_store_ps( linearRow[x].v,cv.Load( row + x * 4u ) );
+            }
+            for( std::uint32_t x = 0u; x < dst.width; x++ )
+            {
+                auto acc = _mm_setzero_ps();
+                for( int k = 0; k < taps; k++ )
+                {
+                    const auto sx = std::clamp<long long>( 2ll * x - 3 + k,0,src.width - 1u );
+                    acc = _mm_add_ps( acc,_mm_mul_ps( _mm_load_ps( linearRow[std::size_t( sx )].v ),weights[k] ) );
+                }
+                _mm_store_ps( out[x].v,acc );
+            }
+        };
+        for( std::uint32_t y = 0u; y < dst.height; y++ )
+        {
+            const Float4* rows[taps];
+            for( int k = 0; k < taps; k++ )
+            {
+                const long long sy = 2ll * y - 3 + k;
+                const auto slot = std::size_t( ( sy % taps + taps ) % taps );
+                if( cachedRow[slot] != sy )
+                {
+                    filterRow( sy,&cache[slot * dst.width] );
+                    cachedRow[slot] = sy;
+                }
+                rows[k] = &cache[slot * dst.width];
+            }
+            const auto out = dst.Row( y );
+            for( std::uint32_t x = 0u; x < dst.width; x++ )
+            {
+                auto acc = _mm_setzero_ps();
+                for( int k = 0; k < taps; k++ )
+                {
+                    acc = _mm_add_ps( acc,_mm_mul_ps( _mm_load_ps( rows[k][x].v ),weights[k] ) );
+                }
+                cv.Store( out + x * 4u,acc );
+            }
+        }
+    }
+}
+
+void MipChain::Generate( Image& image,MipFilter filter )
+{
+    assert( "Mips can only be generated for uncompressed images" && !Image::IsCompressed( image.GetFormat() ) );
+    image.AllocateMipChain();
+    const Converter cv( Image::IsSrgb( image.GetFormat() ) );
+    const auto level = [&image]( std::uint32_t i ) noexcept {
+        const auto& m = image.GetMip( i );
+        return Level{ reinterpret_cast<std::uint8_t*>( image.GetMipData( i ) ),m.width,m.height,m.rowPitch };
+    };
+    for( std::uint32_t i = 1u; i < image.GetMipCount(); i++ )
+    {
+        if( filter == MipFilter::Kaiser )
+        {
+            DownsampleKaiser( level( i - 1u ),level( i ),cv );
+        }
+        else
+        {
+            DownsampleBox( level( i - 1u ),level( i ),cv );
+        }
+    }
+}
+
+float MipChain::SrgbToLinear( std::uint8_t v ) noexcept
+{
+    return GetTables().srgbToLinear[v];
+}
+
+std::uint8_t MipChain::LinearToSrgb( float v ) noexcept
+{
+    return GetTables().linearToSrgb[int( std::clamp( v,0.0f,1.0f ) * 4095.0f + 0.5f )];
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Image.h"
+#include <cstdint>
+
+enum class MipFilter : std::uint8_t
+{
+    // 2x2 平均，最快
+    Box,
+    // Kaiser 窗 sinc（8 抽头，可分离），比 Box 锐利；负瓣造成的越界会被截断
+    Kaiser,
+};
+
+// mip 链生成，用 SSE 一次处理一个像素的四个通道
+namespace MipChain
+{
+    // 把 RGBA8 图像扩成完整的 mip 链并逐层生成，每层从上一层算出。
+    // sRGB 格式先转到线性空间滤波再转回去（gamma-correct），alpha 始终按线性处理
+    void Generate( Image& image,MipFilter filter );
+    float SrgbToLinear( std::uint8_t v ) noexcept;
+    // v is clamped to [0,1]
+    std::uint8_t LinearToSrgb( float v ) noexcept;
+}
@@ -0,0 +1,55 @@
+#include "ModelPart.h"
+#include "BindableBase.h"
+#include "LodSelector.h"
+#include "MemoryTracker.h"
+
+ModelPart::ModelPart( Graphics& gfx,const GltfGeometry& geometry )
+    :
+    triangleCount( geometry.GetIndexCount() / 3u ),
+    transformCbuf( gfx,*this )
+{
+    MemoryScope memoryScope( MemoryTag::Meshes );
+    DirectX::XMStoreFloat4x4( &transform,DirectX::XMMatrixIdentity() );
+
+    if( !IsStaticInitialized() )
+    {
+        // 和 Mesh 一样只读 Position；stride 由顶点缓冲决定，交错的 glTF 顶点也能直接用
+        const auto vs = BindPool<VertexShader>::Emplace( gfx,L"VertexShader.cso" );
+        auto pvsbc = BindPool<VertexShader>::Get( vs ).GetBytecode();
+        AddStaticBind( vs );
+        AddStaticBind( BindPool<PixelShader>::Emplace( gfx,L"MeshPS.cso" ) );
+        // MeshPS 的淡入淡出常数：glTF 的 primitive 没有 LOD，总是画满
+        AddStaticBind( BindPool<PixelConstantBuffer<LodFadeConstants>>::Emplace( gfx,LodFadeConstants{ 1.0f,0u } ) );
+        const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
+        {
+            { "Position",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D11_INPUT_PER_VERTEX_DATA,0 },
+        };
+        AddStaticBind( BindPool<InputLayout>::Emplace( gfx,ied,pvsbc ) );
+        AddStaticBind( BindPool<Topology>::Emplace( gfx,D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST ) );
+        // 世界矩阵里带着 z 取反，索引没有交换，屏幕上是逆时针为正面
+        AddStaticBind( BindPool<Rasterizer>::Emplace( gfx,true ) );
+    }
+
+    AddBind( BindPool<VertexBuffer>::Emplace( gfx,geometry.GetPositions(),
+        geometry.GetPositionStride(),geometry.GetPositionBytes() ) );
+    AddIndexBuffer( BindPool<IndexBuffer>::Emplace( gfx,geometry.GetIndices(),geometry.GetIndexCount(),
+        geometry.GetIndexSize() == 2u ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT ) );
+
+    AddInlineBind( transformCbuf );
+}
+
+void ModelPart::DrawInstance( Graphics& gfx,DirectX::FXMMATRIX world ) noexcept(!IS_DEBUG)
+{
+    DirectX::XMStoreFloat4x4( &transform,world );
+    Draw( gfx );
+}
+
+DirectX::XMMATRIX ModelPart::GetTransformXM() const noexcept
+{
+    return DirectX::XMLoadFloat4x4( &transform );
+}
+
+UINT ModelPart::GetTriangleCount() const noexcept
+{
+    return triangleCount;
+}
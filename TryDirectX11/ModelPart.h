@@ -0,0 +1,22 @@
+#pragma once
+#include "DrawbleBase.h"
+#include "GltfLoader.h"
+#include "TransformCbuf.h"
+
+// .glb 场景里的一个 primitive。顶点 / 索引缓冲是自己的，零拷贝时直接从映射的文件创建；
+// 着色器、输入布局、拓扑和逆时针为正面的光栅化状态所有 ModelPart 共用（static binds）。
+// 用到它的每个节点是 ECS 里的一个实体（WorldTransform + ModelInstance），像 Box 一样按各自的世界矩阵绘制
+class ModelPart : public DrawableBase<ModelPart>
+{
+public:
+    // geometry must have vertices and indices; its file data only has to live until the constructor returns
+    ModelPart( Graphics& gfx,const GltfGeometry& geometry );
+    void DrawInstance( Graphics& gfx,DirectX::FXMMATRIX world ) noexcept(!IS_DEBUG);
+    DirectX::XMMATRIX GetTransformXM() const noexcept override;
+    UINT GetTriangleCount() const noexcept;
+private:
+    UINT triangleCount;
+    // world matrix of the instance being drawn
+    DirectX::XMFLOAT4X4 transform;
+    TransformCbuf transformCbuf;
+};
@@ -23,51 +23,82 @@
 
 std::pair<int, int> Mouse::GetPos() const noexcept
 {
-	return { x,y };
+	const auto& s = SampleState();
+	return { s.x,s.y };
 }
 
 int Mouse::GetPosX() const noexcept
 {
-	return x;
+	return SampleState().x;
 }
 
 int Mouse::GetPosY() const noexcept
 {
-	return y;
+	return SampleState().y;
 }
 
 bool Mouse::IsInWindow() const noexcept
 {
-	return isInWindow;
+	return SampleState().isInWindow;
 }
 
 bool Mouse::LeftIsPressed() const noexcept
 {
-	return leftIsPressed;
+	return SampleState().leftIsPressed;
 }
 
 bool Mouse::RightIsPressed() const noexcept
 {
-	return rightIsPressed;
+	return SampleState().rightIsPressed;
 }
 
 Mouse::Event Mouse::Read() noexcept
 {
-	if (buffer.size() > 0u)
+	Mouse::Event e;
+	if (buffer.Pop(e) && moveCoalescingEnabled)
 	{
-		Mouse::Event e = buffer.front();
-		buffer.pop();
-		return e;
-	}
-	else
-	{
-		return Mouse::Event();
+		// skip over stale moves, only the latest position in a run of moves matters
+		while (e.GetType() == Mouse::Event::Type::Move)
+		{
+			const auto pNext = buffer.Peek();
+			if (pNext == nullptr || pNext->GetType() != Mouse::Event::Type::Move)
+			{
+				break;
+			}
+			buffer.Pop(e);
+		}
 	}
+	return e;
 }
 
 void Mouse::Flush() noexcept
 {
-	buffer = std::queue<Event>();
+	buffer.Clear();
+}
+
+void Mouse::EnableMoveCoalescing() noexcept
+{
+	moveCoalescingEnabled = true;
+}
+
+void Mouse::DisableMoveCoalescing() noexcept
+{
+	moveCoalescingEnabled = false;
+}
+
+bool Mouse::MoveCoalescingIsEnabled() const noexcept
+{
+	return moveCoalescingEnabled;
+}
+
+float Mouse::GetSampleLatency() const noexcept
+{
+	return sampleLatency;
+}
+
+unsigned long long Mouse::GetOverflowCount() const noexcept
+{
+	return buffer.GetOverflowCount();
 }
 
 void Mouse::OnMouseMove(int newx, int newy) noexcept
@@ -75,74 +106,64 @@ void Mouse::OnMouseMove(int newx, int newy) noexcept
 	x = newx;
 	y = newy;
 
-	buffer.push(Mouse::Event(Mouse::Event::Type::Move, *this));
-	TrimBuffer();
+	PublishState();
+	buffer.Push(Mouse::Event(Mouse::Event::Type::Move, *this));
 }
 
 void Mouse::OnMouseLeave() noexcept
 {
 	isInWindow = false;
-	buffer.push(Mouse::Event(Mouse::Event::Type::Leave, *this));
-	TrimBuffer();
+	PublishState();
+	buffer.Push(Mouse::Event(Mouse::Event::Type::Leave, *this));
 }
 
 void Mouse::OnMouseEnter() noexcept
 {
 	isInWindow = true;
-	buffer.push(Mouse::Event(Mouse::Event::Type::Enter, *this));
-	TrimBuffer();
+	PublishState();
+	buffer.Push(Mouse::Event(Mouse::Event::Type::Enter, *this));
 }
 
 void Mouse::OnLeftPressed(int x, int y) noexcept
 {
 	leftIsPressed = true;
 
-	buffer.push(Mouse::Event(Mouse::Event::Type::LPress, *this));
-	TrimBuffer();
+	PublishState();
+	buffer.Push(Mouse::Event(Mouse::Event::Type::LPress, *this));
 }
 
 void Mouse::OnLeftReleased(int x, int y) noexcept
 {
 	leftIsPressed = false;
 
-	buffer.push(Mouse::Event(Mouse::Event::Type::LRelease, *this));
-	TrimBuffer();
+	PublishState();
+	buffer.Push(Mouse::Event(Mouse::Event::Type::LRelease, *this));
 }
 
 void Mouse::OnRightPressed(int x, int y) noexcept
 {
 	rightIsPressed = true;
 
-	buffer.push(Mouse::Event(Mouse::Event::Type::RPress, *this));
-	TrimBuffer();
+	PublishState();
+	buffer.Push(Mouse::Event(Mouse::Event::Type::RPress, *this));
 }
 
 void Mouse::OnRightReleased(int x, int y) noexcept
 {
 	rightIsPressed = false;
 
-	buffer.push(Mouse::Event(Mouse::Event::Type::RRelease, *this));
-	TrimBuffer();
+	PublishState();
+	buffer.Push(Mouse::Event(Mouse::Event::Type::RRelease, *this));
 }
 
 void Mouse::OnWheelUp(int x, int y) noexcept
 {
-	buffer.push(Mouse::Event(Mouse::Event::Type::WheelUp, *this));
-	TrimBuffer();
+	buffer.Push(Mouse::Event(Mouse::Event::Type::WheelUp, *this));
 }
 
 void Mouse::OnWheelDown(int x, int y) noexcept
 {
-	buffer.push(Mouse::Event(Mouse::Event::Type::WheelDown, *this));
-	TrimBuffer();
-}
-
-void Mouse::TrimBuffer() noexcept
-{
-	while (buffer.size() > bufferSize)
-	{
-		buffer.pop();
-	}
+	buffer.Push(Mouse::Event(Mouse::Event::Type::WheelDown, *this));
 }
 
 void Mouse::OnWheelDelta(int x, int y, int delta) noexcept
@@ -159,4 +180,19 @@ void Mouse::OnWheelDelta(int x, int y, int delta) noexcept
 		wheelDeltaCarry += WHEEL_DELTA;
 		OnWheelDown(x, y);
 	}
-}
\ No newline at end of file
+}
+
+void Mouse::PublishState() noexcept
+{
+	snapshot.Publish({ x,y,leftIsPressed,rightIsPressed,isInWindow,std::chrono::steady_clock::now() });
+}
+
+const Mouse::State& Mouse::SampleState() const noexcept
+{
+	if (snapshot.Latch())
+	{
+		const std::chrono::duration<float> latency = std::chrono::steady_clock::now() - snapshot.Get().timestamp;
+		sampleLatency = latency.count();
+	}
+	return snapshot.Get();
+}
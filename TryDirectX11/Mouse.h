@@ -19,11 +19,16 @@
  *	along with The Chili DirectX Framework.  If not, see <http://www.gnu.org/licenses/>.  *
  ******************************************************************************************/
 #pragma once
-#include <queue>
+#include "RingBuffer.h"
+#include "SnapshotBuffer.h"
+#include <chrono>
+#include <utility>
 
 class Mouse
 {
 	friend class Window;
+	// injects recorded input on replay
+	friend class FrameReplayer;
 public:
 	class Event
 	{
@@ -47,6 +52,8 @@ public:
 		bool rightIsPressed;
 		int x;
 		int y;
+		// time the message reached HandleMsg
+		std::chrono::steady_clock::time_point timestamp;
 	public:
 		Event() noexcept
 			:
@@ -62,7 +69,8 @@ public:
 			leftIsPressed(parent.leftIsPressed),
 			rightIsPressed(parent.rightIsPressed),
 			x(parent.x),
-			y(parent.y)
+			y(parent.y),
+			timestamp(std::chrono::steady_clock::now())
 		{}
 		bool IsValid() const noexcept
 		{
@@ -92,6 +100,20 @@ public:
 		{
 			return rightIsPressed;
 		}
+		std::chrono::steady_clock::time_point GetTimestamp() const noexcept
+		{
+			return timestamp;
+		}
+	};
+	// pointer state as last published by the thread that runs the message pump
+	struct State
+	{
+		int x = 0;
+		int y = 0;
+		bool leftIsPressed = false;
+		bool rightIsPressed = false;
+		bool isInWindow = false;
+		std::chrono::steady_clock::time_point timestamp;
 	};
 public:
 	Mouse() = default;
@@ -106,9 +128,17 @@ public:
 	Mouse::Event Read() noexcept;
 	bool IsEmpty() const noexcept
 	{
-		return buffer.empty();
+		return buffer.IsEmpty();
 	}
 	void Flush() noexcept;
+	// when enabled, Read() collapses runs of queued Move events into the newest one
+	void EnableMoveCoalescing() noexcept;
+	void DisableMoveCoalescing() noexcept;
+	bool MoveCoalescingIsEnabled() const noexcept;
+	// seconds between the message thread publishing the newest state and this thread first seeing it
+	float GetSampleLatency() const noexcept;
+	// number of events dropped because the buffer was full
+	unsigned long long GetOverflowCount() const noexcept;
 private:
 	void OnMouseMove(int x, int y) noexcept;
 	void OnMouseLeave() noexcept;
@@ -119,15 +149,20 @@ private:
 	void OnRightReleased(int x, int y) noexcept;
 	void OnWheelUp(int x, int y) noexcept;
 	void OnWheelDown(int x, int y) noexcept;
-	void TrimBuffer() noexcept;
 	void OnWheelDelta(int x, int y, int delta) noexcept;
+	void PublishState() noexcept;
+	const State& SampleState() const noexcept;
 private:
-	static constexpr unsigned int bufferSize = 16u;
-	int x;
-	int y;
+	static constexpr unsigned int bufferSize = 256u;
+	// fields below are only touched by the message thread, other threads read the published snapshot
+	int x = 0;
+	int y = 0;
 	bool leftIsPressed = false;
 	bool rightIsPressed = false;
 	bool isInWindow = false;
 	int wheelDeltaCarry = 0;
-	std::queue<Event> buffer;
+	bool moveCoalescingEnabled = false;
+	RingBuffer<Event, bufferSize> buffer;
+	SnapshotBuffer<State> snapshot;
+	mutable float sampleLatency = 0.0f;
 };
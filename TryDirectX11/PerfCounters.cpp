@@ -0,0 +1,254 @@
+#include "PerfCounters.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct Entry
+    {
+        // must have static storage duration (string literal)
+        const char* name;
+        PerfCounters::Kind kind;
+    };
+    using Kind = PerfCounters::Kind;
+    constexpr auto maxCounters = PerfCounters::maxCounters;
+
+    // 内置的几个在静态初始化阶段就已经就位，和 PerfCounter 的顺序一致
+    Entry entries[maxCounters] = {
+        { "DrawCalls",Kind::Counter },
+        { "IndicesDrawn",Kind::Counter },
+        { "Binds",Kind::Counter },
+        { "Maps",Kind::Counter },
+        { "BytesMapped",Kind::Counter },
+        { "BuffersCreated",Kind::Counter },
+        { "BufferBytesCreated",Kind::Counter },
+        { "FrameTimeMs",Kind::Gauge },
+        { "Entities",Kind::Gauge },
+    };
+    std::atomic<unsigned int> nEntries{ static_cast<unsigned int>( PerfCounter::BuiltinCount ) };
+    std::mutex registryMutex;
+
+    std::array<std::atomic<double>, maxCounters> gauges = {};
+
+    // 每个线程的累计值，只有所属线程写；EndFrame 读取并和上次读到的值相减得到增量
+    struct ThreadBlock
+    {
+        ThreadBlock();
+        ~ThreadBlock();
+        std::array<std::atomic<std::int64_t>, maxCounters> values = {};
+        // owned by EndFrame (guarded by blocksMutex)
+        std::array<std::int64_t, maxCounters> lastSeen = {};
+    };
+    std::mutex blocksMutex;
+    std::vector<ThreadBlock*> blocks;
+    // counts of threads that exited since the last EndFrame
+    std::array<std::int64_t, maxCounters> retired = {};
+
+    ThreadBlock::ThreadBlock()
+    {
+        std::lock_guard<std::mutex> lock( blocksMutex );
+        blocks.push_back( this );
+    }
+
+    ThreadBlock::~ThreadBlock()
+    {
+        std::lock_guard<std::mutex> lock( blocksMutex );
+        for( unsigned int i = 0u; i < maxCounters; i++ )
+        {
+            retired[i] += values[i].load( std::memory_order_relaxed ) - lastSeen[i];
+        }
+        for( auto it = blocks.begin(); it != blocks.end(); ++it )
+        {
+            if( *it == this )
+            {
+                blocks.erase( it );
+                break;
+            }
+        }
+    }
+
+    thread_local ThreadBlock threadBlock;
+
+    // 下面这些只有调用 EndFrame 的线程读写
+    std::array<double, maxCounters> frameValues = {};
+    std::array<double, maxCounters> totals = {};
+    std::atomic<unsigned long long> frameCount{ 0u };
+
+    struct Dump
+    {
+        std::ofstream file;
+        unsigned int interval = 0u;
+        bool json = false;
+        // CSV columns are fixed by the header line
+        unsigned int nColumns = 0u;
+    };
+    Dump dump;
+
+    void WriteDumpLine()
+    {
+        char field[96];
+        const auto n = dump.json ? nEntries.load( std::memory_order_acquire ) : dump.nColumns;
+        const auto frame = frameCount.load( std::memory_order_relaxed );
+        const auto write = [&]( int length ) {
+            dump.file.write( field,std::min<std::streamsize>( length,sizeof( field ) - 1 ) );
+        };
+        write( dump.json ? std::snprintf( field,sizeof( field ),"{\"frame\":%llu",frame )
+                         : std::snprintf( field,sizeof( field ),"%llu",frame ) );
+        for( unsigned int i = 0u; i < n; i++ )
+        {
+            if( dump.json )
+            {
+                write( std::snprintf( field,sizeof( field ),",\"%s\":%.9g",entries[i].name,frameValues[i] ) );
+            }
+            else
+            {
+                write( std::snprintf( field,sizeof( field ),",%.9g",frameValues[i] ) );
+            }
+        }
+        dump.file.write( dump.json ? "}\n" : "\n",dump.json ? 2 : 1 );
+        dump.file.flush();
+    }
+}
+
+unsigned int PerfCounters::Register( const char* name,Kind kind )
+{
+    std::lock_guard<std::mutex> lock( registryMutex );
+    const auto id = nEntries.load( std::memory_order_relaxed );
+    assert( "Too many perf counters" && id < maxCounters );
+    entries[id] = { name,kind };
+    nEntries.store( id + 1u,std::memory_order_release );
+    return id;
+}
+
+unsigned int PerfCounters::Find( const std::string& name ) noexcept
+{
+    const auto n = nEntries.load( std::memory_order_acquire );
+    for( unsigned int i = 0u; i < n; i++ )
+    {
+        if( name == entries[i].name )
+        {
+            return i;
+        }
+    }
+    return maxCounters;
+}
+
+unsigned int PerfCounters::GetCount() noexcept
+{
+    return nEntries.load( std::memory_order_acquire );
+}
+
+const char* PerfCounters::GetName( unsigned int id ) noexcept
+{
+    return entries[id].name;
+}
+
+PerfCounters::Kind PerfCounters::GetKind( unsigned int id ) noexcept
+{
+    return entries[id].kind;
+}
+
+void PerfCounters::Add( unsigned int id,std::int64_t value ) noexcept
+{
+    // 只有本线程写这个槽，load + store 就够了
+    auto& slot = threadBlock.values[id];
+    slot.store( slot.load( std::memory_order_relaxed ) + value,std::memory_order_relaxed );
+}
+
+void PerfCounters::Set( unsigned int id,double value ) noexcept
+{
+    gauges[id].store( value,std::memory_order_relaxed );
+}
+
+void PerfCounters::EndFrame()
+{
+    const auto n = nEntries.load( std::memory_order_acquire );
+    std::array<std::int64_t, maxCounters> sums;
+    {
+        std::lock_guard<std::mutex> lock( blocksMutex );
+        sums = retired;
+        retired = {};
+        for( auto pBlock : blocks )
+        {
+            for( unsigned int i = 0u; i < n; i++ )
+            {
+                const auto v = pBlock->values[i].load( std::memory_order_relaxed );
+                sums[i] += v - pBlock->lastSeen[i];
+                pBlock->lastSeen[i] = v;
+            }
+        }
+    }
+    for( unsigned int i = 0u; i < n; i++ )
+    {
+        if( entries[i].kind == Kind::Counter )
+        {
+            frameValues[i] = double( sums[i] );
+            totals[i] += frameValues[i];
+        }
+        else
+        {
+            frameValues[i] = gauges[i].load( std::memory_order_relaxed );
+        }
+    }
+    const auto frame = frameCount.fetch_add( 1u,std::memory_order_relaxed ) + 1u;
+    if( dump.interval != 0u && frame % dump.interval == 0u )
+    {
+        WriteDumpLine();
+    }
+}
+
+double PerfCounters::GetFrameValue( unsigned int id ) noexcept
+{
+    return frameValues[id];
+}
+
+double PerfCounters::GetTotal( unsigned int id ) noexcept
+{
+    return totals[id];
+}
+
+unsigned long long PerfCounters::GetFrameCount() noexcept
+{
+    return frameCount.load( std::memory_order_relaxed );
+}
+
+void PerfCounters::FormatSummary( char* buffer,std::size_t size ) noexcept
+{
+    std::snprintf( buffer,size,"%.2f ms | %.0f draws | %.1fk tris | %.0f binds | %.1f KB mapped | %.0f entities",
+                   GetFrameValue( PerfCounter::FrameTimeMs ),
+                   GetFrameValue( PerfCounter::DrawCalls ),
+                   GetFrameValue( PerfCounter::IndicesDrawn ) / 3000.0,
+                   GetFrameValue( PerfCounter::Binds ),
+                   GetFrameValue( PerfCounter::BytesMapped ) / 1024.0,
+                   GetFrameValue( PerfCounter::Entities ) );
+}
+
+void PerfCounters::EnableDump( const std::string& path,unsigned int interval )
+{
+    dump.file = std::ofstream( path,std::ios::trunc );
+    dump.interval = dump.file ? std::max( interval,1u ) : 0u;
+    dump.json = path.size() >= 5u && path.compare( path.size() - 5u,5u,".json" ) == 0;
+    dump.nColumns = GetCount();
+    if( dump.interval != 0u && !dump.json )
+    {
+        dump.file << "frame";
+        for( unsigned int i = 0u; i < dump.nColumns; i++ )
+        {
+            dump.file << ',' << entries[i].name;
+        }
+        dump.file << '\n';
+    }
+}
+
+void PerfCounters::DisableDump() noexcept
+{
+    dump.interval = 0u;
+    dump.file.close();
+}
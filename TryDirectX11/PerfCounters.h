@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// 引擎内置的计数器和量表，顺序就是编号；其他子系统可以再用 PerfCounters::Register 注册自己的
+enum class PerfCounter : unsigned int
+{
+    // counters: summed over all threads, reset every frame
+    DrawCalls,
+    IndicesDrawn,
+    Binds,
+    Maps,
+    BytesMapped,
+    BuffersCreated,
+    BufferBytesCreated,
+    // gauges: last value set
+    FrameTimeMs,
+    Entities,
+    BuiltinCount,
+};
+
+// 具名的无锁计数器和量表。
+// 计数器每个线程一份（只有本线程写，普通的 relaxed load/store，没有原子 RMW 也不会争用缓存行），
+// EndFrame 时把所有线程自上一帧以来的增量加起来作为这一帧的值。量表是全局的，取最后一次 Set 的值。
+// 可以按帧查询，也可以周期性地把每帧的值写成 CSV 或 JSON Lines。
+class PerfCounters
+{
+public:
+    enum class Kind
+    {
+        Counter,
+        Gauge,
+    };
+    static constexpr unsigned int maxCounters = 64u;
+public:
+    // registers a new counter or gauge and returns its id; call once per name (e.g. into a static)
+    static unsigned int Register( const char* name,Kind kind );
+    // returns maxCounters if no such name
+    static unsigned int Find( const std::string& name ) noexcept;
+    static unsigned int GetCount() noexcept;
+    static const char* GetName( unsigned int id ) noexcept;
+    static Kind GetKind( unsigned int id ) noexcept;
+    static void Add( unsigned int id,std::int64_t value = 1 ) noexcept;
+    static void Add( PerfCounter counter,std::int64_t value = 1 ) noexcept
+    {
+        Add( static_cast<unsigned int>( counter ),value );
+    }
+    static void Set( unsigned int id,double value ) noexcept;
+    static void Set( PerfCounter gauge,double value ) noexcept
+    {
+        Set( static_cast<unsigned int>( gauge ),value );
+    }
+    // folds every thread's counts into the finished frame and writes a dump line if one is due;
+    // called once per frame by the thread driving the frame loop
+    static void EndFrame();
+    // value during the last finished frame (counters) or current value (gauges)
+    static double GetFrameValue( unsigned int id ) noexcept;
+    static double GetFrameValue( PerfCounter counter ) noexcept
+    {
+        return GetFrameValue( static_cast<unsigned int>( counter ) );
+    }
+    // sum over all finished frames (counters only)
+    static double GetTotal( unsigned int id ) noexcept;
+    static unsigned long long GetFrameCount() noexcept;
+    // one-line summary of the last frame into buffer, for the window title readout; no heap allocation
+    static void FormatSummary( char* buffer,std::size_t size ) noexcept;
+    // every 'interval' frames append one line with every counter's value to path;
+    // a .json path writes JSON Lines, anything else CSV (columns fixed at the first write)
+    static void EnableDump( const std::string& path,unsigned int interval );
+    static void DisableDump() noexcept;
+};
@@ -0,0 +1,56 @@
+#include "PerfHud.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr float barWidth = 3.0f;
+    constexpr float margin = 10.0f;
+    // 每毫秒的像素数，最高 maxHeight
+    constexpr float pixelsPerMs = 4.0f;
+    constexpr float maxHeight = 200.0f;
+    // R 在最低字节（见 SpriteVertex）
+    constexpr std::uint32_t green = 0xFF40D040u;
+    constexpr std::uint32_t yellow = 0xFF30D0E0u;
+    constexpr std::uint32_t red = 0xFF3030E0u;
+    constexpr std::uint32_t grey = 0xFFB0B0B0u;
+}
+
+PerfHud::PerfHud( Graphics& gfx )
+    :
+    // 条数加两条参考线
+    batch( gfx,BuildAtlas(),UINT( maxSamples + 2u ) )
+{}
+
+void PerfHud::Draw( Graphics& gfx,float frameMs )
+{
+    samples[next] = frameMs;
+    next = ( next + 1u ) % maxSamples;
+    count = std::min( count + 1u,maxSamples );
+
+    batch.Begin( gfx );
+    const auto bottom = gfx.GetViewportHeight() - margin;
+    // 最旧的在左边
+    for( std::size_t i = 0u; i < count; i++ )
+    {
+        const auto ms = samples[( next + maxSamples - count + i ) % maxSamples];
+        const auto height = std::min( std::max( ms * pixelsPerMs,1.0f ),maxHeight );
+        const auto color = ms > 1000.0f / 30.0f ? red : ms > 1000.0f / 60.0f ? yellow : green;
+        batch.Add( 0u,margin + float( i ) * barWidth,bottom - height,barWidth - 1.0f,height,color );
+    }
+    for( const auto fps : { 60.0f,30.0f } )
+    {
+        batch.Add( 0u,margin,bottom - 1000.0f / fps * pixelsPerMs,float( maxSamples ) * barWidth,1.0f,grey );
+    }
+    batch.End( gfx );
+}
+
+TextureAtlas PerfHud::BuildAtlas()
+{
+    // 4x4 的不透明白色，padding 用边缘像素填，线性过滤采到的也是白色
+    Image white( 4u,4u,ImageFormat::RGBA8 );
+    std::memset( white.GetMipData( 0u ),0xFF,white.GetMip( 0u ).size );
+    AtlasOptions options;
+    options.pageSize = 16u;
+    return TextureAtlas::Build( { &white },options );
+}
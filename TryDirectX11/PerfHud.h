@@ -0,0 +1,24 @@
+#pragma once
+#include "SpriteBatch.h"
+#include <array>
+
+// 屏幕左下角的帧时间曲线（App 的 --perf-hud），用 SpriteBatch 画：最近 maxSamples 帧每帧一根竖条，
+// 高度按毫秒，超过 16.7 ms 变黄、超过 33.3 ms 变红，另画 60 / 30 fps 两条参考线。
+// 图集只有一块白色的小图，颜色全靠顶点色；要在 3D 场景之后画（见 SpriteBatch）
+class PerfHud
+{
+public:
+    static constexpr std::size_t maxSamples = 120u;
+public:
+    PerfHud( Graphics& gfx );
+    // adds this frame's time to the graph and draws it
+    void Draw( Graphics& gfx,float frameMs );
+private:
+    static TextureAtlas BuildAtlas();
+private:
+    // 环形，next 是下一个要写的位置
+    std::array<float,maxSamples> samples = {};
+    std::size_t next = 0u;
+    std::size_t count = 0u;
+    SpriteBatch batch;
+};
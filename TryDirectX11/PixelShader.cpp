@@ -1,4 +1,5 @@
 #include "PixelShader.h"
+#include "BindStream.h"
 #include "GraphicsThrowMacros.h"
 
 PixelShader::PixelShader( Graphics& gfx,const std::wstring& path )
@@ -15,4 +16,9 @@ PixelShader::PixelShader( Graphics& gfx,const std::wstring& path )
 void PixelShader::Bind( Graphics& gfx ) noexcept
 {
     GetContext( gfx )->PSSetShader( pPixelShader.Get(),nullptr,0u );
-}
\ No newline at end of file
+}
+
+void PixelShader::Record( BindStream& stream ) const
+{
+    stream.PushPixelShader( pPixelShader.Get() );
+}
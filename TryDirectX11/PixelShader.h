@@ -6,6 +6,7 @@ class PixelShader : public Bindable
 public:
     PixelShader(Graphics& gfx, const std::wstring& path);
     void Bind(Graphics& gfx) noexcept override;
+    void Record(BindStream& stream) const override;
 protected:
     Microsoft::WRL::ComPtr<ID3D11PixelShader> pPixelShader;
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "Rasterizer.h"
+#include "BindStream.h"
+#include "GraphicsThrowMacros.h"
+
+Rasterizer::Rasterizer( Graphics& gfx,bool frontCounterClockwise )
+{
+    INFOMAN( gfx );
+
+    // 除了 FrontCounterClockwise 都是 D3D11 的默认值
+    D3D11_RASTERIZER_DESC rasterDesc = {};
+    rasterDesc.FillMode = D3D11_FILL_SOLID;
+    rasterDesc.CullMode = D3D11_CULL_BACK;
+    rasterDesc.FrontCounterClockwise = frontCounterClockwise ? TRUE : FALSE;
+    rasterDesc.DepthClipEnable = TRUE;
+    GFX_THROW_INFO( GetDevice( gfx )->CreateRasterizerState( &rasterDesc,&pRasterizer ) );
+}
+
+void Rasterizer::Bind( Graphics& gfx ) noexcept
+{
+    GetContext( gfx )->RSSetState( pRasterizer.Get() );
+}
+
+void Rasterizer::Record( BindStream& stream ) const
+{
+    stream.PushRasterizer( pRasterizer.Get() );
+}
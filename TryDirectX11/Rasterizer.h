@@ -0,0 +1,15 @@
+#pragma once
+#include "Bindable.h"
+
+// 光栅化状态，只决定哪一面是正面（背面剔除）。引擎自己的网格都是顺时针为正面（D3D 默认）；
+// glTF 的数据是逆时针，零拷贝时不能交换索引，只能换成逆时针为正面的状态。
+// 状态会一直留在 context 上，所以每个 Drawable 都要绑定一个
+class Rasterizer : public Bindable
+{
+public:
+    Rasterizer( Graphics& gfx,bool frontCounterClockwise );
+    void Bind( Graphics& gfx ) noexcept override;
+    void Record( BindStream& stream ) const override;
+private:
+    Microsoft::WRL::ComPtr<ID3D11RasterizerState> pRasterizer;
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 固定容量的单生产者 / 单消费者（SPSC）环形缓冲。
+// 生产者（消息线程）只写 head，消费者（模拟线程）只写 tail，所以不需要锁，也不会在 Push 时分配内存。
+// 和原来的 std::queue + TrimBuffer 不同，满了以后没法由生产者丢弃最旧的事件（那是消费者的数据），
+// 因此丢弃的是新事件，并记录在 overflow 计数里，方便发现缓冲开得太小。
+template<typename T, std::size_t Capacity>
+class RingBuffer
+{
+	static_assert(Capacity >= 2u && (Capacity & (Capacity - 1u)) == 0u, "RingBuffer capacity must be a power of two");
+public:
+	RingBuffer() = default;
+	RingBuffer(const RingBuffer&) = delete;
+	RingBuffer& operator=(const RingBuffer&) = delete;
+	// producer side
+	bool Push(const T& item) noexcept
+	{
+		const auto h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= Capacity)
+		{
+			overflows.fetch_add(1u, std::memory_order_relaxed);
+			return false;
+		}
+		slots[h & mask] = item;
+		head.store(h + 1u, std::memory_order_release);
+		return true;
+	}
+	// consumer side
+	bool Pop(T& item) noexcept
+	{
+		const auto t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		item = slots[t & mask];
+		tail.store(t + 1u, std::memory_order_release);
+		return true;
+	}
+	// 查看下一个将被 Pop 的元素，空时返回 nullptr（consumer side）
+	const T* Peek() const noexcept
+	{
+		const auto t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &slots[t & mask];
+	}
+	// 丢弃当前所有未读元素（consumer side）
+	void Clear() noexcept
+	{
+		tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+	}
+	bool IsEmpty() const noexcept
+	{
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+	std::size_t Size() const noexcept
+	{
+		return std::size_t(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+	}
+	static constexpr std::size_t GetCapacity() noexcept
+	{
+		return Capacity;
+	}
+	// 因为缓冲已满而被丢弃的元素个数
+	std::uint64_t GetOverflowCount() const noexcept
+	{
+		return overflows.load(std::memory_order_relaxed);
+	}
+private:
+	static constexpr std::uint64_t mask = Capacity - 1u;
+	// head / tail 各占一条 cache line，避免两个线程互相把对方的缓存行踢掉（false sharing）
+	alignas(64) std::atomic<std::uint64_t> head{ 0u };
+	alignas(64) std::atomic<std::uint64_t> tail{ 0u };
+	alignas(64) std::atomic<std::uint64_t> overflows{ 0u };
+	std::array<T, Capacity> slots;
+};
@@ -0,0 +1,33 @@
+#include "Sampler.h"
+#include "BindStream.h"
+#include "GraphicsThrowMacros.h"
+
+Sampler::Sampler( Graphics& gfx,D3D11_FILTER filter,D3D11_TEXTURE_ADDRESS_MODE address,UINT slot,UINT maxAnisotropy )
+    :
+    slot( slot )
+{
+    INFOMAN( gfx );
+
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter = filter;
+    samplerDesc.AddressU = address;
+    samplerDesc.AddressV = address;
+    samplerDesc.AddressW = address;
+    samplerDesc.MipLODBias = 0.0f;
+    samplerDesc.MaxAnisotropy = maxAnisotropy;
+    samplerDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+    // 允许使用全部 mip 层
+    samplerDesc.MinLOD = 0.0f;
+    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+    GFX_THROW_INFO( GetDevice( gfx )->CreateSamplerState( &samplerDesc,&pSampler ) );
+}
+
+void Sampler::Bind( Graphics& gfx ) noexcept
+{
+    GetContext( gfx )->PSSetSamplers( slot,1u,pSampler.GetAddressOf() );
+}
+
+void Sampler::Record( BindStream& stream ) const
+{
+    stream.PushPixelSampler( pSampler.Get(),slot );
+}
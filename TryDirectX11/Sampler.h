@@ -0,0 +1,16 @@
+#pragma once
+#include "Bindable.h"
+
+// 像素着色器的采样器状态（s 寄存器）
+class Sampler : public Bindable
+{
+public:
+    // anisotropic filters use maxAnisotropy, the others ignore it
+    Sampler( Graphics& gfx,D3D11_FILTER filter = D3D11_FILTER_ANISOTROPIC,
+        D3D11_TEXTURE_ADDRESS_MODE address = D3D11_TEXTURE_ADDRESS_WRAP,UINT slot = 0u,UINT maxAnisotropy = 8u );
+    void Bind( Graphics& gfx ) noexcept override;
+    void Record( BindStream& stream ) const override;
+private:
+    UINT slot;
+    Microsoft::WRL::ComPtr<ID3D11SamplerState> pSampler;
+};
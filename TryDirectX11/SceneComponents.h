@@ -0,0 +1,61 @@
+#pragma once
+#include "LodSelector.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <random>
+
+// 场景里用到的 ECS 组件，都是平凡可复制的纯数据
+
+// 动画系统写、渲染系统读的世界矩阵
+struct WorldTransform
+{
+    DirectX::XMFLOAT4X4 matrix;
+};
+
+// 原来 Box 里的运动参数：绕自身旋转，再绕场景中心公转
+struct BoxMotion
+{
+    // mt19937 Mersenne Twister算法译为马特赛特旋转演算法，是伪随机数发生器之一
+    static BoxMotion Random(std::mt19937& rng,
+        std::uniform_real_distribution<float>& adist,
+        std::uniform_real_distribution<float>& ddist,
+        std::uniform_real_distribution<float>& odist,
+        std::uniform_real_distribution<float>& rdist);
+    void Advance(float dt) noexcept;
+    DirectX::XMMATRIX GetTransformXM() const noexcept;
+    // positional
+    float r;
+    float roll;
+    float pitch;
+    float yaw;
+    float theta;
+    float phi;
+    float chi;
+    // speed (delta/s)
+    // 角速度
+    float droll;
+    float dpitch;
+    float dyaw;
+    // 世界空间中旋转
+    float dtheta;
+    float dphi;
+    float dchi;
+};
+
+// 用 Box 的网格和着色器绘制
+struct BoxInstance
+{
+    unsigned char unused;
+};
+
+// 用 App 的第 part 个 ModelPart 绘制（glTF 场景里的一个 primitive 实例）
+struct ModelInstance
+{
+    std::uint32_t part;
+};
+
+// 用 App 的 --model 网格绘制，各自选 LOD
+struct MeshInstance
+{
+    LodState lod;
+};
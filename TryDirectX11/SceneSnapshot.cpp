@@ -0,0 +1,163 @@
+#include "SceneSnapshot.h"
+#include "SceneComponents.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#define SNAPSHOT_EXCEPT( note ) SceneSnapshot::Exception( __LINE__,__FILE__,path,(note) )
+
+constexpr char SceneSnapshot::magic[8];
+
+void SceneSnapshot::Save( const std::string& path,World& world )
+{
+    // 先把组件数组收集成连续的两段
+    std::vector<BoxMotion> motions;
+    std::vector<WorldTransform> transforms;
+    world.ForEach<const BoxMotion,const WorldTransform,const BoxInstance>(
+        [&]( const BoxMotion& m,const WorldTransform& t,const BoxInstance& )
+        {
+            motions.push_back( m );
+            transforms.push_back( t );
+        } );
+
+    const auto alignUp = []( std::uint64_t o ) { return (o + sectionAlignment - 1u) & ~std::uint64_t( sectionAlignment - 1u ); };
+    SectionEntry sections[2];
+    sections[0] = { SectionType::BoxMotion,std::uint32_t( sizeof( BoxMotion ) ),
+                    alignUp( sizeof( Header ) + sizeof( sections ) ),motions.size() };
+    sections[1] = { SectionType::WorldTransform,std::uint32_t( sizeof( WorldTransform ) ),
+                    alignUp( sections[0].offset + sizeof( BoxMotion ) * motions.size() ),transforms.size() };
+    Header header = {};
+    std::memcpy( header.magic,magic,sizeof( magic ) );
+    header.version = version;
+    header.sectionCount = 2u;
+    header.fileSize = sections[1].offset + sizeof( WorldTransform ) * transforms.size();
+
+    std::ofstream file( path,std::ios::binary | std::ios::trunc );
+    if( !file )
+    {
+        throw SNAPSHOT_EXCEPT( "Cannot open file for writing" );
+    }
+    const char padding[sectionAlignment] = {};
+    const auto writePadded = [&]( const void* pData,std::uint64_t size,std::uint64_t offset )
+    {
+        file.write( padding,std::streamsize( offset - std::uint64_t( file.tellp() ) ) );
+        file.write( static_cast<const char*>( pData ),std::streamsize( size ) );
+    };
+    file.write( reinterpret_cast<const char*>( &header ),sizeof( header ) );
+    file.write( reinterpret_cast<const char*>( sections ),sizeof( sections ) );
+    writePadded( motions.data(),sizeof( BoxMotion ) * motions.size(),sections[0].offset );
+    writePadded( transforms.data(),sizeof( WorldTransform ) * transforms.size(),sections[1].offset );
+    if( !file )
+    {
+        throw SNAPSHOT_EXCEPT( "Write failed" );
+    }
+}
+
+std::size_t SceneSnapshot::Load( const std::byte* pData,std::size_t size,const std::string& path,World& world )
+{
+    if( size < sizeof( Header ) )
+    {
+        throw SNAPSHOT_EXCEPT( "File too small for a snapshot header" );
+    }
+    Header header;
+    std::memcpy( &header,pData,sizeof( header ) );
+    if( std::memcmp( header.magic,magic,sizeof( magic ) ) != 0 )
+    {
+        throw SNAPSHOT_EXCEPT( "Not a scene snapshot" );
+    }
+    if( header.version != version )
+    {
+        std::ostringstream oss;
+        oss << "Unsupported snapshot version " << header.version << " (expected " << version << ")";
+        throw SNAPSHOT_EXCEPT( oss.str() );
+    }
+    if( header.fileSize != size ||
+        sizeof( Header ) + sizeof( SectionEntry ) * std::uint64_t( header.sectionCount ) > size )
+    {
+        throw SNAPSHOT_EXCEPT( "Truncated snapshot" );
+    }
+
+    // 找到需要的段并校验；不认识的段跳过，方便以后加新段
+    const std::byte* pMotions = nullptr;
+    const std::byte* pTransforms = nullptr;
+    std::uint64_t count = 0u;
+    bool haveCount = false;
+    for( std::uint32_t i = 0u; i < header.sectionCount; i++ )
+    {
+        SectionEntry s;
+        std::memcpy( &s,pData + sizeof( Header ) + sizeof( SectionEntry ) * i,sizeof( s ) );
+        const std::byte** ppTarget = nullptr;
+        std::size_t expectedSize = 0u;
+        switch( s.type )
+        {
+        case SectionType::BoxMotion:
+            ppTarget = &pMotions;
+            expectedSize = sizeof( BoxMotion );
+            break;
+        case SectionType::WorldTransform:
+            ppTarget = &pTransforms;
+            expectedSize = sizeof( WorldTransform );
+            break;
+        default:
+            continue;
+        }
+        if( s.elementSize != expectedSize || s.offset % sectionAlignment != 0u ||
+            s.offset > size || s.count > (size - s.offset) / expectedSize )
+        {
+            throw SNAPSHOT_EXCEPT( "Corrupt section table" );
+        }
+        if( !haveCount )
+        {
+            count = s.count;
+            haveCount = true;
+        }
+        else if( s.count != count )
+        {
+            throw SNAPSHOT_EXCEPT( "Sections disagree on entity count" );
+        }
+        *ppTarget = pData + s.offset;
+    }
+    if( pMotions == nullptr || pTransforms == nullptr )
+    {
+        throw SNAPSHOT_EXCEPT( "Missing box sections" );
+    }
+
+    // 每个 chunk 一次 memcpy；BoxInstance 只是标记，清零即可
+    world.CreateManyChunked<BoxMotion,WorldTransform,BoxInstance>( std::size_t( count ),
+        [pMotions,pTransforms]( std::size_t first,std::uint32_t n,BoxMotion* pM,WorldTransform* pT,BoxInstance* pI )
+        {
+            std::memcpy( pM,pMotions + first * sizeof( BoxMotion ),n * sizeof( BoxMotion ) );
+            std::memcpy( pT,pTransforms + first * sizeof( WorldTransform ),n * sizeof( WorldTransform ) );
+            std::memset( pI,0,n * sizeof( BoxInstance ) );
+        } );
+    return std::size_t( count );
+}
+
+SceneSnapshot::Exception::Exception( int line,const char* file,std::string path,std::string note ) noexcept
+    :
+    ChiliException( line,file ),
+    path( std::move( path ) ),
+    note( std::move( note ) )
+{}
+
+const char* SceneSnapshot::Exception::what() const noexcept
+{
+    std::ostringstream oss;
+    oss << GetType() << std::endl
+        << "[Path] " << path << std::endl
+        << "[Note] " << note << std::endl
+        << GetOriginString();
+    whatBuffer = oss.str();
+    return whatBuffer.c_str();
+}
+
+const char* SceneSnapshot::Exception::GetType() const noexcept
+{
+    return "Scene Snapshot Exception";
+}
+
+const std::string& SceneSnapshot::Exception::GetNote() const noexcept
+{
+    return note;
+}
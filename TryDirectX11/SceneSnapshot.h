@@ -0,0 +1,56 @@
+#pragma once
+#include "ChiliException.h"
+#include "Ecs.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 场景快照：把实体的组件数组原样写进带版本号的二进制文件。
+// 文件布局：Header，然后 sectionCount 个 SectionEntry，然后各段数据（每段起始 64 字节对齐）。
+// 每段是一种组件的平铺数组，加载时直接读内存映射的文件（调用者用 MappedFile 映射），按 chunk 整段 memcpy 进 ECS，不逐个构造对象。
+// 只保存/加载箱子实体（BoxMotion + WorldTransform + BoxInstance）。
+class SceneSnapshot
+{
+public:
+    class Exception : public ChiliException
+    {
+    public:
+        Exception( int line,const char* file,std::string path,std::string note ) noexcept;
+        const char* what() const noexcept override;
+        const char* GetType() const noexcept override;
+        const std::string& GetNote() const noexcept;
+    private:
+        std::string path;
+        std::string note;
+    };
+public:
+    // bump when the layout of a section or of a stored component changes
+    static constexpr std::uint32_t version = 1u;
+    static constexpr std::size_t sectionAlignment = 64u;
+    static void Save( const std::string& path,World& world );
+    // appends the snapshot's entities to world and returns how many were created;
+    // pData is the whole file, path only names it in exceptions
+    static std::size_t Load( const std::byte* pData,std::size_t size,const std::string& path,World& world );
+private:
+    enum class SectionType : std::uint32_t
+    {
+        BoxMotion = 1u,
+        WorldTransform = 2u,
+    };
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t sectionCount;
+        std::uint64_t fileSize;
+    };
+    struct SectionEntry
+    {
+        SectionType type;
+        // sizeof the stored element, checked on load so a changed component is rejected instead of misread
+        std::uint32_t elementSize;
+        std::uint64_t offset;
+        std::uint64_t count;
+    };
+    static constexpr char magic[8] = { 'D','X','1','1','S','C','N','\0' };
+};
@@ -0,0 +1,89 @@
+#include "SceneSystems.h"
+#include "Box.h"
+#include "DrawList.h"
+#include "Mesh.h"
+#include "ModelPart.h"
+#include "SceneComponents.h"
+
+BoxMotion BoxMotion::Random(std::mt19937& rng,
+    std::uniform_real_distribution<float>& adist,
+    std::uniform_real_distribution<float>& ddist,
+    std::uniform_real_distribution<float>& odist,
+    std::uniform_real_distribution<float>& rdist)
+{
+    BoxMotion m = {};
+    m.r = rdist(rng);
+    m.droll = ddist(rng);
+    m.dpitch = ddist(rng);
+    m.dyaw = ddist(rng);
+    m.dphi = odist(rng);
+    m.dtheta = odist(rng);
+    m.dchi = odist(rng);
+    m.chi = adist(rng);
+    m.theta = adist(rng);
+    m.phi = adist(rng);
+    return m;
+}
+
+void BoxMotion::Advance(float dt) noexcept
+{
+    roll += droll * dt;
+    pitch += dpitch * dt;
+    yaw += dyaw * dt;
+    theta += dtheta * dt;
+    phi += dphi * dt;
+    chi += dchi * dt;
+}
+
+DirectX::XMMATRIX BoxMotion::GetTransformXM() const noexcept
+{
+    return DirectX::XMMatrixRotationRollPitchYaw(pitch, yaw, roll) *
+           DirectX::XMMatrixTranslation(r, 0.0f, 0.0f) *
+           DirectX::XMMatrixRotationRollPitchYaw(theta, phi, chi) *
+           // 离摄像机远一点
+           DirectX::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
+}
+
+void AnimateBoxes(World& world, ThreadPool& pool, float dt) noexcept
+{
+    world.ParallelForEach<BoxMotion, WorldTransform>(pool, [dt](BoxMotion& motion, WorldTransform& transform) {
+        motion.Advance(dt);
+        DirectX::XMStoreFloat4x4(&transform.matrix, motion.GetTransformXM());
+    });
+}
+
+void DrawBoxes(World& world, Graphics& gfx, Box& box) noexcept(!IS_DEBUG)
+{
+    // 盒子是边长 2 的立方体，只有旋转和平移
+    constexpr float boxRadius = 1.7320508f;
+    DirectX::XMFLOAT4X4 projection;
+    DirectX::XMStoreFloat4x4(&projection, gfx.GetProjection());
+    // 剔除和排序的列表只活这一帧，放在 FrameMemory 上
+    DrawList<WorldTransform> drawList(projection.m, world.Count<WorldTransform, BoxInstance>());
+    world.ForEach<const WorldTransform, const BoxInstance>([&drawList](const WorldTransform& transform, const BoxInstance&) {
+        const float center[3] = { transform.matrix._41, transform.matrix._42, transform.matrix._43 };
+        drawList.Add(transform, center, boxRadius);
+    });
+    drawList.SortFrontToBack();
+    // D3D11 的 immediate context 只能在一个线程上用，绘制保持串行
+    for (const auto& item : drawList) {
+        box.DrawInstance(gfx, DirectX::XMLoadFloat4x4(&item.pObject->matrix));
+    }
+}
+
+void DrawModels(World& world, Graphics& gfx, const std::vector<std::unique_ptr<ModelPart>>& parts) noexcept(!IS_DEBUG)
+{
+    world.ForEach<const WorldTransform, const ModelInstance>([&gfx, &parts](const WorldTransform& transform, const ModelInstance& model) {
+        parts[model.part]->DrawInstance(gfx, DirectX::XMLoadFloat4x4(&transform.matrix));
+    });
+}
+
+void DrawMeshes(World& world, Graphics& gfx, Mesh& mesh, DirectX::FXMMATRIX fit, float dt) noexcept(!IS_DEBUG)
+{
+    DirectX::XMFLOAT4X4 fitMatrix;
+    DirectX::XMStoreFloat4x4(&fitMatrix, fit);
+    world.ForEach<const WorldTransform, MeshInstance>([&](const WorldTransform& transform, MeshInstance& instance) {
+        mesh.DrawInstance(gfx, DirectX::XMLoadFloat4x4(&fitMatrix) * DirectX::XMLoadFloat4x4(&transform.matrix),
+            instance.lod, dt);
+    });
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "Ecs.h"
+#include "Graphics.h"
+#include <memory>
+#include <vector>
+
+class Box;
+class Mesh;
+class ModelPart;
+
+// BoxMotion 推进 dt 并写入 WorldTransform，按 chunk 并行
+void AnimateBoxes(World& world, ThreadPool& pool, float dt) noexcept;
+// 每个带 BoxInstance 的实体用共享的 Box 绘制一次：视锥外的不画，其余从近到远画
+void DrawBoxes(World& world, Graphics& gfx, Box& box) noexcept(!IS_DEBUG);
+// 每个带 ModelInstance 的实体用它引用的 ModelPart 绘制一次
+void DrawModels(World& world, Graphics& gfx, const std::vector<std::unique_ptr<ModelPart>>& parts) noexcept(!IS_DEBUG);
+// 每个带 MeshInstance 的实体用共享的 Mesh 绘制一次（fit 先把模型缩放到合适的大小），按投影大小选 LOD
+void DrawMeshes(World& world, Graphics& gfx, Mesh& mesh, DirectX::FXMMATRIX fit, float dt) noexcept(!IS_DEBUG);
@@ -0,0 +1,168 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 前 N 个元素直接放在对象内部，超过才去堆上分配的 vector。
+// 只用于平凡可复制的小类型（句柄、指针、命令），搬家就是 memcpy；接口取和 std::vector 同名的子集，可以直接替换。
+// 堆指针和内联存储共用一块内存，头部只有两个 32 位计数：SmallVector<T*, 1> 是 16 字节。
+template<class T, std::size_t N>
+class SmallVector
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector elements are moved with memcpy");
+    static_assert(N > 0u, "Use std::vector when there is no inline capacity");
+public:
+    SmallVector() noexcept = default;
+    SmallVector(const SmallVector& other)
+    {
+        *this = other;
+    }
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other.count);
+            std::memcpy(data(), other.data(), other.count * sizeof(T));
+            count = other.count;
+        }
+        return *this;
+    }
+    SmallVector(SmallVector&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            FreeHeap();
+            if (other.IsInline())
+            {
+                std::memcpy(inlineStorage, other.inlineStorage, other.count * sizeof(T));
+            }
+            else
+            {
+                // 直接接管对方的堆内存
+                pHeap = other.pHeap;
+                capacity_ = other.capacity_;
+                other.capacity_ = std::uint32_t(N);
+            }
+            count = other.count;
+            other.count = 0u;
+        }
+        return *this;
+    }
+    ~SmallVector()
+    {
+        FreeHeap();
+    }
+    void push_back(const T& value)
+    {
+        if (count == capacity_)
+        {
+            // value 可能就在自己里面，先拷出来再扩容
+            const T copy = value;
+            reserve(capacity_ * 2u);
+            data()[count++] = copy;
+            return;
+        }
+        data()[count++] = value;
+    }
+    void pop_back() noexcept
+    {
+        assert(count > 0u);
+        count--;
+    }
+    void reserve(std::size_t n)
+    {
+        if (n <= capacity_)
+        {
+            return;
+        }
+        auto pNew = static_cast<T*>(::operator new(n * sizeof(T)));
+        // 内联的元素要在 pHeap 盖住它们之前拷走
+        std::memcpy(pNew, data(), count * sizeof(T));
+        FreeHeap();
+        pHeap = pNew;
+        capacity_ = std::uint32_t(n);
+    }
+    // 只清空元素，已经分配的堆内存留着复用
+    void clear() noexcept
+    {
+        count = 0u;
+    }
+    std::size_t size() const noexcept
+    {
+        return count;
+    }
+    std::size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+    bool empty() const noexcept
+    {
+        return count == 0u;
+    }
+    // true while the elements still fit in the inline storage
+    bool IsInline() const noexcept
+    {
+        return capacity_ == N;
+    }
+    T* data() noexcept
+    {
+        return IsInline() ? reinterpret_cast<T*>(inlineStorage) : pHeap;
+    }
+    const T* data() const noexcept
+    {
+        return IsInline() ? reinterpret_cast<const T*>(inlineStorage) : pHeap;
+    }
+    T& operator[](std::size_t i) noexcept
+    {
+        assert(i < count);
+        return data()[i];
+    }
+    const T& operator[](std::size_t i) const noexcept
+    {
+        assert(i < count);
+        return data()[i];
+    }
+    T* begin() noexcept
+    {
+        return data();
+    }
+    T* end() noexcept
+    {
+        return data() + count;
+    }
+    const T* begin() const noexcept
+    {
+        return data();
+    }
+    const T* end() const noexcept
+    {
+        return data() + count;
+    }
+private:
+    void FreeHeap() noexcept
+    {
+        if (!IsInline())
+        {
+            ::operator delete(pHeap);
+            capacity_ = std::uint32_t(N);
+        }
+    }
+private:
+    std::uint32_t count = 0u;
+    // == N 时元素在 inlineStorage 里，否则在 pHeap 指的堆内存里
+    std::uint32_t capacity_ = std::uint32_t(N);
+    union
+    {
+        T* pHeap;
+        alignas(T) std::byte inlineStorage[N * sizeof(T)];
+    };
+};
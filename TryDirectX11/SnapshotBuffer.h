@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// 单生产者 / 单消费者的 "最新值" 缓冲（三缓冲）。
+// 生产者 Publish 一份完整状态，消费者 Latch 之后拿到的总是某一次 Publish 的完整副本，不会读到写了一半的数据。
+// 两块缓冲在无锁的情况下做不到这一点（生产者可能正在写消费者在读的那块），所以多用一块做中转：
+// back 只属于生产者，front 只属于消费者，middle 通过一次原子交换在两者之间传递。
+template<typename T>
+class SnapshotBuffer
+{
+public:
+	SnapshotBuffer() = default;
+	SnapshotBuffer(const SnapshotBuffer&) = delete;
+	SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+	// producer side
+	void Publish(const T& value) noexcept
+	{
+		buffers[back] = value;
+		back = middle.exchange(std::uint8_t(back | freshBit), std::memory_order_acq_rel) & indexMask;
+	}
+	// consumer side: 如果有新的快照就换到 front，返回是否换了
+	bool Latch() const noexcept
+	{
+		if ((middle.load(std::memory_order_relaxed) & freshBit) == 0u)
+		{
+			return false;
+		}
+		front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+		return true;
+	}
+	// consumer side: 最近一次 Latch 到的快照
+	const T& Get() const noexcept
+	{
+		return buffers[front];
+	}
+private:
+	static constexpr std::uint8_t indexMask = 0x3u;
+	static constexpr std::uint8_t freshBit = 0x4u;
+	std::array<T, 3> buffers = {};
+	std::uint8_t back = 0u;
+	mutable std::atomic<std::uint8_t> middle{ 1u };
+	mutable std::uint8_t front = 2u;
+};
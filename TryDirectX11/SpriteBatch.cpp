@@ -0,0 +1,107 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+namespace
+{
+    // 每个四边形两个三角形，顶点顺序是 左上、右上、左下、右下（见 SpriteQueue），顺时针
+    std::vector<unsigned short> MakeQuadIndices( UINT quads )
+    {
+        std::vector<unsigned short> indices;
+        indices.reserve( std::size_t( quads ) * 6u );
+        for( UINT q = 0u; q < quads; q++ )
+        {
+            const auto v = static_cast<unsigned short>( q * 4u );
+            indices.insert( indices.end(),{ v,
+                static_cast<unsigned short>( v + 1u ),static_cast<unsigned short>( v + 2u ),
+                static_cast<unsigned short>( v + 2u ),static_cast<unsigned short>( v + 1u ),
+                static_cast<unsigned short>( v + 3u ) } );
+        }
+        return indices;
+    }
+
+    std::vector<D3D11_INPUT_ELEMENT_DESC> MakeLayout()
+    {
+        return {
+            { "Position",0,DXGI_FORMAT_R32G32_FLOAT,0,0u,D3D11_INPUT_PER_VERTEX_DATA,0 },
+            { "TexCoord",0,DXGI_FORMAT_R32G32_FLOAT,0,8u,D3D11_INPUT_PER_VERTEX_DATA,0 },
+            { "Color",0,DXGI_FORMAT_R8G8B8A8_UNORM,0,16u,D3D11_INPUT_PER_VERTEX_DATA,0 },
+        };
+    }
+}
+
+SpriteBatch::SpriteBatch( Graphics& gfx,const TextureAtlas& atlas,UINT maxQuads )
+    :
+    vertexBuffer( gfx,sizeof( SpriteVertex ),maxQuads * 4u ),
+    indexBuffer( gfx,MakeQuadIndices( std::min( maxQuads,maxQuadsPerDraw ) ) ),
+    vertexShader( gfx,L"SpriteVS.cso" ),
+    pixelShader( gfx,L"SpritePS.cso" ),
+    inputLayout( gfx,MakeLayout(),vertexShader.GetBytecode() ),
+    topology( gfx,D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST ),
+    rasterizer( gfx,false ),
+    // padding 够宽时线性过滤不会采到相邻图块；页没有 mip
+    sampler( gfx,D3D11_FILTER_MIN_MAG_MIP_LINEAR,D3D11_TEXTURE_ADDRESS_CLAMP )
+{
+    for( std::uint32_t i = 0u; i < atlas.GetRegionCount(); i++ )
+    {
+        regions.push_back( atlas.GetRegion( i ) );
+    }
+    for( std::uint32_t page = 0u; page < atlas.GetPageCount(); page++ )
+    {
+        pages.push_back( std::make_unique<Texture>( gfx,atlas.GetPage( page ) ) );
+    }
+}
+
+void SpriteBatch::Begin( Graphics& gfx ) noexcept
+{
+    queue.Clear();
+    queue.SetViewport( gfx.GetViewportWidth(),gfx.GetViewportHeight() );
+}
+
+void SpriteBatch::Add( std::uint32_t region,float x,float y,float width,float height,std::uint32_t color )
+{
+    queue.Add( regions[region],x,y,width,height,color );
+}
+
+void SpriteBatch::AddRotated( std::uint32_t region,float centerX,float centerY,float width,float height,float angle,
+    std::uint32_t color )
+{
+    queue.AddRotated( regions[region],centerX,centerY,width,height,angle,color );
+}
+
+void SpriteBatch::End( Graphics& gfx )
+{
+    if( queue.GetQuadCount() == 0u )
+    {
+        return;
+    }
+    vertexBuffer.Bind( gfx );
+    indexBuffer.Bind( gfx );
+    vertexShader.Bind( gfx );
+    pixelShader.Bind( gfx );
+    inputLayout.Bind( gfx );
+    topology.Bind( gfx );
+    rasterizer.Bind( gfx );
+    sampler.Bind( gfx );
+    const auto quadsPerDraw = std::min( indexBuffer.GetCount() / 6u,vertexBuffer.GetCapacity() / 4u );
+    for( std::uint32_t page = 0u; page < queue.GetPageCount(); page++ )
+    {
+        const auto& vertices = queue.GetVertices( page );
+        if( vertices.empty() )
+        {
+            continue;
+        }
+        pages[page]->Bind( gfx );
+        const auto quads = static_cast<UINT>( vertices.size() / 4u );
+        for( UINT first = 0u; first < quads; first += quadsPerDraw )
+        {
+            const auto count = std::min( quadsPerDraw,quads - first );
+            const auto baseVertex = vertexBuffer.Append( gfx,&vertices[std::size_t( first ) * 4u],count * 4u );
+            gfx.DrawIndexed( count * 6u,0u,static_cast<INT>( baseVertex ) );
+        }
+    }
+}
+
+const AtlasRegion& SpriteBatch::GetRegion( std::uint32_t region ) const noexcept
+{
+    return regions[region];
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "DynamicVertexBuffer.h"
+#include "IndexBuffer.h"
+#include "InputLayout.h"
+#include "PixelShader.h"
+#include "Rasterizer.h"
+#include "Sampler.h"
+#include "SpriteQueue.h"
+#include "Texture.h"
+#include "Topology.h"
+#include "VertexShader.h"
+#include <memory>
+#include <vector>
+
+// 屏幕空间的精灵批处理：一帧里 Add 的所有四边形按图集页分桶，End 时每页一次 Map + 一次 DrawIndexed
+// （超过一次能画的四边形数就分几次）。不经过 Drawable，自己的 Bindable 直接 Bind。
+// 没有混合状态，像素着色器按 alpha 0.5 裁掉像素（alpha test），所以要在 3D 场景之后画
+class SpriteBatch
+{
+public:
+    // 16 位索引一次最多画 16384 个四边形
+    static constexpr UINT maxQuadsPerDraw = 16384u;
+public:
+    // 图集每页建一个 Texture；maxQuads 决定动态顶点缓冲的大小
+    SpriteBatch( Graphics& gfx,const TextureAtlas& atlas,UINT maxQuads = maxQuadsPerDraw );
+    // clears the queue and picks up the current viewport size
+    void Begin( Graphics& gfx ) noexcept;
+    // region: index into the atlas regions; see SpriteQueue for the coordinates
+    void Add( std::uint32_t region,float x,float y,float width,float height,std::uint32_t color = 0xFFFFFFFFu );
+    void AddRotated( std::uint32_t region,float centerX,float centerY,float width,float height,float angle,
+        std::uint32_t color = 0xFFFFFFFFu );
+    void End( Graphics& gfx );
+    const AtlasRegion& GetRegion( std::uint32_t region ) const noexcept;
+private:
+    std::vector<AtlasRegion> regions;
+    std::vector<std::unique_ptr<Texture>> pages;
+    SpriteQueue queue;
+    DynamicVertexBuffer vertexBuffer;
+    IndexBuffer indexBuffer;
+    VertexShader vertexShader;
+    PixelShader pixelShader;
+    InputLayout inputLayout;
+    Topology topology;
+    Rasterizer rasterizer;
+    Sampler sampler;
+};
@@ -0,0 +1,85 @@
+#include "SpriteQueue.h"
+#include <cmath>
+
+void SpriteQueue::SetViewport( float width,float height ) noexcept
+{
+    scaleX = 2.0f / width;
+    scaleY = 2.0f / height;
+}
+
+void SpriteQueue::Clear() noexcept
+{
+    for( auto& bucket : buckets )
+    {
+        bucket.clear();
+    }
+    quadCount = 0u;
+}
+
+void SpriteQueue::Add( const AtlasRegion& region,float x,float y,float width,float height,std::uint32_t color )
+{
+    auto& bucket = GetBucket( region.page );
+    const auto x0 = x * scaleX - 1.0f;
+    const auto x1 = ( x + width ) * scaleX - 1.0f;
+    const auto y0 = 1.0f - y * scaleY;
+    const auto y1 = 1.0f - ( y + height ) * scaleY;
+    const auto n = bucket.size();
+    bucket.resize( n + 4u );
+    const auto v = bucket.data() + n;
+    v[0] = { x0,y0,region.u0,region.v0,color };
+    v[1] = { x1,y0,region.u1,region.v0,color };
+    v[2] = { x0,y1,region.u0,region.v1,color };
+    v[3] = { x1,y1,region.u1,region.v1,color };
+    quadCount++;
+}
+
+void SpriteQueue::AddRotated( const AtlasRegion& region,float centerX,float centerY,float width,float height,float angle,
+    std::uint32_t color )
+{
+    auto& bucket = GetBucket( region.page );
+    const auto c = std::cos( angle );
+    const auto s = std::sin( angle );
+    // 半宽、半高两个轴旋转后的向量，四个角是中心加减它们
+    const auto ax = 0.5f * width * c;
+    const auto ay = 0.5f * width * s;
+    const auto bx = -0.5f * height * s;
+    const auto by = 0.5f * height * c;
+    const auto corner = [&]( float sa,float sb,float u,float v ) noexcept {
+        return SpriteVertex{
+            ( centerX + sa * ax + sb * bx ) * scaleX - 1.0f,
+            1.0f - ( centerY + sa * ay + sb * by ) * scaleY,
+            u,v,color };
+    };
+    const auto n = bucket.size();
+    bucket.resize( n + 4u );
+    const auto v = bucket.data() + n;
+    v[0] = corner( -1.0f,-1.0f,region.u0,region.v0 );
+    v[1] = corner( 1.0f,-1.0f,region.u1,region.v0 );
+    v[2] = corner( -1.0f,1.0f,region.u0,region.v1 );
+    v[3] = corner( 1.0f,1.0f,region.u1,region.v1 );
+    quadCount++;
+}
+
+std::uint32_t SpriteQueue::GetPageCount() const noexcept
+{
+    return static_cast<std::uint32_t>( buckets.size() );
+}
+
+const std::vector<SpriteVertex>& SpriteQueue::GetVertices( std::uint32_t page ) const noexcept
+{
+    return buckets[page];
+}
+
+std::size_t SpriteQueue::GetQuadCount() const noexcept
+{
+    return quadCount;
+}
+
+std::vector<SpriteVertex>& SpriteQueue::GetBucket( std::uint32_t page )
+{
+    if( page >= buckets.size() )
+    {
+        buckets.resize( page + 1u );
+    }
+    return buckets[page];
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "TextureAtlas.h"
+#include <cstdint>
+#include <vector>
+
+// 和 HLSL/SpriteVS.hlsl 的输入一致，20 字节
+struct SpriteVertex
+{
+    // NDC
+    float x;
+    float y;
+    float u;
+    float v;
+    // R8G8B8A8_UNORM，R 在最低字节
+    std::uint32_t color;
+};
+
+// 一帧的精灵，按图集页分桶，每页的顶点连续存放，SpriteBatch 每页一次上传一次绘制。
+// 纯 CPU，不碰 D3D（Tools/AtlasBench 也要编译）；Clear 保留容量，稳定之后每帧不分配内存
+class SpriteQueue
+{
+public:
+    // 屏幕坐标（像素，原点在左上角，y 向下）到 NDC 的换算
+    void SetViewport( float width,float height ) noexcept;
+    void Clear() noexcept;
+    // 轴对齐的四边形，(x,y) 是左上角
+    void Add( const AtlasRegion& region,float x,float y,float width,float height,std::uint32_t color = 0xFFFFFFFFu );
+    // 绕中心旋转 angle 弧度（屏幕上顺时针）
+    void AddRotated( const AtlasRegion& region,float centerX,float centerY,float width,float height,float angle,
+        std::uint32_t color = 0xFFFFFFFFu );
+    std::uint32_t GetPageCount() const noexcept;
+    // 4 vertices per quad in the order top-left, top-right, bottom-left, bottom-right
+    const std::vector<SpriteVertex>& GetVertices( std::uint32_t page ) const noexcept;
+    std::size_t GetQuadCount() const noexcept;
+private:
+    std::vector<SpriteVertex>& GetBucket( std::uint32_t page );
+private:
+    float scaleX = 2.0f;
+    float scaleY = 2.0f;
+    std::vector<std::vector<SpriteVertex>> buckets;
+    std::size_t quadCount = 0u;
+};
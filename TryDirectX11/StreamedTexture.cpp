@@ -0,0 +1,130 @@
+#include "StreamedTexture.h"
+#include "BindStream.h"
+#include "Drawable.h"
+#include "GraphicsThrowMacros.h"
+#include "Texture.h"
+#include <algorithm>
+
+StreamedTexture::StreamedTexture( std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t mipCount,UINT slot ) noexcept
+    :
+    slot( slot ),
+    width( width ),
+    height( height ),
+    format( format ),
+    mipCount( mipCount ),
+    residentMip( mipCount )
+{}
+
+void StreamedTexture::Bind( Graphics& gfx ) noexcept
+{
+    GetContext( gfx )->PSSetShaderResources( slot,1u,&pCurrentView );
+}
+
+void StreamedTexture::Record( BindStream& stream ) const
+{
+    stream.PushStreamedPixelShaderResource( &pCurrentView,slot );
+}
+
+void StreamedTexture::SetResidency( Graphics& gfx,std::uint32_t mostDetailedMip,const Image* pNewLevels )
+{
+    INFOMAN( gfx );
+    MemoryScope memoryScope( MemoryTag::Textures );
+    const auto levels = mipCount - mostDetailedMip;
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = std::max( 1u,width >> mostDetailedMip );
+    textureDesc.Height = std::max( 1u,height >> mostDetailedMip );
+    textureDesc.MipLevels = levels;
+    textureDesc.ArraySize = 1u;
+    textureDesc.Format = Texture::GetDxgiFormat( format );
+    textureDesc.SampleDesc.Count = 1u;
+    textureDesc.SampleDesc.Quality = 0u;
+    // 要往里拷旧纹理的层，不能是 IMMUTABLE
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    textureDesc.CPUAccessFlags = 0u;
+    textureDesc.MiscFlags = 0u;
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> pNewTexture;
+    GFX_THROW_INFO( GetDevice( gfx )->CreateTexture2D( &textureDesc,nullptr,&pNewTexture ) );
+
+    // 新纹理的第 i 层是整条链的第 mostDetailedMip + i 层，旧纹理的第 i 层是第 residentMip + i 层
+    const auto pContext = GetContext( gfx );
+    const UINT newLevels = pNewLevels != nullptr ? pNewLevels->GetMipCount() : 0u;
+    std::size_t bytes = 0u;
+    for( UINT i = 0u; i < levels; i++ )
+    {
+        const auto level = mostDetailedMip + i;
+        bytes += Image::GetLevelSize( width,height,format,level );
+        if( i < newLevels )
+        {
+            pContext->UpdateSubresource( pNewTexture.Get(),i,nullptr,pNewLevels->GetMipData( i ),pNewLevels->GetMip( i ).rowPitch,0u );
+        }
+        else
+        {
+            pContext->CopySubresourceRegion( pNewTexture.Get(),i,0u,0u,0u,pTexture.Get(),level - residentMip,nullptr );
+        }
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = textureDesc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = 0u;
+    srvDesc.Texture2D.MipLevels = levels;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> pNewView;
+    GFX_THROW_INFO( GetDevice( gfx )->CreateShaderResourceView( pNewTexture.Get(),&srvDesc,&pNewView ) );
+
+    // 旧纹理如果还绑在管线上，驱动会等用完再真正释放
+    pTexture = std::move( pNewTexture );
+    pTextureView = std::move( pNewView );
+    pCurrentView = pTextureView.Get();
+    residentMip = mostDetailedMip;
+    gpuMemory.Track( GpuMemoryKind::Texture,bytes );
+}
+
+float StreamedTexture::ComputeScreenSize( Graphics& gfx,const Drawable& drawable,float objectSize ) noexcept
+{
+    namespace dx = DirectX;
+    const auto transform = drawable.GetTransformXM();
+    // 模型原点在观察空间里的深度，和模型矩阵的缩放（取第一行的长度）
+    const auto origin = dx::XMVector3Transform( dx::XMVectorZero(),transform );
+    const auto depth = dx::XMVectorGetZ( origin );
+    if( depth <= 0.0f )
+    {
+        return 0.0f;
+    }
+    const auto scale = dx::XMVectorGetX( dx::XMVector3Length( transform.r[0] ) );
+    // 投影矩阵的 _22 把观察空间里深度为 1 处的高度换算成 NDC（高 2 个单位）
+    dx::XMFLOAT4X4 projection;
+    dx::XMStoreFloat4x4( &projection,gfx.GetProjection() );
+    return objectSize * scale * projection._22 / depth * 0.5f * gfx.GetViewportHeight();
+}
+
+GraphicsStreamingDevice::GraphicsStreamingDevice( Graphics& gfx,UINT slot ) noexcept
+    :
+    gfx( gfx ),
+    slot( slot )
+{}
+
+void GraphicsStreamingDevice::Create( StreamedTextureId id,std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t mipCount )
+{
+    if( id >= textures.size() )
+    {
+        textures.resize( id + 1u );
+    }
+    textures[id] = std::make_unique<StreamedTexture>( width,height,format,mipCount,slot );
+}
+
+void GraphicsStreamingDevice::SetResidency( StreamedTextureId id,std::uint32_t mostDetailedMip,const Image* pNewLevels )
+{
+    textures[id]->SetResidency( gfx,mostDetailedMip,pNewLevels );
+}
+
+void GraphicsStreamingDevice::Release( StreamedTextureId id ) noexcept
+{
+    textures[id].reset();
+}
+
+StreamedTexture& GraphicsStreamingDevice::GetTexture( StreamedTextureId id ) noexcept
+{
+    return *textures[id];
+}
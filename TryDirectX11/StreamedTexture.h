@@ -0,0 +1,54 @@
+#pragma once
+#include "Bindable.h"
+#include "MemoryTracker.h"
+#include "TextureStreamer.h"
+#include <memory>
+#include <vector>
+
+class Drawable;
+
+// 流送纹理的 Bindable。常驻的 mip 范围变化时整个纹理和视图都会换掉，
+// 所以记录进 BindStream 的是视图指针的地址，执行时才读出当前的视图
+class StreamedTexture : public Bindable
+{
+public:
+    StreamedTexture( std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t mipCount,UINT slot ) noexcept;
+    void Bind( Graphics& gfx ) noexcept override;
+    void Record( BindStream& stream ) const override;
+    // 见 StreamingDevice::SetResidency
+    void SetResidency( Graphics& gfx,std::uint32_t mostDetailedMip,const Image* pNewLevels );
+    // 物体在屏幕上占多少像素（竖直方向），objectSize 是物体在模型空间里的大小；
+    // 只看模型原点的深度，在相机后面时返回 0
+    static float ComputeScreenSize( Graphics& gfx,const Drawable& drawable,float objectSize ) noexcept;
+private:
+    UINT slot;
+    std::uint32_t width;
+    std::uint32_t height;
+    ImageFormat format;
+    std::uint32_t mipCount;
+    // 还没有层常驻时是 mipCount
+    std::uint32_t residentMip;
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> pTexture;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> pTextureView;
+    // BindStream 里存的是它的地址
+    ID3D11ShaderResourceView* pCurrentView = nullptr;
+    GpuAllocation gpuMemory;
+};
+
+// TextureStreamer 在 D3D11 上的设备。D3D11 不能只释放纹理的一部分 mip（tiled resource 要 11.2 和硬件支持），
+// 所以每次常驻范围变化都新建一张只含 [mostDetailedMip, mipCount) 的纹理：
+// 新读进来的层用 UpdateSubresource 传上去，原来就有的层用 CopySubresourceRegion 在显存里拷过去。
+// 纹理归设备所有，Drawable 用 AddInlineBind( device.GetTexture( id ) ) 绑定，不能活得比设备久
+class GraphicsStreamingDevice : public StreamingDevice
+{
+public:
+    GraphicsStreamingDevice( Graphics& gfx,UINT slot = 0u ) noexcept;
+    void Create( StreamedTextureId id,std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t mipCount ) override;
+    void SetResidency( StreamedTextureId id,std::uint32_t mostDetailedMip,const Image* pNewLevels ) override;
+    void Release( StreamedTextureId id ) noexcept override;
+    StreamedTexture& GetTexture( StreamedTextureId id ) noexcept;
+private:
+    Graphics& gfx;
+    UINT slot;
+    std::vector<std::unique_ptr<StreamedTexture>> textures;
+};
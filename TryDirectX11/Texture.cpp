@@ -0,0 +1,129 @@
+#include "Texture.h"
+#include "BindStream.h"
+#include "GraphicsThrowMacros.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include <memory>
+
+Texture::Texture( Graphics& gfx,const Image& image,UINT slot )
+    :
+    slot( slot )
+{
+    Create( gfx,image );
+}
+
+Texture::Texture( Graphics& gfx,const std::string& path,UINT slot,const ImageLoadOptions& options )
+    :
+    slot( slot )
+{
+    const MappedFile file( path );
+    Create( gfx,ImageLoader::LoadFromMemory( { path,file.GetData(),file.GetSize() },options ) );
+}
+
+std::vector<BindHandle> Texture::LoadMany( Graphics& gfx,ThreadPool& pool,const std::vector<std::string>& paths,
+    UINT slot,const ImageLoadOptions& options )
+{
+    // 映射文件很便宜，在当前线程做；页面是在工作线程解码时才真正读进来的
+    std::vector<std::unique_ptr<MappedFile>> files;
+    std::vector<ImageLoader::Source> sources;
+    files.reserve( paths.size() );
+    sources.reserve( paths.size() );
+    for( const auto& path : paths )
+    {
+        files.push_back( std::make_unique<MappedFile>( path ) );
+        sources.push_back( { path,files.back()->GetData(),files.back()->GetSize() } );
+    }
+    const auto images = ImageLoader::LoadMany( pool,sources,options );
+    std::vector<BindHandle> handles;
+    handles.reserve( images.size() );
+    for( const auto& image : images )
+    {
+        handles.push_back( BindPool<Texture>::Emplace( gfx,image,slot ) );
+    }
+    return handles;
+}
+
+void Texture::Create( Graphics& gfx,const Image& image )
+{
+    INFOMAN( gfx );
+    MemoryScope memoryScope( MemoryTag::Textures );
+    width = image.GetWidth();
+    height = image.GetHeight();
+    mipCount = image.GetMipCount();
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = width;
+    textureDesc.Height = height;
+    textureDesc.MipLevels = mipCount;
+    textureDesc.ArraySize = 1u;
+    textureDesc.Format = GetDxgiFormat( image.GetFormat() );
+    textureDesc.SampleDesc.Count = 1u;
+    textureDesc.SampleDesc.Quality = 0u;
+    // 创建后不再修改，IMMUTABLE 让驱动可以把它放在最合适的地方
+    textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    textureDesc.CPUAccessFlags = 0u;
+    textureDesc.MiscFlags = 0u;
+    // 每个 mip 层一个子资源，一次调用把整条链传上去
+    D3D11_SUBRESOURCE_DATA subresources[Image::maxMipCount] = {};
+    std::size_t bytes = 0u;
+    for( UINT level = 0u; level < mipCount; level++ )
+    {
+        subresources[level].pSysMem = image.GetMipData( level );
+        subresources[level].SysMemPitch = image.GetMip( level ).rowPitch;
+        bytes += image.GetMip( level ).size;
+    }
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> pTexture;
+    GFX_THROW_INFO( GetDevice( gfx )->CreateTexture2D( &textureDesc,subresources,&pTexture ) );
+    gpuMemory.Track( GpuMemoryKind::Texture,bytes );
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = textureDesc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = 0u;
+    srvDesc.Texture2D.MipLevels = mipCount;
+    GFX_THROW_INFO( GetDevice( gfx )->CreateShaderResourceView( pTexture.Get(),&srvDesc,&pTextureView ) );
+}
+
+void Texture::Bind( Graphics& gfx ) noexcept
+{
+    GetContext( gfx )->PSSetShaderResources( slot,1u,pTextureView.GetAddressOf() );
+}
+
+void Texture::Record( BindStream& stream ) const
+{
+    stream.PushPixelShaderResource( pTextureView.Get(),slot );
+}
+
+UINT Texture::GetWidth() const noexcept
+{
+    return width;
+}
+
+UINT Texture::GetHeight() const noexcept
+{
+    return height;
+}
+
+UINT Texture::GetMipCount() const noexcept
+{
+    return mipCount;
+}
+
+DXGI_FORMAT Texture::GetDxgiFormat( ImageFormat format ) noexcept
+{
+    switch( format )
+    {
+    case ImageFormat::RGBA8: return DXGI_FORMAT_R8G8B8A8_UNORM;
+    case ImageFormat::RGBA8Srgb: return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    case ImageFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+    case ImageFormat::BC1Srgb: return DXGI_FORMAT_BC1_UNORM_SRGB;
+    case ImageFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+    case ImageFormat::BC3Srgb: return DXGI_FORMAT_BC3_UNORM_SRGB;
+    case ImageFormat::BC4: return DXGI_FORMAT_BC4_UNORM;
+    case ImageFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+    case ImageFormat::BC7: return DXGI_FORMAT_BC7_UNORM;
+    case ImageFormat::BC7Srgb: return DXGI_FORMAT_BC7_UNORM_SRGB;
+    }
+    return DXGI_FORMAT_UNKNOWN;
+}
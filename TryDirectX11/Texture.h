@@ -0,0 +1,37 @@
+#pragma once
+#include "Bindable.h"
+#include "BindPool.h"
+#include "ImageLoader.h"
+#include "MemoryTracker.h"
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// 像素着色器的 Texture2D（t 寄存器）。整条 mip 链用一次 CreateTexture2D 建好，之后不可修改
+class Texture : public Bindable
+{
+public:
+    Texture( Graphics& gfx,const Image& image,UINT slot = 0u );
+    // 读文件、解码、生成 mip 都在当前线程上完成
+    Texture( Graphics& gfx,const std::string& path,UINT slot = 0u,const ImageLoadOptions& options = {} );
+    // 在线程池上并行读文件和解码，再在当前线程上逐个创建纹理放进 BindPool<Texture>；返回的句柄和 paths 一一对应
+    static std::vector<BindHandle> LoadMany( Graphics& gfx,ThreadPool& pool,const std::vector<std::string>& paths,
+        UINT slot = 0u,const ImageLoadOptions& options = {} );
+    void Bind( Graphics& gfx ) noexcept override;
+    void Record( BindStream& stream ) const override;
+    UINT GetWidth() const noexcept;
+    UINT GetHeight() const noexcept;
+    UINT GetMipCount() const noexcept;
+    // DXGI_FORMAT_UNKNOWN for formats D3D11 has no match for
+    static DXGI_FORMAT GetDxgiFormat( ImageFormat format ) noexcept;
+private:
+    void Create( Graphics& gfx,const Image& image );
+private:
+    UINT slot;
+    UINT width = 0u;
+    UINT height = 0u;
+    UINT mipCount = 0u;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> pTextureView;
+    GpuAllocation gpuMemory;
+};
@@ -0,0 +1,235 @@
+#include "TextureAtlas.h"
+#include "MipChain.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#define ATLAS_EXCEPT( note ) ImageException( __LINE__,__FILE__,"TextureAtlas",(note) )
+
+SkylinePacker::SkylinePacker( std::uint32_t width,std::uint32_t height )
+    :
+    width( width ),
+    height( height )
+{
+    Reset();
+}
+
+bool SkylinePacker::Insert( std::uint32_t rectWidth,std::uint32_t rectHeight,AtlasRect& out )
+{
+    // 底边最低优先，平局取起点所在段最窄的（留下的缝最小）
+    std::size_t best = skyline.size();
+    std::uint32_t bestTop = 0u;
+    std::uint32_t bestSegmentWidth = 0u;
+    std::uint32_t bestY = 0u;
+    for( std::size_t i = 0u; i < skyline.size(); i++ )
+    {
+        std::uint32_t y;
+        if( !Fit( i,rectWidth,rectHeight,y ) )
+        {
+            continue;
+        }
+        const auto top = y + rectHeight;
+        if( best == skyline.size() || top < bestTop || ( top == bestTop && skyline[i].width < bestSegmentWidth ) )
+        {
+            best = i;
+            bestTop = top;
+            bestSegmentWidth = skyline[i].width;
+            bestY = y;
+        }
+    }
+    if( best == skyline.size() )
+    {
+        return false;
+    }
+    out = { skyline[best].x,bestY,rectWidth,rectHeight };
+    usedArea += std::uint64_t( rectWidth ) * rectHeight;
+
+    // 新段盖住 [x, x + rectWidth)，后面被盖住的段删掉或截短
+    skyline.insert( skyline.begin() + best,{ out.x,bestTop,rectWidth } );
+    const auto right = out.x + rectWidth;
+    auto i = best + 1u;
+    while( i < skyline.size() && skyline[i].x < right )
+    {
+        const auto segmentRight = skyline[i].x + skyline[i].width;
+        if( segmentRight <= right )
+        {
+            skyline.erase( skyline.begin() + i );
+        }
+        else
+        {
+            skyline[i].width = segmentRight - right;
+            skyline[i].x = right;
+            break;
+        }
+    }
+    // 合并等高的相邻段
+    for( std::size_t j = 0u; j + 1u < skyline.size(); )
+    {
+        if( skyline[j].y == skyline[j + 1u].y )
+        {
+            skyline[j].width += skyline[j + 1u].width;
+            skyline.erase( skyline.begin() + j + 1u );
+        }
+        else
+        {
+            j++;
+        }
+    }
+    return true;
+}
+
+void SkylinePacker::Reset() noexcept
+{
+    skyline.clear();
+    skyline.push_back( { 0u,0u,width } );
+    usedArea = 0u;
+}
+
+double SkylinePacker::GetOccupancy() const noexcept
+{
+    return double( usedArea ) / ( double( width ) * double( height ) );
+}
+
+bool SkylinePacker::Fit( std::size_t i,std::uint32_t rectWidth,std::uint32_t rectHeight,std::uint32_t& y ) const noexcept
+{
+    if( skyline[i].x + rectWidth > width )
+    {
+        return false;
+    }
+    // 矩形跨过的所有段里最高的那段决定底边
+    y = 0u;
+    std::uint32_t covered = 0u;
+    for( auto j = i; covered < rectWidth; j++ )
+    {
+        y = std::max( y,skyline[j].y );
+        if( y + rectHeight > height )
+        {
+            return false;
+        }
+        covered += skyline[j].width;
+    }
+    return true;
+}
+
+TextureAtlas TextureAtlas::Build( const std::vector<const Image*>& images,const AtlasOptions& options )
+{
+    TextureAtlas atlas;
+    if( images.empty() )
+    {
+        return atlas;
+    }
+    const auto format = images.front()->GetFormat();
+    const auto pad = options.padding;
+    for( const auto pImage : images )
+    {
+        if( pImage->IsEmpty() || pImage->GetFormat() != format || Image::IsCompressed( format ) )
+        {
+            throw ATLAS_EXCEPT( "Atlas images must be non-empty and all RGBA8 or all RGBA8Srgb" );
+        }
+        if( pImage->GetWidth() + 2u * pad > options.pageSize || pImage->GetHeight() + 2u * pad > options.pageSize )
+        {
+            throw ATLAS_EXCEPT( std::to_string( pImage->GetWidth() ) + "x" + std::to_string( pImage->GetHeight() ) +
+                " image does not fit on a " + std::to_string( options.pageSize ) + " page" );
+        }
+    }
+
+    // 高的先放，轮廓更平，浪费更少
+    std::vector<std::uint32_t> order( images.size() );
+    std::iota( order.begin(),order.end(),0u );
+    std::stable_sort( order.begin(),order.end(),[&images]( std::uint32_t a,std::uint32_t b ) noexcept {
+        const auto& ia = *images[a];
+        const auto& ib = *images[b];
+        return ia.GetHeight() != ib.GetHeight() ? ia.GetHeight() > ib.GetHeight() : ia.GetWidth() > ib.GetWidth();
+    } );
+    std::vector<SkylinePacker> packers;
+    atlas.regions.resize( images.size() );
+    for( const auto index : order )
+    {
+        const auto& image = *images[index];
+        AtlasRect rect = {};
+        std::uint32_t page = 0u;
+        while( page < packers.size() && !packers[page].Insert( image.GetWidth() + 2u * pad,image.GetHeight() + 2u * pad,rect ) )
+        {
+            page++;
+        }
+        if( page == packers.size() )
+        {
+            packers.emplace_back( options.pageSize,options.pageSize );
+            packers.back().Insert( image.GetWidth() + 2u * pad,image.GetHeight() + 2u * pad,rect );
+        }
+        auto& region = atlas.regions[index];
+        region.page = page;
+        region.rect = { rect.x + pad,rect.y + pad,image.GetWidth(),image.GetHeight() };
+        const auto scale = 1.0f / float( options.pageSize );
+        region.u0 = float( region.rect.x ) * scale;
+        region.v0 = float( region.rect.y ) * scale;
+        region.u1 = float( region.rect.x + region.rect.width ) * scale;
+        region.v1 = float( region.rect.y + region.rect.height ) * scale;
+    }
+
+    // 拷像素，padding 用最近的边缘像素填（相当于 clamp 寻址）
+    for( std::uint32_t page = 0u; page < packers.size(); page++ )
+    {
+        atlas.pages.emplace_back( options.pageSize,options.pageSize,format,1u );
+        std::memset( atlas.pages.back().GetMipData( 0u ),0,atlas.pages.back().GetMip( 0u ).size );
+        atlas.occupancy.push_back( 0.0 );
+    }
+    for( std::size_t i = 0u; i < images.size(); i++ )
+    {
+        const auto& region = atlas.regions[i];
+        const auto& src = *images[i];
+        auto& dst = atlas.pages[region.page];
+        const auto srcPitch = src.GetMip( 0u ).rowPitch;
+        const auto dstPitch = dst.GetMip( 0u ).rowPitch;
+        const auto pSrc = src.GetMipData( 0u );
+        const auto pDst = dst.GetMipData( 0u );
+        const auto w = region.rect.width;
+        const auto h = region.rect.height;
+        for( std::uint32_t y = 0u; y < h + 2u * pad; y++ )
+        {
+            const auto sy = std::min( h - 1u,y >= pad ? y - pad : 0u );
+            const auto srcRow = pSrc + std::size_t( sy ) * srcPitch;
+            const auto dstRow = pDst + std::size_t( region.rect.y - pad + y ) * dstPitch + std::size_t( region.rect.x - pad ) * 4u;
+            for( std::uint32_t x = 0u; x < pad; x++ )
+            {
+                std::memcpy( dstRow + x * 4u,srcRow,4u );
+                std::memcpy( dstRow + ( pad + w + x ) * 4u,srcRow + ( w - 1u ) * 4u,4u );
+            }
+            std::memcpy( dstRow + pad * 4u,srcRow,std::size_t( w ) * 4u );
+        }
+        atlas.occupancy[region.page] += double( w ) * h / ( double( options.pageSize ) * options.pageSize );
+    }
+    if( options.generateMips )
+    {
+        for( auto& page : atlas.pages )
+        {
+            MipChain::Generate( page,MipFilter::Box );
+        }
+    }
+    return atlas;
+}
+
+std::uint32_t TextureAtlas::GetPageCount() const noexcept
+{
+    return static_cast<std::uint32_t>( pages.size() );
+}
+
+const Image& TextureAtlas::GetPage( std::uint32_t page ) const noexcept
+{
+    return pages[page];
+}
+
+std::uint32_t TextureAtlas::GetRegionCount() const noexcept
+{
+    return static_cast<std::uint32_t>( regions.size() );
+}
+
+const AtlasRegion& TextureAtlas::GetRegion( std::uint32_t index ) const noexcept
+{
+    return regions[index];
+}
+
+double TextureAtlas::GetOccupancy( std::uint32_t page ) const noexcept
+{
+    return occupancy[page];
+}
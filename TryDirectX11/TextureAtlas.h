@@ -0,0 +1,81 @@
+#pragma once
+#include "Image.h"
+#include <cstdint>
+#include <vector>
+
+struct AtlasRect
+{
+    std::uint32_t x;
+    std::uint32_t y;
+    std::uint32_t width;
+    std::uint32_t height;
+};
+
+// 天际线（skyline）装箱：记录已放矩形的上轮廓，每个矩形放在使它顶边最低的位置，平局取最贴合的那一段。
+// 比 maxrects 稍松一点，但插入只要 O(轮廓段数)，适合运行时往图集里增量添加
+class SkylinePacker
+{
+public:
+    SkylinePacker( std::uint32_t width,std::uint32_t height );
+    // false if the rectangle does not fit anywhere; rectangles are never rotated
+    bool Insert( std::uint32_t width,std::uint32_t height,AtlasRect& out );
+    void Reset() noexcept;
+    // 已放矩形的面积 / 箱子面积
+    double GetOccupancy() const noexcept;
+private:
+    struct Segment
+    {
+        std::uint32_t x;
+        std::uint32_t y;
+        std::uint32_t width;
+    };
+private:
+    // 矩形放在第 i 段起点时的底边高度，放不下返回 false
+    bool Fit( std::size_t i,std::uint32_t width,std::uint32_t height,std::uint32_t& y ) const noexcept;
+private:
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint64_t usedArea = 0u;
+    // 从左到右，相邻段的 x 首尾相接，覆盖整个宽度
+    std::vector<Segment> skyline;
+};
+
+struct AtlasOptions
+{
+    std::uint32_t pageSize = 1024u;
+    // 每个图块四周留出的像素，用边缘像素填满，双线性过滤时不会采到相邻图块
+    std::uint32_t padding = 2u;
+    // 页生成 mip 时相邻图块会在低层混在一起，只适合缩小得不多的情况
+    bool generateMips = false;
+};
+
+struct AtlasRegion
+{
+    std::uint32_t page;
+    // 不含 padding 的 UV，v 向下
+    float u0;
+    float v0;
+    float u1;
+    float v1;
+    // 在页里的像素位置，不含 padding
+    AtlasRect rect;
+};
+
+// 把一组 RGBA8 小图装进若干张方形的页，regions 和输入一一对应（UV 重映射表）。
+// 先按高度从大到小排序再逐个放，放不进已有的页就开新页
+class TextureAtlas
+{
+public:
+    // 所有图像必须是同一种 RGBA8 / RGBA8Srgb 格式，只用第 0 层；加上 padding 超过页大小时抛 ImageException
+    static TextureAtlas Build( const std::vector<const Image*>& images,const AtlasOptions& options = {} );
+    std::uint32_t GetPageCount() const noexcept;
+    const Image& GetPage( std::uint32_t page ) const noexcept;
+    std::uint32_t GetRegionCount() const noexcept;
+    const AtlasRegion& GetRegion( std::uint32_t index ) const noexcept;
+    // 各页的占用率（不含 padding）
+    double GetOccupancy( std::uint32_t page ) const noexcept;
+private:
+    std::vector<Image> pages;
+    std::vector<double> occupancy;
+    std::vector<AtlasRegion> regions;
+};
@@ -0,0 +1,630 @@
+#include "TextureStreamer.h"
+#include "FrameArena.h"
+#include "ImageCodecs.h"
+#include "MemoryTracker.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#define STREAM_EXCEPT( note ) ImageException( __LINE__,__FILE__,path,(note) )
+#define SIM_EXCEPT( note ) ImageException( __LINE__,__FILE__,"SimulatedStreamingDevice",(note) )
+
+namespace
+{
+    struct StreamingCounters
+    {
+        unsigned int residentMB;
+        unsigned int loadsInFlight;
+        unsigned int belowTarget;
+        unsigned int bytesStreamed;
+    };
+
+    // 每个名字只能注册一次，多个 TextureStreamer 共用
+    const StreamingCounters& GetCounters()
+    {
+        static const StreamingCounters counters = {
+            PerfCounters::Register( "StreamResidentMB",PerfCounters::Kind::Gauge ),
+            PerfCounters::Register( "StreamLoadsInFlight",PerfCounters::Kind::Gauge ),
+            PerfCounters::Register( "StreamBelowTarget",PerfCounters::Kind::Gauge ),
+            PerfCounters::Register( "StreamBytes",PerfCounters::Kind::Counter ),
+        };
+        return counters;
+    }
+
+    std::uint32_t LevelDim( std::uint32_t size,std::uint32_t level ) noexcept
+    {
+        return std::max( 1u,size >> level );
+    }
+
+    // 读 image 的每一层，文件里各层紧挨着，Image 里每层按 16 字节对齐，所以逐层读
+    void ReadLevels( std::ifstream& file,std::size_t offset,Image& image )
+    {
+        file.seekg( static_cast<std::streamoff>( offset ) );
+        for( std::uint32_t i = 0u; i < image.GetMipCount(); i++ )
+        {
+            file.read( reinterpret_cast<char*>( image.GetMipData( i ) ),static_cast<std::streamsize>( image.GetMip( i ).size ) );
+        }
+    }
+}
+
+void SimulatedStreamingDevice::Create( StreamedTextureId id,std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t mipCount )
+{
+    if( id < slots.size() && slots[id].live )
+    {
+        throw SIM_EXCEPT( "Texture " + std::to_string( id ) + " created twice" );
+    }
+    if( id >= slots.size() )
+    {
+        slots.resize( id + 1u );
+    }
+    slots[id] = { width,height,format,mipCount,mipCount,0u,true };
+}
+
+void SimulatedStreamingDevice::SetResidency( StreamedTextureId id,std::uint32_t mostDetailedMip,const Image* pNewLevels )
+{
+    if( id >= slots.size() || !slots[id].live )
+    {
+        throw SIM_EXCEPT( "Residency change on unknown texture " + std::to_string( id ) );
+    }
+    auto& s = slots[id];
+    if( mostDetailedMip >= s.mipCount || mostDetailedMip == s.residentMip )
+    {
+        throw SIM_EXCEPT( "Bad residency change to mip " + std::to_string( mostDetailedMip ) );
+    }
+    std::size_t bytes = 0u;
+    for( auto level = mostDetailedMip; level < s.mipCount; level++ )
+    {
+        bytes += Image::GetLevelSize( s.width,s.height,s.format,level );
+    }
+    if( mostDetailedMip < s.residentMip )
+    {
+        // 第一次以外每次只能加一层，不然说明流送跳过了中间的层
+        const auto added = s.residentMip - mostDetailedMip;
+        if( s.residentMip != s.mipCount && added != 1u )
+        {
+            throw SIM_EXCEPT( "Texture " + std::to_string( id ) + " skipped from mip " +
+                std::to_string( s.residentMip ) + " to " + std::to_string( mostDetailedMip ) );
+        }
+        if( pNewLevels == nullptr || pNewLevels->GetMipCount() != added || pNewLevels->GetFormat() != s.format ||
+            pNewLevels->GetWidth() != LevelDim( s.width,mostDetailedMip ) || pNewLevels->GetHeight() != LevelDim( s.height,mostDetailedMip ) )
+        {
+            throw SIM_EXCEPT( "New levels of texture " + std::to_string( id ) + " do not match the texture" );
+        }
+        uploadedBytes += bytes - s.bytes;
+    }
+    else if( pNewLevels != nullptr )
+    {
+        throw SIM_EXCEPT( "Dropping levels must not upload anything" );
+    }
+    residentBytes = residentBytes - s.bytes + bytes;
+    s.bytes = bytes;
+    s.residentMip = mostDetailedMip;
+    residencyChanges++;
+}
+
+void SimulatedStreamingDevice::Release( StreamedTextureId id ) noexcept
+{
+    if( id < slots.size() && slots[id].live )
+    {
+        residentBytes -= slots[id].bytes;
+        slots[id].live = false;
+    }
+}
+
+std::size_t SimulatedStreamingDevice::GetResidentBytes() const noexcept
+{
+    return residentBytes;
+}
+
+std::size_t SimulatedStreamingDevice::GetUploadedBytes() const noexcept
+{
+    return uploadedBytes;
+}
+
+unsigned long long SimulatedStreamingDevice::GetResidencyChanges() const noexcept
+{
+    return residencyChanges;
+}
+
+TextureStreamer::TextureStreamer( StreamingDevice& device,std::size_t budgetBytes )
+    :
+    device( device ),
+    budget( budgetBytes )
+{
+    GetCounters();
+    ioThread = std::thread( &TextureStreamer::IoLoop,this );
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        quit = true;
+    }
+    wake.notify_all();
+    ioThread.join();
+    for( StreamedTextureId id = 0u; id < entries.size(); id++ )
+    {
+        Unregister( id );
+    }
+}
+
+StreamedTextureId TextureStreamer::Register( const std::string& path,bool srgb )
+{
+    MemoryScope memoryScope( MemoryTag::Textures );
+    std::ifstream file( path,std::ios::binary | std::ios::ate );
+    if( !file )
+    {
+        throw STREAM_EXCEPT( "Cannot open file" );
+    }
+    const auto fileSize = static_cast<std::size_t>( file.tellg() );
+    // DDS 头加 DX10 扩展头一共 148 字节
+    std::byte header[148] = {};
+    file.seekg( 0 );
+    file.read( reinterpret_cast<char*>( header ),static_cast<std::streamsize>( std::min( fileSize,sizeof( header ) ) ) );
+    const auto info = ImageCodecs::ReadDdsInfo( header,fileSize,path,srgb );
+    if( info.swapRedBlue || info.forceOpaque )
+    {
+        throw STREAM_EXCEPT( "Streaming needs a DDS that can be uploaded as is (RGBA8 or BC)" );
+    }
+
+    Entry e = {};
+    e.path = path;
+    e.width = info.width;
+    e.height = info.height;
+    e.format = info.format;
+    e.mipCount = info.mipCount;
+    auto offset = info.dataOffset;
+    for( std::uint32_t level = 0u; level < e.mipCount; level++ )
+    {
+        e.levelOffsets[level] = offset;
+        offset += Image::GetLevelSize( e.width,e.height,e.format,level );
+    }
+    // 文件里的 mip 链不够长时最后一层就是尾部
+    e.tailMip = e.mipCount - 1u;
+    while( e.tailMip > 0u && std::max( LevelDim( e.width,e.tailMip - 1u ),LevelDim( e.height,e.tailMip - 1u ) ) <= tailSize )
+    {
+        e.tailMip--;
+    }
+    e.residentMip = e.tailMip;
+    e.targetMip = e.tailMip;
+    e.pendingMip = e.mipCount;
+    e.live = true;
+
+    Image tail( LevelDim( e.width,e.tailMip ),LevelDim( e.height,e.tailMip ),e.format,e.mipCount - e.tailMip );
+    ReadLevels( file,e.levelOffsets[e.tailMip],tail );
+    if( !file )
+    {
+        throw STREAM_EXCEPT( "Cannot read the mip tail" );
+    }
+    const auto id = static_cast<StreamedTextureId>( entries.size() );
+    const auto tailBytes = GetRangeBytes( e,e.tailMip,e.mipCount );
+    // 尾部必须常驻，腾不出地方也照样放进来，报告里会显示超出预算
+    MakeRoom( tailBytes,id,false );
+    device.Create( id,e.width,e.height,e.format,e.mipCount );
+    try
+    {
+        device.SetResidency( id,e.tailMip,&tail );
+    }
+    catch( ... )
+    {
+        device.Release( id );
+        throw;
+    }
+    entries.push_back( std::move( e ) );
+    residentBytes += tailBytes;
+    return id;
+}
+
+void TextureStreamer::Unregister( StreamedTextureId id ) noexcept
+{
+    if( id >= entries.size() || !entries[id].live )
+    {
+        return;
+    }
+    auto& e = entries[id];
+    // 还在读的层回来时按 pendingMip 对不上丢掉，这里先把它占的预算还回去
+    if( e.pendingMip != e.mipCount )
+    {
+        reservedBytes -= GetLevelBytes( e,e.pendingMip );
+        e.pendingMip = e.mipCount;
+    }
+    residentBytes -= GetRangeBytes( e,e.residentMip,e.mipCount );
+    e.live = false;
+    device.Release( id );
+}
+
+void TextureStreamer::ReportUsage( StreamedTextureId id,float screenSizePixels ) noexcept
+{
+    auto& e = entries[id];
+    if( e.lastUsedFrame != frame )
+    {
+        e.lastUsedFrame = frame;
+        e.screenSize = 0.0f;
+    }
+    e.screenSize = std::max( e.screenSize,screenSizePixels );
+}
+
+void TextureStreamer::Update()
+{
+    const auto& counters = GetCounters();
+    ApplyResults();
+    for( auto& e : entries )
+    {
+        if( e.live )
+        {
+            UpdateTarget( e );
+            e.budgetLimited = false;
+        }
+    }
+    // 预算被调小了：先按平常的顺序淘汰，还不够就连本帧用到的纹理也降
+    if( residentBytes + reservedBytes > budget && !MakeRoom( 0u,static_cast<StreamedTextureId>( entries.size() ),false ) )
+    {
+        MakeRoom( 0u,static_cast<StreamedTextureId>( entries.size() ),true );
+    }
+
+    // 按 屏幕像素 / 当前最精细层的边长 排序，比值越大越模糊，越先读
+    // 只活这一帧，放在调用线程当帧的 arena 上
+    FrameVector<StreamedTextureId> candidates;
+    candidates.reserve( entries.size() );
+    for( StreamedTextureId id = 0u; id < entries.size(); id++ )
+    {
+        const auto& e = entries[id];
+        if( e.live && e.error.empty() && e.lastUsedFrame == frame && e.pendingMip == e.mipCount && e.residentMip > e.targetMip )
+        {
+            candidates.push_back( id );
+        }
+    }
+    const auto priority = [this]( StreamedTextureId id ) noexcept {
+        const auto& e = entries[id];
+        return e.screenSize / float( std::max( LevelDim( e.width,e.residentMip ),LevelDim( e.height,e.residentMip ) ) );
+    };
+    std::sort( candidates.begin(),candidates.end(),[&priority]( StreamedTextureId a,StreamedTextureId b ) noexcept {
+        return priority( a ) > priority( b );
+    } );
+    unsigned int requested = 0u;
+    for( const auto id : candidates )
+    {
+        if( loadsInFlight == maxLoadsInFlight )
+        {
+            break;
+        }
+        auto& e = entries[id];
+        const auto level = e.residentMip - 1u;
+        const auto bytes = GetLevelBytes( e,level );
+        if( !MakeRoom( bytes,id,false ) )
+        {
+            e.budgetLimited = true;
+            continue;
+        }
+        reservedBytes += bytes;
+        e.pendingMip = level;
+        loadsInFlight++;
+        requested++;
+        std::lock_guard<std::mutex> lock( mutex );
+        loads.push_back( { id,level,e.path,e.levelOffsets[level],LevelDim( e.width,level ),LevelDim( e.height,level ),e.format } );
+        loadsOnIoThread++;
+    }
+    if( requested != 0u )
+    {
+        wake.notify_one();
+    }
+
+    unsigned int belowTarget = 0u;
+    for( auto& e : entries )
+    {
+        if( e.live && e.lastUsedFrame == frame )
+        {
+            e.lastScreenSize = e.screenSize;
+            belowTarget += e.residentMip > e.targetMip ? 1u : 0u;
+        }
+    }
+    PerfCounters::Set( counters.residentMB,double( residentBytes ) / ( 1024.0 * 1024.0 ) );
+    PerfCounters::Set( counters.loadsInFlight,double( loadsInFlight ) );
+    PerfCounters::Set( counters.belowTarget,double( belowTarget ) );
+    frame++;
+}
+
+void TextureStreamer::SetBudget( std::size_t budgetBytes ) noexcept
+{
+    budget = budgetBytes;
+}
+
+std::size_t TextureStreamer::GetBudget() const noexcept
+{
+    return budget;
+}
+
+std::size_t TextureStreamer::GetResidentBytes() const noexcept
+{
+    return residentBytes;
+}
+
+std::uint32_t TextureStreamer::GetResidentMip( StreamedTextureId id ) const noexcept
+{
+    return entries[id].residentMip;
+}
+
+std::uint32_t TextureStreamer::GetTargetMip( StreamedTextureId id ) const noexcept
+{
+    return entries[id].targetMip;
+}
+
+unsigned int TextureStreamer::GetLoadsInFlight() const noexcept
+{
+    return loadsInFlight;
+}
+
+void TextureStreamer::WaitForLoads()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    idle.wait( lock,[this] { return loadsOnIoThread == 0u; } );
+}
+
+std::string TextureStreamer::GetReport() const
+{
+    unsigned int live = 0u;
+    unsigned int used = 0u;
+    unsigned int atTarget = 0u;
+    unsigned int limited = 0u;
+    unsigned int deficit = 0u;
+    for( const auto& e : entries )
+    {
+        if( !e.live )
+        {
+            continue;
+        }
+        live++;
+        // 上一次 Update 处理的是 frame - 1
+        if( e.lastUsedFrame + 1u == frame )
+        {
+            used++;
+            atTarget += e.residentMip <= e.targetMip ? 1u : 0u;
+            limited += e.budgetLimited ? 1u : 0u;
+            deficit += e.residentMip > e.targetMip ? e.residentMip - e.targetMip : 0u;
+        }
+    }
+    char line[200];
+    std::string report;
+    std::snprintf( line,sizeof( line ),"[Streaming] budget %.1f MB, resident %.1f MB (%.0f%%), %u loads in flight%s\n",
+        double( budget ) / ( 1024.0 * 1024.0 ),double( residentBytes ) / ( 1024.0 * 1024.0 ),
+        budget != 0u ? 100.0 * double( residentBytes ) / double( budget ) : 0.0,loadsInFlight,
+        residentBytes > budget ? "  OVER BUDGET" : "" );
+    report += line;
+    std::snprintf( line,sizeof( line ),"[Streaming] %u textures, %u visible: %u at target, %u below (%u limited by budget), %.2f mips short on average\n",
+        live,used,atTarget,used - atTarget,limited,used != 0u ? double( deficit ) / double( used ) : 0.0 );
+    report += line;
+    report += "[Streaming]   id   size        screen  resident  target  KB\n";
+    for( StreamedTextureId id = 0u; id < entries.size(); id++ )
+    {
+        const auto& e = entries[id];
+        if( !e.live )
+        {
+            continue;
+        }
+        const bool visible = e.lastUsedFrame + 1u == frame;
+        std::snprintf( line,sizeof( line ),"[Streaming] %4u %5ux%-5u %7.0f %9u %7u %7zu%s%s%s\n",
+            id,e.width,e.height,visible ? e.lastScreenSize : 0.0f,e.residentMip,e.targetMip,
+            GetRangeBytes( e,e.residentMip,e.mipCount ) / 1024u,
+            e.pendingMip != e.mipCount ? "  loading" : "",e.budgetLimited ? "  BUDGET" : "",
+            e.error.empty() ? "" : "  FAILED" );
+        report += line;
+        if( !e.error.empty() )
+        {
+            report += "[Streaming]        " + e.error + '\n';
+        }
+    }
+    return report;
+}
+
+void TextureStreamer::IoLoop()
+{
+    // 读进来的层在应用前都算纹理的内存
+    MemoryScope memoryScope( MemoryTag::Textures );
+    for( ;; )
+    {
+        Load load;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            wake.wait( lock,[this] { return quit || !loads.empty(); } );
+            if( quit )
+            {
+                return;
+            }
+            load = std::move( loads.front() );
+            loads.pop_front();
+        }
+        Result result = { load.id,load.level,{},{} };
+        try
+        {
+            const auto& path = load.path;
+            std::ifstream file( path,std::ios::binary );
+            Image image( load.width,load.height,load.format,1u );
+            ReadLevels( file,load.offset,image );
+            if( !file )
+            {
+                throw STREAM_EXCEPT( "Cannot read mip " + std::to_string( load.level ) );
+            }
+            result.image = std::move( image );
+        }
+        catch( const std::exception& e )
+        {
+            result.error = e.what();
+        }
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            results.push_back( std::move( result ) );
+            loadsOnIoThread--;
+        }
+        idle.notify_all();
+    }
+}
+
+std::size_t TextureStreamer::GetLevelBytes( const Entry& e,std::uint32_t level ) const noexcept
+{
+    return Image::GetLevelSize( e.width,e.height,e.format,level );
+}
+
+std::size_t TextureStreamer::GetRangeBytes( const Entry& e,std::uint32_t first,std::uint32_t last ) const noexcept
+{
+    std::size_t bytes = 0u;
+    for( auto level = first; level < last; level++ )
+    {
+        bytes += GetLevelBytes( e,level );
+    }
+    return bytes;
+}
+
+void TextureStreamer::ApplyResults()
+{
+    applying.clear();
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        std::swap( applying,results );
+    }
+    const auto& counters = GetCounters();
+    for( auto& r : applying )
+    {
+        loadsInFlight--;
+        auto& e = entries[r.id];
+        // 读的过程中纹理被注销了
+        if( !e.live || e.pendingMip != r.level )
+        {
+            continue;
+        }
+        const auto bytes = GetLevelBytes( e,r.level );
+        e.pendingMip = e.mipCount;
+        reservedBytes -= bytes;
+        if( !r.error.empty() )
+        {
+            // 不再流送这张纹理，保留已经常驻的层
+            e.error = std::move( r.error );
+            continue;
+        }
+        // 读的过程中被淘汰了几层，或者预算被调小了放不下
+        if( r.level + 1u != e.residentMip || residentBytes + reservedBytes + bytes > budget )
+        {
+            continue;
+        }
+        device.SetResidency( r.id,r.level,&r.image );
+        residentBytes += bytes;
+        e.residentMip = r.level;
+        PerfCounters::Add( counters.bytesStreamed,std::int64_t( bytes ) );
+    }
+    // 像素已经传给设备了，不用留着
+    applying.clear();
+}
+
+void TextureStreamer::UpdateTarget( Entry& e ) noexcept
+{
+    // 没用到的纹理保持原来的目标，它的层只在预算不够时按最久未用淘汰
+    if( e.lastUsedFrame != frame )
+    {
+        e.dropCount = 0u;
+        return;
+    }
+    // 第 m 层的边长是 maxDim / 2^m，要不小于屏幕上的像素数
+    const auto maxDim = float( std::max( e.width,e.height ) );
+    const auto ideal = std::clamp( std::log2( maxDim / std::max( e.screenSize,1.0f ) ),0.0f,float( e.tailMip ) );
+    const auto desired = static_cast<std::uint32_t>( ideal );
+    if( desired <= e.targetMip )
+    {
+        e.targetMip = desired;
+        e.dropCount = 0u;
+    }
+    else if( ideal >= float( e.targetMip ) + 1.0f + dropMargin )
+    {
+        if( ++e.dropCount >= dropFrames )
+        {
+            e.targetMip = desired;
+            e.dropCount = 0u;
+        }
+    }
+    else
+    {
+        e.dropCount = 0u;
+    }
+}
+
+bool TextureStreamer::MakeRoom( std::size_t bytes,StreamedTextureId except,bool includeUsed )
+{
+    while( residentBytes + reservedBytes + bytes > budget )
+    {
+        // 依次找：没用到的纹理里最久未用的（可以降到尾部），用到的纹理超出目标的层，
+        // includeUsed 时再找用到的纹理里屏幕像素 / 层边长最小的（最不缺精度的）
+        StreamedTextureId victim = except;
+        std::uint32_t victimFloor = 0u;
+        int victimTier = 3;
+        double victimKey = 0.0;
+        for( StreamedTextureId id = 0u; id < entries.size(); id++ )
+        {
+            const auto& e = entries[id];
+            if( id == except || !e.live )
+            {
+                continue;
+            }
+            const bool used = e.lastUsedFrame == frame;
+            int tier;
+            std::uint32_t floor;
+            double key;
+            if( !used )
+            {
+                tier = 0;
+                floor = e.tailMip;
+                key = double( e.lastUsedFrame );
+            }
+            else if( e.residentMip < e.targetMip )
+            {
+                tier = 1;
+                floor = e.targetMip;
+                key = 0.0;
+            }
+            else if( includeUsed )
+            {
+                tier = 2;
+                floor = e.tailMip;
+                key = e.screenSize / double( std::max( LevelDim( e.width,e.residentMip ),LevelDim( e.height,e.residentMip ) ) );
+            }
+            else
+            {
+                continue;
+            }
+            if( e.residentMip >= floor )
+            {
+                continue;
+            }
+            if( tier < victimTier || ( tier == victimTier && key < victimKey ) )
+            {
+                victim = id;
+                victimFloor = floor;
+                victimTier = tier;
+                victimKey = key;
+            }
+        }
+        if( victim == except )
+        {
+            return false;
+        }
+        // 一层一层地降到刚好放得下，一次 SetResidency 做完
+        const auto& e = entries[victim];
+        auto mip = e.residentMip;
+        auto freed = std::size_t( 0u );
+        while( mip < victimFloor && residentBytes - freed + reservedBytes + bytes > budget )
+        {
+            freed += GetLevelBytes( e,mip );
+            mip++;
+        }
+        DropTo( victim,mip );
+    }
+    return true;
+}
+
+void TextureStreamer::DropTo( StreamedTextureId id,std::uint32_t mip )
+{
+    auto& e = entries[id];
+    device.SetResidency( id,mip,nullptr );
+    residentBytes -= GetRangeBytes( e,e.residentMip,mip );
+    e.residentMip = mip;
+}
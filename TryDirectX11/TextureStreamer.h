@@ -0,0 +1,163 @@
+#pragma once
+#include "Image.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using StreamedTextureId = std::uint32_t;
+
+// 流送纹理在 GPU 那一侧的接口。TextureStreamer 只通过它改常驻的 mip 范围，
+// 游戏里是 GraphicsStreamingDevice（StreamedTexture.h），测试和 Tools/StreamingSim 用 SimulatedStreamingDevice
+class StreamingDevice
+{
+public:
+    virtual ~StreamingDevice() = default;
+    // 登记纹理的完整尺寸，这时还没有任何层常驻
+    virtual void Create( StreamedTextureId id,std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t mipCount ) = 0;
+    // 让 [mostDetailedMip, mipCount) 常驻。变精细时 pNewLevels 的第 0 层是 mostDetailedMip，
+    // 依次放着所有新加的层（第一次调用时是整段尾部），其余的层设备自己从旧的资源拷过来；
+    // 变粗糙时 pNewLevels 是 nullptr，丢掉更精细的层
+    virtual void SetResidency( StreamedTextureId id,std::uint32_t mostDetailedMip,const Image* pNewLevels ) = 0;
+    virtual void Release( StreamedTextureId id ) noexcept = 0;
+};
+
+// 只记账不碰 GPU：检查每次变精细只加一层（尾部除外）、新层的尺寸和格式都对得上，不对就抛 ImageException
+class SimulatedStreamingDevice : public StreamingDevice
+{
+public:
+    void Create( StreamedTextureId id,std::uint32_t width,std::uint32_t height,ImageFormat format,std::uint32_t mipCount ) override;
+    void SetResidency( StreamedTextureId id,std::uint32_t mostDetailedMip,const Image* pNewLevels ) override;
+    void Release( StreamedTextureId id ) noexcept override;
+    std::size_t GetResidentBytes() const noexcept;
+    std::size_t GetUploadedBytes() const noexcept;
+    unsigned long long GetResidencyChanges() const noexcept;
+private:
+    struct Slot
+    {
+        std::uint32_t width;
+        std::uint32_t height;
+        ImageFormat format;
+        std::uint32_t mipCount;
+        std::uint32_t residentMip;
+        std::size_t bytes;
+        bool live;
+    };
+private:
+    std::vector<Slot> slots;
+    std::size_t residentBytes = 0u;
+    std::size_t uploadedBytes = 0u;
+    unsigned long long residencyChanges = 0u;
+};
+
+// 按 mip 层流送 DDS 纹理，所有纹理的常驻字节数不超过预算。
+// 每帧渲染时用 ReportUsage 报告纹理在屏幕上占多少像素（同一帧取最大值），Update 据此决定每张纹理要到哪一层：
+// 放大立刻生效，缩小要持续 dropFrames 帧且超出半层以上才降，避免在两层之间来回切换。
+// 读文件在后台线程上一层一层地做，应用结果、淘汰和调用 StreamingDevice 都在调用 Update 的线程上。
+// 预算不够时先按最久未用淘汰本帧没用到的纹理的精细层（最多降到尾部），再淘汰用到的纹理超出目标的层。
+// 边长不超过 tailSize 的尾部层在 Register 时同步读进来，一直常驻，也算在预算里
+class TextureStreamer
+{
+public:
+    static constexpr std::uint32_t tailSize = 64u;
+    static constexpr unsigned int dropFrames = 30u;
+    static constexpr float dropMargin = 0.5f;
+    static constexpr unsigned int maxLoadsInFlight = 4u;
+public:
+    TextureStreamer( StreamingDevice& device,std::size_t budgetBytes );
+    ~TextureStreamer();
+    TextureStreamer( const TextureStreamer& ) = delete;
+    TextureStreamer& operator=( const TextureStreamer& ) = delete;
+    // 只支持文件里的格式能直接上传的 DDS（RGBA8 或 BC，不需要交换通道），缺层的文件只流送它有的层
+    StreamedTextureId Register( const std::string& path,bool srgb = true );
+    void Unregister( StreamedTextureId id ) noexcept;
+    // screenSizePixels: how many pixels the texture spans on screen along its longer side
+    void ReportUsage( StreamedTextureId id,float screenSizePixels ) noexcept;
+    // once per frame, after all ReportUsage calls for the frame
+    void Update();
+    void SetBudget( std::size_t budgetBytes ) noexcept;
+    std::size_t GetBudget() const noexcept;
+    std::size_t GetResidentBytes() const noexcept;
+    std::uint32_t GetResidentMip( StreamedTextureId id ) const noexcept;
+    std::uint32_t GetTargetMip( StreamedTextureId id ) const noexcept;
+    unsigned int GetLoadsInFlight() const noexcept;
+    // blocks until every load handed to the I/O thread has finished; the results are applied by the next Update
+    void WaitForLoads();
+    // 预算、常驻量，每张纹理离目标差几层、是不是被预算卡住了
+    std::string GetReport() const;
+private:
+    struct Entry
+    {
+        std::string path;
+        std::uint32_t width;
+        std::uint32_t height;
+        ImageFormat format;
+        std::uint32_t mipCount;
+        // 第 i 层在文件里的偏移
+        std::size_t levelOffsets[Image::maxMipCount];
+        std::uint32_t tailMip;
+        std::uint32_t residentMip;
+        std::uint32_t targetMip;
+        // 正在读的层，没有时是 mipCount
+        std::uint32_t pendingMip;
+        float screenSize;
+        float lastScreenSize;
+        unsigned long long lastUsedFrame;
+        unsigned int dropCount;
+        bool budgetLimited;
+        bool live;
+        std::string error;
+    };
+    struct Load
+    {
+        StreamedTextureId id;
+        std::uint32_t level;
+        std::string path;
+        std::size_t offset;
+        std::uint32_t width;
+        std::uint32_t height;
+        ImageFormat format;
+    };
+    struct Result
+    {
+        StreamedTextureId id;
+        std::uint32_t level;
+        Image image;
+        std::string error;
+    };
+private:
+    void IoLoop();
+    std::size_t GetLevelBytes( const Entry& e,std::uint32_t level ) const noexcept;
+    // bytes of levels [first, last)
+    std::size_t GetRangeBytes( const Entry& e,std::uint32_t first,std::uint32_t last ) const noexcept;
+    void ApplyResults();
+    void UpdateTarget( Entry& e ) noexcept;
+    // evicts levels until 'bytes' more fit, never touching 'except'; returns false if it could not make room.
+    // 正常情况下不动本帧用到的纹理目标以内的层，只有预算被调小时才允许（includeUsed）
+    bool MakeRoom( std::size_t bytes,StreamedTextureId except,bool includeUsed );
+    void DropTo( StreamedTextureId id,std::uint32_t mip );
+private:
+    StreamingDevice& device;
+    std::size_t budget;
+    std::vector<Entry> entries;
+    std::size_t residentBytes = 0u;
+    // 已经交给 I/O 线程、还没应用的层也先占着预算，结果回来时一定放得下
+    std::size_t reservedBytes = 0u;
+    unsigned int loadsInFlight = 0u;
+    unsigned long long frame = 1u;
+    // 每帧复用，稳定运行时 Update 不分配内存（每帧的候选列表在 FrameMemory 上）
+    std::vector<Result> applying;
+    // 下面这些在 I/O 线程和调用线程之间共享
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<Load> loads;
+    std::vector<Result> results;
+    unsigned int loadsOnIoThread = 0u;
+    bool quit = false;
+    std::thread ioThread;
+};
@@ -0,0 +1,89 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int nWorkers)
+{
+    if (nWorkers == 0u)
+    {
+        nWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+    }
+    workers.reserve(nWorkers);
+    for (unsigned int i = 0u; i < nWorkers; i++)
+    {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& t : workers)
+    {
+        t.join();
+    }
+}
+
+unsigned int ThreadPool::GetWorkerCount() const noexcept
+{
+    return static_cast<unsigned int>(workers.size());
+}
+
+void ThreadPool::Dispatch(Job& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pCurrent = &job;
+        jobSerial++;
+    }
+    wakeCondition.notify_all();
+    Execute(job);
+    // 所有块都已被领走；撤下任务，等还在里面的工作线程做完手上的块，之后 job 才能出栈
+    std::unique_lock<std::mutex> lock(mutex);
+    pCurrent = nullptr;
+    doneCondition.wait(lock, [this] { return busy == 0u; });
+}
+
+void ThreadPool::Execute(Job& job) noexcept
+{
+    while (true)
+    {
+        const auto begin = job.next.fetch_add(job.grain, std::memory_order_relaxed);
+        if (begin >= job.count)
+        {
+            return;
+        }
+        job.invoke(job.pContext, begin, std::min(begin + job.grain, job.count));
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    unsigned long long seenSerial = 0u;
+    while (true)
+    {
+        Job* pJob;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [this, seenSerial] {
+                return stopping || (pCurrent != nullptr && jobSerial != seenSerial);
+            });
+            if (stopping)
+            {
+                return;
+            }
+            seenSerial = jobSerial;
+            pJob = pCurrent;
+            busy++;
+        }
+        Execute(*pJob);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy--;
+        }
+        doneCondition.notify_one();
+    }
+}
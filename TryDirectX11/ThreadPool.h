@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 固定数量的工作线程，只提供 ParallelFor：把 [0,count) 按 grain 切块，工作线程和调用线程一起抢块执行。
+// 分发一次不产生堆分配（任务放在调用者的栈上，函数对象按指针传递），所以每帧调用也没有问题。
+// 只能由一个线程分发（通常是主线程），不支持在任务里再嵌套 ParallelFor；任务函数不能抛异常。
+class ThreadPool
+{
+public:
+    // 0 means hardware_concurrency - 1 workers (the calling thread takes part as well)
+    explicit ThreadPool(unsigned int nWorkers = 0u);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+    // f(begin, end) is called for disjoint ranges covering [0,count); returns when all of them are done
+    template<typename F>
+    void ParallelFor(size_t count, size_t grain, F&& f)
+    {
+        if (count == 0u)
+        {
+            return;
+        }
+        if (grain == 0u)
+        {
+            grain = 1u;
+        }
+        // 只有一块或者没有工作线程时直接在当前线程执行，省掉唤醒的开销
+        if (count <= grain || workers.empty())
+        {
+            f(size_t(0u), count);
+            return;
+        }
+        Job job;
+        job.invoke = [](void* pContext, size_t begin, size_t end) {
+            (*static_cast<std::remove_reference_t<F>*>(pContext))(begin, end);
+        };
+        job.pContext = const_cast<void*>(static_cast<const void*>(&f));
+        job.count = count;
+        job.grain = grain;
+        Dispatch(job);
+    }
+    unsigned int GetWorkerCount() const noexcept;
+private:
+    struct Job
+    {
+        void (*invoke)(void* pContext, size_t begin, size_t end);
+        void* pContext;
+        size_t count;
+        size_t grain;
+        std::atomic<size_t> next{ 0u };
+    };
+    void Dispatch(Job& job);
+    static void Execute(Job& job) noexcept;
+    void WorkerLoop();
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    Job* pCurrent = nullptr;
+    unsigned long long jobSerial = 0u;
+    // workers currently inside pCurrent
+    unsigned int busy = 0u;
+    bool stopping = false;
+};
+
+// f(i) for every i in [0,count), one task per index, on pPool or on the calling thread when pPool is nullptr.
+// 和 ParallelFor 不同，f 可以抛异常：各个任务先自己接住，全部结束后抛出下标最小的那个
+template<typename F>
+void RunTasks(ThreadPool* pPool, size_t count, F&& f)
+{
+    std::vector<std::exception_ptr> errors(count);
+    const auto run = [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++)
+        {
+            try
+            {
+                f(i);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    if (pPool != nullptr)
+    {
+        pPool->ParallelFor(count, 1u, run);
+    }
+    else
+    {
+        run(size_t(0u), count);
+    }
+    for (const auto& e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#include "TiledImage.h"
+#include <cstring>
+
+#define TILED_EXCEPT( note ) ImageException( __LINE__,__FILE__,"TiledImage",(note) )
+
+namespace
+{
+    constexpr std::uint16_t Spread( std::uint32_t v ) noexcept
+    {
+        std::uint32_t r = 0u;
+        for( std::uint32_t bit = 0u; bit < 6u; bit++ )
+        {
+            r |= ( ( v >> bit ) & 1u ) << ( 2u * bit );
+        }
+        return std::uint16_t( r );
+    }
+}
+
+const std::uint16_t TiledImage::mortonSpread[64] = {
+    Spread( 0 ),Spread( 1 ),Spread( 2 ),Spread( 3 ),Spread( 4 ),Spread( 5 ),Spread( 6 ),Spread( 7 ),
+    Spread( 8 ),Spread( 9 ),Spread( 10 ),Spread( 11 ),Spread( 12 ),Spread( 13 ),Spread( 14 ),Spread( 15 ),
+    Spread( 16 ),Spread( 17 ),Spread( 18 ),Spread( 19 ),Spread( 20 ),Spread( 21 ),Spread( 22 ),Spread( 23 ),
+    Spread( 24 ),Spread( 25 ),Spread( 26 ),Spread( 27 ),Spread( 28 ),Spread( 29 ),Spread( 30 ),Spread( 31 ),
+    Spread( 32 ),Spread( 33 ),Spread( 34 ),Spread( 35 ),Spread( 36 ),Spread( 37 ),Spread( 38 ),Spread( 39 ),
+    Spread( 40 ),Spread( 41 ),Spread( 42 ),Spread( 43 ),Spread( 44 ),Spread( 45 ),Spread( 46 ),Spread( 47 ),
+    Spread( 48 ),Spread( 49 ),Spread( 50 ),Spread( 51 ),Spread( 52 ),Spread( 53 ),Spread( 54 ),Spread( 55 ),
+    Spread( 56 ),Spread( 57 ),Spread( 58 ),Spread( 59 ),Spread( 60 ),Spread( 61 ),Spread( 62 ),Spread( 63 ),
+};
+
+TiledImage::TiledImage( const Image& source )
+    :
+    width( source.GetWidth() ),
+    height( source.GetHeight() ),
+    format( source.GetFormat() )
+{
+    if( source.IsEmpty() || Image::IsCompressed( format ) )
+    {
+        throw TILED_EXCEPT( "TiledImage needs a non-empty RGBA8 or RGBA8Srgb image" );
+    }
+    std::size_t total = 0u;
+    for( std::uint32_t i = 0u; i < source.GetMipCount(); i++ )
+    {
+        Level level;
+        level.width = source.GetMip( i ).width;
+        level.height = source.GetMip( i ).height;
+        level.superTilesX = ( level.width + superTileSize - 1u ) / superTileSize;
+        level.offset = total;
+        const auto superTilesY = ( level.height + superTileSize - 1u ) / superTileSize;
+        total += std::size_t( level.superTilesX ) * superTilesY * superTileSize * superTileSize;
+        levels.push_back( level );
+    }
+    pTexels.reset( new std::uint32_t[total] );
+
+    for( std::uint32_t i = 0u; i < source.GetMipCount(); i++ )
+    {
+        const auto view = GetLevel( i );
+        const auto pDst = pTexels.get() + levels[i].offset;
+        const auto pSrc = source.GetMipData( i );
+        const auto pitch = source.GetMip( i ).rowPitch;
+        for( std::uint32_t y = 0u; y < view.height; y++ )
+        {
+            const auto row = pSrc + std::size_t( y ) * pitch;
+            const auto rowOffset = RowOffset( view,y );
+            for( std::uint32_t x = 0u; x < view.width; x++ )
+            {
+                std::memcpy( pDst + rowOffset + ColumnOffset( view,x ),row + x * 4u,4u );
+            }
+        }
+    }
+}
+
+std::uint32_t TiledImage::GetWidth() const noexcept
+{
+    return width;
+}
+
+std::uint32_t TiledImage::GetHeight() const noexcept
+{
+    return height;
+}
+
+ImageFormat TiledImage::GetFormat() const noexcept
+{
+    return format;
+}
+
+std::uint32_t TiledImage::GetMipCount() const noexcept
+{
+    return static_cast<std::uint32_t>( levels.size() );
+}
+
+TiledImage::LevelView TiledImage::GetLevel( std::uint32_t level ) const noexcept
+{
+    const auto& l = levels[level];
+    return { pTexels.get() + l.offset,l.width,l.height,l.superTilesX };
+}
+
+Image TiledImage::ToImage() const
+{
+    Image image( width,height,format,GetMipCount() );
+    for( std::uint32_t i = 0u; i < GetMipCount(); i++ )
+    {
+        const auto view = GetLevel( i );
+        const auto pitch = image.GetMip( i ).rowPitch;
+        const auto pDst = image.GetMipData( i );
+        for( std::uint32_t y = 0u; y < view.height; y++ )
+        {
+            for( std::uint32_t x = 0u; x < view.width; x++ )
+            {
+                const auto texel = Fetch( view,RowOffset( view,y ) + ColumnOffset( view,x ) );
+                std::memcpy( pDst + std::size_t( y ) * pitch + x * 4u,&texel,4u );
+            }
+        }
+    }
+    return image;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "Image.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// RGBA8 mip 链的 CPU 采样用布局：每层切成 64x64 的超级块（16KB，正好是 L1 的量级），超级块按行排列，
+// 块内 4096 个像素按 Morton（Z 序）排列。任何对齐的 2^k x 2^k 方块在内存里都是连续的，
+// 双线性的 2x2 足迹大多落在同一条缓存行里，竖着走、斜着走也不会每个像素换一页。
+// 只给 CPU 用（软件渲染、回读分析、烘焙），上传 GPU 还是用 Image
+class TiledImage
+{
+public:
+    static constexpr std::uint32_t superTileSize = 64u;
+    // 取一层的只读视图，CpuSampler 按它寻址
+    struct LevelView
+    {
+        const std::uint32_t* pTexels;
+        std::uint32_t width;
+        std::uint32_t height;
+        // 一行有多少个超级块
+        std::uint32_t superTilesX;
+    };
+public:
+    // source 必须是 RGBA8 / RGBA8Srgb，已有的 mip 层全部转过来
+    explicit TiledImage( const Image& source );
+    std::uint32_t GetWidth() const noexcept;
+    std::uint32_t GetHeight() const noexcept;
+    ImageFormat GetFormat() const noexcept;
+    std::uint32_t GetMipCount() const noexcept;
+    LevelView GetLevel( std::uint32_t level ) const noexcept;
+    // 转回行优先的 Image（测试和调试用）
+    Image ToImage() const;
+    // 像素的位置拆成行、列两部分，Fetch( view,RowOffset( y ) + ColumnOffset( x ) )；
+    // 双线性的四个像素只要算两行两列。x < width, y < height，不做边界检查
+    static std::size_t RowOffset( const LevelView& level,std::uint32_t y ) noexcept
+    {
+        return std::size_t( y >> 6u ) * level.superTilesX * 4096u + ( std::size_t( mortonSpread[y & 63u] ) << 1u );
+    }
+    static std::size_t ColumnOffset( const LevelView&,std::uint32_t x ) noexcept
+    {
+        return std::size_t( x >> 6u ) * 4096u + mortonSpread[x & 63u];
+    }
+    static std::uint32_t Fetch( const LevelView& level,std::size_t offset ) noexcept
+    {
+        return level.pTexels[offset];
+    }
+private:
+    struct Level
+    {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t superTilesX;
+        // 以像素计
+        std::size_t offset;
+    };
+private:
+    // 6 位的坐标每位之间插一个 0，x 占偶数位，y 占奇数位
+    static const std::uint16_t mortonSpread[64];
+    std::uint32_t width;
+    std::uint32_t height;
+    ImageFormat format;
+    std::vector<Level> levels;
+    // 超级块凑不满的部分不初始化，采样时坐标总在 [0,width) x [0,height) 内，读不到
+    std::unique_ptr<std::uint32_t[]> pTexels;
+};
@@ -1,4 +1,5 @@
 #include "Topology.h"
+#include "BindStream.h"
 
 Topology::Topology( Graphics& gfx,D3D11_PRIMITIVE_TOPOLOGY type )
         :
@@ -9,4 +10,9 @@ void Topology::Bind( Graphics& gfx ) noexcept
 {
     // 设置图元类型，设定输入布局
     GetContext( gfx )->IASetPrimitiveTopology( type );
-}
\ No newline at end of file
+}
+
+void Topology::Record( BindStream& stream ) const
+{
+    stream.PushTopology( type );
+}
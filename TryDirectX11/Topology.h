@@ -6,6 +6,7 @@ class Topology : public Bindable
 public:
     Topology(Graphics& gfx, D3D11_PRIMITIVE_TOPOLOGY type);
     void Bind(Graphics& gfx) noexcept override;
+    void Record(BindStream& stream) const override;
 protected:
     D3D11_PRIMITIVE_TOPOLOGY type;
 };
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+
+// 图形调用 trace 的文件格式，App 写、Tools/TraceAnalyzer 读，所以这里只能用标准 C++。
+// 文件 = TraceHeader + 若干条定长 TraceRecord，每帧以一条 FrameEnd 结束。
+
+constexpr char traceMagic[8] = { 'D','X','1','1','T','R','C','\0' };
+// bump when TraceRecord or the meaning of its fields changes
+constexpr std::uint32_t traceVersion = 1u;
+
+struct TraceHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+};
+
+enum class TraceRecordKind : std::uint8_t
+{
+    // op = TraceBindOp, arg = slot / stride / format / topology, object = bound object
+    Bind,
+    // object = buffer, arg = bytes written
+    Map,
+    // arg = index count, object = start index
+    Draw,
+    // object = frame id, arg = 1 if the frame hit GraphicsTrace's per-frame record limit and later calls were dropped
+    FrameEnd,
+};
+
+// 和 BindStream::Op 的顺序一致（GraphicsTrace.cpp 里有 static_assert）
+enum class TraceBindOp : std::uint8_t
+{
+    VertexBuffer,
+    IndexBuffer,
+    InputLayout,
+    Topology,
+    VertexShader,
+    PixelShader,
+    VertexConstantBuffer,
+    PixelConstantBuffer,
+    PixelShaderResource,
+    PixelSampler,
+    Rasterizer,
+    Count,
+};
+
+constexpr const char* traceBindOpNames[] = {
+    "VertexBuffer",
+    "IndexBuffer",
+    "InputLayout",
+    "Topology",
+    "VertexShader",
+    "PixelShader",
+    "VertexConstantBuffer",
+    "PixelConstantBuffer",
+    "PixelShaderResource",
+    "PixelSampler",
+    "Rasterizer",
+};
+
+struct TraceRecord
+{
+    TraceRecordKind kind;
+    TraceBindOp op;
+    std::uint16_t reserved;
+    std::uint32_t arg;
+    // pointer value of the D3D object, only used as an identity
+    std::uint64_t object;
+};
+static_assert(sizeof(TraceRecord) == 16u, "TraceRecord is written to disk as is");
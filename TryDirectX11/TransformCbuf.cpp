@@ -1,4 +1,5 @@
 #include "TransformCbuf.h"
+#include "BindStream.h"
 
 TransformCbuf::TransformCbuf(Graphics &gfx, const Drawable &parent)
         :
@@ -8,10 +9,20 @@ TransformCbuf::TransformCbuf(Graphics &gfx, const Drawable &parent)
 
 void TransformCbuf::Bind(Graphics &gfx) noexcept {
     // 由于 CPU 中矩阵通常是行主序的，但 HLSL 中默认是列主序的，如果不想在 shader 里面转置，就要在传数据前转置一下。
-    pVcbuf.Update(gfx,
+    // 每次 draw 都会更新，Bind 又是 noexcept，所以不检查（设备丢失会在 Present 时报出来）
+    pVcbuf.Update<GfxCheck::Unchecked>(gfx,
                    DirectX::XMMatrixTranspose(
                            parent.GetTransformXM() * gfx.GetProjection()
                    )
     );
     pVcbuf.Bind(gfx);
-}
\ No newline at end of file
+}
+
+void TransformCbuf::Record(BindStream &stream) const {
+    // 只记录自己，矩阵在执行时才计算
+    stream.PushTransform(*this, 0u);
+}
+
+ID3D11Buffer *TransformCbuf::GetBuffer() const noexcept {
+    return pVcbuf.GetBuffer();
+}
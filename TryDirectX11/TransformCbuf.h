@@ -8,6 +8,8 @@ class TransformCbuf : public Bindable
 public:
     TransformCbuf(Graphics& gfx, const Drawable& parent);
     void Bind(Graphics& gfx) noexcept override;
+    void Record(BindStream& stream) const override;
+    ID3D11Buffer* GetBuffer() const noexcept;
 private:
     VertexConstantBuffer<DirectX::XMMATRIX> pVcbuf;
     const Drawable& parent;
@@ -1,4 +1,5 @@
 #include "VertexShader.h"
+#include "BindStream.h"
 #include "GraphicsThrowMacros.h"
 
 
@@ -21,4 +22,8 @@ void VertexShader::Bind(Graphics &gfx) noexcept {
 
 ID3DBlob *VertexShader::GetBytecode() const noexcept {
     return pBytecodeBlob.Get();
-}
\ No newline at end of file
+}
+
+void VertexShader::Record(BindStream &stream) const {
+    stream.PushVertexShader(pVertexShader.Get());
+}
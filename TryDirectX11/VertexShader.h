@@ -6,6 +6,7 @@ class VertexShader : public Bindable
 public:
     VertexShader(Graphics& gfx, const std::wstring& path);
     void Bind(Graphics& gfx) noexcept override;
+    void Record(BindStream& stream) const override;
     ID3DBlob* GetBytecode() const noexcept;
 protected:
     Microsoft::WRL::ComPtr<ID3DBlob> pBytecodeBlob;
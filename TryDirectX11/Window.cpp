@@ -19,6 +19,7 @@
 ******************************************************************************************/
 #include "Window.h"
 #include <sstream>
+#include <future>
 #include "resource.h"
 #include "WindowsThrowMacros.h"
 
@@ -58,7 +59,59 @@ HINSTANCE Window::WindowClass::GetInstance() noexcept {
 
 
 // Window Stuff
-Window::Window(int width, int height, LPCTSTR name) : width(width), height(height) {
+Window::Window(int width, int height, LPCTSTR name, bool dedicatedMessageThread)
+        :
+        width(width),
+        height(height),
+        ownerThreadId(GetCurrentThreadId()),
+        dedicatedMessageThread(dedicatedMessageThread) {
+    if (dedicatedMessageThread) {
+        // 保证创建者线程已经有消息队列，否则消息线程 PostThreadMessage(WM_QUIT) 会失败
+        MSG msg;
+        PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+        // 窗口属于创建它的线程，消息也只会派发到那个线程，所以窗口必须在消息线程里创建
+        std::promise<void> created;
+        auto ready = created.get_future();
+        messageThread = std::thread([this, name, &created]() {
+            try {
+                CreateHwnd(name);
+            }
+            catch (...) {
+                created.set_exception(std::current_exception());
+                return;
+            }
+            created.set_value();
+            RunMessageThread();
+        });
+        try {
+            ready.get();
+        }
+        catch (...) {
+            messageThread.join();
+            throw;
+        }
+    } else {
+        CreateHwnd(name);
+    }
+    // create graphics object
+    // unique 指针，在窗口销毁的时候也会自动销毁这个对象
+    try {
+        pGfx = std::make_unique<Graphics>(hWnd);
+    }
+    catch (...) {
+        // 构造失败不会调用析构函数，这里要自己把窗口（和消息线程）收拾掉
+        StopMessageThread();
+        throw;
+    }
+}
+
+Window::~Window() {
+    // 交换链引用着窗口，先于窗口销毁
+    pGfx.reset();
+    StopMessageThread();
+}
+
+void Window::CreateHwnd(LPCTSTR name) {
     // calculate window size based on desired client region size
     RECT wr;
     wr.left = 100;
@@ -81,17 +134,34 @@ Window::Window(int width, int height, LPCTSTR name) : width(width), height(heigh
     }
     // newly create windows start off as hidden
     ShowWindow(hWnd, SW_SHOWDEFAULT);
-    // create graphics object
-    // unique 指针，在窗口销毁的时候也会自动销毁这个对象
-    pGfx = std::make_unique<Graphics>(hWnd);
 }
 
-Window::~Window() {
-    DestroyWindow(hWnd);
+void Window::RunMessageThread() noexcept {
+    MSG msg;
+    // GetMessage 会阻塞等待，这个线程除了处理消息没有别的事情做
+    while (GetMessage(&msg, nullptr, 0, 0) > 0) {
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+}
+
+void Window::StopMessageThread() noexcept {
+    if (messageThread.joinable()) {
+        // DestroyWindow 只能在窗口所属线程调用
+        PostMessage(hWnd, WM_STOP_MESSAGE_THREAD, 0, 0);
+        messageThread.join();
+    } else if (hWnd != nullptr) {
+        DestroyWindow(hWnd);
+    }
+    hWnd = nullptr;
 }
 
 void Window::SetTitle(const std::string &title) {
-    if (SetWindowTextA(hWnd, title.c_str()) == 0) {
+    SetTitle(title.c_str());
+}
+
+void Window::SetTitle(const char *title) {
+    if (SetWindowTextA(hWnd, title) == 0) {
         throw CHWND_LAST_EXCEPT();
     }
 }
@@ -162,6 +232,16 @@ LRESULT Window::HandleMsg(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noe
         // we don't want the DefProc to handle this message because
         // we want our destructor to destroy the window, so return 0 instead of break
         case WM_CLOSE:
+            if (dedicatedMessageThread) {
+                // the frame loop runs on the owner thread, so that is where ProcessMessages must see WM_QUIT;
+                // this pump keeps running until the destructor stops it
+                PostThreadMessage(ownerThreadId, WM_QUIT, 0, 0);
+            } else {
+                PostQuitMessage(0);
+            }
+            return 0;
+        case WM_STOP_MESSAGE_THREAD:
+            DestroyWindow(hWnd);
             PostQuitMessage(0);
             return 0;
             // clear keystate when window loses focus to prevent input getting "stuck"
@@ -194,7 +274,8 @@ LRESULT Window::HandleMsg(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noe
             // in client region -> log move, and log enter + capture mouse (if not previously in window)
             if (pt.x >= 0 && pt.x < width && pt.y >= 0 && pt.y < height) {
                 mouse.OnMouseMove(pt.x, pt.y);
-                if (!mouse.IsInWindow()) {
+                // read the pump-side flag, IsInWindow() returns the snapshot meant for other threads
+                if (!mouse.isInWindow) {
                     SetCapture(hWnd);
                     mouse.OnMouseEnter();
                 }
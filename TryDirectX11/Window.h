@@ -25,6 +25,7 @@
 #include "Graphics.h"
 #include <optional>
 #include <memory>
+#include <thread>
 
 class Window
 {
@@ -67,23 +68,37 @@ private:
 		HINSTANCE hInst;
 	};
 public:
-	Window(int width, int height, LPCTSTR name);
+	// dedicatedMessageThread: create the window and run its message pump on a separate thread,
+	// so a slow frame does not delay input and dragging the window does not stall rendering.
+	// Keyboard / Mouse are then fed across threads through their lock-free buffers and snapshots.
+	Window(int width, int height, LPCTSTR name, bool dedicatedMessageThread = false);
 	~Window();
 	Window(const Window&) = delete;
 	Window& operator=(const Window&) = delete;
 	void SetTitle(const std::string& title);
+	// no temporary string, for titles updated while running
+	void SetTitle(const char* title);
 	static std::optional<int> ProcessMessages();
 	Graphics& Gfx();
 private:
 	static LRESULT CALLBACK HandleMsgSetup(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
 	static LRESULT CALLBACK HandleMsgThunk(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
 	LRESULT HandleMsg(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
+	void CreateHwnd(LPCTSTR name);
+	void RunMessageThread() noexcept;
+	void StopMessageThread() noexcept;
+	// posted to the message thread to have it destroy the window and leave its pump
+	static constexpr UINT WM_STOP_MESSAGE_THREAD = WM_APP + 1;
 public:
     Keyboard kbd;
     Mouse mouse;
 private:
 	int width;
 	int height;
-	HWND hWnd;
+	HWND hWnd = nullptr;
+	// thread that created this Window; receives WM_QUIT when the window is closed
+	const DWORD ownerThreadId;
+	const bool dedicatedMessageThread;
+	std::thread messageThread;
 	std::unique_ptr<Graphics> pGfx;
 };
\ No newline at end of file